@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+/**
+ * Audio device of `esp_codec_dev` on the host. It plays in real time, or faster, behind a buffer as the DMA of the I2S
+ * does: a write blocks while the buffer is full. It keeps the samples written, and counts the gaps when the buffer ran
+ * empty before the next write.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_codec_dev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Audio device usage structure
+ */
+typedef struct {
+    uint32_t opens;                     /*!< Times the device was opened */
+    bool is_open;                       /*!< True if the device is opened */
+    esp_codec_dev_sample_info_t fs;     /*!< Format of the last open */
+    uint64_t bytes;                     /*!< Bytes written since the last open */
+    uint32_t gaps;                      /*!< Times the buffer ran empty between two writes */
+    uint64_t gap_total_us;              /*!< Total time the buffer was empty */
+    uint64_t gap_max_us;                /*!< Longest time the buffer was empty */
+} codec_dev_host_usage_t;
+
+/**
+ * @brief Create an audio device
+ *
+ * @param buffer_ms Audio held by the device before a write blocks
+ * @param speed Speed of the device, 1 for real time
+ * @param capture_size Bytes kept of the audio written since the last open
+ * @return The device, or NULL
+ */
+esp_codec_dev_handle_t codec_dev_host_create(uint32_t buffer_ms, uint32_t speed, uint32_t capture_size);
+
+void codec_dev_host_get_usage(esp_codec_dev_handle_t dev, codec_dev_host_usage_t *usage);
+
+/**
+ * @brief Get the audio written since the last open
+ *
+ * @return Samples, valid until the next open, of `usage.bytes` bytes or the capture size if lower
+ */
+const uint8_t *codec_dev_host_get_capture(esp_codec_dev_handle_t dev);
+
+void codec_dev_host_destroy(esp_codec_dev_handle_t dev);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,143 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "esp_timer.h"
+#include "codec_dev_host.h"
+
+typedef struct {
+    pthread_mutex_t mutex;
+    uint32_t buffer_us;             /*!< Real time of the audio held by the device */
+    uint32_t speed;
+    uint8_t *capture;
+    uint32_t capture_size;
+    int64_t play_end_us;            /*!< Time the audio written so far is played, 0 before the first write */
+    codec_dev_host_usage_t usage;
+} codec_dev_host_t;
+
+esp_codec_dev_handle_t codec_dev_host_create(uint32_t buffer_ms, uint32_t speed, uint32_t capture_size)
+{
+    codec_dev_host_t *dev = calloc(1, sizeof(codec_dev_host_t));
+    if (dev == NULL) {
+        return NULL;
+    }
+    dev->capture = malloc(capture_size);
+    if (dev->capture == NULL) {
+        free(dev);
+        return NULL;
+    }
+    pthread_mutex_init(&dev->mutex, NULL);
+    dev->speed = (speed > 0) ? speed : 1;
+    dev->buffer_us = buffer_ms * 1000 / dev->speed;
+    dev->capture_size = capture_size;
+    return dev;
+}
+
+void codec_dev_host_get_usage(esp_codec_dev_handle_t handle, codec_dev_host_usage_t *usage)
+{
+    codec_dev_host_t *dev = (codec_dev_host_t *)handle;
+    pthread_mutex_lock(&dev->mutex);
+    *usage = dev->usage;
+    pthread_mutex_unlock(&dev->mutex);
+}
+
+const uint8_t *codec_dev_host_get_capture(esp_codec_dev_handle_t handle)
+{
+    return ((codec_dev_host_t *)handle)->capture;
+}
+
+void codec_dev_host_destroy(esp_codec_dev_handle_t handle)
+{
+    codec_dev_host_t *dev = (codec_dev_host_t *)handle;
+    pthread_mutex_destroy(&dev->mutex);
+    free(dev->capture);
+    free(dev);
+}
+
+int esp_codec_dev_open(esp_codec_dev_handle_t handle, esp_codec_dev_sample_info_t *fs)
+{
+    codec_dev_host_t *dev = (codec_dev_host_t *)handle;
+    if ((dev == NULL) || (fs == NULL) || (fs->sample_rate == 0) || (fs->channel == 0) ||
+            (fs->bits_per_sample % 8 != 0)) {
+        return ESP_CODEC_DEV_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&dev->mutex);
+    if (dev->usage.is_open) {
+        pthread_mutex_unlock(&dev->mutex);
+        return ESP_CODEC_DEV_WRONG_STATE;
+    }
+    dev->usage.opens++;
+    dev->usage.is_open = true;
+    dev->usage.fs = *fs;
+    dev->usage.bytes = 0;
+    dev->play_end_us = 0;
+    pthread_mutex_unlock(&dev->mutex);
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_write(esp_codec_dev_handle_t handle, void *data, int len)
+{
+    codec_dev_host_t *dev = (codec_dev_host_t *)handle;
+    if ((dev == NULL) || (data == NULL) || (len < 0)) {
+        return ESP_CODEC_DEV_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&dev->mutex);
+    if (!dev->usage.is_open) {
+        pthread_mutex_unlock(&dev->mutex);
+        return ESP_CODEC_DEV_WRONG_STATE;
+    }
+    const esp_codec_dev_sample_info_t *fs = &dev->usage.fs;
+    uint64_t bytes_per_s = (uint64_t)fs->sample_rate * fs->channel * (fs->bits_per_sample / 8);
+    int64_t duration_us = (int64_t)((uint64_t)len * 1000000 / bytes_per_s / dev->speed);
+
+    // The device starts with the first write, and stays silent when the buffer runs empty
+    int64_t now_us = esp_timer_get_time();
+    if ((dev->play_end_us > 0) && (dev->play_end_us < now_us)) {
+        uint64_t gap_us = now_us - dev->play_end_us;
+        dev->usage.gaps++;
+        dev->usage.gap_total_us += gap_us;
+        if (gap_us > dev->usage.gap_max_us) {
+            dev->usage.gap_max_us = gap_us;
+        }
+    }
+    if (dev->play_end_us < now_us) {
+        dev->play_end_us = now_us;
+    }
+    dev->play_end_us += duration_us;
+
+    if (dev->usage.bytes < dev->capture_size) {
+        uint64_t room = dev->capture_size - dev->usage.bytes;
+        memcpy(dev->capture + dev->usage.bytes, data, ((uint64_t)len < room) ? (size_t)len : (size_t)room);
+    }
+    dev->usage.bytes += len;
+    int64_t wake_us = dev->play_end_us - dev->buffer_us;
+    pthread_mutex_unlock(&dev->mutex);
+
+    // Blocks while the buffer is full
+    now_us = esp_timer_get_time();
+    if (wake_us > now_us) {
+        usleep((useconds_t)(wake_us - now_us));
+    }
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_close(esp_codec_dev_handle_t handle)
+{
+    codec_dev_host_t *dev = (codec_dev_host_t *)handle;
+    if (dev == NULL) {
+        return ESP_CODEC_DEV_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&dev->mutex);
+    dev->usage.is_open = false;
+    pthread_mutex_unlock(&dev->mutex);
+    return ESP_CODEC_DEV_OK;
+}
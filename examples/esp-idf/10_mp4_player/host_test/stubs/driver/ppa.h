@@ -0,0 +1,117 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ppa_client_t *ppa_client_handle_t;
+
+typedef enum {
+    PPA_OPERATION_SRM,
+    PPA_OPERATION_BLEND,
+    PPA_OPERATION_FILL,
+} ppa_operation_t;
+
+typedef struct {
+    ppa_operation_t oper_type;
+    uint32_t max_pending_trans_num;
+} ppa_client_config_t;
+
+typedef enum {
+    PPA_TRANS_MODE_BLOCKING,
+    PPA_TRANS_MODE_NON_BLOCKING,
+} ppa_trans_mode_t;
+
+typedef enum {
+    PPA_SRM_COLOR_MODE_ARGB8888,
+    PPA_SRM_COLOR_MODE_RGB888,
+    PPA_SRM_COLOR_MODE_RGB565,
+} ppa_srm_color_mode_t;
+
+typedef enum {
+    PPA_FILL_COLOR_MODE_ARGB8888,
+    PPA_FILL_COLOR_MODE_RGB888,
+    PPA_FILL_COLOR_MODE_RGB565,
+} ppa_fill_color_mode_t;
+
+typedef enum {
+    PPA_SRM_ROTATION_ANGLE_0,
+    PPA_SRM_ROTATION_ANGLE_90,
+    PPA_SRM_ROTATION_ANGLE_180,
+    PPA_SRM_ROTATION_ANGLE_270,
+} ppa_srm_rotation_angle_t;
+
+typedef union {
+    struct {
+        uint32_t b: 8;
+        uint32_t g: 8;
+        uint32_t r: 8;
+        uint32_t a: 8;
+    };
+    uint32_t val;
+} color_pixel_argb8888_data_t;
+
+typedef struct {
+    const void *buffer;
+    uint32_t pic_w;
+    uint32_t pic_h;
+    uint32_t block_w;
+    uint32_t block_h;
+    uint32_t block_offset_x;
+    uint32_t block_offset_y;
+    ppa_srm_color_mode_t srm_cm;
+} ppa_in_pic_blk_config_t;
+
+typedef struct {
+    void *buffer;
+    uint32_t buffer_size;
+    uint32_t pic_w;
+    uint32_t pic_h;
+    uint32_t block_offset_x;
+    uint32_t block_offset_y;
+    union {
+        ppa_srm_color_mode_t srm_cm;
+        ppa_fill_color_mode_t fill_cm;
+    };
+} ppa_out_pic_blk_config_t;
+
+typedef struct {
+    ppa_in_pic_blk_config_t in;
+    ppa_out_pic_blk_config_t out;
+    ppa_srm_rotation_angle_t rotation_angle;
+    float scale_x;
+    float scale_y;
+    bool mirror_x;
+    bool mirror_y;
+    bool rgb_swap;
+    bool byte_swap;
+    ppa_trans_mode_t mode;
+    void *user_data;
+} ppa_srm_oper_config_t;
+
+typedef struct {
+    ppa_out_pic_blk_config_t out;
+    uint32_t fill_block_w;
+    uint32_t fill_block_h;
+    color_pixel_argb8888_data_t fill_argb_color;
+    ppa_trans_mode_t mode;
+    void *user_data;
+} ppa_fill_oper_config_t;
+
+esp_err_t ppa_register_client(const ppa_client_config_t *config, ppa_client_handle_t *ret_client);
+esp_err_t ppa_unregister_client(ppa_client_handle_t ppa_client);
+esp_err_t ppa_do_scale_rotate_mirror(ppa_client_handle_t ppa_client, const ppa_srm_oper_config_t *config);
+esp_err_t ppa_do_fill(ppa_client_handle_t ppa_client, const ppa_fill_oper_config_t *config);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,24 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESP_CACHE_MSYNC_FLAG_INVALIDATE     (1 << 0)
+#define ESP_CACHE_MSYNC_FLAG_UNALIGNED      (1 << 1)
+#define ESP_CACHE_MSYNC_FLAG_DIR_C2M        (1 << 2)
+#define ESP_CACHE_MSYNC_FLAG_DIR_M2C        (1 << 3)
+
+esp_err_t esp_cache_msync(void *addr, size_t size, int flags);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,34 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESP_CODEC_DEV_OK                (0)
+#define ESP_CODEC_DEV_INVALID_ARG       (-1)
+#define ESP_CODEC_DEV_WRONG_STATE       (-5)
+
+typedef void *esp_codec_dev_handle_t;
+
+typedef struct {
+    uint8_t bits_per_sample;
+    uint8_t channel;
+    uint16_t channel_mask;
+    uint32_t sample_rate;
+    int mclk_multiple;
+} esp_codec_dev_sample_info_t;
+
+int esp_codec_dev_open(esp_codec_dev_handle_t dev, esp_codec_dev_sample_info_t *fs);
+int esp_codec_dev_write(esp_codec_dev_handle_t dev, void *data, int len);
+int esp_codec_dev_close(esp_codec_dev_handle_t dev);
+
+#ifdef __cplusplus
+}
+#endif
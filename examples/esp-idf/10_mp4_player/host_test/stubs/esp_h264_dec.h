@@ -0,0 +1,67 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    ESP_H264_ERR_OK = 0,
+    ESP_H264_ERR_FAIL = -1,
+    ESP_H264_ERR_ARG = -2,
+    ESP_H264_ERR_MEM = -3,
+} esp_h264_err_t;
+
+typedef enum {
+    ESP_H264_RAW_FMT_I420 = 3,
+} esp_h264_raw_format_t;
+
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+} esp_h264_resolution_t;
+
+typedef struct {
+    uint8_t *buffer;
+    uint32_t len;
+} esp_h264_pkt_t;
+
+typedef struct {
+    esp_h264_pkt_t raw_data;
+    uint32_t consume;
+    uint32_t pts;
+    uint32_t dts;
+} esp_h264_dec_in_frame_t;
+
+typedef struct {
+    uint8_t *outbuf;
+    uint32_t out_size;
+    uint32_t pts;
+    uint32_t dts;
+} esp_h264_dec_out_frame_t;
+
+typedef struct esp_h264_dec_param_if_t esp_h264_dec_param_if_t;
+typedef esp_h264_dec_param_if_t *esp_h264_dec_param_handle_t;
+
+struct esp_h264_dec_param_if_t {
+    esp_h264_err_t (*get_res)(esp_h264_dec_param_handle_t handle, esp_h264_resolution_t *res);
+};
+
+typedef struct esp_h264_dec_if_t *esp_h264_dec_handle_t;
+
+esp_h264_err_t esp_h264_dec_open(esp_h264_dec_handle_t dec);
+esp_h264_err_t esp_h264_dec_process(esp_h264_dec_handle_t dec, esp_h264_dec_in_frame_t *in_frame,
+                                    esp_h264_dec_out_frame_t *out_frame);
+esp_h264_err_t esp_h264_dec_close(esp_h264_dec_handle_t dec);
+esp_h264_err_t esp_h264_dec_del(esp_h264_dec_handle_t dec);
+esp_h264_err_t esp_h264_dec_get_resolution(esp_h264_dec_param_handle_t handle, esp_h264_resolution_t *res);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,29 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include "esp_h264_dec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    esp_h264_raw_format_t pic_type;
+} esp_h264_dec_cfg_sw_t;
+
+typedef struct {
+    esp_h264_dec_param_if_t base;
+} esp_h264_dec_param_sw_t;
+
+typedef esp_h264_dec_param_sw_t *esp_h264_dec_param_sw_handle_t;
+
+esp_h264_err_t esp_h264_dec_sw_new(const esp_h264_dec_cfg_sw_t *cfg, esp_h264_dec_handle_t *out_dec);
+esp_h264_err_t esp_h264_dec_sw_get_param_hd(esp_h264_dec_handle_t dec, esp_h264_dec_param_sw_handle_t *out_param);
+
+#ifdef __cplusplus
+}
+#endif
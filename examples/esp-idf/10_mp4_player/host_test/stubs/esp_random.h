@@ -0,0 +1,21 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get a random number, from `random()` of the host, so a test can repeat it with `srandom()`
+ */
+uint32_t esp_random(void);
+
+#ifdef __cplusplus
+}
+#endif
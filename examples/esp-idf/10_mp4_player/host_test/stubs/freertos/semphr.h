@@ -0,0 +1,30 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+/* As in FreeRTOS, a semaphore is a queue of empty items */
+typedef QueueHandle_t SemaphoreHandle_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define xSemaphoreTake(sem, ticks)          xQueueReceive(sem, NULL, ticks)
+#define xSemaphoreGive(sem)                 xQueueSend(sem, NULL, 0)
+#define xSemaphoreGiveFromISR(sem, woken)   ((void)(woken), xQueueSend(sem, NULL, 0))
+#define uxSemaphoreGetCount(sem)            uxQueueMessagesWaiting(sem)
+#define vSemaphoreDelete(sem)               vQueueDelete(sem)
@@ -0,0 +1,440 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+struct QueueDefinition {
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;         /* Signaled when an item is added or removed */
+    UBaseType_t length;
+    UBaseType_t item_size;          /* 0 for a semaphore */
+    UBaseType_t head;
+    UBaseType_t count;
+    uint8_t *items;
+};
+
+struct EventGroupDef_t {
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;
+    EventBits_t bits;
+};
+
+struct tskTaskControlBlock {
+    pthread_mutex_t mutex;
+    pthread_cond_t notified;
+    uint32_t notify_value;
+    TaskFunction_t task_code;
+    void *parameters;
+};
+
+static __thread TaskHandle_t current_task;
+
+static struct timespec get_deadline(TickType_t ticks)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += ticks / configTICK_RATE_HZ;
+    deadline.tv_nsec += (long)(ticks % configTICK_RATE_HZ) * (1000000000L / configTICK_RATE_HZ);
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    return deadline;
+}
+
+static void init_cond(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+/**
+ * @brief Wait on a condition until a deadline, the mutex is held
+ *
+ * @return False on timeout
+ */
+static bool wait_cond(pthread_cond_t *cond, pthread_mutex_t *mutex, TickType_t ticks, const struct timespec *deadline)
+{
+    if (ticks == 0) {
+        return false;
+    }
+    if (ticks == portMAX_DELAY) {
+        pthread_cond_wait(cond, mutex);
+        return true;
+    }
+    return pthread_cond_timedwait(cond, mutex, deadline) != ETIMEDOUT;
+}
+
+void spinlock_initialize(portMUX_TYPE *mux)
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mux->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+void vPortEnterCritical(portMUX_TYPE *mux)
+{
+    pthread_mutex_lock(&mux->mutex);
+}
+
+void vPortExitCritical(portMUX_TYPE *mux)
+{
+    pthread_mutex_unlock(&mux->mutex);
+}
+
+/* Queues and semaphores */
+
+static QueueHandle_t create_queue(UBaseType_t length, UBaseType_t item_size, UBaseType_t count)
+{
+    QueueHandle_t queue = calloc(1, sizeof(struct QueueDefinition));
+    if (queue == NULL) {
+        return NULL;
+    }
+    if (item_size > 0) {
+        queue->items = malloc((size_t)length * item_size);
+        if (queue->items == NULL) {
+            free(queue);
+            return NULL;
+        }
+    }
+    pthread_mutex_init(&queue->mutex, NULL);
+    init_cond(&queue->changed);
+    queue->length = length;
+    queue->item_size = item_size;
+    queue->count = count;
+    return queue;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    return (length > 0) ? create_queue(length, item_size, 0) : NULL;
+}
+
+static BaseType_t queue_send(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait, bool to_front)
+{
+    struct timespec deadline = get_deadline(ticks_to_wait);
+    pthread_mutex_lock(&queue->mutex);
+    while (queue->count == queue->length) {
+        if (!wait_cond(&queue->changed, &queue->mutex, ticks_to_wait, &deadline)) {
+            pthread_mutex_unlock(&queue->mutex);
+            return pdFAIL;
+        }
+    }
+
+    if (queue->item_size > 0) {
+        UBaseType_t index;
+        if (to_front) {
+            queue->head = (queue->head + queue->length - 1) % queue->length;
+            index = queue->head;
+        } else {
+            index = (queue->head + queue->count) % queue->length;
+        }
+        memcpy(queue->items + (size_t)index * queue->item_size, item, queue->item_size);
+    }
+    queue->count++;
+    pthread_cond_broadcast(&queue->changed);
+    pthread_mutex_unlock(&queue->mutex);
+    return pdPASS;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    return queue_send(queue, item, ticks_to_wait, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    return queue_send(queue, item, ticks_to_wait, true);
+}
+
+static BaseType_t queue_receive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait, bool is_peek)
+{
+    struct timespec deadline = get_deadline(ticks_to_wait);
+    pthread_mutex_lock(&queue->mutex);
+    while (queue->count == 0) {
+        if (!wait_cond(&queue->changed, &queue->mutex, ticks_to_wait, &deadline)) {
+            pthread_mutex_unlock(&queue->mutex);
+            return pdFALSE;
+        }
+    }
+
+    if (queue->item_size > 0) {
+        memcpy(item, queue->items + (size_t)queue->head * queue->item_size, queue->item_size);
+    }
+    if (!is_peek) {
+        queue->head = (queue->head + 1) % queue->length;
+        queue->count--;
+        pthread_cond_broadcast(&queue->changed);
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    return queue_receive(queue, item, ticks_to_wait, false);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    return queue_receive(queue, item, ticks_to_wait, true);
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->mutex);
+    queue->head = 0;
+    queue->count = 0;
+    pthread_cond_broadcast(&queue->changed);
+    pthread_mutex_unlock(&queue->mutex);
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->mutex);
+    UBaseType_t count = queue->count;
+    pthread_mutex_unlock(&queue->mutex);
+    return count;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    pthread_cond_destroy(&queue->changed);
+    pthread_mutex_destroy(&queue->mutex);
+    free(queue->items);
+    free(queue);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return create_queue(1, 0, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return create_queue(1, 0, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count)
+{
+    if (max_count == 0 || initial_count > max_count) {
+        return NULL;
+    }
+    return create_queue(max_count, 0, initial_count);
+}
+
+/* Event groups */
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    EventGroupHandle_t group = calloc(1, sizeof(struct EventGroupDef_t));
+    if (group == NULL) {
+        return NULL;
+    }
+    pthread_mutex_init(&group->mutex, NULL);
+    init_cond(&group->changed);
+    return group;
+}
+
+static bool are_bits_set(EventBits_t bits, EventBits_t bits_to_wait, BaseType_t wait_for_all)
+{
+    return wait_for_all ? ((bits & bits_to_wait) == bits_to_wait) : ((bits & bits_to_wait) != 0);
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits_to_wait, BaseType_t clear_on_exit,
+                                BaseType_t wait_for_all, TickType_t ticks_to_wait)
+{
+    struct timespec deadline = get_deadline(ticks_to_wait);
+    pthread_mutex_lock(&group->mutex);
+    while (!are_bits_set(group->bits, bits_to_wait, wait_for_all)) {
+        if (!wait_cond(&group->changed, &group->mutex, ticks_to_wait, &deadline)) {
+            break;
+        }
+    }
+
+    // As in FreeRTOS, the bits are returned before they are cleared, and cleared only if the wait succeeded
+    EventBits_t bits = group->bits;
+    if (clear_on_exit && are_bits_set(bits, bits_to_wait, wait_for_all)) {
+        group->bits &= ~bits_to_wait;
+    }
+    pthread_mutex_unlock(&group->mutex);
+    return bits;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    pthread_mutex_lock(&group->mutex);
+    group->bits |= bits;
+    EventBits_t ret = group->bits;
+    pthread_cond_broadcast(&group->changed);
+    pthread_mutex_unlock(&group->mutex);
+    return ret;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    pthread_mutex_lock(&group->mutex);
+    EventBits_t ret = group->bits;
+    group->bits &= ~bits;
+    pthread_mutex_unlock(&group->mutex);
+    return ret;
+}
+
+void vEventGroupDelete(EventGroupHandle_t group)
+{
+    pthread_cond_destroy(&group->changed);
+    pthread_mutex_destroy(&group->mutex);
+    free(group);
+}
+
+/* Tasks */
+
+static TaskHandle_t create_task_control_block(void)
+{
+    TaskHandle_t task = calloc(1, sizeof(struct tskTaskControlBlock));
+    if (task == NULL) {
+        return NULL;
+    }
+    pthread_mutex_init(&task->mutex, NULL);
+    init_cond(&task->notified);
+    return task;
+}
+
+static void *task_entry(void *arg)
+{
+    current_task = arg;
+    current_task->task_code(current_task->parameters);
+    // A task must delete itself rather than return
+    abort();
+    return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task_code, const char *name, uint32_t stack_depth, void *parameters,
+                       UBaseType_t priority, TaskHandle_t *created_task)
+{
+    (void)name;
+    (void)stack_depth;
+    (void)priority;
+
+    TaskHandle_t task = create_task_control_block();
+    if (task == NULL) {
+        return pdFAIL;
+    }
+    task->task_code = task_code;
+    task->parameters = parameters;
+    // The handle is known before the task runs, as on FreeRTOS
+    if (created_task != NULL) {
+        *created_task = task;
+    }
+
+    pthread_t thread;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    int ret = pthread_create(&thread, &attr, task_entry, task);
+    pthread_attr_destroy(&attr);
+    if (ret != 0) {
+        if (created_task != NULL) {
+            *created_task = NULL;
+        }
+        free(task);
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task_code, const char *name, uint32_t stack_depth,
+                                   void *parameters, UBaseType_t priority, TaskHandle_t *created_task,
+                                   BaseType_t core_id)
+{
+    (void)core_id;
+    return xTaskCreate(task_code, name, stack_depth, parameters, priority, created_task);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if ((task != NULL) && (task != current_task)) {
+        // Threads cannot be killed safely
+        abort();
+    }
+
+    task = current_task;
+    current_task = NULL;
+    if (task != NULL) {
+        pthread_cond_destroy(&task->notified);
+        pthread_mutex_destroy(&task->mutex);
+        free(task);
+    }
+    pthread_exit(NULL);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    struct timespec deadline = get_deadline(ticks);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {
+    }
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (TickType_t)(now.tv_sec * configTICK_RATE_HZ + now.tv_nsec / (1000000000L / configTICK_RATE_HZ));
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    // The threads not created by `xTaskCreate()` get a task on their first call, it is never freed
+    if (current_task == NULL) {
+        current_task = create_task_control_block();
+    }
+    return current_task;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    pthread_mutex_lock(&task->mutex);
+    task->notify_value++;
+    pthread_cond_broadcast(&task->notified);
+    pthread_mutex_unlock(&task->mutex);
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    struct timespec deadline = get_deadline(ticks_to_wait);
+
+    pthread_mutex_lock(&task->mutex);
+    while (task->notify_value == 0) {
+        if (!wait_cond(&task->notified, &task->mutex, ticks_to_wait, &deadline)) {
+            break;
+        }
+    }
+    uint32_t value = task->notify_value;
+    if (value > 0) {
+        task->notify_value = clear_on_exit ? 0 : value - 1;
+    }
+    pthread_mutex_unlock(&task->mutex);
+    return value;
+}
@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+/**
+ * Software decoder of `esp_h264` modelled on the host, as the component ships as a RISC-V binary. It takes one NAL unit
+ * of an Annex-B stream per call, as the decoder does, and outputs I420 pictures generated from the NAL units:
+ *
+ * - A sequence parameter set (type 7) holds the width and the height, 2 bytes each in big endian, then a seed
+ * - A slice (type 1 or 5) holds a picture number, the picture is `h264_dec_host_fill_picture()` of the seed and number
+ * - The other NAL units output nothing
+ *
+ * It also writes back the cache by `esp_cache_msync()`, which counts the bytes.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_h264_dec_sw.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief H.264 decoder usage structure
+ */
+typedef struct {
+    uint32_t decoders;          /*!< Decoders created and not deleted yet */
+    uint32_t created;           /*!< Decoders created */
+    uint32_t pictures;          /*!< Pictures output */
+    uint64_t synced_bytes;      /*!< Bytes written back from the cache */
+} h264_dec_host_usage_t;
+
+/**
+ * @brief Make the creation of the decoders fail, or succeed again
+ */
+void h264_dec_host_set_new_failure(bool is_failing);
+
+/**
+ * @brief Make the next calls of `esp_h264_dec_process()` fail
+ */
+void h264_dec_host_set_process_failures(uint32_t failure_num);
+
+void h264_dec_host_get_usage(h264_dec_host_usage_t *usage);
+
+/**
+ * @brief Generate the I420 picture of a slice
+ *
+ * @param yuv Picture, of `width * height + 2 * ((width + 1) / 2) * ((height + 1) / 2)` bytes
+ */
+void h264_dec_host_fill_picture(uint8_t *yuv, uint16_t width, uint16_t height, uint8_t seed, uint8_t number);
+
+#ifdef __cplusplus
+}
+#endif
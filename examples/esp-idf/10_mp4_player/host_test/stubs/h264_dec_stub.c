@@ -0,0 +1,222 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include "esp_cache.h"
+#include "h264_dec_host.h"
+
+#define NAL_TYPE_SLICE          (1)
+#define NAL_TYPE_SLICE_IDR      (5)
+#define NAL_TYPE_SPS            (7)
+
+/**
+ * @brief Decoder, the parameters first so their handle is the one of the decoder
+ */
+struct esp_h264_dec_if_t {
+    esp_h264_dec_param_sw_t param;
+    bool is_open;
+    uint16_t width;                 /*!< Size of the sequence, 0 before a sequence parameter set */
+    uint16_t height;
+    uint8_t seed;
+    uint8_t *picture;
+    uint32_t picture_size;
+};
+
+static pthread_mutex_t usage_mutex = PTHREAD_MUTEX_INITIALIZER;
+static h264_dec_host_usage_t h264_usage;
+static bool is_new_failing;
+static uint32_t process_failure_num;
+
+void h264_dec_host_set_new_failure(bool is_failing)
+{
+    is_new_failing = is_failing;
+}
+
+void h264_dec_host_set_process_failures(uint32_t failure_num)
+{
+    process_failure_num = failure_num;
+}
+
+void h264_dec_host_get_usage(h264_dec_host_usage_t *usage)
+{
+    pthread_mutex_lock(&usage_mutex);
+    *usage = h264_usage;
+    pthread_mutex_unlock(&usage_mutex);
+}
+
+void h264_dec_host_fill_picture(uint8_t *yuv, uint16_t width, uint16_t height, uint8_t seed, uint8_t number)
+{
+    // Xorshift, over the whole range of the bytes rather than the limited range of the video
+    uint32_t size = (uint32_t)width * height + 2 * ((width + 1) / 2) * ((height + 1) / 2);
+    uint32_t state = ((uint32_t)seed << 8 | number) * 2654435761u + 1;
+    for (uint32_t i = 0; i < size; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        yuv[i] = (uint8_t)(state >> 24);
+    }
+}
+
+esp_err_t esp_cache_msync(void *addr, size_t size, int flags)
+{
+    (void)flags;
+    if ((addr == NULL) || (size == 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&usage_mutex);
+    h264_usage.synced_bytes += size;
+    pthread_mutex_unlock(&usage_mutex);
+    return ESP_OK;
+}
+
+static esp_h264_err_t get_resolution(esp_h264_dec_param_handle_t handle, esp_h264_resolution_t *res)
+{
+    esp_h264_dec_handle_t dec = (esp_h264_dec_handle_t)handle;
+    res->width = dec->width;
+    res->height = dec->height;
+    return ESP_H264_ERR_OK;
+}
+
+esp_h264_err_t esp_h264_dec_sw_new(const esp_h264_dec_cfg_sw_t *cfg, esp_h264_dec_handle_t *out_dec)
+{
+    if ((cfg == NULL) || (out_dec == NULL) || (cfg->pic_type != ESP_H264_RAW_FMT_I420)) {
+        return ESP_H264_ERR_ARG;
+    }
+    if (is_new_failing) {
+        return ESP_H264_ERR_MEM;
+    }
+
+    esp_h264_dec_handle_t dec = calloc(1, sizeof(struct esp_h264_dec_if_t));
+    if (dec == NULL) {
+        return ESP_H264_ERR_MEM;
+    }
+    dec->param.base.get_res = get_resolution;
+    pthread_mutex_lock(&usage_mutex);
+    h264_usage.decoders++;
+    h264_usage.created++;
+    pthread_mutex_unlock(&usage_mutex);
+    *out_dec = dec;
+    return ESP_H264_ERR_OK;
+}
+
+esp_h264_err_t esp_h264_dec_sw_get_param_hd(esp_h264_dec_handle_t dec, esp_h264_dec_param_sw_handle_t *out_param)
+{
+    if ((dec == NULL) || (out_param == NULL)) {
+        return ESP_H264_ERR_ARG;
+    }
+    *out_param = &dec->param;
+    return ESP_H264_ERR_OK;
+}
+
+esp_h264_err_t esp_h264_dec_get_resolution(esp_h264_dec_param_handle_t handle, esp_h264_resolution_t *res)
+{
+    if ((handle == NULL) || (res == NULL)) {
+        return ESP_H264_ERR_ARG;
+    }
+    return handle->get_res(handle, res);
+}
+
+esp_h264_err_t esp_h264_dec_open(esp_h264_dec_handle_t dec)
+{
+    if (dec == NULL) {
+        return ESP_H264_ERR_ARG;
+    }
+    dec->is_open = true;
+    return ESP_H264_ERR_OK;
+}
+
+/**
+ * @brief Find the next start code of 3 bytes, or the end
+ */
+static uint32_t find_start_code(const uint8_t *data, uint32_t size, uint32_t from)
+{
+    for (uint32_t i = from; i + 3 <= size; i++) {
+        if ((data[i] == 0) && (data[i + 1] == 0) && (data[i + 2] == 1)) {
+            return i;
+        }
+    }
+    return size;
+}
+
+esp_h264_err_t esp_h264_dec_process(esp_h264_dec_handle_t dec, esp_h264_dec_in_frame_t *in_frame,
+                                    esp_h264_dec_out_frame_t *out_frame)
+{
+    if ((dec == NULL) || (in_frame == NULL) || (out_frame == NULL) || (in_frame->raw_data.buffer == NULL)) {
+        return ESP_H264_ERR_ARG;
+    }
+    if (!dec->is_open || (process_failure_num > 0)) {
+        if (process_failure_num > 0) {
+            process_failure_num--;
+        }
+        return ESP_H264_ERR_FAIL;
+    }
+
+    // One NAL unit, up to the next start code
+    const uint8_t *data = in_frame->raw_data.buffer;
+    uint32_t size = in_frame->raw_data.len;
+    uint32_t start = find_start_code(data, size, 0);
+    out_frame->out_size = 0;
+    if (start + 3 >= size) {
+        in_frame->consume = size;
+        return ESP_H264_ERR_OK;
+    }
+    const uint8_t *nal = data + start + 3;
+    uint32_t end = find_start_code(data, size, start + 3);
+    uint32_t nal_size = end - (start + 3);
+    in_frame->consume = end;
+
+    uint8_t type = nal[0] & 0x1F;
+    if ((type == NAL_TYPE_SPS) && (nal_size >= 6)) {
+        dec->width = (uint16_t)(nal[1] << 8 | nal[2]);
+        dec->height = (uint16_t)(nal[3] << 8 | nal[4]);
+        dec->seed = nal[5];
+    } else if (((type == NAL_TYPE_SLICE) || (type == NAL_TYPE_SLICE_IDR)) && (nal_size >= 2)) {
+        if ((dec->width == 0) || (dec->height == 0)) {
+            return ESP_H264_ERR_FAIL;
+        }
+        uint32_t picture_size = (uint32_t)dec->width * dec->height +
+                                2 * ((dec->width + 1) / 2) * ((dec->height + 1) / 2);
+        if (picture_size > dec->picture_size) {
+            free(dec->picture);
+            dec->picture_size = 0;
+            dec->picture = malloc(picture_size);
+            if (dec->picture == NULL) {
+                return ESP_H264_ERR_MEM;
+            }
+            dec->picture_size = picture_size;
+        }
+        h264_dec_host_fill_picture(dec->picture, dec->width, dec->height, dec->seed, nal[1]);
+        out_frame->outbuf = dec->picture;
+        out_frame->out_size = picture_size;
+        pthread_mutex_lock(&usage_mutex);
+        h264_usage.pictures++;
+        pthread_mutex_unlock(&usage_mutex);
+    }
+    return ESP_H264_ERR_OK;
+}
+
+esp_h264_err_t esp_h264_dec_close(esp_h264_dec_handle_t dec)
+{
+    if (dec == NULL) {
+        return ESP_H264_ERR_ARG;
+    }
+    dec->is_open = false;
+    return ESP_H264_ERR_OK;
+}
+
+esp_h264_err_t esp_h264_dec_del(esp_h264_dec_handle_t dec)
+{
+    if (dec == NULL) {
+        return ESP_H264_ERR_ARG;
+    }
+    free(dec->picture);
+    free(dec);
+    pthread_mutex_lock(&usage_mutex);
+    h264_usage.decoders--;
+    pthread_mutex_unlock(&usage_mutex);
+    return ESP_H264_ERR_OK;
+}
@@ -0,0 +1,33 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+/**
+ * Memory pool of the extractor on the heap of the host. Each block is counted, so the tests can check that all the
+ * blocks are returned.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "mem_pool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Memory pool usage structure
+ */
+typedef struct {
+    uint32_t used;              /*!< Bytes allocated */
+    uint32_t used_max;          /*!< Maximum bytes allocated at once */
+    uint32_t blocks;            /*!< Blocks allocated */
+    uint32_t alloc_failures;    /*!< Allocations over the size of the pool */
+} mem_pool_host_usage_t;
+
+void mem_pool_host_get_usage(mem_pool_handle_t pool, mem_pool_host_usage_t *usage);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,133 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mem_pool_host.h"
+
+#define BLOCK_ALIGN     (64)
+
+struct mem_pool_t {
+    pthread_mutex_t mutex;
+    uint32_t size;
+    mem_pool_host_usage_t usage;
+};
+
+/* Placed before each block, the data starts on the alignment of the block */
+typedef struct {
+    void *base;
+    uint32_t size;
+} block_header_t;
+
+mem_pool_handle_t mem_pool_create(uint32_t size)
+{
+    mem_pool_handle_t pool = calloc(1, sizeof(struct mem_pool_t));
+    if (pool != NULL) {
+        pthread_mutex_init(&pool->mutex, NULL);
+        pool->size = size;
+    }
+    return pool;
+}
+
+bool mem_pool_is_over_size(mem_pool_handle_t pool, uint32_t size)
+{
+    return (pool == NULL) || (size > pool->size);
+}
+
+void *mem_pool_malloc_aligned(mem_pool_handle_t pool, uint32_t size, uint16_t align_size)
+{
+    if (pool == NULL) {
+        return NULL;
+    }
+    uint32_t align = (align_size > sizeof(block_header_t)) ? align_size : sizeof(block_header_t);
+
+    pthread_mutex_lock(&pool->mutex);
+    uint8_t *base = NULL;
+    if (pool->usage.used + size <= pool->size) {
+        base = malloc(sizeof(block_header_t) + align + size);
+    }
+    if (base == NULL) {
+        pool->usage.alloc_failures++;
+        pthread_mutex_unlock(&pool->mutex);
+        return NULL;
+    }
+    pool->usage.used += size;
+    pool->usage.blocks++;
+    if (pool->usage.used > pool->usage.used_max) {
+        pool->usage.used_max = pool->usage.used;
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    uintptr_t data = ((uintptr_t)base + sizeof(block_header_t) + align - 1) / align * align;
+    block_header_t *header = (block_header_t *)data - 1;
+    header->base = base;
+    header->size = size;
+    return (void *)data;
+}
+
+void *mem_pool_try_malloc_aligned(mem_pool_handle_t pool, uint32_t size, uint16_t align_size)
+{
+    return mem_pool_malloc_aligned(pool, size, align_size);
+}
+
+void *mem_pool_alloc(mem_pool_handle_t pool, uint32_t size)
+{
+    return mem_pool_malloc_aligned(pool, size, BLOCK_ALIGN);
+}
+
+void *mem_pool_try_alloc(mem_pool_handle_t pool, uint32_t size)
+{
+    return mem_pool_malloc_aligned(pool, size, BLOCK_ALIGN);
+}
+
+void mem_pool_free(mem_pool_handle_t pool, void *buffer)
+{
+    if (pool == NULL || buffer == NULL) {
+        return;
+    }
+    block_header_t *header = (block_header_t *)buffer - 1;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->usage.used -= header->size;
+    pool->usage.blocks--;
+    pthread_mutex_unlock(&pool->mutex);
+    free(header->base);
+}
+
+void *mem_pool_realloc(mem_pool_handle_t pool, void *buffer, uint32_t size)
+{
+    if (buffer == NULL) {
+        return mem_pool_alloc(pool, size);
+    }
+    void *new_buffer = mem_pool_alloc(pool, size);
+    if (new_buffer != NULL) {
+        uint32_t old_size = ((block_header_t *)buffer - 1)->size;
+        memcpy(new_buffer, buffer, (old_size < size) ? old_size : size);
+        mem_pool_free(pool, buffer);
+    }
+    return new_buffer;
+}
+
+void *mem_pool_try_realloc(mem_pool_handle_t pool, void *buffer, uint32_t size)
+{
+    return mem_pool_realloc(pool, buffer, size);
+}
+
+void mem_pool_destroy(mem_pool_handle_t pool)
+{
+    if (pool != NULL) {
+        pthread_mutex_destroy(&pool->mutex);
+        free(pool);
+    }
+}
+
+void mem_pool_host_get_usage(mem_pool_handle_t pool, mem_pool_host_usage_t *usage)
+{
+    pthread_mutex_lock(&pool->mutex);
+    *usage = pool->usage;
+    pthread_mutex_unlock(&pool->mutex);
+}
@@ -0,0 +1,45 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+/**
+ * PPA of the ESP32-P4 modelled in software. It checks the operations as the driver does, so the tests can check the
+ * layouts given to it, and it can be made to fail.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "driver/ppa.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief PPA usage structure
+ */
+typedef struct {
+    uint32_t clients;           /*!< Clients registered */
+    uint32_t srm_num;           /*!< Scale, rotate and mirror operations done */
+    uint32_t fill_num;          /*!< Fill operations done */
+    uint32_t rejected_num;      /*!< Operations rejected for their configuration */
+    float last_scale;           /*!< Scale of the last scale, rotate and mirror operation */
+} ppa_host_usage_t;
+
+/**
+ * @brief Make the next registrations fail, as if the PPA was used by others
+ */
+void ppa_host_set_register_failure(bool is_failing);
+
+/**
+ * @brief Make the next scale, rotate and mirror operations fail
+ */
+void ppa_host_set_srm_failures(uint32_t failure_num);
+
+void ppa_host_get_usage(ppa_host_usage_t *usage);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,195 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ppa_host.h"
+
+#define PPA_SCALE_STEPS     (16)    /*!< The scales are steps of 1/16 */
+#define PPA_SCALE_MAX       (256)   /*!< The scales are below 256 */
+
+struct ppa_client_t {
+    ppa_operation_t oper_type;
+};
+
+static ppa_host_usage_t ppa_usage;
+static bool is_register_failing;
+static uint32_t srm_failure_num;
+
+void ppa_host_set_register_failure(bool is_failing)
+{
+    is_register_failing = is_failing;
+}
+
+void ppa_host_set_srm_failures(uint32_t failure_num)
+{
+    srm_failure_num = failure_num;
+}
+
+void ppa_host_get_usage(ppa_host_usage_t *usage)
+{
+    *usage = ppa_usage;
+}
+
+esp_err_t ppa_register_client(const ppa_client_config_t *config, ppa_client_handle_t *ret_client)
+{
+    if ((config == NULL) || (ret_client == NULL) || (config->oper_type > PPA_OPERATION_FILL)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (is_register_failing) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    ppa_client_handle_t client = calloc(1, sizeof(struct ppa_client_t));
+    if (client == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    client->oper_type = config->oper_type;
+    ppa_usage.clients++;
+    *ret_client = client;
+    return ESP_OK;
+}
+
+esp_err_t ppa_unregister_client(ppa_client_handle_t ppa_client)
+{
+    if (ppa_client == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ppa_usage.clients--;
+    free(ppa_client);
+    return ESP_OK;
+}
+
+static uint32_t get_srm_bytes_per_pixel(ppa_srm_color_mode_t mode)
+{
+    switch (mode) {
+    case PPA_SRM_COLOR_MODE_ARGB8888:
+        return 4;
+    case PPA_SRM_COLOR_MODE_RGB888:
+        return 3;
+    case PPA_SRM_COLOR_MODE_RGB565:
+        return 2;
+    }
+    return 0;
+}
+
+static bool is_valid_scale(float scale)
+{
+    float steps = scale * PPA_SCALE_STEPS;
+    return (scale > 0) && (scale < PPA_SCALE_MAX) && (steps == (float)(uint32_t)steps);
+}
+
+/**
+ * @brief Nearest source pixel of an output pixel, along an axis
+ */
+static uint32_t get_nearest(uint32_t out, float scale, uint32_t size)
+{
+    uint32_t in = (uint32_t)((out + 0.5f) / scale);
+    return (in < size) ? in : size - 1;
+}
+
+esp_err_t ppa_do_scale_rotate_mirror(ppa_client_handle_t ppa_client, const ppa_srm_oper_config_t *config)
+{
+    if ((ppa_client == NULL) || (config == NULL) || (ppa_client->oper_type != PPA_OPERATION_SRM)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (srm_failure_num > 0) {
+        srm_failure_num--;
+        return ESP_FAIL;
+    }
+
+    // The checks of the driver, the output block is the input block scaled, then rotated
+    const ppa_in_pic_blk_config_t *in = &config->in;
+    const ppa_out_pic_blk_config_t *out = &config->out;
+    uint32_t bpp = get_srm_bytes_per_pixel(in->srm_cm);
+    bool quarter = (config->rotation_angle == PPA_SRM_ROTATION_ANGLE_90) ||
+                   (config->rotation_angle == PPA_SRM_ROTATION_ANGLE_270);
+    float scale_u = quarter ? config->scale_y : config->scale_x;
+    float scale_v = quarter ? config->scale_x : config->scale_y;
+    uint32_t rot_width = quarter ? in->block_h : in->block_w;
+    uint32_t rot_height = quarter ? in->block_w : in->block_h;
+    uint32_t out_width = (uint32_t)(rot_width * scale_u);
+    uint32_t out_height = (uint32_t)(rot_height * scale_v);
+    if ((in->buffer == NULL) || (out->buffer == NULL) || (bpp == 0) || (out->srm_cm != in->srm_cm) ||
+            config->mirror_x || config->mirror_y || config->rgb_swap || config->byte_swap ||
+            !is_valid_scale(config->scale_x) || !is_valid_scale(config->scale_y) ||
+            (in->block_w == 0) || (in->block_h == 0) || (in->block_offset_x + in->block_w > in->pic_w) ||
+            (in->block_offset_y + in->block_h > in->pic_h) || (out_width == 0) || (out_height == 0) ||
+            (out->block_offset_x + out_width > out->pic_w) || (out->block_offset_y + out_height > out->pic_h) ||
+            (out->buffer_size < out->pic_w * out->pic_h * bpp)) {
+        ppa_usage.rejected_num++;
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const uint8_t *src = (const uint8_t *)in->buffer + (in->block_offset_y * in->pic_w + in->block_offset_x) * bpp;
+    uint8_t *dst = (uint8_t *)out->buffer + (out->block_offset_y * out->pic_w + out->block_offset_x) * bpp;
+    for (uint32_t v = 0; v < out_height; v++) {
+        uint32_t rot_v = get_nearest(v, scale_v, rot_height);
+        for (uint32_t u = 0; u < out_width; u++) {
+            uint32_t rot_u = get_nearest(u, scale_u, rot_width);
+            // Counter-clockwise
+            uint32_t x = rot_u;
+            uint32_t y = rot_v;
+            switch (config->rotation_angle) {
+            case PPA_SRM_ROTATION_ANGLE_90:
+                x = in->block_w - 1 - rot_v;
+                y = rot_u;
+                break;
+            case PPA_SRM_ROTATION_ANGLE_180:
+                x = in->block_w - 1 - rot_u;
+                y = in->block_h - 1 - rot_v;
+                break;
+            case PPA_SRM_ROTATION_ANGLE_270:
+                x = rot_v;
+                y = in->block_h - 1 - rot_u;
+                break;
+            default:
+                break;
+            }
+            memcpy(dst + (v * out->pic_w + u) * bpp, src + (y * in->pic_w + x) * bpp, bpp);
+        }
+    }
+
+    ppa_usage.srm_num++;
+    ppa_usage.last_scale = config->scale_x;
+    return ESP_OK;
+}
+
+esp_err_t ppa_do_fill(ppa_client_handle_t ppa_client, const ppa_fill_oper_config_t *config)
+{
+    if ((ppa_client == NULL) || (config == NULL) || (ppa_client->oper_type != PPA_OPERATION_FILL)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const ppa_out_pic_blk_config_t *out = &config->out;
+    color_pixel_argb8888_data_t color = config->fill_argb_color;
+    uint8_t pixel[4] = { color.b, color.g, color.r, color.a };
+    uint32_t bpp = 4;
+    if (out->fill_cm == PPA_FILL_COLOR_MODE_RGB888) {
+        bpp = 3;
+    } else if (out->fill_cm == PPA_FILL_COLOR_MODE_RGB565) {
+        uint16_t rgb565 = ((color.r >> 3) << 11) | ((color.g >> 2) << 5) | (color.b >> 3);
+        memcpy(pixel, &rgb565, sizeof(rgb565));
+        bpp = 2;
+    }
+    if ((out->buffer == NULL) || (config->fill_block_w == 0) || (config->fill_block_h == 0) ||
+            (out->block_offset_x + config->fill_block_w > out->pic_w) ||
+            (out->block_offset_y + config->fill_block_h > out->pic_h) ||
+            (out->buffer_size < out->pic_w * out->pic_h * bpp)) {
+        ppa_usage.rejected_num++;
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (uint32_t row = 0; row < config->fill_block_h; row++) {
+        uint8_t *dst = (uint8_t *)out->buffer + ((out->block_offset_y + row) * out->pic_w + out->block_offset_x) * bpp;
+        for (uint32_t i = 0; i < config->fill_block_w; i++) {
+            memcpy(dst + i * bpp, pixel, bpp);
+        }
+    }
+
+    ppa_usage.fill_num++;
+    return ESP_OK;
+}
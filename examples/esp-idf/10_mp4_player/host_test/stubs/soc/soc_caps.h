@@ -0,0 +1,9 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+/* The host has the PPA of the ESP32-P4, modelled in software by `ppa_stub.c` */
+#define SOC_PPA_SUPPORTED               1
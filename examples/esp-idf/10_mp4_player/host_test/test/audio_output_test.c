@@ -0,0 +1,524 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+/**
+ * Test of the audio output, its ring and the task writing the device modelled by `codec_dev_stub.c`, which plays faster
+ * than real time to keep the test short. The audio must reach the device as written, or converted to the format of a
+ * fixed device without clicks, and the device must be reopened when the format of the stream changes. It checks the
+ * pause of the decoding at the high level of the ring, an underrun when the writer stalls, a flush while a write is
+ * blocked, and the audio clock given to the A/V sync.
+ *
+ * Usage: mp4_host_audio_output_test [--quick]
+ */
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "codec_dev_host.h"
+#include "app_audio_output.h"
+
+#define DEV_BUFFER_MS       (40)            /*!< Audio held by the device, as the DMA buffers of the I2S */
+#define DEV_SPEED           (4)             /*!< Speed of the device against real time */
+#define CAPTURE_SIZE        (8 * 1024 * 1024)
+#define TONE_AMPLITUDE      (16000.0)
+#define TIMEOUT_MS          (10000)
+
+static int failure_num = 0;
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+static esp_codec_dev_sample_info_t make_fs(uint32_t rate, uint8_t channels)
+{
+    esp_codec_dev_sample_info_t fs = {
+        .bits_per_sample = 16,
+        .channel = channels,
+        .sample_rate = rate,
+    };
+    return fs;
+}
+
+static app_audio_output_handle_t create_output(esp_codec_dev_handle_t dev, uint32_t rate, uint8_t channels)
+{
+    app_audio_output_config_t config = APP_AUDIO_OUTPUT_CONFIG_DEFAULT();
+    config.dev = dev;
+    config.sample_rate = rate;
+    config.channels = channels;
+    app_audio_output_handle_t output = NULL;
+    TEST_CHECK(app_audio_output_create(&config, &output) == ESP_OK, "Create failed");
+    return output;
+}
+
+/**
+ * @brief Wait until the device played some frames since the last flush
+ *
+ * @return false on timeout
+ */
+static bool wait_played(app_audio_output_handle_t output, uint64_t frames)
+{
+    app_audio_output_stats_t stats = {0};
+    int64_t start_us = esp_timer_get_time();
+    while (esp_timer_get_time() - start_us < TIMEOUT_MS * 1000LL) {
+        app_audio_output_get_stats(output, &stats);
+        if (stats.frames_played >= frames) {
+            return true;
+        }
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+    TEST_CHECK(false, "%" PRIu64 " frames played, %" PRIu64 " expected", stats.frames_played, frames);
+    return false;
+}
+
+/**
+ * @brief Write 16 bits frames in calls of random sizes, each call a segment with a timestamp if `pts` is not 0
+ */
+static void write_frames(app_audio_output_handle_t output, const esp_codec_dev_sample_info_t *fs, uint32_t pts,
+                         const int16_t *samples, uint32_t frames, unsigned int *seed)
+{
+    uint32_t done = 0;
+    while (done < frames) {
+        uint32_t n = 1 + (uint32_t)rand_r(seed) % 4096;
+        if (n > frames - done) {
+            n = frames - done;
+        }
+        uint32_t call_pts = (pts != 0) ? pts + (uint32_t)((uint64_t)done * 1000 / fs->sample_rate) : 0;
+        TEST_CHECK(app_audio_output_write(output, fs, call_pts, samples + done * fs->channel,
+                                          n * fs->channel * sizeof(int16_t)) == ESP_OK, "Write failed");
+        done += n;
+    }
+}
+
+static int16_t *make_noise(uint32_t frames, uint8_t channels, unsigned int *seed)
+{
+    int16_t *samples = malloc(frames * channels * sizeof(int16_t));
+    if (samples == NULL) {
+        TEST_CHECK(false, "No memory for the samples");
+        return NULL;
+    }
+    for (uint32_t i = 0; i < frames * channels; i++) {
+        samples[i] = (int16_t)rand_r(seed);
+    }
+    return samples;
+}
+
+static void test_invalid_args(void)
+{
+    esp_codec_dev_handle_t dev = codec_dev_host_create(DEV_BUFFER_MS, DEV_SPEED, 1024);
+    app_audio_output_config_t config = APP_AUDIO_OUTPUT_CONFIG_DEFAULT();
+    app_audio_output_handle_t output = NULL;
+    esp_codec_dev_sample_info_t fs = make_fs(48000, 2);
+    int16_t samples[4] = {0};
+    app_audio_output_stats_t stats;
+
+    TEST_CHECK(app_audio_output_create(NULL, &output) == ESP_ERR_INVALID_ARG, "Create without a configuration");
+    TEST_CHECK(app_audio_output_create(&config, &output) == ESP_ERR_INVALID_ARG, "Create without a device");
+    config.dev = dev;
+    TEST_CHECK(app_audio_output_create(&config, NULL) == ESP_ERR_INVALID_ARG, "Create without a handle");
+    config.ring_ms = 0;
+    TEST_CHECK(app_audio_output_create(&config, &output) == ESP_ERR_INVALID_ARG, "Create without a ring");
+    config.ring_ms = 500;
+    config.low_percent = 90;
+    TEST_CHECK(app_audio_output_create(&config, &output) == ESP_ERR_INVALID_ARG, "Create with low level at high");
+    config.low_percent = 50;
+    config.high_percent = 101;
+    TEST_CHECK(app_audio_output_create(&config, &output) == ESP_ERR_INVALID_ARG, "Create with high level above 100");
+    config.high_percent = 90;
+
+    TEST_CHECK(app_audio_output_create(&config, &output) == ESP_OK, "Create failed");
+    TEST_CHECK(app_audio_output_write(NULL, &fs, 0, samples, sizeof(samples)) == ESP_ERR_INVALID_ARG,
+               "Write without an output");
+    TEST_CHECK(app_audio_output_write(output, NULL, 0, samples, sizeof(samples)) == ESP_ERR_INVALID_ARG,
+               "Write without a format");
+    TEST_CHECK(app_audio_output_write(output, &fs, 0, NULL, sizeof(samples)) == ESP_ERR_INVALID_ARG,
+               "Write without samples");
+    fs.channel = 0;
+    TEST_CHECK(app_audio_output_write(output, &fs, 0, samples, sizeof(samples)) == ESP_ERR_INVALID_ARG,
+               "Write without channels");
+    TEST_CHECK(app_audio_output_set_av_sync(NULL, NULL) == ESP_ERR_INVALID_ARG, "A/V sync without an output");
+    TEST_CHECK(app_audio_output_flush(NULL) == ESP_ERR_INVALID_ARG, "Flush without an output");
+    TEST_CHECK(app_audio_output_get_stats(NULL, &stats) == ESP_ERR_INVALID_ARG, "Stats without an output");
+    TEST_CHECK(app_audio_output_get_stats(output, NULL) == ESP_ERR_INVALID_ARG, "Stats without output");
+    TEST_CHECK(app_audio_output_destroy(output) == ESP_OK, "Destroy failed");
+    TEST_CHECK(app_audio_output_destroy(NULL) == ESP_ERR_INVALID_ARG, "Destroy without an output");
+    codec_dev_host_destroy(dev);
+}
+
+static void test_passthrough(uint32_t seconds)
+{
+    // A device following the stream gets the samples as written, through the pauses of the decoding
+    const esp_codec_dev_sample_info_t fs = make_fs(44100, 2);
+    const uint32_t frames = fs.sample_rate * seconds;
+    unsigned int seed = 1;
+    int16_t *samples = make_noise(frames, fs.channel, &seed);
+    esp_codec_dev_handle_t dev = codec_dev_host_create(DEV_BUFFER_MS, DEV_SPEED, CAPTURE_SIZE);
+    app_audio_output_handle_t output = create_output(dev, 0, 0);
+    if ((samples == NULL) || (output == NULL)) {
+        free(samples);
+        codec_dev_host_destroy(dev);
+        return;
+    }
+
+    write_frames(output, &fs, 0, samples, frames, &seed);
+    wait_played(output, frames);
+
+    app_audio_output_stats_t stats;
+    codec_dev_host_usage_t usage;
+    app_audio_output_get_stats(output, &stats);
+    codec_dev_host_get_usage(dev, &usage);
+    uint64_t size = (uint64_t)frames * fs.channel * sizeof(int16_t);
+    TEST_CHECK(stats.frames_played == frames, "%" PRIu64 " frames played of %" PRIu32, stats.frames_played, frames);
+    TEST_CHECK(usage.bytes == size, "%" PRIu64 " bytes on the device of %" PRIu64, usage.bytes, size);
+    TEST_CHECK((usage.bytes != size) || (memcmp(codec_dev_host_get_capture(dev), samples, size) == 0),
+               "The device did not get the samples written");
+    TEST_CHECK((usage.opens == 1) && (usage.fs.sample_rate == 44100) && (usage.fs.channel == 2) &&
+               (usage.fs.bits_per_sample == 16), "Device opened %" PRIu32 " times, last at %" PRIu32 " Hz %u ch",
+               usage.opens, usage.fs.sample_rate, usage.fs.channel);
+    TEST_CHECK((stats.in_rate == 44100) && (stats.out_rate == 44100) && (stats.out_channels == 2),
+               "Stats of %" PRIu32 " Hz to %" PRIu32 " Hz %u ch", stats.in_rate, stats.out_rate, stats.out_channels);
+    // The ring holds half a second, the decoding pauses several times
+    TEST_CHECK(stats.decode_waits >= seconds, "%" PRIu32 " pauses of the decoding", stats.decode_waits);
+    TEST_CHECK(stats.underruns == 0, "%" PRIu32 " underruns", stats.underruns);
+    TEST_CHECK(usage.gaps == 0, "%" PRIu32 " gaps on the device, %" PRIu64 " us at most", usage.gaps,
+               usage.gap_max_us);
+    TEST_CHECK(stats.dev_reopens == 0, "%" PRIu32 " reopens", stats.dev_reopens);
+
+    app_audio_output_destroy(output);
+    codec_dev_host_get_usage(dev, &usage);
+    TEST_CHECK(!usage.is_open, "Device left open");
+    codec_dev_host_destroy(dev);
+    free(samples);
+}
+
+static void test_fixed_device(uint32_t seconds)
+{
+    // A 48 kHz stereo device plays a 44.1 kHz mono tone, converted on its way into the ring
+    const esp_codec_dev_sample_info_t fs = make_fs(44100, 1);
+    const uint32_t frames = fs.sample_rate * seconds;
+    const double freq = 1000.0;
+    int16_t *samples = malloc(frames * sizeof(int16_t));
+    esp_codec_dev_handle_t dev = codec_dev_host_create(DEV_BUFFER_MS, DEV_SPEED, CAPTURE_SIZE);
+    app_audio_output_handle_t output = create_output(dev, 48000, 2);
+    if ((samples == NULL) || (output == NULL)) {
+        TEST_CHECK(false, "No memory for the samples");
+        free(samples);
+        app_audio_output_destroy(output);
+        codec_dev_host_destroy(dev);
+        return;
+    }
+    for (uint32_t i = 0; i < frames; i++) {
+        samples[i] = (int16_t)lrint(TONE_AMPLITUDE * sin(2.0 * M_PI * freq * i / fs.sample_rate));
+    }
+
+    // The filter of the resampler keeps its last input samples
+    unsigned int seed = 2;
+    uint32_t out_frames = 48000 * seconds - 32;
+    write_frames(output, &fs, 0, samples, frames, &seed);
+    wait_played(output, out_frames);
+
+    codec_dev_host_usage_t usage;
+    app_audio_output_stats_t stats;
+    codec_dev_host_get_usage(dev, &usage);
+    app_audio_output_get_stats(output, &stats);
+    TEST_CHECK((usage.opens == 1) && (usage.fs.sample_rate == 48000) && (usage.fs.channel == 2),
+               "Device opened %" PRIu32 " times, last at %" PRIu32 " Hz %u ch",
+               usage.opens, usage.fs.sample_rate, usage.fs.channel);
+    TEST_CHECK((stats.in_rate == 44100) && (stats.out_rate == 48000) && (stats.out_channels == 2),
+               "Stats of %" PRIu32 " Hz to %" PRIu32 " Hz %u ch", stats.in_rate, stats.out_rate, stats.out_channels);
+
+    // The tone fitted by least squares, anything else is noise, and a click between two writes a jump
+    const int16_t *out = (const int16_t *)codec_dev_host_get_capture(dev);
+    uint32_t captured = (uint32_t)(usage.bytes / (2 * sizeof(int16_t)));
+    double ss = 0, sc = 0, cc = 0, ys = 0, yc = 0, yy = 0;
+    uint32_t mismatches = 0;
+    int32_t max_step = 0;
+    for (uint32_t i = 64; i < captured; i++) {
+        double w = 2.0 * M_PI * freq * i / 48000;
+        double y = out[i * 2];
+        ss += sin(w) * sin(w);
+        sc += sin(w) * cos(w);
+        cc += cos(w) * cos(w);
+        ys += y * sin(w);
+        yc += y * cos(w);
+        yy += y * y;
+        if (out[i * 2] != out[i * 2 + 1]) {
+            mismatches++;
+        }
+        int32_t step = abs(out[i * 2] - out[(i - 1) * 2]);
+        if (step > max_step) {
+            max_step = step;
+        }
+    }
+    double det = ss * cc - sc * sc;
+    double a = (ys * cc - yc * sc) / det;
+    double b = (yc * ss - ys * sc) / det;
+    double tone = a * ys + b * yc;
+    double snr_db = 10.0 * log10(tone / (yy - tone));
+    double gain_db = 20.0 * log10(sqrt(a * a + b * b) / TONE_AMPLITUDE);
+    double phase_deg = atan2(b, a) * 180.0 / M_PI;
+    int32_t step_limit = (int32_t)(TONE_AMPLITUDE * 2.0 * M_PI * freq / 48000 * 1.05);
+    TEST_CHECK(mismatches == 0, "%" PRIu32 " frames with different channels", mismatches);
+    TEST_CHECK(fabs(gain_db) < 0.1, "Gain of %.3f dB", gain_db);
+    TEST_CHECK(fabs(phase_deg) < 0.5, "Phase of %.2f degrees", phase_deg);
+    TEST_CHECK(snr_db > 60.0, "SNR of %.1f dB", snr_db);
+    TEST_CHECK(max_step <= step_limit, "Step of %" PRId32 " between two samples, %" PRId32 " at most",
+               max_step, step_limit);
+
+    app_audio_output_destroy(output);
+    codec_dev_host_destroy(dev);
+    free(samples);
+}
+
+static void test_format_change(void)
+{
+    // The second stream follows the first one in the ring, with another format
+    const esp_codec_dev_sample_info_t fs_a = make_fs(44100, 2);
+    const esp_codec_dev_sample_info_t fs_b = make_fs(48000, 1);
+    const uint32_t frames_a = fs_a.sample_rate * 3 / 10;
+    const uint32_t frames_b = fs_b.sample_rate * 3 / 10;
+    unsigned int seed = 3;
+    int16_t *samples_a = make_noise(frames_a, fs_a.channel, &seed);
+    int16_t *samples_b = make_noise(frames_b, fs_b.channel, &seed);
+
+    for (int fixed = 0; (fixed < 2) && (samples_a != NULL) && (samples_b != NULL); fixed++) {
+        esp_codec_dev_handle_t dev = codec_dev_host_create(DEV_BUFFER_MS, DEV_SPEED, CAPTURE_SIZE);
+        app_audio_output_handle_t output = create_output(dev, fixed ? 48000 : 0, fixed ? 2 : 0);
+        if (output == NULL) {
+            codec_dev_host_destroy(dev);
+            continue;
+        }
+        write_frames(output, &fs_a, 0, samples_a, frames_a, &seed);
+        write_frames(output, &fs_b, 1000, samples_b, frames_b, &seed);
+
+        codec_dev_host_usage_t usage;
+        app_audio_output_stats_t stats;
+        if (fixed) {
+            // Converted to the format of the device, which is opened once
+            wait_played(output, (uint64_t)frames_b + 48000 * 3 / 10 - 64);
+            app_audio_output_get_stats(output, &stats);
+            codec_dev_host_get_usage(dev, &usage);
+            TEST_CHECK((usage.opens == 1) && (stats.dev_reopens == 0) && (usage.fs.sample_rate == 48000) &&
+                       (usage.fs.channel == 2), "Fixed device opened %" PRIu32 " times, %" PRIu32 " reopens",
+                       usage.opens, stats.dev_reopens);
+        } else {
+            wait_played(output, (uint64_t)frames_a + frames_b);
+            app_audio_output_get_stats(output, &stats);
+            codec_dev_host_get_usage(dev, &usage);
+            uint64_t size = (uint64_t)frames_b * sizeof(int16_t);
+            TEST_CHECK((usage.opens == 2) && (stats.dev_reopens == 1),
+                       "Device opened %" PRIu32 " times, %" PRIu32 " reopens", usage.opens, stats.dev_reopens);
+            TEST_CHECK((usage.fs.sample_rate == 48000) && (usage.fs.channel == 1) && (stats.out_rate == 48000) &&
+                       (stats.out_channels == 1), "Device reopened at %" PRIu32 " Hz %u ch",
+                       usage.fs.sample_rate, usage.fs.channel);
+            TEST_CHECK((usage.bytes == size) && (memcmp(codec_dev_host_get_capture(dev), samples_b, size) == 0),
+                       "The reopened device did not get the second stream, %" PRIu64 " bytes", usage.bytes);
+        }
+        app_audio_output_destroy(output);
+        codec_dev_host_destroy(dev);
+    }
+    free(samples_a);
+    free(samples_b);
+}
+
+static void test_underrun(void)
+{
+    // The writer stalls once the device played its audio, so the ring runs empty
+    const esp_codec_dev_sample_info_t fs = make_fs(48000, 2);
+    const uint32_t frames = fs.sample_rate / 5;
+    const uint32_t stall_ms = 150;
+    unsigned int seed = 4;
+    int16_t *samples = make_noise(frames, fs.channel, &seed);
+    esp_codec_dev_handle_t dev = codec_dev_host_create(DEV_BUFFER_MS, DEV_SPEED, CAPTURE_SIZE);
+    app_audio_output_handle_t output = create_output(dev, 0, 0);
+    if ((samples == NULL) || (output == NULL)) {
+        free(samples);
+        codec_dev_host_destroy(dev);
+        return;
+    }
+
+    TEST_CHECK(app_audio_output_write(output, &fs, 0, samples, frames * 4) == ESP_OK, "Write failed");
+    wait_played(output, frames);
+    vTaskDelay(pdMS_TO_TICKS(stall_ms));
+    TEST_CHECK(app_audio_output_write(output, &fs, 0, samples, frames * 4) == ESP_OK, "Write failed");
+    wait_played(output, frames * 2);
+
+    app_audio_output_stats_t stats;
+    codec_dev_host_usage_t usage;
+    app_audio_output_get_stats(output, &stats);
+    codec_dev_host_get_usage(dev, &usage);
+    TEST_CHECK(stats.underruns == 1, "%" PRIu32 " underruns", stats.underruns);
+    TEST_CHECK((stats.underrun_max_ms >= stall_ms) && (stats.underrun_max_ms < stall_ms + 200) &&
+               (stats.underrun_total_ms == stats.underrun_max_ms),
+               "Underrun of %" PRIu32 " ms, %" PRIu32 " ms in total, after a stall of %" PRIu32 " ms",
+               stats.underrun_max_ms, stats.underrun_total_ms, stall_ms);
+    // The device still held its buffer when the writer stalled
+    TEST_CHECK((usage.gaps == 1) && (usage.gap_max_us >= (stall_ms - DEV_BUFFER_MS / DEV_SPEED) * 1000ULL),
+               "%" PRIu32 " gaps on the device, %" PRIu64 " us at most", usage.gaps, usage.gap_max_us);
+    TEST_CHECK(stats.frames_played == frames * 2, "%" PRIu64 " frames played of %" PRIu32, stats.frames_played,
+               frames * 2);
+
+    app_audio_output_destroy(output);
+    codec_dev_host_destroy(dev);
+    free(samples);
+}
+
+typedef struct {
+    app_audio_output_handle_t output;
+    const int16_t *samples;
+    uint32_t frames;
+    esp_err_t ret;
+    SemaphoreHandle_t done;
+} writer_context_t;
+
+/**
+ * @brief Task writing decoded frames of 1024 samples, as the audio decoder does, until a write fails
+ */
+static void writer_task(void *arg)
+{
+    writer_context_t *context = arg;
+    esp_codec_dev_sample_info_t fs = make_fs(48000, 2);
+    for (uint32_t done = 0; (done < context->frames) && (context->ret == ESP_OK); done += 1024) {
+        uint32_t n = (context->frames - done < 1024) ? context->frames - done : 1024;
+        context->ret = app_audio_output_write(context->output, &fs, 0, context->samples + done * 2, n * 4);
+    }
+    xSemaphoreGive(context->done);
+    vTaskDelete(NULL);
+}
+
+static void test_flush(void)
+{
+    // The writer of 3 s in real time waits for room in the ring of 500 ms
+    const esp_codec_dev_sample_info_t fs = make_fs(48000, 2);
+    const uint32_t frames = fs.sample_rate * 3;
+    unsigned int seed = 5;
+    int16_t *samples = make_noise(frames, fs.channel, &seed);
+    esp_codec_dev_handle_t dev = codec_dev_host_create(DEV_BUFFER_MS, 1, CAPTURE_SIZE);
+    app_audio_output_handle_t output = create_output(dev, 0, 0);
+    if ((samples == NULL) || (output == NULL)) {
+        free(samples);
+        codec_dev_host_destroy(dev);
+        return;
+    }
+
+    writer_context_t context = {
+        .output = output,
+        .samples = samples,
+        .frames = frames,
+        .ret = ESP_OK,
+        .done = xSemaphoreCreateBinary(),
+    };
+    TEST_CHECK(xTaskCreate(writer_task, "writer", 4096, &context, 5, NULL) == pdPASS, "Task failed");
+    vTaskDelay(pdMS_TO_TICKS(200));
+
+    app_audio_output_stats_t stats;
+    app_audio_output_get_stats(output, &stats);
+    TEST_CHECK(stats.decode_waits > 0, "%" PRIu32 " pauses of the decoding", stats.decode_waits);
+    TEST_CHECK(xSemaphoreTake(context.done, 0) == pdFALSE, "The write returned before the flush");
+    app_audio_output_flush(output);
+    TEST_CHECK(xSemaphoreTake(context.done, pdMS_TO_TICKS(500)) == pdTRUE, "The write did not return on the flush");
+    TEST_CHECK(context.ret == ESP_ERR_INVALID_STATE, "The flushed write returned %d", context.ret);
+
+    // At most the chunk being written to the device when the ring was flushed
+    app_audio_output_get_stats(output, &stats);
+    TEST_CHECK(stats.frames_played <= fs.sample_rate / 50, "%" PRIu64 " frames played after the flush",
+               stats.frames_played);
+    TEST_CHECK(stats.decode_waits == 0, "%" PRIu32 " pauses of the decoding after the flush", stats.decode_waits);
+
+    // The output plays on after the flush
+    TEST_CHECK(app_audio_output_write(output, &fs, 2000, samples, fs.sample_rate / 10 * 4) == ESP_OK,
+               "Write after the flush failed");
+    wait_played(output, fs.sample_rate / 10);
+
+    app_audio_output_destroy(output);
+    codec_dev_host_destroy(dev);
+    vSemaphoreDelete(context.done);
+    free(samples);
+}
+
+static void test_av_sync(void)
+{
+    // The audio clock follows the timestamps of the audio played, in real time
+    const esp_codec_dev_sample_info_t fs = make_fs(48000, 2);
+    const uint32_t frames = fs.sample_rate * 4 / 10;
+    const uint32_t first_pts = 5000;
+    unsigned int seed = 6;
+    int16_t *samples = make_noise(frames, fs.channel, &seed);
+    esp_codec_dev_handle_t dev = codec_dev_host_create(DEV_BUFFER_MS, 1, CAPTURE_SIZE);
+    app_audio_output_handle_t output = create_output(dev, 0, 0);
+    app_av_sync_config_t sync_config = APP_AV_SYNC_CONFIG_DEFAULT();
+    sync_config.audio_latency_ms = DEV_BUFFER_MS;
+    app_av_sync_handle_t sync = NULL;
+    TEST_CHECK(app_av_sync_create(&sync_config, &sync) == ESP_OK, "A/V sync create failed");
+    if ((samples == NULL) || (output == NULL) || (sync == NULL)) {
+        free(samples);
+        app_audio_output_destroy(output);
+        app_av_sync_destroy(sync);
+        codec_dev_host_destroy(dev);
+        return;
+    }
+    TEST_CHECK(app_audio_output_set_av_sync(output, sync) == ESP_OK, "Set A/V sync failed");
+
+    int64_t start_us = esp_timer_get_time();
+    write_frames(output, &fs, first_pts, samples, frames, &seed);
+    vTaskDelay(pdMS_TO_TICKS(200));
+
+    // A frame 100 ms ahead of the audio waits for it, a frame 100 ms behind is dropped, beyond the tolerance
+    int64_t now_us = esp_timer_get_time();
+    uint32_t pts = first_pts + (uint32_t)((now_us - start_us) / 1000);
+    uint32_t wait_ms = 0;
+    app_av_sync_action_t action = app_av_sync_check_video(sync, pts + 100, now_us, &wait_ms);
+    TEST_CHECK((action == APP_AV_SYNC_WAIT) && (wait_ms == sync_config.tolerance_ms),
+               "Frame 100 ms ahead: action %d, wait of %" PRIu32 " ms", action, wait_ms);
+    action = app_av_sync_check_video(sync, pts - 100, now_us, &wait_ms);
+    TEST_CHECK(action == APP_AV_SYNC_DROP, "Frame 100 ms behind: action %d", action);
+
+    app_av_sync_stats_t sync_stats;
+    app_av_sync_get_stats(sync, &sync_stats);
+    TEST_CHECK(sync_stats.audio_master, "The audio is not the master clock");
+
+    app_audio_output_destroy(output);
+    app_av_sync_destroy(sync);
+    codec_dev_host_destroy(dev);
+    free(samples);
+}
+
+int main(int argc, char **argv)
+{
+    bool is_quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !is_quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The dropped partial frames and flushed writes are expected
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    test_invalid_args();
+    test_passthrough(is_quick ? 2 : 20);
+    test_fixed_device(is_quick ? 1 : 10);
+    test_format_change();
+    test_underrun();
+    test_flush();
+    test_av_sync();
+
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,540 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+/**
+ * Test of the audio resampler. It checks the conversions of the sample formats and channels against a plain reference,
+ * then resamples tones between the usual rates and fits a sine to the output: its gain, its phase, so the output is
+ * not delayed, and the noise and distortion left. A tone above the lower rate checks the anti-aliasing filter. The
+ * same stream cut into random calls, or after a reset, must give the same samples as in one call.
+ *
+ * Usage: mp4_host_audio_resampler_test [--quick]
+ */
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "app_audio_resampler.h"
+
+#define TAPS                (32)        /*!< Input samples per output sample of the filter */
+#define TONE_AMPLITUDE      (16000.0)
+
+static int failure_num = 0;
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+typedef struct {
+    uint32_t in_rate;
+    uint32_t out_rate;
+} rate_pair_t;
+
+/**
+ * @brief Sine fitted to resampled samples
+ */
+typedef struct {
+    double gain;                /*!< Amplitude of the output over the one of the input */
+    double phase_deg;           /*!< Phase of the output against the input at the same time */
+    double snr_db;              /*!< Tone over the rest of the output, noise and distortion */
+} tone_fit_t;
+
+static app_audio_resampler_handle_t create_resampler(uint32_t in_rate, uint8_t in_channels, uint8_t in_bits,
+                                                     uint32_t out_rate, uint8_t out_channels)
+{
+    app_audio_resampler_config_t config = {
+        .in_rate = in_rate,
+        .in_channels = in_channels,
+        .in_bits = in_bits,
+        .out_rate = out_rate,
+        .out_channels = out_channels,
+    };
+    app_audio_resampler_handle_t resampler = NULL;
+    TEST_CHECK(app_audio_resampler_create(&config, &resampler) == ESP_OK,
+               "Create failed: %" PRIu32 " Hz %u ch %u bits to %" PRIu32 " Hz %u ch",
+               in_rate, in_channels, in_bits, out_rate, out_channels);
+    return resampler;
+}
+
+/**
+ * @brief Resample 16 bits frames in calls of `chunk_frames`, or of random sizes up to it if `seed` is not NULL
+ *
+ * @return Number of output frames
+ */
+static uint32_t resample(app_audio_resampler_handle_t resampler, const int16_t *in, uint32_t frames,
+                         uint8_t in_channels, uint8_t out_channels, uint32_t chunk_frames, unsigned int *seed,
+                         int16_t *out)
+{
+    uint32_t out_frames = 0;
+    uint32_t done = 0;
+    while (done < frames) {
+        uint32_t n = (seed != NULL) ? (uint32_t)rand_r(seed) % (chunk_frames + 1) : chunk_frames;
+        if (n > frames - done) {
+            n = frames - done;
+        }
+        uint32_t in_size = n * in_channels * sizeof(int16_t);
+        uint32_t out_size = 0;
+        TEST_CHECK(app_audio_resampler_process(resampler, in + done * in_channels, in_size,
+                                               out + out_frames * out_channels, &out_size) == ESP_OK,
+                   "Process failed");
+        TEST_CHECK(out_size <= app_audio_resampler_get_out_size(resampler, in_size),
+                   "Output of %" PRIu32 " bytes above the bound of %" PRIu32 " for %" PRIu32 " input bytes",
+                   out_size, app_audio_resampler_get_out_size(resampler, in_size), in_size);
+        out_frames += out_size / (out_channels * sizeof(int16_t));
+        done += n;
+    }
+    return out_frames;
+}
+
+static void fill_tone(int16_t *samples, uint32_t frames, uint8_t channels, double freq, uint32_t rate)
+{
+    for (uint32_t i = 0; i < frames; i++) {
+        int16_t value = (int16_t)lrint(TONE_AMPLITUDE * sin(2.0 * M_PI * freq * i / rate));
+        for (uint8_t c = 0; c < channels; c++) {
+            samples[i * channels + c] = value;
+        }
+    }
+}
+
+/**
+ * @brief Fit a sine of a frequency to a channel, by least squares from the frame `first` on
+ */
+static tone_fit_t fit_tone(const int16_t *samples, uint32_t first, uint32_t frames, uint8_t channels, uint8_t channel,
+                           double freq, uint32_t rate)
+{
+    double ss = 0, sc = 0, cc = 0, ys = 0, yc = 0, yy = 0;
+    for (uint32_t i = first; i < frames; i++) {
+        double w = 2.0 * M_PI * freq * i / rate;
+        double s = sin(w);
+        double c = cos(w);
+        double y = samples[i * channels + channel];
+        ss += s * s;
+        sc += s * c;
+        cc += c * c;
+        ys += y * s;
+        yc += y * c;
+        yy += y * y;
+    }
+    double det = ss * cc - sc * sc;
+    double a = (ys * cc - yc * sc) / det;
+    double b = (yc * ss - ys * sc) / det;
+    double tone = a * ys + b * yc;
+    double rest = yy - tone;
+    tone_fit_t fit = {
+        .gain = sqrt(a * a + b * b) / TONE_AMPLITUDE,
+        .phase_deg = atan2(b, a) * 180.0 / M_PI,
+        .snr_db = (rest > 0) ? 10.0 * log10(tone / rest) : 200.0,
+    };
+    return fit;
+}
+
+static double get_rms(const int16_t *samples, uint32_t first, uint32_t frames, uint8_t channels)
+{
+    double sum = 0;
+    for (uint32_t i = first; i < frames; i++) {
+        sum += (double)samples[i * channels] * samples[i * channels];
+    }
+    return (frames > first) ? sqrt(sum / (frames - first)) : 0;
+}
+
+static void test_invalid_args(void)
+{
+    app_audio_resampler_config_t config = {
+        .in_rate = 44100, .in_channels = 2, .in_bits = 16, .out_rate = 48000, .out_channels = 2,
+    };
+    app_audio_resampler_handle_t resampler = NULL;
+    int16_t samples[16] = {0};
+    uint32_t out_size = 0;
+
+    TEST_CHECK(app_audio_resampler_create(NULL, &resampler) == ESP_ERR_INVALID_ARG, "Create without a configuration");
+    TEST_CHECK(app_audio_resampler_create(&config, NULL) == ESP_ERR_INVALID_ARG, "Create without a handle");
+    config.in_rate = 0;
+    TEST_CHECK(app_audio_resampler_create(&config, &resampler) == ESP_ERR_INVALID_ARG, "Create without a rate");
+    config.in_rate = 44100;
+    config.in_channels = 9;
+    TEST_CHECK(app_audio_resampler_create(&config, &resampler) == ESP_ERR_INVALID_ARG, "Create with 9 channels");
+    config.in_channels = 2;
+    config.out_channels = 0;
+    TEST_CHECK(app_audio_resampler_create(&config, &resampler) == ESP_ERR_INVALID_ARG, "Create without channels");
+    config.out_channels = 2;
+    config.in_bits = 20;
+    TEST_CHECK(app_audio_resampler_create(&config, &resampler) == ESP_ERR_INVALID_ARG, "Create with 20 bits");
+    config.in_bits = 16;
+
+    // A decimation by more than 16 is beyond the taps of an output sample
+    config.in_rate = 96000;
+    config.out_rate = 6000;
+    TEST_CHECK(app_audio_resampler_create(&config, &resampler) == ESP_OK, "Create failed for a ratio of 16");
+    app_audio_resampler_destroy(resampler);
+    config.out_rate = 5999;
+    TEST_CHECK(app_audio_resampler_create(&config, &resampler) == ESP_ERR_NOT_SUPPORTED,
+               "Create with a ratio above 16");
+    config.in_rate = 44100;
+    config.out_rate = 48000;
+
+    TEST_CHECK(app_audio_resampler_create(&config, &resampler) == ESP_OK, "Create failed");
+    TEST_CHECK(app_audio_resampler_process(NULL, samples, 4, samples, &out_size) == ESP_ERR_INVALID_ARG,
+               "Process without a resampler");
+    TEST_CHECK(app_audio_resampler_process(resampler, NULL, 4, samples, &out_size) == ESP_ERR_INVALID_ARG,
+               "Process without an input");
+    TEST_CHECK(app_audio_resampler_process(resampler, samples, 4, NULL, &out_size) == ESP_ERR_INVALID_ARG,
+               "Process without an output");
+    TEST_CHECK(app_audio_resampler_process(resampler, samples, 4, samples, NULL) == ESP_ERR_INVALID_ARG,
+               "Process without an output size");
+    TEST_CHECK(app_audio_resampler_process(resampler, NULL, 0, samples, &out_size) == ESP_OK,
+               "Process of no input failed");
+    TEST_CHECK(out_size == 0, "%" PRIu32 " bytes out of no input", out_size);
+    TEST_CHECK(app_audio_resampler_get_out_size(NULL, 4) == 0, "Output size without a resampler");
+    app_audio_resampler_reset(NULL);
+    app_audio_resampler_destroy(resampler);
+    TEST_CHECK(app_audio_resampler_destroy(NULL) == ESP_ERR_INVALID_ARG, "Destroy without a resampler");
+}
+
+/**
+ * @brief 16 bits value of an input sample, the upper bytes of a wider one
+ */
+static int16_t get_reference(const uint8_t *p, uint8_t bits)
+{
+    switch (bits) {
+    case 8:
+        return (int16_t)((p[0] - 128) * 256);
+    case 24:
+        return (int16_t)(p[1] | (p[2] << 8));
+    case 32:
+        return (int16_t)(p[2] | (p[3] << 8));
+    default:
+        return (int16_t)(p[0] | (p[1] << 8));
+    }
+}
+
+static void test_formats(void)
+{
+    static const uint8_t bits_list[] = {8, 16, 24, 32};
+    static const uint8_t channels_list[] = {1, 2, 3, 6, 8};
+    const uint32_t frames = 1000;
+    uint8_t *in = malloc(frames * 8 * 4);
+    int16_t *out = malloc(frames * 8 * sizeof(int16_t));
+    if ((in == NULL) || (out == NULL)) {
+        TEST_CHECK(false, "No memory for the samples");
+        free(in);
+        free(out);
+        return;
+    }
+    unsigned int seed = 1;
+
+    for (size_t b = 0; b < sizeof(bits_list); b++) {
+        for (size_t i = 0; i < sizeof(channels_list); i++) {
+            for (size_t o = 0; o < sizeof(channels_list); o++) {
+                uint8_t bits = bits_list[b];
+                uint8_t in_channels = channels_list[i];
+                uint8_t out_channels = channels_list[o];
+                uint32_t sample_size = bits / 8;
+                uint32_t in_size = frames * in_channels * sample_size;
+                for (uint32_t k = 0; k < in_size; k++) {
+                    in[k] = (uint8_t)rand_r(&seed);
+                }
+
+                app_audio_resampler_handle_t resampler = create_resampler(48000, in_channels, bits, 48000,
+                                                                          out_channels);
+                if (resampler == NULL) {
+                    continue;
+                }
+                uint32_t out_size = 0;
+                TEST_CHECK(app_audio_resampler_process(resampler, in, in_size, out, &out_size) == ESP_OK,
+                           "Process failed");
+                TEST_CHECK(out_size == frames * out_channels * sizeof(int16_t),
+                           "%u bits %u to %u ch: %" PRIu32 " bytes out of %" PRIu32 " frames",
+                           bits, in_channels, out_channels, out_size, frames);
+                TEST_CHECK(out_size == app_audio_resampler_get_out_size(resampler, in_size),
+                           "%u bits %u to %u ch: output size %" PRIu32 " announced as %" PRIu32,
+                           bits, in_channels, out_channels, out_size,
+                           app_audio_resampler_get_out_size(resampler, in_size));
+
+                // Fewer input channels are copied in turn, more are averaged into the output channels
+                uint32_t mismatches = 0;
+                for (uint32_t f = 0; (f < frames) && (mismatches == 0); f++) {
+                    const uint8_t *frame = in + f * in_channels * sample_size;
+                    for (uint8_t c = 0; c < out_channels; c++) {
+                        int32_t expected = 0;
+                        if (in_channels <= out_channels) {
+                            expected = get_reference(frame + (c % in_channels) * sample_size, bits);
+                        } else {
+                            int32_t sum = 0;
+                            int32_t count = 0;
+                            for (uint8_t k = c; k < in_channels; k += out_channels) {
+                                sum += get_reference(frame + k * sample_size, bits);
+                                count++;
+                            }
+                            expected = sum / count;
+                        }
+                        if (out[f * out_channels + c] != expected) {
+                            TEST_CHECK(false, "%u bits %u to %u ch: frame %" PRIu32 " channel %u is %d, not %" PRId32,
+                                       bits, in_channels, out_channels, f, c, out[f * out_channels + c], expected);
+                            mismatches++;
+                            break;
+                        }
+                    }
+                }
+                app_audio_resampler_destroy(resampler);
+            }
+        }
+    }
+    free(in);
+    free(out);
+}
+
+static void test_tones(const rate_pair_t *pairs, size_t pair_num, uint32_t seconds)
+{
+    static const double freqs[] = {100, 1000, 3000};
+
+    for (size_t p = 0; p < pair_num; p++) {
+        uint32_t in_rate = pairs[p].in_rate;
+        uint32_t out_rate = pairs[p].out_rate;
+        uint32_t in_frames = in_rate * seconds;
+        uint32_t max_frames = (uint32_t)((uint64_t)in_frames * out_rate / in_rate) + 2;
+        int16_t *in = malloc(in_frames * 2 * sizeof(int16_t));
+        int16_t *out = malloc(max_frames * 2 * sizeof(int16_t));
+        if ((in == NULL) || (out == NULL)) {
+            TEST_CHECK(false, "No memory for the samples");
+            free(in);
+            free(out);
+            return;
+        }
+
+        for (size_t t = 0; t < sizeof(freqs) / sizeof(freqs[0]); t++) {
+            double freq = freqs[t];
+            // In the passband of both rates
+            if (freq > 0.3 * ((in_rate < out_rate) ? in_rate : out_rate)) {
+                continue;
+            }
+            app_audio_resampler_handle_t resampler = create_resampler(in_rate, 2, 16, out_rate, 2);
+            if (resampler == NULL) {
+                continue;
+            }
+            fill_tone(in, in_frames, 2, freq, in_rate);
+            uint32_t out_frames = resample(resampler, in, in_frames, 2, 2, 441, NULL, out);
+            app_audio_resampler_destroy(resampler);
+
+            // The filter keeps half of its taps until the next call
+            double expected = (double)in_frames * out_rate / in_rate;
+            double held = (double)(TAPS / 2 + 1) * out_rate / in_rate + 1;
+            TEST_CHECK((out_frames <= expected + 1) && (out_frames + held >= expected),
+                       "%" PRIu32 " to %" PRIu32 " Hz: %" PRIu32 " frames out of %" PRIu32 ", %.1f expected",
+                       in_rate, out_rate, out_frames, in_frames, expected);
+
+            // The first output samples are the step response of the filter
+            uint32_t settle = TAPS * out_rate / in_rate + TAPS;
+            for (uint8_t c = 0; c < 2; c++) {
+                tone_fit_t fit = fit_tone(out, settle, out_frames, 2, c, freq, out_rate);
+                TEST_CHECK(fabs(20.0 * log10(fit.gain)) < 0.1,
+                           "%" PRIu32 " to %" PRIu32 " Hz, %.0f Hz: gain of %.3f dB",
+                           in_rate, out_rate, freq, 20.0 * log10(fit.gain));
+                TEST_CHECK(fabs(fit.phase_deg) < 0.5,
+                           "%" PRIu32 " to %" PRIu32 " Hz, %.0f Hz: phase of %.2f degrees",
+                           in_rate, out_rate, freq, fit.phase_deg);
+                TEST_CHECK(fit.snr_db > 65.0,
+                           "%" PRIu32 " to %" PRIu32 " Hz, %.0f Hz: SNR of %.1f dB",
+                           in_rate, out_rate, freq, fit.snr_db);
+            }
+        }
+        free(in);
+        free(out);
+    }
+}
+
+static void test_anti_alias(void)
+{
+    // A tone above half of the output rate would fold into the passband
+    static const struct {
+        uint32_t in_rate;
+        uint32_t out_rate;
+        double freq;
+    } cases[] = {
+        {48000, 16000, 12000}, {44100, 22050, 16000}, {48000, 44100, 24000}, {96000, 48000, 30000}, {44100, 8000, 7000},
+        {96000, 8000, 8000},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        uint32_t in_frames = cases[i].in_rate;
+        uint32_t max_frames = cases[i].out_rate + 2;
+        int16_t *in = malloc(in_frames * sizeof(int16_t));
+        int16_t *out = malloc(max_frames * sizeof(int16_t));
+        app_audio_resampler_handle_t resampler = create_resampler(cases[i].in_rate, 1, 16, cases[i].out_rate, 1);
+        if ((in == NULL) || (out == NULL) || (resampler == NULL)) {
+            TEST_CHECK(false, "No memory for the samples");
+            free(in);
+            free(out);
+            app_audio_resampler_destroy(resampler);
+            continue;
+        }
+
+        fill_tone(in, in_frames, 1, cases[i].freq, cases[i].in_rate);
+        uint32_t out_frames = resample(resampler, in, in_frames, 1, 1, 1024, NULL, out);
+        double level_db = 20.0 * log10((get_rms(out, TAPS, out_frames, 1) + 1e-9) / (TONE_AMPLITUDE / sqrt(2.0)));
+        TEST_CHECK(level_db < -60.0, "%" PRIu32 " to %" PRIu32 " Hz, %.0f Hz: alias at %.1f dB",
+                   cases[i].in_rate, cases[i].out_rate, cases[i].freq, level_db);
+        app_audio_resampler_destroy(resampler);
+        free(in);
+        free(out);
+    }
+}
+
+static void test_chunks(const rate_pair_t *pairs, size_t pair_num, uint32_t round_num)
+{
+    const uint32_t in_frames = 20000;
+    int16_t *in = malloc(in_frames * sizeof(int16_t));
+    int16_t *whole = malloc(in_frames * 16 * 2 * sizeof(int16_t));
+    int16_t *cut = malloc(in_frames * 16 * 2 * sizeof(int16_t));
+    if ((in == NULL) || (whole == NULL) || (cut == NULL)) {
+        TEST_CHECK(false, "No memory for the samples");
+        free(in);
+        free(whole);
+        free(cut);
+        return;
+    }
+    unsigned int seed = 7;
+    for (uint32_t i = 0; i < in_frames; i++) {
+        in[i] = (int16_t)(rand_r(&seed) % 20001 - 10000);
+    }
+
+    for (size_t p = 0; p < pair_num; p++) {
+        // Mono to stereo, the output channels are the same
+        app_audio_resampler_handle_t resampler = create_resampler(pairs[p].in_rate, 1, 16, pairs[p].out_rate, 2);
+        if (resampler == NULL) {
+            continue;
+        }
+        uint32_t whole_frames = resample(resampler, in, in_frames, 1, 2, in_frames, NULL, whole);
+
+        for (uint32_t round = 0; round < round_num; round++) {
+            // After a reset the filter starts from silence as a new resampler does
+            app_audio_resampler_reset(resampler);
+            uint32_t max_chunk = (round % 2 == 0) ? 8 : 3000;
+            uint32_t cut_frames = resample(resampler, in, in_frames, 1, 2, max_chunk, &seed, cut);
+            TEST_CHECK(cut_frames == whole_frames,
+                       "%" PRIu32 " to %" PRIu32 " Hz: %" PRIu32 " frames in chunks of %" PRIu32 " at most, "
+                       "%" PRIu32 " in one call", pairs[p].in_rate, pairs[p].out_rate, cut_frames, max_chunk,
+                       whole_frames);
+            if ((cut_frames == whole_frames) && (memcmp(cut, whole, cut_frames * 2 * sizeof(int16_t)) != 0)) {
+                uint32_t i = 0;
+                while (cut[i] == whole[i]) {
+                    i++;
+                }
+                TEST_CHECK(false, "%" PRIu32 " to %" PRIu32 " Hz: sample %" PRIu32 " is %d in chunks, %d in one call",
+                           pairs[p].in_rate, pairs[p].out_rate, i, cut[i], whole[i]);
+            }
+        }
+        app_audio_resampler_destroy(resampler);
+    }
+    free(in);
+    free(whole);
+    free(cut);
+}
+
+static void test_saturation(void)
+{
+    // The ripple of the filter around the edges of a full scale square wave is clipped, never wrapped around
+    const uint32_t in_frames = 44100;
+    int16_t *in = malloc(in_frames * sizeof(int16_t));
+    int16_t *out = malloc((48000 + 2) * sizeof(int16_t));
+    app_audio_resampler_handle_t resampler = create_resampler(44100, 1, 16, 48000, 1);
+    if ((in == NULL) || (out == NULL) || (resampler == NULL)) {
+        TEST_CHECK(false, "No memory for the samples");
+        free(in);
+        free(out);
+        app_audio_resampler_destroy(resampler);
+        return;
+    }
+
+    const uint32_t half_period = 441;
+    for (uint32_t i = 0; i < in_frames; i++) {
+        in[i] = ((i / half_period) % 2 == 0) ? INT16_MAX : INT16_MIN;
+    }
+    uint32_t out_frames = resample(resampler, in, in_frames, 1, 1, 1024, NULL, out);
+    uint32_t clipped = 0;
+    uint32_t wrapped = 0;
+    for (uint32_t i = TAPS; i < out_frames; i++) {
+        // Input sample at the time of the output sample, and how far it is from an edge
+        uint32_t at = (uint32_t)((uint64_t)i * 44100 / 48000);
+        uint32_t edge = at % half_period;
+        if (edge > half_period / 2) {
+            edge = half_period - edge;
+        }
+        bool high = ((at / half_period) % 2 == 0);
+        if ((out[i] == INT16_MAX) || (out[i] == INT16_MIN)) {
+            clipped++;
+        }
+        if ((edge > TAPS / 2) && (high ? (out[i] < 30000) : (out[i] > -30000))) {
+            wrapped++;
+        }
+    }
+    TEST_CHECK(clipped > 0, "No sample clipped");
+    TEST_CHECK(wrapped == 0, "%" PRIu32 " samples off the level of the square wave", wrapped);
+    app_audio_resampler_destroy(resampler);
+    free(in);
+    free(out);
+}
+
+static void test_speed(uint32_t seconds)
+{
+    const uint32_t in_frames = 44100 * seconds;
+    int16_t *in = malloc(in_frames * 2 * sizeof(int16_t));
+    int16_t *out = malloc((48000 * seconds + 2) * 2 * sizeof(int16_t));
+    app_audio_resampler_handle_t resampler = create_resampler(44100, 2, 16, 48000, 2);
+    if ((in == NULL) || (out == NULL) || (resampler == NULL)) {
+        TEST_CHECK(false, "No memory for the samples");
+        free(in);
+        free(out);
+        app_audio_resampler_destroy(resampler);
+        return;
+    }
+
+    fill_tone(in, in_frames, 2, 1000, 44100);
+    int64_t start_us = esp_timer_get_time();
+    resample(resampler, in, in_frames, 2, 2, 1024, NULL, out);
+    int64_t elapsed_us = esp_timer_get_time() - start_us;
+    printf("44100 to 48000 Hz stereo: %" PRId64 " us per second of audio\n", elapsed_us / seconds);
+    app_audio_resampler_destroy(resampler);
+    free(in);
+    free(out);
+}
+
+int main(int argc, char **argv)
+{
+    bool is_quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !is_quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The rejected configurations are expected
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    static const rate_pair_t pairs[] = {
+        {44100, 48000}, {48000, 44100}, {22050, 48000}, {8000, 48000}, {48000, 16000}, {32000, 44100},
+        {11025, 8000}, {96000, 44100}, {48000, 48001},
+    };
+    const size_t pair_num = sizeof(pairs) / sizeof(pairs[0]);
+    test_invalid_args();
+    test_formats();
+    test_tones(pairs, pair_num, is_quick ? 1 : 10);
+    test_anti_alias();
+    test_chunks(pairs, pair_num, is_quick ? 4 : 100);
+    test_saturation();
+    test_speed(is_quick ? 2 : 20);
+
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,441 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+/**
+ * Test of the A/V sync. It plays streams on a simulated clock of 1 ms: an audio device whose clock drifts from the
+ * system timer, fed in chunks as the audio task does, and a video task which decodes each frame and presents it when
+ * the sync says so. It checks the offset between the frames presented and the audio heard, the drops of a slow
+ * decoder, the audio which ends before the video, and the seeks. Then an audio task and a video task call the sync at
+ * once on the real clock.
+ *
+ * Usage: mp4_host_av_sync_test [--quick]
+ */
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "app_av_sync.h"
+
+#define AUDIO_RATE          (48000)
+#define AUDIO_CHUNK         (1024)      /*!< Samples per write of the audio task */
+#define START_US            (1000000)   /*!< System time of the start of the simulation */
+
+#define MIN(a, b)           (((a) < (b)) ? (a) : (b))
+#define MAX(a, b)           (((a) > (b)) ? (a) : (b))
+
+static int failure_num = 0;
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+typedef struct {
+    const char *name;
+    uint32_t duration_ms;       /*!< Length of the video */
+    uint32_t fps;
+    uint32_t decode_ms;         /*!< Time to decode a frame */
+    uint32_t slow_every;        /*!< Period of the frames slower to decode, e.g. the key frames, 0 for none */
+    uint32_t slow_decode_ms;    /*!< Time to decode a slow frame */
+    bool skip_before_decode;    /*!< Ask the sync before decoding, as for the intra-only MJPEG frames */
+    bool has_audio;
+    int32_t drift_ppm;          /*!< Clock of the audio device against the system timer */
+    uint32_t audio_end_ms;      /*!< End of the audio track, 0 if it is as long as the video */
+    uint32_t seek_at_ms;        /*!< Media time of a seek, 0 for none */
+    uint32_t seek_to_ms;        /*!< Media time after the seek */
+} scenario_t;
+
+typedef struct {
+    uint32_t presented;
+    uint32_t dropped;           /*!< Dropped after the decode */
+    uint32_t skipped;           /*!< Dropped before the decode */
+    uint32_t drops_in_row_max;
+    int32_t offset_min_ms;      /*!< Frame shown minus audio heard, or minus the ideal time without audio */
+    int32_t offset_max_ms;
+    uint32_t gap_max_ms;        /*!< Longest time between two presented frames */
+    app_av_sync_stats_t stats;
+} result_t;
+
+/**
+ * @brief Audio device fed by the audio task, its buffer holds the latency of the configuration
+ */
+typedef struct {
+    double played;              /*!< Samples played */
+    uint64_t written;           /*!< Samples written */
+    uint64_t base;              /*!< Samples written before the last seek */
+    uint32_t base_pts;          /*!< Media time of the samples after the last seek */
+    double rate;                /*!< Samples played per millisecond */
+    uint32_t capacity;          /*!< Samples the device holds */
+} audio_device_t;
+
+static double get_audio_heard_ms(const audio_device_t *device)
+{
+    return device->base_pts + (device->played - device->base) * 1000.0 / AUDIO_RATE;
+}
+
+static void run_scenario(const scenario_t *scenario, const app_av_sync_config_t *config, result_t *result)
+{
+    app_av_sync_handle_t sync = NULL;
+    TEST_CHECK(app_av_sync_create(config, &sync) == ESP_OK, "%s: create failed", scenario->name);
+    if (sync == NULL) {
+        return;
+    }
+
+    memset(result, 0, sizeof(*result));
+    result->offset_min_ms = INT32_MAX;
+    result->offset_max_ms = INT32_MIN;
+
+    audio_device_t device = {
+        .rate = AUDIO_RATE * (1.0 + scenario->drift_ppm / 1e6) / 1000.0,
+        .capacity = config->audio_latency_ms * AUDIO_RATE / 1000,
+    };
+    bool is_audio_first = true;
+
+    uint32_t frame = 0;
+    uint32_t frame_num = scenario->duration_ms * scenario->fps / 1000;
+    uint32_t pts_offset_ms = 0;             // Added to the timestamps after the seek
+    uint32_t seek_frame = (scenario->seek_at_ms > 0) ? scenario->seek_at_ms * scenario->fps / 1000 : UINT32_MAX;
+    int64_t next_us = START_US;             // Time of the next action of the video task
+    bool is_decoded = false;
+    uint32_t drops_in_row = 0;
+    int64_t last_present_us = 0;
+    // Without audio, the frames are compared with the time since the first frame shown
+    bool is_ref_set = false;
+    uint32_t ref_pts = 0;
+    int64_t ref_us = 0;
+
+    int64_t end_us = START_US + (int64_t)scenario->duration_ms * 2000;
+    int64_t now_us = START_US;
+    for (; (frame < frame_num) && (now_us < end_us); now_us += 1000) {
+        // Audio task: the device plays, the task writes a chunk once there is room for it
+        device.played = (device.played + device.rate < device.written) ? device.played + device.rate : device.written;
+        uint32_t audio_ms = device.base_pts + (uint32_t)((device.written - device.base) * 1000 / AUDIO_RATE);
+        bool has_audio_left = scenario->has_audio &&
+                              ((scenario->audio_end_ms == 0) || (audio_ms < scenario->audio_end_ms));
+        if (has_audio_left && (device.written - device.played + AUDIO_CHUNK <= device.capacity)) {
+            app_av_sync_audio_written(sync, is_audio_first ? device.base_pts : 0, AUDIO_CHUNK, AUDIO_RATE, now_us);
+            device.written += AUDIO_CHUNK;
+            is_audio_first = false;
+        }
+
+        // Video task
+        if (now_us < next_us) {
+            continue;
+        }
+        if (frame == seek_frame) {
+            // The seek flushes both streams, they restart from the new position
+            pts_offset_ms = scenario->seek_to_ms - frame * 1000 / scenario->fps;
+            seek_frame = UINT32_MAX;
+            device.played = device.written;
+            device.base = device.written;
+            device.base_pts = scenario->seek_to_ms;
+            is_audio_first = true;
+            is_ref_set = false;
+            is_decoded = false;
+        }
+        uint32_t pts = frame * 1000 / scenario->fps + pts_offset_ms;
+        if (!is_decoded) {
+            if (scenario->skip_before_decode && app_av_sync_skip_video(sync, pts, now_us)) {
+                result->skipped++;
+                drops_in_row++;
+                result->drops_in_row_max = MAX(result->drops_in_row_max, drops_in_row);
+                frame++;
+                continue;
+            }
+            bool is_slow = (scenario->slow_every > 0) && (frame % scenario->slow_every == 0);
+            is_decoded = true;
+            next_us = now_us + (is_slow ? scenario->slow_decode_ms : scenario->decode_ms) * 1000;
+            continue;
+        }
+
+        uint32_t wait_ms = 0;
+        app_av_sync_action_t action = app_av_sync_check_video(sync, pts, now_us, &wait_ms);
+        if (action == APP_AV_SYNC_WAIT) {
+            TEST_CHECK((wait_ms > 0) && (wait_ms <= config->tolerance_ms), "%s: wait of %" PRIu32 " ms",
+                       scenario->name, wait_ms);
+            next_us = now_us + MAX(wait_ms, 1) * 1000;
+            continue;
+        }
+
+        is_decoded = false;
+        frame++;
+        if (action == APP_AV_SYNC_DROP) {
+            result->dropped++;
+            drops_in_row++;
+            result->drops_in_row_max = MAX(result->drops_in_row_max, drops_in_row);
+            continue;
+        }
+
+        if (!is_ref_set) {
+            is_ref_set = true;
+            ref_pts = pts;
+            ref_us = now_us;
+        }
+        bool is_audio_playing = scenario->has_audio && (device.played > device.base) &&
+                                (device.played < device.written);
+        if (is_audio_playing || !scenario->has_audio) {
+            double heard_ms = is_audio_playing ? get_audio_heard_ms(&device) : ref_pts + (now_us - ref_us) / 1000.0;
+            int32_t offset_ms = (int32_t)lround(pts - heard_ms);
+            result->offset_min_ms = MIN(result->offset_min_ms, offset_ms);
+            result->offset_max_ms = MAX(result->offset_max_ms, offset_ms);
+        }
+        if (last_present_us > 0) {
+            result->gap_max_ms = MAX(result->gap_max_ms, (uint32_t)((now_us - last_present_us) / 1000));
+        }
+        last_present_us = now_us;
+        result->presented++;
+        drops_in_row = 0;
+    }
+
+    TEST_CHECK(frame == frame_num, "%s: stuck at frame %" PRIu32 " of %" PRIu32, scenario->name, frame, frame_num);
+    app_av_sync_get_stats(sync, &result->stats);
+    app_av_sync_destroy(sync);
+
+    printf("%-16s %5" PRIu32 " presented, %4" PRIu32 " dropped, %4" PRIu32 " skipped, offset %4" PRId32 "..%3" PRId32
+           " ms, gap max %3" PRIu32 " ms, %" PRIu32 " resyncs\n", scenario->name, result->presented, result->dropped,
+           result->skipped, result->offset_min_ms, result->offset_max_ms, result->gap_max_ms, result->stats.resyncs);
+}
+
+static void test_scenarios(bool is_quick)
+{
+    const app_av_sync_config_t config = APP_AV_SYNC_CONFIG_DEFAULT();
+    const uint32_t duration_ms = is_quick ? 60000 : 600000;
+    const int32_t tolerance_ms = (int32_t)config.tolerance_ms;
+    result_t result;
+
+    // Without audio the clock is the system timer, each frame is shown on time
+    scenario_t video_only = { .name = "video only", .duration_ms = duration_ms, .fps = 30, .decode_ms = 10 };
+    run_scenario(&video_only, &config, &result);
+    TEST_CHECK((result.dropped == 0) && (result.stats.frames_repeated > 0), "Video only: %" PRIu32 " dropped, %"
+               PRIu32 " repeated", result.dropped, result.stats.frames_repeated);
+    TEST_CHECK((result.offset_min_ms >= -1) && (result.offset_max_ms <= 1) && (result.gap_max_ms <= 35),
+               "Video only: offset %" PRId32 "..%" PRId32 " ms, gap %" PRIu32 " ms", result.offset_min_ms,
+               result.offset_max_ms, result.gap_max_ms);
+    TEST_CHECK(!result.stats.audio_master, "Video only: audio master");
+
+    // The video follows the audio heard, whatever the drift of the clock of the audio device
+    const int32_t drifts_ppm[] = { 0, 200, -200, 5000, -5000 };
+    for (size_t i = 0; i < sizeof(drifts_ppm) / sizeof(drifts_ppm[0]); i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "audio %+" PRId32 " ppm", drifts_ppm[i]);
+        scenario_t drift = {
+            .name = name, .duration_ms = duration_ms, .fps = 30, .decode_ms = 10, .has_audio = true,
+            .drift_ppm = drifts_ppm[i],
+        };
+        run_scenario(&drift, &config, &result);
+        TEST_CHECK(result.stats.audio_master && (result.dropped == 0), "%s: %" PRIu32 " dropped", name,
+                   result.dropped);
+        TEST_CHECK((result.offset_min_ms >= -tolerance_ms) && (result.offset_max_ms <= tolerance_ms),
+                   "%s: offset %" PRId32 "..%" PRId32 " ms", name, result.offset_min_ms, result.offset_max_ms);
+        TEST_CHECK(result.stats.resyncs == 0, "%s: %" PRIu32 " resyncs", name, result.stats.resyncs);
+    }
+
+    // A key frame slow to decode every second, the late frames after it are dropped but never too many in a row. The
+    // intra-only MJPEG frames are dropped before the decode, the H.264 ones are all decoded.
+    const bool skips[] = { true, false };
+    for (size_t i = 0; i < sizeof(skips) / sizeof(skips[0]); i++) {
+        scenario_t slow = {
+            .name = skips[i] ? "slow MJPEG" : "slow H.264", .duration_ms = duration_ms, .fps = 30, .decode_ms = 10,
+            .slow_every = 30, .slow_decode_ms = 150, .skip_before_decode = skips[i], .has_audio = true,
+        };
+        run_scenario(&slow, &config, &result);
+        uint32_t drops = result.dropped + result.skipped;
+        TEST_CHECK((drops > 0) && (result.drops_in_row_max <= config.max_drop_frames), "%s: %" PRIu32 " dropped, %"
+                   PRIu32 " in a row", slow.name, drops, result.drops_in_row_max);
+        TEST_CHECK(skips[i] ? (result.skipped > 0) : (result.skipped == 0), "%s: %" PRIu32 " skipped", slow.name,
+                   result.skipped);
+        // The video catches up after each slow frame
+        TEST_CHECK((result.offset_min_ms >= -(int32_t)slow.slow_decode_ms) && (result.offset_max_ms <= tolerance_ms),
+                   "%s: offset %" PRId32 "..%" PRId32 " ms", slow.name, result.offset_min_ms, result.offset_max_ms);
+        TEST_CHECK(result.stats.offset_avg_ms >= -tolerance_ms, "%s: average offset %" PRId32 " ms", slow.name,
+                   result.stats.offset_avg_ms);
+    }
+
+    // A decoder slower than the frame rate all along, one frame is presented after the most drops in a row
+    scenario_t overload = {
+        .name = "overload", .duration_ms = duration_ms, .fps = 30, .decode_ms = 45, .skip_before_decode = true,
+        .has_audio = true,
+    };
+    run_scenario(&overload, &config, &result);
+    TEST_CHECK(result.drops_in_row_max <= config.max_drop_frames, "Overload: %" PRIu32 " dropped in a row",
+               result.drops_in_row_max);
+    TEST_CHECK(result.presented * (config.max_drop_frames + 1) >= overload.duration_ms * overload.fps / 1000,
+               "Overload: %" PRIu32 " presented", result.presented);
+    TEST_CHECK(result.stats.resyncs == 0, "Overload: %" PRIu32 " resyncs", result.stats.resyncs);
+
+    // The audio ends first, the clock runs on its own after the stall time
+    scenario_t audio_end = {
+        .name = "audio ends", .duration_ms = duration_ms, .fps = 30, .decode_ms = 10, .has_audio = true,
+        .audio_end_ms = duration_ms / 2,
+    };
+    run_scenario(&audio_end, &config, &result);
+    TEST_CHECK(result.gap_max_ms <= config.audio_stall_ms + config.tolerance_ms, "Audio ends: gap of %" PRIu32 " ms",
+               result.gap_max_ms);
+    TEST_CHECK(result.dropped == 0, "Audio ends: %" PRIu32 " dropped", result.dropped);
+
+    // A seek forward, both streams restart from the new position
+    scenario_t seek = {
+        .name = "seek", .duration_ms = duration_ms, .fps = 30, .decode_ms = 10, .has_audio = true,
+        .seek_at_ms = duration_ms / 3, .seek_to_ms = duration_ms,
+    };
+    run_scenario(&seek, &config, &result);
+    TEST_CHECK(result.stats.resyncs >= 1, "Seek: %" PRIu32 " resyncs", result.stats.resyncs);
+    TEST_CHECK((result.dropped == 0) && (result.gap_max_ms <= 100), "Seek: %" PRIu32 " dropped, gap of %" PRIu32
+               " ms", result.dropped, result.gap_max_ms);
+    TEST_CHECK((result.offset_min_ms >= -tolerance_ms) && (result.offset_max_ms <= tolerance_ms),
+               "Seek: offset %" PRId32 "..%" PRId32 " ms", result.offset_min_ms, result.offset_max_ms);
+}
+
+static void test_actions(void)
+{
+    const app_av_sync_config_t config = APP_AV_SYNC_CONFIG_DEFAULT();
+    app_av_sync_handle_t sync = NULL;
+    TEST_CHECK(app_av_sync_create(NULL, &sync) == ESP_ERR_INVALID_ARG, "Create without a configuration");
+    TEST_CHECK(app_av_sync_create(&config, &sync) == ESP_OK, "Create failed");
+    if (sync == NULL) {
+        return;
+    }
+
+    // Nothing is skipped before the first frame starts the clock
+    TEST_CHECK(!app_av_sync_skip_video(sync, 5000, START_US), "Skipped before the clock started");
+    uint32_t wait_ms = 0;
+    TEST_CHECK(app_av_sync_check_video(sync, 5000, START_US, &wait_ms) == APP_AV_SYNC_PRESENT, "First frame");
+
+    // An early frame waits, at most the tolerance at a time, and counts once as repeated
+    TEST_CHECK(app_av_sync_check_video(sync, 5100, START_US, &wait_ms) == APP_AV_SYNC_WAIT && (wait_ms == 40),
+               "Frame 100 ms early waits %" PRIu32 " ms", wait_ms);
+    TEST_CHECK(app_av_sync_check_video(sync, 5100, START_US + 70000, &wait_ms) == APP_AV_SYNC_WAIT && (wait_ms == 30),
+               "Frame 30 ms early waits %" PRIu32 " ms", wait_ms);
+    TEST_CHECK(app_av_sync_check_video(sync, 5100, START_US + 100000, &wait_ms) == APP_AV_SYNC_PRESENT, "Due frame");
+
+    // Late frames, within the tolerance and beyond it
+    int64_t now_us = START_US + 1000000;
+    TEST_CHECK(app_av_sync_check_video(sync, 5960, now_us, &wait_ms) == APP_AV_SYNC_PRESENT, "Frame 40 ms late");
+    for (uint32_t i = 0; i < config.max_drop_frames; i++) {
+        if (i % 2 == 0) {
+            TEST_CHECK(app_av_sync_skip_video(sync, 5900, now_us), "Late frame %" PRIu32 " not skipped", i);
+        } else {
+            TEST_CHECK(app_av_sync_check_video(sync, 5900, now_us, &wait_ms) == APP_AV_SYNC_DROP,
+                       "Late frame %" PRIu32 " not dropped", i);
+        }
+    }
+    TEST_CHECK(!app_av_sync_skip_video(sync, 5900, now_us), "Skipped after %" PRIu32 " drops", config.max_drop_frames);
+    TEST_CHECK(app_av_sync_check_video(sync, 5900, now_us, &wait_ms) == APP_AV_SYNC_PRESENT, "Late frame presented");
+
+    // A jump of the timestamps without audio restarts the clock from the frame
+    TEST_CHECK(app_av_sync_check_video(sync, 60000, now_us, &wait_ms) == APP_AV_SYNC_PRESENT, "Jump forward");
+    TEST_CHECK(app_av_sync_check_video(sync, 60040, now_us + 40000, &wait_ms) == APP_AV_SYNC_PRESENT, "After jump");
+
+    app_av_sync_stats_t stats;
+    TEST_CHECK(app_av_sync_get_stats(sync, &stats) == ESP_OK, "Get stats failed");
+    TEST_CHECK((stats.frames_presented == 6) && (stats.frames_dropped == config.max_drop_frames) &&
+               (stats.frames_repeated == 1) && (stats.resyncs == 1) && (stats.offset_min_ms == -100) &&
+               (stats.offset_max_ms == 0), "Stats: %" PRIu32 " presented, %" PRIu32 " dropped, %" PRIu32 " repeated, %"
+               PRIu32 " resyncs, offset %" PRId32 "..%" PRId32 " ms", stats.frames_presented, stats.frames_dropped,
+               stats.frames_repeated, stats.resyncs, stats.offset_min_ms, stats.offset_max_ms);
+
+    app_av_sync_reset(sync);
+    app_av_sync_get_stats(sync, &stats);
+    TEST_CHECK((stats.frames_presented == 0) && (stats.frames_dropped == 0) && (stats.resyncs == 0), "Stats kept");
+    TEST_CHECK(!app_av_sync_skip_video(sync, 0, now_us), "Skipped after the reset");
+
+    app_av_sync_destroy(sync);
+}
+
+typedef struct {
+    app_av_sync_handle_t sync;
+    SemaphoreHandle_t done;
+    volatile bool is_running;
+    uint32_t presented;
+    uint32_t dropped;
+} task_context_t;
+
+static void audio_task(void *arg)
+{
+    task_context_t *context = arg;
+    while (context->is_running) {
+        app_av_sync_audio_written(context->sync, 0, AUDIO_RATE / 1000, AUDIO_RATE, esp_timer_get_time());
+        vTaskDelay(1);
+    }
+    xSemaphoreGive(context->done);
+    vTaskDelete(NULL);
+}
+
+static void test_tasks(uint32_t duration_ms)
+{
+    const app_av_sync_config_t config = APP_AV_SYNC_CONFIG_DEFAULT();
+    task_context_t context = { .done = xSemaphoreCreateBinary(), .is_running = true };
+    TEST_CHECK(app_av_sync_create(&config, &context.sync) == ESP_OK, "Create failed");
+    if (context.sync == NULL) {
+        return;
+    }
+    TEST_CHECK(xTaskCreate(audio_task, "audio", 4096, &context, 5, NULL) == pdPASS, "Task failed");
+
+    // The video task presents 100 frames per second and reads the statistics as the main task does
+    int64_t start_us = esp_timer_get_time();
+    uint32_t pts = 0;
+    while (esp_timer_get_time() - start_us < (int64_t)duration_ms * 1000) {
+        uint32_t wait_ms = 0;
+        app_av_sync_action_t action = app_av_sync_check_video(context.sync, pts, esp_timer_get_time(), &wait_ms);
+        if (action == APP_AV_SYNC_WAIT) {
+            vTaskDelay(pdMS_TO_TICKS(wait_ms));
+            continue;
+        }
+        if (action == APP_AV_SYNC_DROP) {
+            context.dropped++;
+        } else {
+            context.presented++;
+        }
+        pts += 10;
+        app_av_sync_stats_t stats;
+        app_av_sync_get_stats(context.sync, &stats);
+    }
+    context.is_running = false;
+    xSemaphoreTake(context.done, portMAX_DELAY);
+
+    app_av_sync_stats_t stats;
+    app_av_sync_get_stats(context.sync, &stats);
+    printf("Tasks: %" PRIu32 " presented, %" PRIu32 " dropped, offset %" PRId32 "..%" PRId32 " ms\n",
+           context.presented, context.dropped, stats.offset_min_ms, stats.offset_max_ms);
+    TEST_CHECK(stats.audio_master, "Tasks: the audio is not the master");
+    TEST_CHECK((stats.frames_presented == context.presented) && (stats.frames_dropped == context.dropped),
+               "Tasks: %" PRIu32 " presented, %" PRIu32 " dropped in the stats", stats.frames_presented,
+               stats.frames_dropped);
+
+    vSemaphoreDelete(context.done);
+    app_av_sync_destroy(context.sync);
+}
+
+int main(int argc, char **argv)
+{
+    bool is_quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !is_quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    test_actions();
+    test_scenarios(is_quick);
+    test_tasks(is_quick ? 500 : 3000);
+
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,478 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+/**
+ * Test of the read-ahead file source. It reads generated files in pieces of random sizes, sequentially, with the short
+ * seeks back of interleaved tracks and with random seeks, and compares each byte with the file. The reads of the file
+ * go through `read()`, which is wrapped at link time to model an SD card: a delay per read, latency spikes, a card
+ * which hangs and read errors. It checks the stalls absorbed by the ring, an abort and a close while the card hangs.
+ *
+ * Usage: mp4_host_file_source_test [--quick]
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "app_file_source.h"
+
+#define CHUNK_SIZE          (16 * 1024)
+#define CHUNK_NUM           (8)
+
+static int failure_num = 0;
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+/**
+ * @brief Model of the SD card, for the reads of the file source
+ */
+static struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;
+    uint32_t delay_us;          /*!< Time of each read */
+    uint32_t spike_every;       /*!< Period of the slow reads, 0 for none */
+    uint32_t spike_us;          /*!< Time of a slow read */
+    uint32_t reads;             /*!< Reads so far */
+    bool is_hung;               /*!< The reads wait until it is cleared */
+    bool is_reading;            /*!< A read waits in the card */
+    off_t fail_offset;          /*!< Offset whose read fails, -1 for none */
+} card = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .changed = PTHREAD_COND_INITIALIZER,
+    .fail_offset = -1,
+};
+
+ssize_t __real_read(int fd, void *buffer, size_t size);
+
+ssize_t __wrap_read(int fd, void *buffer, size_t size)
+{
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+
+    pthread_mutex_lock(&card.mutex);
+    uint32_t delay_us = card.delay_us;
+    card.reads++;
+    if ((card.spike_every > 0) && (card.reads % card.spike_every == 0)) {
+        delay_us = card.spike_us;
+    }
+    card.is_reading = true;
+    pthread_cond_broadcast(&card.changed);
+    while (card.is_hung) {
+        pthread_cond_wait(&card.changed, &card.mutex);
+    }
+    card.is_reading = false;
+    bool is_failed = (card.fail_offset >= 0) && (offset <= card.fail_offset) &&
+                     (card.fail_offset < offset + (off_t)size);
+    pthread_mutex_unlock(&card.mutex);
+
+    if (delay_us > 0) {
+        usleep(delay_us);
+    }
+    if (is_failed) {
+        errno = EIO;
+        return -1;
+    }
+    return __real_read(fd, buffer, size);
+}
+
+static void set_card(uint32_t delay_us, uint32_t spike_every, uint32_t spike_us)
+{
+    pthread_mutex_lock(&card.mutex);
+    card.delay_us = delay_us;
+    card.spike_every = spike_every;
+    card.spike_us = spike_us;
+    card.reads = 0;
+    pthread_mutex_unlock(&card.mutex);
+}
+
+static void set_card_hung(bool is_hung)
+{
+    pthread_mutex_lock(&card.mutex);
+    card.is_hung = is_hung;
+    pthread_cond_broadcast(&card.changed);
+    pthread_mutex_unlock(&card.mutex);
+}
+
+static void wait_card_reading(void)
+{
+    pthread_mutex_lock(&card.mutex);
+    while (!card.is_reading) {
+        pthread_cond_wait(&card.changed, &card.mutex);
+    }
+    pthread_mutex_unlock(&card.mutex);
+}
+
+static void *release_card_thread(void *arg)
+{
+    (void)arg;
+    usleep(50000);
+    set_card_hung(false);
+    return NULL;
+}
+
+static void set_card_failure(off_t offset)
+{
+    pthread_mutex_lock(&card.mutex);
+    card.fail_offset = offset;
+    pthread_mutex_unlock(&card.mutex);
+}
+
+static inline uint8_t get_file_byte(uint32_t seed, uint32_t offset)
+{
+    uint32_t value = (offset + seed) * 2654435761u;
+    return (uint8_t)(value >> 24);
+}
+
+static void create_file(char *path, uint32_t seed, uint32_t size)
+{
+    const char *dir = getenv("TMPDIR");
+    snprintf(path, 256, "%s/mp4_host_file_source_XXXXXX", (dir != NULL) ? dir : "/tmp");
+    int fd = mkstemp(path);
+    TEST_CHECK(fd >= 0, "Failed to create %s", path);
+    if (fd < 0) {
+        return;
+    }
+
+    uint8_t buffer[4096];
+    for (uint32_t offset = 0; offset < size; offset += sizeof(buffer)) {
+        uint32_t len = (size - offset < sizeof(buffer)) ? size - offset : sizeof(buffer);
+        for (uint32_t i = 0; i < len; i++) {
+            buffer[i] = get_file_byte(seed, offset + i);
+        }
+        TEST_CHECK(write(fd, buffer, len) == (ssize_t)len, "Failed to write %s", path);
+    }
+    close(fd);
+}
+
+/**
+ * @brief Read at a position and compare with the file
+ *
+ * @return Number of bytes read
+ */
+static int read_and_check(app_file_source_handle_t source, uint32_t seed, uint32_t position, uint32_t size,
+                          const char *step)
+{
+    static uint8_t buffer[4 * CHUNK_SIZE];
+    size = (size < sizeof(buffer)) ? size : sizeof(buffer);
+    int got = app_file_source_read(source, buffer, size);
+    for (int i = 0; i < got; i++) {
+        if (buffer[i] != get_file_byte(seed, position + i)) {
+            TEST_CHECK(false, "%s: byte %" PRIu32 " is wrong", step, position + i);
+            break;
+        }
+    }
+    return got;
+}
+
+static app_file_source_handle_t create_source_with(uint32_t chunk_num)
+{
+    app_file_source_config_t config = APP_FILE_SOURCE_CONFIG_DEFAULT();
+    config.chunk_size = CHUNK_SIZE;
+    config.chunk_num = chunk_num;
+    app_file_source_handle_t source = NULL;
+    TEST_CHECK(app_file_source_create(&config, &source) == ESP_OK, "Create failed");
+    return source;
+}
+
+static app_file_source_handle_t create_source(void)
+{
+    return create_source_with(CHUNK_NUM);
+}
+
+static void test_invalid_args(void)
+{
+    app_file_source_config_t config = APP_FILE_SOURCE_CONFIG_DEFAULT();
+    app_file_source_handle_t source = NULL;
+    config.chunk_size = 1000;
+    TEST_CHECK(app_file_source_create(&config, &source) == ESP_ERR_INVALID_ARG, "Chunk of 1000 bytes");
+    config.chunk_size = CHUNK_SIZE;
+    config.chunk_num = 1;
+    TEST_CHECK(app_file_source_create(&config, &source) == ESP_ERR_INVALID_ARG, "Ring of 1 chunk");
+
+    source = create_source();
+    if (source == NULL) {
+        return;
+    }
+    uint8_t byte;
+    TEST_CHECK(app_file_source_open(source, "/nonexistent/video.mp4") == ESP_ERR_NOT_FOUND, "Missing file opened");
+    TEST_CHECK(app_file_source_read(source, &byte, 1) == 0, "Read without a file");
+    TEST_CHECK(app_file_source_seek(source, 0) == ESP_ERR_INVALID_STATE, "Seek without a file");
+    app_file_source_destroy(source);
+}
+
+static void test_sequential(uint32_t file_size)
+{
+    char path[256];
+    create_file(path, 1, file_size);
+    app_file_source_handle_t source = create_source();
+    if (source == NULL) {
+        return;
+    }
+
+    TEST_CHECK(app_file_source_open(source, path) == ESP_OK, "Open failed");
+    TEST_CHECK(app_file_source_get_size(source) == file_size, "Size %" PRIu32, app_file_source_get_size(source));
+
+    // Pieces of random sizes, as the extractor reads the boxes and the samples
+    uint32_t seed = 7;
+    uint32_t position = 0;
+    while (position < file_size) {
+        uint32_t size = 1 + rand_r(&seed) % (3 * CHUNK_SIZE);
+        int got = read_and_check(source, 1, position, size, "Sequential");
+        uint32_t expected = (file_size - position < size) ? file_size - position : size;
+        TEST_CHECK(got == (int)expected, "Sequential: %d of %" PRIu32 " bytes at %" PRIu32, got, expected, position);
+        if (got <= 0) {
+            break;
+        }
+        position += got;
+    }
+    uint8_t byte;
+    TEST_CHECK(app_file_source_read(source, &byte, 1) == 0, "Read after the end");
+
+    // Each chunk is read once from the file
+    app_file_source_stats_t stats;
+    app_file_source_get_stats(source, &stats);
+    uint32_t chunk_total = (file_size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    TEST_CHECK((stats.bytes_read == file_size) && (stats.chunks_read == chunk_total) && (stats.restarts == 0) &&
+               (stats.chunks_discarded == 0), "Sequential: %" PRIu64 " bytes, %" PRIu32 " chunks, %" PRIu32
+               " restarts, %" PRIu32 " discarded", stats.bytes_read, stats.chunks_read, stats.restarts,
+               stats.chunks_discarded);
+
+    // Read again from the start
+    TEST_CHECK(app_file_source_seek(source, 0) == ESP_OK, "Seek to the start failed");
+    TEST_CHECK(read_and_check(source, 1, 0, 1000, "Again") == 1000, "Read from the start failed");
+    TEST_CHECK(app_file_source_seek(source, file_size) == ESP_OK, "Seek to the end failed");
+    TEST_CHECK(app_file_source_read(source, &byte, 1) == 0, "Read at the end");
+    TEST_CHECK(app_file_source_seek(source, file_size + 1) == ESP_ERR_INVALID_STATE, "Seek beyond the end");
+
+    app_file_source_close(source);
+    app_file_source_destroy(source);
+    unlink(path);
+}
+
+static void test_seeks(uint32_t file_size, uint32_t round_num)
+{
+    char path[256];
+    create_file(path, 2, file_size);
+    app_file_source_handle_t source = create_source();
+    if (source == NULL) {
+        return;
+    }
+    TEST_CHECK(app_file_source_open(source, path) == ESP_OK, "Open failed");
+
+    // Two interleaved tracks, the audio samples of a frame lie a little before the video ones
+    uint32_t seed = 11;
+    uint32_t video = 0;
+    while (video + CHUNK_SIZE < file_size) {
+        uint32_t audio = (video > CHUNK_SIZE / 2) ? video - rand_r(&seed) % (CHUNK_SIZE / 2) : video;
+        TEST_CHECK(app_file_source_seek(source, video) == ESP_OK, "Seek to the video failed");
+        uint32_t video_size = 500 + rand_r(&seed) % (CHUNK_SIZE / 2);
+        TEST_CHECK(read_and_check(source, 2, video, video_size, "Video track") == (int)video_size, "Video read");
+        TEST_CHECK(app_file_source_seek(source, audio) == ESP_OK, "Seek to the audio failed");
+        TEST_CHECK(read_and_check(source, 2, audio, 300, "Audio track") == 300, "Audio read");
+        video += video_size;
+    }
+    // The chunk before the one of the reader is kept, so each chunk is read once
+    app_file_source_stats_t stats;
+    app_file_source_get_stats(source, &stats);
+    uint32_t chunk_num = video / CHUNK_SIZE + 1;
+    TEST_CHECK((stats.restarts == 0) && (stats.chunks_read <= chunk_num + CHUNK_NUM),
+               "Interleaved: %" PRIu32 " restarts, %" PRIu32 " chunks read for %" PRIu32, stats.restarts,
+               stats.chunks_read, chunk_num);
+
+    // Random seeks all over the file
+    for (uint32_t i = 0; i < round_num; i++) {
+        uint32_t position = rand_r(&seed) % file_size;
+        uint32_t size = 1 + rand_r(&seed) % (2 * CHUNK_SIZE);
+        TEST_CHECK(app_file_source_seek(source, position) == ESP_OK, "Seek to %" PRIu32 " failed", position);
+        uint32_t expected = (file_size - position < size) ? file_size - position : size;
+        int got = read_and_check(source, 2, position, size, "Random");
+        TEST_CHECK(got == (int)expected, "Random: %d of %" PRIu32 " bytes at %" PRIu32, got, expected, position);
+    }
+    app_file_source_get_stats(source, &stats);
+    TEST_CHECK(stats.restarts > 0, "Random: no restart");
+
+    // Another file replaces the first one
+    char other_path[256];
+    create_file(other_path, 3, CHUNK_SIZE * 3 + 5);
+    TEST_CHECK(app_file_source_open(source, other_path) == ESP_OK, "Open of another file failed");
+    TEST_CHECK(read_and_check(source, 3, 0, CHUNK_SIZE * 4, "Other file") == CHUNK_SIZE * 3 + 5, "Other file read");
+
+    app_file_source_close(source);
+    app_file_source_destroy(source);
+    unlink(path);
+    unlink(other_path);
+}
+
+/**
+ * @brief Read a file at the bitrate of a video, from a card with latency spikes
+ *
+ * @return Longest wait of a read
+ */
+static uint32_t read_from_slow_card(uint32_t file_size, uint32_t chunk_num)
+{
+    char path[256];
+    create_file(path, 4, file_size);
+    app_file_source_handle_t source = create_source_with(chunk_num);
+    if (source == NULL) {
+        return 0;
+    }
+
+    // A card of about 8 MB/s with a spike of 50 ms every 20 reads, read at 2 MB/s by the player
+    set_card(2000, 20, 50000);
+    TEST_CHECK(app_file_source_open(source, path) == ESP_OK, "Open failed");
+    vTaskDelay(pdMS_TO_TICKS(100));
+    uint32_t position = 0;
+    int64_t start_us = esp_timer_get_time();
+    while (position < file_size) {
+        int got = read_and_check(source, 4, position, 8192, "Spikes");
+        if (got <= 0) {
+            break;
+        }
+        position += got;
+        // 8 KB every 4 ms
+        int64_t due_us = start_us + (int64_t)position * 4000 / 8192;
+        int64_t now_us = esp_timer_get_time();
+        if (due_us > now_us) {
+            vTaskDelay(pdMS_TO_TICKS((due_us - now_us + 999) / 1000));
+        }
+    }
+    set_card(0, 0, 0);
+
+    app_file_source_stats_t stats;
+    app_file_source_get_stats(source, &stats);
+    printf("Card spikes, %" PRIu32 " chunks: %" PRIu32 " stalls, %" PRIu32 " us at most, %" PRIu64 " us in total\n",
+           chunk_num, stats.stalls, stats.stall_max_us, stats.stall_total_us);
+    TEST_CHECK(position == file_size, "Spikes: %" PRIu32 " of %" PRIu32 " bytes", position, file_size);
+
+    app_file_source_close(source);
+    app_file_source_destroy(source);
+    unlink(path);
+    return stats.stall_max_us;
+}
+
+static void test_card_spikes(uint32_t file_size)
+{
+    // The ring of 128 KB lasts 64 ms at 2 MB/s, longer than a spike, a ring of 2 chunks does not
+    uint32_t stall_small_us = read_from_slow_card(file_size, 2);
+    uint32_t stall_us = read_from_slow_card(file_size, CHUNK_NUM);
+    TEST_CHECK(stall_us < 20000, "Spikes: a read waited %" PRIu32 " us", stall_us);
+    TEST_CHECK(stall_small_us > stall_us, "Spikes: %" PRIu32 " us at most with 2 chunks", stall_small_us);
+}
+
+typedef struct {
+    app_file_source_handle_t source;
+    SemaphoreHandle_t done;
+    int got;
+    int64_t wait_us;
+} reader_t;
+
+static void reader_task(void *arg)
+{
+    reader_t *reader = arg;
+    static uint8_t buffer[CHUNK_SIZE];
+    int64_t start_us = esp_timer_get_time();
+    reader->got = app_file_source_read(reader->source, buffer, sizeof(buffer));
+    reader->wait_us = esp_timer_get_time() - start_us;
+    xSemaphoreGive(reader->done);
+    vTaskDelete(NULL);
+}
+
+static void test_hung_card(void)
+{
+    char path[256];
+    create_file(path, 5, CHUNK_SIZE * CHUNK_NUM * 4);
+    app_file_source_handle_t source = create_source();
+    if (source == NULL) {
+        return;
+    }
+
+    // The card hangs on the first chunk, a read waits until it is aborted
+    set_card_hung(true);
+    TEST_CHECK(app_file_source_open(source, path) == ESP_OK, "Open failed");
+    wait_card_reading();
+
+    reader_t reader = { .source = source, .done = xSemaphoreCreateBinary() };
+    TEST_CHECK(xTaskCreate(reader_task, "reader", 4096, &reader, 5, NULL) == pdPASS, "Task failed");
+    TEST_CHECK(xSemaphoreTake(reader.done, pdMS_TO_TICKS(150)) == pdFALSE, "Read returned while the card hangs");
+    int64_t abort_us = esp_timer_get_time();
+    app_file_source_abort(source);
+    TEST_CHECK(xSemaphoreTake(reader.done, pdMS_TO_TICKS(1000)) == pdTRUE, "Read not aborted");
+    int64_t abort_wait_us = esp_timer_get_time() - abort_us;
+    TEST_CHECK((reader.got == 0) && (abort_wait_us < 20000), "Abort: %d bytes after %" PRId64 " us", reader.got,
+               abort_wait_us);
+    uint8_t byte;
+    TEST_CHECK(app_file_source_read(source, &byte, 1) == 0, "Read after the abort");
+
+    // A close waits for the read of the card, then another file is read
+    char other_path[256];
+    create_file(other_path, 6, CHUNK_SIZE * 2);
+    pthread_t release_thread;
+    pthread_create(&release_thread, NULL, release_card_thread, NULL);
+    int64_t close_us = esp_timer_get_time();
+    TEST_CHECK(app_file_source_close(source) == ESP_OK, "Close failed");
+    close_us = esp_timer_get_time() - close_us;
+    pthread_join(release_thread, NULL);
+    TEST_CHECK(close_us >= 40000, "Close returned after %" PRId64 " us, while the card was read", close_us);
+    TEST_CHECK(app_file_source_open(source, other_path) == ESP_OK, "Open of another file failed");
+    TEST_CHECK(read_and_check(source, 6, 0, CHUNK_SIZE * 2, "After the hang") == CHUNK_SIZE * 2, "Read failed");
+
+    // A read error of the card ends the reads rather than wait for the chunk, until the file is opened again
+    set_card_failure(CHUNK_SIZE);
+    TEST_CHECK(app_file_source_open(source, other_path) == ESP_OK, "Open failed");
+    int got = read_and_check(source, 6, 0, CHUNK_SIZE * 2, "Read error");
+    TEST_CHECK(got == CHUNK_SIZE, "Read error: %d bytes", got);
+    int64_t read_us = esp_timer_get_time();
+    TEST_CHECK(app_file_source_read(source, &byte, 1) == 0, "Read of the chunk which failed");
+    read_us = esp_timer_get_time() - read_us;
+    TEST_CHECK(read_us < 20000, "Read after an error returned after %" PRId64 " us", read_us);
+    set_card_failure(-1);
+    TEST_CHECK(app_file_source_open(source, other_path) == ESP_OK, "Open failed");
+    TEST_CHECK(read_and_check(source, 6, 0, CHUNK_SIZE * 2, "After the error") == CHUNK_SIZE * 2, "Read failed");
+
+    vSemaphoreDelete(reader.done);
+    app_file_source_close(source);
+    app_file_source_destroy(source);
+    unlink(path);
+    unlink(other_path);
+}
+
+int main(int argc, char **argv)
+{
+    bool is_quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !is_quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The errors of the card are expected
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    test_invalid_args();
+    test_sequential(is_quick ? 1000003 : 20000003);
+    test_seeks(is_quick ? 1000003 : 20000003, is_quick ? 200 : 5000);
+    test_card_spikes(is_quick ? 512 * 1024 : 4 * 1024 * 1024);
+    test_hung_card();
+
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,281 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+/**
+ * Test of the frame pool. It checks the references of a frame, the buffer freed on a wrap failure and the statistics,
+ * then wraps frames in the extractor task and releases them from a decode task and a trace task, as the player does.
+ * All the buffers must be back in the memory pool at the end.
+ *
+ * Usage: mp4_host_frame_pool_test [--quick]
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "mem_pool_host.h"
+#include "app_frame_pool.h"
+
+#define POOL_SIZE           (64 * 1024)
+#define CONSUMER_NUM        (2)
+
+static int failure_num = 0;
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+static uint8_t *alloc_frame_data(app_frame_pool_handle_t pool, uint32_t size, uint32_t pts)
+{
+    uint8_t *buffer = mem_pool_alloc(app_frame_pool_get_mem_pool(pool), size);
+    if (buffer != NULL) {
+        memset(buffer, (uint8_t)pts, size);
+    }
+    return buffer;
+}
+
+static bool is_frame_intact(const app_frame_t *frame)
+{
+    for (uint32_t i = 0; i < frame->size; i++) {
+        if (frame->buffer[i] != (uint8_t)frame->pts) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static mem_pool_host_usage_t get_usage(app_frame_pool_handle_t pool)
+{
+    mem_pool_host_usage_t usage;
+    mem_pool_host_get_usage(app_frame_pool_get_mem_pool(pool), &usage);
+    return usage;
+}
+
+static void test_invalid_args(void)
+{
+    app_frame_pool_handle_t pool = NULL;
+    TEST_CHECK(app_frame_pool_create(0, 4, &pool) == ESP_ERR_INVALID_ARG, "Pool of 0 bytes created");
+    TEST_CHECK(app_frame_pool_create(POOL_SIZE, 0, &pool) == ESP_ERR_INVALID_ARG, "Pool of 0 frames created");
+    TEST_CHECK(app_frame_pool_create(POOL_SIZE, 4, NULL) == ESP_ERR_INVALID_ARG, "Pool created without a handle");
+    TEST_CHECK(app_frame_pool_wrap(NULL, NULL, 0, 0, true) == NULL, "Frame wrapped without a pool");
+    TEST_CHECK(app_frame_pool_destroy(NULL) == ESP_ERR_INVALID_ARG, "Destroy without a pool");
+
+    // Releasing nothing does nothing
+    app_frame_ref(NULL);
+    app_frame_unref(NULL);
+}
+
+static void test_references(void)
+{
+    app_frame_pool_handle_t pool = NULL;
+    TEST_CHECK(app_frame_pool_create(POOL_SIZE, 4, &pool) == ESP_OK, "Create failed");
+    if (pool == NULL) {
+        return;
+    }
+
+    app_frame_t *frame = app_frame_pool_wrap(pool, alloc_frame_data(pool, 1000, 40), 1000, 40, true);
+    TEST_CHECK((frame != NULL) && (frame->pts == 40) && frame->is_video && (frame->size == 1000), "Wrap failed");
+    if (frame == NULL) {
+        app_frame_pool_destroy(pool);
+        return;
+    }
+    TEST_CHECK(atomic_load(&frame->ref_count) == 1, "%u references after the wrap", atomic_load(&frame->ref_count));
+
+    // The decoder and the tracer hold a reference each, the data stays until both release it
+    app_frame_ref(frame);
+    app_frame_ref(frame);
+    app_frame_unref(frame);
+    app_frame_unref(frame);
+    TEST_CHECK(get_usage(pool).blocks == 1, "Buffer freed with a reference left");
+    TEST_CHECK(is_frame_intact(frame), "Frame data changed with a reference left");
+
+    app_frame_pool_stats_t stats;
+    TEST_CHECK(app_frame_pool_get_stats(pool, &stats) == ESP_OK, "Get stats failed");
+    TEST_CHECK(stats.frames_in_use == 1, "%" PRIu32 " frames in use", stats.frames_in_use);
+
+    app_frame_unref(frame);
+    mem_pool_host_usage_t usage = get_usage(pool);
+    TEST_CHECK((usage.blocks == 0) && (usage.used == 0), "%" PRIu32 " blocks left after the last release",
+               usage.blocks);
+    app_frame_pool_get_stats(pool, &stats);
+    TEST_CHECK((stats.frames_in_use == 0) && (stats.frames_in_use_max == 1) && (stats.frames_wrapped == 1),
+               "Stats: %" PRIu32 " in use, %" PRIu32 " max, %" PRIu32 " wrapped", stats.frames_in_use,
+               stats.frames_in_use_max, stats.frames_wrapped);
+
+    app_frame_pool_destroy(pool);
+}
+
+static void test_exhausted(void)
+{
+    const uint32_t frame_num = 4;
+    app_frame_pool_handle_t pool = NULL;
+    TEST_CHECK(app_frame_pool_create(POOL_SIZE, frame_num, &pool) == ESP_OK, "Create failed");
+    if (pool == NULL) {
+        return;
+    }
+
+    app_frame_t *frames[4] = { 0 };
+    for (uint32_t i = 0; i < frame_num; i++) {
+        frames[i] = app_frame_pool_wrap(pool, alloc_frame_data(pool, 100, i), 100, i, false);
+        TEST_CHECK(frames[i] != NULL, "Wrap %" PRIu32 " of %" PRIu32 " failed", i, frame_num);
+    }
+
+    // No descriptor left, the buffer goes back to the memory pool
+    uint8_t *buffer = alloc_frame_data(pool, 100, 9);
+    TEST_CHECK(get_usage(pool).blocks == frame_num + 1, "Buffer not allocated");
+    TEST_CHECK(app_frame_pool_wrap(pool, buffer, 100, 9, false) == NULL, "Wrap succeeded without a free descriptor");
+    TEST_CHECK(get_usage(pool).blocks == frame_num, "Buffer of the failed wrap not freed");
+
+    // A released descriptor is used again
+    app_frame_unref(frames[1]);
+    frames[1] = app_frame_pool_wrap(pool, alloc_frame_data(pool, 100, 10), 100, 10, false);
+    TEST_CHECK((frames[1] != NULL) && (frames[1]->pts == 10) && is_frame_intact(frames[1]), "Wrap after a release");
+
+    app_frame_pool_stats_t stats;
+    app_frame_pool_get_stats(pool, &stats);
+    TEST_CHECK((stats.frames_in_use == frame_num) && (stats.frames_in_use_max == frame_num) &&
+               (stats.frames_wrapped == frame_num + 1) && (stats.wrap_failures == 1),
+               "Stats: %" PRIu32 " in use, %" PRIu32 " max, %" PRIu32 " wrapped, %" PRIu32 " failures",
+               stats.frames_in_use, stats.frames_in_use_max, stats.frames_wrapped, stats.wrap_failures);
+
+    for (uint32_t i = 0; i < frame_num; i++) {
+        app_frame_unref(frames[i]);
+    }
+    TEST_CHECK(get_usage(pool).blocks == 0, "%" PRIu32 " blocks left", get_usage(pool).blocks);
+    app_frame_pool_destroy(pool);
+}
+
+typedef struct {
+    QueueHandle_t queue;
+    SemaphoreHandle_t done;
+    uint32_t seed;
+    uint32_t frames;
+    uint32_t damaged;
+} consumer_t;
+
+static void consumer_task(void *arg)
+{
+    consumer_t *consumer = arg;
+    app_frame_t *frame = NULL;
+    while (xQueueReceive(consumer->queue, &frame, portMAX_DELAY) == pdTRUE && frame != NULL) {
+        // The decoder takes a few milliseconds now and then
+        if (rand_r(&consumer->seed) % 8 == 0) {
+            vTaskDelay(pdMS_TO_TICKS(1));
+        }
+        if (!is_frame_intact(frame)) {
+            consumer->damaged++;
+        }
+        consumer->frames++;
+        app_frame_unref(frame);
+    }
+    xSemaphoreGive(consumer->done);
+    vTaskDelete(NULL);
+}
+
+static void test_tasks(uint32_t frame_total)
+{
+    const uint32_t frame_num = 8;
+    app_frame_pool_handle_t pool = NULL;
+    TEST_CHECK(app_frame_pool_create(POOL_SIZE, frame_num, &pool) == ESP_OK, "Create failed");
+    if (pool == NULL) {
+        return;
+    }
+
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(CONSUMER_NUM, 0);
+    consumer_t consumers[CONSUMER_NUM];
+    for (int i = 0; i < CONSUMER_NUM; i++) {
+        consumers[i] = (consumer_t) {
+            .queue = xQueueCreate(16, sizeof(app_frame_t *)),
+            .done = done,
+            .seed = (uint32_t)i + 1,
+        };
+        TEST_CHECK(xTaskCreate(consumer_task, "consumer", 4096, &consumers[i], 5, NULL) == pdPASS, "Task failed");
+    }
+
+    // The extractor wraps each frame and hands a reference to each consumer
+    uint32_t seed = 42;
+    uint32_t sent = 0;
+    uint32_t failed = 0;
+    for (uint32_t pts = 0; pts < frame_total; pts++) {
+        uint32_t size = 64 + rand_r(&seed) % 2048;
+        uint8_t *buffer = alloc_frame_data(pool, size, pts);
+        if (buffer == NULL) {
+            failed++;
+            continue;
+        }
+        app_frame_t *frame = app_frame_pool_wrap(pool, buffer, size, pts, true);
+        if (frame == NULL) {
+            failed++;
+            vTaskDelay(pdMS_TO_TICKS(1));
+            continue;
+        }
+        for (int i = 0; i < CONSUMER_NUM; i++) {
+            app_frame_ref(frame);
+            xQueueSend(consumers[i].queue, &frame, portMAX_DELAY);
+        }
+        app_frame_unref(frame);
+        sent++;
+    }
+
+    app_frame_t *end = NULL;
+    for (int i = 0; i < CONSUMER_NUM; i++) {
+        xQueueSend(consumers[i].queue, &end, portMAX_DELAY);
+    }
+    for (int i = 0; i < CONSUMER_NUM; i++) {
+        xSemaphoreTake(done, portMAX_DELAY);
+    }
+
+    app_frame_pool_stats_t stats;
+    app_frame_pool_get_stats(pool, &stats);
+    mem_pool_host_usage_t usage = get_usage(pool);
+    printf("Tasks: %" PRIu32 " frames sent, %" PRIu32 " dropped, %" PRIu32 " in use at most, %" PRIu32 " bytes used at "
+           "most\n", sent, failed, stats.frames_in_use_max, usage.used_max);
+    for (int i = 0; i < CONSUMER_NUM; i++) {
+        TEST_CHECK(consumers[i].frames == sent, "Consumer %d: %" PRIu32 " of %" PRIu32 " frames", i,
+                   consumers[i].frames, sent);
+        TEST_CHECK(consumers[i].damaged == 0, "Consumer %d: %" PRIu32 " frames damaged", i, consumers[i].damaged);
+        vQueueDelete(consumers[i].queue);
+    }
+    TEST_CHECK(stats.frames_wrapped == sent, "%" PRIu32 " frames wrapped", stats.frames_wrapped);
+    TEST_CHECK(stats.frames_in_use == 0, "%" PRIu32 " frames in use", stats.frames_in_use);
+    TEST_CHECK(stats.frames_in_use_max <= frame_num, "%" PRIu32 " frames in use at most", stats.frames_in_use_max);
+    TEST_CHECK((usage.blocks == 0) && (usage.used == 0), "%" PRIu32 " blocks left", usage.blocks);
+
+    vSemaphoreDelete(done);
+    app_frame_pool_destroy(pool);
+}
+
+int main(int argc, char **argv)
+{
+    bool is_quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !is_quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The wrap failures are expected
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    test_invalid_args();
+    test_references();
+    test_exhausted();
+    test_tasks(is_quick ? 2000 : 20000);
+
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+
+    return EXIT_SUCCESS;
+}
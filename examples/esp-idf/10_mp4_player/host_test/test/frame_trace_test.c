@@ -0,0 +1,539 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+/**
+ * Test of the frame tracer. It traces frames with known refresh intervals and outcomes and checks the percentiles and
+ * the drops of the summary, then frames across the wrap of the low 32 bits of the timer, and checks each event of the
+ * Chrome trace dump, which must parse as JSON. Last a writer thread traces frames without pause in a small ring while
+ * the reader takes summaries and dumps, which must skip the records replaced during their copy.
+ *
+ * Usage: mp4_host_frame_trace_test [--quick]
+ */
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "app_frame_trace.h"
+
+#define FRAME_PERIOD_US     (33334) /*!< Even, so the times keep their lowest bit clear */
+#define PTS_STEP_MS         (33)
+#define JSON_DEPTH_MAX      (16)
+
+/* Times of the points from the start of a frame */
+#define READ_END_US         (2000)
+#define DECODE_START_US     (4000)
+#define DECODE_END_US       (10000)
+#define PRESENT_US          (12000)
+#define VSYNC_US            (16000)
+
+static int failure_num = 0;
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+/**
+ * @brief Trace a frame as the pipeline does, up to the stage it leaves at for its outcome
+ */
+static uint32_t trace_frame(app_frame_trace_handle_t trace, uint32_t pts, int64_t start_us,
+                            app_frame_trace_outcome_t outcome)
+{
+    uint32_t id = app_frame_trace_begin(trace, pts);
+    app_frame_trace_mark(trace, id, APP_FRAME_TRACE_READ_START, start_us);
+    app_frame_trace_mark(trace, id, APP_FRAME_TRACE_READ_END, start_us + READ_END_US);
+    if (outcome == APP_FRAME_TRACE_LATE) {
+        app_frame_trace_end(trace, id, outcome, start_us + DECODE_START_US);
+        return id;
+    }
+
+    app_frame_trace_mark(trace, id, APP_FRAME_TRACE_DECODE_START, start_us + DECODE_START_US);
+    app_frame_trace_mark(trace, id, APP_FRAME_TRACE_DECODE_END, start_us + DECODE_END_US);
+    if ((outcome == APP_FRAME_TRACE_FAILED) || (outcome == APP_FRAME_TRACE_NO_PICTURE)) {
+        app_frame_trace_end(trace, id, outcome, start_us + DECODE_END_US);
+        return id;
+    }
+    if (outcome == APP_FRAME_TRACE_PENDING) {
+        return id;
+    }
+
+    app_frame_trace_mark(trace, id, APP_FRAME_TRACE_PRESENT, start_us + PRESENT_US);
+    app_frame_trace_mark(trace, id, APP_FRAME_TRACE_VSYNC, start_us + VSYNC_US);
+    app_frame_trace_end(trace, id, outcome, start_us + VSYNC_US);
+    return id;
+}
+
+static const char *skip_json_space(const char *p)
+{
+    while ((*p == ' ') || (*p == '\t') || (*p == '\n') || (*p == '\r')) {
+        p++;
+    }
+    return p;
+}
+
+static const char *parse_json_digits(const char *p)
+{
+    if ((*p < '0') || (*p > '9')) {
+        return NULL;
+    }
+    while ((*p >= '0') && (*p <= '9')) {
+        p++;
+    }
+    return p;
+}
+
+static const char *parse_json_string(const char *p)
+{
+    if (*p++ != '"') {
+        return NULL;
+    }
+    while (*p != '"') {
+        if ((unsigned char)*p < 0x20) {
+            return NULL;
+        }
+        if (*p++ != '\\') {
+            continue;
+        }
+        if (*p == 'u') {
+            for (int i = 1; i <= 4; i++) {
+                if (strchr("0123456789abcdefABCDEF", p[i]) == NULL || p[i] == '\0') {
+                    return NULL;
+                }
+            }
+            p += 5;
+        } else if ((*p != '\0') && (strchr("\"\\/bfnrt", *p) != NULL)) {
+            p++;
+        } else {
+            return NULL;
+        }
+    }
+    return p + 1;
+}
+
+static const char *parse_json_number(const char *p)
+{
+    if (*p == '-') {
+        p++;
+    }
+    if (*p == '0') {
+        p++;
+    } else if ((p = parse_json_digits(p)) == NULL) {
+        return NULL;
+    }
+    if ((*p == '.') && ((p = parse_json_digits(p + 1)) == NULL)) {
+        return NULL;
+    }
+    if ((*p == 'e') || (*p == 'E')) {
+        p++;
+        if ((*p == '+') || (*p == '-')) {
+            p++;
+        }
+        p = parse_json_digits(p);
+    }
+    return p;
+}
+
+/**
+ * @brief Parse a JSON value (RFC 8259)
+ *
+ * @return The end of the value, or NULL if it is not valid
+ */
+static const char *parse_json_value(const char *p, int depth)
+{
+    p = skip_json_space(p);
+    if (depth > JSON_DEPTH_MAX) {
+        return NULL;
+    }
+
+    if ((*p == '{') || (*p == '[')) {
+        char close = (*p == '{') ? '}' : ']';
+        p = skip_json_space(p + 1);
+        if (*p == close) {
+            return p + 1;
+        }
+        while (true) {
+            if (close == '}') {
+                p = parse_json_string(skip_json_space(p));
+                if ((p == NULL) || (*(p = skip_json_space(p)) != ':')) {
+                    return NULL;
+                }
+                p++;
+            }
+            if ((p = parse_json_value(p, depth + 1)) == NULL) {
+                return NULL;
+            }
+            p = skip_json_space(p);
+            if (*p == close) {
+                return p + 1;
+            }
+            if (*p++ != ',') {
+                return NULL;
+            }
+        }
+    }
+    if (*p == '"') {
+        return parse_json_string(p);
+    }
+    if (strncmp(p, "true", 4) == 0) {
+        return p + 4;
+    }
+    if (strncmp(p, "false", 5) == 0) {
+        return p + 5;
+    }
+    if (strncmp(p, "null", 4) == 0) {
+        return p + 4;
+    }
+    return parse_json_number(p);
+}
+
+static bool check_json(const char *text)
+{
+    const char *end = parse_json_value(text, 0);
+    return (end != NULL) && (*skip_json_space(end) == '\0');
+}
+
+/**
+ * @brief Dump the trace into a string, to be freed
+ */
+static char *dump_trace(app_frame_trace_handle_t trace, uint32_t frames)
+{
+    char *text = NULL;
+    size_t size = 0;
+    FILE *out = open_memstream(&text, &size);
+    if (out == NULL) {
+        printf("Failed to open a memory stream\n");
+        exit(EXIT_FAILURE);
+    }
+    esp_err_t ret = app_frame_trace_dump(trace, out, frames);
+    fclose(out);
+    TEST_CHECK(ret == ESP_OK, "dump returned %d", ret);
+    return text;
+}
+
+typedef struct {
+    uint32_t events;
+    uint32_t frames;            /*!< Frames with a read event */
+    uint32_t first_frame;
+    uint32_t first_pts;
+    uint32_t last_frame;
+    uint32_t late;
+    uint32_t failed;
+} dump_stats_t;
+
+/**
+ * @brief Check each event of a dump of frames started every `FRAME_PERIOD_US` with a PTS of `PTS_STEP_MS` per frame
+ *
+ * The time stamps start at the read of the first frame, so they only depend on the distance to the first frame.
+ *
+ * @return The number of events whose time, duration or PTS differ
+ */
+static uint32_t check_dump_events(const char *text, dump_stats_t *stats)
+{
+    memset(stats, 0, sizeof(dump_stats_t));
+    uint32_t error_num = 0;
+    bool has_first = false;
+
+    for (const char *line = text; line != NULL; line = strchr(line, '\n')) {
+        line += (*line == '\n');
+        // The metadata events name the process and the threads
+        if ((strncmp(line, "{\"name\":", 8) != 0) || (strncmp(strstr(line, "\"ph\":"), "\"ph\":\"M\"", 8) == 0)) {
+            continue;
+        }
+
+        char name[16];
+        int tid;
+        int32_t ts;
+        uint32_t dur = 0;
+        uint32_t frame;
+        uint32_t pts;
+        bool complete = (sscanf(line, "{\"name\":\"%15[^\"]\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%" SCNd32
+                                ",\"dur\":%" SCNu32 ",\"args\":{\"frame\":%" SCNu32 ",\"pts\":%" SCNu32 "}}",
+                                name, &tid, &ts, &dur, &frame, &pts) == 6);
+        if (!complete && (sscanf(line, "{\"name\":\"%15[^\"]\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%"
+                                 SCNd32 ",\"args\":{\"frame\":%" SCNu32 ",\"pts\":%" SCNu32 "}}",
+                                 name, &tid, &ts, &frame, &pts) != 5)) {
+            error_num++;
+            continue;
+        }
+        stats->events++;
+        if (!has_first) {
+            stats->first_frame = frame;
+            stats->first_pts = pts;
+            has_first = true;
+        }
+
+        int32_t offset_us = -1;
+        uint32_t dur_us = 0;
+        if (complete && (strcmp(name, "read") == 0)) {
+            offset_us = 0;
+            dur_us = READ_END_US;
+            stats->frames++;
+            stats->last_frame = frame;
+        } else if (complete && (strcmp(name, "decode") == 0)) {
+            offset_us = DECODE_START_US;
+            dur_us = DECODE_END_US - DECODE_START_US;
+        } else if (complete && (strcmp(name, "present") == 0)) {
+            offset_us = PRESENT_US;
+            dur_us = VSYNC_US - PRESENT_US;
+        } else if (!complete && (strcmp(name, "vsync") == 0)) {
+            offset_us = VSYNC_US;
+        } else if (!complete && (strcmp(name, "late") == 0)) {
+            offset_us = DECODE_START_US;
+            stats->late++;
+        } else if (!complete && (strcmp(name, "failed") == 0)) {
+            offset_us = DECODE_END_US;
+            stats->failed++;
+        }
+
+        int32_t expected_ts = (int32_t)((frame - stats->first_frame) * FRAME_PERIOD_US) + offset_us;
+        if ((offset_us < 0) || (ts != expected_ts) || (dur != dur_us) || (pts - stats->first_pts != (frame - stats->first_frame) * PTS_STEP_MS)) {
+            error_num++;
+        }
+    }
+    return error_num;
+}
+
+/**
+ * @brief Frames with a known refresh interval each, and dropped frames between them
+ */
+static void test_summary(void)
+{
+    app_frame_trace_handle_t trace = NULL;
+    TEST_CHECK(app_frame_trace_create(0, &trace) == ESP_ERR_INVALID_ARG, "zero depth accepted");
+    TEST_CHECK(app_frame_trace_create(200, &trace) == ESP_OK, "create failed");
+    if (trace == NULL) {
+        return;
+    }
+
+    app_frame_trace_summary_t summary;
+    TEST_CHECK(app_frame_trace_get_summary(trace, &summary) == ESP_OK, "summary of no frame failed");
+    TEST_CHECK(summary.frames == 0 && summary.frame_max_us == 0, "summary of no frame: %" PRIu32 " frames",
+               summary.frames);
+
+    // Intervals of 100 us to 10 ms, each once and out of order: 37 is prime with 100
+    int64_t vsync_us = 1000000;
+    uint32_t late_num = 0;
+    uint32_t failed_num = 0;
+    trace_frame(trace, 0, vsync_us - VSYNC_US, APP_FRAME_TRACE_PRESENTED);
+    for (uint32_t i = 0; i < 100; i++) {
+        if (i % 10 == 5) {
+            trace_frame(trace, 0, vsync_us, APP_FRAME_TRACE_LATE);
+            late_num++;
+        }
+        if (i % 20 == 15) {
+            trace_frame(trace, 0, vsync_us, APP_FRAME_TRACE_FAILED);
+            failed_num++;
+        }
+        if (i % 30 == 25) {
+            trace_frame(trace, 0, vsync_us, APP_FRAME_TRACE_NO_PICTURE);
+        }
+        vsync_us += ((i * 37) % 100 + 1) * 100;
+        trace_frame(trace, 0, vsync_us - VSYNC_US, APP_FRAME_TRACE_PRESENTED);
+    }
+    // Still decoding
+    trace_frame(trace, 0, vsync_us, APP_FRAME_TRACE_PENDING);
+
+    TEST_CHECK(app_frame_trace_get_summary(trace, &summary) == ESP_OK, "summary failed");
+    TEST_CHECK(summary.frames == 101 + late_num + failed_num, "frames %" PRIu32 ", expected %" PRIu32,
+               summary.frames, 101 + late_num + failed_num);
+    TEST_CHECK(summary.frames_dropped == late_num + failed_num, "dropped %" PRIu32 ", expected %" PRIu32,
+               summary.frames_dropped, late_num + failed_num);
+    float drop_rate = (float)(late_num + failed_num) / (101 + late_num + failed_num);
+    TEST_CHECK(summary.drop_rate > drop_rate - 1e-6f && summary.drop_rate < drop_rate + 1e-6f,
+               "drop rate %f, expected %f", summary.drop_rate, drop_rate);
+    // Nearest rank of 100 sorted intervals
+    TEST_CHECK(summary.frame_p50_us == 5000, "p50 %" PRIu32 " us", summary.frame_p50_us);
+    TEST_CHECK(summary.frame_p95_us == 9500, "p95 %" PRIu32 " us", summary.frame_p95_us);
+    TEST_CHECK(summary.frame_p99_us == 9900, "p99 %" PRIu32 " us", summary.frame_p99_us);
+    TEST_CHECK(summary.frame_max_us == 10000, "max %" PRIu32 " us", summary.frame_max_us);
+
+    // Only the last frames of the ring are kept
+    app_frame_trace_clear(trace);
+    TEST_CHECK(app_frame_trace_get_summary(trace, &summary) == ESP_OK && summary.frames == 0,
+               "%" PRIu32 " frames after clear", summary.frames);
+    for (uint32_t i = 0; i < 300; i++) {
+        trace_frame(trace, i * PTS_STEP_MS, (int64_t)i * FRAME_PERIOD_US, APP_FRAME_TRACE_PRESENTED);
+    }
+    TEST_CHECK(app_frame_trace_get_summary(trace, &summary) == ESP_OK && summary.frames == 256,
+               "%" PRIu32 " frames in a ring of 256", summary.frames);
+    TEST_CHECK(summary.frame_p50_us == FRAME_PERIOD_US && summary.frame_max_us == FRAME_PERIOD_US,
+               "p50 %" PRIu32 " us, max %" PRIu32 " us", summary.frame_p50_us, summary.frame_max_us);
+
+    char *text = dump_trace(trace, 5);
+    dump_stats_t stats;
+    TEST_CHECK(check_json(text), "dump of the last frames is not JSON");
+    TEST_CHECK(check_dump_events(text, &stats) == 0, "dump of the last frames has wrong events");
+    TEST_CHECK(stats.frames == 5 && stats.last_frame == stats.first_frame + 4,
+               "dump of the last frames: %" PRIu32 " frames from %" PRIu32, stats.frames, stats.first_frame);
+    free(text);
+
+    // A handle not created is ignored
+    TEST_CHECK(app_frame_trace_begin(NULL, 0) == 0, "begin without handle");
+    app_frame_trace_mark(NULL, 0, APP_FRAME_TRACE_READ_START, 0);
+    app_frame_trace_end(NULL, 0, APP_FRAME_TRACE_PRESENTED, 0);
+    app_frame_trace_clear(NULL);
+    TEST_CHECK(app_frame_trace_get_summary(NULL, &summary) == ESP_ERR_INVALID_ARG, "summary without handle");
+    TEST_CHECK(app_frame_trace_dump(trace, NULL, 0) == ESP_ERR_INVALID_ARG, "dump without stream");
+    TEST_CHECK(app_frame_trace_destroy(NULL) == ESP_ERR_INVALID_ARG, "destroy without handle");
+    app_frame_trace_destroy(trace);
+}
+
+/**
+ * @brief Frames across the wrap of the low 32 bits of the timer, after 71.6 minutes
+ */
+static void test_time_wrap(void)
+{
+    app_frame_trace_handle_t trace = NULL;
+    TEST_CHECK(app_frame_trace_create(64, &trace) == ESP_OK, "create failed");
+    if (trace == NULL) {
+        return;
+    }
+
+    // The read of frame 10 starts on 2^32 us exactly, whose low bits are 0
+    int64_t base_us = (1LL << 32) - 10 * FRAME_PERIOD_US;
+    uint32_t late_num = 0;
+    uint32_t failed_num = 0;
+    for (uint32_t i = 0; i < 40; i++) {
+        app_frame_trace_outcome_t outcome = APP_FRAME_TRACE_PRESENTED;
+        if (i == 12 || i == 30) {
+            outcome = APP_FRAME_TRACE_LATE;
+            late_num++;
+        } else if (i == 9) {
+            outcome = APP_FRAME_TRACE_FAILED;
+            failed_num++;
+        }
+        trace_frame(trace, i * PTS_STEP_MS, base_us + (int64_t)i * FRAME_PERIOD_US, outcome);
+    }
+
+    app_frame_trace_summary_t summary;
+    TEST_CHECK(app_frame_trace_get_summary(trace, &summary) == ESP_OK, "summary failed");
+    TEST_CHECK(summary.frames == 40 && summary.frames_dropped == late_num + failed_num,
+               "across the wrap: %" PRIu32 " frames, %" PRIu32 " dropped", summary.frames, summary.frames_dropped);
+    // The refresh after a dropped frame comes two periods after the last one
+    TEST_CHECK(summary.frame_p50_us == FRAME_PERIOD_US, "across the wrap: p50 %" PRIu32 " us", summary.frame_p50_us);
+    TEST_CHECK(summary.frame_max_us == 2 * FRAME_PERIOD_US, "across the wrap: max %" PRIu32 " us",
+               summary.frame_max_us);
+
+    char *text = dump_trace(trace, 0);
+    dump_stats_t stats;
+    TEST_CHECK(check_json(text), "dump across the wrap is not JSON");
+    TEST_CHECK(check_dump_events(text, &stats) == 0, "dump across the wrap has wrong events");
+    TEST_CHECK(stats.frames == 40 && stats.first_frame == 0 && stats.last_frame == 39,
+               "dump across the wrap: %" PRIu32 " frames from %" PRIu32, stats.frames, stats.first_frame);
+    TEST_CHECK(stats.late == late_num && stats.failed == failed_num, "dump across the wrap: %" PRIu32 " late, %"
+               PRIu32 " failed", stats.late, stats.failed);
+    // Read, decode, present and vsync for each frame, minus the stages of the dropped frames
+    uint32_t events = 40 * 4 - late_num * 3 - failed_num * 2 + late_num + failed_num;
+    TEST_CHECK(stats.events == events, "dump across the wrap: %" PRIu32 " events, expected %" PRIu32,
+               stats.events, events);
+    free(text);
+
+    app_frame_trace_destroy(trace);
+}
+
+typedef struct {
+    app_frame_trace_handle_t trace;
+    atomic_uint frame_num;
+    atomic_bool stop;
+} writer_t;
+
+static void *writer_thread(void *arg)
+{
+    writer_t *writer = arg;
+    // Times past the wrap of the low bits, as the loop goes on
+    const int64_t base_us = (1LL << 32) - 1000 * FRAME_PERIOD_US;
+    while (!atomic_load(&writer->stop)) {
+        uint32_t id = atomic_load(&writer->frame_num);
+        trace_frame(writer->trace, id * PTS_STEP_MS, base_us + (int64_t)id * FRAME_PERIOD_US,
+                    APP_FRAME_TRACE_PRESENTED);
+        atomic_store(&writer->frame_num, id + 1);
+    }
+    return NULL;
+}
+
+/**
+ * @brief One writer without pause, the reader takes summaries and dumps meanwhile
+ */
+static void test_concurrent_reader(int read_num)
+{
+    writer_t writer = {0};
+    TEST_CHECK(app_frame_trace_create(16, &writer.trace) == ESP_OK, "create failed");
+    if (writer.trace == NULL) {
+        return;
+    }
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, writer_thread, &writer);
+    while (atomic_load(&writer.frame_num) < 16) {
+        sched_yield();
+    }
+
+    uint32_t skipped_num = 0;
+    uint32_t wrong_summary_num = 0;
+    uint32_t wrong_dump_num = 0;
+    for (int i = 0; i < read_num; i++) {
+        app_frame_trace_summary_t summary;
+        app_frame_trace_get_summary(writer.trace, &summary);
+        // A torn record would give another interval, or a drop
+        if ((summary.frames > 16) || (summary.frames_dropped != 0) ||
+                ((summary.frame_max_us != 0) && ((summary.frame_p50_us != FRAME_PERIOD_US) ||
+                                                 (summary.frame_max_us != FRAME_PERIOD_US)))) {
+            wrong_summary_num++;
+        }
+        // All the frames of the ring are presented but the one traced now
+        if (summary.frames < 15) {
+            skipped_num++;
+        }
+
+        char *text = dump_trace(writer.trace, 0);
+        dump_stats_t stats;
+        if (!check_json(text) || (check_dump_events(text, &stats) != 0) || (stats.frames > 16)) {
+            wrong_dump_num++;
+        }
+        free(text);
+    }
+
+    atomic_store(&writer.stop, true);
+    pthread_join(thread, NULL);
+
+    printf("%" PRIu32 " frames traced during %d reads, %" PRIu32 " summaries skipped a replaced record\n",
+           atomic_load(&writer.frame_num), read_num, skipped_num);
+    TEST_CHECK(wrong_summary_num == 0, "%" PRIu32 " summaries out of %d read torn records", wrong_summary_num,
+               read_num);
+    TEST_CHECK(wrong_dump_num == 0, "%" PRIu32 " dumps out of %d are wrong", wrong_dump_num, read_num);
+    app_frame_trace_destroy(writer.trace);
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The creation of the tracers logs their depth
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    test_summary();
+    test_time_wrap();
+    test_concurrent_reader(quick ? 2000 : 50000);
+
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+
+    return EXIT_SUCCESS;
+}
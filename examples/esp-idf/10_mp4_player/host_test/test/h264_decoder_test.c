@@ -0,0 +1,407 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+/**
+ * Test of the H.264 decoder on the decoder of `esp_h264` modelled on the host. It decodes streams of several sizes,
+ * without and with converting tasks, and compares each picture with the conversion of the picture the decoder output.
+ * It checks the parameter sets alone, a buffer too small, a new sequence which changes the size, the failures of the
+ * decoder and of its creation, and that every decoder is deleted. Then it reports the time per picture with 0 to 3
+ * converting tasks, only the conversion to RGB is split in bands, the decoding runs in the caller.
+ *
+ * Usage: mp4_host_h264_decoder_test [--quick]
+ */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "h264_dec_host.h"
+#include "app_h264_decoder.h"
+#include "app_yuv_convert.h"
+
+#define FRAME_MAX_SIZE      (32)        /*!< Largest frame built by the test */
+
+static int failure_num = 0;
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+} picture_size_t;
+
+/**
+ * @brief Build a frame in Annex-B: the parameter sets if a seed is given, then a slice
+ *
+ * @param seed Seed of the pictures of the sequence, 0 for a frame without parameter sets
+ * @param number Picture number of the slice, 0 for a frame without slice
+ * @return Size of the frame
+ */
+static uint32_t build_frame(uint8_t *frame, uint16_t width, uint16_t height, uint8_t seed, uint8_t number)
+{
+    uint32_t size = 0;
+    if (seed != 0) {
+        const uint8_t sps[] = {0, 0, 0, 1, 0x67, width >> 8, width & 0xFF, height >> 8, height & 0xFF, seed};
+        const uint8_t pps[] = {0, 0, 0, 1, 0x68, 0xCE};
+        memcpy(frame + size, sps, sizeof(sps));
+        size += sizeof(sps);
+        memcpy(frame + size, pps, sizeof(pps));
+        size += sizeof(pps);
+    }
+    if (number != 0) {
+        // An IDR slice after the parameter sets, a P slice otherwise
+        const uint8_t slice[] = {0, 0, 0, 1, (seed != 0) ? 0x65 : 0x41, number, 0x88};
+        memcpy(frame + size, slice, sizeof(slice));
+        size += sizeof(slice);
+    }
+    return size;
+}
+
+/**
+ * @brief Convert the picture the decoder outputs for a slice, as a reference
+ */
+static uint8_t *get_reference(uint16_t width, uint16_t height, uint8_t seed, uint8_t number,
+                              app_video_pixel_format_t format, bool bgr_order)
+{
+    uint32_t uv_stride = (width + 1) / 2;
+    uint32_t y_size = (uint32_t)width * height;
+    uint32_t uv_size = uv_stride * ((height + 1) / 2);
+    uint32_t bytes_per_pixel = (format == APP_VIDEO_PIXEL_RGB888) ? 3 : 2;
+    uint8_t *yuv = malloc(y_size + 2 * uv_size);
+    uint8_t *rgb = malloc(y_size * bytes_per_pixel);
+    if ((yuv == NULL) || (rgb == NULL)) {
+        free(yuv);
+        free(rgb);
+        return NULL;
+    }
+
+    h264_dec_host_fill_picture(yuv, width, height, seed, number);
+    app_yuv_picture_t picture = {
+        .y = yuv,
+        .u = yuv + y_size,
+        .v = yuv + y_size + uv_size,
+        .y_stride = width,
+        .uv_stride = uv_stride,
+        .width = width,
+        .height = height,
+    };
+    app_yuv_convert_rows(&picture, 0, height, format, bgr_order, rgb, width * bytes_per_pixel);
+    free(yuv);
+    return rgb;
+}
+
+static app_h264_decoder_handle_t create_decoder(app_video_pixel_format_t format, bool bgr_order, uint8_t tasks)
+{
+    app_h264_decoder_config_t config = APP_H264_DECODER_CONFIG_DEFAULT();
+    config.output_format = format;
+    config.bgr_order = bgr_order;
+    config.convert_tasks = tasks;
+    app_h264_decoder_handle_t decoder = NULL;
+    esp_err_t ret = app_h264_decoder_create(&config, &decoder);
+    TEST_CHECK(ret == ESP_OK, "Create with %d converting tasks: %d", tasks, ret);
+    return (ret == ESP_OK) ? decoder : NULL;
+}
+
+static void test_invalid_args(void)
+{
+    app_h264_decoder_config_t config = APP_H264_DECODER_CONFIG_DEFAULT();
+    app_h264_decoder_handle_t decoder = NULL;
+    TEST_CHECK(app_h264_decoder_create(NULL, &decoder) == ESP_ERR_INVALID_ARG, "Create without configuration");
+    TEST_CHECK(app_h264_decoder_create(&config, NULL) == ESP_ERR_INVALID_ARG, "Create without handle");
+    TEST_CHECK(app_h264_decoder_destroy(NULL) == ESP_ERR_INVALID_ARG, "Destroy without handle");
+
+    decoder = create_decoder(APP_VIDEO_PIXEL_RGB565, true, 1);
+    if (decoder == NULL) {
+        return;
+    }
+    uint8_t frame[FRAME_MAX_SIZE];
+    uint32_t size = build_frame(frame, 16, 16, 1, 1);
+    uint8_t out[16 * 16 * 2];
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t out_len = 0;
+    TEST_CHECK(app_h264_decoder_decode(NULL, frame, size, out, sizeof(out), &width, &height, &out_len) ==
+               ESP_ERR_INVALID_ARG, "Decode without decoder");
+    TEST_CHECK(app_h264_decoder_decode(decoder, NULL, size, out, sizeof(out), &width, &height, &out_len) ==
+               ESP_ERR_INVALID_ARG, "Decode without frame");
+    TEST_CHECK(app_h264_decoder_decode(decoder, frame, size, NULL, sizeof(out), &width, &height, &out_len) ==
+               ESP_ERR_INVALID_ARG, "Decode without output");
+    TEST_CHECK(app_h264_decoder_decode(decoder, frame, size, out, sizeof(out), NULL, &height, &out_len) ==
+               ESP_ERR_INVALID_ARG, "Decode without width");
+    TEST_CHECK(app_h264_decoder_decode(decoder, frame, size, out, sizeof(out), &width, NULL, &out_len) ==
+               ESP_ERR_INVALID_ARG, "Decode without height");
+    TEST_CHECK(app_h264_decoder_decode(decoder, frame, size, out, sizeof(out), &width, &height, NULL) ==
+               ESP_ERR_INVALID_ARG, "Decode without length");
+    app_h264_decoder_stats_t stats;
+    TEST_CHECK(app_h264_decoder_get_stats(NULL, &stats) == ESP_ERR_INVALID_ARG, "Stats without decoder");
+    TEST_CHECK(app_h264_decoder_get_stats(decoder, NULL) == ESP_ERR_INVALID_ARG, "Stats without output");
+    app_h264_decoder_destroy(decoder);
+}
+
+/**
+ * @brief Decode a stream of several pictures and compare each one with its reference
+ */
+static void test_pictures(const picture_size_t *sizes, size_t size_num, uint32_t picture_num)
+{
+    static const uint8_t task_nums[] = {0, 1, 3};
+    for (size_t t = 0; t < sizeof(task_nums) / sizeof(task_nums[0]); t++) {
+        for (int format = APP_VIDEO_PIXEL_RGB565; format <= APP_VIDEO_PIXEL_RGB888; format++) {
+            for (int bgr_order = 0; bgr_order <= 1; bgr_order++) {
+                for (size_t s = 0; s < size_num; s++) {
+                    uint16_t width = sizes[s].width;
+                    uint16_t height = sizes[s].height;
+                    uint32_t bytes_per_pixel = (format == APP_VIDEO_PIXEL_RGB888) ? 3 : 2;
+                    uint32_t out_size = (uint32_t)width * height * bytes_per_pixel;
+                    app_h264_decoder_handle_t decoder = create_decoder(format, bgr_order, task_nums[t]);
+                    uint8_t *out = malloc(out_size);
+                    if ((decoder == NULL) || (out == NULL)) {
+                        TEST_CHECK(out != NULL, "No memory for the output");
+                        if (decoder != NULL) {
+                            app_h264_decoder_destroy(decoder);
+                        }
+                        free(out);
+                        continue;
+                    }
+
+                    h264_dec_host_usage_t before;
+                    h264_dec_host_get_usage(&before);
+                    uint8_t seed = (uint8_t)(s + 1);
+                    uint32_t mismatches = 0;
+                    for (uint32_t i = 0; i < picture_num; i++) {
+                        uint8_t frame[FRAME_MAX_SIZE];
+                        uint8_t number = (uint8_t)(i % 255 + 1);
+                        uint32_t size = build_frame(frame, width, height, (i == 0) ? seed : 0, number);
+                        uint32_t out_width = 0;
+                        uint32_t out_height = 0;
+                        uint32_t out_len = 0;
+                        memset(out, 0, out_size);
+                        esp_err_t ret = app_h264_decoder_decode(decoder, frame, size, out, out_size,
+                                                                &out_width, &out_height, &out_len);
+                        TEST_CHECK((ret == ESP_OK) && (out_width == width) && (out_height == height) &&
+                                   (out_len == out_size), "%dx%d picture %" PRIu32 ": %d, %" PRIu32 "x%" PRIu32
+                                   " of %" PRIu32 " bytes", width, height, i, ret, out_width, out_height, out_len);
+
+                        uint8_t *expected = get_reference(width, height, seed, number, format, bgr_order);
+                        if (expected == NULL) {
+                            TEST_CHECK(false, "No memory for the reference");
+                            continue;
+                        }
+                        if (memcmp(out, expected, out_size) != 0) {
+                            mismatches++;
+                        }
+                        free(expected);
+                    }
+                    TEST_CHECK(mismatches == 0, "%dx%d %s %s, %d converting tasks: %" PRIu32 " pictures differ",
+                               width, height, (bytes_per_pixel == 3) ? "RGB888" : "RGB565",
+                               bgr_order ? "BGR" : "RGB", task_nums[t], mismatches);
+
+                    // Each picture is written back from the cache, in bands which cover it once
+                    h264_dec_host_usage_t after;
+                    h264_dec_host_get_usage(&after);
+                    TEST_CHECK(after.synced_bytes - before.synced_bytes == (uint64_t)out_size * picture_num,
+                               "%dx%d: %" PRIu64 " bytes written back for %" PRIu32 " pictures of %" PRIu32,
+                               width, height, after.synced_bytes - before.synced_bytes, picture_num, out_size);
+
+                    app_h264_decoder_stats_t stats;
+                    app_h264_decoder_get_stats(decoder, &stats);
+                    TEST_CHECK((stats.frames == picture_num) && (stats.reopens == 0),
+                               "%" PRIu32 " frames and %" PRIu32 " reopens for %" PRIu32 " pictures",
+                               stats.frames, stats.reopens, picture_num);
+                    TEST_CHECK((stats.decode_avg_us <= stats.decode_max_us) &&
+                               (stats.convert_avg_us <= stats.convert_max_us),
+                               "Average over the maximum: decode %" PRIu32 "/%" PRIu32 " us, convert %" PRIu32 "/%"
+                               PRIu32 " us", stats.decode_avg_us, stats.decode_max_us, stats.convert_avg_us,
+                               stats.convert_max_us);
+                    app_h264_decoder_destroy(decoder);
+                    free(out);
+                }
+            }
+        }
+    }
+}
+
+static void test_sequences(void)
+{
+    app_h264_decoder_handle_t decoder = create_decoder(APP_VIDEO_PIXEL_RGB565, true, 2);
+    if (decoder == NULL) {
+        return;
+    }
+    uint8_t out[64 * 48 * 2];
+    uint8_t frame[FRAME_MAX_SIZE];
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t out_len = 0;
+    esp_err_t ret;
+
+    // A slice before any sequence parameter set is an error of the decoder
+    uint32_t size = build_frame(frame, 0, 0, 0, 1);
+    ret = app_h264_decoder_decode(decoder, frame, size, out, sizeof(out), &width, &height, &out_len);
+    TEST_CHECK(ret == ESP_FAIL, "Slice without sequence: %d", ret);
+
+    // The parameter sets alone output no picture
+    size = build_frame(frame, 32, 24, 1, 0);
+    ret = app_h264_decoder_decode(decoder, frame, size, out, sizeof(out), &width, &height, &out_len);
+    TEST_CHECK(ret == ESP_ERR_NOT_FINISHED, "Parameter sets alone: %d", ret);
+    size = build_frame(frame, 0, 0, 0, 1);
+    ret = app_h264_decoder_decode(decoder, frame, size, out, sizeof(out), &width, &height, &out_len);
+    TEST_CHECK((ret == ESP_OK) && (width == 32) && (height == 24), "Slice after the parameter sets: %d, %" PRIu32
+               "x%" PRIu32, ret, width, height);
+
+    // The same sequence again keeps the decoder
+    size = build_frame(frame, 32, 24, 1, 2);
+    ret = app_h264_decoder_decode(decoder, frame, size, out, sizeof(out), &width, &height, &out_len);
+    app_h264_decoder_stats_t stats;
+    app_h264_decoder_get_stats(decoder, &stats);
+    TEST_CHECK((ret == ESP_OK) && (stats.reopens == 0), "Same sequence: %d, %" PRIu32 " reopens", ret,
+               stats.reopens);
+
+    // A new sequence reopens the decoder, with the new size
+    h264_dec_host_usage_t before;
+    h264_dec_host_get_usage(&before);
+    size = build_frame(frame, 64, 48, 2, 1);
+    ret = app_h264_decoder_decode(decoder, frame, size, out, sizeof(out), &width, &height, &out_len);
+    app_h264_decoder_get_stats(decoder, &stats);
+    h264_dec_host_usage_t after;
+    h264_dec_host_get_usage(&after);
+    TEST_CHECK((ret == ESP_OK) && (width == 64) && (height == 48) && (out_len == sizeof(out)),
+               "New sequence: %d, %" PRIu32 "x%" PRIu32 " of %" PRIu32 " bytes", ret, width, height, out_len);
+    TEST_CHECK((stats.reopens == 1) && (after.created == before.created + 1) && (after.decoders == before.decoders),
+               "New sequence: %" PRIu32 " reopens, %" PRIu32 " decoders created, %" PRIu32 " alive",
+               stats.reopens, after.created - before.created, after.decoders);
+    uint8_t *expected = get_reference(64, 48, 2, 1, APP_VIDEO_PIXEL_RGB565, true);
+    TEST_CHECK((expected != NULL) && (memcmp(out, expected, sizeof(out)) == 0), "New sequence: picture differs");
+    free(expected);
+
+    // A picture larger than the buffer
+    size = build_frame(frame, 64, 48, 2, 2);
+    ret = app_h264_decoder_decode(decoder, frame, size, out, sizeof(out) - 1, &width, &height, &out_len);
+    TEST_CHECK(ret == ESP_ERR_NO_MEM, "Buffer too small: %d", ret);
+
+    // A failure of the decoder loses the frame only
+    h264_dec_host_set_process_failures(1);
+    size = build_frame(frame, 0, 0, 0, 3);
+    ret = app_h264_decoder_decode(decoder, frame, size, out, sizeof(out), &width, &height, &out_len);
+    TEST_CHECK(ret == ESP_FAIL, "Decoder failure: %d", ret);
+    size = build_frame(frame, 0, 0, 0, 4);
+    ret = app_h264_decoder_decode(decoder, frame, size, out, sizeof(out), &width, &height, &out_len);
+    TEST_CHECK(ret == ESP_OK, "After a decoder failure: %d", ret);
+
+    // A new sequence while no decoder can be created, then once it can
+    h264_dec_host_set_new_failure(true);
+    size = build_frame(frame, 32, 24, 3, 1);
+    ret = app_h264_decoder_decode(decoder, frame, size, out, sizeof(out), &width, &height, &out_len);
+    TEST_CHECK(ret == ESP_ERR_NO_MEM, "New sequence without decoder: %d", ret);
+    h264_dec_host_set_new_failure(false);
+    ret = app_h264_decoder_decode(decoder, frame, size, out, sizeof(out), &width, &height, &out_len);
+    TEST_CHECK((ret == ESP_OK) && (width == 32) && (height == 24), "New sequence once a decoder can be created: %d,"
+               " %" PRIu32 "x%" PRIu32, ret, width, height);
+
+    app_h264_decoder_get_stats(decoder, &stats);
+    TEST_CHECK(stats.frames == 5, "%" PRIu32 " frames instead of 5", stats.frames);
+    app_h264_decoder_destroy(decoder);
+}
+
+static void test_create_failure(void)
+{
+    h264_dec_host_usage_t before;
+    h264_dec_host_get_usage(&before);
+    h264_dec_host_set_new_failure(true);
+    app_h264_decoder_config_t config = APP_H264_DECODER_CONFIG_DEFAULT();
+    config.convert_tasks = 2;
+    app_h264_decoder_handle_t decoder = NULL;
+    esp_err_t ret = app_h264_decoder_create(&config, &decoder);
+    h264_dec_host_set_new_failure(false);
+    h264_dec_host_usage_t after;
+    h264_dec_host_get_usage(&after);
+    TEST_CHECK((ret == ESP_ERR_NO_MEM) && (decoder == NULL), "Create without decoder: %d", ret);
+    TEST_CHECK(after.decoders == before.decoders, "%" PRIu32 " decoders left", after.decoders - before.decoders);
+
+    // Many decoders created and destroyed with their tasks
+    for (uint32_t i = 0; i < 50; i++) {
+        decoder = create_decoder(APP_VIDEO_PIXEL_RGB565, true, (uint8_t)(i % 4));
+        if (decoder != NULL) {
+            app_h264_decoder_destroy(decoder);
+        }
+    }
+}
+
+static void test_speed(uint32_t picture_num)
+{
+    static const picture_size_t sizes[] = { {854, 480}, {1280, 720} };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint16_t width = sizes[s].width;
+        uint16_t height = sizes[s].height;
+        uint32_t out_size = (uint32_t)width * height * 2;
+        uint8_t *out = malloc(out_size);
+        if (out == NULL) {
+            TEST_CHECK(false, "No memory for the output");
+            continue;
+        }
+
+        for (uint8_t tasks = 0; tasks <= 3; tasks++) {
+            app_h264_decoder_handle_t decoder = create_decoder(APP_VIDEO_PIXEL_RGB565, true, tasks);
+            if (decoder == NULL) {
+                continue;
+            }
+            int64_t start_us = esp_timer_get_time();
+            for (uint32_t i = 0; i < picture_num; i++) {
+                uint8_t frame[FRAME_MAX_SIZE];
+                uint32_t size = build_frame(frame, width, height, (i == 0) ? 1 : 0, (uint8_t)(i % 255 + 1));
+                uint32_t out_width;
+                uint32_t out_height;
+                uint32_t out_len;
+                app_h264_decoder_decode(decoder, frame, size, out, out_size, &out_width, &out_height, &out_len);
+            }
+            int64_t elapsed_us = esp_timer_get_time() - start_us;
+            app_h264_decoder_stats_t stats;
+            app_h264_decoder_get_stats(decoder, &stats);
+            printf("%dx%d to RGB565, %d converting tasks: %" PRId64 " us per picture, %" PRIu32 " us decoding, %"
+                   PRIu32 " us converting, %.0f pictures/s\n", width, height, tasks, elapsed_us / picture_num,
+                   stats.decode_avg_us, stats.convert_avg_us, picture_num * 1000000.0 / elapsed_us);
+            app_h264_decoder_destroy(decoder);
+        }
+        free(out);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool is_quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !is_quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The failures of the decoder are expected
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    // Bands of uneven heights, odd sizes and a single pair of rows
+    static const picture_size_t sizes[] = { {2, 2}, {33, 17}, {64, 6}, {176, 144}, {320, 241} };
+    test_invalid_args();
+    test_pictures(sizes, sizeof(sizes) / sizeof(sizes[0]), is_quick ? 4 : 40);
+    test_sequences();
+    test_create_failure();
+    test_speed(is_quick ? 10 : 300);
+
+    h264_dec_host_usage_t usage;
+    h264_dec_host_get_usage(&usage);
+    TEST_CHECK(usage.decoders == 0, "%" PRIu32 " decoders not deleted", usage.decoders);
+
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+
+    return EXIT_SUCCESS;
+}
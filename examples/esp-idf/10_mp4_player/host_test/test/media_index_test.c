@@ -0,0 +1,453 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+/**
+ * Test of the seek index. It builds the index of H.264 streams with fixed and random GOPs and of an MJPEG stream, saves
+ * and loads it, and compares the key frame found for random positions with a walk through the frames. Then it checks
+ * that the index is rejected when the media file changes, when the index file is damaged or truncated, and that a save
+ * which fails leaves no index behind.
+ *
+ * Usage: mp4_host_media_index_test [--quick]
+ */
+#include <inttypes.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "app_media_index.h"
+
+#define MEDIA_FPS           (30)
+#define MEDIA_SIZE          (4096)
+
+static int failure_num = 0;
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+/**
+ * @brief Kinds of the generated streams
+ */
+typedef enum {
+    STREAM_H264_GOP,        /*!< A key frame every second */
+    STREAM_H264_RANDOM,     /*!< A key frame every 5 to 120 frames, several frames may share a PTS */
+    STREAM_H264_CUT,        /*!< As STREAM_H264_GOP, but it does not start with a key frame */
+    STREAM_MJPEG,           /*!< Every frame is a key frame */
+} stream_kind_t;
+
+static const app_media_index_info_t test_info = {
+    .width = 1280,
+    .height = 720,
+    .fps = MEDIA_FPS,
+    .duration = 600000,
+    .audio_sample_rate = 44100,
+    .audio_channels = 2,
+    .audio_bits = 16,
+    .audio_duration = 599980,
+};
+
+static bool is_same_info(const app_media_index_info_t *a, const app_media_index_info_t *b)
+{
+    return (a->width == b->width) && (a->height == b->height) && (a->fps == b->fps) &&
+           (a->duration == b->duration) && (a->audio_sample_rate == b->audio_sample_rate) &&
+           (a->audio_channels == b->audio_channels) && (a->audio_bits == b->audio_bits) &&
+           (a->audio_duration == b->audio_duration);
+}
+
+/**
+ * @brief Create a media file, only its size and modification time matter to the index
+ */
+static void create_media(char *path)
+{
+    const char *dir = getenv("TMPDIR");
+    snprintf(path, 256, "%s/mp4_host_media_index_XXXXXX", (dir != NULL) ? dir : "/tmp");
+    int fd = mkstemp(path);
+    TEST_CHECK(fd >= 0, "Failed to create %s", path);
+    if (fd < 0) {
+        return;
+    }
+
+    static const uint8_t data[MEDIA_SIZE] = {0};
+    TEST_CHECK(write(fd, data, sizeof(data)) == (ssize_t)sizeof(data), "Failed to write %s", path);
+    close(fd);
+
+    // A fixed time, so a later change is seen whatever the resolution of the clock
+    struct utimbuf times = { .actime = 1700000000, .modtime = 1700000000 };
+    TEST_CHECK(utime(path, &times) == 0, "Failed to set the time of %s", path);
+}
+
+static void get_index_path(const char *media_path, char *path)
+{
+    snprintf(path, 300, "%s%s", media_path, APP_MEDIA_INDEX_SUFFIX);
+}
+
+static void remove_media(const char *media_path)
+{
+    char path[300];
+    get_index_path(media_path, path);
+    unlink(path);
+    unlink(media_path);
+}
+
+/**
+ * @brief Build the index of a generated stream, as the extractor reports its frames
+ */
+static app_media_index_handle_t build_index(stream_kind_t kind, uint32_t frame_num, uint32_t seed)
+{
+    app_media_index_handle_t index = NULL;
+    // No hint, so the frames are reallocated as the index grows
+    if (app_media_index_create(&test_info, 0, &index) != ESP_OK) {
+        TEST_CHECK(false, "Create failed");
+        return NULL;
+    }
+
+    uint32_t next_key = 0;
+    uint32_t pts = 0;
+    for (uint32_t i = 0; i < frame_num; i++) {
+        bool keyframe = false;
+        switch (kind) {
+        case STREAM_H264_GOP:
+            keyframe = (i % MEDIA_FPS) == 0;
+            pts = i * 1000 / MEDIA_FPS;
+            break;
+        case STREAM_H264_CUT:
+            keyframe = (i % MEDIA_FPS) == 7;
+            pts = i * 1000 / MEDIA_FPS;
+            break;
+        case STREAM_H264_RANDOM:
+            keyframe = (i == next_key);
+            if (keyframe) {
+                next_key = i + 5 + rand_r(&seed) % 116;
+            }
+            pts += rand_r(&seed) % 60;
+            break;
+        case STREAM_MJPEG:
+            keyframe = true;
+            pts = i * 1000 / MEDIA_FPS;
+            break;
+        }
+        // Sizes up to the largest one the index keeps
+        uint32_t size = keyframe ? 0x7FFFFFFF - i : 1 + (uint32_t)rand_r(&seed) % 65536;
+        esp_err_t ret = app_media_index_add_frame(index, pts, size, keyframe);
+        if (ret != ESP_OK) {
+            TEST_CHECK(false, "Add of frame %" PRIu32 " failed: %s", i, esp_err_to_name(ret));
+            break;
+        }
+    }
+    return index;
+}
+
+static void check_same_frames(app_media_index_handle_t a, app_media_index_handle_t b, const char *name)
+{
+    uint32_t count = app_media_index_get_frame_count(a);
+    TEST_CHECK(app_media_index_get_frame_count(b) == count, "%s: %" PRIu32 " frames, not %" PRIu32, name,
+               app_media_index_get_frame_count(b), count);
+    for (uint32_t i = 0; i < count; i++) {
+        app_media_index_frame_t frame_a;
+        app_media_index_frame_t frame_b;
+        if ((app_media_index_get_frame(a, i, &frame_a) != ESP_OK) ||
+                (app_media_index_get_frame(b, i, &frame_b) != ESP_OK) || (frame_a.pts != frame_b.pts) ||
+                (frame_a.size != frame_b.size) || (frame_a.keyframe != frame_b.keyframe)) {
+            TEST_CHECK(false, "%s: frame %" PRIu32 " differs", name, i);
+            return;
+        }
+    }
+}
+
+static int compare_positions(const void *a, const void *b)
+{
+    uint32_t pa = *(const uint32_t *)a;
+    uint32_t pb = *(const uint32_t *)b;
+    return (pa > pb) - (pa < pb);
+}
+
+/**
+ * @brief Compare the key frames found for random positions with a walk through all the frames in order
+ */
+static void check_keyframes(app_media_index_handle_t index, uint32_t round_num, uint32_t seed, const char *name)
+{
+    uint32_t count = app_media_index_get_frame_count(index);
+    app_media_index_frame_t frame;
+    app_media_index_get_frame(index, count - 1, &frame);
+    uint32_t end_pts = frame.pts;
+
+    // Positions before the start and after the end too
+    uint32_t *positions = malloc(round_num * sizeof(uint32_t));
+    TEST_CHECK(positions != NULL, "%s: no memory for the positions", name);
+    if (positions == NULL) {
+        return;
+    }
+    positions[0] = 0;
+    positions[1] = UINT32_MAX;
+    for (uint32_t i = 2; i < round_num; i++) {
+        positions[i] = rand_r(&seed) % (end_pts + 2000);
+    }
+    qsort(positions, round_num, sizeof(uint32_t), compare_positions);
+
+    uint32_t frame_index = 0;
+    int64_t key_index = -1;
+    uint32_t not_found = 0;
+    for (uint32_t i = 0; i < round_num; i++) {
+        // Last frame at or before the position and the last key frame up to it
+        while (frame_index < count) {
+            app_media_index_get_frame(index, frame_index, &frame);
+            if ((frame.pts > positions[i]) && (frame_index > 0)) {
+                break;
+            }
+            if (frame.keyframe) {
+                key_index = frame_index;
+            }
+            if (frame.pts > positions[i]) {
+                break;
+            }
+            frame_index++;
+        }
+
+        uint32_t found_index = UINT32_MAX;
+        uint32_t pts = UINT32_MAX;
+        esp_err_t ret = app_media_index_find_keyframe(index, positions[i], &found_index, &pts);
+        if (key_index < 0) {
+            TEST_CHECK(ret == ESP_ERR_NOT_FOUND, "%s: key frame %" PRIu32 " found for %" PRIu32 " before any", name,
+                       found_index, positions[i]);
+            not_found++;
+            continue;
+        }
+        app_media_index_get_frame(index, (uint32_t)key_index, &frame);
+        TEST_CHECK((ret == ESP_OK) && (found_index == key_index) && (pts == frame.pts),
+                   "%s: key frame %" PRIu32 " (PTS %" PRIu32 ") for %" PRIu32 ", not %" PRId64 ": %s", name,
+                   found_index, pts, positions[i], key_index, esp_err_to_name(ret));
+    }
+    free(positions);
+
+    TEST_CHECK(app_media_index_find_keyframe(index, end_pts, NULL, NULL) == ESP_OK, "%s: find without the outputs",
+               name);
+    printf("%s: %" PRIu32 " frames, %" PRIu32 " positions before the first key frame\n", name, count, not_found);
+}
+
+static bool is_index_valid(const char *media_path)
+{
+    app_media_index_handle_t index = NULL;
+    if (app_media_index_load(media_path, &index) != ESP_OK) {
+        return false;
+    }
+    app_media_index_destroy(index);
+    return true;
+}
+
+static void test_invalid_args(void)
+{
+    app_media_index_handle_t index = NULL;
+    app_media_index_info_t info;
+
+    TEST_CHECK(app_media_index_load(NULL, &index) == ESP_ERR_INVALID_ARG, "Load without a path");
+    TEST_CHECK(app_media_index_load("/none", NULL) == ESP_ERR_INVALID_ARG, "Load without a handle");
+    TEST_CHECK(app_media_index_load_info(NULL, &info) == ESP_ERR_INVALID_ARG, "Load info without a path");
+    TEST_CHECK(app_media_index_create(NULL, 0, &index) == ESP_ERR_INVALID_ARG, "Create without the info");
+    TEST_CHECK(app_media_index_add_frame(NULL, 0, 0, true) == ESP_ERR_INVALID_ARG, "Add without a handle");
+    TEST_CHECK(app_media_index_save(NULL, "/none") == ESP_ERR_INVALID_ARG, "Save without a handle");
+    TEST_CHECK(app_media_index_find_keyframe(NULL, 0, NULL, NULL) == ESP_ERR_INVALID_ARG, "Find without a handle");
+    TEST_CHECK(app_media_index_destroy(NULL) == ESP_ERR_INVALID_ARG, "Destroy without a handle");
+    TEST_CHECK(app_media_index_get_info(NULL) == NULL, "Info without a handle");
+    TEST_CHECK(app_media_index_get_frame_count(NULL) == 0, "Frames without a handle");
+
+    TEST_CHECK(app_media_index_create(&test_info, 0, &index) == ESP_OK, "Create failed");
+    app_media_index_frame_t frame;
+    TEST_CHECK(app_media_index_find_keyframe(index, 0, NULL, NULL) == ESP_ERR_NOT_FOUND, "Find in an empty index");
+    TEST_CHECK(app_media_index_get_frame(index, 0, &frame) == ESP_ERR_INVALID_ARG, "Frame of an empty index");
+    TEST_CHECK(app_media_index_add_frame(index, 100, 10, false) == ESP_OK, "Add failed");
+    TEST_CHECK(app_media_index_find_keyframe(index, 100, NULL, NULL) == ESP_ERR_NOT_FOUND, "Find without key frame");
+    TEST_CHECK(app_media_index_add_frame(index, 100, 10, true) == ESP_OK, "Add with the same PTS failed");
+    TEST_CHECK(app_media_index_add_frame(index, 99, 10, true) == ESP_ERR_INVALID_STATE, "Add with the PTS back");
+    TEST_CHECK(app_media_index_get_frame_count(index) == 2, "%" PRIu32 " frames after a rejected one",
+               app_media_index_get_frame_count(index));
+    TEST_CHECK(app_media_index_get_frame(index, 1, NULL) == ESP_ERR_INVALID_ARG, "Frame without the output");
+
+    // A path too long for the index
+    char long_path[400];
+    memset(long_path, 'a', sizeof(long_path) - 1);
+    long_path[sizeof(long_path) - 1] = '\0';
+    TEST_CHECK(app_media_index_save(index, long_path) == ESP_ERR_NOT_FOUND, "Save with a path too long");
+    TEST_CHECK(app_media_index_load(long_path, &index) == ESP_ERR_NOT_FOUND, "Load with a path too long");
+    TEST_CHECK(app_media_index_save(index, "/nonexistent/media.mp4") == ESP_ERR_NOT_FOUND, "Save without media");
+    app_media_index_destroy(index);
+}
+
+static void test_round_trip(uint32_t frame_num, uint32_t round_num)
+{
+    static const struct {
+        stream_kind_t kind;
+        const char *name;
+    } streams[] = {
+        {STREAM_H264_GOP, "H.264"},
+        {STREAM_H264_RANDOM, "H.264 random GOP"},
+        {STREAM_H264_CUT, "H.264 cut"},
+        {STREAM_MJPEG, "MJPEG"},
+    };
+
+    for (size_t i = 0; i < sizeof(streams) / sizeof(streams[0]); i++) {
+        char path[256];
+        create_media(path);
+        app_media_index_handle_t built = build_index(streams[i].kind, frame_num, i + 1);
+        if (built == NULL) {
+            remove_media(path);
+            continue;
+        }
+        TEST_CHECK(!is_index_valid(path), "%s: index loaded before the save", streams[i].name);
+        TEST_CHECK(app_media_index_save(built, path) == ESP_OK, "%s: save failed", streams[i].name);
+
+        int64_t start_us = esp_timer_get_time();
+        app_media_index_handle_t loaded = NULL;
+        esp_err_t ret = app_media_index_load(path, &loaded);
+        int64_t load_us = esp_timer_get_time() - start_us;
+        TEST_CHECK(ret == ESP_OK, "%s: load failed: %s", streams[i].name, esp_err_to_name(ret));
+        if (ret == ESP_OK) {
+            TEST_CHECK(is_same_info(app_media_index_get_info(loaded), &test_info), "%s: info differs",
+                       streams[i].name);
+            check_same_frames(built, loaded, streams[i].name);
+            check_keyframes(loaded, round_num, i + 1, streams[i].name);
+            printf("%s: loaded in %" PRId64 " us\n", streams[i].name, load_us);
+            app_media_index_destroy(loaded);
+        }
+
+        app_media_index_info_t info;
+        TEST_CHECK((app_media_index_load_info(path, &info) == ESP_OK) && is_same_info(&info, &test_info),
+                   "%s: load of the info failed", streams[i].name);
+
+        app_media_index_destroy(built);
+        remove_media(path);
+    }
+}
+
+/**
+ * @brief Write bytes of an index file at an offset
+ */
+static void patch_index(const char *media_path, long offset, const void *data, size_t size)
+{
+    char path[300];
+    get_index_path(media_path, path);
+    FILE *file = fopen(path, "r+b");
+    TEST_CHECK(file != NULL, "Failed to open %s", path);
+    if (file == NULL) {
+        return;
+    }
+    TEST_CHECK((fseek(file, offset, SEEK_SET) == 0) && (fwrite(data, size, 1, file) == 1), "Failed to patch %s", path);
+    fclose(file);
+}
+
+static off_t get_index_size(const char *media_path)
+{
+    char path[300];
+    struct stat index_stat;
+    get_index_path(media_path, path);
+    return (stat(path, &index_stat) == 0) ? index_stat.st_size : -1;
+}
+
+static void test_validation(void)
+{
+    char path[256];
+    char index_path[300];
+    create_media(path);
+    get_index_path(path, index_path);
+    app_media_index_handle_t index = build_index(STREAM_H264_GOP, 1000, 1);
+    if (index == NULL) {
+        remove_media(path);
+        return;
+    }
+
+    // The media file is modified, the modification time changes
+    TEST_CHECK(app_media_index_save(index, path) == ESP_OK, "Save failed");
+    TEST_CHECK(is_index_valid(path), "Index rejected");
+    struct utimbuf times = { .actime = 1700000001, .modtime = 1700000001 };
+    utime(path, &times);
+    TEST_CHECK(!is_index_valid(path), "Index accepted after the media time changed");
+    app_media_index_info_t info;
+    TEST_CHECK(app_media_index_load_info(path, &info) == ESP_ERR_NOT_FOUND, "Info accepted after the time changed");
+
+    // The media file is replaced by one of another size with the same time
+    TEST_CHECK(app_media_index_save(index, path) == ESP_OK, "Save failed");
+    TEST_CHECK(truncate(path, MEDIA_SIZE / 2) == 0, "Failed to truncate the media");
+    utime(path, &times);
+    TEST_CHECK(!is_index_valid(path), "Index accepted after the media size changed");
+    TEST_CHECK(app_media_index_save(index, path) == ESP_OK, "Save failed");
+    TEST_CHECK(is_index_valid(path), "Index rejected after a new save");
+
+    // The header is damaged, the magic is first and the version follows it
+    off_t full_size = get_index_size(path);
+    uint32_t bad_magic = 0x12345678;
+    patch_index(path, 0, &bad_magic, sizeof(bad_magic));
+    TEST_CHECK(!is_index_valid(path), "Index accepted with a bad magic");
+    TEST_CHECK(app_media_index_save(index, path) == ESP_OK, "Save failed");
+    uint16_t bad_version = 2;
+    patch_index(path, 4, &bad_version, sizeof(bad_version));
+    TEST_CHECK(!is_index_valid(path), "Index accepted with another version");
+    uint16_t bad_entry_size = 12;
+    TEST_CHECK(app_media_index_save(index, path) == ESP_OK, "Save failed");
+    patch_index(path, 6, &bad_entry_size, sizeof(bad_entry_size));
+    TEST_CHECK(!is_index_valid(path), "Index accepted with another entry size");
+
+    // The index file is truncated, in the frames and in the header
+    TEST_CHECK(app_media_index_save(index, path) == ESP_OK, "Save failed");
+    TEST_CHECK(truncate(index_path, full_size - 3) == 0, "Failed to truncate the index");
+    TEST_CHECK(!is_index_valid(path), "Index accepted truncated in the frames");
+    TEST_CHECK(app_media_index_load_info(path, &info) == ESP_OK, "Info rejected with the frames truncated");
+    TEST_CHECK(truncate(index_path, 10) == 0, "Failed to truncate the index");
+    TEST_CHECK(!is_index_valid(path), "Index accepted truncated in the header");
+    TEST_CHECK(truncate(index_path, 0) == 0, "Failed to truncate the index");
+    TEST_CHECK(!is_index_valid(path), "Empty index accepted");
+
+    // The file system is full during the save: the size of a file is limited, and the signal ignored so that the
+    // write fails with EFBIG instead
+    TEST_CHECK(app_media_index_save(index, path) == ESP_OK, "Save failed");
+    struct rlimit old_limit;
+    getrlimit(RLIMIT_FSIZE, &old_limit);
+    struct rlimit limit = { .rlim_cur = (rlim_t)full_size / 2, .rlim_max = old_limit.rlim_max };
+    void (*old_handler)(int) = signal(SIGXFSZ, SIG_IGN);
+    TEST_CHECK(setrlimit(RLIMIT_FSIZE, &limit) == 0, "Failed to limit the file size");
+    TEST_CHECK(app_media_index_save(index, path) == ESP_FAIL, "Save to a full file system succeeded");
+    setrlimit(RLIMIT_FSIZE, &old_limit);
+    signal(SIGXFSZ, old_handler);
+    TEST_CHECK(get_index_size(path) < 0, "Partial index left behind, %lld bytes", (long long)get_index_size(path));
+    TEST_CHECK(!is_index_valid(path), "Index accepted after a failed save");
+    TEST_CHECK(app_media_index_save(index, path) == ESP_OK, "Save after a failed one failed");
+    TEST_CHECK(is_index_valid(path), "Index rejected after a failed save");
+
+    app_media_index_destroy(index);
+    remove_media(path);
+}
+
+int main(int argc, char **argv)
+{
+    bool is_quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !is_quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The rejected indexes are expected
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    test_invalid_args();
+    // 10 minutes or 2 hours at 30 fps
+    test_round_trip(is_quick ? 18000 : 216000, is_quick ? 2000 : 100000);
+    test_validation();
+
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,395 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+/**
+ * Test of the playlist. It loads an M3U file of a temporary card, then merges the new files of the card by name, and
+ * plays them in each loop mode, checking that a peek returns the file the next move picks. Then it plays shuffled rounds
+ * and counts the position of each file, adds files and turns the shuffle off in the middle of a round. Last it saves the
+ * playlist and resumes at the current file, in order and shuffled.
+ *
+ * Usage: mp4_host_playlist_test [--quick]
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "esp_log.h"
+#include "app_playlist.h"
+
+#define SHUFFLE_FILE_NUM    (8)
+#define PATH_MAX_LEN        (256)
+#define SHUFFLED_RESUME_NUM (20)
+
+static int failure_num = 0;
+static char card_dir[] = "/tmp/mp4_host_playlist_XXXXXX";
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+static void make_card_path(char *path, const char *name)
+{
+    snprintf(path, PATH_MAX_LEN, "%s/%s", card_dir, name);
+}
+
+static void write_card_file(const char *name, const char *content)
+{
+    char path[PATH_MAX_LEN];
+    make_card_path(path, name);
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        printf("Failed to create %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    fputs(content, file);
+    fclose(file);
+}
+
+static void remove_card_file(const char *name)
+{
+    char path[PATH_MAX_LEN];
+    make_card_path(path, name);
+    remove(path);
+}
+
+/**
+ * @brief Name of a file of the card, from its path
+ */
+static const char *get_name(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+    return (slash != NULL) ? slash + 1 : path;
+}
+
+/**
+ * @brief Peek at the next file, then move to it, and check that both return the same file
+ *
+ * @return Name of the file, or NULL at the end of the playlist
+ */
+static const char *peek_and_next(app_playlist_handle_t playlist)
+{
+    const char *peeked = NULL;
+    const char *path = NULL;
+    esp_err_t peek_ret = app_playlist_peek_next(playlist, &peeked);
+    esp_err_t next_ret = app_playlist_next(playlist, &path);
+    TEST_CHECK(peek_ret == next_ret, "Peek returns %s, next returns %s", esp_err_to_name(peek_ret),
+               esp_err_to_name(next_ret));
+    if (next_ret != ESP_OK) {
+        return NULL;
+    }
+    TEST_CHECK((peek_ret == ESP_OK) && (strcmp(peeked, path) == 0), "Peek returns %s, next returns %s",
+               (peek_ret == ESP_OK) ? peeked : "nothing", path);
+    return get_name(path);
+}
+
+/**
+ * @brief Play the files and compare their names, separated by spaces, "." for the end of the playlist
+ */
+static void check_play(app_playlist_handle_t playlist, const char *case_name, const char *expected)
+{
+    char played[PATH_MAX_LEN * 2] = "";
+    size_t len = 0;
+    for (const char *name = expected; *name != '\0';) {
+        size_t name_len = strcspn(name, " ");
+        const char *path = peek_and_next(playlist);
+        len += snprintf(&played[len], sizeof(played) - len, "%s%s", (len > 0) ? " " : "", path ? path : ".");
+        name += name_len;
+        name += (*name == ' ') ? 1 : 0;
+    }
+    TEST_CHECK(strcmp(played, expected) == 0, "%s: played \"%s\", expected \"%s\"", case_name, played, expected);
+}
+
+static app_playlist_handle_t create_playlist(const char *path, bool shuffle, app_playlist_loop_t loop)
+{
+    app_playlist_config_t config = APP_PLAYLIST_CONFIG_DEFAULT();
+    config.path = path;
+    config.shuffle = shuffle;
+    config.loop = loop;
+    app_playlist_handle_t playlist = NULL;
+    TEST_CHECK(app_playlist_create(&config, &playlist) == ESP_OK, "Create failed");
+    return playlist;
+}
+
+/**
+ * @brief Load the M3U file of the card, then add the new files of the card
+ */
+static app_playlist_handle_t open_card_playlist(bool shuffle, app_playlist_loop_t loop)
+{
+    char m3u_path[PATH_MAX_LEN];
+    make_card_path(m3u_path, "playlist.m3u");
+    app_playlist_handle_t playlist = create_playlist(m3u_path, shuffle, loop);
+    TEST_CHECK(app_playlist_load(playlist) == ESP_OK, "Load failed");
+    TEST_CHECK(app_playlist_scan(playlist, card_dir, ".mp4") == ESP_OK, "Scan failed");
+    return playlist;
+}
+
+static void test_load_and_scan(void)
+{
+    char m3u[PATH_MAX_LEN * 2];
+    char path[PATH_MAX_LEN];
+    make_card_path(path, "a.mp4");
+    // A relative path, an absolute one, a missing file, spaces, comments and blank lines
+    snprintf(m3u, sizeof(m3u), "#EXTM3U\n#EXTINF:10,Clip C\nc.mp4\r\n%s\n\nmissing.mp4\n  b.MP4  \nc.mp4\n", path);
+    write_card_file("playlist.m3u", m3u);
+
+    app_playlist_handle_t playlist = create_playlist(NULL, false, APP_PLAYLIST_LOOP_NONE);
+    TEST_CHECK(app_playlist_load(playlist) == ESP_ERR_INVALID_STATE, "A playlist without M3U file is loaded");
+    app_playlist_destroy(playlist);
+
+    make_card_path(path, "none.m3u");
+    playlist = create_playlist(path, false, APP_PLAYLIST_LOOP_NONE);
+    TEST_CHECK(app_playlist_load(playlist) == ESP_ERR_NOT_FOUND, "A missing M3U file is loaded");
+    const char *peeked = NULL;
+    TEST_CHECK(app_playlist_peek_next(playlist, &peeked) == ESP_ERR_NOT_FOUND, "An empty playlist has a file");
+    app_playlist_destroy(playlist);
+
+    // The files of the M3U file keep its order, a file listed twice is added once
+    make_card_path(path, "playlist.m3u");
+    playlist = create_playlist(path, false, APP_PLAYLIST_LOOP_NONE);
+    TEST_CHECK(app_playlist_load(playlist) == ESP_OK, "Load failed");
+    TEST_CHECK(app_playlist_get_count(playlist) == 3, "%" PRIu32 " files loaded, expected 3",
+               app_playlist_get_count(playlist));
+    TEST_CHECK(app_playlist_get_current(playlist, NULL, NULL) == ESP_ERR_NOT_FOUND, "A file is current at the start");
+    check_play(playlist, "M3U", "c.mp4 a.mp4 b.MP4 .");
+    app_playlist_destroy(playlist);
+
+    // The new files of the card follow by name, whatever the order of the directory
+    playlist = open_card_playlist(false, APP_PLAYLIST_LOOP_NONE);
+    TEST_CHECK(app_playlist_get_count(playlist) == 6, "%" PRIu32 " files after the scan, expected 6",
+               app_playlist_get_count(playlist));
+    check_play(playlist, "Scan", "c.mp4 a.mp4 b.MP4 0.mp4 d.mp4 e.Mp4 .");
+    TEST_CHECK(app_playlist_scan(playlist, card_dir, ".mp4") == ESP_OK, "Second scan failed");
+    TEST_CHECK(app_playlist_get_count(playlist) == 6, "A second scan adds files");
+    TEST_CHECK(app_playlist_scan(playlist, "/nonexistent_mp4_card", ".mp4") == ESP_ERR_NOT_FOUND,
+               "A missing directory is scanned");
+    app_playlist_destroy(playlist);
+}
+
+static void test_loop_modes(void)
+{
+    app_playlist_handle_t playlist = open_card_playlist(false, APP_PLAYLIST_LOOP_ALL);
+    check_play(playlist, "Loop all", "c.mp4 a.mp4 b.MP4 0.mp4 d.mp4 e.Mp4 c.mp4 a.mp4");
+
+    // The current file repeats, then the playlist goes on from it
+    TEST_CHECK(app_playlist_set_loop(playlist, APP_PLAYLIST_LOOP_ONE) == ESP_OK, "Set loop failed");
+    check_play(playlist, "Loop one", "a.mp4 a.mp4 a.mp4");
+    uint32_t position = 0;
+    const char *path = NULL;
+    TEST_CHECK((app_playlist_get_current(playlist, &position, &path) == ESP_OK) && (position == 1) &&
+               (strcmp(get_name(path), "a.mp4") == 0), "Loop one: current %" PRIu32 " %s", position,
+               path ? path : "none");
+
+    TEST_CHECK(app_playlist_set_loop(playlist, APP_PLAYLIST_LOOP_NONE) == ESP_OK, "Set loop failed");
+    check_play(playlist, "Loop none", "b.MP4 0.mp4 d.mp4 e.Mp4 . .");
+    app_playlist_destroy(playlist);
+
+    // The first file is played before the repeat starts
+    playlist = open_card_playlist(false, APP_PLAYLIST_LOOP_ONE);
+    check_play(playlist, "Loop one from the start", "c.mp4 c.mp4");
+    app_playlist_destroy(playlist);
+}
+
+static void test_shuffle(int round_num)
+{
+    // count[file][position] over the rounds
+    static int position_counts[SHUFFLE_FILE_NUM][SHUFFLE_FILE_NUM];
+    memset(position_counts, 0, sizeof(position_counts));
+
+    app_playlist_handle_t playlist = create_playlist(NULL, true, APP_PLAYLIST_LOOP_ALL);
+    char path[PATH_MAX_LEN];
+    for (int i = 0; i < SHUFFLE_FILE_NUM; i++) {
+        snprintf(path, sizeof(path), "/sdcard/%d.mp4", i);
+        app_playlist_add(playlist, path);
+    }
+
+    // Each round is a permutation, and does not start with the file which ended the previous one
+    int last_file = -1;
+    bool is_permutation = true;
+    bool is_repeated = false;
+    for (int round = 0; round < round_num; round++) {
+        bool played[SHUFFLE_FILE_NUM] = {};
+        for (int i = 0; i < SHUFFLE_FILE_NUM; i++) {
+            const char *name = peek_and_next(playlist);
+            int file = (name != NULL) ? atoi(name) : -1;
+            if ((file < 0) || (file >= SHUFFLE_FILE_NUM) || played[file]) {
+                is_permutation = false;
+                continue;
+            }
+            is_repeated |= (i == 0) && (file == last_file);
+            played[file] = true;
+            position_counts[file][i]++;
+            last_file = file;
+        }
+    }
+    TEST_CHECK(is_permutation, "Shuffle: a round is not a permutation of the files");
+    TEST_CHECK(!is_repeated, "Shuffle: a round starts with the file just played");
+
+    // Each file is as likely at each position, the bound is about 4 standard deviations
+    double expected = (double)round_num / SHUFFLE_FILE_NUM;
+    double max_deviation = 0;
+    for (int file = 0; file < SHUFFLE_FILE_NUM; file++) {
+        for (int i = 0; i < SHUFFLE_FILE_NUM; i++) {
+            double deviation = (position_counts[file][i] - expected) / expected;
+            max_deviation = (deviation > max_deviation) ? deviation : max_deviation;
+            max_deviation = (-deviation > max_deviation) ? -deviation : max_deviation;
+        }
+    }
+    double bound = 4 / __builtin_sqrt(expected);
+    printf("Shuffle: %d rounds of %d files, position counts within %.1f%% of the mean\n", round_num,
+           SHUFFLE_FILE_NUM, max_deviation * 100);
+    TEST_CHECK(max_deviation < bound, "Shuffle: a position count is %.1f%% off the mean, bound %.1f%%",
+               max_deviation * 100, bound * 100);
+
+    // A file added in the middle of a round is played in the rest of it
+    peek_and_next(playlist);
+    peek_and_next(playlist);
+    app_playlist_add(playlist, "/sdcard/8.mp4");
+    bool is_added_played = false;
+    for (int i = 2; i < SHUFFLE_FILE_NUM + 1; i++) {
+        const char *name = peek_and_next(playlist);
+        is_added_played |= (name != NULL) && (strcmp(name, "8.mp4") == 0);
+    }
+    TEST_CHECK(is_added_played, "Shuffle: a file added in the round is not played in it");
+
+    // Without the shuffle the files follow the current one in the order they were added
+    uint32_t position = 0;
+    const char *current = NULL;
+    app_playlist_get_current(playlist, &position, &current);
+    int current_file = atoi(get_name(current));
+    TEST_CHECK(app_playlist_set_shuffle(playlist, false) == ESP_OK, "Set shuffle failed");
+    for (int i = 1; i <= SHUFFLE_FILE_NUM + 1; i++) {
+        const char *name = peek_and_next(playlist);
+        int file = (name != NULL) ? atoi(name) : -1;
+        TEST_CHECK(file == (current_file + i) % (SHUFFLE_FILE_NUM + 1), "Unshuffled: %d after %d, step %d", file,
+                   current_file, i);
+    }
+    app_playlist_destroy(playlist);
+
+    // Shuffled without loop, the playlist ends after one round
+    playlist = create_playlist(NULL, true, APP_PLAYLIST_LOOP_NONE);
+    for (int i = 0; i < SHUFFLE_FILE_NUM; i++) {
+        snprintf(path, sizeof(path), "/sdcard/%d.mp4", i);
+        app_playlist_add(playlist, path);
+    }
+    int played_num = 0;
+    while (peek_and_next(playlist) != NULL) {
+        played_num++;
+    }
+    TEST_CHECK(played_num == SHUFFLE_FILE_NUM, "Shuffle without loop: %d files played", played_num);
+    app_playlist_destroy(playlist);
+}
+
+static void test_save_and_resume(void)
+{
+    char m3u_path[PATH_MAX_LEN];
+    make_card_path(m3u_path, "playlist.m3u");
+
+    // Saved in the middle of the playlist
+    app_playlist_handle_t playlist = open_card_playlist(false, APP_PLAYLIST_LOOP_ALL);
+    check_play(playlist, "Before save", "c.mp4 a.mp4 b.MP4");
+    TEST_CHECK(app_playlist_save(playlist) == ESP_OK, "Save failed");
+    app_playlist_destroy(playlist);
+
+    // The files of the card are written relative to the M3U file, all of them, and the current one first
+    FILE *file = fopen(m3u_path, "r");
+    char content[PATH_MAX_LEN * 2] = "";
+    size_t size = (file != NULL) ? fread(content, 1, sizeof(content) - 1, file) : 0;
+    content[size] = '\0';
+    if (file != NULL) {
+        fclose(file);
+    }
+    const char *expected = "#EXTM3U\n#CURRENT:b.MP4\nc.mp4\na.mp4\nb.MP4\n0.mp4\nd.mp4\ne.Mp4\n";
+    TEST_CHECK(strcmp(content, expected) == 0, "Saved \"%s\", expected \"%s\"", content, expected);
+    struct stat file_stat;
+    make_card_path(m3u_path, "playlist.m3u.tmp");
+    TEST_CHECK(stat(m3u_path, &file_stat) != 0, "The temporary file is left");
+
+    // The playback resumes at the current file, in order and shuffled
+    playlist = open_card_playlist(false, APP_PLAYLIST_LOOP_NONE);
+    check_play(playlist, "Resume", "b.MP4 0.mp4 d.mp4 e.Mp4 .");
+    app_playlist_destroy(playlist);
+
+    // The files copied to the card since the save are shuffled in after the resumed one, whatever the draw
+    write_card_file("f.mp4", "");
+    write_card_file("g.mp4", "");
+    for (int i = 0; i < SHUFFLED_RESUME_NUM; i++) {
+        playlist = open_card_playlist(true, APP_PLAYLIST_LOOP_NONE);
+        const char *name = peek_and_next(playlist);
+        TEST_CHECK((name != NULL) && (strcmp(name, "b.MP4") == 0), "Shuffled resume %d at %s", i,
+                   name ? name : "nothing");
+        int played_num = 1;
+        while (peek_and_next(playlist) != NULL) {
+            played_num++;
+        }
+        TEST_CHECK(played_num == 8, "Shuffled resume %d: %d files played, expected 8", i, played_num);
+        app_playlist_destroy(playlist);
+    }
+
+    // A resumed file which was removed from the card starts the playlist from the first file
+    remove_card_file("b.MP4");
+    playlist = open_card_playlist(false, APP_PLAYLIST_LOOP_NONE);
+    check_play(playlist, "Resume removed", "c.mp4 a.mp4 0.mp4 d.mp4 e.Mp4 f.mp4 g.mp4 .");
+    app_playlist_destroy(playlist);
+    remove_card_file("f.mp4");
+    remove_card_file("g.mp4");
+
+    // A playlist in memory is not saved
+    playlist = create_playlist(NULL, false, APP_PLAYLIST_LOOP_NONE);
+    TEST_CHECK(app_playlist_save(playlist) == ESP_ERR_INVALID_STATE, "A playlist without M3U file is saved");
+    app_playlist_destroy(playlist);
+}
+
+int main(int argc, char **argv)
+{
+    bool quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The missing files and directories are expected
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    if (mkdtemp(card_dir) == NULL) {
+        printf("Failed to create the card directory\n");
+        return EXIT_FAILURE;
+    }
+    // Created out of the order of their names, as FAT lists them by creation
+    const char *names[] = {"e.Mp4", "c.mp4", "a.mp4", "d.mp4", "b.MP4", "0.mp4", "notes.txt", ".mp4"};
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        write_card_file(names[i], "");
+    }
+    char path[PATH_MAX_LEN];
+    make_card_path(path, "dir.mp4");
+    mkdir(path, 0700);
+
+    // The shuffle draws from `esp_random()`, which follows `random()` on the host
+    srandom(1);
+    test_load_and_scan();
+    test_loop_modes();
+    test_shuffle(quick ? 2000 : 50000);
+    test_save_and_resume();
+
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        remove_card_file(names[i]);
+    }
+    remove_card_file("playlist.m3u");
+    rmdir(path);
+    rmdir(card_dir);
+
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+
+    return EXIT_SUCCESS;
+}
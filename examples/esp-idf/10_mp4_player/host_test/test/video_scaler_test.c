@@ -0,0 +1,734 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+/**
+ * Test of the video scaler. It places videos of many sizes on displays of several sizes, in each mode and rotation, in
+ * software and on the PPA modelled by `ppa_stub.c`, and checks the geometry of each layout. Then it scales frames whose
+ * pixels hold their coordinates, and checks where each pixel of the display comes from and that the bars are black. A
+ * gradient checks the bilinear filter, and a failing PPA the fallback to software.
+ *
+ * Usage: mp4_host_video_scaler_test [--quick]
+ */
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "ppa_host.h"
+#include "app_video_scaler.h"
+
+#define HW_SCALE_STEPS      (16)        /*!< The PPA scales by steps of 1/16 */
+#define HW_SCALE_MAX        (256 * HW_SCALE_STEPS)
+
+static int failure_num = 0;
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+} frame_size_t;
+
+/* Usual video sizes, the size of a display, a portrait video, odd sizes and sizes out of the range of the PPA */
+static const frame_size_t video_sizes[] = {
+    {1280, 720}, {1920, 1080}, {640, 480}, {320, 240}, {176, 144}, {1024, 600}, {600, 1024}, {333, 197},
+    {2, 2}, {8000, 16}, {17, 1000},
+};
+
+static const char *mode_names[] = {"fit", "fill", "letterbox"};
+
+static bool is_quarter_turn(app_video_rotation_t rotation)
+{
+    return (rotation == APP_VIDEO_ROTATE_90) || (rotation == APP_VIDEO_ROTATE_270);
+}
+
+/**
+ * @brief Scale of the PPA for a video, in steps of 1/16, out of its range if 0 or HW_SCALE_MAX and above
+ */
+static uint32_t get_hw_scale(const app_video_scaler_config_t *config, uint32_t rot_width, uint32_t rot_height)
+{
+    uint32_t scale_x = config->dst_width * HW_SCALE_STEPS / rot_width;
+    uint32_t scale_y = config->dst_height * HW_SCALE_STEPS / rot_height;
+    uint32_t fit = (scale_x < scale_y) ? scale_x : scale_y;
+    if (config->mode == APP_VIDEO_SCALE_FILL) {
+        scale_x = (config->dst_width * HW_SCALE_STEPS + rot_width - 1) / rot_width;
+        scale_y = (config->dst_height * HW_SCALE_STEPS + rot_height - 1) / rot_height;
+        return (scale_x > scale_y) ? scale_x : scale_y;
+    }
+    if ((config->mode == APP_VIDEO_SCALE_LETTERBOX) && (fit > HW_SCALE_STEPS)) {
+        return HW_SCALE_STEPS;
+    }
+    return fit;
+}
+
+static void check_layout(const app_video_scaler_config_t *config, uint32_t src_width, uint32_t src_height,
+                         const app_video_layout_t *layout, const char *name)
+{
+    const app_video_rect_t *src = &layout->src;
+    const app_video_rect_t *dst = &layout->dst;
+    uint32_t dst_width = config->dst_width;
+    uint32_t dst_height = config->dst_height;
+    bool quarter = is_quarter_turn(config->rotation);
+    uint32_t rot_width = quarter ? src_height : src_width;
+    uint32_t rot_height = quarter ? src_width : src_height;
+    uint32_t crop_width = quarter ? src->height : src->width;
+    uint32_t crop_height = quarter ? src->width : src->height;
+
+    // Within the source and the display, and centered
+    TEST_CHECK((src->width > 0) && (src->height > 0) && (src->x + src->width <= src_width) &&
+               (src->y + src->height <= src_height) && (src->x == (src_width - src->width) / 2) &&
+               (src->y == (src_height - src->height) / 2), "%s: crop %" PRIu32 "x%" PRIu32 " at (%" PRIu32 ",%"
+               PRIu32 ")", name, src->width, src->height, src->x, src->y);
+    TEST_CHECK((dst->width > 0) && (dst->height > 0) && (dst->x + dst->width <= dst_width) &&
+               (dst->y + dst->height <= dst_height) && (dst->x == (dst_width - dst->width) / 2) &&
+               (dst->y == (dst_height - dst->height) / 2), "%s: video %" PRIu32 "x%" PRIu32 " at (%" PRIu32 ",%"
+               PRIu32 ")", name, dst->width, dst->height, dst->x, dst->y);
+
+    uint32_t hw_scale = get_hw_scale(config, rot_width, rot_height);
+    // The PPA outputs a pixel at least
+    bool hw = config->use_hw && (hw_scale > 0) && (hw_scale < HW_SCALE_MAX) &&
+              (rot_width * hw_scale / HW_SCALE_STEPS > 0) && (rot_height * hw_scale / HW_SCALE_STEPS > 0);
+    TEST_CHECK(layout->hw == hw, "%s: %s, scale %" PRIu32 "/16", name, layout->hw ? "PPA" : "software", hw_scale);
+    bool fits = (rot_width <= dst_width) && (rot_height <= dst_height);
+    bool is_full = (config->mode == APP_VIDEO_SCALE_FIT) || (config->mode == APP_VIDEO_SCALE_LETTERBOX);
+    if (is_full) {
+        TEST_CHECK((src->width == src_width) && (src->height == src_height), "%s: cropped to %" PRIu32 "x%" PRIu32,
+                   name, src->width, src->height);
+    } else if (!layout->hw) {
+        // The scale of the PPA is rounded up, it may crop both sides
+        TEST_CHECK((crop_width == rot_width) || (crop_height == rot_height), "%s: cropped on both sides to %" PRIu32
+                   "x%" PRIu32, name, src->width, src->height);
+    }
+
+    if (layout->hw) {
+        // The PPA outputs the crop times the scale, rounded down
+        uint32_t out_width = crop_width * hw_scale / HW_SCALE_STEPS;
+        uint32_t out_height = crop_height * hw_scale / HW_SCALE_STEPS;
+        TEST_CHECK((dst->width == out_width) && (dst->height == out_height), "%s: video %" PRIu32 "x%" PRIu32
+                   " for a PPA output of %" PRIu32 "x%" PRIu32, name, dst->width, dst->height, out_width, out_height);
+        if (config->mode == APP_VIDEO_SCALE_FILL) {
+            uint32_t gap = (hw_scale + HW_SCALE_STEPS - 1) / HW_SCALE_STEPS;
+            TEST_CHECK((dst->width + gap >= dst_width) && (dst->height + gap >= dst_height), "%s: video %" PRIu32 "x%"
+                       PRIu32 " does not fill the display", name, dst->width, dst->height);
+        }
+        return;
+    }
+
+    if ((config->mode == APP_VIDEO_SCALE_LETTERBOX) && fits) {
+        TEST_CHECK((dst->width == rot_width) && (dst->height == rot_height), "%s: native size shown as %" PRIu32 "x%"
+                   PRIu32, name, dst->width, dst->height);
+    } else if (is_full) {
+        // The aspect ratio is kept to a pixel, and the video touches two sides
+        uint64_t error = llabs((int64_t)dst->width * rot_height - (int64_t)dst->height * rot_width);
+        TEST_CHECK(error <= ((rot_width > rot_height) ? rot_width : rot_height), "%s: video %" PRIu32 "x%" PRIu32
+                   " for %" PRIu32 "x%" PRIu32, name, dst->width, dst->height, rot_width, rot_height);
+        TEST_CHECK((dst->width == dst_width) || (dst->height == dst_height), "%s: video %" PRIu32 "x%" PRIu32
+                   " touches no side", name, dst->width, dst->height);
+    } else {
+        TEST_CHECK((dst->width == dst_width) && (dst->height == dst_height), "%s: video %" PRIu32 "x%" PRIu32
+                   " does not fill the display", name, dst->width, dst->height);
+        uint64_t error = llabs((int64_t)crop_width * dst_height - (int64_t)crop_height * dst_width);
+        TEST_CHECK(error <= ((dst_width > dst_height) ? dst_width : dst_height), "%s: crop %" PRIu32 "x%" PRIu32
+                   " for %" PRIu32 "x%" PRIu32, name, crop_width, crop_height, dst_width, dst_height);
+    }
+}
+
+/**
+ * @brief Fill a frame whose pixels hold their coordinates, modulo 4096 in RGB888 and 256 in RGB565
+ */
+static void fill_coordinates(uint8_t *frame, uint32_t width, uint32_t height, uint32_t bpp)
+{
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            uint8_t *pixel = frame + (y * width + x) * bpp;
+            if (bpp == 2) {
+                uint16_t value = ((y & 0xFF) << 8) | (x & 0xFF);
+                memcpy(pixel, &value, sizeof(value));
+            } else {
+                uint32_t value = ((y & 0xFFF) << 12) | (x & 0xFFF);
+                pixel[0] = value & 0xFF;
+                pixel[1] = (value >> 8) & 0xFF;
+                pixel[2] = value >> 16;
+            }
+        }
+    }
+}
+
+static void get_coordinates(const uint8_t *pixel, uint32_t bpp, uint32_t *x, uint32_t *y)
+{
+    if (bpp == 2) {
+        uint16_t value;
+        memcpy(&value, pixel, sizeof(value));
+        *x = value & 0xFF;
+        *y = value >> 8;
+        return;
+    }
+    uint32_t value = pixel[0] | (pixel[1] << 8) | (pixel[2] << 16);
+    *x = value & 0xFFF;
+    *y = value >> 12;
+}
+
+static float get_distance(uint32_t coord, float expected, uint32_t modulo)
+{
+    float diff = fmodf((float)coord - expected, (float)modulo);
+    if (diff > modulo / 2.0f) {
+        diff -= modulo;
+    } else if (diff < -(modulo / 2.0f)) {
+        diff += modulo;
+    }
+    return fabsf(diff);
+}
+
+static float clamp_coord(float coord, uint32_t size)
+{
+    return (coord < 0) ? 0 : (coord > size - 1) ? (float)(size - 1) : coord;
+}
+
+/**
+ * @brief Position in the source of a pixel of the display, from the center of the display pixel
+ *
+ * @param step_u Pixels of the rotated crop per display pixel, horizontally
+ * @param step_v Pixels of the rotated crop per display pixel, vertically
+ */
+static void get_source_position(const app_video_scaler_config_t *config, const app_video_layout_t *layout,
+                                float step_u, float step_v, uint32_t u, uint32_t v, float *x, float *y)
+{
+    const app_video_rect_t *src = &layout->src;
+    bool quarter = is_quarter_turn(config->rotation);
+    uint32_t rot_width = quarter ? src->height : src->width;
+    uint32_t rot_height = quarter ? src->width : src->height;
+    float rot_u = clamp_coord((u - layout->dst.x + 0.5f) * step_u - 0.5f, rot_width);
+    float rot_v = clamp_coord((v - layout->dst.y + 0.5f) * step_v - 0.5f, rot_height);
+
+    // Counter-clockwise
+    switch (config->rotation) {
+    case APP_VIDEO_ROTATE_90:
+        *x = src->width - 1 - rot_v;
+        *y = rot_u;
+        break;
+    case APP_VIDEO_ROTATE_180:
+        *x = src->width - 1 - rot_u;
+        *y = src->height - 1 - rot_v;
+        break;
+    case APP_VIDEO_ROTATE_270:
+        *x = rot_v;
+        *y = src->height - 1 - rot_u;
+        break;
+    default:
+        *x = rot_u;
+        *y = rot_v;
+        break;
+    }
+    *x += src->x;
+    *y += src->y;
+}
+
+/**
+ * @brief Pixels of the rotated crop per display pixel, the PPA scales by its step and the software maps the crop to the
+ *        video
+ */
+static void get_steps(const app_video_scaler_config_t *config, const app_video_layout_t *layout, float hw_scale,
+                      float *step_u, float *step_v)
+{
+    if (hw_scale > 0) {
+        *step_u = 1.0f / hw_scale;
+        *step_v = 1.0f / hw_scale;
+        return;
+    }
+    bool quarter = is_quarter_turn(config->rotation);
+    *step_u = (float)(quarter ? layout->src.height : layout->src.width) / layout->dst.width;
+    *step_v = (float)(quarter ? layout->src.width : layout->src.height) / layout->dst.height;
+}
+
+static bool is_black(const uint8_t *pixel, uint32_t bpp)
+{
+    for (uint32_t i = 0; i < bpp; i++) {
+        if (pixel[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Check where each pixel of the display comes from, and that the bars are black
+ *
+ * @param hw_scale Scale of the PPA, 0 for the software scaler which maps the crop to the video
+ * @param tolerance Distance allowed to the expected source pixel
+ */
+static void check_coordinates(const app_video_scaler_config_t *config, const app_video_layout_t *layout,
+                              float hw_scale, float tolerance, const uint8_t *dst, const char *name)
+{
+    uint32_t bpp = (config->pixel_format == APP_VIDEO_PIXEL_RGB888) ? 3 : 2;
+    uint32_t modulo = (bpp == 2) ? 256 : 4096;
+    const app_video_rect_t *video = &layout->dst;
+    float step_u = 0;
+    float step_v = 0;
+    get_steps(config, layout, hw_scale, &step_u, &step_v);
+
+    for (uint32_t v = 0; v < config->dst_height; v++) {
+        for (uint32_t u = 0; u < config->dst_width; u++) {
+            const uint8_t *pixel = dst + (v * config->dst_width + u) * bpp;
+            bool is_video = (u >= video->x) && (u < video->x + video->width) && (v >= video->y) &&
+                            (v < video->y + video->height);
+            if (!is_video) {
+                if (!is_black(pixel, bpp)) {
+                    TEST_CHECK(false, "%s: bar at (%" PRIu32 ",%" PRIu32 ") not cleared", name, u, v);
+                    return;
+                }
+                continue;
+            }
+
+            float expected_x;
+            float expected_y;
+            get_source_position(config, layout, step_u, step_v, u, v, &expected_x, &expected_y);
+            uint32_t x;
+            uint32_t y;
+            get_coordinates(pixel, bpp, &x, &y);
+            if ((get_distance(x, expected_x, modulo) > tolerance) || (get_distance(y, expected_y, modulo) > tolerance)) {
+                TEST_CHECK(false, "%s: pixel (%" PRIu32 ",%" PRIu32 ") from (%" PRIu32 ",%" PRIu32 "), not (%.1f,%.1f)"
+                           " modulo %" PRIu32, name, u, v, x, y, expected_x, expected_y, modulo);
+                return;
+            }
+        }
+    }
+}
+
+static void get_name(char *name, size_t size, const app_video_scaler_config_t *config, uint32_t src_width,
+                     uint32_t src_height)
+{
+    snprintf(name, size, "%" PRIu32 "x%" PRIu32 " on %" PRIu32 "x%" PRIu32 " %s %d deg %s %s%s", src_width,
+             src_height, config->dst_width, config->dst_height, mode_names[config->mode], config->rotation * 90,
+             (config->pixel_format == APP_VIDEO_PIXEL_RGB888) ? "RGB888" : "RGB565",
+             (config->filter == APP_VIDEO_FILTER_BILINEAR) ? "bilinear" : "nearest", config->use_hw ? " PPA" : "");
+}
+
+static void test_invalid_args(void)
+{
+    app_video_scaler_config_t config = APP_VIDEO_SCALER_CONFIG_DEFAULT(320, 240);
+    app_video_scaler_handle_t scaler = NULL;
+    app_video_layout_t layout;
+    uint16_t frame[4] = {0};
+
+    TEST_CHECK(app_video_scaler_create(NULL, &scaler) == ESP_ERR_INVALID_ARG, "Create without a configuration");
+    TEST_CHECK(app_video_scaler_create(&config, NULL) == ESP_ERR_INVALID_ARG, "Create without a handle");
+    config.dst_width = 0;
+    TEST_CHECK(app_video_scaler_create(&config, &scaler) == ESP_ERR_INVALID_ARG, "Create without a display width");
+    config.dst_width = 320;
+    TEST_CHECK(app_video_scaler_create(&config, &scaler) == ESP_OK, "Create failed");
+
+    TEST_CHECK(app_video_scaler_get_layout(scaler, 0, 240, &layout) == ESP_ERR_INVALID_ARG, "Layout of no width");
+    TEST_CHECK(app_video_scaler_get_layout(scaler, 320, 240, NULL) == ESP_ERR_INVALID_ARG, "Layout without output");
+    TEST_CHECK(app_video_scaler_process(scaler, NULL, 2, 2, frame, sizeof(frame)) == ESP_ERR_INVALID_ARG,
+               "Process without a source");
+    TEST_CHECK(app_video_scaler_process(scaler, frame, 2, 2, frame, sizeof(frame)) == ESP_ERR_INVALID_SIZE,
+               "Process into a buffer too small");
+    TEST_CHECK(app_video_scaler_get_stats(scaler, NULL) == ESP_ERR_INVALID_ARG, "Stats without output");
+
+    // Any mode shows a video of the display size as is, but not rotated
+    TEST_CHECK(app_video_scaler_is_identity(scaler, 320, 240), "320x240 on 320x240 is not the identity");
+    TEST_CHECK(!app_video_scaler_is_identity(scaler, 240, 320), "240x320 on 320x240 is the identity");
+    TEST_CHECK(!app_video_scaler_is_identity(scaler, 640, 480), "640x480 on 320x240 is the identity");
+    TEST_CHECK(!app_video_scaler_is_identity(NULL, 320, 240), "Identity without a scaler");
+    app_video_scaler_destroy(scaler);
+
+    config.mode = APP_VIDEO_SCALE_FILL;
+    config.rotation = APP_VIDEO_ROTATE_180;
+    TEST_CHECK(app_video_scaler_create(&config, &scaler) == ESP_OK, "Create failed");
+    TEST_CHECK(!app_video_scaler_is_identity(scaler, 320, 240), "Rotated 320x240 on 320x240 is the identity");
+    app_video_scaler_destroy(scaler);
+    TEST_CHECK(app_video_scaler_destroy(NULL) == ESP_ERR_INVALID_ARG, "Destroy without a scaler");
+}
+
+static void test_layouts(uint32_t random_num)
+{
+    static const frame_size_t displays[] = { {1024, 600}, {480, 800}, {320, 240}, {720, 720} };
+    uint32_t seed = 1;
+    uint32_t layout_num = 0;
+    char name[128];
+
+    for (size_t d = 0; d < sizeof(displays) / sizeof(displays[0]); d++) {
+        for (int mode = APP_VIDEO_SCALE_FIT; mode <= APP_VIDEO_SCALE_LETTERBOX; mode++) {
+            for (int rotation = APP_VIDEO_ROTATE_0; rotation <= APP_VIDEO_ROTATE_270; rotation++) {
+                for (int hw = 0; hw < 2; hw++) {
+                    app_video_scaler_config_t config = APP_VIDEO_SCALER_CONFIG_DEFAULT(displays[d].width,
+                                                                                       displays[d].height);
+                    config.mode = mode;
+                    config.rotation = rotation;
+                    config.use_hw = hw;
+                    app_video_scaler_handle_t scaler = NULL;
+                    TEST_CHECK(app_video_scaler_create(&config, &scaler) == ESP_OK, "Create failed");
+                    if (scaler == NULL) {
+                        continue;
+                    }
+
+                    size_t size_num = sizeof(video_sizes) / sizeof(video_sizes[0]);
+                    for (uint32_t i = 0; i < size_num + random_num; i++) {
+                        frame_size_t size = (i < size_num) ? video_sizes[i] : (frame_size_t) {
+                            1 + rand_r(&seed) % 2000, 1 + rand_r(&seed) % 2000
+                        };
+                        app_video_layout_t layout;
+                        get_name(name, sizeof(name), &config, size.width, size.height);
+                        TEST_CHECK(app_video_scaler_get_layout(scaler, size.width, size.height, &layout) == ESP_OK,
+                                   "%s: no layout", name);
+                        check_layout(&config, size.width, size.height, &layout, name);
+                        layout_num++;
+                    }
+                    app_video_scaler_destroy(scaler);
+                }
+            }
+        }
+    }
+    printf("Layouts: %" PRIu32 " checked\n", layout_num);
+}
+
+/**
+ * @brief Scale a frame of each video size, and check where each pixel of the display comes from
+ */
+static void test_coordinates(const frame_size_t *displays, size_t display_num)
+{
+    static const size_t max_video = sizeof(video_sizes) / sizeof(video_sizes[0]);
+    uint32_t frame_num = 0;
+    char name[128];
+
+    uint8_t *src = malloc(1920 * 1080 * 3);
+    uint8_t *dst = malloc(1024 * 800 * 3);
+    TEST_CHECK((src != NULL) && (dst != NULL), "No memory for the frames");
+    if ((src == NULL) || (dst == NULL)) {
+        free(src);
+        free(dst);
+        return;
+    }
+
+    for (size_t d = 0; d < display_num; d++) {
+        for (int format = APP_VIDEO_PIXEL_RGB565; format <= APP_VIDEO_PIXEL_RGB888; format++) {
+            uint32_t bpp = (format == APP_VIDEO_PIXEL_RGB888) ? 3 : 2;
+            uint32_t dst_size = displays[d].width * displays[d].height * bpp;
+            for (size_t i = 0; i < max_video; i++) {
+                fill_coordinates(src, video_sizes[i].width, video_sizes[i].height, bpp);
+                for (int mode = APP_VIDEO_SCALE_FIT; mode <= APP_VIDEO_SCALE_LETTERBOX; mode++) {
+                    for (int rotation = APP_VIDEO_ROTATE_0; rotation <= APP_VIDEO_ROTATE_270; rotation++) {
+                        for (int hw = 0; hw < 2; hw++) {
+                            app_video_scaler_config_t config = APP_VIDEO_SCALER_CONFIG_DEFAULT(displays[d].width,
+                                                                                               displays[d].height);
+                            config.pixel_format = format;
+                            config.mode = mode;
+                            config.rotation = rotation;
+                            config.filter = APP_VIDEO_FILTER_NEAREST;
+                            config.use_hw = hw;
+                            app_video_scaler_handle_t scaler = NULL;
+                            TEST_CHECK(app_video_scaler_create(&config, &scaler) == ESP_OK, "Create failed");
+                            if (scaler == NULL) {
+                                continue;
+                            }
+
+                            get_name(name, sizeof(name), &config, video_sizes[i].width, video_sizes[i].height);
+                            memset(dst, 0xA5, dst_size);
+                            TEST_CHECK(app_video_scaler_process(scaler, src, video_sizes[i].width,
+                                                                video_sizes[i].height, dst, dst_size) == ESP_OK,
+                                       "%s: process failed", name);
+                            app_video_layout_t layout;
+                            app_video_scaler_get_layout(scaler, video_sizes[i].width, video_sizes[i].height, &layout);
+                            app_video_scaler_stats_t stats;
+                            app_video_scaler_get_stats(scaler, &stats);
+                            TEST_CHECK((stats.hw == layout.hw) && (stats.frames == 1) && (stats.hw_failures == 0),
+                                       "%s: %s, %" PRIu32 " frames, %" PRIu32 " failures", name,
+                                       stats.hw ? "PPA" : "software", stats.frames, stats.hw_failures);
+
+                            ppa_host_usage_t usage;
+                            ppa_host_get_usage(&usage);
+                            check_coordinates(&config, &layout, layout.hw ? usage.last_scale : 0, 1.0f, dst, name);
+                            app_video_scaler_destroy(scaler);
+                            frame_num++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    free(src);
+    free(dst);
+
+    ppa_host_usage_t usage;
+    ppa_host_get_usage(&usage);
+    printf("Coordinates: %" PRIu32 " frames checked, %" PRIu32 " on the PPA\n", frame_num, usage.srm_num);
+    TEST_CHECK(usage.rejected_num == 0, "%" PRIu32 " operations rejected by the PPA", usage.rejected_num);
+    TEST_CHECK(usage.clients == 0, "%" PRIu32 " PPA clients left", usage.clients);
+}
+
+/**
+ * @brief At the native size, any rotation and filter is an exact copy of the source pixels
+ */
+static void test_native_rotations(void)
+{
+    static const frame_size_t size = {333, 197};
+    uint8_t *src = malloc(size.width * size.height * 3);
+    uint8_t *dst = malloc(size.width * size.height * 3);
+    char name[128];
+    if ((src == NULL) || (dst == NULL)) {
+        TEST_CHECK(false, "No memory for the frames");
+        free(src);
+        free(dst);
+        return;
+    }
+
+    for (int format = APP_VIDEO_PIXEL_RGB565; format <= APP_VIDEO_PIXEL_RGB888; format++) {
+        uint32_t bpp = (format == APP_VIDEO_PIXEL_RGB888) ? 3 : 2;
+        fill_coordinates(src, size.width, size.height, bpp);
+        for (int rotation = APP_VIDEO_ROTATE_0; rotation <= APP_VIDEO_ROTATE_270; rotation++) {
+            for (int filter = APP_VIDEO_FILTER_NEAREST; filter <= APP_VIDEO_FILTER_BILINEAR; filter++) {
+                bool quarter = is_quarter_turn(rotation);
+                app_video_scaler_config_t config = APP_VIDEO_SCALER_CONFIG_DEFAULT(
+                                                       quarter ? size.height : size.width, quarter ? size.width : size.height);
+                config.pixel_format = format;
+                config.rotation = rotation;
+                config.filter = filter;
+                config.use_hw = false;
+                app_video_scaler_handle_t scaler = NULL;
+                TEST_CHECK(app_video_scaler_create(&config, &scaler) == ESP_OK, "Create failed");
+                if (scaler == NULL) {
+                    continue;
+                }
+
+                get_name(name, sizeof(name), &config, size.width, size.height);
+                memset(dst, 0xA5, size.width * size.height * bpp);
+                app_video_scaler_process(scaler, src, size.width, size.height, dst, size.width * size.height * bpp);
+                app_video_layout_t layout;
+                app_video_scaler_get_layout(scaler, size.width, size.height, &layout);
+                check_coordinates(&config, &layout, 0, 0.0f, dst, name);
+                app_video_scaler_destroy(scaler);
+            }
+        }
+    }
+    free(src);
+    free(dst);
+}
+
+/**
+ * @brief The bilinear filter of a gradient is the gradient at the position of each pixel
+ */
+static void test_bilinear(void)
+{
+    static const frame_size_t displays[] = { {320, 240}, {480, 800} };
+    static const frame_size_t sizes[] = { {1280, 720}, {176, 144}, {333, 197}, {2, 2} };
+    uint8_t *src = malloc(1280 * 720 * 3);
+    uint8_t *dst = malloc(480 * 800 * 3);
+    char name[128];
+    if ((src == NULL) || (dst == NULL)) {
+        TEST_CHECK(false, "No memory for the frames");
+        free(src);
+        free(dst);
+        return;
+    }
+
+    for (size_t d = 0; d < sizeof(displays) / sizeof(displays[0]); d++) {
+        for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            for (int format = APP_VIDEO_PIXEL_RGB565; format <= APP_VIDEO_PIXEL_RGB888; format++) {
+                // Red goes up from left to right and green from top to bottom, blue is constant
+                uint32_t bpp = (format == APP_VIDEO_PIXEL_RGB888) ? 3 : 2;
+                float max_r = (bpp == 2) ? 31 : 255;
+                float max_g = (bpp == 2) ? 63 : 255;
+                uint32_t blue = (bpp == 2) ? 0x15 : 0x5A;
+                float scale_r = max_r / (sizes[i].width - 1);
+                float scale_g = max_g / (sizes[i].height - 1);
+                for (uint32_t y = 0; y < sizes[i].height; y++) {
+                    for (uint32_t x = 0; x < sizes[i].width; x++) {
+                        uint32_t r = lroundf(x * scale_r);
+                        uint32_t g = lroundf(y * scale_g);
+                        uint8_t *pixel = src + (y * sizes[i].width + x) * bpp;
+                        if (bpp == 2) {
+                            uint16_t value = (r << 11) | (g << 5) | blue;
+                            memcpy(pixel, &value, sizeof(value));
+                        } else {
+                            pixel[0] = blue;
+                            pixel[1] = g;
+                            pixel[2] = r;
+                        }
+                    }
+                }
+
+                for (int rotation = APP_VIDEO_ROTATE_0; rotation <= APP_VIDEO_ROTATE_270; rotation++) {
+                    app_video_scaler_config_t config = APP_VIDEO_SCALER_CONFIG_DEFAULT(displays[d].width,
+                                                                                       displays[d].height);
+                    config.pixel_format = format;
+                    config.mode = APP_VIDEO_SCALE_FILL;
+                    config.rotation = rotation;
+                    config.use_hw = false;
+                    app_video_scaler_handle_t scaler = NULL;
+                    TEST_CHECK(app_video_scaler_create(&config, &scaler) == ESP_OK, "Create failed");
+                    if (scaler == NULL) {
+                        continue;
+                    }
+
+                    get_name(name, sizeof(name), &config, sizes[i].width, sizes[i].height);
+                    uint32_t dst_size = displays[d].width * displays[d].height * bpp;
+                    app_video_scaler_process(scaler, src, sizes[i].width, sizes[i].height, dst, dst_size);
+                    app_video_layout_t layout;
+                    app_video_scaler_get_layout(scaler, sizes[i].width, sizes[i].height, &layout);
+                    float step_u = 0;
+                    float step_v = 0;
+                    get_steps(&config, &layout, 0, &step_u, &step_v);
+
+                    float error_max = 0;
+                    for (uint32_t v = layout.dst.y; v < layout.dst.y + layout.dst.height; v++) {
+                        for (uint32_t u = layout.dst.x; u < layout.dst.x + layout.dst.width; u++) {
+                            float x;
+                            float y;
+                            get_source_position(&config, &layout, step_u, step_v, u, v, &x, &y);
+                            const uint8_t *pixel = dst + (v * displays[d].width + u) * bpp;
+                            uint32_t r = pixel[2];
+                            uint32_t g = pixel[1];
+                            uint32_t b = pixel[0];
+                            if (bpp == 2) {
+                                uint16_t value;
+                                memcpy(&value, pixel, sizeof(value));
+                                r = value >> 11;
+                                g = (value >> 5) & 0x3F;
+                                b = value & 0x1F;
+                            }
+                            float error = fmaxf(fabsf(r - x * scale_r), fabsf(g - y * scale_g));
+                            error_max = fmaxf(error_max, (b == blue) ? error : INFINITY);
+                        }
+                    }
+                    // The weights have 5 bits in RGB565 and 8 bits in RGB888
+                    float tolerance = 2.0f + 2.0f * fmaxf(scale_r, scale_g) / ((bpp == 2) ? 32 : 256);
+                    TEST_CHECK(error_max <= tolerance, "%s: gradient off by %.2f", name, error_max);
+                    app_video_scaler_destroy(scaler);
+                }
+            }
+        }
+    }
+    free(src);
+    free(dst);
+}
+
+static void test_ppa_failures(void)
+{
+    app_video_scaler_config_t config = APP_VIDEO_SCALER_CONFIG_DEFAULT(320, 240);
+    static const frame_size_t size = {640, 480};
+    uint16_t *src = malloc(size.width * size.height * 2);
+    uint16_t *dst = malloc(config.dst_width * config.dst_height * 2);
+    uint32_t dst_size = config.dst_width * config.dst_height * 2;
+    if ((src == NULL) || (dst == NULL)) {
+        TEST_CHECK(false, "No memory for the frames");
+        free(src);
+        free(dst);
+        return;
+    }
+    fill_coordinates((uint8_t *)src, size.width, size.height, 2);
+    config.filter = APP_VIDEO_FILTER_NEAREST;
+
+    // The PPA is used by others, the frames are scaled in software
+    app_video_scaler_handle_t scaler = NULL;
+    app_video_layout_t layout;
+    ppa_host_set_register_failure(true);
+    TEST_CHECK(app_video_scaler_create(&config, &scaler) == ESP_OK, "Create without the PPA failed");
+    ppa_host_set_register_failure(false);
+    TEST_CHECK(app_video_scaler_get_layout(scaler, size.width, size.height, &layout) == ESP_OK && !layout.hw,
+               "Layout on the PPA without it");
+    TEST_CHECK(app_video_scaler_process(scaler, src, size.width, size.height, dst, dst_size) == ESP_OK,
+               "Process without the PPA failed");
+    app_video_scaler_destroy(scaler);
+
+    // An operation of the PPA fails, the frame is scaled in software with the layout of the PPA
+    TEST_CHECK(app_video_scaler_create(&config, &scaler) == ESP_OK, "Create failed");
+    ppa_host_set_srm_failures(1);
+    memset(dst, 0xA5, dst_size);
+    TEST_CHECK(app_video_scaler_process(scaler, src, size.width, size.height, dst, dst_size) == ESP_OK,
+               "Process with the PPA failing failed");
+    app_video_scaler_stats_t stats;
+    app_video_scaler_get_stats(scaler, &stats);
+    TEST_CHECK(!stats.hw && (stats.hw_failures == 1), "PPA failure: %s, %" PRIu32 " failures",
+               stats.hw ? "PPA" : "software", stats.hw_failures);
+    app_video_scaler_get_layout(scaler, size.width, size.height, &layout);
+    TEST_CHECK(layout.hw, "Layout not on the PPA");
+    check_coordinates(&config, &layout, 0, 1.0f, (uint8_t *)dst, "PPA failure");
+
+    TEST_CHECK(app_video_scaler_process(scaler, src, size.width, size.height, dst, dst_size) == ESP_OK,
+               "Process after a failure failed");
+    app_video_scaler_get_stats(scaler, &stats);
+    TEST_CHECK(stats.hw && (stats.frames == 2) && (stats.hw_failures == 1), "After a failure: %s, %" PRIu32
+               " frames, %" PRIu32 " failures", stats.hw ? "PPA" : "software", stats.frames, stats.hw_failures);
+    app_video_scaler_destroy(scaler);
+
+    ppa_host_usage_t usage;
+    ppa_host_get_usage(&usage);
+    TEST_CHECK(usage.clients == 0, "%" PRIu32 " PPA clients left", usage.clients);
+    free(src);
+    free(dst);
+}
+
+/**
+ * @brief Time of the software scaler for a 720p video on a 1024x600 display, on the host
+ */
+static void test_speed(uint32_t frame_num)
+{
+    static const frame_size_t size = {1280, 720};
+    uint16_t *src = calloc(size.width * size.height, 2);
+    uint16_t *dst = malloc(1024 * 600 * 2);
+    if ((src == NULL) || (dst == NULL)) {
+        TEST_CHECK(false, "No memory for the frames");
+        free(src);
+        free(dst);
+        return;
+    }
+
+    for (int filter = APP_VIDEO_FILTER_NEAREST; filter <= APP_VIDEO_FILTER_BILINEAR; filter++) {
+        app_video_scaler_config_t config = APP_VIDEO_SCALER_CONFIG_DEFAULT(1024, 600);
+        config.filter = filter;
+        config.use_hw = false;
+        app_video_scaler_handle_t scaler = NULL;
+        TEST_CHECK(app_video_scaler_create(&config, &scaler) == ESP_OK, "Create failed");
+        if (scaler == NULL) {
+            continue;
+        }
+        for (uint32_t i = 0; i < frame_num; i++) {
+            app_video_scaler_process(scaler, src, size.width, size.height, dst, 1024 * 600 * 2);
+        }
+        app_video_scaler_stats_t stats;
+        app_video_scaler_get_stats(scaler, &stats);
+        printf("1280x720 on 1024x600 RGB565 %s: %" PRIu32 " us per frame on average, %" PRIu32 " us at most\n",
+               (filter == APP_VIDEO_FILTER_BILINEAR) ? "bilinear" : "nearest", stats.avg_us, stats.max_us);
+        app_video_scaler_destroy(scaler);
+    }
+    free(src);
+    free(dst);
+}
+
+int main(int argc, char **argv)
+{
+    bool is_quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !is_quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The failures of the PPA are expected
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    static const frame_size_t displays[] = { {320, 240}, {240, 320}, {1024, 600}, {480, 800} };
+    test_invalid_args();
+    test_layouts(is_quick ? 100 : 5000);
+    test_coordinates(displays, is_quick ? 2 : 4);
+    test_native_rotations();
+    test_bilinear();
+    test_ppa_failures();
+    test_speed(is_quick ? 10 : 100);
+
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+
+    return EXIT_SUCCESS;
+}
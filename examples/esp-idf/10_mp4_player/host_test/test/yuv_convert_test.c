@@ -0,0 +1,282 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+/**
+ * Test and benchmark of the YUV to RGB conversion. It converts random pictures of odd and usual sizes and compares each
+ * pixel with BT.601 of the limited range in floating point. The RGB565 output must be the RGB888 one truncated, and the
+ * BGR order the RGB one swapped. A picture converted in bands of rows must match the one converted at once, without a
+ * byte written outside of the rows of the band. Then it reports the time to convert 480p and 720p pictures.
+ *
+ * Usage: mp4_host_yuv_convert_test [--quick]
+ */
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "app_yuv_convert.h"
+
+#define GUARD_BYTE          (0xA5)      /*!< Bytes of the output the conversion must not write */
+
+static int failure_num = 0;
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+} picture_size_t;
+
+/**
+ * @brief I420 picture with its planes in one buffer, of random bytes over the whole range
+ */
+typedef struct {
+    uint8_t *data;
+    app_yuv_picture_t picture;
+} test_picture_t;
+
+static bool create_picture(test_picture_t *test, uint32_t width, uint32_t height, unsigned int *seed)
+{
+    uint32_t uv_stride = (width + 1) / 2;
+    uint32_t y_size = width * height;
+    uint32_t uv_size = uv_stride * ((height + 1) / 2);
+    test->data = malloc(y_size + 2 * uv_size);
+    if (test->data == NULL) {
+        TEST_CHECK(false, "No memory for a %" PRIu32 "x%" PRIu32 " picture", width, height);
+        return false;
+    }
+    for (uint32_t i = 0; i < y_size + 2 * uv_size; i++) {
+        test->data[i] = (uint8_t)rand_r(seed);
+    }
+    test->picture = (app_yuv_picture_t) {
+        .y = test->data,
+        .u = test->data + y_size,
+        .v = test->data + y_size + uv_size,
+        .y_stride = width,
+        .uv_stride = uv_stride,
+        .width = width,
+        .height = height,
+    };
+    return true;
+}
+
+/**
+ * @brief BT.601 of the limited range, rounded and clamped to 8 bits
+ */
+static void get_reference(uint8_t y, uint8_t u, uint8_t v, uint8_t rgb[3])
+{
+    double luma = 1.164383 * (y - 16);
+    double cb = u - 128;
+    double cr = v - 128;
+    double channels[3] = {
+        luma + 1.596027 * cr,
+        luma - 0.391762 * cb - 0.812968 * cr,
+        luma + 2.017232 * cb,
+    };
+    for (int c = 0; c < 3; c++) {
+        double value = round(channels[c]);
+        rgb[c] = (uint8_t)((value < 0) ? 0 : (value > 255) ? 255 : value);
+    }
+}
+
+static void test_accuracy(const picture_size_t *sizes, size_t size_num)
+{
+    unsigned int seed = 1;
+    for (size_t s = 0; s < size_num; s++) {
+        uint32_t width = sizes[s].width;
+        uint32_t height = sizes[s].height;
+        test_picture_t test;
+        if (!create_picture(&test, width, height, &seed)) {
+            continue;
+        }
+        uint8_t *rgb888 = malloc(width * height * 3);
+        uint8_t *bgr888 = malloc(width * height * 3);
+        uint16_t *rgb565 = malloc(width * height * 2);
+        uint16_t *bgr565 = malloc(width * height * 2);
+        if ((rgb888 == NULL) || (bgr888 == NULL) || (rgb565 == NULL) || (bgr565 == NULL)) {
+            TEST_CHECK(false, "No memory for the output");
+            free(rgb888);
+            free(bgr888);
+            free(rgb565);
+            free(bgr565);
+            free(test.data);
+            continue;
+        }
+
+        // In RGB order the red is the first byte of RGB888 and in the low bits of RGB565, in BGR order the blue
+        app_yuv_convert_rows(&test.picture, 0, height, APP_VIDEO_PIXEL_RGB888, false, rgb888, width * 3);
+        app_yuv_convert_rows(&test.picture, 0, height, APP_VIDEO_PIXEL_RGB888, true, bgr888, width * 3);
+        app_yuv_convert_rows(&test.picture, 0, height, APP_VIDEO_PIXEL_RGB565, false, (uint8_t *)rgb565, width * 2);
+        app_yuv_convert_rows(&test.picture, 0, height, APP_VIDEO_PIXEL_RGB565, true, (uint8_t *)bgr565, width * 2);
+
+        int32_t max_error = 0;
+        uint32_t order_errors = 0;
+        uint32_t rgb565_errors = 0;
+        for (uint32_t row = 0; row < height; row++) {
+            for (uint32_t x = 0; x < width; x++) {
+                uint32_t i = row * width + x;
+                uint32_t uv = (row / 2) * test.picture.uv_stride + x / 2;
+                uint8_t expected[3];
+                get_reference(test.picture.y[i], test.picture.u[uv], test.picture.v[uv], expected);
+                const uint8_t *rgb = &rgb888[i * 3];
+                const uint8_t *bgr = &bgr888[i * 3];
+                for (int c = 0; c < 3; c++) {
+                    int32_t error = abs((int32_t)rgb[c] - expected[c]);
+                    max_error = (error > max_error) ? error : max_error;
+                    if (bgr[c] != rgb[2 - c]) {
+                        order_errors++;
+                    }
+                }
+                uint16_t red_low = (uint16_t)(((rgb[2] & 0xF8) << 8) | ((rgb[1] & 0xFC) << 3) | (rgb[0] >> 3));
+                uint16_t blue_low = (uint16_t)(((rgb[0] & 0xF8) << 8) | ((rgb[1] & 0xFC) << 3) | (rgb[2] >> 3));
+                if ((rgb565[i] != red_low) || (bgr565[i] != blue_low)) {
+                    rgb565_errors++;
+                }
+            }
+        }
+        TEST_CHECK(max_error <= 1, "%" PRIu32 "x%" PRIu32 ": %" PRId32 " LSB off BT.601", width, height, max_error);
+        TEST_CHECK(order_errors == 0, "%" PRIu32 "x%" PRIu32 ": %" PRIu32 " channels not swapped in BGR order",
+                   width, height, order_errors);
+        TEST_CHECK(rgb565_errors == 0, "%" PRIu32 "x%" PRIu32 ": %" PRIu32 " RGB565 pixels not the RGB888 ones",
+                   width, height, rgb565_errors);
+
+        free(rgb888);
+        free(bgr888);
+        free(rgb565);
+        free(bgr565);
+        free(test.data);
+    }
+}
+
+static void test_bands(const picture_size_t *sizes, size_t size_num)
+{
+    // The rows of the output are padded, keeping them aligned for RGB565, the padding and the rows out of the band
+    // must stay untouched
+    unsigned int seed = 2;
+    for (size_t s = 0; s < size_num; s++) {
+        uint32_t width = sizes[s].width;
+        uint32_t height = sizes[s].height;
+        test_picture_t test;
+        if (!create_picture(&test, width, height, &seed)) {
+            continue;
+        }
+
+        for (int format = APP_VIDEO_PIXEL_RGB565; format <= APP_VIDEO_PIXEL_RGB888; format++) {
+            uint32_t bpp = (format == APP_VIDEO_PIXEL_RGB888) ? 3 : 2;
+            uint32_t stride = width * bpp + 8;
+            uint8_t *whole = malloc(stride * height);
+            uint8_t *band = malloc(stride * height);
+            if ((whole == NULL) || (band == NULL)) {
+                TEST_CHECK(false, "No memory for the output");
+                free(whole);
+                free(band);
+                continue;
+            }
+            app_yuv_convert_rows(&test.picture, 0, height, format, true, whole, stride);
+
+            // Random bands of pairs of rows, the last one may run past the picture
+            for (uint32_t round = 0; round < 8; round++) {
+                memset(band, GUARD_BYTE, stride * height);
+                uint32_t row = 2 * ((uint32_t)rand_r(&seed) % ((height + 1) / 2));
+                uint32_t rows = 1 + (uint32_t)rand_r(&seed) % (height + 2);
+                app_yuv_convert_rows(&test.picture, row, rows, format, true, band, stride);
+
+                uint32_t end = (row + rows < height) ? row + rows : height;
+                uint32_t mismatches = 0;
+                uint32_t overwrites = 0;
+                for (uint32_t r = 0; r < height; r++) {
+                    for (uint32_t b = 0; b < stride; b++) {
+                        uint8_t value = band[r * stride + b];
+                        if ((r >= row) && (r < end) && (b < width * bpp)) {
+                            mismatches += (value != whole[r * stride + b]);
+                        } else {
+                            overwrites += (value != GUARD_BYTE);
+                        }
+                    }
+                }
+                TEST_CHECK(mismatches == 0, "%" PRIu32 "x%" PRIu32 " %s, rows %" PRIu32 "+%" PRIu32 ": %" PRIu32
+                           " bytes differ from the whole picture", width, height, (bpp == 3) ? "RGB888" : "RGB565",
+                           row, rows, mismatches);
+                TEST_CHECK(overwrites == 0, "%" PRIu32 "x%" PRIu32 " %s, rows %" PRIu32 "+%" PRIu32 ": %" PRIu32
+                           " bytes written out of the band", width, height, (bpp == 3) ? "RGB888" : "RGB565",
+                           row, rows, overwrites);
+            }
+            free(whole);
+            free(band);
+        }
+        free(test.data);
+    }
+}
+
+static void test_speed(uint32_t picture_num)
+{
+    static const picture_size_t sizes[] = { {854, 480}, {1280, 720} };
+    unsigned int seed = 3;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint32_t width = sizes[s].width;
+        uint32_t height = sizes[s].height;
+        test_picture_t test;
+        if (!create_picture(&test, width, height, &seed)) {
+            continue;
+        }
+        uint8_t *out = malloc(width * height * 3);
+        if (out == NULL) {
+            TEST_CHECK(false, "No memory for the output");
+            free(test.data);
+            continue;
+        }
+
+        for (int format = APP_VIDEO_PIXEL_RGB565; format <= APP_VIDEO_PIXEL_RGB888; format++) {
+            uint32_t bpp = (format == APP_VIDEO_PIXEL_RGB888) ? 3 : 2;
+            int64_t start_us = esp_timer_get_time();
+            for (uint32_t i = 0; i < picture_num; i++) {
+                app_yuv_convert_rows(&test.picture, 0, height, format, true, out, width * bpp);
+            }
+            int64_t elapsed_us = esp_timer_get_time() - start_us;
+            printf("%" PRIu32 "x%" PRIu32 " to %s on one thread: %" PRId64 " us per picture, %.0f pictures/s\n",
+                   width, height, (bpp == 3) ? "RGB888" : "RGB565", elapsed_us / picture_num,
+                   picture_num * 1000000.0 / elapsed_us);
+        }
+        free(out);
+        free(test.data);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool is_quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !is_quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Nothing is expected in the log
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    // Partial chunks of 64 pixels, odd sizes, a single row and column, and the usual sizes
+    static const picture_size_t sizes[] = {
+        {2, 2}, {1, 1}, {63, 5}, {64, 2}, {65, 3}, {129, 17}, {333, 197}, {176, 144}, {854, 480}, {1280, 720},
+    };
+    test_accuracy(sizes, sizeof(sizes) / sizeof(sizes[0]));
+    test_bands(sizes, sizeof(sizes) / sizeof(sizes[0]));
+    test_speed(is_quick ? 20 : 500);
+
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+
+    return EXIT_SUCCESS;
+}
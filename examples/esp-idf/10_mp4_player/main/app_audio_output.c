@@ -0,0 +1,632 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+
+#include "app_audio_output.h"
+#include "app_audio_resampler.h"
+
+static const char *TAG = "audio_output";
+
+#define AUDIO_OUTPUT_WAIT_MS            (100)       /*!< Period to check the state while waiting */
+#define AUDIO_OUTPUT_PREBUFFER_POLL_MS  (10)        /*!< Period to check the level while prebuffering */
+#define AUDIO_OUTPUT_SEGMENT_NUM        (128)       /*!< Segments of audio with their own timestamp in the ring */
+#define AUDIO_OUTPUT_RESAMPLE_FRAMES    (1024)      /*!< Input frames converted at once */
+#define AUDIO_OUTPUT_DEFAULT_RATE       (48000)     /*!< Sizes of the buffers, without a sample rate configured */
+#define AUDIO_OUTPUT_DEFAULT_CHANNELS   (2)
+#define AUDIO_OUTPUT_BITS               (16)        /*!< Bits of the converted audio */
+
+/* Event group bits */
+#define AUDIO_OUTPUT_DATA_BIT           (1 << 0)    /*!< Audio written into the ring, for the task */
+#define AUDIO_OUTPUT_SPACE_BIT          (1 << 1)    /*!< Audio taken from the ring or flush, for the writer */
+#define AUDIO_OUTPUT_STOP_BIT           (1 << 2)    /*!< Stop the task */
+
+/**
+ * @brief Audio in the ring from a position on, until the next segment
+ */
+typedef struct {
+    uint64_t position;                  /*!< Position of the first byte */
+    uint32_t pts;                       /*!< Presentation time of the first sample, 0 if it follows the previous one */
+    esp_codec_dev_sample_info_t fs;     /*!< Format of the audio */
+} audio_segment_t;
+
+/**
+ * @brief Audio output context structure
+ *
+ * The positions count the bytes written into the ring and read from it, the byte at the position `p` is in the ring
+ * at `p % ring_size`. The writer copies into the ring and the task copies out of it without the lock, each on its own
+ * side of the positions, and a flush increments the generation so the copy in progress is dropped.
+ */
+typedef struct app_audio_output_t {
+    app_audio_output_config_t config;   /*!< Audio output configuration */
+    uint8_t *ring;                      /*!< Ring of decoded audio */
+    uint32_t ring_size;                 /*!< Size of the ring */
+    uint32_t low_level;                 /*!< Level under which the decoding resumes */
+    uint32_t high_level;                /*!< Level at which the decoding pauses */
+    uint8_t *chunk;                     /*!< Audio written to the device, out of the ring */
+    uint32_t chunk_size;                /*!< Size of the chunk */
+    SemaphoreHandle_t lock;             /*!< Lock of the state below */
+    EventGroupHandle_t events;          /*!< Events between the writer and the task */
+    TaskHandle_t task_handle;           /*!< Task writing the device */
+    app_av_sync_handle_t av_sync;       /*!< A/V sync, or NULL */
+
+    /* Ring */
+    uint32_t generation;                /*!< Incremented by a flush */
+    uint64_t write_position;            /*!< Position of the next byte written */
+    uint64_t read_position;             /*!< Position of the next byte read */
+    audio_segment_t segments[AUDIO_OUTPUT_SEGMENT_NUM];     /*!< Segments of the audio, from the one read */
+    uint32_t segment_first;             /*!< Index of the segment read */
+    uint32_t segment_count;             /*!< Number of segments */
+    bool playing;                       /*!< Flag indicating if the device is written, false until prebuffered */
+    bool starved;                       /*!< Flag indicating if the ring ran empty while playing */
+    int64_t starved_us;                 /*!< Time the ring ran empty */
+    int64_t prebuffer_us;               /*!< Time the prebuffering started, 0 if not yet */
+
+    /* Conversion, used by the writer only */
+    app_audio_resampler_handle_t resampler;     /*!< Conversion to the format of the device */
+    esp_codec_dev_sample_info_t resampler_fs;   /*!< Format of the input of the resampler */
+    uint32_t resampler_generation;      /*!< Generation of the audio last converted */
+    int16_t *convert_buffer;            /*!< Converted audio */
+    uint32_t convert_size;              /*!< Size of the converted audio buffer */
+
+    /* Device, used by the task only */
+    esp_codec_dev_sample_info_t dev_fs; /*!< Format the device is opened with */
+    bool dev_open;                      /*!< Flag indicating if the device is opened */
+
+    app_audio_output_stats_t stats;     /*!< Statistics */
+} app_audio_output_t;
+
+static bool fs_equal(const esp_codec_dev_sample_info_t *a, const esp_codec_dev_sample_info_t *b)
+{
+    return (a->sample_rate == b->sample_rate) && (a->channel == b->channel) &&
+           (a->bits_per_sample == b->bits_per_sample);
+}
+
+static uint32_t frame_size(const esp_codec_dev_sample_info_t *fs)
+{
+    return fs->channel * (fs->bits_per_sample / 8);
+}
+
+/**
+ * @brief Get the format of the audio in the ring, the one of the device, for the audio written
+ */
+static void get_out_format(app_audio_output_t *output, const esp_codec_dev_sample_info_t *fs,
+                           esp_codec_dev_sample_info_t *out_fs)
+{
+    *out_fs = *fs;
+    if (output->config.sample_rate != 0 || output->config.channels != 0) {
+        out_fs->bits_per_sample = AUDIO_OUTPUT_BITS;
+    }
+    if (output->config.sample_rate != 0) {
+        out_fs->sample_rate = output->config.sample_rate;
+    }
+    if (output->config.channels != 0) {
+        out_fs->channel = output->config.channels;
+    }
+}
+
+static void reset_stats(app_audio_output_t *output)
+{
+    app_audio_output_stats_t stats = {
+        .in_rate = output->stats.in_rate,
+        .out_rate = output->stats.out_rate,
+        .out_channels = output->stats.out_channels,
+        .level_min_ms = UINT32_MAX,
+    };
+    output->stats = stats;
+}
+
+/**
+ * @brief Wait for the task to take audio from the ring, with the lock taken
+ *
+ * @return false if the ring was flushed meanwhile
+ */
+static bool wait_space(app_audio_output_t *output, uint32_t generation)
+{
+    xSemaphoreGive(output->lock);
+    xEventGroupWaitBits(output->events, AUDIO_OUTPUT_SPACE_BIT, pdTRUE, pdFALSE,
+                        pdMS_TO_TICKS(AUDIO_OUTPUT_WAIT_MS));
+    xSemaphoreTake(output->lock, portMAX_DELAY);
+    return (generation == output->generation);
+}
+
+/**
+ * @brief Copy into the ring, across its end
+ */
+static void copy_in(app_audio_output_t *output, uint32_t offset, const uint8_t *data, uint32_t size)
+{
+    uint32_t first = output->ring_size - offset;
+    if (first > size) {
+        first = size;
+    }
+    memcpy(output->ring + offset, data, first);
+    memcpy(output->ring, data + first, size - first);
+}
+
+/**
+ * @brief Copy out of the ring, across its end
+ */
+static void copy_out(app_audio_output_t *output, uint32_t offset, uint8_t *data, uint32_t size)
+{
+    uint32_t first = output->ring_size - offset;
+    if (first > size) {
+        first = size;
+    }
+    memcpy(data, output->ring + offset, first);
+    memcpy(data + first, output->ring, size - first);
+}
+
+/**
+ * @brief Start a segment at the write position, or continue the last one with the audio following it
+ *
+ * @return false if all the segments are in use
+ */
+static bool add_segment(app_audio_output_t *output, const esp_codec_dev_sample_info_t *fs, uint32_t pts)
+{
+    if (output->segment_count > 0) {
+        audio_segment_t *last = &output->segments[(output->segment_first + output->segment_count - 1) %
+                                                  AUDIO_OUTPUT_SEGMENT_NUM];
+        if (pts == 0 && fs_equal(&last->fs, fs)) {
+            return true;
+        }
+    }
+    if (output->segment_count == AUDIO_OUTPUT_SEGMENT_NUM) {
+        return false;
+    }
+
+    audio_segment_t *segment = &output->segments[(output->segment_first + output->segment_count) %
+                                                 AUDIO_OUTPUT_SEGMENT_NUM];
+    segment->position = output->write_position;
+    segment->pts = pts;
+    segment->fs = *fs;
+    output->segment_count++;
+    return true;
+}
+
+/**
+ * @brief Copy audio in the format of the device into the ring
+ *
+ * The decoding is paused once the ring is at its high level, until it is down to its low level.
+ */
+static esp_err_t push_audio(app_audio_output_t *output, uint32_t generation, const esp_codec_dev_sample_info_t *fs,
+                            uint32_t pts, const uint8_t *data, uint32_t size)
+{
+    uint32_t frame = frame_size(fs);
+    esp_err_t ret = ESP_OK;
+    bool segment_added = false;
+
+    xSemaphoreTake(output->lock, portMAX_DELAY);
+
+    // How close the decoding came to an underrun, the level drops at the end of the stream without one
+    uint32_t level = (uint32_t)(output->write_position - output->read_position);
+    uint32_t bytes_per_ms = fs->sample_rate * frame / 1000;
+    if (output->playing && bytes_per_ms > 0 && level / bytes_per_ms < output->stats.level_min_ms) {
+        output->stats.level_min_ms = level / bytes_per_ms;
+    }
+
+    if (generation != output->generation) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else if (output->write_position - output->read_position >= output->high_level) {
+        output->stats.decode_waits++;
+        while (output->write_position - output->read_position > output->low_level) {
+            if (!wait_space(output, generation)) {
+                ret = ESP_ERR_INVALID_STATE;
+                break;
+            }
+        }
+    }
+
+    while (ret == ESP_OK && size > 0) {
+        uint32_t space = output->ring_size - (uint32_t)(output->write_position - output->read_position);
+        space -= space % frame;
+        if (space > 0 && !segment_added) {
+            segment_added = add_segment(output, fs, pts);
+        }
+        if (space == 0 || !segment_added) {
+            if (!wait_space(output, generation)) {
+                ret = ESP_ERR_INVALID_STATE;
+            }
+            continue;
+        }
+
+        uint32_t n = (size < space) ? size : space;
+        uint32_t offset = (uint32_t)(output->write_position % output->ring_size);
+        xSemaphoreGive(output->lock);
+        copy_in(output, offset, data, n);
+        xSemaphoreTake(output->lock, portMAX_DELAY);
+
+        if (generation != output->generation) {
+            ret = ESP_ERR_INVALID_STATE;
+            break;
+        }
+        output->write_position += n;
+        data += n;
+        size -= n;
+        xEventGroupSetBits(output->events, AUDIO_OUTPUT_DATA_BIT);
+    }
+
+    xSemaphoreGive(output->lock);
+    return ret;
+}
+
+/**
+ * @brief Get the resampler for a format, created again when the format changes
+ */
+static esp_err_t prepare_resampler(app_audio_output_t *output, const esp_codec_dev_sample_info_t *fs,
+                                   const esp_codec_dev_sample_info_t *out_fs, uint32_t generation)
+{
+    if (output->resampler != NULL && fs_equal(&output->resampler_fs, fs)) {
+        // The audio after a flush does not follow the samples kept by the filter
+        if (output->resampler_generation != generation) {
+            app_audio_resampler_reset(output->resampler);
+            output->resampler_generation = generation;
+        }
+        return ESP_OK;
+    }
+
+    if (output->resampler != NULL) {
+        app_audio_resampler_destroy(output->resampler);
+        output->resampler = NULL;
+    }
+
+    app_audio_resampler_config_t config = {
+        .in_rate = fs->sample_rate,
+        .in_channels = fs->channel,
+        .in_bits = fs->bits_per_sample,
+        .out_rate = out_fs->sample_rate,
+        .out_channels = out_fs->channel,
+    };
+    esp_err_t ret = app_audio_resampler_create(&config, &output->resampler);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create resampler: %d", ret);
+        return ret;
+    }
+    output->resampler_fs = *fs;
+    output->resampler_generation = generation;
+
+    uint32_t size = app_audio_resampler_get_out_size(output->resampler, AUDIO_OUTPUT_RESAMPLE_FRAMES *
+                                                     frame_size(fs));
+    if (size > output->convert_size) {
+        free(output->convert_buffer);
+        output->convert_size = 0;
+        output->convert_buffer = malloc(size);
+        if (output->convert_buffer == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        output->convert_size = size;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Open the device with the format of the audio, it is reopened only when the format changes
+ */
+static esp_err_t open_dev(app_audio_output_t *output, const esp_codec_dev_sample_info_t *fs)
+{
+    if (output->dev_open && fs_equal(&output->dev_fs, fs)) {
+        return ESP_OK;
+    }
+
+    bool reopen = output->dev_open;
+    if (output->dev_open) {
+        esp_codec_dev_close(output->config.dev);
+        output->dev_open = false;
+    }
+    esp_codec_dev_sample_info_t dev_fs = *fs;
+    if (esp_codec_dev_open(output->config.dev, &dev_fs) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open audio device: %" PRIu32 " Hz %u ch %u bits",
+                 fs->sample_rate, fs->channel, fs->bits_per_sample);
+        return ESP_FAIL;
+    }
+    output->dev_fs = *fs;
+    output->dev_open = true;
+
+    xSemaphoreTake(output->lock, portMAX_DELAY);
+    output->stats.out_rate = fs->sample_rate;
+    output->stats.out_channels = fs->channel;
+    if (reopen) {
+        output->stats.dev_reopens++;
+    }
+    xSemaphoreGive(output->lock);
+    return ESP_OK;
+}
+
+static bool is_task_running(app_audio_output_t *output)
+{
+    xSemaphoreTake(output->lock, portMAX_DELAY);
+    bool running = (output->task_handle != NULL);
+    xSemaphoreGive(output->lock);
+    return running;
+}
+
+/**
+ * @brief Task writing the audio of the ring to the device, paced by the device
+ */
+static void output_task(void *arg)
+{
+    app_audio_output_t *output = (app_audio_output_t *)arg;
+
+    while (!(xEventGroupGetBits(output->events) & AUDIO_OUTPUT_STOP_BIT)) {
+        xSemaphoreTake(output->lock, portMAX_DELAY);
+
+        uint32_t level = (uint32_t)(output->write_position - output->read_position);
+        int64_t now_us = esp_timer_get_time();
+        if (level == 0 || output->segment_count == 0) {
+            if (output->playing) {
+                output->playing = false;
+                output->starved = true;
+                output->starved_us = now_us;
+            }
+            xSemaphoreGive(output->lock);
+            xEventGroupWaitBits(output->events, AUDIO_OUTPUT_DATA_BIT | AUDIO_OUTPUT_STOP_BIT, pdFALSE, pdFALSE,
+                                pdMS_TO_TICKS(AUDIO_OUTPUT_WAIT_MS));
+            xEventGroupClearBits(output->events, AUDIO_OUTPUT_DATA_BIT);
+            continue;
+        }
+
+        // Segments read up to their end
+        while (output->segment_count > 1 &&
+                output->segments[(output->segment_first + 1) % AUDIO_OUTPUT_SEGMENT_NUM].position <=
+                output->read_position) {
+            output->segment_first = (output->segment_first + 1) % AUDIO_OUTPUT_SEGMENT_NUM;
+            output->segment_count--;
+        }
+        audio_segment_t *segment = &output->segments[output->segment_first];
+        esp_codec_dev_sample_info_t fs = segment->fs;
+        uint32_t frame = frame_size(&fs);
+        uint32_t bytes_per_ms = fs.sample_rate * frame / 1000;
+
+        // Some audio ahead before the device starts, unless the decoding is done, e.g. at the end of the stream
+        if (!output->playing) {
+            if (output->prebuffer_us == 0) {
+                output->prebuffer_us = now_us;
+            }
+            uint32_t prebuffer = output->config.prebuffer_ms * bytes_per_ms;
+            if (level < prebuffer && level < output->low_level &&
+                    (now_us - output->prebuffer_us < (int64_t)output->config.prebuffer_ms * 1000)) {
+                xSemaphoreGive(output->lock);
+                vTaskDelay(pdMS_TO_TICKS(AUDIO_OUTPUT_PREBUFFER_POLL_MS));
+                continue;
+            }
+            if (output->starved) {
+                uint32_t wait_ms = (uint32_t)((now_us - output->starved_us) / 1000);
+                output->stats.underruns++;
+                output->stats.underrun_total_ms += wait_ms;
+                if (wait_ms > output->stats.underrun_max_ms) {
+                    output->stats.underrun_max_ms = wait_ms;
+                }
+                output->starved = false;
+            }
+            output->playing = true;
+            output->prebuffer_us = 0;
+        }
+
+        // A chunk within the segment, in whole frames
+        uint32_t n = (level < output->chunk_size) ? level : output->chunk_size;
+        if (output->segment_count > 1) {
+            uint64_t end = output->segments[(output->segment_first + 1) % AUDIO_OUTPUT_SEGMENT_NUM].position;
+            if (end - output->read_position < n) {
+                n = (uint32_t)(end - output->read_position);
+            }
+        }
+        n -= n % frame;
+        uint32_t pts = (output->read_position == segment->position) ? segment->pts : 0;
+        uint32_t generation = output->generation;
+        uint32_t offset = (uint32_t)(output->read_position % output->ring_size);
+        xSemaphoreGive(output->lock);
+
+        if (n == 0) {
+            ESP_LOGW(TAG, "Partial frame in the ring, dropped");
+            app_audio_output_flush(output);
+            continue;
+        }
+
+        copy_out(output, offset, output->chunk, n);
+
+        xSemaphoreTake(output->lock, portMAX_DELAY);
+        bool flushed = (generation != output->generation);
+        if (!flushed) {
+            output->read_position += n;
+        }
+        xSemaphoreGive(output->lock);
+        xEventGroupSetBits(output->events, AUDIO_OUTPUT_SPACE_BIT);
+        if (flushed || open_dev(output, &fs) != ESP_OK) {
+            continue;
+        }
+
+        // The write blocks while the device is full, so the audio plays at its own rate
+        if (esp_codec_dev_write(output->config.dev, output->chunk, n) == ESP_OK) {
+            uint32_t frames = n / frame;
+            xSemaphoreTake(output->lock, portMAX_DELAY);
+            output->stats.frames_played += frames;
+            xSemaphoreGive(output->lock);
+            app_av_sync_handle_t av_sync = output->av_sync;
+            if (av_sync != NULL) {
+                app_av_sync_audio_written(av_sync, pts, frames, fs.sample_rate, esp_timer_get_time());
+            }
+        }
+    }
+
+    xSemaphoreTake(output->lock, portMAX_DELAY);
+    output->task_handle = NULL;
+    xSemaphoreGive(output->lock);
+    vTaskDelete(NULL);
+}
+
+esp_err_t app_audio_output_create(const app_audio_output_config_t *config, app_audio_output_handle_t *ret_output)
+{
+    if (config == NULL || ret_output == NULL || config->dev == NULL || config->ring_ms == 0 ||
+            config->chunk_ms == 0 || config->low_percent >= config->high_percent || config->high_percent > 100) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_audio_output_t *output = calloc(1, sizeof(app_audio_output_t));
+    if (output == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate audio output context");
+        return ESP_ERR_NO_MEM;
+    }
+
+    output->config = *config;
+    uint32_t rate = (config->sample_rate != 0) ? config->sample_rate : AUDIO_OUTPUT_DEFAULT_RATE;
+    uint32_t channels = (config->channels != 0) ? config->channels : AUDIO_OUTPUT_DEFAULT_CHANNELS;
+    uint32_t bytes_per_ms = rate * channels * (AUDIO_OUTPUT_BITS / 8) / 1000;
+    output->ring_size = config->ring_ms * bytes_per_ms;
+    output->low_level = (uint32_t)((uint64_t)output->ring_size * config->low_percent / 100);
+    output->high_level = (uint32_t)((uint64_t)output->ring_size * config->high_percent / 100);
+    output->chunk_size = config->chunk_ms * bytes_per_ms;
+    reset_stats(output);
+
+    output->lock = xSemaphoreCreateMutex();
+    output->events = xEventGroupCreate();
+    output->ring = heap_caps_malloc(output->ring_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    output->chunk = heap_caps_malloc(output->chunk_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (output->lock == NULL || output->events == NULL || output->ring == NULL || output->chunk == NULL) {
+        ESP_LOGE(TAG, "Failed to create audio output, ring of %" PRIu32 " bytes", output->ring_size);
+        app_audio_output_destroy(output);
+        return ESP_ERR_NO_MEM;
+    }
+
+    BaseType_t task_ret = xTaskCreate(output_task, "audio_output", config->task_stack_size, output,
+                                      config->task_priority, &output->task_handle);
+    if (task_ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create audio output task");
+        output->task_handle = NULL;
+        app_audio_output_destroy(output);
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "Audio output created: %" PRIu32 " Hz %" PRIu32 " ch%s, ring of %" PRIu32 " bytes",
+             rate, channels, (config->sample_rate != 0) ? "" : " or the rate of the audio", output->ring_size);
+    *ret_output = output;
+    return ESP_OK;
+}
+
+esp_err_t app_audio_output_set_av_sync(app_audio_output_handle_t output, app_av_sync_handle_t av_sync)
+{
+    if (output == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    output->av_sync = av_sync;
+    return ESP_OK;
+}
+
+esp_err_t app_audio_output_write(app_audio_output_handle_t output, const esp_codec_dev_sample_info_t *fs, uint32_t pts,
+                                 const void *data, uint32_t size)
+{
+    if (output == NULL || fs == NULL || data == NULL || fs->sample_rate == 0 || frame_size(fs) == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(output->lock, portMAX_DELAY);
+    uint32_t generation = output->generation;
+    output->stats.in_rate = fs->sample_rate;
+    xSemaphoreGive(output->lock);
+
+    esp_codec_dev_sample_info_t out_fs;
+    get_out_format(output, fs, &out_fs);
+    uint32_t in_frame = frame_size(fs);
+    const uint8_t *input = (const uint8_t *)data;
+    size -= size % in_frame;
+
+    if (fs_equal(fs, &out_fs)) {
+        return push_audio(output, generation, &out_fs, pts, input, size);
+    }
+
+    esp_err_t ret = prepare_resampler(output, fs, &out_fs, generation);
+    while (ret == ESP_OK && size > 0) {
+        uint32_t n = (size < AUDIO_OUTPUT_RESAMPLE_FRAMES * in_frame) ? size : AUDIO_OUTPUT_RESAMPLE_FRAMES * in_frame;
+        uint32_t converted = 0;
+        ret = app_audio_resampler_process(output->resampler, input, n, output->convert_buffer, &converted);
+        if (ret == ESP_OK && converted > 0) {
+            ret = push_audio(output, generation, &out_fs, pts, (const uint8_t *)output->convert_buffer, converted);
+            // The timestamp is the one of the first samples, until the filter outputs them
+            pts = 0;
+        }
+        input += n;
+        size -= n;
+    }
+    return ret;
+}
+
+esp_err_t app_audio_output_flush(app_audio_output_handle_t output)
+{
+    if (output == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(output->lock, portMAX_DELAY);
+    output->generation++;
+    output->read_position = output->write_position;
+    output->segment_count = 0;
+    output->playing = false;
+    output->starved = false;
+    output->prebuffer_us = 0;
+    reset_stats(output);
+    xSemaphoreGive(output->lock);
+
+    // A writer waiting for room returns
+    xEventGroupSetBits(output->events, AUDIO_OUTPUT_SPACE_BIT);
+    return ESP_OK;
+}
+
+esp_err_t app_audio_output_get_stats(app_audio_output_handle_t output, app_audio_output_stats_t *stats)
+{
+    if (output == NULL || stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(output->lock, portMAX_DELAY);
+    *stats = output->stats;
+    xSemaphoreGive(output->lock);
+    if (stats->level_min_ms == UINT32_MAX) {
+        stats->level_min_ms = 0;
+    }
+    return ESP_OK;
+}
+
+esp_err_t app_audio_output_destroy(app_audio_output_handle_t output)
+{
+    if (output == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (output->task_handle != NULL) {
+        xEventGroupSetBits(output->events, AUDIO_OUTPUT_STOP_BIT);
+        while (is_task_running(output)) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+    if (output->dev_open) {
+        esp_codec_dev_close(output->config.dev);
+    }
+
+    if (output->resampler != NULL) {
+        app_audio_resampler_destroy(output->resampler);
+    }
+    free(output->convert_buffer);
+    heap_caps_free(output->chunk);
+    heap_caps_free(output->ring);
+    if (output->events != NULL) {
+        vEventGroupDelete(output->events);
+    }
+    if (output->lock != NULL) {
+        vSemaphoreDelete(output->lock);
+    }
+    free(output);
+
+    return ESP_OK;
+}
@@ -0,0 +1,129 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_codec_dev.h"
+#include "app_av_sync.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Audio output handle
+ */
+typedef struct app_audio_output_t* app_audio_output_handle_t;
+
+/**
+ * @brief Audio output configuration structure
+ */
+typedef struct {
+    esp_codec_dev_handle_t dev;     /*!< Audio device */
+    uint32_t sample_rate;           /*!< Sample rate of the device, or 0 to follow the audio written */
+    uint8_t channels;               /*!< Channels of the device, or 0 to follow the audio written */
+    uint32_t ring_ms;               /*!< Decoded audio held ahead of the device, in 48 kHz stereo without a format */
+    uint8_t low_percent;            /*!< Level of the ring under which the decoding resumes */
+    uint8_t high_percent;           /*!< Level of the ring at which the decoding pauses */
+    uint32_t prebuffer_ms;          /*!< Audio in the ring before the device starts, and after an underrun */
+    uint32_t chunk_ms;              /*!< Audio written to the device at once */
+    uint32_t task_priority;         /*!< Priority of the task writing the device */
+    uint32_t task_stack_size;       /*!< Stack size of the task writing the device */
+} app_audio_output_config_t;
+
+/**
+ * @brief Helper macro to create default audio output configuration
+ */
+#define APP_AUDIO_OUTPUT_CONFIG_DEFAULT()   \
+    {                                       \
+        .dev = NULL,                        \
+        .sample_rate = 48000,               \
+        .channels = 2,                      \
+        .ring_ms = 500,                     \
+        .low_percent = 50,                  \
+        .high_percent = 90,                 \
+        .prebuffer_ms = 100,                \
+        .chunk_ms = 20,                     \
+        .task_priority = 8,                 \
+        .task_stack_size = 3 * 1024,        \
+    }
+
+/**
+ * @brief Audio output statistics structure
+ */
+typedef struct {
+    uint32_t in_rate;               /*!< Sample rate of the audio written last */
+    uint32_t out_rate;              /*!< Sample rate of the device */
+    uint8_t out_channels;           /*!< Channels of the device */
+    uint64_t frames_played;         /*!< Frames written to the device */
+    uint32_t underruns;             /*!< Times the ring ran empty, and the device waited for the decoding */
+    uint32_t underrun_max_ms;       /*!< Longest wait of the device */
+    uint32_t underrun_total_ms;     /*!< Total wait of the device */
+    uint32_t level_min_ms;          /*!< Lowest level of the ring when the decoded audio is written, while playing */
+    uint32_t decode_waits;          /*!< Times the decoding paused at the high level of the ring */
+    uint32_t dev_reopens;           /*!< Times the device was reopened for another audio format */
+} app_audio_output_stats_t;
+
+/**
+ * @brief Create an audio output
+ *
+ * The audio is decoded ahead into a ring in PSRAM, which a task writes to the device. The decoding runs until the ring
+ * is at its high level, then pauses until the ring is down to its low level, so it works in bursts and the device
+ * keeps playing through a slow read or decode. The audio is converted on its way into the ring to the format of the
+ * device, by `app_audio_resampler`, so a device with a fixed sample rate plays any stream and is opened only once.
+ * Without a sample rate and channels configured, the device follows the format of the audio, and is reopened in the
+ * stream when it changes.
+ *
+ * @note The task starts here, and runs until the audio output is destroyed
+ *
+ * @param config Audio output configuration
+ * @param ret_output Pointer to store the audio output handle
+ * @return ESP_OK on success, or an error code
+ */
+esp_err_t app_audio_output_create(const app_audio_output_config_t *config, app_audio_output_handle_t *ret_output);
+
+/**
+ * @brief Set the A/V sync whose audio clock follows the audio written to the device, or NULL
+ */
+esp_err_t app_audio_output_set_av_sync(app_audio_output_handle_t output, app_av_sync_handle_t av_sync);
+
+/**
+ * @brief Write decoded audio into the ring
+ *
+ * It blocks while the ring is above its high level, until it is down to its low level.
+ *
+ * @param output Audio output handle
+ * @param fs Format of the audio
+ * @param pts Presentation time of the first sample in milliseconds, 0 if they follow the previous ones
+ * @param data Samples, whole frames of all the channels
+ * @param size Size of the samples in bytes
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if the ring was flushed meanwhile, or another error code
+ */
+esp_err_t app_audio_output_write(app_audio_output_handle_t output, const esp_codec_dev_sample_info_t *fs, uint32_t pts,
+                                 const void *data, uint32_t size);
+
+/**
+ * @brief Drop the audio in the ring, and the statistics, e.g. for a new stream or a seek
+ *
+ * A write in progress returns with ESP_ERR_INVALID_STATE.
+ */
+esp_err_t app_audio_output_flush(app_audio_output_handle_t output);
+
+/**
+ * @brief Get the audio output statistics, since the last flush
+ */
+esp_err_t app_audio_output_get_stats(app_audio_output_handle_t output, app_audio_output_stats_t *stats);
+
+/**
+ * @brief Destroy an audio output, the device is closed
+ */
+esp_err_t app_audio_output_destroy(app_audio_output_handle_t output);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,311 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include "esp_log.h"
+#include "esp_err.h"
+
+#include "app_audio_resampler.h"
+
+static const char *TAG = "audio_resampler";
+
+#define RESAMPLER_TAPS              (32)        /*!< Input samples per output sample */
+#define RESAMPLER_PHASES            (128)       /*!< Phases of the filter between two input samples */
+#define RESAMPLER_COEF_SHIFT        (14)        /*!< Q14, the sum of the products stays in 32 bits */
+#define RESAMPLER_WEIGHT_SHIFT      (15)        /*!< Q15 weight of the interpolation between two phases */
+#define RESAMPLER_BLOCK_FRAMES      (256)       /*!< Input frames mixed at once */
+#define RESAMPLER_CUTOFF            (0.45f)     /*!< Cutoff of the filter, relative to the lower rate */
+#define RESAMPLER_KAISER_BETA       (7.0f)      /*!< Window of the filter, about 70 dB of stopband */
+#define RESAMPLER_MAX_CHANNELS      (8)
+#define RESAMPLER_MAX_RATIO         (RESAMPLER_TAPS / 2)    /*!< Decimation at most, within the taps of an output */
+
+/**
+ * @brief Resampler context structure
+ *
+ * The history holds the mixed input frames not used up by the filter yet. The next output sample is at the input
+ * time `pos + RESAMPLER_TAPS / 2 - 1 + frac / step_out`, `pos` being 0 at the start of each call.
+ */
+typedef struct app_audio_resampler_t {
+    app_audio_resampler_config_t config;    /*!< Resampler configuration */
+    uint32_t in_frame_size;                 /*!< Bytes of an input frame */
+    bool resample;                          /*!< Flag indicating if the rates differ */
+    uint32_t step_in;                       /*!< Input rate, divided by the greatest common divisor of the rates */
+    uint32_t step_out;                      /*!< Output rate, divided by the greatest common divisor of the rates */
+    uint32_t frac;                          /*!< Position between two input samples, in `1 / step_out` */
+    int16_t *coefs;                         /*!< `RESAMPLER_PHASES + 1` phases of `RESAMPLER_TAPS` coefficients */
+    int16_t *history;                       /*!< Mixed input frames */
+    uint32_t history_frames;                /*!< Frames in the history */
+} app_audio_resampler_t;
+
+static uint32_t gcd(uint32_t a, uint32_t b)
+{
+    while (b != 0) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/**
+ * @brief Modified Bessel function of the first kind of order 0, for the Kaiser window
+ */
+static float bessel_i0(float x)
+{
+    float sum = 1.0f;
+    float term = 1.0f;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0f * k)) * (x / (2.0f * k));
+        sum += term;
+        if (term < sum * 1e-9f) {
+            break;
+        }
+    }
+    return sum;
+}
+
+/**
+ * @brief Fill the phases of the filter, each one normalized to a unity gain
+ */
+static void init_coefs(app_audio_resampler_t *resampler)
+{
+    const app_audio_resampler_config_t *config = &resampler->config;
+    float ratio = (config->out_rate < config->in_rate) ? (float)config->out_rate / config->in_rate : 1.0f;
+    float cutoff = RESAMPLER_CUTOFF * ratio;    // In cycles per input sample
+    float half = RESAMPLER_TAPS / 2;
+    float window_norm = 1.0f / bessel_i0(RESAMPLER_KAISER_BETA);
+    float taps[RESAMPLER_TAPS];
+
+    for (int p = 0; p <= RESAMPLER_PHASES; p++) {
+        float phase = (float)p / RESAMPLER_PHASES;
+        float sum = 0.0f;
+        for (int k = 0; k < RESAMPLER_TAPS; k++) {
+            // Distance from the input sample of the tap to the output sample
+            float d = half - 1.0f + phase - k;
+            float x = 2.0f * cutoff * d;
+            float sinc = (fabsf(x) < 1e-6f) ? 1.0f : sinf((float)M_PI * x) / ((float)M_PI * x);
+            float r = d / half;
+            float window = (r * r < 1.0f) ?
+                           bessel_i0(RESAMPLER_KAISER_BETA * sqrtf(1.0f - r * r)) * window_norm : 0.0f;
+            taps[k] = sinc * window;
+            sum += taps[k];
+        }
+        for (int k = 0; k < RESAMPLER_TAPS; k++) {
+            resampler->coefs[p * RESAMPLER_TAPS + k] =
+                (int16_t)lrintf(taps[k] / sum * (1 << RESAMPLER_COEF_SHIFT));
+        }
+    }
+}
+
+/**
+ * @brief Read an input sample, in 16 bits
+ */
+static inline int32_t read_sample(const uint8_t *p, uint8_t bits)
+{
+    switch (bits) {
+    case 8:
+        return ((int32_t)p[0] - 128) * 256;
+    case 16:
+        return (int16_t)(p[0] | (p[1] << 8));
+    case 24:
+        return (int16_t)(p[1] | (p[2] << 8));
+    default:
+        return (int16_t)(p[2] | (p[3] << 8));
+    }
+}
+
+/**
+ * @brief Convert input frames to 16 bits, and mix them to the output channels
+ */
+static void mix_frames(app_audio_resampler_t *resampler, const uint8_t *in, uint32_t frames, int16_t *out)
+{
+    uint8_t in_channels = resampler->config.in_channels;
+    uint8_t out_channels = resampler->config.out_channels;
+    uint8_t bits = resampler->config.in_bits;
+    uint32_t sample_size = bits / 8;
+
+    for (uint32_t f = 0; f < frames; f++) {
+        if (in_channels <= out_channels) {
+            for (uint8_t o = 0; o < out_channels; o++) {
+                out[o] = (int16_t)read_sample(in + (o % in_channels) * sample_size, bits);
+            }
+        } else {
+            for (uint8_t o = 0; o < out_channels; o++) {
+                int32_t sum = 0;
+                int32_t count = 0;
+                for (uint8_t i = o; i < in_channels; i += out_channels) {
+                    sum += read_sample(in + i * sample_size, bits);
+                    count++;
+                }
+                out[o] = (int16_t)(sum / count);
+            }
+        }
+        in += resampler->in_frame_size;
+        out += out_channels;
+    }
+}
+
+/**
+ * @brief Filter the history into output frames, as long as it has the input samples of the taps
+ *
+ * @return Number of output frames
+ */
+static uint32_t filter_history(app_audio_resampler_t *resampler, int16_t *out)
+{
+    uint8_t channels = resampler->config.out_channels;
+    uint32_t pos = 0;
+    uint32_t produced = 0;
+    int16_t coefs[RESAMPLER_TAPS];
+
+    while (pos + RESAMPLER_TAPS <= resampler->history_frames) {
+        // Coefficients interpolated between the two phases around the position
+        uint32_t x = resampler->frac * RESAMPLER_PHASES;
+        uint32_t phase = x / resampler->step_out;
+        int32_t weight = (int32_t)(((uint64_t)(x % resampler->step_out) << RESAMPLER_WEIGHT_SHIFT) /
+                                   resampler->step_out);
+        const int16_t *c0 = &resampler->coefs[phase * RESAMPLER_TAPS];
+        const int16_t *c1 = c0 + RESAMPLER_TAPS;
+        for (int k = 0; k < RESAMPLER_TAPS; k++) {
+            coefs[k] = (int16_t)(c0[k] + (((c1[k] - c0[k]) * weight) >> RESAMPLER_WEIGHT_SHIFT));
+        }
+
+        const int16_t *samples = &resampler->history[pos * channels];
+        for (uint8_t c = 0; c < channels; c++) {
+            int32_t acc = 1 << (RESAMPLER_COEF_SHIFT - 1);
+            for (int k = 0; k < RESAMPLER_TAPS; k++) {
+                acc += coefs[k] * samples[k * channels + c];
+            }
+            acc >>= RESAMPLER_COEF_SHIFT;
+            *out++ = (int16_t)((acc > INT16_MAX) ? INT16_MAX : (acc < INT16_MIN) ? INT16_MIN : acc);
+        }
+        produced++;
+
+        resampler->frac += resampler->step_in;
+        pos += resampler->frac / resampler->step_out;
+        resampler->frac %= resampler->step_out;
+    }
+
+    // The frames still needed by the taps move to the start of the history
+    resampler->history_frames -= pos;
+    memmove(resampler->history, &resampler->history[pos * channels],
+            resampler->history_frames * channels * sizeof(int16_t));
+    return produced;
+}
+
+esp_err_t app_audio_resampler_create(const app_audio_resampler_config_t *config,
+                                     app_audio_resampler_handle_t *ret_resampler)
+{
+    if (config == NULL || ret_resampler == NULL || config->in_rate == 0 || config->out_rate == 0 ||
+            config->in_channels == 0 || config->in_channels > RESAMPLER_MAX_CHANNELS ||
+            config->out_channels == 0 || config->out_channels > RESAMPLER_MAX_CHANNELS ||
+            (config->in_bits != 8 && config->in_bits != 16 && config->in_bits != 24 && config->in_bits != 32)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (config->in_rate > config->out_rate * RESAMPLER_MAX_RATIO) {
+        ESP_LOGE(TAG, "Cannot resample from %" PRIu32 " Hz to %" PRIu32 " Hz", config->in_rate, config->out_rate);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    app_audio_resampler_t *resampler = calloc(1, sizeof(app_audio_resampler_t));
+    if (resampler == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    resampler->config = *config;
+    resampler->in_frame_size = config->in_channels * (config->in_bits / 8);
+    resampler->resample = (config->in_rate != config->out_rate);
+
+    if (resampler->resample) {
+        uint32_t divisor = gcd(config->in_rate, config->out_rate);
+        resampler->step_in = config->in_rate / divisor;
+        resampler->step_out = config->out_rate / divisor;
+        resampler->coefs = malloc((RESAMPLER_PHASES + 1) * RESAMPLER_TAPS * sizeof(int16_t));
+        resampler->history = malloc((RESAMPLER_TAPS + RESAMPLER_BLOCK_FRAMES) * config->out_channels *
+                                    sizeof(int16_t));
+        if (resampler->coefs == NULL || resampler->history == NULL) {
+            app_audio_resampler_destroy(resampler);
+            return ESP_ERR_NO_MEM;
+        }
+        init_coefs(resampler);
+        app_audio_resampler_reset(resampler);
+    }
+
+    ESP_LOGI(TAG, "Resampler %" PRIu32 " Hz %u ch %u bits to %" PRIu32 " Hz %u ch 16 bits", config->in_rate,
+             config->in_channels, config->in_bits, config->out_rate, config->out_channels);
+    *ret_resampler = resampler;
+    return ESP_OK;
+}
+
+uint32_t app_audio_resampler_get_out_size(app_audio_resampler_handle_t resampler, uint32_t in_size)
+{
+    if (resampler == NULL) {
+        return 0;
+    }
+
+    uint64_t frames = in_size / resampler->in_frame_size;
+    if (resampler->resample) {
+        frames = (frames + RESAMPLER_TAPS) * resampler->config.out_rate / resampler->config.in_rate + 2;
+    }
+    return (uint32_t)(frames * resampler->config.out_channels * sizeof(int16_t));
+}
+
+esp_err_t app_audio_resampler_process(app_audio_resampler_handle_t resampler, const void *in, uint32_t in_size,
+                                      int16_t *out, uint32_t *out_size)
+{
+    if (resampler == NULL || (in == NULL && in_size > 0) || out == NULL || out_size == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const uint8_t *input = (const uint8_t *)in;
+    uint32_t frames = in_size / resampler->in_frame_size;
+    uint32_t out_frames = 0;
+    uint8_t channels = resampler->config.out_channels;
+
+    while (frames > 0) {
+        uint32_t n = (frames < RESAMPLER_BLOCK_FRAMES) ? frames : RESAMPLER_BLOCK_FRAMES;
+        if (resampler->resample) {
+            mix_frames(resampler, input, n, &resampler->history[resampler->history_frames * channels]);
+            resampler->history_frames += n;
+            out_frames += filter_history(resampler, &out[out_frames * channels]);
+        } else {
+            mix_frames(resampler, input, n, &out[out_frames * channels]);
+            out_frames += n;
+        }
+        input += n * resampler->in_frame_size;
+        frames -= n;
+    }
+
+    *out_size = out_frames * channels * sizeof(int16_t);
+    return ESP_OK;
+}
+
+void app_audio_resampler_reset(app_audio_resampler_handle_t resampler)
+{
+    if (resampler == NULL || !resampler->resample) {
+        return;
+    }
+
+    // Silence before the first input sample, so the first output sample is at its time
+    resampler->history_frames = RESAMPLER_TAPS / 2 - 1;
+    memset(resampler->history, 0, resampler->history_frames * resampler->config.out_channels * sizeof(int16_t));
+    resampler->frac = 0;
+}
+
+esp_err_t app_audio_resampler_destroy(app_audio_resampler_handle_t resampler)
+{
+    if (resampler == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    free(resampler->coefs);
+    free(resampler->history);
+    free(resampler);
+    return ESP_OK;
+}
@@ -0,0 +1,82 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Resampler handle
+ */
+typedef struct app_audio_resampler_t* app_audio_resampler_handle_t;
+
+/**
+ * @brief Resampler configuration structure
+ *
+ * The output is 16 bits interleaved PCM.
+ */
+typedef struct {
+    uint32_t in_rate;               /*!< Sample rate of the input */
+    uint8_t in_channels;            /*!< Channels of the input, interleaved */
+    uint8_t in_bits;                /*!< Bits per sample of the input: 8 (unsigned), 16, 24 (packed) or 32 */
+    uint32_t out_rate;              /*!< Sample rate of the output */
+    uint8_t out_channels;           /*!< Channels of the output, interleaved */
+} app_audio_resampler_config_t;
+
+/**
+ * @brief Create a resampler
+ *
+ * The samples are converted to 16 bits, and the channels mixed to the output channels: with fewer input channels they
+ * are copied in turn, e.g. a mono input to both channels, and with more the input channel `i` is mixed into the output
+ * channel `i % out_channels`, e.g. the two channels of a stereo input into a mono output. The sample rate is then
+ * converted by a polyphase FIR filter, a windowed sinc in Q14 with its coefficients interpolated between 128 phases,
+ * so the rates do not need a common multiple. It is skipped if the rates are the same.
+ *
+ * @note The filter keeps the last input samples of a call for the next one, so a stream is resampled without clicks
+ *       at the boundaries of the calls
+ *
+ * @param config Resampler configuration
+ * @param ret_resampler Pointer to store the resampler handle
+ * @return ESP_OK on success, or an error code
+ */
+esp_err_t app_audio_resampler_create(const app_audio_resampler_config_t *config,
+                                     app_audio_resampler_handle_t *ret_resampler);
+
+/**
+ * @brief Get the largest output for an input, in bytes
+ */
+uint32_t app_audio_resampler_get_out_size(app_audio_resampler_handle_t resampler, uint32_t in_size);
+
+/**
+ * @brief Convert the input
+ *
+ * @param resampler Resampler handle
+ * @param in Input samples, whole frames of all the channels
+ * @param in_size Size of the input in bytes
+ * @param out Output buffer, of `app_audio_resampler_get_out_size()` bytes at least
+ * @param out_size Pointer to store the size of the output in bytes
+ * @return ESP_OK on success, or an error code
+ */
+esp_err_t app_audio_resampler_process(app_audio_resampler_handle_t resampler, const void *in, uint32_t in_size,
+                                      int16_t *out, uint32_t *out_size);
+
+/**
+ * @brief Drop the input samples kept, e.g. before a stream which does not follow the previous one
+ */
+void app_audio_resampler_reset(app_audio_resampler_handle_t resampler);
+
+/**
+ * @brief Destroy a resampler
+ */
+esp_err_t app_audio_resampler_destroy(app_audio_resampler_handle_t resampler);
+
+#ifdef __cplusplus
+}
+#endif
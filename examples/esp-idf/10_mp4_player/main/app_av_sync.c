@@ -0,0 +1,286 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#include "app_av_sync.h"
+
+static const char *TAG = "av_sync";
+
+/**
+ * @brief A/V sync context structure
+ *
+ * The clock is the media time `anchor_media_us` at the time `anchor_time_us`, and runs with the system timer from
+ * there. The audio moves the anchor on each write, and holds the clock at the end of the audio written.
+ */
+typedef struct app_av_sync_t {
+    app_av_sync_config_t config;    /*!< A/V sync configuration */
+    portMUX_TYPE lock;              /*!< Lock between the audio task and the video tasks */
+
+    /* Master clock */
+    bool clock_started;             /*!< Flag indicating if the clock is anchored */
+    int64_t anchor_media_us;        /*!< Media time played at anchor_time_us */
+    int64_t anchor_time_us;         /*!< System time of the anchor */
+
+    /* Audio clock */
+    bool audio_started;             /*!< Flag indicating if some audio is written */
+    int64_t audio_base_us;          /*!< Media time of the first sample written */
+    uint64_t audio_samples;         /*!< Samples written since audio_base_us */
+    uint32_t audio_sample_rate;     /*!< Sample rate of the audio written */
+    int64_t audio_end_us;           /*!< Media time of the end of the audio written */
+
+    /* Video */
+    bool frame_waiting;             /*!< Flag indicating if the current frame already waited */
+    uint32_t consecutive_drops;     /*!< Late frames dropped in a row */
+
+    /* Statistics */
+    app_av_sync_stats_t stats;      /*!< Statistics, without the average */
+    int64_t offset_sum_ms;          /*!< Sum of the offsets of the presented frames */
+} app_av_sync_t;
+
+static int64_t get_clock_us(app_av_sync_t *sync, int64_t now_us)
+{
+    int64_t elapsed_us = now_us - sync->anchor_time_us;
+    int64_t clock_us = sync->anchor_media_us + elapsed_us;
+
+    // The audio is not played beyond what was written. Once it stalled, e.g. at the end of the audio track, the clock
+    // runs on from the end of the audio rather than jump by the time it was held.
+    int64_t stall_us = (int64_t)sync->config.audio_stall_ms * 1000;
+    if (sync->audio_started && (clock_us > sync->audio_end_us)) {
+        clock_us = sync->audio_end_us + ((elapsed_us > stall_us) ? elapsed_us - stall_us : 0);
+    }
+
+    return clock_us;
+}
+
+static void anchor_clock(app_av_sync_t *sync, int64_t media_us, int64_t now_us)
+{
+    sync->anchor_media_us = media_us;
+    sync->anchor_time_us = now_us;
+    sync->clock_started = true;
+}
+
+/**
+ * @brief Offset of a frame from the clock, the first frame starts the clock if there is no audio yet
+ */
+static int64_t get_video_offset_us(app_av_sync_t *sync, uint32_t pts, int64_t now_us)
+{
+    int64_t pts_us = (int64_t)pts * 1000;
+
+    if (!sync->clock_started) {
+        anchor_clock(sync, pts_us, now_us);
+    }
+
+    return pts_us - get_clock_us(sync, now_us);
+}
+
+static bool is_discontinuous(app_av_sync_t *sync, int64_t offset_us)
+{
+    return llabs(offset_us) > (int64_t)sync->config.resync_ms * 1000;
+}
+
+static bool drop_late_frame(app_av_sync_t *sync, int64_t offset_us)
+{
+    if ((offset_us >= -(int64_t)sync->config.tolerance_ms * 1000) ||
+            (sync->consecutive_drops >= sync->config.max_drop_frames)) {
+        return false;
+    }
+
+    sync->consecutive_drops++;
+    sync->stats.frames_dropped++;
+    sync->frame_waiting = false;
+    return true;
+}
+
+static void present_frame(app_av_sync_t *sync, int64_t offset_us)
+{
+    int32_t offset_ms = (int32_t)(offset_us / 1000);
+
+    if (sync->stats.frames_presented == 0) {
+        sync->stats.offset_min_ms = offset_ms;
+        sync->stats.offset_max_ms = offset_ms;
+    } else if (offset_ms < sync->stats.offset_min_ms) {
+        sync->stats.offset_min_ms = offset_ms;
+    } else if (offset_ms > sync->stats.offset_max_ms) {
+        sync->stats.offset_max_ms = offset_ms;
+    }
+    sync->stats.offset_ms = offset_ms;
+    sync->stats.frames_presented++;
+    sync->offset_sum_ms += offset_ms;
+
+    sync->consecutive_drops = 0;
+    sync->frame_waiting = false;
+}
+
+esp_err_t app_av_sync_create(const app_av_sync_config_t *config, app_av_sync_handle_t *ret_sync)
+{
+    if (config == NULL || ret_sync == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_av_sync_t *sync = calloc(1, sizeof(app_av_sync_t));
+    if (sync == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate A/V sync context");
+        return ESP_ERR_NO_MEM;
+    }
+
+    sync->config = *config;
+    spinlock_initialize(&sync->lock);
+
+    ESP_LOGI(TAG, "A/V sync created: tolerance %" PRIu32 " ms, audio latency %" PRIu32 " ms",
+             config->tolerance_ms, config->audio_latency_ms);
+    *ret_sync = sync;
+    return ESP_OK;
+}
+
+void app_av_sync_reset(app_av_sync_handle_t sync)
+{
+    if (sync == NULL) {
+        return;
+    }
+
+    // The other members are set again when the clocks start
+    portENTER_CRITICAL(&sync->lock);
+    sync->clock_started = false;
+    sync->audio_started = false;
+    sync->frame_waiting = false;
+    sync->consecutive_drops = 0;
+    memset(&sync->stats, 0, sizeof(sync->stats));
+    sync->offset_sum_ms = 0;
+    portEXIT_CRITICAL(&sync->lock);
+}
+
+void app_av_sync_audio_written(app_av_sync_handle_t sync, uint32_t pts, uint32_t samples, uint32_t sample_rate,
+                               int64_t now_us)
+{
+    if (sync == NULL || sample_rate == 0) {
+        return;
+    }
+
+    int64_t pts_us = (int64_t)pts * 1000;
+
+    portENTER_CRITICAL(&sync->lock);
+
+    // The samples count from the last base, so that the clock does not drift with the rounding of the timestamps
+    if (!sync->audio_started || (sample_rate != sync->audio_sample_rate) ||
+            ((pts != 0) && is_discontinuous(sync, pts_us - sync->audio_end_us))) {
+        if (sync->audio_started) {
+            sync->stats.resyncs++;
+        }
+        sync->audio_started = true;
+        sync->audio_base_us = pts_us;
+        sync->audio_samples = 0;
+        sync->audio_sample_rate = sample_rate;
+        sync->stats.audio_master = true;
+    }
+
+    sync->audio_samples += samples;
+    sync->audio_end_us = sync->audio_base_us + (int64_t)(sync->audio_samples * 1000000 / sample_rate);
+
+    // The write returns once the samples are queued, behind the latency of the device
+    int64_t played_us = sync->audio_end_us - (int64_t)sync->config.audio_latency_ms * 1000;
+    if (played_us < sync->audio_base_us) {
+        played_us = sync->audio_base_us;
+    }
+    anchor_clock(sync, played_us, now_us);
+
+    portEXIT_CRITICAL(&sync->lock);
+}
+
+app_av_sync_action_t app_av_sync_check_video(app_av_sync_handle_t sync, uint32_t pts, int64_t now_us,
+                                             uint32_t *wait_ms)
+{
+    if (sync == NULL) {
+        return APP_AV_SYNC_PRESENT;
+    }
+
+    app_av_sync_action_t action = APP_AV_SYNC_PRESENT;
+
+    portENTER_CRITICAL(&sync->lock);
+
+    int64_t offset_us = get_video_offset_us(sync, pts, now_us);
+    if (is_discontinuous(sync, offset_us)) {
+        // Present the frame rather than wait or drop for long, the clock restarts from it without audio
+        sync->stats.resyncs++;
+        if (!sync->audio_started) {
+            anchor_clock(sync, (int64_t)pts * 1000, now_us);
+            offset_us = 0;
+        }
+        present_frame(sync, offset_us);
+    } else if (offset_us > 0) {
+        if (!sync->frame_waiting) {
+            sync->frame_waiting = true;
+            sync->stats.frames_repeated++;
+        }
+
+        // Check again within the tolerance, the audio clock may move meanwhile
+        uint32_t due_ms = (uint32_t)((offset_us + 999) / 1000);
+        if (wait_ms) {
+            *wait_ms = (due_ms < sync->config.tolerance_ms) ? due_ms : sync->config.tolerance_ms;
+        }
+        action = APP_AV_SYNC_WAIT;
+    } else if (drop_late_frame(sync, offset_us)) {
+        action = APP_AV_SYNC_DROP;
+    } else {
+        present_frame(sync, offset_us);
+    }
+
+    portEXIT_CRITICAL(&sync->lock);
+
+    return action;
+}
+
+bool app_av_sync_skip_video(app_av_sync_handle_t sync, uint32_t pts, int64_t now_us)
+{
+    if (sync == NULL) {
+        return false;
+    }
+
+    bool skip = false;
+
+    portENTER_CRITICAL(&sync->lock);
+
+    // The first frame starts the clock when it is presented, not when it is decoded
+    if (sync->clock_started) {
+        int64_t offset_us = get_video_offset_us(sync, pts, now_us);
+        skip = !is_discontinuous(sync, offset_us) && drop_late_frame(sync, offset_us);
+    }
+
+    portEXIT_CRITICAL(&sync->lock);
+
+    return skip;
+}
+
+esp_err_t app_av_sync_get_stats(app_av_sync_handle_t sync, app_av_sync_stats_t *stats)
+{
+    if (sync == NULL || stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&sync->lock);
+    *stats = sync->stats;
+    if (sync->stats.frames_presented > 0) {
+        stats->offset_avg_ms = (int32_t)(sync->offset_sum_ms / sync->stats.frames_presented);
+    }
+    portEXIT_CRITICAL(&sync->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t app_av_sync_destroy(app_av_sync_handle_t sync)
+{
+    if (sync == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    free(sync);
+    return ESP_OK;
+}
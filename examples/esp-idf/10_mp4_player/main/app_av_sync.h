@@ -0,0 +1,135 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A/V sync handle
+ */
+typedef struct app_av_sync_t* app_av_sync_handle_t;
+
+/**
+ * @brief Action for a video frame, decided against the master clock
+ */
+typedef enum {
+    APP_AV_SYNC_PRESENT,    /*!< The frame is due, present it */
+    APP_AV_SYNC_WAIT,       /*!< The frame is early, keep the previous frame on the panel and check again later */
+    APP_AV_SYNC_DROP,       /*!< The frame is late, drop it */
+} app_av_sync_action_t;
+
+/**
+ * @brief A/V sync configuration structure
+ */
+typedef struct {
+    uint32_t tolerance_ms;          /*!< Lateness within which a frame is still presented */
+    uint32_t max_drop_frames;       /*!< Consecutive late frames dropped before one is presented anyway */
+    uint32_t audio_latency_ms;      /*!< Audio written to the device but not played yet, e.g. in the DMA buffers */
+    uint32_t audio_stall_ms;        /*!< Time without audio written after which the clock runs on its own */
+    uint32_t resync_ms;             /*!< Offset beyond which the timestamps are discontinuous, e.g. after a seek */
+} app_av_sync_config_t;
+
+/**
+ * @brief Helper macro to create default A/V sync configuration
+ */
+#define APP_AV_SYNC_CONFIG_DEFAULT()    \
+    {                                   \
+        .tolerance_ms = 40,             \
+        .max_drop_frames = 4,           \
+        .audio_latency_ms = 30,         \
+        .audio_stall_ms = 200,          \
+        .resync_ms = 1000,              \
+    }
+
+/**
+ * @brief A/V sync statistics structure
+ *
+ * The offsets are the PTS of the presented frames minus the master clock, so a positive offset is a frame shown early.
+ */
+typedef struct {
+    bool audio_master;              /*!< True if the audio clock drives the video */
+    int32_t offset_ms;              /*!< Offset of the last presented frame */
+    int32_t offset_avg_ms;          /*!< Average offset of the presented frames */
+    int32_t offset_min_ms;          /*!< Minimum offset of the presented frames */
+    int32_t offset_max_ms;          /*!< Maximum offset of the presented frames */
+    uint32_t frames_presented;      /*!< Frames presented */
+    uint32_t frames_dropped;        /*!< Frames dropped because they were late */
+    uint32_t frames_repeated;       /*!< Frames which came early, the previous frame was shown meanwhile */
+    uint32_t resyncs;               /*!< Discontinuities of the timestamps */
+} app_av_sync_stats_t;
+
+/**
+ * @brief Create an A/V sync instance
+ *
+ * The audio clock is the master, it follows the samples written to the audio device. Until some audio is written, or
+ * once the audio stalls, the clock runs on the system timer from where it was.
+ *
+ * @note The time is passed by the caller to all the functions, in microseconds of `esp_timer_get_time()`
+ *
+ * @param config A/V sync configuration
+ * @param ret_sync Pointer to store the A/V sync handle
+ * @return ESP_OK on success, or an error code
+ */
+esp_err_t app_av_sync_create(const app_av_sync_config_t *config, app_av_sync_handle_t *ret_sync);
+
+/**
+ * @brief Restart the clock and the statistics, e.g. for a new stream or after a seek
+ */
+void app_av_sync_reset(app_av_sync_handle_t sync);
+
+/**
+ * @brief Advance the audio clock by the samples written to the audio device
+ *
+ * @param sync A/V sync handle
+ * @param pts Presentation time of the first sample in milliseconds, 0 if they follow the previous ones
+ * @param samples Number of samples per channel written
+ * @param sample_rate Sample rate of the audio
+ * @param now_us Current time, once the write returned
+ */
+void app_av_sync_audio_written(app_av_sync_handle_t sync, uint32_t pts, uint32_t samples, uint32_t sample_rate,
+                               int64_t now_us);
+
+/**
+ * @brief Decide the action for a decoded video frame
+ *
+ * @param sync A/V sync handle
+ * @param pts Presentation time of the frame in milliseconds
+ * @param now_us Current time
+ * @param wait_ms Time to wait before checking the frame again, for `APP_AV_SYNC_WAIT`
+ * @return Action for the frame
+ */
+app_av_sync_action_t app_av_sync_check_video(app_av_sync_handle_t sync, uint32_t pts, int64_t now_us,
+                                             uint32_t *wait_ms);
+
+/**
+ * @brief Check if a video frame is already too late to be decoded
+ *
+ * It follows the same rule as `app_av_sync_check_video()`, and counts the frame as dropped if it returns true.
+ *
+ * @note Only for frames decoded on their own, e.g. MJPEG. An H.264 frame must be decoded for the next ones, which refer
+ *       to it, so its picture is dropped after the decoding by `app_av_sync_check_video()`
+ */
+bool app_av_sync_skip_video(app_av_sync_handle_t sync, uint32_t pts, int64_t now_us);
+
+/**
+ * @brief Get the A/V sync statistics
+ */
+esp_err_t app_av_sync_get_stats(app_av_sync_handle_t sync, app_av_sync_stats_t *stats);
+
+/**
+ * @brief Destroy an A/V sync instance
+ */
+esp_err_t app_av_sync_destroy(app_av_sync_handle_t sync);
+
+#ifdef __cplusplus
+}
+#endif
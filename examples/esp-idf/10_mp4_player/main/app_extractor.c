@@ -8,11 +8,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
-#include <fcntl.h>      // Add support for open, O_RDONLY, etc.
-#include <unistd.h>     // Add support for read, close, etc.
-#include <sys/types.h>  // Add support for lseek, etc.
 #include <math.h>
-#include <errno.h>
 #include "esp_log.h"
 #include "esp_err.h"
 #include "esp_heap_caps.h"
@@ -20,6 +16,7 @@
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "freertos/queue.h"
+#include "freertos/event_groups.h"
 
 #include "app_extractor.h"
 #include "esp_extractor.h"
@@ -74,19 +71,24 @@ static const char *TAG = "app_extractor";
     } \
 } while (0)
 
-/* Audio frame item for queue */
+#define PRELOAD_DONE_BIT        (1 << 0)  /*!< Preload of the next file done */
+
+/**
+ * @brief Audio format of a stream, the audio decoder is kept while it does not change
+ */
 typedef struct {
-    uint8_t *buffer;
-    uint32_t size;
-    uint32_t pts;
-} audio_frame_item_t;
+    extractor_audio_format_t format;
+    uint32_t                 sample_rate;
+    uint8_t                  channels;
+    uint8_t                  bits;
+} audio_params_t;
 
 /**
  * @brief App extractor context structure
  */
 typedef struct app_extractor_t {
     esp_extractor_handle_t  extractor;
-    int                     file;
+    app_file_source_handle_t file_source;   // Read-ahead of the media file
     app_extractor_frame_cb_t frame_cb;
     bool                    extract_video;
     bool                    extract_audio;
@@ -106,11 +108,17 @@ typedef struct app_extractor_t {
     extractor_audio_format_t audio_format;
     bool                    eos_reached;
 
-    // A/V sync support (Kconfig controlled)
-    bool                   sync_enabled;
-    uint32_t               sync_threshold_ms;
-    SemaphoreHandle_t      sync_mutex;
-    int64_t                base_time;
+    // Parameter sets of an H.264 stream in Annex-B, put before the first frame after a start or a seek
+    uint8_t                *video_config;
+    uint32_t               video_config_size;
+    uint8_t                video_nal_length_size;   // Length field of the NAL units of the MP4 frames
+    bool                   video_config_pending;
+
+    // A/V sync, the audio written to the device drives its clock
+    app_av_sync_handle_t   av_sync;
+
+    // Audio decoded ahead of the device, converted to its format
+    app_audio_output_handle_t audio_output;
 
     // Audio decoder
     esp_audio_simple_dec_handle_t audio_decoder;
@@ -119,49 +127,67 @@ typedef struct app_extractor_t {
     uint32_t               audio_buffer_size;
     esp_codec_dev_handle_t audio_dev;
 
+    // Output frames, handed to the decoders without a copy
+    app_frame_pool_handle_t frame_pool;
+
+    // Seek index of the media file, loaded or built by a full playback
+    app_media_index_handle_t index;
+    bool                   index_building;
+    char                   *media_path;
+
+    // Next file, opened and parsed in the background while the current one plays
+    SemaphoreHandle_t      preload_lock;
+    EventGroupHandle_t     preload_events;
+    app_file_source_handle_t next_source;   // Swapped with the file source of the current file at the switch
+    esp_extractor_handle_t next_extractor;
+    char                   *next_path;
+    esp_err_t              next_result;
+    bool                   preload_pending;
+    char                   *path;           // Path of the current file if it was preloaded, used by the extractor
+    uint32_t               pts_base;        // Start of the current file on the timeline of the files played in a row
+    bool                   video_started;
+    bool                   audio_started;
+
+    // Audio format of the audio decoder
+    audio_params_t         decoder_params;
+
     // Audio task and queue
     TaskHandle_t           audio_task_handle;
     QueueHandle_t          audio_queue;
     bool                   audio_task_running;
-
-    // Frame rate control
-    uint32_t               frame_interval_ms;
-    int64_t                last_frame_time;
 } app_extractor_t;
 
 /* Forward declarations */
 static esp_err_t process_audio_frame(app_extractor_t *extractor, uint8_t *buffer, uint32_t buffer_size, uint32_t pts);
 
 /**
- * @brief File I/O wrapper functions for ESP Extractor
+ * @brief File I/O wrapper functions for ESP Extractor, the reads are served by the read-ahead of the file source
  */
 static void *_file_open(char *url, void *ctx)
 {
-    int fd = open(url, O_RDONLY);
-    if (fd < 0) {
-        ESP_LOGE(TAG, "Failed to open file: %s", url);
+    app_file_source_handle_t source = (app_file_source_handle_t)ctx;
+    if (app_file_source_open(source, url) != ESP_OK) {
         return NULL;
     }
-    return (void*)(intptr_t)fd;
+    return source;
 }
 
 static int _file_read(void *data, uint32_t size, void *ctx)
 {
-    int fd = (int)(intptr_t)ctx;
-    ssize_t bytes_read = read(fd, data, size);
-    if (bytes_read < 0) {
-        ESP_LOGE(TAG, "File read error: %d", errno);
-        return 0;
-    }
-    return (int)bytes_read;
+    return app_file_source_read((app_file_source_handle_t)ctx, data, size);
+}
+
+static int _file_read_abort(void *ctx)
+{
+    app_file_source_abort((app_file_source_handle_t)ctx);
+    return 0;
 }
 
 static int _file_seek(uint32_t position, void *ctx)
 {
-    int fd = (int)(intptr_t)ctx;
-    off_t result = lseek(fd, position, SEEK_SET);
-    if (result < 0) {
-        ESP_LOGE(TAG, "File seek error: %d", errno);
+    esp_err_t ret = app_file_source_seek((app_file_source_handle_t)ctx, position);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "File seek error: %d", ret);
         return -1;
     }
     return 0;
@@ -169,22 +195,12 @@ static int _file_seek(uint32_t position, void *ctx)
 
 static int _file_close(void *ctx)
 {
-    int fd = (int)(intptr_t)ctx;
-    int result = close(fd);
-    if (result < 0) {
-        ESP_LOGE(TAG, "File close error: %d", errno);
-        return -1;
-    }
-    return 0;
+    return (app_file_source_close((app_file_source_handle_t)ctx) == ESP_OK) ? 0 : -1;
 }
 
 static uint32_t _file_size(void *ctx)
 {
-    int fd = (int)(intptr_t)ctx;
-    off_t current = lseek(fd, 0, SEEK_CUR);
-    off_t end = lseek(fd, 0, SEEK_END);
-    lseek(fd, current, SEEK_SET);
-    return end <= 0 ? 0 : (uint32_t)end;
+    return app_file_source_get_size((app_file_source_handle_t)ctx);
 }
 
 /**
@@ -193,20 +209,20 @@ static uint32_t _file_size(void *ctx)
 static void audio_task(void *arg)
 {
     app_extractor_t *extractor = (app_extractor_t *)arg;
-    audio_frame_item_t *frame_item;
+    app_frame_t *frame;
     uint32_t processed_frames = 0;
 
     while (extractor->audio_task_running) {
-        if (xQueueReceive(extractor->audio_queue, &frame_item,
+        if (xQueueReceive(extractor->audio_queue, &frame,
                           pdMS_TO_TICKS(AUDIO_QUEUE_TIMEOUT_MS))) {
 
-            esp_err_t ret = process_audio_frame(extractor, frame_item->buffer,
-                                                frame_item->size, frame_item->pts);
+            esp_err_t ret = process_audio_frame(extractor, frame->buffer,
+                                                frame->size, frame->pts);
             if (ret != ESP_OK) {
                 ESP_LOGE(TAG, "Failed to process audio frame: %d", ret);
             }
 
-            free(frame_item);  // Free entire structure
+            app_frame_unref(frame);  // Return the buffer to the frame pool
             processed_frames++;
 
             // Log every 100 frames to reduce overhead
@@ -248,45 +264,105 @@ static esp_err_t start_audio_task(app_extractor_t *extractor)
 
 /**
  * @brief Stop audio processing task and clean up queue
+ *
+ * @param extractor Extractor
+ * @param flush Drop the audio decoded ahead too, otherwise the device plays it out, e.g. at a change of audio format
  */
-static void stop_audio_task(app_extractor_t *extractor)
+static void stop_audio_task(app_extractor_t *extractor, bool flush)
 {
+    flush = flush && (extractor->audio_output != NULL);
     if (!extractor->audio_task_running) {
+        if (flush) {
+            app_audio_output_flush(extractor->audio_output);
+        }
         return;
     }
 
     extractor->audio_task_running = false;
 
+    // The task may wait for room in the ring, the flush releases it
+    if (flush) {
+        app_audio_output_flush(extractor->audio_output);
+    }
+
     // Wait for task to exit
     while (extractor->audio_task_handle != NULL) {
         vTaskDelay(pdMS_TO_TICKS(10));
     }
 
     // Clean up remaining audio frames in queue
-    audio_frame_item_t *frame_item;
-    while (xQueueReceive(extractor->audio_queue, &frame_item, 0)) {
-        free(frame_item);
+    app_frame_t *frame;
+    while (xQueueReceive(extractor->audio_queue, &frame, 0)) {
+        app_frame_unref(frame);
+    }
+
+    if (flush) {
+        app_audio_output_flush(extractor->audio_output);
     }
 }
 
 /**
- * @brief Control frame rate for proper playback timing
+ * @brief Wait for the audio task to take the audio frames queued
  */
-static void control_frame_rate(app_extractor_t *extractor)
+static void drain_audio_queue(app_extractor_t *extractor)
 {
-    int64_t current_time = esp_timer_get_time() / 1000;
+    int64_t start_us = esp_timer_get_time();
+    while (extractor->audio_task_running && (uxQueueMessagesWaiting(extractor->audio_queue) > 0) &&
+            (esp_timer_get_time() - start_us < AUDIO_DRAIN_TIMEOUT_MS * 1000)) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
 
-    // Calculate target time for this frame
-    int64_t target_time = extractor->last_frame_time + extractor->frame_interval_ms;
+/**
+ * @brief Get the audio format of the current stream
+ */
+static void get_audio_params(app_extractor_t *extractor, audio_params_t *params)
+{
+    params->format = extractor->audio_format;
+    params->sample_rate = extractor->audio_sample_rate;
+    params->channels = extractor->audio_channels;
+    params->bits = extractor->audio_bits;
+}
 
-    if (current_time < target_time) {
-        uint32_t delay = target_time - current_time;
-        if (delay > 0 && delay < 1000) { // Sanity check: delay should be reasonable
-            vTaskDelay(pdMS_TO_TICKS(delay));
-        }
-    }
+/**
+ * @brief Read the audio format of an opened stream
+ *
+ * @return true if the stream has audio
+ */
+static bool read_audio_params(esp_extractor_handle_t handle, audio_params_t *params)
+{
+    uint16_t audio_num = 0;
+    extractor_stream_info_t stream_info = {0};
+    if ((esp_extractor_get_stream_num(handle, EXTRACTOR_STREAM_TYPE_AUDIO, &audio_num) != ESP_OK) || (audio_num == 0) ||
+            (esp_extractor_get_stream_info(handle, EXTRACTOR_STREAM_TYPE_AUDIO, 0, &stream_info) != ESP_OK)) {
+        return false;
+    }
+
+    extractor_audio_stream_info_t *audio_info = &stream_info.stream_info.audio_info;
+    params->format = (audio_info->format == EXTRACTOR_AUDIO_FORMAT_NONE) ? EXTRACTOR_AUDIO_FORMAT_PCM :
+                     audio_info->format;
+    params->sample_rate = audio_info->sample_rate;
+    params->channels = audio_info->channel;
+    params->bits = audio_info->bits_per_sample;
+    return true;
+}
 
-    extractor->last_frame_time = esp_timer_get_time() / 1000;
+static bool audio_params_equal(const audio_params_t *a, const audio_params_t *b)
+{
+    return (a->format == b->format) && (a->sample_rate == b->sample_rate) && (a->channels == b->channels) &&
+           (a->bits == b->bits);
+}
+
+/**
+ * @brief Close the audio decoder, for a stream of another audio format
+ */
+static void close_audio_decoder(app_extractor_t *extractor)
+{
+    if (extractor->audio_decoder != NULL) {
+        esp_audio_dec_close(extractor->audio_decoder);
+        extractor->audio_decoder = NULL;
+    }
+    extractor->audio_decoder_open = false;
 }
 
 /**
@@ -381,13 +457,8 @@ static esp_err_t init_audio_decoder(app_extractor_t *extractor)
     }
 
     // Close existing decoder if any
-    if (extractor->audio_decoder != NULL) {
-        if (extractor->audio_decoder_open) {
-            esp_audio_dec_close(extractor->audio_decoder);
-        }
-        extractor->audio_decoder = NULL;
-        extractor->audio_decoder_open = false;
-    }
+    close_audio_decoder(extractor);
+    get_audio_params(extractor, &extractor->decoder_params);
 
     esp_err_t ret = ESP_OK;
 
@@ -498,40 +569,34 @@ static esp_err_t init_audio_decoder(app_extractor_t *extractor)
 }
 
 /**
- * @brief Process audio frame with optimized timing control
+ * @brief Get the format of the decoded audio of the stream
+ */
+static void get_audio_fs(app_extractor_t *extractor, esp_codec_dev_sample_info_t *fs)
+{
+    memset(fs, 0, sizeof(esp_codec_dev_sample_info_t));
+    fs->sample_rate = extractor->audio_sample_rate;
+    fs->channel = extractor->audio_channels;
+    fs->bits_per_sample = extractor->audio_bits;
+}
+
+/**
+ * @brief Process audio frame, paced by the ring of the audio output
+ *
+ * The audio dropped by a flush meanwhile is not an error.
  */
 static esp_err_t process_audio_frame(app_extractor_t *extractor, uint8_t *buffer, uint32_t buffer_size, uint32_t pts)
 {
-    if (extractor->audio_dev == NULL) {
+    if (extractor->audio_output == NULL) {
         return ESP_OK;
     }
 
+    esp_codec_dev_sample_info_t fs;
+    get_audio_fs(extractor, &fs);
+
     // PCM direct playback
     if (extractor->audio_format == EXTRACTOR_AUDIO_FORMAT_PCM) {
-        static bool first_frame = true;
-        if (first_frame) {
-            esp_codec_dev_sample_info_t fs = {
-                .sample_rate = extractor->audio_sample_rate,
-                .channel = extractor->audio_channels,
-                .bits_per_sample = extractor->audio_bits
-            };
-            esp_codec_dev_open(extractor->audio_dev, &fs);
-            first_frame = false;
-        }
-
-        esp_err_t ret = esp_codec_dev_write(extractor->audio_dev, buffer, buffer_size);
-
-        // Precise timing control based on audio frame duration
-        if (ret == ESP_OK) {
-            uint32_t bytes_per_sample = extractor->audio_channels * (extractor->audio_bits / 8);
-            uint32_t frame_duration_ms = (buffer_size * 1000) / (extractor->audio_sample_rate * bytes_per_sample);
-
-            // Use 60% of frame duration to prevent audio buffer underrun while maintaining timing
-            if (frame_duration_ms > 0 && frame_duration_ms < 50) {
-                vTaskDelay(pdMS_TO_TICKS(frame_duration_ms * 6 / 10));
-            }
-        }
-        return ret;
+        esp_err_t ret = app_audio_output_write(extractor->audio_output, &fs, pts, buffer, buffer_size);
+        return (ret == ESP_ERR_INVALID_STATE) ? ESP_OK : ret;
     }
 
     // Initialize decoder for compressed audio
@@ -587,31 +652,14 @@ static esp_err_t process_audio_frame(app_extractor_t *extractor, uint8_t *buffer
         }
 
         if (out_frame.decoded_size > 0) {
-            // Configure audio device on first decoded frame
-            static bool first_decoded = true;
-            if (first_decoded) {
-                esp_codec_dev_sample_info_t fs = {
-                    .sample_rate = extractor->audio_sample_rate,
-                    .channel = extractor->audio_channels,
-                    .bits_per_sample = extractor->audio_bits
-                };
-                esp_codec_dev_open(extractor->audio_dev, &fs);
-                first_decoded = false;
+            // The write blocks while the ring is ahead of the device, the PTS is the one of the first samples of
+            // the frame, the next ones follow
+            esp_err_t write_ret = app_audio_output_write(extractor->audio_output, &fs, (total_decoded == 0) ? pts : 0,
+                                                         out_frame.buffer, out_frame.decoded_size);
+            if (write_ret == ESP_ERR_INVALID_STATE) {
+                return ESP_OK;
             }
-
-            esp_err_t write_ret = esp_codec_dev_write(extractor->audio_dev, out_frame.buffer, out_frame.decoded_size);
             total_decoded += out_frame.decoded_size;
-
-            // Optimized timing control for decoded audio
-            if (write_ret == ESP_OK) {
-                uint32_t bytes_per_sample = extractor->audio_channels * (extractor->audio_bits / 8);
-                uint32_t decoded_duration_ms = (out_frame.decoded_size * 1000) / (extractor->audio_sample_rate * bytes_per_sample);
-
-                // Use 40% delay for decoded audio to balance timing and responsiveness
-                if (decoded_duration_ms > 0 && decoded_duration_ms < 50) {
-                    vTaskDelay(pdMS_TO_TICKS(decoded_duration_ms * 4 / 10));
-                }
-            }
         }
 
         // Advance buffer pointer
@@ -626,6 +674,280 @@ static esp_err_t process_audio_frame(app_extractor_t *extractor, uint8_t *buffer
     return (total_decoded > 0) ? ESP_OK : ESP_FAIL;
 }
 
+/**
+ * @brief Create the audio output, which the audio is decoded ahead into
+ */
+static esp_err_t create_audio_output(esp_codec_dev_handle_t audio_dev, app_audio_output_handle_t *ret_output)
+{
+    app_audio_output_config_t config = APP_AUDIO_OUTPUT_CONFIG_DEFAULT();
+    config.dev = audio_dev;
+    config.sample_rate = CONFIG_HDMI_AUDIO_OUTPUT_RATE;
+    config.channels = CONFIG_HDMI_AUDIO_OUTPUT_CHANNELS;
+    config.ring_ms = CONFIG_HDMI_AUDIO_RING_MS;
+    config.task_priority = AUDIO_OUTPUT_TASK_PRIORITY;
+    config.task_stack_size = AUDIO_OUTPUT_TASK_STACK_SIZE;
+    return app_audio_output_create(&config, ret_output);
+}
+
+/**
+ * @brief Release the seek index of the media file
+ */
+static void close_media_index(app_extractor_t *extractor)
+{
+    if (extractor->index != NULL) {
+        app_media_index_destroy(extractor->index);
+        extractor->index = NULL;
+    }
+    extractor->index_building = false;
+
+    free(extractor->media_path);
+    extractor->media_path = NULL;
+}
+
+/**
+ * @brief Stop building the seek index, the frames extracted are not the whole stream anymore
+ */
+static void abandon_media_index(app_extractor_t *extractor)
+{
+    if (extractor->index_building) {
+        app_media_index_destroy(extractor->index);
+        extractor->index = NULL;
+        extractor->index_building = false;
+    }
+}
+
+/**
+ * @brief Load the seek index of the media file, or start to build it
+ */
+static void open_media_index(app_extractor_t *extractor, const char *filename)
+{
+#if CONFIG_HDMI_MEDIA_INDEX_ENABLED
+    close_media_index(extractor);
+
+    extractor->media_path = strdup(filename);
+    if (extractor->media_path == NULL) {
+        return;
+    }
+
+    int64_t start_us = esp_timer_get_time();
+    if (app_media_index_load(filename, &extractor->index) == ESP_OK) {
+        ESP_LOGI(TAG, "Seek index loaded: %" PRIu32 " frames in %" PRId64 " us",
+                 app_media_index_get_frame_count(extractor->index), esp_timer_get_time() - start_us);
+        return;
+    }
+
+    // The index is built by this playback if it goes to the end, the key frames are known for MJPEG only
+    if (!extractor->extract_video || !extractor->has_video ||
+            (extractor->video_format != EXTRACTOR_VIDEO_FORMAT_MJPEG)) {
+        return;
+    }
+
+    app_media_index_info_t info = {
+        .width = extractor->video_width,
+        .height = extractor->video_height,
+        .fps = extractor->video_fps,
+        .duration = extractor->video_duration,
+        .audio_sample_rate = extractor->has_audio ? extractor->audio_sample_rate : 0,
+        .audio_channels = extractor->audio_channels,
+        .audio_bits = extractor->audio_bits,
+        .audio_duration = extractor->audio_duration,
+    };
+    uint32_t fps = (extractor->video_fps > 0) ? extractor->video_fps : DEFAULT_VIDEO_FPS;
+    uint32_t frame_hint = (uint32_t)((uint64_t)extractor->video_duration * fps / 1000) + fps;
+    if (app_media_index_create(&info, frame_hint, &extractor->index) == ESP_OK) {
+        extractor->index_building = true;
+    }
+#endif
+}
+
+/**
+ * @brief Store the seek index built, once the whole stream is extracted
+ */
+static void save_media_index(app_extractor_t *extractor)
+{
+    if (!extractor->index_building) {
+        return;
+    }
+
+    // The index is kept for the seeks of this playback
+    extractor->index_building = false;
+
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t ret = app_media_index_save(extractor->index, extractor->media_path);
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "Seek index saved: %" PRIu32 " frames in %" PRId64 " us",
+                 app_media_index_get_frame_count(extractor->index), esp_timer_get_time() - start_us);
+    } else {
+        ESP_LOGW(TAG, "Failed to save seek index: %d", ret);
+    }
+}
+
+/**
+ * @brief PTS of a frame on the timeline of the files played in a row
+ *
+ * A PTS of 0 past the first frame of a stream means no PTS, it stays so.
+ */
+static uint32_t timeline_pts(app_extractor_t *extractor, uint32_t pts, bool *started)
+{
+    bool first = !*started;
+    *started = true;
+    return (pts != 0 || first) ? extractor->pts_base + pts : 0;
+}
+
+/**
+ * @brief End of the current file, where the next one starts
+ */
+static uint32_t get_end_pts(app_extractor_t *extractor)
+{
+    uint32_t fps = (extractor->video_fps > 0) ? extractor->video_fps : DEFAULT_VIDEO_FPS;
+    uint32_t end = extractor->last_video_pts + 1000 / fps;
+    if (extractor->video_duration > end) {
+        end = extractor->video_duration;
+    }
+    if (extractor->has_audio && (extractor->audio_duration > end)) {
+        end = extractor->audio_duration;
+    }
+    if (extractor->last_audio_pts > end) {
+        end = extractor->last_audio_pts;
+    }
+    return end;
+}
+
+/**
+ * @brief Check for an Annex-B start code with 4 bytes, which is no NAL unit length in practice
+ */
+static bool is_annexb_frame(const uint8_t *data, uint32_t size)
+{
+    return (size >= 4) && (data[0] == 0) && (data[1] == 0) && (data[2] == 0) && (data[3] == 1);
+}
+
+/**
+ * @brief Replace the 4 bytes lengths of the NAL units of a frame with start codes, in place
+ *
+ * The frame is left as is if the lengths do not add up to its size.
+ */
+static void h264_frame_to_annexb(uint8_t *data, uint32_t size)
+{
+    uint32_t pos = 0;
+    while (pos + 4 <= size) {
+        uint32_t nal_size = ((uint32_t)data[pos] << 24) | ((uint32_t)data[pos + 1] << 16) |
+                            ((uint32_t)data[pos + 2] << 8) | data[pos + 3];
+        if (nal_size > size - pos - 4) {
+            return;
+        }
+        pos += 4 + nal_size;
+    }
+    if (pos != size) {
+        return;
+    }
+
+    for (pos = 0; pos < size;) {
+        uint32_t nal_size = ((uint32_t)data[pos] << 24) | ((uint32_t)data[pos + 1] << 16) |
+                            ((uint32_t)data[pos + 2] << 8) | data[pos + 3];
+        data[pos] = 0;
+        data[pos + 1] = 0;
+        data[pos + 2] = 0;
+        data[pos + 3] = 1;
+        pos += 4 + nal_size;
+    }
+}
+
+/**
+ * @brief Keep the parameter sets of an H.264 stream in Annex-B, for the software decoder
+ *
+ * The MP4 stores them in an AVC decoder configuration record, with the size of the NAL unit lengths of its frames,
+ * the other containers as Annex-B already.
+ */
+static void set_video_config(app_extractor_t *extractor, const uint8_t *spec_info, uint32_t spec_info_len)
+{
+    free(extractor->video_config);
+    extractor->video_config = NULL;
+    extractor->video_config_size = 0;
+    extractor->video_nal_length_size = 0;
+    extractor->video_config_pending = false;
+    if ((extractor->video_format != EXTRACTOR_VIDEO_FORMAT_H264) || (spec_info == NULL) || (spec_info_len < 7)) {
+        return;
+    }
+
+    if (spec_info[0] != 1) {
+        extractor->video_config = malloc(spec_info_len);
+        if (extractor->video_config != NULL) {
+            memcpy(extractor->video_config, spec_info, spec_info_len);
+            extractor->video_config_size = spec_info_len;
+            extractor->video_config_pending = true;
+        }
+        return;
+    }
+
+    // Each NAL unit grows from a length of 2 bytes to a start code of 4, in a record of 7 bytes at least
+    uint8_t *config = malloc(spec_info_len * 2);
+    if (config == NULL) {
+        return;
+    }
+    extractor->video_nal_length_size = (spec_info[4] & 0x03) + 1;
+
+    static const uint8_t start_code[4] = {0, 0, 0, 1};
+    uint32_t pos = 5;
+    uint32_t size = 0;
+    for (int set = 0; set < 2; set++) {
+        // The SPS count in the low 5 bits, then the PPS count after the SPS
+        uint32_t count = (set == 0) ? (spec_info[pos] & 0x1F) : spec_info[pos];
+        pos++;
+        for (uint32_t i = 0; i < count; i++) {
+            if (pos + 2 > spec_info_len) {
+                break;
+            }
+            uint32_t nal_size = ((uint32_t)spec_info[pos] << 8) | spec_info[pos + 1];
+            pos += 2;
+            if (nal_size > spec_info_len - pos) {
+                break;
+            }
+            memcpy(config + size, start_code, sizeof(start_code));
+            memcpy(config + size + 4, spec_info + pos, nal_size);
+            size += 4 + nal_size;
+            pos += nal_size;
+        }
+        if (pos >= spec_info_len) {
+            break;
+        }
+    }
+
+    if (size == 0) {
+        free(config);
+        return;
+    }
+    extractor->video_config = config;
+    extractor->video_config_size = size;
+    extractor->video_config_pending = true;
+}
+
+/**
+ * @brief Turn an H.264 frame into Annex-B, with the parameter sets before the first frame after a start or a seek
+ *
+ * The decoder then takes the frames of any container, and each file or seek starts as a stream of its own.
+ */
+static void prepare_h264_frame(app_extractor_t *extractor, extractor_frame_info_t *frame)
+{
+    if (!is_annexb_frame(frame->frame_buffer, frame->frame_size) && (extractor->video_nal_length_size == 4)) {
+        h264_frame_to_annexb(frame->frame_buffer, frame->frame_size);
+    }
+    if (!extractor->video_config_pending) {
+        return;
+    }
+
+    uint32_t size = extractor->video_config_size + frame->frame_size;
+    uint8_t *buffer = mem_pool_realloc(app_frame_pool_get_mem_pool(extractor->frame_pool), frame->frame_buffer, size);
+    if (buffer == NULL) {
+        ESP_LOGW(TAG, "No memory for the H.264 parameter sets, waiting for the next frame");
+        return;
+    }
+    memmove(buffer + extractor->video_config_size, buffer, frame->frame_size);
+    memcpy(buffer, extractor->video_config, extractor->video_config_size);
+    frame->frame_buffer = buffer;
+    frame->frame_size = size;
+    extractor->video_config_pending = false;
+}
+
 /**
  * @brief Process extracted frame with optimized routing
  */
@@ -633,6 +955,7 @@ static esp_err_t process_frame(extractor_frame_info_t *frame, app_extractor_t *e
 {
     if (frame->eos) {
         extractor->eos_reached = true;
+        save_media_index(extractor);
         return ESP_ERR_NOT_FOUND;
     }
 
@@ -644,11 +967,31 @@ static esp_err_t process_frame(extractor_frame_info_t *frame, app_extractor_t *e
             extractor->last_video_pts = frame->pts;
         }
 
+        if (extractor->index_building &&
+                (app_media_index_add_frame(extractor->index, frame->pts, frame->frame_size, true) != ESP_OK)) {
+            ESP_LOGW(TAG, "Frames out of order, no seek index for this file");
+            abandon_media_index(extractor);
+        }
+
+        // The frames are paced by the present stage of the stream adapter, which blocks this callback when its
+        // queues are full
         if (extractor->extract_video && frame->frame_buffer &&
                 frame->frame_size > 0 && extractor->frame_cb) {
+            if (extractor->video_format == EXTRACTOR_VIDEO_FORMAT_H264) {
+                prepare_h264_frame(extractor, frame);
+            }
 
-            control_frame_rate(extractor);
-            ret = extractor->frame_cb(frame->frame_buffer, frame->frame_size, true, frame->pts);
+            // The frame owns the buffer from now on, even if it cannot be wrapped
+            app_frame_t *video_frame = app_frame_pool_wrap(extractor->frame_pool, frame->frame_buffer,
+                                                           frame->frame_size,
+                                                           timeline_pts(extractor, frame->pts,
+                                                                        &extractor->video_started), true);
+            frame->frame_buffer = NULL;
+            if (video_frame != NULL) {
+                ret = extractor->frame_cb(video_frame);
+            } else {
+                ESP_LOGW(TAG, "No free frame descriptor, video frame dropped");
+            }
         }
         break;
 
@@ -660,19 +1003,19 @@ static esp_err_t process_frame(extractor_frame_info_t *frame, app_extractor_t *e
         if (extractor->extract_audio && extractor->audio_dev &&
                 frame->frame_buffer && frame->frame_size > 0) {
 
-            // Optimized audio frame queuing
-            audio_frame_item_t *frame_item = malloc(sizeof(audio_frame_item_t) + frame->frame_size);
-            if (frame_item) {
-                frame_item->buffer = (uint8_t*)(frame_item + 1);  // Buffer follows struct
-                frame_item->size = frame->frame_size;
-                frame_item->pts = frame->pts;
-                memcpy(frame_item->buffer, frame->frame_buffer, frame->frame_size);
-
-                if (xQueueSend(extractor->audio_queue, &frame_item, 0) != pdTRUE) {
-                    free(frame_item);  // Drop frame if queue full
+            // Queue the buffer of the extractor itself, the audio task releases it
+            app_frame_t *audio_frame = app_frame_pool_wrap(extractor->frame_pool, frame->frame_buffer,
+                                                           frame->frame_size,
+                                                           timeline_pts(extractor, frame->pts,
+                                                                        &extractor->audio_started), false);
+            frame->frame_buffer = NULL;
+            if (audio_frame) {
+                // Wait for the audio task a little, a dropped frame would be a jump of the audio clock
+                if (xQueueSend(extractor->audio_queue, &audio_frame, pdMS_TO_TICKS(AUDIO_QUEUE_TIMEOUT_MS)) != pdTRUE) {
+                    app_frame_unref(audio_frame);  // Drop frame if queue full
                 }
             } else {
-                ESP_LOGW(TAG, "Audio frame memory allocation failed");
+                ESP_LOGW(TAG, "No free frame descriptor, audio frame dropped");
             }
         }
         break;
@@ -681,9 +1024,9 @@ static esp_err_t process_frame(extractor_frame_info_t *frame, app_extractor_t *e
         break;
     }
 
-    // Release frame buffer back to output pool (prevent memory leak)
+    // Release the frame buffer not handed over back to output pool (prevent memory leak)
     if (frame->frame_buffer) {
-        mem_pool_free(esp_extractor_get_output_pool(extractor->extractor), frame->frame_buffer);
+        mem_pool_free(app_frame_pool_get_mem_pool(extractor->frame_pool), frame->frame_buffer);
         frame->frame_buffer = NULL;
     }
 
@@ -694,7 +1037,7 @@ static esp_err_t process_frame(extractor_frame_info_t *frame, app_extractor_t *e
  * @brief Validate MPEG format compatibility for ESP32-P4
  *
  * This function ensures that only MPEG-compatible formats are processed:
- * - Video: MJPEG only (ESP32-P4 hardware JPEG decoder limitation)
+ * - Video: MJPEG (ESP32-P4 hardware JPEG decoder) or H.264 (software decoder)
  * - Audio: MPEG-related formats (AAC, MP3, etc.)
  *
  * @param extractor App extractor handle
@@ -709,8 +1052,11 @@ static esp_err_t validate_mpeg_compatibility(app_extractor_t *extractor)
             break;
 
         case EXTRACTOR_VIDEO_FORMAT_H264:
-            ESP_LOGE(TAG, "Video: H.264 format not supported - use MJPEG instead");
-            return ESP_ERR_NOT_SUPPORTED;
+            if (extractor->video_config == NULL) {
+                ESP_LOGW(TAG, "Video: H.264 without parameter sets, the frames must carry them");
+            }
+            ESP_LOGI(TAG, "Video: H.264 format - software decoder");
+            break;
 
         default:
             ESP_LOGE(TAG, "Video: Unsupported format %d", extractor->video_format);
@@ -805,6 +1151,7 @@ static esp_err_t get_stream_info(app_extractor_t *extractor)
         extractor->video_height = video_info->height;
         extractor->video_fps = video_info->fps;
         extractor->video_duration = stream_info.duration;
+        set_video_config(extractor, stream_info.spec_info, stream_info.spec_info_len);
 
         ESP_LOGI(TAG, "Video: format=%d, %" PRIu32 "x%" PRIu32 ", %" PRIu32 "fps",
                  (int)video_info->format, video_info->width, video_info->height,
@@ -817,6 +1164,130 @@ static esp_err_t get_stream_info(app_extractor_t *extractor)
     return ESP_OK;
 }
 
+/**
+ * @brief Create a read-ahead of the media file
+ */
+static esp_err_t create_file_source(app_file_source_handle_t *ret_source)
+{
+    app_file_source_config_t source_config = APP_FILE_SOURCE_CONFIG_DEFAULT();
+    source_config.chunk_size = EXTRACTOR_READ_CHUNK_SIZE;
+    source_config.chunk_num = EXTRACTOR_READ_CHUNK_NUM;
+    source_config.task_priority = EXTRACTOR_READ_TASK_PRIORITY;
+    return app_file_source_create(&source_config, ret_source);
+}
+
+/**
+ * @brief Open a media file on a file source and parse its stream information
+ */
+static esp_err_t open_stream(app_extractor_t *extractor, app_file_source_handle_t source, const char *filename,
+                             esp_extractor_handle_t *ret_handle)
+{
+    // Set extraction mask based on what we want to extract
+    uint8_t extract_mask = 0;
+    if (extractor->extract_video) {
+        extract_mask |= ESP_EXTRACT_MASK_VIDEO;
+    }
+    if (extractor->extract_audio) {
+        extract_mask |= ESP_EXTRACT_MASK_AUDIO;
+    }
+
+    // Configure extractor with larger pool size
+    esp_extractor_config_t config = {
+        .open = _file_open,
+        .read = _file_read,
+        .read_abort = _file_read_abort,
+        .seek = _file_seek,
+        .file_size = _file_size,
+        .close = _file_close,
+        .extract_mask = extract_mask,
+        .url = (char *)filename,  // Cast to match the API
+        .input_ctx = source,
+        .output_pool = app_frame_pool_get_mem_pool(extractor->frame_pool),  // Frames outlive the extractor
+        .output_align = EXTRACTOR_FRAME_ALIGN,
+        .wait_for_output = true,                     // Block until the decoders release frames
+        .cache_block_num = EXTRACTOR_POOL_BLOCKS,    // Set number of cache blocks
+        .cache_block_size = EXTRACTOR_POOL_SIZE / EXTRACTOR_POOL_BLOCKS  // Served from the read-ahead chunks
+    };
+
+    // Open extractor
+    esp_extractor_handle_t handle = NULL;
+    esp_err_t ret = esp_extractor_open(&config, &handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open extractor: %d", ret);
+        return ret;
+    }
+
+    // Parse stream information
+    ret = esp_extractor_parse_stream_info(handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to parse stream info: %d", ret);
+        esp_extractor_close(handle);
+        return ret;
+    }
+
+    *ret_handle = handle;
+    return ESP_OK;
+}
+
+/**
+ * @brief Open and parse the next file, below the priority of the tasks of the playback
+ */
+static void preload_task(void *arg)
+{
+    app_extractor_t *extractor = (app_extractor_t *)arg;
+
+    int64_t start_us = esp_timer_get_time();
+    extractor->next_result = open_stream(extractor, extractor->next_source, extractor->next_path,
+                                         &extractor->next_extractor);
+    if (extractor->next_result == ESP_OK) {
+        ESP_LOGI(TAG, "Next file %s preloaded in %" PRId64 " us", extractor->next_path,
+                 esp_timer_get_time() - start_us);
+    } else {
+        ESP_LOGW(TAG, "Failed to preload %s: %d", extractor->next_path, extractor->next_result);
+    }
+
+    xEventGroupSetBits(extractor->preload_events, PRELOAD_DONE_BIT);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Wait for the preload of the next file, with the preload lock held
+ */
+static void wait_preload(app_extractor_t *extractor)
+{
+    if (extractor->preload_pending) {
+        xEventGroupWaitBits(extractor->preload_events, PRELOAD_DONE_BIT, pdTRUE, pdFALSE, portMAX_DELAY);
+        extractor->preload_pending = false;
+    }
+}
+
+/**
+ * @brief Drop the next file, with the preload lock held
+ */
+static void drop_preload(app_extractor_t *extractor)
+{
+    if (extractor->preload_pending) {
+        // The reads fail from now on, so the parse gives up early
+        app_file_source_abort(extractor->next_source);
+        wait_preload(extractor);
+    }
+
+    if (extractor->next_extractor != NULL) {
+        esp_extractor_close(extractor->next_extractor);
+        extractor->next_extractor = NULL;
+    }
+
+    free(extractor->next_path);
+    extractor->next_path = NULL;
+}
+
+static void cancel_preload(app_extractor_t *extractor)
+{
+    xSemaphoreTake(extractor->preload_lock, portMAX_DELAY);
+    drop_preload(extractor);
+    xSemaphoreGive(extractor->preload_lock);
+}
+
 esp_err_t app_extractor_init(app_extractor_frame_cb_t frame_cb,
                              esp_codec_dev_handle_t audio_dev,
                              app_extractor_handle_t *ret_extractor)
@@ -832,23 +1303,11 @@ esp_err_t app_extractor_init(app_extractor_frame_cb_t frame_cb,
     }
 
     extractor->frame_cb = frame_cb;
-    extractor->file = -1;
     extractor->extractor = NULL;
     extractor->eos_reached = false;
 
     extractor->audio_dev = audio_dev;
 
-    // Initialize A/V sync if enabled
-#if CONFIG_HDMI_VIDEO_SYNC_ENABLED
-    extractor->sync_enabled = true;
-    extractor->sync_threshold_ms = HDMI_SYNC_THRESHOLD_MS;
-    extractor->base_time = esp_timer_get_time() / 1000;
-    extractor->sync_mutex = xSemaphoreCreateMutex();
-#else
-    extractor->sync_enabled = false;
-    extractor->sync_mutex = NULL;
-#endif
-
     extractor->audio_decoder = NULL;
     extractor->audio_decoder_open = false;
     extractor->audio_buffer = NULL;
@@ -859,20 +1318,11 @@ esp_err_t app_extractor_init(app_extractor_frame_cb_t frame_cb,
     extractor->audio_task_running = false;
     extractor->audio_queue = NULL;
 
-    // Initialize frame rate control
-    extractor->frame_interval_ms = 1000 / DEFAULT_VIDEO_FPS;
-    extractor->last_frame_time = 0;
-
     // Create audio queue if audio device is provided
     if (audio_dev) {
-        extractor->audio_queue = xQueueCreate(AUDIO_QUEUE_SIZE, sizeof(audio_frame_item_t*));
+        extractor->audio_queue = xQueueCreate(AUDIO_QUEUE_SIZE, sizeof(app_frame_t*));
         if (extractor->audio_queue == NULL) {
             ESP_LOGE(TAG, "Failed to create audio queue");
-#if CONFIG_HDMI_VIDEO_SYNC_ENABLED
-            if (extractor->sync_mutex) {
-                vSemaphoreDelete(extractor->sync_mutex);
-            }
-#endif
             free(extractor);
             return ESP_ERR_NO_MEM;
         }
@@ -884,11 +1334,6 @@ esp_err_t app_extractor_init(app_extractor_frame_cb_t frame_cb,
         if (extractor->audio_queue) {
             vQueueDelete(extractor->audio_queue);
         }
-#if CONFIG_HDMI_VIDEO_SYNC_ENABLED
-        if (extractor->sync_mutex) {
-            vSemaphoreDelete(extractor->sync_mutex);
-        }
-#endif
         free(extractor);
         return ret;
     }
@@ -900,11 +1345,61 @@ esp_err_t app_extractor_init(app_extractor_frame_cb_t frame_cb,
             if (extractor->audio_queue) {
                 vQueueDelete(extractor->audio_queue);
             }
-#if CONFIG_HDMI_VIDEO_SYNC_ENABLED
-            if (extractor->sync_mutex) {
-                vSemaphoreDelete(extractor->sync_mutex);
-            }
-#endif
+            free(extractor);
+            return ret;
+        }
+    }
+
+    ret = app_frame_pool_create(EXTRACTOR_FRAME_POOL_SIZE, EXTRACTOR_FRAME_POOL_FRAMES, &extractor->frame_pool);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create frame pool: %d", ret);
+        if (extractor->audio_queue) {
+            vQueueDelete(extractor->audio_queue);
+        }
+        free(extractor);
+        return ret;
+    }
+
+    ret = create_file_source(&extractor->file_source);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create file source: %d", ret);
+        app_frame_pool_destroy(extractor->frame_pool);
+        if (extractor->audio_queue) {
+            vQueueDelete(extractor->audio_queue);
+        }
+        free(extractor);
+        return ret;
+    }
+
+    // The file source of the next file is created by the first preload
+    extractor->preload_lock = xSemaphoreCreateMutex();
+    extractor->preload_events = xEventGroupCreate();
+    if (extractor->preload_lock == NULL || extractor->preload_events == NULL) {
+        ESP_LOGE(TAG, "Failed to create preload lock");
+        if (extractor->preload_lock) {
+            vSemaphoreDelete(extractor->preload_lock);
+        }
+        if (extractor->preload_events) {
+            vEventGroupDelete(extractor->preload_events);
+        }
+        app_file_source_destroy(extractor->file_source);
+        app_frame_pool_destroy(extractor->frame_pool);
+        if (extractor->audio_queue) {
+            vQueueDelete(extractor->audio_queue);
+        }
+        free(extractor);
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (audio_dev != NULL) {
+        ret = create_audio_output(audio_dev, &extractor->audio_output);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create audio output: %d", ret);
+            vSemaphoreDelete(extractor->preload_lock);
+            vEventGroupDelete(extractor->preload_events);
+            app_file_source_destroy(extractor->file_source);
+            app_frame_pool_destroy(extractor->frame_pool);
+            vQueueDelete(extractor->audio_queue);
             free(extractor);
             return ret;
         }
@@ -926,15 +1421,21 @@ esp_err_t app_extractor_start(app_extractor_handle_t handle,
 
     app_extractor_t *extractor = (app_extractor_t *)handle;
     esp_err_t ret;
+    int64_t start_us = esp_timer_get_time();
+
+    // A file started from scratch replaces the next file preloaded
+    cancel_preload(extractor);
 
     // Close any existing extractor
     if (extractor->extractor != NULL) {
         esp_extractor_close(extractor->extractor);
         extractor->extractor = NULL;
     }
+    free(extractor->path);
+    extractor->path = NULL;
 
-    // Stop audio task if running
-    stop_audio_task(extractor);
+    // Stop audio task if running, the audio of the previous stream is dropped
+    stop_audio_task(extractor, true);
 
     // Set extraction flags
     extractor->extract_video = extract_video;
@@ -942,43 +1443,12 @@ esp_err_t app_extractor_start(app_extractor_handle_t handle,
     extractor->eos_reached = false;
     extractor->last_video_pts = 0;
     extractor->last_audio_pts = 0;
-    extractor->last_frame_time = esp_timer_get_time() / 1000;
-
-    // Set extraction mask based on what we want to extract
-    uint8_t extract_mask = 0;
-    if (extract_video) {
-        extract_mask |= ESP_EXTRACT_MASK_VIDEO;
-    }
-    if (extractor->extract_audio) {
-        extract_mask |= ESP_EXTRACT_MASK_AUDIO;
-    }
-
-    // Configure extractor with larger pool size
-    esp_extractor_config_t config = {
-        .open = _file_open,
-        .read = _file_read,
-        .seek = _file_seek,
-        .file_size = _file_size,
-        .close = _file_close,
-        .extract_mask = extract_mask,
-        .url = (char *)filename,  // Cast to match the API
-        .input_ctx = extractor,
-        .output_pool_size = EXTRACTOR_POOL_SIZE,     // Set output pool size
-        .cache_block_num = EXTRACTOR_POOL_BLOCKS,    // Set number of cache blocks
-        .cache_block_size = EXTRACTOR_POOL_SIZE / EXTRACTOR_POOL_BLOCKS  // Set cache block size
-    };
-
-    // Open extractor
-    ret = esp_extractor_open(&config, &extractor->extractor);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to open extractor: %d", ret);
-        return ret;
-    }
+    extractor->pts_base = 0;
+    extractor->video_started = false;
+    extractor->audio_started = false;
 
-    // Parse stream information
-    ret = esp_extractor_parse_stream_info(extractor->extractor);
+    ret = open_stream(extractor, extractor->file_source, filename, &extractor->extractor);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to parse stream info: %d", ret);
         return ret;
     }
 
@@ -989,6 +1459,13 @@ esp_err_t app_extractor_start(app_extractor_handle_t handle,
         return ret;
     }
 
+    // The audio decoder is kept for the streams of the same audio format
+    audio_params_t audio_params;
+    get_audio_params(extractor, &audio_params);
+    if (extractor->audio_decoder_open && !audio_params_equal(&audio_params, &extractor->decoder_params)) {
+        close_audio_decoder(extractor);
+    }
+
     // Validate MPEG format compatibility
     ret = validate_mpeg_compatibility(extractor);
     if (ret != ESP_OK) {
@@ -996,12 +1473,7 @@ esp_err_t app_extractor_start(app_extractor_handle_t handle,
         return ret;
     }
 
-    // Calculate optimal frame interval based on video fps
-    if (extractor->has_video && extractor->video_fps > 0) {
-        extractor->frame_interval_ms = 1000 / extractor->video_fps;
-    } else {
-        extractor->frame_interval_ms = 1000 / DEFAULT_VIDEO_FPS;
-    }
+    open_media_index(extractor, filename);
 
     // Start audio processing if needed
     if (extractor->extract_audio) {
@@ -1012,8 +1484,9 @@ esp_err_t app_extractor_start(app_extractor_handle_t handle,
         }
     }
 
-    ESP_LOGI(TAG, "Extraction started: fps=%" PRIu32 "ms, audio=%s",
-             extractor->frame_interval_ms, extractor->extract_audio ? "yes" : "no");
+    ESP_LOGI(TAG, "Extraction started in %" PRId64 " us: fps=%" PRIu32 ", audio=%s, seek index=%s",
+             esp_timer_get_time() - start_us, extractor->video_fps, extractor->extract_audio ? "yes" : "no",
+             extractor->index_building ? "building" : (extractor->index != NULL) ? "yes" : "no");
     return ESP_OK;
 }
 
@@ -1109,6 +1582,54 @@ esp_err_t app_extractor_get_audio_info(app_extractor_handle_t handle,
     return ESP_OK;
 }
 
+esp_err_t app_extractor_set_av_sync(app_extractor_handle_t handle, app_av_sync_handle_t av_sync)
+{
+    app_extractor_t *extractor = (app_extractor_t *)handle;
+    if (extractor == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    extractor->av_sync = av_sync;
+    if (extractor->audio_output != NULL) {
+        app_audio_output_set_av_sync(extractor->audio_output, av_sync);
+    }
+    return ESP_OK;
+}
+
+esp_err_t app_extractor_get_file_source_stats(app_extractor_handle_t handle, app_file_source_stats_t *stats)
+{
+    app_extractor_t *extractor = (app_extractor_t *)handle;
+    if (extractor == NULL || stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return app_file_source_get_stats(extractor->file_source, stats);
+}
+
+esp_err_t app_extractor_get_frame_pool_stats(app_extractor_handle_t handle, app_frame_pool_stats_t *stats)
+{
+    if (handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_extractor_t *extractor = (app_extractor_t *)handle;
+
+    return app_frame_pool_get_stats(extractor->frame_pool, stats);
+}
+
+esp_err_t app_extractor_get_audio_output_stats(app_extractor_handle_t handle, app_audio_output_stats_t *stats)
+{
+    app_extractor_t *extractor = (app_extractor_t *)handle;
+    if (extractor == NULL || stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (extractor->audio_output == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    return app_audio_output_get_stats(extractor->audio_output, stats);
+}
+
 esp_err_t app_extractor_seek(app_extractor_handle_t handle, uint32_t position)
 {
     if (handle == NULL) {
@@ -1124,8 +1645,211 @@ esp_err_t app_extractor_seek(app_extractor_handle_t handle, uint32_t position)
     // Reset EOS flag when seeking
     extractor->eos_reached = false;
 
+    // The audio decoded ahead is dropped, and the decoding continues from the new position
+    if (extractor->audio_task_running) {
+        stop_audio_task(extractor, true);
+        start_audio_task(extractor);
+    }
+
+    // The decoder starts again from the parameter sets
+    extractor->video_config_pending = (extractor->video_config != NULL);
+
+    // Seek straight to the key frame at or before the position, if the seek index is known
+    uint32_t target = position;
+    if (extractor->index_building) {
+        abandon_media_index(extractor);
+    } else if (extractor->index != NULL) {
+        app_media_index_find_keyframe(extractor->index, position, NULL, &target);
+    }
+
     // Seek to the specified position (in milliseconds)
-    return esp_extractor_seek(extractor->extractor, position);
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t ret = esp_extractor_seek(extractor->extractor, target);
+    ESP_LOGI(TAG, "Seek to %" PRIu32 " ms (frame at %" PRIu32 " ms) in %" PRId64 " us",
+             position, target, esp_timer_get_time() - start_us);
+    return ret;
+}
+
+esp_err_t app_extractor_find_keyframe(app_extractor_handle_t handle, uint32_t position, uint32_t *pts)
+{
+    app_extractor_t *extractor = (app_extractor_t *)handle;
+    if (extractor == NULL || pts == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // The index being built covers the frames extracted so far only
+    if (extractor->index == NULL || extractor->index_building) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    return app_media_index_find_keyframe(extractor->index, position, NULL, pts);
+}
+
+esp_err_t app_extractor_preload(app_extractor_handle_t handle, const char *filename)
+{
+    app_extractor_t *extractor = (app_extractor_t *)handle;
+    if (extractor == NULL || filename == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(extractor->preload_lock, portMAX_DELAY);
+    drop_preload(extractor);
+
+    // The file source of the next file is swapped with the one of the current file at each switch
+    esp_err_t ret = ESP_OK;
+    if (extractor->next_source == NULL) {
+        ret = create_file_source(&extractor->next_source);
+    }
+
+    if (ret == ESP_OK) {
+        extractor->next_path = strdup(filename);
+        ret = (extractor->next_path != NULL) ? ESP_OK : ESP_ERR_NO_MEM;
+    }
+
+    if (ret == ESP_OK) {
+        xEventGroupClearBits(extractor->preload_events, PRELOAD_DONE_BIT);
+        extractor->next_result = ESP_FAIL;
+        extractor->preload_pending = true;
+        if (xTaskCreate(preload_task, "preload_task", PRELOAD_TASK_STACK_SIZE, extractor, PRELOAD_TASK_PRIORITY,
+                        NULL) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create preload task");
+            extractor->preload_pending = false;
+            drop_preload(extractor);
+            ret = ESP_FAIL;
+        }
+    }
+
+    xSemaphoreGive(extractor->preload_lock);
+    return ret;
+}
+
+esp_err_t app_extractor_get_next_video_info(app_extractor_handle_t handle,
+                                            uint32_t *width, uint32_t *height,
+                                            uint32_t *fps, uint32_t *duration)
+{
+    app_extractor_t *extractor = (app_extractor_t *)handle;
+    if (extractor == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(extractor->preload_lock, portMAX_DELAY);
+    wait_preload(extractor);
+
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+    if (extractor->next_extractor != NULL) {
+        extractor_stream_info_t stream_info = {0};
+        ret = esp_extractor_get_stream_info(extractor->next_extractor, EXTRACTOR_STREAM_TYPE_VIDEO, 0, &stream_info);
+        if (ret == ESP_OK) {
+            extractor_video_stream_info_t *video_info = &stream_info.stream_info.video_info;
+            if (width) {
+                *width = video_info->width;
+            }
+            if (height) {
+                *height = video_info->height;
+            }
+            if (fps) {
+                *fps = video_info->fps;
+            }
+            if (duration) {
+                *duration = stream_info.duration;
+            }
+        }
+    } else if (extractor->next_path != NULL) {
+        ret = extractor->next_result;
+    }
+
+    xSemaphoreGive(extractor->preload_lock);
+    return ret;
+}
+
+esp_err_t app_extractor_cancel_preload(app_extractor_handle_t handle)
+{
+    app_extractor_t *extractor = (app_extractor_t *)handle;
+    if (extractor == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    cancel_preload(extractor);
+    return ESP_OK;
+}
+
+esp_err_t app_extractor_switch_next(app_extractor_handle_t handle)
+{
+    app_extractor_t *extractor = (app_extractor_t *)handle;
+    if (extractor == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(extractor->preload_lock, portMAX_DELAY);
+    wait_preload(extractor);
+
+    if (extractor->next_extractor == NULL) {
+        esp_err_t ret = (extractor->next_path != NULL) ? extractor->next_result : ESP_ERR_NOT_FOUND;
+        drop_preload(extractor);
+        xSemaphoreGive(extractor->preload_lock);
+        return ret;
+    }
+
+    // The next file starts where the current one ends
+    uint32_t end_pts = get_end_pts(extractor);
+
+    // The audio of the current file is decoded before the audio decoder is closed for another audio format, and the
+    // audio output plays it out
+    audio_params_t current_audio;
+    audio_params_t next_audio;
+    get_audio_params(extractor, &current_audio);
+    if (extractor->extract_audio && read_audio_params(extractor->next_extractor, &next_audio) &&
+            !audio_params_equal(&current_audio, &next_audio)) {
+        drain_audio_queue(extractor);
+        stop_audio_task(extractor, false);
+        close_audio_decoder(extractor);
+    }
+
+    // The current file is closed, and its file source serves the next preload
+    if (extractor->extractor != NULL) {
+        esp_extractor_close(extractor->extractor);
+    }
+    close_media_index(extractor);
+
+    app_file_source_handle_t source = extractor->file_source;
+    extractor->file_source = extractor->next_source;
+    extractor->next_source = source;
+    extractor->extractor = extractor->next_extractor;
+    extractor->next_extractor = NULL;
+    free(extractor->path);
+    extractor->path = extractor->next_path;
+    extractor->next_path = NULL;
+    xSemaphoreGive(extractor->preload_lock);
+
+    extractor->pts_base += end_pts;
+    extractor->eos_reached = false;
+    extractor->last_video_pts = 0;
+    extractor->last_audio_pts = 0;
+    extractor->video_started = false;
+    extractor->audio_started = false;
+
+    esp_err_t ret = get_stream_info(extractor);
+    if (ret == ESP_OK) {
+        ret = validate_mpeg_compatibility(extractor);
+    }
+    if (ret != ESP_OK) {
+        // The stream ends with the previous file
+        extractor->eos_reached = true;
+        return ret;
+    }
+
+    open_media_index(extractor, extractor->path);
+
+    if (extractor->extract_audio) {
+        ret = start_audio_task(extractor);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Audio task start failed: %d", ret);
+            return ret;
+        }
+    }
+
+    ESP_LOGI(TAG, "Switched to %s at %" PRIu32 " ms", extractor->path, extractor->pts_base);
+    return ESP_OK;
 }
 
 esp_err_t app_extractor_stop(app_extractor_handle_t handle)
@@ -1136,13 +1860,19 @@ esp_err_t app_extractor_stop(app_extractor_handle_t handle)
 
     app_extractor_t *extractor = (app_extractor_t *)handle;
 
+    cancel_preload(extractor);
+
     // Stop audio task first
-    stop_audio_task(extractor);
+    stop_audio_task(extractor, true);
 
     if (extractor->extractor != NULL) {
         esp_extractor_close(extractor->extractor);
         extractor->extractor = NULL;
     }
+    free(extractor->path);
+    extractor->path = NULL;
+
+    close_media_index(extractor);
 
     extractor->eos_reached = true;
 
@@ -1161,9 +1891,11 @@ esp_err_t app_extractor_deinit(app_extractor_handle_t handle)
     app_extractor_stop(handle);
 
     // Close audio decoder
-    if (extractor->audio_decoder != NULL) {
-        esp_audio_dec_close(extractor->audio_decoder);
-        extractor->audio_decoder = NULL;
+    close_audio_decoder(extractor);
+
+    if (extractor->audio_output != NULL) {
+        app_audio_output_destroy(extractor->audio_output);
+        extractor->audio_output = NULL;
     }
 
     // Free audio buffer
@@ -1172,19 +1904,33 @@ esp_err_t app_extractor_deinit(app_extractor_handle_t handle)
         extractor->audio_buffer = NULL;
     }
 
+    free(extractor->video_config);
+    extractor->video_config = NULL;
+
     // Delete audio queue
     if (extractor->audio_queue != NULL) {
         vQueueDelete(extractor->audio_queue);
         extractor->audio_queue = NULL;
     }
 
-    // Delete sync mutex
-#if CONFIG_HDMI_VIDEO_SYNC_ENABLED
-    if (extractor->sync_mutex != NULL) {
-        vSemaphoreDelete(extractor->sync_mutex);
-        extractor->sync_mutex = NULL;
+    // Destroy frame pool, after the extractor and the audio task released their frames
+    if (extractor->frame_pool != NULL) {
+        app_frame_pool_destroy(extractor->frame_pool);
+        extractor->frame_pool = NULL;
+    }
+
+    // Destroy file sources, after the extractors closed their file
+    if (extractor->file_source != NULL) {
+        app_file_source_destroy(extractor->file_source);
+        extractor->file_source = NULL;
+    }
+    if (extractor->next_source != NULL) {
+        app_file_source_destroy(extractor->next_source);
+        extractor->next_source = NULL;
     }
-#endif
+
+    vSemaphoreDelete(extractor->preload_lock);
+    vEventGroupDelete(extractor->preload_events);
 
     // Unregister all extractors
     esp_extractor_unregister_all();
@@ -1204,6 +1950,26 @@ esp_err_t app_extractor_probe_video_info(const char *filename,
         return ESP_ERR_INVALID_ARG;
     }
 
+#if CONFIG_HDMI_MEDIA_INDEX_ENABLED
+    // The seek index keeps the stream information, without parsing the file
+    app_media_index_info_t info;
+    if (app_media_index_load_info(filename, &info) == ESP_OK) {
+        if (width) {
+            *width = info.width;
+        }
+        if (height) {
+            *height = info.height;
+        }
+        if (fps) {
+            *fps = info.fps;
+        }
+        if (duration) {
+            *duration = info.duration;
+        }
+        return ESP_OK;
+    }
+#endif
+
     app_extractor_handle_t probe;
     esp_err_t ret = app_extractor_init(NULL, NULL, &probe);
     if (ret != ESP_OK) {
@@ -9,6 +9,11 @@
 #include "esp_err.h"
 #include "esp_extractor.h"
 #include "esp_codec_dev.h"
+#include "app_frame_pool.h"
+#include "app_av_sync.h"
+#include "app_file_source.h"
+#include "app_media_index.h"
+#include "app_audio_output.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -17,20 +22,36 @@ extern "C" {
 /* ESP32-P4 JPEG Hardware Configuration */
 #define HDMI_AUDIO_BUFFER_SIZE          (64 * 1024)
 
-/* A/V Sync Configuration */
-#define HDMI_SYNC_THRESHOLD_MS          (50)
-
 /* Memory pool configuration */
 #define EXTRACTOR_POOL_SIZE             (256 * 1024)
 #define EXTRACTOR_POOL_BLOCKS           (3)
 
+/* Output frame pool configuration, the frames are held by the decoders until they are released */
+#define EXTRACTOR_FRAME_POOL_SIZE       (768 * 1024)
+#define EXTRACTOR_FRAME_POOL_FRAMES     (32)
+#define EXTRACTOR_FRAME_ALIGN           (128)   /* L2 cache line, for the DMA of the JPEG decoder */
+
+/* Read-ahead of the media file, in sector aligned chunks in PSRAM */
+#define EXTRACTOR_READ_CHUNK_SIZE       (64 * 1024)
+#define EXTRACTOR_READ_CHUNK_NUM        (8)
+#define EXTRACTOR_READ_TASK_PRIORITY    (6)
+
 /* Audio Task Configuration  */
 #define AUDIO_TASK_PRIORITY             (7)
 #define AUDIO_TASK_STACK_SIZE           (4 * 1024)
 #define AUDIO_QUEUE_SIZE                (6)
 #define AUDIO_QUEUE_TIMEOUT_MS          (50)
+#define AUDIO_DRAIN_TIMEOUT_MS          (500)   /* Audio of a file decoded before a change of audio format */
 
-/* Frame Rate Control */
+/* Audio output, the task writing the codec from the ring of decoded audio runs above the decoding */
+#define AUDIO_OUTPUT_TASK_PRIORITY      (8)
+#define AUDIO_OUTPUT_TASK_STACK_SIZE    (3 * 1024)
+
+/* Preload of the next file, below the tasks of the playback */
+#define PRELOAD_TASK_PRIORITY           (3)
+#define PRELOAD_TASK_STACK_SIZE         (4 * 1024)
+
+/* Frame Rate Control, for the streams without FPS */
 #define DEFAULT_VIDEO_FPS               (25)
 
 /**
@@ -40,9 +61,10 @@ typedef struct app_extractor_t* app_extractor_handle_t;
 
 /**
  * @brief Frame callback function
+ *
+ * @note The callback takes over the reference of the frame, and releases it with `app_frame_unref()` once done
  */
-typedef esp_err_t (*app_extractor_frame_cb_t)(uint8_t *buffer, uint32_t buffer_size,
-                                              bool is_video, uint32_t pts);
+typedef esp_err_t (*app_extractor_frame_cb_t)(app_frame_t *frame);
 
 /**
  * @brief Initialize extractor with optional audio support
@@ -82,11 +104,76 @@ esp_err_t app_extractor_probe_video_info(const char *filename,
                                          uint32_t *width, uint32_t *height,
                                          uint32_t *fps, uint32_t *duration);
 
+/**
+ * @brief Set the A/V sync instance, which follows the audio written to the audio device
+ *
+ * @note Without it, the audio is played on its own
+ */
+esp_err_t app_extractor_set_av_sync(app_extractor_handle_t extractor, app_av_sync_handle_t av_sync);
+
+/**
+ * @brief Get the statistics of the read-ahead of the media file
+ */
+esp_err_t app_extractor_get_file_source_stats(app_extractor_handle_t extractor, app_file_source_stats_t *stats);
+
+/**
+ * @brief Get the statistics of the output frame pool
+ */
+esp_err_t app_extractor_get_frame_pool_stats(app_extractor_handle_t extractor, app_frame_pool_stats_t *stats);
+
+/**
+ * @brief Get the statistics of the audio decoded ahead of the audio device, since the start or the last seek
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND without audio device, or another error code
+ */
+esp_err_t app_extractor_get_audio_output_stats(app_extractor_handle_t extractor, app_audio_output_stats_t *stats);
+
 /**
  * @brief Seek to position in milliseconds
+ *
+ * @note With the seek index of the file, the seek goes to the key frame at or before the position
  */
 esp_err_t app_extractor_seek(app_extractor_handle_t extractor, uint32_t position);
 
+/**
+ * @brief Find the key frame at or before a position, e.g. for the thumbnails of a scrub bar
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if the file has no seek index yet
+ */
+esp_err_t app_extractor_find_keyframe(app_extractor_handle_t extractor, uint32_t position, uint32_t *pts);
+
+/**
+ * @brief Open and parse the next file in the background, for a switch without a gap at the end of the current one
+ *
+ * The file source and the frame pool are shared with the current file, so a preload replaces the previous one. A
+ * start of another file drops the file preloaded.
+ */
+esp_err_t app_extractor_preload(app_extractor_handle_t extractor, const char *filename);
+
+/**
+ * @brief Get the video stream info of the next file, once its preload is done
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND without next file, or the error of its preload
+ */
+esp_err_t app_extractor_get_next_video_info(app_extractor_handle_t extractor,
+                                            uint32_t *width, uint32_t *height,
+                                            uint32_t *fps, uint32_t *duration);
+
+/**
+ * @brief Drop the next file
+ */
+esp_err_t app_extractor_cancel_preload(app_extractor_handle_t extractor);
+
+/**
+ * @brief Continue with the next file at the end of the current one
+ *
+ * The PTS of the next file follow the ones of the current file, so the clock of the A/V sync runs on. The audio
+ * decoder and the audio device are kept if the audio format is the same.
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND without next file, or the error of its preload
+ */
+esp_err_t app_extractor_switch_next(app_extractor_handle_t extractor);
+
 /**
  * @brief Stop extraction
  */
@@ -0,0 +1,499 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+
+#include "app_file_source.h"
+
+static const char *TAG = "file_source";
+
+#define FILE_SOURCE_SECTOR_SIZE     (512)
+#define FILE_SOURCE_BUFFER_ALIGN    (128)       /*!< Cache line, the card DMA writes the sectors into the chunks */
+#define FILE_SOURCE_WAIT_MS         (100)       /*!< Period to check the state while waiting */
+#define FILE_SOURCE_NO_POSITION     (UINT32_MAX)
+
+/* Event group bits */
+#define FILE_SOURCE_WAKE_BIT        (1 << 0)    /*!< Chunks to read ahead, for the task */
+#define FILE_SOURCE_DATA_BIT        (1 << 1)    /*!< Chunk read or abort, for the reader */
+#define FILE_SOURCE_STOP_BIT        (1 << 2)    /*!< Stop the task */
+
+/**
+ * @brief Chunk of the file in the ring
+ */
+typedef struct {
+    uint8_t *data;                  /*!< Chunk data */
+    uint32_t index;                 /*!< Index of the chunk in the file */
+    uint32_t size;                  /*!< Size of the data, less than the chunk size at the end of the file */
+    bool ready;                     /*!< Flag indicating if the data is read */
+} file_chunk_t;
+
+/**
+ * @brief File source context structure
+ *
+ * The ring holds the chunks `first` to `first + chunk_num - 1` of the file, the chunk `i` in the slot
+ * `i % chunk_num`. The task reads them in order from `fetch_index`, and the reader releases them as it moves on.
+ */
+typedef struct app_file_source_t {
+    app_file_source_config_t config;    /*!< File source configuration */
+    file_chunk_t *chunks;               /*!< Ring of chunks */
+    SemaphoreHandle_t lock;             /*!< Lock of the state below */
+    EventGroupHandle_t events;          /*!< Events between the reader and the task */
+    TaskHandle_t task_handle;           /*!< Read-ahead task */
+
+    /* File */
+    int fd;                             /*!< File descriptor, -1 if closed */
+    uint32_t file_size;                 /*!< Size of the file */
+    uint32_t fd_position;               /*!< Position of the file descriptor, used by the task only */
+
+    /* Ring */
+    uint32_t generation;                /*!< Incremented when the chunks are dropped, to discard the read in progress */
+    uint32_t first;                     /*!< First chunk kept */
+    uint32_t fetch_index;               /*!< Next chunk to read ahead */
+    bool io_busy;                       /*!< Flag indicating if the task reads the file */
+    bool error;                         /*!< Flag indicating if a read of the file failed */
+
+    /* Reader */
+    uint32_t read_position;             /*!< Current position */
+    bool aborted;                       /*!< Flag indicating if the reads are aborted */
+
+    app_file_source_stats_t stats;      /*!< Statistics */
+} app_file_source_t;
+
+/**
+ * @brief Drop all the chunks, and read ahead from a chunk
+ */
+static void restart_ring(app_file_source_t *source, uint32_t index)
+{
+    for (uint32_t i = 0; i < source->config.chunk_num; i++) {
+        if (source->chunks[i].ready) {
+            source->chunks[i].ready = false;
+            source->stats.chunks_discarded++;
+        }
+    }
+
+    source->generation++;
+    source->first = index;
+    source->fetch_index = index;
+    source->error = false;
+}
+
+/**
+ * @brief Move the ring to the chunk of the reader
+ *
+ * The chunk before the one of the reader is kept, as the interleaved tracks of a file are read with short seeks back.
+ */
+static void move_ring(app_file_source_t *source, uint32_t index)
+{
+    if ((index >= source->first) && (index - source->first < source->config.chunk_num)) {
+        if (index > source->first + 1) {
+            source->first = index - 1;
+            xEventGroupSetBits(source->events, FILE_SOURCE_WAKE_BIT);
+        }
+        return;
+    }
+
+    restart_ring(source, index);
+    source->stats.restarts++;
+    xEventGroupSetBits(source->events, FILE_SOURCE_WAKE_BIT);
+}
+
+/**
+ * @brief Read a chunk from the file, as few system calls as possible
+ *
+ * @return Number of bytes read, or -1 on error
+ */
+static int read_chunk(app_file_source_t *source, int fd, uint32_t offset, uint8_t *data)
+{
+    if (source->fd_position != offset) {
+        if (lseek(fd, offset, SEEK_SET) < 0) {
+            ESP_LOGE(TAG, "File seek error: %d", errno);
+            source->fd_position = FILE_SOURCE_NO_POSITION;
+            return -1;
+        }
+    }
+
+    uint32_t got = 0;
+    while (got < source->config.chunk_size) {
+        ssize_t ret = read(fd, data + got, source->config.chunk_size - got);
+        if (ret < 0) {
+            ESP_LOGE(TAG, "File read error: %d", errno);
+            source->fd_position = FILE_SOURCE_NO_POSITION;
+            return -1;
+        }
+        if (ret == 0) {
+            break;
+        }
+        got += ret;
+    }
+
+    source->fd_position = offset + got;
+    return (int)got;
+}
+
+/**
+ * @brief Read the chunks ahead of the reader, as long as the ring has room
+ */
+static void read_ahead(app_file_source_t *source)
+{
+    while (1) {
+        xSemaphoreTake(source->lock, portMAX_DELAY);
+
+        if (source->fetch_index < source->first) {
+            source->fetch_index = source->first;
+        }
+        uint32_t index = source->fetch_index;
+        int fd = source->fd;
+        if ((fd < 0) || source->error || (index - source->first >= source->config.chunk_num) ||
+                ((uint64_t)index * source->config.chunk_size >= source->file_size)) {
+            xSemaphoreGive(source->lock);
+            return;
+        }
+
+        file_chunk_t *chunk = &source->chunks[index % source->config.chunk_num];
+        chunk->ready = false;
+        chunk->index = index;
+        uint32_t generation = source->generation;
+        source->io_busy = true;
+
+        xSemaphoreGive(source->lock);
+
+        int got = read_chunk(source, fd, index * source->config.chunk_size, chunk->data);
+
+        xSemaphoreTake(source->lock, portMAX_DELAY);
+
+        source->io_busy = false;
+        if (generation != source->generation) {
+            source->stats.chunks_discarded++;
+        } else if (got < 0) {
+            source->error = true;
+        } else {
+            chunk->size = (uint32_t)got;
+            chunk->ready = true;
+            source->fetch_index = index + 1;
+            source->stats.bytes_read += got;
+            source->stats.chunks_read++;
+        }
+        xEventGroupSetBits(source->events, FILE_SOURCE_DATA_BIT);
+
+        xSemaphoreGive(source->lock);
+    }
+}
+
+/* The flags set by the task are read under the lock, so the reader sees them in order with the rest of the state */
+static bool is_io_busy(app_file_source_t *source)
+{
+    xSemaphoreTake(source->lock, portMAX_DELAY);
+    bool busy = source->io_busy;
+    xSemaphoreGive(source->lock);
+    return busy;
+}
+
+static bool is_task_running(app_file_source_t *source)
+{
+    xSemaphoreTake(source->lock, portMAX_DELAY);
+    bool running = (source->task_handle != NULL);
+    xSemaphoreGive(source->lock);
+    return running;
+}
+
+static void read_ahead_task(void *arg)
+{
+    app_file_source_t *source = (app_file_source_t *)arg;
+
+    while (1) {
+        EventBits_t bits = xEventGroupWaitBits(source->events, FILE_SOURCE_WAKE_BIT | FILE_SOURCE_STOP_BIT,
+                                               pdFALSE, pdFALSE, portMAX_DELAY);
+        if (bits & FILE_SOURCE_STOP_BIT) {
+            break;
+        }
+
+        // Cleared before the state is checked, so no wake up is missed
+        xEventGroupClearBits(source->events, FILE_SOURCE_WAKE_BIT);
+        read_ahead(source);
+    }
+
+    xSemaphoreTake(source->lock, portMAX_DELAY);
+    source->task_handle = NULL;
+    xSemaphoreGive(source->lock);
+    vTaskDelete(NULL);
+}
+
+esp_err_t app_file_source_create(const app_file_source_config_t *config, app_file_source_handle_t *ret_source)
+{
+    if (config == NULL || ret_source == NULL || config->chunk_size == 0 ||
+            (config->chunk_size % FILE_SOURCE_SECTOR_SIZE) != 0 || config->chunk_num < 2) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_file_source_t *source = calloc(1, sizeof(app_file_source_t));
+    if (source == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate file source context");
+        return ESP_ERR_NO_MEM;
+    }
+
+    source->config = *config;
+    source->fd = -1;
+    source->lock = xSemaphoreCreateMutex();
+    source->events = xEventGroupCreate();
+    source->chunks = calloc(config->chunk_num, sizeof(file_chunk_t));
+    if (source->lock == NULL || source->events == NULL || source->chunks == NULL) {
+        ESP_LOGE(TAG, "Failed to create file source");
+        app_file_source_destroy(source);
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (uint32_t i = 0; i < config->chunk_num; i++) {
+        source->chunks[i].data = heap_caps_aligned_alloc(FILE_SOURCE_BUFFER_ALIGN, config->chunk_size,
+                                                         MALLOC_CAP_SPIRAM);
+        if (source->chunks[i].data == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate %" PRIu32 " chunks of %" PRIu32 " bytes",
+                     config->chunk_num, config->chunk_size);
+            app_file_source_destroy(source);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    BaseType_t task_ret = xTaskCreate(read_ahead_task, "file_source", config->task_stack_size, source,
+                                      config->task_priority, &source->task_handle);
+    if (task_ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create read-ahead task");
+        source->task_handle = NULL;
+        app_file_source_destroy(source);
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "File source created: %" PRIu32 " chunks of %" PRIu32 " bytes",
+             config->chunk_num, config->chunk_size);
+    *ret_source = source;
+    return ESP_OK;
+}
+
+esp_err_t app_file_source_open(app_file_source_handle_t source, const char *path)
+{
+    if (source == NULL || path == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_file_source_close(source);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        ESP_LOGE(TAG, "Failed to open file: %s", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    off_t end = lseek(fd, 0, SEEK_END);
+    if (end < 0) {
+        ESP_LOGE(TAG, "Failed to get the size of %s: %d", path, errno);
+        close(fd);
+        return ESP_FAIL;
+    }
+
+    xSemaphoreTake(source->lock, portMAX_DELAY);
+    source->fd = fd;
+    source->file_size = (uint32_t)end;
+    source->fd_position = FILE_SOURCE_NO_POSITION;
+    source->read_position = 0;
+    source->aborted = false;
+    restart_ring(source, 0);
+    memset(&source->stats, 0, sizeof(source->stats));
+    xSemaphoreGive(source->lock);
+
+    xEventGroupSetBits(source->events, FILE_SOURCE_WAKE_BIT);
+    return ESP_OK;
+}
+
+int app_file_source_read(app_file_source_handle_t source, void *buffer, uint32_t size)
+{
+    if (source == NULL || buffer == NULL) {
+        return 0;
+    }
+
+    uint8_t *out = (uint8_t *)buffer;
+    uint32_t total = 0;
+    int64_t wait_us = 0;
+
+    xSemaphoreTake(source->lock, portMAX_DELAY);
+
+    while ((size > 0) && !source->aborted && (source->fd >= 0) && (source->read_position < source->file_size)) {
+        uint32_t index = source->read_position / source->config.chunk_size;
+        move_ring(source, index);
+
+        file_chunk_t *chunk = &source->chunks[index % source->config.chunk_num];
+        if (chunk->ready && (chunk->index == index)) {
+            uint32_t offset = source->read_position - index * source->config.chunk_size;
+            if (offset >= chunk->size) {
+                break;  // The file is shorter than its size
+            }
+
+            uint32_t len = chunk->size - offset;
+            if (len > size) {
+                len = size;
+            }
+            memcpy(out, chunk->data + offset, len);
+            out += len;
+            size -= len;
+            total += len;
+            source->read_position += len;
+            continue;
+        }
+
+        if (source->error) {
+            break;
+        }
+
+        // Wait for the chunk, the read-ahead did not keep up
+        xSemaphoreGive(source->lock);
+        int64_t start_us = esp_timer_get_time();
+        xEventGroupWaitBits(source->events, FILE_SOURCE_DATA_BIT, pdTRUE, pdFALSE, pdMS_TO_TICKS(FILE_SOURCE_WAIT_MS));
+        wait_us += esp_timer_get_time() - start_us;
+        xSemaphoreTake(source->lock, portMAX_DELAY);
+    }
+
+    if (wait_us > 0) {
+        source->stats.stalls++;
+        source->stats.stall_total_us += wait_us;
+        if (wait_us > source->stats.stall_max_us) {
+            source->stats.stall_max_us = (uint32_t)wait_us;
+        }
+    }
+
+    xSemaphoreGive(source->lock);
+
+    return (int)total;
+}
+
+void app_file_source_abort(app_file_source_handle_t source)
+{
+    if (source == NULL) {
+        return;
+    }
+
+    xSemaphoreTake(source->lock, portMAX_DELAY);
+    source->aborted = true;
+    xSemaphoreGive(source->lock);
+
+    xEventGroupSetBits(source->events, FILE_SOURCE_DATA_BIT);
+}
+
+esp_err_t app_file_source_seek(app_file_source_handle_t source, uint32_t position)
+{
+    if (source == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(source->lock, portMAX_DELAY);
+
+    if (source->fd < 0 || position > source->file_size) {
+        xSemaphoreGive(source->lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Read ahead from the new position at once, rather than on the next read
+    source->read_position = position;
+    source->aborted = false;
+    if (position < source->file_size) {
+        move_ring(source, position / source->config.chunk_size);
+    }
+
+    xSemaphoreGive(source->lock);
+    return ESP_OK;
+}
+
+uint32_t app_file_source_get_size(app_file_source_handle_t source)
+{
+    return (source != NULL) ? source->file_size : 0;
+}
+
+esp_err_t app_file_source_close(app_file_source_handle_t source)
+{
+    if (source == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(source->lock, portMAX_DELAY);
+    int fd = source->fd;
+    source->fd = -1;
+    restart_ring(source, 0);
+    xSemaphoreGive(source->lock);
+
+    if (fd < 0) {
+        return ESP_OK;
+    }
+
+    // The task may still read the file, its chunk is discarded
+    while (is_io_busy(source)) {
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+
+    if (close(fd) < 0) {
+        ESP_LOGE(TAG, "File close error: %d", errno);
+        return ESP_FAIL;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t app_file_source_get_stats(app_file_source_handle_t source, app_file_source_stats_t *stats)
+{
+    if (source == NULL || stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(source->lock, portMAX_DELAY);
+    *stats = source->stats;
+    xSemaphoreGive(source->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t app_file_source_destroy(app_file_source_handle_t source)
+{
+    if (source == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (source->fd >= 0) {
+        ESP_LOGW(TAG, "Destroy file source with a file opened");
+        app_file_source_close(source);
+    }
+
+    if (source->task_handle != NULL) {
+        xEventGroupSetBits(source->events, FILE_SOURCE_STOP_BIT);
+        while (is_task_running(source)) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+
+    if (source->chunks != NULL) {
+        for (uint32_t i = 0; i < source->config.chunk_num; i++) {
+            heap_caps_free(source->chunks[i].data);
+        }
+        free(source->chunks);
+    }
+    if (source->events != NULL) {
+        vEventGroupDelete(source->events);
+    }
+    if (source->lock != NULL) {
+        vSemaphoreDelete(source->lock);
+    }
+    free(source);
+
+    return ESP_OK;
+}
@@ -0,0 +1,114 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief File source handle
+ */
+typedef struct app_file_source_t* app_file_source_handle_t;
+
+/**
+ * @brief File source configuration structure
+ */
+typedef struct {
+    uint32_t chunk_size;            /*!< Size of a read from the file, a multiple of the 512 bytes sectors */
+    uint32_t chunk_num;             /*!< Number of chunks in the ring, read ahead of the reader */
+    uint32_t task_priority;         /*!< Priority of the read-ahead task */
+    uint32_t task_stack_size;       /*!< Stack size of the read-ahead task */
+} app_file_source_config_t;
+
+/**
+ * @brief Helper macro to create default file source configuration
+ */
+#define APP_FILE_SOURCE_CONFIG_DEFAULT()    \
+    {                                       \
+        .chunk_size = 64 * 1024,            \
+        .chunk_num = 8,                     \
+        .task_priority = 6,                 \
+        .task_stack_size = 3 * 1024,        \
+    }
+
+/**
+ * @brief File source statistics structure
+ */
+typedef struct {
+    uint64_t bytes_read;            /*!< Bytes read from the file */
+    uint32_t chunks_read;           /*!< Chunks read from the file */
+    uint32_t chunks_discarded;      /*!< Chunks read ahead but dropped by a seek */
+    uint32_t restarts;              /*!< Seeks out of the chunks read ahead, which restart the read-ahead */
+    uint32_t stalls;                /*!< Reads which waited for the read-ahead */
+    uint32_t stall_max_us;          /*!< Longest wait of a read */
+    uint64_t stall_total_us;        /*!< Total wait of the reads */
+} app_file_source_stats_t;
+
+/**
+ * @brief Create a file source
+ *
+ * A task reads the file ahead of the reader, in chunks aligned on their size, into a ring of chunks in PSRAM. The
+ * reads are served from the ring, so the latency spikes of an SD card are absorbed while the ring is not empty. A seek
+ * into or just ahead of the ring keeps the chunks read, a seek elsewhere restarts the read-ahead from there.
+ *
+ * @note The ring and the task are created once here, and reused by every file opened
+ *
+ * @param config File source configuration
+ * @param ret_source Pointer to store the file source handle
+ * @return ESP_OK on success, or an error code
+ */
+esp_err_t app_file_source_create(const app_file_source_config_t *config, app_file_source_handle_t *ret_source);
+
+/**
+ * @brief Open a file, and start to read it ahead, the previous file is closed
+ */
+esp_err_t app_file_source_open(app_file_source_handle_t source, const char *path);
+
+/**
+ * @brief Read from the current position
+ *
+ * @return Number of bytes read, less than size at the end of the file, or 0 on error or abort
+ */
+int app_file_source_read(app_file_source_handle_t source, void *buffer, uint32_t size);
+
+/**
+ * @brief Abort the reads in progress and the next ones, until the next open or seek
+ */
+void app_file_source_abort(app_file_source_handle_t source);
+
+/**
+ * @brief Move the current position
+ */
+esp_err_t app_file_source_seek(app_file_source_handle_t source, uint32_t position);
+
+/**
+ * @brief Get the size of the file opened
+ */
+uint32_t app_file_source_get_size(app_file_source_handle_t source);
+
+/**
+ * @brief Close the file opened
+ */
+esp_err_t app_file_source_close(app_file_source_handle_t source);
+
+/**
+ * @brief Get the file source statistics, since the last open
+ */
+esp_err_t app_file_source_get_stats(app_file_source_handle_t source, app_file_source_stats_t *stats);
+
+/**
+ * @brief Destroy a file source, its file must be closed
+ */
+esp_err_t app_file_source_destroy(app_file_source_handle_t source);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,159 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#include "app_frame_pool.h"
+
+static const char *TAG = "frame_pool";
+
+/**
+ * @brief Frame pool context structure
+ */
+typedef struct app_frame_pool_t {
+    mem_pool_handle_t mem_pool;         /*!< Memory pool of the frame data */
+    app_frame_t *frames;                /*!< Frame descriptors */
+    uint32_t frame_num;                 /*!< Number of frame descriptors */
+    QueueHandle_t free_queue;           /*!< Free frame descriptors */
+    atomic_uint frames_in_use;          /*!< Frames referenced */
+    atomic_uint frames_in_use_max;      /*!< Maximum number of frames referenced at once */
+    atomic_uint frames_wrapped;         /*!< Total frames wrapped */
+    atomic_uint wrap_failures;          /*!< Frames dropped because no descriptor was free */
+} app_frame_pool_t;
+
+esp_err_t app_frame_pool_create(uint32_t pool_size, uint32_t frame_num, app_frame_pool_handle_t *ret_pool)
+{
+    if (pool_size == 0 || frame_num == 0 || ret_pool == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_frame_pool_t *pool = calloc(1, sizeof(app_frame_pool_t));
+    if (pool == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate frame pool context");
+        return ESP_ERR_NO_MEM;
+    }
+
+    pool->frame_num = frame_num;
+    pool->frames = calloc(frame_num, sizeof(app_frame_t));
+    pool->free_queue = xQueueCreate(frame_num, sizeof(app_frame_t *));
+    pool->mem_pool = mem_pool_create(pool_size);
+    if (pool->frames == NULL || pool->free_queue == NULL || pool->mem_pool == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate frame pool of %" PRIu32 " bytes", pool_size);
+        app_frame_pool_destroy(pool);
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (uint32_t i = 0; i < frame_num; i++) {
+        app_frame_t *frame = &pool->frames[i];
+        frame->pool = pool;
+        xQueueSend(pool->free_queue, &frame, 0);
+    }
+
+    ESP_LOGI(TAG, "Frame pool created: %" PRIu32 " bytes, %" PRIu32 " frames", pool_size, frame_num);
+    *ret_pool = pool;
+    return ESP_OK;
+}
+
+mem_pool_handle_t app_frame_pool_get_mem_pool(app_frame_pool_handle_t pool)
+{
+    return (pool != NULL) ? pool->mem_pool : NULL;
+}
+
+app_frame_t *app_frame_pool_wrap(app_frame_pool_handle_t pool, uint8_t *buffer, uint32_t size,
+                                 uint32_t pts, bool is_video)
+{
+    if (pool == NULL || buffer == NULL) {
+        return NULL;
+    }
+
+    app_frame_t *frame = NULL;
+    if (xQueueReceive(pool->free_queue, &frame, 0) != pdTRUE) {
+        atomic_fetch_add(&pool->wrap_failures, 1);
+        mem_pool_free(pool->mem_pool, buffer);
+        return NULL;
+    }
+
+    frame->buffer = buffer;
+    frame->size = size;
+    frame->pts = pts;
+    frame->is_video = is_video;
+    atomic_store(&frame->ref_count, 1);
+
+    atomic_fetch_add(&pool->frames_wrapped, 1);
+    unsigned in_use = atomic_fetch_add(&pool->frames_in_use, 1) + 1;
+    unsigned in_use_max = atomic_load(&pool->frames_in_use_max);
+    while (in_use > in_use_max && !atomic_compare_exchange_weak(&pool->frames_in_use_max, &in_use_max, in_use)) {
+    }
+
+    return frame;
+}
+
+void app_frame_ref(app_frame_t *frame)
+{
+    if (frame != NULL) {
+        atomic_fetch_add(&frame->ref_count, 1);
+    }
+}
+
+void app_frame_unref(app_frame_t *frame)
+{
+    if (frame == NULL) {
+        return;
+    }
+
+    if (atomic_fetch_sub(&frame->ref_count, 1) != 1) {
+        return;
+    }
+
+    app_frame_pool_t *pool = frame->pool;
+    mem_pool_free(pool->mem_pool, frame->buffer);
+    frame->buffer = NULL;
+    atomic_fetch_sub(&pool->frames_in_use, 1);
+    xQueueSend(pool->free_queue, &frame, 0);
+}
+
+esp_err_t app_frame_pool_get_stats(app_frame_pool_handle_t pool, app_frame_pool_stats_t *stats)
+{
+    if (pool == NULL || stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    stats->frames_in_use = atomic_load(&pool->frames_in_use);
+    stats->frames_in_use_max = atomic_load(&pool->frames_in_use_max);
+    stats->frames_wrapped = atomic_load(&pool->frames_wrapped);
+    stats->wrap_failures = atomic_load(&pool->wrap_failures);
+
+    return ESP_OK;
+}
+
+esp_err_t app_frame_pool_destroy(app_frame_pool_handle_t pool)
+{
+    if (pool == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t frames_in_use = atomic_load(&pool->frames_in_use);
+    if (frames_in_use > 0) {
+        ESP_LOGW(TAG, "Destroy frame pool with %" PRIu32 " frames in use", frames_in_use);
+    }
+
+    if (pool->mem_pool != NULL) {
+        mem_pool_destroy(pool->mem_pool);
+    }
+    if (pool->free_queue != NULL) {
+        vQueueDelete(pool->free_queue);
+    }
+    free(pool->frames);
+    free(pool);
+
+    return ESP_OK;
+}
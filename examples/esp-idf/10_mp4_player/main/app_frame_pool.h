@@ -0,0 +1,97 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "esp_err.h"
+#include "mem_pool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Frame pool handle
+ */
+typedef struct app_frame_pool_t* app_frame_pool_handle_t;
+
+/**
+ * @brief Reference counted compressed frame
+ *
+ * The data is the buffer output by the extractor, allocated from the memory pool of the frame pool, so it is handed to
+ * the decoders without a copy. It returns to the memory pool when the last reference is released.
+ */
+typedef struct {
+    uint8_t *buffer;                    /*!< Frame data, allocated from the memory pool */
+    uint32_t size;                      /*!< Frame data size */
+    uint32_t pts;                       /*!< Presentation time in milliseconds */
+    bool is_video;                      /*!< True for a video frame, false for an audio frame */
+
+    /* Private members */
+    atomic_uint ref_count;              /*!< Number of references */
+    app_frame_pool_handle_t pool;       /*!< Owner of the frame */
+} app_frame_t;
+
+/**
+ * @brief Frame pool statistics structure
+ */
+typedef struct {
+    uint32_t frames_in_use;             /*!< Frames referenced */
+    uint32_t frames_in_use_max;         /*!< Maximum number of frames referenced at once */
+    uint32_t frames_wrapped;            /*!< Total frames wrapped */
+    uint32_t wrap_failures;             /*!< Frames dropped because no descriptor was free */
+} app_frame_pool_stats_t;
+
+/**
+ * @brief Create a frame pool
+ *
+ * The memory pool and the frame descriptors are allocated once here, so wrapping and releasing frames never allocates.
+ *
+ * @param pool_size Size of the memory pool of the frame data
+ * @param frame_num Maximum number of frames referenced at once
+ * @param ret_pool Pointer to store the frame pool
+ * @return ESP_OK on success, or an error code
+ */
+esp_err_t app_frame_pool_create(uint32_t pool_size, uint32_t frame_num, app_frame_pool_handle_t *ret_pool);
+
+/**
+ * @brief Get the memory pool, to be set as the output pool of the extractor
+ */
+mem_pool_handle_t app_frame_pool_get_mem_pool(app_frame_pool_handle_t pool);
+
+/**
+ * @brief Wrap a buffer of the memory pool into a frame with one reference
+ *
+ * @note The frame owns the buffer. If no descriptor is free, the buffer is freed and NULL is returned.
+ */
+app_frame_t *app_frame_pool_wrap(app_frame_pool_handle_t pool, uint8_t *buffer, uint32_t size,
+                                 uint32_t pts, bool is_video);
+
+/**
+ * @brief Add a reference to a frame
+ */
+void app_frame_ref(app_frame_t *frame);
+
+/**
+ * @brief Release a reference to a frame, the last one returns its buffer to the memory pool
+ */
+void app_frame_unref(app_frame_t *frame);
+
+/**
+ * @brief Get the frame pool statistics
+ */
+esp_err_t app_frame_pool_get_stats(app_frame_pool_handle_t pool, app_frame_pool_stats_t *stats);
+
+/**
+ * @brief Destroy a frame pool, all its frames must have been released
+ */
+esp_err_t app_frame_pool_destroy(app_frame_pool_handle_t pool);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,374 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+
+#include "app_frame_trace.h"
+
+static const char *TAG = "frame_trace";
+
+#define MIN_TRACE_DEPTH     (16)    /*!< Frames in the pipeline at once are far fewer */
+
+/* Chrome trace threads of the pipeline tasks */
+#define TRACE_TID_EXTRACT   (1)
+#define TRACE_TID_DECODE    (2)
+#define TRACE_TID_PRESENT   (3)
+
+/**
+ * @brief Times of a frame
+ *
+ * The times are the low 32 bits of the timer with the lowest bit set, so a point not reached is 0. They are written
+ * with single stores by the stage owning them, and compared by their difference, which holds across the wrap of the
+ * low bits.
+ */
+typedef struct {
+    uint32_t pts;                                   /*!< Presentation time in milliseconds */
+    uint32_t time_us[APP_FRAME_TRACE_POINT_MAX];    /*!< Times of the points, 0 if not reached */
+    uint32_t end_us;                                /*!< Time the frame left the pipeline, 0 if still in it */
+    uint32_t outcome;                               /*!< app_frame_trace_outcome_t */
+} frame_times_t;
+
+/**
+ * @brief Record of a frame in the ring
+ *
+ * The fields of the times are atomic, as a reader may copy them while they are written, and accessed with relaxed
+ * loads and stores, which are single loads and stores as the plain ones. The tag tells whether the copy is valid.
+ */
+typedef struct {
+    atomic_uint tag;                                /*!< Identifier of the frame plus one, 0 while the record is reset */
+    atomic_uint pts;                                /*!< See frame_times_t */
+    atomic_uint time_us[APP_FRAME_TRACE_POINT_MAX];
+    atomic_uint end_us;
+    atomic_uint outcome;
+} frame_record_t;
+
+/**
+ * @brief Frame tracer context structure
+ */
+typedef struct app_frame_trace_t {
+    frame_record_t *records;    /*!< Ring of the records */
+    uint32_t mask;              /*!< Number of records minus one, a power of two */
+    atomic_uint next_id;        /*!< Identifier of the next frame */
+    atomic_uint first_id;       /*!< First frame since the tracer was cleared */
+} app_frame_trace_t;
+
+static inline frame_record_t *get_record(app_frame_trace_t *trace, uint32_t id)
+{
+    return &trace->records[id & trace->mask];
+}
+
+/**
+ * @brief Copy the times of a frame, if its record is not being replaced meanwhile
+ */
+static bool copy_record(app_frame_trace_t *trace, uint32_t id, frame_times_t *times)
+{
+    frame_record_t *record = get_record(trace, id);
+    if (atomic_load(&record->tag) != id + 1) {
+        return false;
+    }
+    times->pts = atomic_load_explicit(&record->pts, memory_order_relaxed);
+    for (int i = 0; i < APP_FRAME_TRACE_POINT_MAX; i++) {
+        times->time_us[i] = atomic_load_explicit(&record->time_us[i], memory_order_relaxed);
+    }
+    times->end_us = atomic_load_explicit(&record->end_us, memory_order_relaxed);
+    times->outcome = atomic_load_explicit(&record->outcome, memory_order_relaxed);
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load(&record->tag) == id + 1;
+}
+
+/**
+ * @brief Get the range of the frames in the ring since the tracer was cleared, the last ones first to go
+ */
+static uint32_t get_range(app_frame_trace_t *trace, uint32_t frames, uint32_t *first_id)
+{
+    uint32_t next_id = atomic_load(&trace->next_id);
+    uint32_t count = next_id - atomic_load(&trace->first_id);
+    if (count > trace->mask + 1) {
+        count = trace->mask + 1;
+    }
+    if ((frames > 0) && (count > frames)) {
+        count = frames;
+    }
+    *first_id = next_id - count;
+    return count;
+}
+
+esp_err_t app_frame_trace_create(uint32_t depth, app_frame_trace_handle_t *ret_trace)
+{
+    if (depth == 0 || ret_trace == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // The identifiers wrap around in the same record with a power of two
+    uint32_t size = MIN_TRACE_DEPTH;
+    while (size < depth) {
+        size <<= 1;
+    }
+
+    app_frame_trace_t *trace = calloc(1, sizeof(app_frame_trace_t));
+    if (trace == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate frame tracer context");
+        return ESP_ERR_NO_MEM;
+    }
+
+    trace->records = heap_caps_calloc(size, sizeof(frame_record_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (trace->records == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate the records of %" PRIu32 " frames", size);
+        free(trace);
+        return ESP_ERR_NO_MEM;
+    }
+    trace->mask = size - 1;
+
+    ESP_LOGI(TAG, "Frame tracer created, %" PRIu32 " frames", size);
+    *ret_trace = trace;
+    return ESP_OK;
+}
+
+uint32_t app_frame_trace_begin(app_frame_trace_handle_t trace, uint32_t pts)
+{
+    if (trace == NULL) {
+        return 0;
+    }
+
+    uint32_t id = atomic_fetch_add(&trace->next_id, 1);
+    frame_record_t *record = get_record(trace, id);
+
+    // The readers and the late marks of the frame replaced skip the record while it is reset. The fence keeps the reset
+    // after the tag is cleared, so a reader copying part of the new frame sees the tag changed
+    atomic_store(&record->tag, 0);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&record->pts, pts, memory_order_relaxed);
+    for (int i = 0; i < APP_FRAME_TRACE_POINT_MAX; i++) {
+        atomic_store_explicit(&record->time_us[i], 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&record->end_us, 0, memory_order_relaxed);
+    atomic_store_explicit(&record->outcome, APP_FRAME_TRACE_PENDING, memory_order_relaxed);
+    atomic_store(&record->tag, id + 1);
+    return id;
+}
+
+void app_frame_trace_mark(app_frame_trace_handle_t trace, uint32_t id, app_frame_trace_point_t point,
+                          int64_t time_us)
+{
+    if ((trace == NULL) || (point >= APP_FRAME_TRACE_POINT_MAX)) {
+        return;
+    }
+
+    frame_record_t *record = get_record(trace, id);
+    if (atomic_load(&record->tag) == id + 1) {
+        atomic_store_explicit(&record->time_us[point], (uint32_t)time_us | 1, memory_order_relaxed);
+    }
+}
+
+void app_frame_trace_end(app_frame_trace_handle_t trace, uint32_t id, app_frame_trace_outcome_t outcome,
+                         int64_t time_us)
+{
+    if (trace == NULL) {
+        return;
+    }
+
+    frame_record_t *record = get_record(trace, id);
+    if (atomic_load(&record->tag) == id + 1) {
+        atomic_store_explicit(&record->outcome, outcome, memory_order_relaxed);
+        atomic_store_explicit(&record->end_us, (uint32_t)time_us | 1, memory_order_relaxed);
+    }
+}
+
+void app_frame_trace_clear(app_frame_trace_handle_t trace)
+{
+    if (trace == NULL) {
+        return;
+    }
+
+    atomic_store(&trace->first_id, atomic_load(&trace->next_id));
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Get a percentile of sorted values, by the nearest rank
+ */
+static uint32_t get_percentile(const uint32_t *sorted, uint32_t count, uint32_t percent)
+{
+    uint32_t rank = (count * percent + 99) / 100;
+    return sorted[(rank > 0) ? rank - 1 : 0];
+}
+
+esp_err_t app_frame_trace_get_summary(app_frame_trace_handle_t trace, app_frame_trace_summary_t *summary)
+{
+    if (trace == NULL || summary == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(summary, 0, sizeof(app_frame_trace_summary_t));
+
+    uint32_t first_id;
+    uint32_t count = get_range(trace, 0, &first_id);
+    if (count == 0) {
+        return ESP_OK;
+    }
+
+    uint32_t *frame_times = malloc(count * sizeof(uint32_t));
+    if (frame_times == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    uint32_t intervals = 0;
+    uint32_t last_vsync = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        frame_times_t times;
+        // A frame replaced meanwhile breaks the sequence of the refreshes
+        if (!copy_record(trace, first_id + i, &times)) {
+            last_vsync = 0;
+            continue;
+        }
+
+        switch (times.outcome) {
+        case APP_FRAME_TRACE_PRESENTED: {
+            uint32_t vsync = times.time_us[APP_FRAME_TRACE_VSYNC];
+            summary->frames++;
+            if ((last_vsync != 0) && (vsync != 0)) {
+                frame_times[intervals++] = vsync - last_vsync;
+            }
+            last_vsync = vsync;
+            break;
+        }
+        case APP_FRAME_TRACE_LATE:
+        case APP_FRAME_TRACE_FAILED:
+            summary->frames++;
+            summary->frames_dropped++;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (summary->frames > 0) {
+        summary->drop_rate = (float)summary->frames_dropped / summary->frames;
+    }
+    if (intervals > 0) {
+        qsort(frame_times, intervals, sizeof(uint32_t), compare_u32);
+        summary->frame_p50_us = get_percentile(frame_times, intervals, 50);
+        summary->frame_p95_us = get_percentile(frame_times, intervals, 95);
+        summary->frame_p99_us = get_percentile(frame_times, intervals, 99);
+        summary->frame_max_us = frame_times[intervals - 1];
+    }
+
+    free(frame_times);
+    return ESP_OK;
+}
+
+/**
+ * @brief Write a complete event of a stage, if the frame went through it
+ */
+static void dump_stage(FILE *out, const frame_times_t *times, uint32_t id, uint32_t base_us, const char *name,
+                       int tid, app_frame_trace_point_t start, app_frame_trace_point_t end)
+{
+    uint32_t start_us = times->time_us[start];
+    uint32_t end_us = times->time_us[end];
+    if ((start_us == 0) || (end_us == 0)) {
+        return;
+    }
+
+    fprintf(out, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%" PRId32 ",\"dur\":%" PRIu32
+            ",\"args\":{\"frame\":%" PRIu32 ",\"pts\":%" PRIu32 "}}",
+            name, tid, (int32_t)(start_us - base_us), end_us - start_us, id, times->pts);
+}
+
+/**
+ * @brief Write an instant event of a frame
+ */
+static void dump_instant(FILE *out, const frame_times_t *times, uint32_t id, uint32_t base_us, const char *name,
+                         int tid, uint32_t time_us)
+{
+    if (time_us == 0) {
+        return;
+    }
+
+    fprintf(out, ",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%" PRId32
+            ",\"args\":{\"frame\":%" PRIu32 ",\"pts\":%" PRIu32 "}}",
+            name, tid, (int32_t)(time_us - base_us), id, times->pts);
+}
+
+static void dump_thread_name(FILE *out, int tid, const char *name)
+{
+    fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+            tid, name);
+}
+
+esp_err_t app_frame_trace_dump(app_frame_trace_handle_t trace, FILE *out, uint32_t frames)
+{
+    if (trace == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t first_id;
+    uint32_t count = get_range(trace, frames, &first_id);
+
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+            "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"mp4_player\"}}");
+    dump_thread_name(out, TRACE_TID_EXTRACT, "extract");
+    dump_thread_name(out, TRACE_TID_DECODE, "decode");
+    dump_thread_name(out, TRACE_TID_PRESENT, "present");
+
+    // The time stamps start at the read of the first frame
+    uint32_t base_us = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t id = first_id + i;
+        frame_times_t times;
+        if (!copy_record(trace, id, &times) || (times.time_us[APP_FRAME_TRACE_READ_START] == 0)) {
+            continue;
+        }
+        if (base_us == 0) {
+            base_us = times.time_us[APP_FRAME_TRACE_READ_START];
+        }
+
+        const uint32_t *time_us = times.time_us;
+        dump_stage(out, &times, id, base_us, "read", TRACE_TID_EXTRACT,
+                   APP_FRAME_TRACE_READ_START, APP_FRAME_TRACE_READ_END);
+        dump_stage(out, &times, id, base_us, "decode", TRACE_TID_DECODE,
+                   APP_FRAME_TRACE_DECODE_START, APP_FRAME_TRACE_DECODE_END);
+        dump_stage(out, &times, id, base_us, "present", TRACE_TID_PRESENT,
+                   APP_FRAME_TRACE_PRESENT, APP_FRAME_TRACE_VSYNC);
+        dump_instant(out, &times, id, base_us, "vsync", TRACE_TID_PRESENT, time_us[APP_FRAME_TRACE_VSYNC]);
+
+        // A late frame is dropped by the decode stage before its decoding, or by the present stage after it
+        if (times.outcome == APP_FRAME_TRACE_LATE) {
+            bool decoded = (time_us[APP_FRAME_TRACE_DECODE_END] != 0);
+            dump_instant(out, &times, id, base_us, "late", decoded ? TRACE_TID_PRESENT : TRACE_TID_DECODE,
+                         times.end_us);
+        } else if (times.outcome == APP_FRAME_TRACE_FAILED) {
+            dump_instant(out, &times, id, base_us, "failed", TRACE_TID_DECODE, times.end_us);
+        }
+    }
+
+    fprintf(out, "\n]}\n");
+    fflush(out);
+    return ferror(out) ? ESP_FAIL : ESP_OK;
+}
+
+esp_err_t app_frame_trace_destroy(app_frame_trace_handle_t trace)
+{
+    if (trace == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    heap_caps_free(trace->records);
+    free(trace);
+    return ESP_OK;
+}
@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Frame tracer handle
+ */
+typedef struct app_frame_trace_t* app_frame_trace_handle_t;
+
+/**
+ * @brief Points in time of a frame through the pipeline
+ */
+typedef enum {
+    APP_FRAME_TRACE_READ_START,     /*!< The extractor starts to read the frame */
+    APP_FRAME_TRACE_READ_END,       /*!< The frame is read, before it waits for room in the decode queue */
+    APP_FRAME_TRACE_DECODE_START,   /*!< The decoder starts, once an output buffer is free */
+    APP_FRAME_TRACE_DECODE_END,     /*!< The frame is decoded */
+    APP_FRAME_TRACE_PRESENT,        /*!< The frame is due and given to the frame callback */
+    APP_FRAME_TRACE_VSYNC,          /*!< The frame callback returns, on the refresh of the panel */
+    APP_FRAME_TRACE_POINT_MAX,
+} app_frame_trace_point_t;
+
+/**
+ * @brief Outcome of a frame
+ */
+typedef enum {
+    APP_FRAME_TRACE_PENDING,        /*!< Still in the pipeline */
+    APP_FRAME_TRACE_PRESENTED,      /*!< Presented */
+    APP_FRAME_TRACE_LATE,           /*!< Dropped because it was late on the A/V sync clock */
+    APP_FRAME_TRACE_FAILED,         /*!< Dropped because it failed to decode */
+    APP_FRAME_TRACE_NO_PICTURE,     /*!< Decoded without picture, e.g. H.264 parameter sets only */
+} app_frame_trace_outcome_t;
+
+/**
+ * @brief Frame times derived from the frames traced
+ *
+ * The frame time is the interval between the refreshes of two frames presented one after the other, so a frame
+ * dropped in between or a stage running late shows up as a longer frame time.
+ */
+typedef struct {
+    uint32_t frames;                /*!< Frames traced out of the pipeline, presented or dropped */
+    uint32_t frames_dropped;        /*!< Frames of them dropped, late or failed */
+    float drop_rate;                /*!< Frames dropped out of the frames, from 0 to 1 */
+    uint32_t frame_p50_us;          /*!< Median frame time */
+    uint32_t frame_p95_us;          /*!< 95th percentile of the frame time */
+    uint32_t frame_p99_us;          /*!< 99th percentile of the frame time */
+    uint32_t frame_max_us;          /*!< Maximum frame time */
+} app_frame_trace_summary_t;
+
+/**
+ * @brief Create a frame tracer
+ *
+ * The times of the last frames are kept in a ring of records, one per frame. The extract task starts a record, then
+ * each stage writes its own times into it, without lock, so the tracing costs a few stores per stage. The ring can be
+ * read at any time, a record overwritten while it is copied is skipped.
+ *
+ * @param depth Frames kept, at least as many as the frames in the pipeline at once
+ * @param ret_trace Pointer to store the frame tracer handle
+ * @return ESP_OK on success, or an error code
+ */
+esp_err_t app_frame_trace_create(uint32_t depth, app_frame_trace_handle_t *ret_trace);
+
+/**
+ * @brief Start the record of a frame, replacing the oldest one
+ *
+ * @note The functions recording a frame can be called from several tasks at once, and do nothing without tracer
+ *
+ * @param trace Frame tracer handle, or NULL
+ * @param pts Presentation time of the frame in milliseconds
+ * @return Identifier of the frame, for the other points of the frame
+ */
+uint32_t app_frame_trace_begin(app_frame_trace_handle_t trace, uint32_t pts);
+
+/**
+ * @brief Record a point in time of a frame
+ *
+ * @param trace Frame tracer handle, or NULL
+ * @param id Identifier of the frame
+ * @param point Point in the pipeline
+ * @param time_us Time in microseconds of `esp_timer_get_time()`
+ */
+void app_frame_trace_mark(app_frame_trace_handle_t trace, uint32_t id, app_frame_trace_point_t point,
+                          int64_t time_us);
+
+/**
+ * @brief Record the outcome of a frame, once it leaves the pipeline
+ */
+void app_frame_trace_end(app_frame_trace_handle_t trace, uint32_t id, app_frame_trace_outcome_t outcome,
+                         int64_t time_us);
+
+/**
+ * @brief Forget the frames recorded so far, e.g. at the start of a file or after a seek
+ */
+void app_frame_trace_clear(app_frame_trace_handle_t trace);
+
+/**
+ * @brief Get the frame times and the drop rate of the frames in the ring
+ */
+esp_err_t app_frame_trace_get_summary(app_frame_trace_handle_t trace, app_frame_trace_summary_t *summary);
+
+/**
+ * @brief Write the frames in the ring as a Chrome trace, in JSON
+ *
+ * The stages of each frame are complete events on one thread per task, the refreshes and the drops instant events,
+ * for `chrome://tracing` or Perfetto.
+ *
+ * @param trace Frame tracer handle
+ * @param out Stream to write to, e.g. stdout or a file
+ * @param frames Last frames to write, 0 for all of them
+ * @return ESP_OK on success, ESP_FAIL if the stream failed, or an error code
+ */
+esp_err_t app_frame_trace_dump(app_frame_trace_handle_t trace, FILE *out, uint32_t frames);
+
+/**
+ * @brief Destroy a frame tracer
+ */
+esp_err_t app_frame_trace_destroy(app_frame_trace_handle_t trace);
+
+#ifdef __cplusplus
+}
+#endif
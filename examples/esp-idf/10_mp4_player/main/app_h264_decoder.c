@@ -0,0 +1,409 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "esp_cache.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_h264_dec.h"
+#include "esp_h264_dec_sw.h"
+
+#include "app_h264_decoder.h"
+#include "app_yuv_convert.h"
+
+static const char *TAG = "h264_decoder";
+
+#define H264_NAL_TYPE_SPS       (7)
+#define H264_NAL_TYPE_SLICE_MAX (5)     /*!< Types of the slices, 1 to 5, which follow the parameter sets */
+
+/**
+ * @brief Accumulated timing of a step of the decoding
+ */
+typedef struct {
+    uint64_t total_us;      /*!< Sum of the frame times */
+    uint32_t count;         /*!< Number of frames */
+    uint32_t max_us;        /*!< Maximum frame time */
+} decoder_timing_t;
+
+/**
+ * @brief Task converting a band of rows of each picture
+ */
+typedef struct {
+    struct app_h264_decoder_t *decoder; /*!< Owner of the task */
+    TaskHandle_t task_handle;           /*!< Handle of the task, NULL if not created */
+    uint32_t row;                       /*!< First row of the band of the current picture */
+    uint32_t rows;                      /*!< Rows of the band */
+} convert_worker_t;
+
+/**
+ * @brief H.264 decoder context structure
+ */
+typedef struct app_h264_decoder_t {
+    app_h264_decoder_config_t config;   /*!< H.264 decoder configuration */
+    esp_h264_dec_handle_t dec;          /*!< Software decoder, NULL until opened */
+    esp_h264_dec_param_sw_handle_t param;   /*!< Parameters of the software decoder */
+    uint32_t sps_hash;                  /*!< Hash of the sequence parameter set decoded, 0 for none */
+
+    /* Conversion of the current picture */
+    app_yuv_picture_t picture;          /*!< Picture decoded */
+    uint8_t *out;                       /*!< Output buffer */
+    uint32_t out_stride;                /*!< Bytes between two rows of the output */
+    convert_worker_t *workers;          /*!< Converting tasks */
+    SemaphoreHandle_t done_sem;         /*!< Given by a converting task once its band is done, or once stopped */
+    volatile bool stopping;             /*!< Set to stop the converting tasks */
+
+    /* Statistics */
+    uint32_t frames;                    /*!< Pictures output */
+    uint32_t reopens;                   /*!< Times the decoder was reopened */
+    decoder_timing_t decode_timing;     /*!< Decoding into YUV */
+    decoder_timing_t convert_timing;    /*!< Conversion to RGB */
+} app_h264_decoder_t;
+
+static void timing_add(decoder_timing_t *timing, int64_t elapsed_us)
+{
+    timing->total_us += elapsed_us;
+    timing->count++;
+    if (elapsed_us > timing->max_us) {
+        timing->max_us = elapsed_us;
+    }
+}
+
+/**
+ * @brief Find the NAL unit after the next start code, or NULL
+ */
+static const uint8_t *find_nal(const uint8_t *data, const uint8_t *end)
+{
+    for (const uint8_t *p = data; p + 3 < end; p++) {
+        if ((p[0] == 0) && (p[1] == 0) && (p[2] == 1)) {
+            return p + 3;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Get a hash of the sequence parameter set before the slices of a frame, 0 without one
+ */
+static uint32_t get_sps_hash(const uint8_t *data, uint32_t size)
+{
+    const uint8_t *end = data + size;
+    const uint8_t *nal = find_nal(data, end);
+    while (nal != NULL) {
+        uint8_t type = nal[0] & 0x1F;
+        if ((type >= 1) && (type <= H264_NAL_TYPE_SLICE_MAX)) {
+            return 0;
+        }
+
+        const uint8_t *next = find_nal(nal, end);
+        if (type == H264_NAL_TYPE_SPS) {
+            // The zeros before the next start code are no part of the NAL unit
+            const uint8_t *nal_end = (next != NULL) ? next - 3 : end;
+            while ((nal_end > nal) && (nal_end[-1] == 0)) {
+                nal_end--;
+            }
+            // FNV-1a, never 0 in practice
+            uint32_t hash = 2166136261u;
+            for (const uint8_t *p = nal; p < nal_end; p++) {
+                hash = (hash ^ *p) * 16777619u;
+            }
+            return (hash != 0) ? hash : 1;
+        }
+        nal = next;
+    }
+    return 0;
+}
+
+static void close_decoder(app_h264_decoder_t *decoder)
+{
+    if (decoder->dec != NULL) {
+        esp_h264_dec_close(decoder->dec);
+        esp_h264_dec_del(decoder->dec);
+        decoder->dec = NULL;
+        decoder->param = NULL;
+    }
+}
+
+static esp_err_t open_decoder(app_h264_decoder_t *decoder)
+{
+    esp_h264_dec_cfg_sw_t dec_config = {
+        .pic_type = ESP_H264_RAW_FMT_I420,
+    };
+    esp_h264_err_t ret = esp_h264_dec_sw_new(&dec_config, &decoder->dec);
+    if (ret != ESP_H264_ERR_OK) {
+        ESP_LOGE(TAG, "Failed to create decoder: %d", ret);
+        decoder->dec = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    ret = esp_h264_dec_sw_get_param_hd(decoder->dec, &decoder->param);
+    if (ret == ESP_H264_ERR_OK) {
+        ret = esp_h264_dec_open(decoder->dec);
+    }
+    if (ret != ESP_H264_ERR_OK) {
+        ESP_LOGE(TAG, "Failed to open decoder: %d", ret);
+        esp_h264_dec_del(decoder->dec);
+        decoder->dec = NULL;
+        decoder->param = NULL;
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Convert a band of rows of the current picture, and write it back from the cache
+ */
+static void convert_band(app_h264_decoder_t *decoder, uint32_t row, uint32_t rows)
+{
+    if (row + rows > decoder->picture.height) {
+        rows = (row < decoder->picture.height) ? decoder->picture.height - row : 0;
+    }
+    if (rows == 0) {
+        return;
+    }
+
+    uint8_t *out = decoder->out + row * decoder->out_stride;
+    app_yuv_convert_rows(&decoder->picture, row, rows, decoder->config.output_format, decoder->config.bgr_order,
+                         decoder->out, decoder->out_stride);
+
+    // Fails for the memory out of the cache, which needs no write back
+    esp_cache_msync(out, rows * decoder->out_stride, ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_UNALIGNED);
+}
+
+static void convert_task(void *arg)
+{
+    convert_worker_t *worker = (convert_worker_t *)arg;
+    app_h264_decoder_t *decoder = worker->decoder;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (decoder->stopping) {
+            break;
+        }
+        convert_band(decoder, worker->row, worker->rows);
+        xSemaphoreGive(decoder->done_sem);
+    }
+
+    xSemaphoreGive(decoder->done_sem);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Convert the current picture, in bands of pairs of rows shared by the caller and the converting tasks
+ */
+static void convert_picture(app_h264_decoder_t *decoder)
+{
+    uint32_t bands = decoder->config.convert_tasks + 1;
+    uint32_t pairs = (decoder->picture.height + 1) / 2;
+
+    for (uint32_t i = 0; i < decoder->config.convert_tasks; i++) {
+        convert_worker_t *worker = &decoder->workers[i];
+        worker->row = 2 * (pairs * (i + 1) / bands);
+        worker->rows = 2 * (pairs * (i + 2) / bands) - worker->row;
+        xTaskNotifyGive(worker->task_handle);
+    }
+
+    convert_band(decoder, 0, 2 * (pairs / bands));
+
+    for (uint32_t i = 0; i < decoder->config.convert_tasks; i++) {
+        xSemaphoreTake(decoder->done_sem, portMAX_DELAY);
+    }
+}
+
+static void free_decoder(app_h264_decoder_t *decoder)
+{
+    if (decoder->workers != NULL) {
+        decoder->stopping = true;
+        for (uint32_t i = 0; i < decoder->config.convert_tasks; i++) {
+            if (decoder->workers[i].task_handle != NULL) {
+                xTaskNotifyGive(decoder->workers[i].task_handle);
+            }
+        }
+        for (uint32_t i = 0; i < decoder->config.convert_tasks; i++) {
+            if (decoder->workers[i].task_handle != NULL) {
+                xSemaphoreTake(decoder->done_sem, portMAX_DELAY);
+            }
+        }
+        free(decoder->workers);
+    }
+    if (decoder->done_sem != NULL) {
+        vSemaphoreDelete(decoder->done_sem);
+    }
+    close_decoder(decoder);
+    free(decoder);
+}
+
+esp_err_t app_h264_decoder_create(const app_h264_decoder_config_t *config, app_h264_decoder_handle_t *ret_decoder)
+{
+    if (config == NULL || ret_decoder == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_h264_decoder_t *decoder = calloc(1, sizeof(app_h264_decoder_t));
+    if (decoder == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    decoder->config = *config;
+
+    esp_err_t ret = open_decoder(decoder);
+    if (ret != ESP_OK) {
+        free_decoder(decoder);
+        return ret;
+    }
+
+    if (config->convert_tasks > 0) {
+        decoder->done_sem = xSemaphoreCreateCounting(config->convert_tasks, 0);
+        decoder->workers = calloc(config->convert_tasks, sizeof(convert_worker_t));
+        if ((decoder->done_sem == NULL) || (decoder->workers == NULL)) {
+            decoder->config.convert_tasks = 0;
+            free_decoder(decoder);
+            return ESP_ERR_NO_MEM;
+        }
+
+        for (uint32_t i = 0; i < config->convert_tasks; i++) {
+            decoder->workers[i].decoder = decoder;
+            if (xTaskCreate(convert_task, "h264_convert", config->task_stack_size, &decoder->workers[i],
+                            config->task_priority, &decoder->workers[i].task_handle) != pdPASS) {
+                ESP_LOGE(TAG, "Failed to create converting task");
+                decoder->workers[i].task_handle = NULL;
+                free_decoder(decoder);
+                return ESP_FAIL;
+            }
+        }
+    }
+
+    ESP_LOGI(TAG, "H.264 decoder created, %d converting tasks", config->convert_tasks);
+    *ret_decoder = decoder;
+    return ESP_OK;
+}
+
+esp_err_t app_h264_decoder_decode(app_h264_decoder_handle_t decoder, const uint8_t *data, uint32_t size,
+                                  void *out, uint32_t out_size, uint32_t *width, uint32_t *height, uint32_t *out_len)
+{
+    if (decoder == NULL || data == NULL || out == NULL || width == NULL || height == NULL || out_len == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Another sequence, e.g. of the next file, may change the size of the pictures
+    uint32_t sps_hash = get_sps_hash(data, size);
+    if ((sps_hash != 0) && (sps_hash != decoder->sps_hash)) {
+        if (decoder->sps_hash != 0) {
+            close_decoder(decoder);
+            decoder->reopens++;
+        }
+        decoder->sps_hash = sps_hash;
+    }
+    if (decoder->dec == NULL) {
+        esp_err_t ret = open_decoder(decoder);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+
+    // The decoder takes one NAL unit at a time
+    int64_t start_us = esp_timer_get_time();
+    esp_h264_dec_in_frame_t in_frame = {
+        .raw_data.buffer = (uint8_t *)data,
+        .raw_data.len = size,
+    };
+    esp_h264_dec_out_frame_t out_frame = {0};
+    const uint8_t *yuv = NULL;
+    uint32_t yuv_size = 0;
+    while (in_frame.raw_data.len > 0) {
+        esp_h264_err_t ret = esp_h264_dec_process(decoder->dec, &in_frame, &out_frame);
+        if (ret != ESP_H264_ERR_OK) {
+            ESP_LOGW(TAG, "Failed to decode frame: %d", ret);
+            return ESP_FAIL;
+        }
+        if (out_frame.out_size > 0) {
+            yuv = out_frame.outbuf;
+            yuv_size = out_frame.out_size;
+        }
+        if ((in_frame.consume == 0) || (in_frame.consume > in_frame.raw_data.len)) {
+            break;
+        }
+        in_frame.raw_data.buffer += in_frame.consume;
+        in_frame.raw_data.len -= in_frame.consume;
+    }
+    timing_add(&decoder->decode_timing, esp_timer_get_time() - start_us);
+    if (yuv == NULL) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+
+    esp_h264_resolution_t resolution = {0};
+    if (esp_h264_dec_get_resolution(&decoder->param->base, &resolution) != ESP_H264_ERR_OK) {
+        return ESP_FAIL;
+    }
+
+    // I420, the chroma planes after the luma plane
+    uint32_t uv_stride = (resolution.width + 1) / 2;
+    uint32_t uv_size = uv_stride * ((resolution.height + 1) / 2);
+    uint32_t y_size = (uint32_t)resolution.width * resolution.height;
+    if ((y_size == 0) || (yuv_size < y_size + 2 * uv_size)) {
+        ESP_LOGW(TAG, "Picture of %" PRIu32 " bytes for %dx%d", yuv_size, resolution.width, resolution.height);
+        return ESP_FAIL;
+    }
+
+    uint32_t bytes_per_pixel = (decoder->config.output_format == APP_VIDEO_PIXEL_RGB888) ? 3 : 2;
+    uint32_t required_size = y_size * bytes_per_pixel;
+    if (required_size > out_size) {
+        ESP_LOGE(TAG, "Buffer too small: required=%" PRIu32 ", available=%" PRIu32, required_size, out_size);
+        return ESP_ERR_NO_MEM;
+    }
+
+    start_us = esp_timer_get_time();
+    decoder->picture = (app_yuv_picture_t) {
+        .y = yuv,
+        .u = yuv + y_size,
+        .v = yuv + y_size + uv_size,
+        .y_stride = resolution.width,
+        .uv_stride = uv_stride,
+        .width = resolution.width,
+        .height = resolution.height,
+    };
+    decoder->out = out;
+    decoder->out_stride = resolution.width * bytes_per_pixel;
+    convert_picture(decoder);
+    timing_add(&decoder->convert_timing, esp_timer_get_time() - start_us);
+
+    decoder->frames++;
+    *width = resolution.width;
+    *height = resolution.height;
+    *out_len = required_size;
+    return ESP_OK;
+}
+
+esp_err_t app_h264_decoder_get_stats(app_h264_decoder_handle_t decoder, app_h264_decoder_stats_t *stats)
+{
+    if (decoder == NULL || stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const decoder_timing_t *decode = &decoder->decode_timing;
+    const decoder_timing_t *convert = &decoder->convert_timing;
+    stats->frames = decoder->frames;
+    stats->decode_avg_us = (decode->count > 0) ? (uint32_t)(decode->total_us / decode->count) : 0;
+    stats->decode_max_us = decode->max_us;
+    stats->convert_avg_us = (convert->count > 0) ? (uint32_t)(convert->total_us / convert->count) : 0;
+    stats->convert_max_us = convert->max_us;
+    stats->reopens = decoder->reopens;
+    return ESP_OK;
+}
+
+esp_err_t app_h264_decoder_destroy(app_h264_decoder_handle_t decoder)
+{
+    if (decoder == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    free_decoder(decoder);
+    return ESP_OK;
+}
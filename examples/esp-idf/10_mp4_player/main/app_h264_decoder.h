@@ -0,0 +1,104 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "app_video_scaler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief H.264 decoder handle
+ */
+typedef struct app_h264_decoder_t* app_h264_decoder_handle_t;
+
+/**
+ * @brief H.264 decoder configuration structure
+ */
+typedef struct {
+    app_video_pixel_format_t output_format; /*!< Pixel format of the output */
+    bool bgr_order;                         /*!< True for the blue in the low bits or the first byte, as for JPEG */
+    uint8_t convert_tasks;                  /*!< Tasks converting a part of the rows with the caller, 0 for none */
+    uint32_t task_priority;                 /*!< Priority of the converting tasks */
+    uint32_t task_stack_size;               /*!< Stack size of the converting tasks */
+} app_h264_decoder_config_t;
+
+/**
+ * @brief Helper macro to create default H.264 decoder configuration for RGB565 with BGR order
+ */
+#define APP_H264_DECODER_CONFIG_DEFAULT()               \
+    {                                                   \
+        .output_format = APP_VIDEO_PIXEL_RGB565,        \
+        .bgr_order = true,                              \
+        .convert_tasks = 1,                             \
+        .task_priority = 5,                             \
+        .task_stack_size = 3 * 1024,                    \
+    }
+
+/**
+ * @brief H.264 decoder statistics structure
+ */
+typedef struct {
+    uint32_t frames;                /*!< Pictures output */
+    uint32_t decode_avg_us;         /*!< Average decoding time of a frame, into YUV */
+    uint32_t decode_max_us;         /*!< Maximum decoding time of a frame */
+    uint32_t convert_avg_us;        /*!< Average conversion time of a picture, to RGB */
+    uint32_t convert_max_us;        /*!< Maximum conversion time of a picture */
+    uint32_t reopens;               /*!< Times the decoder was reopened for a new sequence parameter set */
+} app_h264_decoder_stats_t;
+
+/**
+ * @brief Create an H.264 decoder
+ *
+ * The frames are decoded into YUV 4:2:0 by the software decoder of the `esp_h264` component, which takes the baseline
+ * profile, then converted to RGB by `app_yuv_convert` straight into the output buffer. The decoding of a frame runs
+ * in the caller, while the rows of the picture are converted by the caller and the converting tasks at once, in
+ * bands of the same height, so the conversion runs on all the cores. A new sequence parameter set, e.g. of the next
+ * file in a playlist, reopens the decoder, so it can change the size of the pictures.
+ *
+ * @param config H.264 decoder configuration
+ * @param ret_decoder Pointer to store the H.264 decoder handle
+ * @return ESP_OK on success, or an error code
+ */
+esp_err_t app_h264_decoder_create(const app_h264_decoder_config_t *config, app_h264_decoder_handle_t *ret_decoder);
+
+/**
+ * @brief Decode a frame into an output buffer
+ *
+ * @note The rows of the output are `width` pixels apart, and the cache of the CPU is written back to the buffer, so a
+ *       DMA can read it
+ *
+ * @param decoder H.264 decoder handle
+ * @param data Frame in Annex-B, with the parameter sets before the first one
+ * @param size Size of the frame
+ * @param out Output buffer
+ * @param out_size Size of the output buffer
+ * @param width Pointer to store the width of the picture
+ * @param height Pointer to store the height of the picture
+ * @param out_len Pointer to store the size of the picture in the output buffer
+ * @return ESP_OK on success, ESP_ERR_NOT_FINISHED if the frame output no picture, ESP_ERR_NO_MEM if the picture does
+ *         not fit in the output buffer, or another error code
+ */
+esp_err_t app_h264_decoder_decode(app_h264_decoder_handle_t decoder, const uint8_t *data, uint32_t size,
+                                  void *out, uint32_t out_size, uint32_t *width, uint32_t *height, uint32_t *out_len);
+
+/**
+ * @brief Get the H.264 decoder statistics
+ */
+esp_err_t app_h264_decoder_get_stats(app_h264_decoder_handle_t decoder, app_h264_decoder_stats_t *stats);
+
+/**
+ * @brief Destroy an H.264 decoder
+ */
+esp_err_t app_h264_decoder_destroy(app_h264_decoder_handle_t decoder);
+
+#ifdef __cplusplus
+}
+#endif
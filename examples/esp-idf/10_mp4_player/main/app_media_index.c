@@ -0,0 +1,325 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+
+#include "app_media_index.h"
+
+static const char *TAG = "media_index";
+
+#define INDEX_MAGIC             (0x5844494D)    /*!< "MIDX" */
+#define INDEX_VERSION           (1)
+#define INDEX_PATH_MAX          (256)
+#define INDEX_KEYFRAME_FLAG     (1u << 31)
+#define INDEX_SIZE_MASK         (~INDEX_KEYFRAME_FLAG)
+#define INDEX_FRAME_HINT_MIN    (256)
+
+/**
+ * @brief Video frame as stored in the index, 8 bytes
+ */
+typedef struct {
+    uint32_t pts;                   /*!< Presentation time in milliseconds */
+    uint32_t size_flags;            /*!< Size of the frame, and INDEX_KEYFRAME_FLAG */
+} index_entry_t;
+
+/**
+ * @brief Header of the index file, followed by the frames
+ */
+typedef struct {
+    uint32_t magic;                 /*!< INDEX_MAGIC */
+    uint16_t version;               /*!< INDEX_VERSION */
+    uint16_t entry_size;            /*!< Size of an entry */
+    uint32_t media_size;            /*!< Size of the media file */
+    uint32_t media_mtime;           /*!< Modification time of the media file */
+    app_media_index_info_t info;    /*!< Stream information */
+    uint32_t frame_count;           /*!< Number of frames */
+} index_header_t;
+
+/**
+ * @brief Media index context structure
+ */
+typedef struct app_media_index_t {
+    app_media_index_info_t info;    /*!< Stream information */
+    index_entry_t *frames;          /*!< Frames in PTS order, in PSRAM */
+    uint32_t frame_count;           /*!< Number of frames */
+    uint32_t frame_capacity;        /*!< Number of frames allocated */
+} app_media_index_t;
+
+static esp_err_t get_index_path(const char *media_path, char *path)
+{
+    int len = snprintf(path, INDEX_PATH_MAX, "%s%s", media_path, APP_MEDIA_INDEX_SUFFIX);
+    return (len > 0 && len < INDEX_PATH_MAX) ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+/**
+ * @brief Open the index of a media file, and check that it matches the media file
+ */
+static FILE *open_index(const char *media_path, index_header_t *header)
+{
+    char path[INDEX_PATH_MAX];
+    struct stat media_stat;
+    if (get_index_path(media_path, path) != ESP_OK || stat(media_path, &media_stat) != 0) {
+        return NULL;
+    }
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+
+    if (fread(header, sizeof(index_header_t), 1, file) != 1 ||
+            header->magic != INDEX_MAGIC || header->version != INDEX_VERSION ||
+            header->entry_size != sizeof(index_entry_t) ||
+            header->media_size != (uint32_t)media_stat.st_size ||
+            header->media_mtime != (uint32_t)media_stat.st_mtime) {
+        ESP_LOGW(TAG, "Index of %s is outdated", media_path);
+        fclose(file);
+        return NULL;
+    }
+
+    return file;
+}
+
+static esp_err_t reserve_frames(app_media_index_t *index, uint32_t frame_num)
+{
+    if (frame_num <= index->frame_capacity) {
+        return ESP_OK;
+    }
+
+    index_entry_t *frames = heap_caps_realloc(index->frames, frame_num * sizeof(index_entry_t),
+                                              MALLOC_CAP_SPIRAM);
+    if (frames == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate %" PRIu32 " frames", frame_num);
+        return ESP_ERR_NO_MEM;
+    }
+
+    index->frames = frames;
+    index->frame_capacity = frame_num;
+    return ESP_OK;
+}
+
+esp_err_t app_media_index_load(const char *media_path, app_media_index_handle_t *ret_index)
+{
+    if (media_path == NULL || ret_index == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    index_header_t header;
+    FILE *file = open_index(media_path, &header);
+    if (file == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    app_media_index_t *index = calloc(1, sizeof(app_media_index_t));
+    if (index == NULL) {
+        fclose(file);
+        return ESP_ERR_NO_MEM;
+    }
+
+    index->info = header.info;
+    esp_err_t ret = reserve_frames(index, (header.frame_count > 0) ? header.frame_count : 1);
+    if (ret == ESP_OK && fread(index->frames, sizeof(index_entry_t), header.frame_count, file) != header.frame_count) {
+        ESP_LOGE(TAG, "Index of %s is truncated", media_path);
+        ret = ESP_ERR_NOT_FOUND;
+    }
+    fclose(file);
+
+    if (ret != ESP_OK) {
+        app_media_index_destroy(index);
+        return ret;
+    }
+
+    index->frame_count = header.frame_count;
+    *ret_index = index;
+    return ESP_OK;
+}
+
+esp_err_t app_media_index_load_info(const char *media_path, app_media_index_info_t *info)
+{
+    if (media_path == NULL || info == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    index_header_t header;
+    FILE *file = open_index(media_path, &header);
+    if (file == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    fclose(file);
+
+    *info = header.info;
+    return ESP_OK;
+}
+
+esp_err_t app_media_index_create(const app_media_index_info_t *info, uint32_t frame_hint,
+                                 app_media_index_handle_t *ret_index)
+{
+    if (info == NULL || ret_index == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_media_index_t *index = calloc(1, sizeof(app_media_index_t));
+    if (index == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    index->info = *info;
+    esp_err_t ret = reserve_frames(index, (frame_hint > INDEX_FRAME_HINT_MIN) ? frame_hint : INDEX_FRAME_HINT_MIN);
+    if (ret != ESP_OK) {
+        app_media_index_destroy(index);
+        return ret;
+    }
+
+    *ret_index = index;
+    return ESP_OK;
+}
+
+esp_err_t app_media_index_add_frame(app_media_index_handle_t index, uint32_t pts, uint32_t size, bool keyframe)
+{
+    if (index == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if ((index->frame_count > 0) && (pts < index->frames[index->frame_count - 1].pts)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (index->frame_count == index->frame_capacity) {
+        esp_err_t ret = reserve_frames(index, index->frame_capacity * 2);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+
+    index->frames[index->frame_count++] = (index_entry_t) {
+        .pts = pts,
+        .size_flags = (size & INDEX_SIZE_MASK) | (keyframe ? INDEX_KEYFRAME_FLAG : 0),
+    };
+    return ESP_OK;
+}
+
+esp_err_t app_media_index_save(app_media_index_handle_t index, const char *media_path)
+{
+    if (index == NULL || media_path == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    char path[INDEX_PATH_MAX];
+    struct stat media_stat;
+    if (get_index_path(media_path, path) != ESP_OK || stat(media_path, &media_stat) != 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    index_header_t header = {
+        .magic = INDEX_MAGIC,
+        .version = INDEX_VERSION,
+        .entry_size = sizeof(index_entry_t),
+        .media_size = (uint32_t)media_stat.st_size,
+        .media_mtime = (uint32_t)media_stat.st_mtime,
+        .info = index->info,
+        .frame_count = index->frame_count,
+    };
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        ESP_LOGW(TAG, "Failed to create %s: %d", path, errno);
+        return ESP_FAIL;
+    }
+
+    bool written = (fwrite(&header, sizeof(header), 1, file) == 1) &&
+                   (fwrite(index->frames, sizeof(index_entry_t), index->frame_count, file) == index->frame_count);
+    written = (fclose(file) == 0) && written;
+
+    // A partial index is not left behind, it would be rejected as truncated on every load
+    if (!written) {
+        ESP_LOGW(TAG, "Failed to write %s", path);
+        remove(path);
+        return ESP_FAIL;
+    }
+
+    return ESP_OK;
+}
+
+const app_media_index_info_t *app_media_index_get_info(app_media_index_handle_t index)
+{
+    return (index != NULL) ? &index->info : NULL;
+}
+
+uint32_t app_media_index_get_frame_count(app_media_index_handle_t index)
+{
+    return (index != NULL) ? index->frame_count : 0;
+}
+
+esp_err_t app_media_index_get_frame(app_media_index_handle_t index, uint32_t frame_index,
+                                    app_media_index_frame_t *frame)
+{
+    if (index == NULL || frame == NULL || frame_index >= index->frame_count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    frame->pts = index->frames[frame_index].pts;
+    frame->size = index->frames[frame_index].size_flags & INDEX_SIZE_MASK;
+    frame->keyframe = (index->frames[frame_index].size_flags & INDEX_KEYFRAME_FLAG) != 0;
+    return ESP_OK;
+}
+
+esp_err_t app_media_index_find_keyframe(app_media_index_handle_t index, uint32_t position,
+                                        uint32_t *frame_index, uint32_t *pts)
+{
+    if (index == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (index->frame_count == 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Last frame with a PTS at or before the position, or the first frame
+    uint32_t low = 0;
+    uint32_t high = index->frame_count;
+    while (high - low > 1) {
+        uint32_t mid = low + (high - low) / 2;
+        if (index->frames[mid].pts <= position) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    // Walk back to its key frame, every frame is a key frame for MJPEG
+    for (uint32_t i = low + 1; i-- > 0;) {
+        if (index->frames[i].size_flags & INDEX_KEYFRAME_FLAG) {
+            if (frame_index) {
+                *frame_index = i;
+            }
+            if (pts) {
+                *pts = index->frames[i].pts;
+            }
+            return ESP_OK;
+        }
+    }
+
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t app_media_index_destroy(app_media_index_handle_t index)
+{
+    if (index == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    heap_caps_free(index->frames);
+    free(index);
+    return ESP_OK;
+}
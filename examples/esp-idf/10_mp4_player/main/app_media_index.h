@@ -0,0 +1,123 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define APP_MEDIA_INDEX_SUFFIX          ".idx"      /*!< Suffix of the index file, next to the media file */
+
+/**
+ * @brief Media index handle
+ */
+typedef struct app_media_index_t* app_media_index_handle_t;
+
+/**
+ * @brief Stream information kept in the index
+ */
+typedef struct {
+    uint32_t width;                 /*!< Video width */
+    uint32_t height;                /*!< Video height */
+    uint32_t fps;                   /*!< Video frames per second */
+    uint32_t duration;              /*!< Video duration in milliseconds */
+    uint32_t audio_sample_rate;     /*!< Audio sample rate, 0 without audio */
+    uint8_t audio_channels;         /*!< Audio channels */
+    uint8_t audio_bits;             /*!< Audio bits per sample */
+    uint32_t audio_duration;        /*!< Audio duration in milliseconds */
+} app_media_index_info_t;
+
+/**
+ * @brief Video frame of the index
+ */
+typedef struct {
+    uint32_t pts;                   /*!< Presentation time in milliseconds */
+    uint32_t size;                  /*!< Size of the compressed frame */
+    bool keyframe;                  /*!< True if the frame is decoded on its own */
+} app_media_index_frame_t;
+
+/**
+ * @brief Load the index of a media file
+ *
+ * The index is built once by a full playback of the file, and stored next to it. It is valid as long as the size and
+ * the modification time of the media file are unchanged.
+ *
+ * @param media_path Path of the media file
+ * @param ret_index Pointer to store the index handle
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if there is no valid index, or another error code
+ */
+esp_err_t app_media_index_load(const char *media_path, app_media_index_handle_t *ret_index);
+
+/**
+ * @brief Load the stream information only from the index of a media file, without the frames
+ */
+esp_err_t app_media_index_load_info(const char *media_path, app_media_index_info_t *info);
+
+/**
+ * @brief Create an empty index, to be filled with the video frames in order
+ *
+ * @param info Stream information
+ * @param frame_hint Expected number of frames, to allocate the frames at once
+ * @param ret_index Pointer to store the index handle
+ * @return ESP_OK on success, or an error code
+ */
+esp_err_t app_media_index_create(const app_media_index_info_t *info, uint32_t frame_hint,
+                                 app_media_index_handle_t *ret_index);
+
+/**
+ * @brief Add the next video frame to an index
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if the PTS goes backwards, or ESP_ERR_NO_MEM
+ */
+esp_err_t app_media_index_add_frame(app_media_index_handle_t index, uint32_t pts, uint32_t size, bool keyframe);
+
+/**
+ * @brief Store an index next to its media file
+ */
+esp_err_t app_media_index_save(app_media_index_handle_t index, const char *media_path);
+
+/**
+ * @brief Get the stream information of an index
+ */
+const app_media_index_info_t *app_media_index_get_info(app_media_index_handle_t index);
+
+/**
+ * @brief Get the number of video frames of an index
+ */
+uint32_t app_media_index_get_frame_count(app_media_index_handle_t index);
+
+/**
+ * @brief Get a video frame of an index
+ */
+esp_err_t app_media_index_get_frame(app_media_index_handle_t index, uint32_t frame_index,
+                                    app_media_index_frame_t *frame);
+
+/**
+ * @brief Find the last key frame at or before a position, to seek or scrub to it
+ *
+ * It is a binary search of the frames, then a walk back to the key frame.
+ *
+ * @param index Index handle
+ * @param position Position in milliseconds
+ * @param frame_index Pointer to store the index of the key frame, can be NULL
+ * @param pts Pointer to store the PTS of the key frame, can be NULL
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if the index has no key frame
+ */
+esp_err_t app_media_index_find_keyframe(app_media_index_handle_t index, uint32_t position,
+                                        uint32_t *frame_index, uint32_t *pts);
+
+/**
+ * @brief Destroy an index
+ */
+esp_err_t app_media_index_destroy(app_media_index_handle_t index);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,560 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_random.h"
+
+#include "app_playlist.h"
+
+static const char *TAG = "playlist";
+
+#define PLAYLIST_PATH_MAX       (256)
+#define PLAYLIST_HEADER         "#EXTM3U"
+#define PLAYLIST_CURRENT_TAG    "#CURRENT:"     /*!< File played when the playlist was saved */
+#define PLAYLIST_TMP_SUFFIX     ".tmp"
+#define PLAYLIST_CAPACITY_MIN   (16)
+
+/**
+ * @brief Playlist context structure
+ */
+typedef struct app_playlist_t {
+    char *path;                 /*!< M3U file, or NULL */
+    bool shuffle;               /*!< Play the entries in a random order */
+    app_playlist_loop_t loop;   /*!< Repeat mode */
+    char **entries;             /*!< Paths of the files, in the order they were added */
+    uint32_t *order;            /*!< Entries in the order of the playback */
+    uint32_t count;             /*!< Number of entries */
+    uint32_t capacity;          /*!< Number of entries allocated */
+    int32_t position;           /*!< Position of the current entry in the order, or the one before the first */
+    int32_t current;            /*!< Current entry */
+    bool started;               /*!< True once the first entry is played */
+    bool round_shuffled;        /*!< The order of the next round is drawn already, by a peek */
+    bool resume_first;          /*!< Shuffled, the first entry of the order is the one to resume at */
+} app_playlist_t;
+
+static uint32_t random_below(uint32_t limit)
+{
+    return esp_random() % limit;
+}
+
+static void swap_order(app_playlist_t *playlist, uint32_t a, uint32_t b)
+{
+    uint32_t entry = playlist->order[a];
+    playlist->order[a] = playlist->order[b];
+    playlist->order[b] = entry;
+}
+
+/**
+ * @brief Shuffle the order from a position to the end, Fisher-Yates
+ */
+static void shuffle_range(app_playlist_t *playlist, uint32_t start)
+{
+    for (uint32_t i = playlist->count; i > start + 1; i--) {
+        swap_order(playlist, i - 1, start + random_below(i - start));
+    }
+}
+
+/**
+ * @brief First position of the order which may be shuffled, after the entries played and the one to resume at
+ */
+static uint32_t get_shuffle_start(const app_playlist_t *playlist)
+{
+    return playlist->position + 1 + (playlist->resume_first ? 1 : 0);
+}
+
+/**
+ * @brief Draw the order of a new round, which does not start with the entry just played
+ */
+static void shuffle_round(app_playlist_t *playlist)
+{
+    shuffle_range(playlist, 0);
+    if ((playlist->count > 1) && ((int32_t)playlist->order[0] == playlist->current)) {
+        swap_order(playlist, 0, 1 + random_below(playlist->count - 1));
+    }
+}
+
+/**
+ * @brief Position of the entry after the current one
+ *
+ * @return Position, or -1 at the end of the playlist
+ */
+static int32_t next_position(const app_playlist_t *playlist, bool *wrap)
+{
+    *wrap = false;
+    if (playlist->count == 0) {
+        return -1;
+    }
+
+    if (playlist->started && (playlist->loop == APP_PLAYLIST_LOOP_ONE)) {
+        return playlist->position;
+    }
+
+    if (playlist->position + 1 < (int32_t)playlist->count) {
+        return playlist->position + 1;
+    }
+
+    if (playlist->loop == APP_PLAYLIST_LOOP_ALL) {
+        *wrap = true;
+        return 0;
+    }
+
+    return -1;
+}
+
+static bool contains(const app_playlist_t *playlist, const char *path)
+{
+    for (uint32_t i = 0; i < playlist->count; i++) {
+        if (strcmp(playlist->entries[i], path) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Strip the end of line and the spaces around a line of the M3U file
+ */
+static char *trim_line(char *line)
+{
+    while (isspace((unsigned char)*line)) {
+        line++;
+    }
+
+    size_t len = strlen(line);
+    while (len > 0 && isspace((unsigned char)line[len - 1])) {
+        line[--len] = '\0';
+    }
+    return line;
+}
+
+/**
+ * @brief Length of the directory of the M3U file, 0 for the current directory
+ */
+static int get_dir_len(const app_playlist_t *playlist)
+{
+    const char *slash = strrchr(playlist->path, '/');
+    return (slash != NULL) ? (int)(slash - playlist->path) : 0;
+}
+
+/**
+ * @brief Path of a file of the M3U file, the relative paths start from the directory of the M3U file
+ */
+static bool resolve_path(const app_playlist_t *playlist, const char *text, char *path)
+{
+    int dir_len = get_dir_len(playlist);
+    int len = (text[0] == '/' || dir_len == 0) ? snprintf(path, PLAYLIST_PATH_MAX, "%s", text) :
+              snprintf(path, PLAYLIST_PATH_MAX, "%.*s/%s", dir_len, playlist->path, text);
+    return (len > 0 && len < PLAYLIST_PATH_MAX);
+}
+
+/**
+ * @brief Path of a file as written in the M3U file, relative if it is in the directory of the M3U file
+ */
+static const char *relative_path(const app_playlist_t *playlist, const char *path)
+{
+    int dir_len = get_dir_len(playlist);
+    if (dir_len > 0 && strncmp(path, playlist->path, dir_len) == 0 && path[dir_len] == '/') {
+        return path + dir_len + 1;
+    }
+    return path;
+}
+
+esp_err_t app_playlist_create(const app_playlist_config_t *config, app_playlist_handle_t *ret_playlist)
+{
+    if (config == NULL || ret_playlist == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_playlist_t *playlist = calloc(1, sizeof(app_playlist_t));
+    if (playlist == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (config->path != NULL) {
+        playlist->path = strdup(config->path);
+        if (playlist->path == NULL) {
+            free(playlist);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    playlist->shuffle = config->shuffle;
+    playlist->loop = config->loop;
+    playlist->position = -1;
+    playlist->current = -1;
+
+    *ret_playlist = playlist;
+    return ESP_OK;
+}
+
+esp_err_t app_playlist_add(app_playlist_handle_t playlist, const char *path)
+{
+    if (playlist == NULL || path == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (playlist->count == playlist->capacity) {
+        uint32_t capacity = (playlist->capacity > 0) ? playlist->capacity * 2 : PLAYLIST_CAPACITY_MIN;
+        char **entries = realloc(playlist->entries, capacity * sizeof(char *));
+        if (entries == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        playlist->entries = entries;
+
+        uint32_t *order = realloc(playlist->order, capacity * sizeof(uint32_t));
+        if (order == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        playlist->order = order;
+        playlist->capacity = capacity;
+    }
+
+    char *entry = strdup(path);
+    if (entry == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    uint32_t index = playlist->count++;
+    playlist->entries[index] = entry;
+    playlist->order[index] = index;
+
+    // Shuffled in among the entries not played yet in this round, so they stay in a uniform random order
+    if (playlist->shuffle) {
+        uint32_t start = get_shuffle_start(playlist);
+        swap_order(playlist, index, start + random_below(index - start + 1));
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t app_playlist_load(app_playlist_handle_t playlist)
+{
+    if (playlist == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (playlist->path == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    FILE *file = fopen(playlist->path, "r");
+    if (file == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    char line[PLAYLIST_PATH_MAX];
+    char path[PLAYLIST_PATH_MAX];
+    char resume[PLAYLIST_PATH_MAX] = "";
+    uint32_t first = playlist->count;
+    uint32_t skipped = 0;
+    esp_err_t ret = ESP_OK;
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        char *text = trim_line(line);
+        if (text[0] == '\0') {
+            continue;
+        }
+
+        if (strncmp(text, PLAYLIST_CURRENT_TAG, strlen(PLAYLIST_CURRENT_TAG)) == 0) {
+            if (!resolve_path(playlist, text + strlen(PLAYLIST_CURRENT_TAG), resume)) {
+                resume[0] = '\0';
+            }
+            continue;
+        }
+        if (text[0] == '#') {
+            continue;
+        }
+
+        struct stat file_stat;
+        if (!resolve_path(playlist, text, path) || stat(path, &file_stat) != 0) {
+            ESP_LOGW(TAG, "Skipped missing file %s", text);
+            skipped++;
+            continue;
+        }
+
+        if (!contains(playlist, path)) {
+            ret = app_playlist_add(playlist, path);
+            if (ret != ESP_OK) {
+                break;
+            }
+        }
+    }
+    fclose(file);
+
+    // The playback resumes at the entry current when the playlist was saved
+    for (uint32_t i = 0; !playlist->started && (resume[0] != '\0') && (i < playlist->count); i++) {
+        if (strcmp(playlist->entries[playlist->order[i]], resume) != 0) {
+            continue;
+        }
+        if (playlist->shuffle) {
+            // The files added later, e.g. by a scan, are shuffled in after it
+            swap_order(playlist, 0, i);
+            playlist->position = -1;
+            playlist->resume_first = true;
+        } else {
+            playlist->position = (int32_t)i - 1;
+        }
+        ESP_LOGI(TAG, "Resume at %s", resume);
+        break;
+    }
+
+    ESP_LOGI(TAG, "Loaded %" PRIu32 " files from %s, %" PRIu32 " missing", playlist->count - first,
+             playlist->path, skipped);
+    return ret;
+}
+
+static int compare_names(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+esp_err_t app_playlist_scan(app_playlist_handle_t playlist, const char *dir_path, const char *ext)
+{
+    if (playlist == NULL || dir_path == NULL || ext == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    DIR *dir = opendir(dir_path);
+    if (dir == NULL) {
+        ESP_LOGE(TAG, "Failed to open directory: %s", dir_path);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // The directory order of FAT is the order of creation, the new files are added by name
+    char **names = NULL;
+    uint32_t name_count = 0;
+    uint32_t name_capacity = 0;
+    size_t ext_len = strlen(ext);
+    esp_err_t ret = ESP_OK;
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        size_t len = strlen(entry->d_name);
+        if (entry->d_type != DT_REG || len <= ext_len || strcasecmp(&entry->d_name[len - ext_len], ext) != 0) {
+            continue;
+        }
+
+        if (name_count == name_capacity) {
+            name_capacity = (name_capacity > 0) ? name_capacity * 2 : PLAYLIST_CAPACITY_MIN;
+            char **grown = realloc(names, name_capacity * sizeof(char *));
+            if (grown == NULL) {
+                ret = ESP_ERR_NO_MEM;
+                break;
+            }
+            names = grown;
+        }
+
+        names[name_count] = strdup(entry->d_name);
+        if (names[name_count] == NULL) {
+            ret = ESP_ERR_NO_MEM;
+            break;
+        }
+        name_count++;
+    }
+    closedir(dir);
+
+    if (name_count > 0) {
+        qsort(names, name_count, sizeof(char *), compare_names);
+    }
+
+    uint32_t added = 0;
+    char path[PLAYLIST_PATH_MAX];
+    for (uint32_t i = 0; i < name_count; i++) {
+        int len = snprintf(path, sizeof(path), "%s/%s", dir_path, names[i]);
+        if (ret == ESP_OK && len > 0 && len < (int)sizeof(path) && !contains(playlist, path)) {
+            ret = app_playlist_add(playlist, path);
+            if (ret == ESP_OK) {
+                ESP_LOGI(TAG, "Found: %s", path);
+                added++;
+            }
+        }
+        free(names[i]);
+    }
+    free(names);
+
+    ESP_LOGI(TAG, "Added %" PRIu32 " files of %s, %" PRIu32 " in total", added, dir_path, playlist->count);
+    return ret;
+}
+
+esp_err_t app_playlist_save(app_playlist_handle_t playlist)
+{
+    if (playlist == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (playlist->path == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Written aside first, so a power loss never leaves a truncated playlist
+    char tmp_path[PLAYLIST_PATH_MAX];
+    int len = snprintf(tmp_path, sizeof(tmp_path), "%s%s", playlist->path, PLAYLIST_TMP_SUFFIX);
+    if (len <= 0 || len >= (int)sizeof(tmp_path)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    FILE *file = fopen(tmp_path, "w");
+    if (file == NULL) {
+        ESP_LOGW(TAG, "Failed to create %s: %d", tmp_path, errno);
+        return ESP_FAIL;
+    }
+
+    bool written = fprintf(file, PLAYLIST_HEADER "\n") > 0;
+    if (written && playlist->started) {
+        written = fprintf(file, PLAYLIST_CURRENT_TAG "%s\n",
+                          relative_path(playlist, playlist->entries[playlist->current])) > 0;
+    }
+    for (uint32_t i = 0; written && i < playlist->count; i++) {
+        written = fprintf(file, "%s\n", relative_path(playlist, playlist->entries[i])) > 0;
+    }
+    written = (fclose(file) == 0) && written;
+
+    // FAT does not rename over an existing file
+    if (!written || ((remove(playlist->path) != 0) && (errno != ENOENT)) ||
+            (rename(tmp_path, playlist->path) != 0)) {
+        ESP_LOGW(TAG, "Failed to write %s", playlist->path);
+        remove(tmp_path);
+        return ESP_FAIL;
+    }
+
+    return ESP_OK;
+}
+
+uint32_t app_playlist_get_count(app_playlist_handle_t playlist)
+{
+    return (playlist != NULL) ? playlist->count : 0;
+}
+
+esp_err_t app_playlist_set_shuffle(app_playlist_handle_t playlist, bool shuffle)
+{
+    if (playlist == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (shuffle == playlist->shuffle) {
+        return ESP_OK;
+    }
+
+    playlist->shuffle = shuffle;
+    playlist->round_shuffled = false;
+
+    if (shuffle) {
+        // The entries not played yet in this round follow in a random order
+        shuffle_range(playlist, playlist->position + 1);
+    } else {
+        // The entries follow the current one in the order they were added, or the one to resume at
+        int32_t resume_position = playlist->resume_first ? (int32_t)playlist->order[0] - 1 : -1;
+        for (uint32_t i = 0; i < playlist->count; i++) {
+            playlist->order[i] = i;
+        }
+        playlist->position = playlist->started ? playlist->current : resume_position;
+        playlist->resume_first = false;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t app_playlist_set_loop(app_playlist_handle_t playlist, app_playlist_loop_t loop)
+{
+    if (playlist == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    playlist->loop = loop;
+    playlist->round_shuffled = false;
+    return ESP_OK;
+}
+
+esp_err_t app_playlist_peek_next(app_playlist_handle_t playlist, const char **path)
+{
+    if (playlist == NULL || path == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool wrap;
+    int32_t position = next_position(playlist, &wrap);
+    if (position < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // The order of the next round is drawn now, so the file preloaded is the one played
+    if (wrap && playlist->shuffle && !playlist->round_shuffled) {
+        shuffle_round(playlist);
+        playlist->round_shuffled = true;
+    }
+
+    *path = playlist->entries[playlist->order[position]];
+    return ESP_OK;
+}
+
+esp_err_t app_playlist_next(app_playlist_handle_t playlist, const char **path)
+{
+    if (playlist == NULL || path == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool wrap;
+    int32_t position = next_position(playlist, &wrap);
+    if (position < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    if (wrap && playlist->shuffle && !playlist->round_shuffled) {
+        shuffle_round(playlist);
+    }
+    playlist->round_shuffled = false;
+
+    playlist->position = position;
+    playlist->current = playlist->order[position];
+    playlist->started = true;
+    playlist->resume_first = false;
+
+    *path = playlist->entries[playlist->current];
+    return ESP_OK;
+}
+
+esp_err_t app_playlist_get_current(app_playlist_handle_t playlist, uint32_t *position, const char **path)
+{
+    if (playlist == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!playlist->started) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    if (position) {
+        *position = playlist->position;
+    }
+    if (path) {
+        *path = playlist->entries[playlist->current];
+    }
+    return ESP_OK;
+}
+
+esp_err_t app_playlist_destroy(app_playlist_handle_t playlist)
+{
+    if (playlist == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (uint32_t i = 0; i < playlist->count; i++) {
+        free(playlist->entries[i]);
+    }
+    free(playlist->entries);
+    free(playlist->order);
+    free(playlist->path);
+    free(playlist);
+    return ESP_OK;
+}
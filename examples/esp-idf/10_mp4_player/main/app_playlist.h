@@ -0,0 +1,131 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Playlist handle
+ */
+typedef struct app_playlist_t* app_playlist_handle_t;
+
+/**
+ * @brief Repeat mode of the playlist
+ */
+typedef enum {
+    APP_PLAYLIST_LOOP_NONE,     /*!< Stop after the last file */
+    APP_PLAYLIST_LOOP_ALL,      /*!< Start again after the last file, in a new order if shuffled */
+    APP_PLAYLIST_LOOP_ONE,      /*!< Repeat the current file */
+} app_playlist_loop_t;
+
+/**
+ * @brief Playlist configuration structure
+ */
+typedef struct {
+    const char *path;           /*!< M3U file of the playlist, to load and save it, or NULL to keep it in memory */
+    bool shuffle;               /*!< Play the files in a random order */
+    app_playlist_loop_t loop;   /*!< Repeat mode */
+} app_playlist_config_t;
+
+/**
+ * @brief Helper macro to create default playlist configuration
+ */
+#define APP_PLAYLIST_CONFIG_DEFAULT()       \
+    {                                       \
+        .path = NULL,                       \
+        .shuffle = false,                   \
+        .loop = APP_PLAYLIST_LOOP_ALL,      \
+    }
+
+/**
+ * @brief Create an empty playlist
+ */
+esp_err_t app_playlist_create(const app_playlist_config_t *config, app_playlist_handle_t *ret_playlist);
+
+/**
+ * @brief Add the files of the M3U file of the playlist
+ *
+ * The relative paths are relative to the directory of the M3U file, and the missing files are skipped. The playback
+ * resumes at the file which was current when the playlist was saved.
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND without M3U file, or another error code
+ */
+esp_err_t app_playlist_load(app_playlist_handle_t playlist);
+
+/**
+ * @brief Add the files of a directory with an extension, which are not in the playlist yet, by name
+ *
+ * @param playlist Playlist handle
+ * @param dir_path Directory
+ * @param ext Extension with the dot, case insensitive, e.g. ".mp4"
+ * @return ESP_OK on success, or an error code
+ */
+esp_err_t app_playlist_scan(app_playlist_handle_t playlist, const char *dir_path, const char *ext);
+
+/**
+ * @brief Add a file at the end of the playlist
+ */
+esp_err_t app_playlist_add(app_playlist_handle_t playlist, const char *path);
+
+/**
+ * @brief Save the files and the current file into the M3U file of the playlist
+ */
+esp_err_t app_playlist_save(app_playlist_handle_t playlist);
+
+/**
+ * @brief Get the number of files
+ */
+uint32_t app_playlist_get_count(app_playlist_handle_t playlist);
+
+/**
+ * @brief Set the shuffle, the order changes from the next file on
+ */
+esp_err_t app_playlist_set_shuffle(app_playlist_handle_t playlist, bool shuffle);
+
+/**
+ * @brief Set the repeat mode
+ */
+esp_err_t app_playlist_set_loop(app_playlist_handle_t playlist, app_playlist_loop_t loop);
+
+/**
+ * @brief Get the file after the current one, without moving to it, e.g. to preload it
+ *
+ * @note The path stays valid until the playlist is destroyed
+ *
+ * @return ESP_OK on success, or ESP_ERR_NOT_FOUND at the end of the playlist
+ */
+esp_err_t app_playlist_peek_next(app_playlist_handle_t playlist, const char **path);
+
+/**
+ * @brief Move to the file after the current one, the first one at the start
+ *
+ * @note The path stays valid until the playlist is destroyed
+ *
+ * @return ESP_OK on success, or ESP_ERR_NOT_FOUND at the end of the playlist
+ */
+esp_err_t app_playlist_next(app_playlist_handle_t playlist, const char **path);
+
+/**
+ * @brief Get the current file, and its position in the order of the playback
+ *
+ * @return ESP_OK on success, or ESP_ERR_NOT_FOUND before the first file
+ */
+esp_err_t app_playlist_get_current(app_playlist_handle_t playlist, uint32_t *position, const char **path);
+
+/**
+ * @brief Destroy a playlist
+ */
+esp_err_t app_playlist_destroy(app_playlist_handle_t playlist);
+
+#ifdef __cplusplus
+}
+#endif
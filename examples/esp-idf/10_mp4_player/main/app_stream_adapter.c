@@ -21,6 +21,8 @@
 
 #include "app_stream_adapter.h"
 #include "app_extractor.h"
+#include "app_h264_decoder.h"
+#include "app_frame_trace.h"
 #include "driver/jpeg_decode.h"
 
 static const char *TAG = "stream_adapter";
@@ -28,11 +30,50 @@ static const char *TAG = "stream_adapter";
 /* Task parameters */
 #define EXTRACT_TASK_STACK_SIZE (4 * 1024)
 #define EXTRACT_TASK_PRIORITY 5
+#define DECODE_TASK_STACK_SIZE (10 * 1024)  // The H.264 software decoder runs in the decode task
+#define DECODE_TASK_PRIORITY 5
+#define H264_CONVERT_TASK_STACK_SIZE (3 * 1024)
+#define PRESENT_TASK_STACK_SIZE (4 * 1024)
+#define PRESENT_TASK_PRIORITY 6
+
+/* Pipeline parameters */
+#define PIPELINE_QUEUE_TIMEOUT_MS   (50)          /*!< Period to check the stop of the pipeline while waiting */
+#define NO_BUFFER                   (UINT32_MAX)  /*!< No output buffer presented */
 
 /* Event group bits for task control */
 #define EXTRACT_TASK_START_BIT      (1 << 0)  /*!< Start extraction task */
 #define EXTRACT_TASK_STOP_BIT       (1 << 1)  /*!< Stop extraction task */
 #define EXTRACT_TASK_STOPPED_BIT    (1 << 2)  /*!< Task has stopped */
+#define EXTRACT_TASK_END_BIT        (1 << 3)  /*!< Extraction reached the end of the last file */
+
+/**
+ * @brief Compressed frame queued from the extract stage to the decode stage
+ */
+typedef struct {
+    app_frame_t *frame;     /*!< Frame of the extractor, released by the decode stage */
+    uint32_t trace_id;      /*!< Identifier of the frame in the frame tracer */
+} queued_frame_item_t;
+
+/**
+ * @brief Decoded frame queued from the decode stage to the present stage
+ */
+typedef struct {
+    uint32_t buffer_index;  /*!< Index of the output buffer */
+    uint32_t size;          /*!< Size of the decoded data */
+    uint32_t width;         /*!< Frame width */
+    uint32_t height;        /*!< Frame height */
+    uint32_t pts;           /*!< Presentation time in milliseconds */
+    uint32_t trace_id;      /*!< Identifier of the frame in the frame tracer */
+} decoded_frame_item_t;
+
+/**
+ * @brief Accumulated timing of a pipeline stage
+ */
+typedef struct {
+    uint64_t total_us;      /*!< Sum of the frame times */
+    uint32_t count;         /*!< Number of frames */
+    uint32_t max_us;        /*!< Maximum frame time */
+} stage_timing_t;
 
 /**
  * @brief Stream adapter context structure
@@ -45,9 +86,13 @@ typedef struct app_stream_adapter_t {
     uint32_t buffer_count;                    /*!< Number of frame buffers */
     uint32_t buffer_size;                     /*!< Size of each frame buffer */
     const char *filename;                     /*!< Current media filename */
+    const char *preload_filename;             /*!< File preloaded, or NULL */
+    const char *volatile next_filename;       /*!< File queued to follow the current one, or NULL */
+    app_stream_track_cb_t track_cb;           /*!< Called when the next file starts */
     bool running;                             /*!< Running state flag */
-    uint32_t current_buffer;                  /*!< Current buffer index */
-    uint32_t frame_count;                     /*!< Number of frames processed */
+    uint32_t frame_count;                     /*!< Number of frames presented */
+    uint32_t dropped_count;                   /*!< Number of frames which failed to decode */
+    uint32_t decoded_count;                   /*!< Number of pictures decoded */
     bool has_info;                            /*!< Flag indicating if stream info is available */
     uint32_t width;                           /*!< Frame width */
     uint32_t height;                          /*!< Frame height */
@@ -56,12 +101,37 @@ typedef struct app_stream_adapter_t {
 
     /* Extractor specific members */
     app_extractor_handle_t extractor_handle;  /*!< Extractor handle */
-    uint8_t *jpeg_buffer;                     /*!< Buffer for JPEG frames from extractor */
-    uint32_t jpeg_buffer_size;                /*!< Size of JPEG buffer */
     jpeg_decoder_handle_t jpeg_handle;        /*!< JPEG hardware decoder handle */
+    app_h264_decoder_handle_t h264_decoder;   /*!< H.264 software decoder, created with the first H.264 frame */
     TaskHandle_t extract_task_handle;         /*!< Handle for extraction task */
     EventGroupHandle_t extract_event_group;   /*!< Event group for task control */
-    SemaphoreHandle_t frame_mutex;            /*!< Mutex to protect frame buffer access */
+
+    /* Pipeline: extract -> decode -> present */
+    volatile bool pipeline_running;           /*!< Cleared to stop the decode and present tasks */
+    TaskHandle_t decode_task_handle;          /*!< Handle for decode task */
+    TaskHandle_t present_task_handle;         /*!< Handle for present task */
+    QueueHandle_t decode_queue;               /*!< JPEG frames of the extractor waiting to be decoded */
+    QueueHandle_t buffer_free_queue;          /*!< Indexes of the free output buffers */
+    QueueHandle_t present_queue;              /*!< Decoded frames waiting to be presented */
+    uint32_t presented_buffer;                /*!< Output buffer shown by the panel, or NO_BUFFER */
+    int64_t read_start_us;                    /*!< Start of the current read of the extract task */
+    volatile uint32_t frames_queued;          /*!< Frames queued to the decode stage since the pipeline start */
+    volatile uint32_t frames_done;            /*!< Frames of them presented, dropped or failed */
+
+    /* Presentation clock */
+    app_av_sync_handle_t av_sync;             /*!< A/V sync, the audio clock is the master */
+    bool pts_started;                         /*!< Flag indicating if a frame is decoded since the start */
+    uint32_t last_pts;                        /*!< PTS of the last frame decoded */
+    uint32_t frame_interval_ms;               /*!< Interval of the frames without PTS */
+
+    /* Statistics */
+    stage_timing_t extract_timing;            /*!< Timing of the extract stage */
+    stage_timing_t decode_timing;             /*!< Timing of the decode stage */
+    stage_timing_t present_timing;            /*!< Timing of the present stage */
+    float current_fps;                        /*!< FPS over the last second */
+    uint32_t fps_frame_count;                 /*!< Frames presented since fps_start_us */
+    int64_t fps_start_us;                     /*!< Start of the FPS measurement */
+    app_frame_trace_handle_t frame_trace;     /*!< Times of the last frames through the stages, or NULL */
 
     /* JPEG decoder configuration */
     app_stream_jpeg_config_t jpeg_config;     /*!< JPEG decoder configuration */
@@ -76,6 +146,35 @@ typedef struct app_stream_adapter_t {
  */
 static app_stream_adapter_t *g_adapter_instance = NULL;
 
+static void stage_timing_add(stage_timing_t *timing, int64_t elapsed_us)
+{
+    timing->total_us += elapsed_us;
+    timing->count++;
+    if (elapsed_us > timing->max_us) {
+        timing->max_us = elapsed_us;
+    }
+}
+
+static void stage_timing_get(const stage_timing_t *timing, app_stream_stage_stats_t *stats)
+{
+    stats->avg_us = (timing->count > 0) ? (uint32_t)(timing->total_us / timing->count) : 0;
+    stats->max_us = timing->max_us;
+}
+
+static void reset_stats(app_stream_adapter_t *adapter)
+{
+    adapter->frame_count = 0;
+    adapter->dropped_count = 0;
+    adapter->decoded_count = 0;
+    memset(&adapter->extract_timing, 0, sizeof(stage_timing_t));
+    memset(&adapter->decode_timing, 0, sizeof(stage_timing_t));
+    memset(&adapter->present_timing, 0, sizeof(stage_timing_t));
+    adapter->current_fps = 0;
+    adapter->fps_frame_count = 0;
+    adapter->fps_start_us = esp_timer_get_time();
+    app_frame_trace_clear(adapter->frame_trace);
+}
+
 /**
  * @brief Initialize JPEG hardware decoder
  *
@@ -98,6 +197,7 @@ static esp_err_t jpeg_hw_init(app_stream_adapter_t *adapter)
  * @param adapter Stream adapter
  * @param input_buffer JPEG data buffer
  * @param input_size JPEG data size
+ * @param output_buffer Output buffer, of `buffer_size` bytes
  * @param out_width Pointer to store width
  * @param out_height Pointer to store height
  * @param out_size Pointer to store decoded size
@@ -107,6 +207,7 @@ static esp_err_t decode_jpeg_frame(
     app_stream_adapter_t *adapter,
     const uint8_t *input_buffer,
     uint32_t input_size,
+    void *output_buffer,
     uint32_t *out_width,
     uint32_t *out_height,
     uint32_t *out_size)
@@ -131,10 +232,6 @@ static esp_err_t decode_jpeg_frame(
         return ESP_ERR_NO_MEM;
     }
 
-    // Select next buffer in round-robin fashion
-    adapter->current_buffer = (adapter->current_buffer + 1) % adapter->buffer_count;
-    void *current_decode_buffer = adapter->decode_buffers[adapter->current_buffer];
-
     jpeg_decode_cfg_t decode_cfg = {
         .conv_std = JPEG_YUV_RGB_CONV_STD_BT601,
     };
@@ -158,7 +255,7 @@ static esp_err_t decode_jpeg_frame(
 
     ret = jpeg_decoder_process(adapter->jpeg_handle, &decode_cfg,
                                input_buffer, input_size,
-                               current_decode_buffer, adapter->buffer_size,
+                               output_buffer, adapter->buffer_size,
                                out_size);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "JPEG decoding failed: %d", ret);
@@ -168,62 +265,336 @@ static esp_err_t decode_jpeg_frame(
     return ESP_OK;
 }
 
-// Extractor frame callback function
-static esp_err_t extractor_frame_callback(uint8_t *buffer,
-                                          uint32_t buffer_size,
-                                          bool is_video,
-                                          uint32_t pts)
+/**
+ * @brief Check for the start code of an H.264 frame in Annex-B, a JPEG frame starts with its SOI marker
+ */
+static bool is_h264_frame(const uint8_t *data, uint32_t size)
+{
+    return (size >= 4) && (data[0] == 0) && (data[1] == 0) &&
+           ((data[2] == 1) || ((data[2] == 0) && (data[3] == 1)));
+}
+
+/**
+ * @brief Decode an H.264 frame using the software decoder, into the same output format as the JPEG frames
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_FINISHED if the frame output no picture, or an error code
+ */
+static esp_err_t decode_h264_frame(
+    app_stream_adapter_t *adapter,
+    const uint8_t *input_buffer,
+    uint32_t input_size,
+    void *output_buffer,
+    uint32_t *out_width,
+    uint32_t *out_height,
+    uint32_t *out_size)
+{
+    if (adapter->h264_decoder == NULL) {
+        app_h264_decoder_config_t config = APP_H264_DECODER_CONFIG_DEFAULT();
+        config.output_format = (adapter->jpeg_config.output_format == APP_STREAM_JPEG_OUTPUT_RGB888) ?
+                               APP_VIDEO_PIXEL_RGB888 : APP_VIDEO_PIXEL_RGB565;
+        config.bgr_order = adapter->jpeg_config.bgr_order;
+        config.convert_tasks = CONFIG_HDMI_H264_CONVERT_TASKS;
+        config.task_priority = DECODE_TASK_PRIORITY;
+        config.task_stack_size = H264_CONVERT_TASK_STACK_SIZE;
+        esp_err_t ret = app_h264_decoder_create(&config, &adapter->h264_decoder);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create H.264 decoder: %d", ret);
+            adapter->h264_decoder = NULL;
+            return ret;
+        }
+    }
+
+    return app_h264_decoder_decode(adapter->h264_decoder, input_buffer, input_size,
+                                   output_buffer, adapter->buffer_size,
+                                   out_width, out_height, out_size);
+}
+
+// Extractor frame callback function, the extract stage of the pipeline
+static esp_err_t extractor_frame_callback(app_frame_t *frame)
 {
     app_stream_adapter_t *adapter = g_adapter_instance;
-    esp_err_t ret = ESP_OK;
 
     if (adapter == NULL) {
         ESP_LOGE(TAG, "Adapter not set for extractor callback");
+        app_frame_unref(frame);
         return ESP_ERR_INVALID_STATE;
     }
 
     // Process video frames only (audio handled in app_extractor)
-    if (!is_video) {
+    if (!frame->is_video) {
+        app_frame_unref(frame);
         return ESP_OK;
     }
 
-    if (buffer_size > adapter->jpeg_buffer_size) {
-        ESP_LOGE(TAG, "JPEG frame too large: %" PRIu32 " > %" PRIu32, buffer_size, adapter->jpeg_buffer_size);
-        return ESP_ERR_NO_MEM;
+    // The frame is queued as is, the decode stage releases it. Wait for room in the queue, so the extraction never
+    // runs too far ahead.
+    int64_t wait_start_us = esp_timer_get_time();
+    queued_frame_item_t item = {
+        .frame = frame,
+        .trace_id = app_frame_trace_begin(adapter->frame_trace, frame->pts),
+    };
+    app_frame_trace_mark(adapter->frame_trace, item.trace_id, APP_FRAME_TRACE_READ_START, adapter->read_start_us);
+    app_frame_trace_mark(adapter->frame_trace, item.trace_id, APP_FRAME_TRACE_READ_END, wait_start_us);
+    while (xQueueSend(adapter->decode_queue, &item, pdMS_TO_TICKS(PIPELINE_QUEUE_TIMEOUT_MS)) != pdTRUE) {
+        if (!adapter->pipeline_running) {
+            app_frame_unref(frame);
+            return ESP_ERR_INVALID_STATE;
+        }
     }
+    adapter->frames_queued++;
 
-    memcpy(adapter->jpeg_buffer, buffer, buffer_size);
+    stage_timing_add(&adapter->extract_timing, wait_start_us - adapter->read_start_us);
+    return ESP_OK;
+}
 
-    uint32_t width = 0, height = 0, decoded_size = 0;
+// Task that decodes the JPEG and H.264 frames into the free output buffers
+static void decode_task(void *arg)
+{
+    app_stream_adapter_t *adapter = (app_stream_adapter_t *)arg;
+    queued_frame_item_t item;
 
-    xSemaphoreTake(adapter->frame_mutex, portMAX_DELAY);
+    ESP_LOGI(TAG, "Decode task started");
 
-    ret = decode_jpeg_frame(adapter, adapter->jpeg_buffer, buffer_size,
-                            &width, &height, &decoded_size);
+    while (adapter->pipeline_running) {
+        if (xQueueReceive(adapter->decode_queue, &item, pdMS_TO_TICKS(PIPELINE_QUEUE_TIMEOUT_MS)) != pdTRUE) {
+            continue;
+        }
+        app_frame_t *frame = item.frame;
 
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to decode frame: %d", ret);
-        xSemaphoreGive(adapter->frame_mutex);
-        return ret;
+        // Wait for the present stage to release an output buffer
+        uint32_t buffer_index = NO_BUFFER;
+        while (adapter->pipeline_running &&
+                (xQueueReceive(adapter->buffer_free_queue, &buffer_index,
+                               pdMS_TO_TICKS(PIPELINE_QUEUE_TIMEOUT_MS)) != pdTRUE)) {
+        }
+        if (buffer_index == NO_BUFFER) {
+            app_frame_unref(frame);
+            break;
+        }
+
+        // Frames without PTS follow the previous one
+        uint32_t pts = frame->pts;
+        if ((pts == 0) && adapter->pts_started) {
+            pts = adapter->last_pts + adapter->frame_interval_ms;
+        }
+        adapter->last_pts = pts;
+        adapter->pts_started = true;
+
+        // An MJPEG frame already late would be dropped by the present stage anyway. An H.264 frame is always decoded,
+        // the next frames refer to it, and the present stage drops its picture if late.
+        bool h264 = is_h264_frame(frame->buffer, frame->size);
+        int64_t now_us = esp_timer_get_time();
+        if (!h264 && app_av_sync_skip_video(adapter->av_sync, pts, now_us)) {
+            app_frame_trace_end(adapter->frame_trace, item.trace_id, APP_FRAME_TRACE_LATE, now_us);
+            app_frame_unref(frame);
+            xQueueSend(adapter->buffer_free_queue, &buffer_index, 0);
+            adapter->frames_done++;
+            continue;
+        }
+
+        decoded_frame_item_t decoded = {
+            .buffer_index = buffer_index,
+            .pts = pts,
+            .trace_id = item.trace_id,
+        };
+        int64_t start_us = esp_timer_get_time();
+        esp_err_t ret;
+        if (h264) {
+            ret = decode_h264_frame(adapter, frame->buffer, frame->size,
+                                    adapter->decode_buffers[buffer_index],
+                                    &decoded.width, &decoded.height, &decoded.size);
+        } else {
+            ret = decode_jpeg_frame(adapter, frame->buffer, frame->size,
+                                    adapter->decode_buffers[buffer_index],
+                                    &decoded.width, &decoded.height, &decoded.size);
+        }
+        int64_t end_us = esp_timer_get_time();
+        stage_timing_add(&adapter->decode_timing, end_us - start_us);
+        app_frame_trace_mark(adapter->frame_trace, item.trace_id, APP_FRAME_TRACE_DECODE_START, start_us);
+        app_frame_trace_mark(adapter->frame_trace, item.trace_id, APP_FRAME_TRACE_DECODE_END, end_us);
+        app_frame_unref(frame);
+
+        // The frame only carried parameter sets
+        if (ret == ESP_ERR_NOT_FINISHED) {
+            app_frame_trace_end(adapter->frame_trace, item.trace_id, APP_FRAME_TRACE_NO_PICTURE, end_us);
+            xQueueSend(adapter->buffer_free_queue, &buffer_index, 0);
+            adapter->frames_done++;
+            continue;
+        }
+
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to decode frame: %d", ret);
+            app_frame_trace_end(adapter->frame_trace, item.trace_id, APP_FRAME_TRACE_FAILED, end_us);
+            adapter->dropped_count++;
+            xQueueSend(adapter->buffer_free_queue, &buffer_index, 0);
+            adapter->frames_done++;
+            continue;
+        }
+
+        adapter->decoded_count++;
+
+        // Never blocks, the queue can hold all the output buffers
+        xQueueSend(adapter->present_queue, &decoded, portMAX_DELAY);
     }
 
-    // Store stream info if not available
-    if (!adapter->has_info) {
+    ESP_LOGI(TAG, "Decode task stopped");
+
+    adapter->decode_task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Wait until a frame is due on the A/V sync clock
+ *
+ * @return Action for the frame, `APP_AV_SYNC_WAIT` if the pipeline stopped meanwhile
+ */
+static app_av_sync_action_t wait_frame_due(app_stream_adapter_t *adapter, uint32_t pts)
+{
+    app_av_sync_action_t action;
+    uint32_t wait_ms = 0;
+
+    // The previous frame stays on the panel meanwhile
+    while (((action = app_av_sync_check_video(adapter->av_sync, pts, esp_timer_get_time(), &wait_ms)) ==
+            APP_AV_SYNC_WAIT) && adapter->pipeline_running) {
+        TickType_t ticks = pdMS_TO_TICKS(wait_ms);
+        vTaskDelay((ticks > 0) ? ticks : 1);
+    }
+
+    return action;
+}
+
+/**
+ * @brief Release the output buffer replaced on the panel by a newly presented one
+ */
+static void release_presented_buffer(app_stream_adapter_t *adapter, uint32_t buffer_index)
+{
+    // With a single buffer, the next frame is decoded into the buffer being shown
+    if (adapter->buffer_count == 1) {
+        xQueueSend(adapter->buffer_free_queue, &buffer_index, 0);
+        return;
+    }
+
+    if (adapter->presented_buffer != NO_BUFFER) {
+        xQueueSend(adapter->buffer_free_queue, &adapter->presented_buffer, 0);
+    }
+    adapter->presented_buffer = buffer_index;
+}
+
+static void update_fps(app_stream_adapter_t *adapter)
+{
+    int64_t now_us = esp_timer_get_time();
+    int64_t elapsed_us = now_us - adapter->fps_start_us;
+
+    adapter->fps_frame_count++;
+    if (elapsed_us >= 1000 * 1000) {
+        adapter->current_fps = adapter->fps_frame_count * 1000000.0f / elapsed_us;
+        adapter->fps_frame_count = 0;
+        adapter->fps_start_us = now_us;
+    }
+}
+
+// Task that presents the decoded frames when they are due
+static void present_task(void *arg)
+{
+    app_stream_adapter_t *adapter = (app_stream_adapter_t *)arg;
+    decoded_frame_item_t item;
+
+    ESP_LOGI(TAG, "Present task started");
+
+    while (adapter->pipeline_running) {
+        if (xQueueReceive(adapter->present_queue, &item, pdMS_TO_TICKS(PIPELINE_QUEUE_TIMEOUT_MS)) != pdTRUE) {
+            continue;
+        }
+
+        // Store stream info if not available
+        if (!adapter->has_info) {
+            adapter->width = item.width;
+            adapter->height = item.height;
+            adapter->has_info = true;
+        }
+
+        // The frames dropped were never presented, their buffers are free again at once
+        if (wait_frame_due(adapter, item.pts) != APP_AV_SYNC_PRESENT) {
+            app_frame_trace_end(adapter->frame_trace, item.trace_id, APP_FRAME_TRACE_LATE, esp_timer_get_time());
+            xQueueSend(adapter->buffer_free_queue, &item.buffer_index, 0);
+            adapter->frames_done++;
+            continue;
+        }
+
+        int64_t start_us = esp_timer_get_time();
+        app_frame_trace_mark(adapter->frame_trace, item.trace_id, APP_FRAME_TRACE_PRESENT, start_us);
+        if (adapter->frame_cb) {
+            esp_err_t ret = adapter->frame_cb(adapter->decode_buffers[item.buffer_index], item.size,
+                                              item.width, item.height, adapter->frame_count, adapter->user_data);
+            int64_t end_us = esp_timer_get_time();
+            stage_timing_add(&adapter->present_timing, end_us - start_us);
+            app_frame_trace_mark(adapter->frame_trace, item.trace_id, APP_FRAME_TRACE_VSYNC, end_us);
+            if (ret != ESP_OK) {
+                ESP_LOGW(TAG, "Frame callback failed: %d", ret);
+            }
+        }
+        app_frame_trace_end(adapter->frame_trace, item.trace_id, APP_FRAME_TRACE_PRESENTED, esp_timer_get_time());
+
+        release_presented_buffer(adapter, item.buffer_index);
+        adapter->frame_count++;
+        adapter->frames_done++;
+        update_fps(adapter);
+    }
+
+    ESP_LOGI(TAG, "Present task stopped");
+
+    adapter->present_task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Get the stream information of the current file from the extractor
+ */
+static void update_stream_info(app_stream_adapter_t *adapter)
+{
+    uint32_t width, height, fps, duration;
+    esp_err_t ret = app_extractor_get_video_info(adapter->extractor_handle,
+                                                 &width, &height, &fps, &duration);
+    if (ret == ESP_OK) {
         adapter->width = width;
         adapter->height = height;
+        adapter->fps = fps;
+        adapter->duration = duration;
         adapter->has_info = true;
+
+        ESP_LOGI(TAG, "Video info: %" PRIu32 "x%" PRIu32 ", %" PRIu32 " fps, %" PRIu32 " ms",
+                 width, height, fps, duration);
     }
+    adapter->frame_interval_ms = 1000 / ((adapter->fps > 0) ? adapter->fps : DEFAULT_VIDEO_FPS);
+}
 
-    adapter->frame_count++;
+/**
+ * @brief Continue with the preloaded file at the end of the current one, the pipeline runs on
+ */
+static esp_err_t switch_next_file(app_stream_adapter_t *adapter)
+{
+    const char *filename = adapter->next_filename;
+    adapter->next_filename = NULL;
+    adapter->preload_filename = NULL;
+    if (filename == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
 
-    if (adapter->frame_cb) {
-        void *current_buffer = adapter->decode_buffers[adapter->current_buffer];
-        uint32_t frame_index = (adapter->frame_count > 0) ? (adapter->frame_count - 1) : 0;
-        ret = adapter->frame_cb(current_buffer, decoded_size, width, height, frame_index, adapter->user_data);
+    esp_err_t ret = app_extractor_switch_next(adapter->extractor_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to continue with %s: %d", filename, ret);
+        return ret;
     }
 
-    xSemaphoreGive(adapter->frame_mutex);
-    return ret;
+    adapter->filename = filename;
+    update_stream_info(adapter);
+
+    // The statistics of the previous file are still there for the callback
+    if (adapter->track_cb) {
+        adapter->track_cb(filename, adapter->user_data);
+    }
+    reset_stats(adapter);
+    return ESP_OK;
 }
 
 // Task that extracts and processes frames
@@ -260,14 +631,23 @@ static void extract_task(void *arg)
                     break;
                 }
 
+                adapter->read_start_us = esp_timer_get_time();
                 ret = app_extractor_read_frame(adapter->extractor_handle);
 
                 if (ret != ESP_OK) {
-                    if (ret == ESP_ERR_NOT_FOUND) {
-                        ESP_LOGI(TAG, "End of stream reached");
-                    } else {
+                    if (!adapter->pipeline_running) {
+                        break;
+                    }
+
+                    if (ret != ESP_ERR_NOT_FOUND) {
                         ESP_LOGW(TAG, "Failed to read frame: %d", ret);
                     }
+                    if (switch_next_file(adapter) == ESP_OK) {
+                        continue;
+                    }
+
+                    ESP_LOGI(TAG, "End of stream reached");
+                    xEventGroupSetBits(adapter->extract_event_group, EXTRACT_TASK_END_BIT);
                     break;
                 }
             }
@@ -297,7 +677,8 @@ static esp_err_t start_extract_task(app_stream_adapter_t *adapter)
 
     // Clear all event bits before starting
     xEventGroupClearBits(adapter->extract_event_group,
-                         EXTRACT_TASK_START_BIT | EXTRACT_TASK_STOP_BIT | EXTRACT_TASK_STOPPED_BIT);
+                         EXTRACT_TASK_START_BIT | EXTRACT_TASK_STOP_BIT | EXTRACT_TASK_STOPPED_BIT |
+                         EXTRACT_TASK_END_BIT);
 
     BaseType_t ret = xTaskCreate(extract_task, "extract_task",
                                  EXTRACT_TASK_STACK_SIZE, adapter,
@@ -341,6 +722,151 @@ static void stop_extract_task(app_stream_adapter_t *adapter)
     xEventGroupClearBits(adapter->extract_event_group, EXTRACT_TASK_STOP_BIT);
 }
 
+/**
+ * @brief Release the JPEG frames waiting to be decoded, so the extractor can reuse their memory
+ */
+static void drain_decode_queue(app_stream_adapter_t *adapter)
+{
+    queued_frame_item_t item;
+    while (xQueueReceive(adapter->decode_queue, &item, 0) == pdTRUE) {
+        app_frame_unref(item.frame);
+    }
+}
+
+/**
+ * @brief Drop the queued frames and mark all the buffers free, except the one shown by the panel
+ */
+static void reset_pipeline_queues(app_stream_adapter_t *adapter)
+{
+    drain_decode_queue(adapter);
+    xQueueReset(adapter->buffer_free_queue);
+    xQueueReset(adapter->present_queue);
+
+    // The buffer after the shown one is decoded into first. Without one, the first buffer is used last, as the panel
+    // starts by showing it.
+    uint32_t first = (adapter->presented_buffer == NO_BUFFER) ? 0 : adapter->presented_buffer;
+    for (uint32_t i = 1; i <= adapter->buffer_count; i++) {
+        uint32_t index = (first + i) % adapter->buffer_count;
+        if (index != adapter->presented_buffer) {
+            xQueueSend(adapter->buffer_free_queue, &index, 0);
+        }
+    }
+}
+
+// Stop the extract, decode and present tasks
+static void stop_pipeline(app_stream_adapter_t *adapter)
+{
+    adapter->pipeline_running = false;
+
+    // The decode and present tasks notice the stop within a queue timeout
+    while ((adapter->decode_task_handle != NULL) || (adapter->present_task_handle != NULL)) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    // The extractor may wait for the memory of the queued frames to output the next one
+    drain_decode_queue(adapter);
+    stop_extract_task(adapter);
+    drain_decode_queue(adapter);
+}
+
+// Start the extract, decode and present tasks, from an empty pipeline
+static esp_err_t start_pipeline(app_stream_adapter_t *adapter)
+{
+    reset_pipeline_queues(adapter);
+    adapter->pts_started = false;
+    adapter->frames_queued = 0;
+    adapter->frames_done = 0;
+    app_frame_trace_clear(adapter->frame_trace);
+    xEventGroupClearBits(adapter->extract_event_group, EXTRACT_TASK_END_BIT);
+    adapter->pipeline_running = true;
+
+    BaseType_t task_ret = xTaskCreate(decode_task, "decode_task",
+                                      DECODE_TASK_STACK_SIZE, adapter,
+                                      DECODE_TASK_PRIORITY,
+                                      &adapter->decode_task_handle);
+    if (task_ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create decode task");
+        stop_pipeline(adapter);
+        return ESP_FAIL;
+    }
+
+    task_ret = xTaskCreate(present_task, "present_task",
+                           PRESENT_TASK_STACK_SIZE, adapter,
+                           PRESENT_TASK_PRIORITY,
+                           &adapter->present_task_handle);
+    if (task_ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create present task");
+        stop_pipeline(adapter);
+        return ESP_FAIL;
+    }
+
+    esp_err_t ret = start_extract_task(adapter);
+    if (ret != ESP_OK) {
+        stop_pipeline(adapter);
+        return ret;
+    }
+
+    return ESP_OK;
+}
+
+// Create the queues of the output buffers, for the current buffer count
+static esp_err_t create_buffer_queues(app_stream_adapter_t *adapter)
+{
+    adapter->buffer_free_queue = xQueueCreate(adapter->buffer_count, sizeof(uint32_t));
+    adapter->present_queue = xQueueCreate(adapter->buffer_count, sizeof(decoded_frame_item_t));
+    if ((adapter->buffer_free_queue == NULL) || (adapter->present_queue == NULL)) {
+        ESP_LOGE(TAG, "Failed to create output buffer queues");
+        return ESP_ERR_NO_MEM;
+    }
+    adapter->presented_buffer = NO_BUFFER;
+
+    return ESP_OK;
+}
+
+static void delete_buffer_queues(app_stream_adapter_t *adapter)
+{
+    if (adapter->buffer_free_queue != NULL) {
+        vQueueDelete(adapter->buffer_free_queue);
+        adapter->buffer_free_queue = NULL;
+    }
+    if (adapter->present_queue != NULL) {
+        vQueueDelete(adapter->present_queue);
+        adapter->present_queue = NULL;
+    }
+}
+
+// Free the resources of the adapter, created or not
+static void free_adapter(app_stream_adapter_t *adapter)
+{
+    if (adapter->jpeg_handle != NULL) {
+        jpeg_del_decoder_engine(adapter->jpeg_handle);
+    }
+
+    if (adapter->h264_decoder != NULL) {
+        app_h264_decoder_destroy(adapter->h264_decoder);
+    }
+
+    if (adapter->frame_trace != NULL) {
+        app_frame_trace_destroy(adapter->frame_trace);
+    }
+
+    delete_buffer_queues(adapter);
+
+    if (adapter->decode_queue != NULL) {
+        vQueueDelete(adapter->decode_queue);
+    }
+
+    if (adapter->extract_event_group != NULL) {
+        vEventGroupDelete(adapter->extract_event_group);
+    }
+
+    if (adapter->av_sync != NULL) {
+        app_av_sync_destroy(adapter->av_sync);
+    }
+
+    free(adapter);
+}
+
 esp_err_t app_stream_adapter_init(const app_stream_adapter_config_t *config,
                                   app_stream_adapter_handle_t *ret_adapter)
 {
@@ -378,54 +904,67 @@ esp_err_t app_stream_adapter_init(const app_stream_adapter_config_t *config,
 
     adapter->frame_cb = config->frame_cb;
     adapter->user_data = config->user_data;
+    adapter->track_cb = config->track_cb;
     adapter->decode_buffers = config->decode_buffers;
     adapter->buffer_count = config->buffer_count;
     adapter->buffer_size = config->buffer_size;
     adapter->running = false;
-    adapter->current_buffer = config->buffer_count - 1;
-    adapter->frame_count = 0;
     adapter->has_info = false;
+    adapter->frame_interval_ms = 1000 / DEFAULT_VIDEO_FPS;
+    reset_stats(adapter);
 
     adapter->jpeg_config = config->jpeg_config;
     adapter->audio_dev = config->audio_dev;
     adapter->extract_audio = (config->audio_dev != NULL);
 
-    adapter->jpeg_buffer_size = APP_STREAM_JPEG_BUFFER_SIZE;
-    adapter->jpeg_buffer = heap_caps_malloc(adapter->jpeg_buffer_size, MALLOC_CAP_SPIRAM);
-    if (adapter->jpeg_buffer == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate JPEG buffer");
-        free(adapter);
+    // Create event group for task control
+    adapter->extract_event_group = xEventGroupCreate();
+    if (adapter->extract_event_group == NULL) {
+        ESP_LOGE(TAG, "Failed to create extract event group");
+        free_adapter(adapter);
         return ESP_ERR_NO_MEM;
     }
 
-    adapter->frame_mutex = xSemaphoreCreateMutex();
-    if (adapter->frame_mutex == NULL) {
-        ESP_LOGE(TAG, "Failed to create frame mutex");
-        heap_caps_free(adapter->jpeg_buffer);
-        free(adapter);
+    // Create the queues between the pipeline stages
+    adapter->decode_queue = xQueueCreate(APP_STREAM_JPEG_QUEUE_SIZE, sizeof(queued_frame_item_t));
+    if (adapter->decode_queue == NULL) {
+        ESP_LOGE(TAG, "Failed to create decode queue");
+        free_adapter(adapter);
         return ESP_ERR_NO_MEM;
     }
 
-    // Create event group for task control
-    adapter->extract_event_group = xEventGroupCreate();
-    if (adapter->extract_event_group == NULL) {
-        ESP_LOGE(TAG, "Failed to create extract event group");
-        vSemaphoreDelete(adapter->frame_mutex);
-        heap_caps_free(adapter->jpeg_buffer);
-        free(adapter);
-        return ESP_ERR_NO_MEM;
+    esp_err_t ret = create_buffer_queues(adapter);
+    if (ret != ESP_OK) {
+        free_adapter(adapter);
+        return ret;
     }
 
-    esp_err_t ret = jpeg_hw_init(adapter);
+    ret = jpeg_hw_init(adapter);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize JPEG decoder: %d", ret);
-        vEventGroupDelete(adapter->extract_event_group);
-        vSemaphoreDelete(adapter->frame_mutex);
-        heap_caps_free(adapter->jpeg_buffer);
-        free(adapter);
+        free_adapter(adapter);
         return ret;
     }
 
+    app_av_sync_config_t sync_config = APP_AV_SYNC_CONFIG_DEFAULT();
+#if CONFIG_HDMI_VIDEO_SYNC_ENABLED
+    sync_config.tolerance_ms = CONFIG_HDMI_VIDEO_SYNC_TOLERANCE_MS;
+    sync_config.audio_latency_ms = CONFIG_HDMI_AUDIO_LATENCY_MS;
+#endif
+    ret = app_av_sync_create(&sync_config, &adapter->av_sync);
+    if (ret != ESP_OK) {
+        free_adapter(adapter);
+        return ret;
+    }
+
+    if (config->trace_depth > 0) {
+        ret = app_frame_trace_create(config->trace_depth, &adapter->frame_trace);
+        if (ret != ESP_OK) {
+            free_adapter(adapter);
+            return ret;
+        }
+    }
+
     g_adapter_instance = adapter;
 
     if (config->audio_dev) {
@@ -437,15 +976,17 @@ esp_err_t app_stream_adapter_init(const app_stream_adapter_config_t *config,
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize extractor: %d", ret);
         g_adapter_instance = NULL;
-        jpeg_del_decoder_engine(adapter->jpeg_handle);
-        vEventGroupDelete(adapter->extract_event_group);
-        vSemaphoreDelete(adapter->frame_mutex);
-        heap_caps_free(adapter->jpeg_buffer);
-        free(adapter);
+        free_adapter(adapter);
         return ret;
     }
 
-    ESP_LOGI(TAG, "Stream adapter initialized%s with event group control", config->audio_dev ? " with audio" : "");
+    // Without A/V sync, the video runs on the system clock and the audio on its own
+#if CONFIG_HDMI_VIDEO_SYNC_ENABLED
+    app_extractor_set_av_sync(adapter->extractor_handle, adapter->av_sync);
+#endif
+
+    ESP_LOGI(TAG, "Stream adapter initialized%s, %" PRIu32 " output buffers",
+             config->audio_dev ? " with audio" : "", adapter->buffer_count);
     *ret_adapter = adapter;
     return ESP_OK;
 }
@@ -465,13 +1006,15 @@ esp_err_t app_stream_adapter_set_file(app_stream_adapter_handle_t handle,
     }
 
     adapter->filename = filename;
-    adapter->frame_count = 0;
+    adapter->preload_filename = NULL;
+    adapter->next_filename = NULL;
     adapter->has_info = false;
     adapter->width = 0;
     adapter->height = 0;
     adapter->fps = 0;
     adapter->duration = 0;
     adapter->extract_audio = extract_audio && (adapter->audio_dev != NULL);
+    reset_stats(adapter);
 
     ESP_LOGI(TAG, "Set media file: %s, extract_audio: %d",
              filename, adapter->extract_audio);
@@ -498,6 +1041,9 @@ esp_err_t app_stream_adapter_start(app_stream_adapter_handle_t handle)
     ESP_LOGI(TAG, "Starting playback of %s%s", adapter->filename,
              adapter->extract_audio ? " with audio" : "");
 
+    // Before the extractor starts to write the audio
+    app_av_sync_reset(adapter->av_sync);
+
     ret = app_extractor_start(adapter->extractor_handle, adapter->filename,
                               true, adapter->extract_audio);
     if (ret != ESP_OK) {
@@ -505,19 +1051,9 @@ esp_err_t app_stream_adapter_start(app_stream_adapter_handle_t handle)
         return ret;
     }
 
-    uint32_t width, height, fps, duration;
-    ret = app_extractor_get_video_info(adapter->extractor_handle,
-                                       &width, &height, &fps, &duration);
-    if (ret == ESP_OK) {
-        adapter->width = width;
-        adapter->height = height;
-        adapter->fps = fps;
-        adapter->duration = duration;
-        adapter->has_info = true;
-
-        ESP_LOGI(TAG, "Video info: %" PRIu32 "x%" PRIu32 ", %" PRIu32 " fps, %" PRIu32 " ms",
-                 width, height, fps, duration);
-    }
+    adapter->preload_filename = NULL;
+    adapter->next_filename = NULL;
+    update_stream_info(adapter);
 
     if (adapter->extract_audio) {
         uint32_t sample_rate, duration;
@@ -531,9 +1067,9 @@ esp_err_t app_stream_adapter_start(app_stream_adapter_handle_t handle)
         }
     }
 
-    ret = start_extract_task(adapter);
+    ret = start_pipeline(adapter);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to start extract task: %d", ret);
+        ESP_LOGE(TAG, "Failed to start pipeline: %d", ret);
         app_extractor_stop(adapter->extractor_handle);
         return ret;
     }
@@ -556,13 +1092,112 @@ esp_err_t app_stream_adapter_stop(app_stream_adapter_handle_t handle)
 
     ESP_LOGI(TAG, "Stopping playback");
 
-    stop_extract_task(adapter);
+    stop_pipeline(adapter);
+    adapter->preload_filename = NULL;
+    adapter->next_filename = NULL;
     app_extractor_stop(adapter->extractor_handle);
 
     adapter->running = false;
     return ESP_OK;
 }
 
+esp_err_t app_stream_adapter_preload_next(app_stream_adapter_handle_t handle, const char *filename)
+{
+    if (handle == NULL || filename == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_stream_adapter_t *adapter = (app_stream_adapter_t *)handle;
+
+    if (!adapter->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // The file queued before is replaced
+    adapter->next_filename = NULL;
+    adapter->preload_filename = NULL;
+    esp_err_t ret = app_extractor_preload(adapter->extractor_handle, filename);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to preload %s: %d", filename, ret);
+        return ret;
+    }
+    adapter->preload_filename = filename;
+    return ESP_OK;
+}
+
+esp_err_t app_stream_adapter_queue_next(app_stream_adapter_handle_t handle)
+{
+    if (handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_stream_adapter_t *adapter = (app_stream_adapter_t *)handle;
+
+    if (adapter->preload_filename == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    adapter->next_filename = adapter->preload_filename;
+    ESP_LOGI(TAG, "Next media file: %s", adapter->next_filename);
+    return ESP_OK;
+}
+
+esp_err_t app_stream_adapter_get_next_info(app_stream_adapter_handle_t handle,
+                                           uint32_t *width, uint32_t *height,
+                                           uint32_t *fps, uint32_t *duration)
+{
+    if (handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_stream_adapter_t *adapter = (app_stream_adapter_t *)handle;
+    return app_extractor_get_next_video_info(adapter->extractor_handle, width, height, fps, duration);
+}
+
+esp_err_t app_stream_adapter_clear_next_file(app_stream_adapter_handle_t handle)
+{
+    if (handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_stream_adapter_t *adapter = (app_stream_adapter_t *)handle;
+
+    adapter->next_filename = NULL;
+    adapter->preload_filename = NULL;
+    return app_extractor_cancel_preload(adapter->extractor_handle);
+}
+
+esp_err_t app_stream_adapter_wait_finished(app_stream_adapter_handle_t handle, uint32_t timeout_ms)
+{
+    if (handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_stream_adapter_t *adapter = (app_stream_adapter_t *)handle;
+
+    if (!adapter->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = pdMS_TO_TICKS(timeout_ms);
+    EventBits_t bits = xEventGroupWaitBits(adapter->extract_event_group, EXTRACT_TASK_END_BIT,
+                                           pdFALSE, pdFALSE, timeout);
+    if (!(bits & EXTRACT_TASK_END_BIT)) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    // The frames already extracted are presented, or dropped if late
+    while (adapter->frames_done != adapter->frames_queued) {
+        if (xTaskGetTickCount() - start >= timeout) {
+            return ESP_ERR_TIMEOUT;
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    return ESP_OK;
+}
+
 esp_err_t app_stream_adapter_seek(app_stream_adapter_handle_t handle, uint32_t position)
 {
     if (handle == NULL) {
@@ -574,20 +1209,38 @@ esp_err_t app_stream_adapter_seek(app_stream_adapter_handle_t handle, uint32_t p
 
     ESP_LOGI(TAG, "Seeking to position %" PRIu32 " ms", position);
 
-    bool was_running = adapter->extract_task_handle != NULL;
+    // The frames queued before the seek are dropped
+    bool was_running = adapter->running;
     if (was_running) {
-        stop_extract_task(adapter);
+        stop_pipeline(adapter);
     }
 
     ret = app_extractor_seek(adapter->extractor_handle, position);
+    app_av_sync_reset(adapter->av_sync);
 
     if (was_running) {
-        start_extract_task(adapter);
+        esp_err_t start_ret = start_pipeline(adapter);
+        if (start_ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to restart pipeline: %d", start_ret);
+            app_extractor_stop(adapter->extractor_handle);
+            adapter->running = false;
+            return start_ret;
+        }
     }
 
     return ret;
 }
 
+esp_err_t app_stream_adapter_find_keyframe(app_stream_adapter_handle_t handle, uint32_t position, uint32_t *pts)
+{
+    if (handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_stream_adapter_t *adapter = (app_stream_adapter_t *)handle;
+    return app_extractor_find_keyframe(adapter->extractor_handle, position, pts);
+}
+
 esp_err_t app_stream_adapter_get_info(app_stream_adapter_handle_t handle,
                                       uint32_t *width, uint32_t *height,
                                       uint32_t *fps, uint32_t *duration)
@@ -628,11 +1281,45 @@ esp_err_t app_stream_adapter_get_stats(app_stream_adapter_handle_t handle,
     app_stream_adapter_t *adapter = (app_stream_adapter_t *)handle;
 
     memset(stats, 0, sizeof(app_stream_stats_t));
+    stats->current_fps = adapter->current_fps;
+    stats->pictures_decoded = adapter->decoded_count;
+    stats->decode_fps = (adapter->decode_timing.total_us > 0) ?
+                        adapter->decoded_count * 1000000.0f / adapter->decode_timing.total_us : 0;
     stats->frames_processed = adapter->frame_count;
+    stats->frames_dropped = adapter->dropped_count;
+    stage_timing_get(&adapter->extract_timing, &stats->extract);
+    stage_timing_get(&adapter->decode_timing, &stats->decode);
+    stage_timing_get(&adapter->present_timing, &stats->present);
+    app_extractor_get_frame_pool_stats(adapter->extractor_handle, &stats->frame_pool);
+    app_extractor_get_file_source_stats(adapter->extractor_handle, &stats->file_source);
+    app_extractor_get_audio_output_stats(adapter->extractor_handle, &stats->audio_output);
+    app_av_sync_get_stats(adapter->av_sync, &stats->av_sync);
+    if (adapter->h264_decoder != NULL) {
+        app_h264_decoder_get_stats(adapter->h264_decoder, &stats->h264);
+    }
+    if (adapter->frame_trace != NULL) {
+        app_frame_trace_get_summary(adapter->frame_trace, &stats->trace);
+    }
 
     return ESP_OK;
 }
 
+esp_err_t app_stream_adapter_get_trace(app_stream_adapter_handle_t handle, app_frame_trace_handle_t *trace)
+{
+    if (handle == NULL || trace == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_stream_adapter_t *adapter = (app_stream_adapter_t *)handle;
+
+    if (adapter->frame_trace == NULL) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    *trace = adapter->frame_trace;
+    return ESP_OK;
+}
+
 esp_err_t app_stream_adapter_deinit(app_stream_adapter_handle_t handle)
 {
     if (handle == NULL) {
@@ -650,28 +1337,11 @@ esp_err_t app_stream_adapter_deinit(app_stream_adapter_handle_t handle)
         adapter->extractor_handle = NULL;
     }
 
-    if (adapter->jpeg_handle != NULL) {
-        jpeg_del_decoder_engine(adapter->jpeg_handle);
-        adapter->jpeg_handle = NULL;
-    }
-
-    if (adapter->frame_mutex != NULL) {
-        vSemaphoreDelete(adapter->frame_mutex);
-    }
-
-    if (adapter->extract_event_group != NULL) {
-        vEventGroupDelete(adapter->extract_event_group);
-    }
-
-    if (adapter->jpeg_buffer != NULL) {
-        heap_caps_free(adapter->jpeg_buffer);
-    }
-
     if (g_adapter_instance == adapter) {
         g_adapter_instance = NULL;
     }
 
-    free(adapter);
+    free_adapter(adapter);
 
     ESP_LOGI(TAG, "Stream adapter deinitialized");
     return ESP_OK;
@@ -682,7 +1352,7 @@ esp_err_t app_stream_adapter_resize_buffers(app_stream_adapter_handle_t handle,
                                             uint32_t buffer_count,
                                             uint32_t buffer_size)
 {
-    if (handle == NULL || decode_buffers == NULL) {
+    if (handle == NULL || decode_buffers == NULL || buffer_count == 0) {
         return ESP_ERR_INVALID_ARG;
     }
 
@@ -695,9 +1365,9 @@ esp_err_t app_stream_adapter_resize_buffers(app_stream_adapter_handle_t handle,
     adapter->decode_buffers = decode_buffers;
     adapter->buffer_count = buffer_count;
     adapter->buffer_size = buffer_size;
-    adapter->current_buffer = buffer_count - 1;
 
-    return ESP_OK;
+    delete_buffer_queues(adapter);
+    return create_buffer_queues(adapter);
 }
 
 esp_err_t app_stream_adapter_probe_video_info(const char *filename,
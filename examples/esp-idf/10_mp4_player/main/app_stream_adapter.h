@@ -8,12 +8,18 @@
 #include <stdint.h>
 #include "esp_err.h"
 #include "esp_codec_dev.h"  // Add for audio device support
+#include "app_frame_pool.h"
+#include "app_av_sync.h"
+#include "app_file_source.h"
+#include "app_audio_output.h"
+#include "app_h264_decoder.h"
+#include "app_frame_trace.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-#define APP_STREAM_JPEG_BUFFER_SIZE     (256 * 1024)  // 256KB JPEG buffer
+#define APP_STREAM_JPEG_QUEUE_SIZE      (2)           // JPEG or H.264 frames queued between extraction and decoding
 
 /**
  * @brief Media stream adapter handle
@@ -48,17 +54,42 @@ typedef struct {
 #define APP_STREAM_JPEG_CONFIG_DEFAULT_RGB888() \
     { .output_format = APP_STREAM_JPEG_OUTPUT_RGB888, .bgr_order = true }
 
+/**
+ * @brief Timing statistics of a pipeline stage
+ */
+typedef struct {
+    uint32_t avg_us;              /*!< Average time per frame */
+    uint32_t max_us;              /*!< Maximum time per frame */
+} app_stream_stage_stats_t;
+
 /**
  * @brief Performance statistics structure
  */
 typedef struct {
-    float current_fps;            /*!< Current frames per second */
-    uint32_t frames_processed;    /*!< Total frames processed */
+    float current_fps;                  /*!< Current frames per second */
+    float decode_fps;                   /*!< Pictures decoded per second of the decode stage, parsing, decoding and
+                                             conversion to RGB included, the frame rate the decoder can sustain */
+    uint32_t pictures_decoded;          /*!< Pictures decoded, presented or dropped late */
+    uint32_t frames_processed;          /*!< Total frames presented */
+    uint32_t frames_dropped;            /*!< Frames which failed to decode */
+    app_stream_stage_stats_t extract;   /*!< Read of a frame, without waiting for room in the decode queue */
+    app_stream_stage_stats_t decode;    /*!< JPEG or H.264 decoding into an output buffer */
+    app_stream_stage_stats_t present;   /*!< Frame callback, e.g. draw and wait for the panel */
+    app_frame_pool_stats_t frame_pool;  /*!< Compressed frames held by the decoders */
+    app_file_source_stats_t file_source; /*!< Read-ahead of the media file */
+    app_av_sync_stats_t av_sync;        /*!< Offsets of the frames from the master clock, frames dropped when late */
+    app_audio_output_stats_t audio_output; /*!< Audio decoded ahead of the codec, since the start of the playback */
+    app_h264_decoder_stats_t h264;      /*!< H.264 decoding and conversion, since the first H.264 frame */
+    app_frame_trace_summary_t trace;    /*!< Frame times of the frames in the frame tracer, if enabled */
 } app_stream_stats_t;
 
 /**
  * @brief Media frame callback function type
  *
+ * It is called from the present task once the frame is due on the audio clock, or on the system clock without audio.
+ * The late frames are dropped rather than presented. The buffer is decoded into again once the next frame has
+ * been presented, so the callback should return when the panel scans out the buffer, e.g. on its refresh done event.
+ *
  * @param buffer Pointer to the frame buffer
  * @param buffer_size Size of the frame buffer
  * @param width Frame width
@@ -74,8 +105,25 @@ typedef esp_err_t (*app_stream_frame_cb_t)(uint8_t *buffer,
                                            uint32_t frame_index,
                                            void *user_data);
 
+/**
+ * @brief Track change callback function type
+ *
+ * It is called from the extract task when the next file queued by `app_stream_adapter_queue_next()` starts. The
+ * statistics of the previous file are still readable in the callback, they are reset after it. The frames of the
+ * previous file already extracted are still being presented, without gap.
+ *
+ * @param filename Media file started
+ * @param user_data User data passed from configuration
+ */
+typedef void (*app_stream_track_cb_t)(const char *filename, void *user_data);
+
 /**
  * @brief Stream adapter initialization configuration structure
+ *
+ * The frames are extracted, decoded and presented by three tasks. The decode buffers are used in turn, so with the
+ * frame buffers of a DPI panel the JPEG decoder writes straight into a spare frame buffer while another one is scanned
+ * out. Three buffers let a frame be decoded while one is waiting to be presented. The H.264 frames are decoded in
+ * software by `app_h264_decoder`, into the output format of the JPEG configuration, and go through the same buffers.
  */
 typedef struct {
     app_stream_frame_cb_t frame_cb;                 /*!< Callback function for decoded frames */
@@ -84,7 +132,9 @@ typedef struct {
     uint32_t buffer_count;                          /*!< Number of frame buffers */
     uint32_t buffer_size;                           /*!< Size of each frame buffer */
     esp_codec_dev_handle_t audio_dev;               /*!< Audio device handle (NULL to disable audio) */
-    app_stream_jpeg_config_t jpeg_config;           /*!< JPEG decoder configuration */
+    app_stream_jpeg_config_t jpeg_config;           /*!< Output format of the JPEG and H.264 decoders */
+    app_stream_track_cb_t track_cb;                 /*!< Callback when the next file starts, optional */
+    uint32_t trace_depth;                           /*!< Frames kept by the frame tracer, 0 to disable it */
 } app_stream_adapter_config_t;
 
 /**
@@ -110,11 +160,61 @@ esp_err_t app_stream_adapter_start(app_stream_adapter_handle_t handle);
  */
 esp_err_t app_stream_adapter_stop(app_stream_adapter_handle_t handle);
 
+/**
+ * @brief Open and parse the file to play after the current one, in the background while the current one plays
+ *
+ * @note The filename must stay valid until the file is stopped, as for `app_stream_adapter_set_file()`
+ *
+ * @param handle Stream adapter handle
+ * @param filename Media file to play next, replacing the previous one
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if the playback is stopped, or an error code
+ */
+esp_err_t app_stream_adapter_preload_next(app_stream_adapter_handle_t handle, const char *filename);
+
+/**
+ * @brief Play the preloaded file after the current one, without gap
+ *
+ * The extraction goes on with it at the end of the current file, with the same decoder, buffers and A/V sync clock.
+ * Its frames are decoded into the same buffers, so check with `app_stream_adapter_get_next_info()` that they fit
+ * first.
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE without preloaded file
+ */
+esp_err_t app_stream_adapter_queue_next(app_stream_adapter_handle_t handle);
+
+/**
+ * @brief Get the video information of the preloaded file, waits for its preload
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND without preloaded file, or the error of its preload
+ */
+esp_err_t app_stream_adapter_get_next_info(app_stream_adapter_handle_t handle,
+                                           uint32_t *width, uint32_t *height,
+                                           uint32_t *fps, uint32_t *duration);
+
+/**
+ * @brief Drop the preloaded file, the playback ends with the current one
+ */
+esp_err_t app_stream_adapter_clear_next_file(app_stream_adapter_handle_t handle);
+
+/**
+ * @brief Wait for the end of the playback, once the last file is extracted and all its frames are presented
+ *
+ * @return ESP_OK at the end, ESP_ERR_TIMEOUT if the playback goes on, or ESP_ERR_INVALID_STATE if stopped
+ */
+esp_err_t app_stream_adapter_wait_finished(app_stream_adapter_handle_t handle, uint32_t timeout_ms);
+
 /**
  * @brief Seek to position in milliseconds
  */
 esp_err_t app_stream_adapter_seek(app_stream_adapter_handle_t handle, uint32_t position);
 
+/**
+ * @brief Find the key frame at or before a position, from the seek index of the file
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if the file has no seek index yet
+ */
+esp_err_t app_stream_adapter_find_keyframe(app_stream_adapter_handle_t handle, uint32_t position, uint32_t *pts);
+
 /**
  * @brief Get stream information
  */
@@ -128,6 +228,15 @@ esp_err_t app_stream_adapter_get_info(app_stream_adapter_handle_t handle,
 esp_err_t app_stream_adapter_get_stats(app_stream_adapter_handle_t handle,
                                        app_stream_stats_t *stats);
 
+/**
+ * @brief Get the frame tracer, e.g. to dump the times of the last frames through the stages
+ *
+ * The tracer holds the frames since the start of the file, or since the last seek, up to its depth.
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if the tracer is disabled
+ */
+esp_err_t app_stream_adapter_get_trace(app_stream_adapter_handle_t handle, app_frame_trace_handle_t *trace);
+
 /**
  * @brief Resize buffers
  *
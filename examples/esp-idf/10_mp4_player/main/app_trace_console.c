@@ -0,0 +1,197 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_console.h"
+#include "argtable3/argtable3.h"
+#include "sdkconfig.h"
+
+#include "app_trace_console.h"
+
+static const char *TAG = "trace_console";
+
+static app_stream_adapter_handle_t console_adapter;
+
+static struct {
+    struct arg_int *frames;
+    struct arg_str *file;
+    struct arg_end *end;
+} trace_dump_args;
+
+/**
+ * @brief Get the frame tracer of the adapter, or tell it is disabled
+ */
+static app_frame_trace_handle_t get_trace(void)
+{
+    app_frame_trace_handle_t trace = NULL;
+    if (app_stream_adapter_get_trace(console_adapter, &trace) != ESP_OK) {
+        printf("The frame tracer is disabled\n");
+        return NULL;
+    }
+    return trace;
+}
+
+static int do_trace_dump_cmd(int argc, char **argv)
+{
+    int nerrors = arg_parse(argc, argv, (void **)&trace_dump_args);
+    if (nerrors != 0) {
+        arg_print_errors(stderr, trace_dump_args.end, argv[0]);
+        return 1;
+    }
+
+    uint32_t frames = 0;
+    if (trace_dump_args.frames->count) {
+        if (trace_dump_args.frames->ival[0] <= 0) {
+            printf("The number of frames must be positive\n");
+            return 1;
+        }
+        frames = trace_dump_args.frames->ival[0];
+    }
+
+    app_frame_trace_handle_t trace = get_trace();
+    if (trace == NULL) {
+        return 1;
+    }
+
+    FILE *out = stdout;
+    const char *path = NULL;
+    if (trace_dump_args.file->count) {
+        path = trace_dump_args.file->sval[0];
+        out = fopen(path, "w");
+        if (out == NULL) {
+            printf("Failed to open %s\n", path);
+            return 1;
+        }
+    }
+
+    esp_err_t ret = app_frame_trace_dump(trace, out, frames);
+    if (path != NULL) {
+        fclose(out);
+        if (ret == ESP_OK) {
+            printf("Trace written to %s\n", path);
+        }
+    }
+    if (ret != ESP_OK) {
+        printf("Failed to write the trace: %s\n", esp_err_to_name(ret));
+        return 1;
+    }
+    return 0;
+}
+
+static void register_trace_dump(void)
+{
+    trace_dump_args.frames = arg_int0("n", "frames", "<frames>", "Write the last frames only");
+    trace_dump_args.file = arg_str0("f", "file", "<file>", "Write to a file, e.g. /sdcard/trace.json");
+    trace_dump_args.end = arg_end(2);
+    const esp_console_cmd_t trace_dump_cmd = {
+        .command = "trace_dump",
+        .help = "Write the times of the last frames through the pipeline as a Chrome trace in JSON",
+        .hint = NULL,
+        .func = &do_trace_dump_cmd,
+        .argtable = &trace_dump_args
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&trace_dump_cmd));
+}
+
+static int do_trace_stats_cmd(int argc, char **argv)
+{
+    app_frame_trace_handle_t trace = get_trace();
+    if (trace == NULL) {
+        return 1;
+    }
+
+    app_frame_trace_summary_t summary;
+    esp_err_t ret = app_frame_trace_get_summary(trace, &summary);
+    if (ret != ESP_OK) {
+        printf("Failed to get the frame times: %s\n", esp_err_to_name(ret));
+        return 1;
+    }
+
+    printf("%" PRIu32 " frames, %" PRIu32 " dropped (%.1f%%)\n",
+           summary.frames, summary.frames_dropped, summary.drop_rate * 100.0f);
+    printf("Frame time p50 %" PRIu32 " us, p95 %" PRIu32 " us, p99 %" PRIu32 " us, max %" PRIu32 " us\n",
+           summary.frame_p50_us, summary.frame_p95_us, summary.frame_p99_us, summary.frame_max_us);
+    return 0;
+}
+
+static void register_trace_stats(void)
+{
+    const esp_console_cmd_t trace_stats_cmd = {
+        .command = "trace_stats",
+        .help = "Print the percentiles of the frame time and the drop rate of the last frames",
+        .hint = NULL,
+        .func = &do_trace_stats_cmd,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&trace_stats_cmd));
+}
+
+static int do_trace_clear_cmd(int argc, char **argv)
+{
+    app_frame_trace_handle_t trace = get_trace();
+    if (trace == NULL) {
+        return 1;
+    }
+
+    app_frame_trace_clear(trace);
+    return 0;
+}
+
+static void register_trace_clear(void)
+{
+    const esp_console_cmd_t trace_clear_cmd = {
+        .command = "trace_clear",
+        .help = "Forget the frames traced so far",
+        .hint = NULL,
+        .func = &do_trace_clear_cmd,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&trace_clear_cmd));
+}
+
+esp_err_t app_trace_console_start(app_stream_adapter_handle_t adapter)
+{
+    if (adapter == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    console_adapter = adapter;
+
+    esp_console_repl_t *repl = NULL;
+    esp_console_repl_config_t repl_config = ESP_CONSOLE_REPL_CONFIG_DEFAULT();
+    repl_config.prompt = "mp4>";
+
+    esp_err_t ret = ESP_ERR_NOT_SUPPORTED;
+#if CONFIG_ESP_CONSOLE_UART
+    esp_console_dev_uart_config_t uart_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
+    ret = esp_console_new_repl_uart(&uart_config, &repl_config, &repl);
+#elif CONFIG_ESP_CONSOLE_USB_CDC
+    esp_console_dev_usb_cdc_config_t cdc_config = ESP_CONSOLE_DEV_CDC_CONFIG_DEFAULT();
+    ret = esp_console_new_repl_usb_cdc(&cdc_config, &repl_config, &repl);
+#elif CONFIG_ESP_CONSOLE_USB_SERIAL_JTAG
+    esp_console_dev_usb_serial_jtag_config_t usbjtag_config = ESP_CONSOLE_DEV_USB_SERIAL_JTAG_CONFIG_DEFAULT();
+    ret = esp_console_new_repl_usb_serial_jtag(&usbjtag_config, &repl_config, &repl);
+#endif
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create the console: %d", ret);
+        return ret;
+    }
+
+    esp_console_register_help_command();
+    register_trace_dump();
+    register_trace_stats();
+    register_trace_clear();
+
+    ret = esp_console_start_repl(repl);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start the console: %d", ret);
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Console started, try 'trace_stats' or 'trace_dump'");
+    return ESP_OK;
+}
@@ -0,0 +1,31 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include "esp_err.h"
+#include "app_stream_adapter.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start a console on the serial port with the commands of the frame tracer of a stream adapter
+ *
+ * - `trace_dump [-n <frames>] [-f <file>]` writes the last frames as a Chrome trace in JSON, to the console or a file
+ * - `trace_stats` prints the percentiles of the frame time and the drop rate
+ * - `trace_clear` forgets the frames traced so far
+ *
+ * The console runs in its own task, along with the playback.
+ *
+ * @param adapter Stream adapter, with its frame tracer enabled
+ * @return ESP_OK on success, or an error code
+ */
+esp_err_t app_trace_console_start(app_stream_adapter_handle_t adapter);
+
+#ifdef __cplusplus
+}
+#endif
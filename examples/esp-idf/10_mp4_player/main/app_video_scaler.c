@@ -0,0 +1,582 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "soc/soc_caps.h"
+#if SOC_PPA_SUPPORTED
+#include "driver/ppa.h"
+#endif
+
+#include "app_video_scaler.h"
+
+static const char *TAG = "video_scaler";
+
+#define SCALER_FRAC_BITS        (16)                /*!< Fraction bits of the software scaler coordinates */
+#define SCALER_HALF             (1 << (SCALER_FRAC_BITS - 1))
+#define SCALER_HW_SCALE_STEPS   (16)                /*!< The PPA scales by steps of 1/16 */
+#define SCALER_HW_SCALE_MAX     (256 * SCALER_HW_SCALE_STEPS)   /*!< The PPA scales by less than 256 */
+#define SCALER_BAR_NUM          (4)                 /*!< Bars above, below, left and right of the video */
+#define RGB565_SPREAD_MASK      (0x07E0F81F)        /*!< RGB565 with green moved up, each field has room for x32 */
+
+/**
+ * @brief Video scaler context structure
+ */
+typedef struct app_video_scaler_t {
+    app_video_scaler_config_t config;   /*!< Video scaler configuration */
+    uint32_t bytes_per_pixel;           /*!< Bytes per pixel of the pixel format */
+
+    /* Layout of the last source size */
+    uint32_t layout_width;              /*!< Source width of the layout, 0 if none */
+    uint32_t layout_height;             /*!< Source height of the layout */
+    app_video_layout_t layout;          /*!< Placement of the video */
+    uint32_t hw_scale;                  /*!< Scale of the PPA, in steps of 1/16 */
+
+#if SOC_PPA_SUPPORTED
+    ppa_client_handle_t srm_client;     /*!< PPA client to scale, rotate and mirror */
+    ppa_client_handle_t fill_client;    /*!< PPA client to fill the bars */
+#endif
+
+    /* Statistics */
+    bool last_hw;                       /*!< True if the last frame was scaled by the PPA */
+    uint32_t frames;                    /*!< Frames scaled */
+    uint32_t hw_failures;               /*!< Frames scaled in software after a failure of the PPA */
+    uint64_t total_us;                  /*!< Sum of the frame times */
+    uint32_t max_us;                    /*!< Maximum frame time */
+} app_video_scaler_t;
+
+static inline bool is_quarter_turn(app_video_rotation_t rotation)
+{
+    return (rotation == APP_VIDEO_ROTATE_90) || (rotation == APP_VIDEO_ROTATE_270);
+}
+
+/**
+ * @brief Place a video on the display
+ *
+ * @param scaler Video scaler
+ * @param src_width Source width
+ * @param src_height Source height
+ * @param hw True to round the scale to the steps of the PPA
+ * @param layout Pointer to store the placement
+ * @return Scale in steps of the PPA with hw, 0 if it is out of the range of the PPA
+ */
+static uint32_t compute_layout(const app_video_scaler_t *scaler, uint32_t src_width, uint32_t src_height, bool hw,
+                               app_video_layout_t *layout)
+{
+    const app_video_scaler_config_t *config = &scaler->config;
+    bool quarter = is_quarter_turn(config->rotation);
+    uint32_t rot_width = quarter ? src_height : src_width;
+    uint32_t rot_height = quarter ? src_width : src_height;
+
+    // The scale is num / den. The wider side fits the display, or the narrower side to cover it.
+    bool wider = (uint64_t)rot_width * config->dst_height >= (uint64_t)rot_height * config->dst_width;
+    bool fit_width = (config->mode == APP_VIDEO_SCALE_FILL) ? !wider : wider;
+    uint64_t num = fit_width ? config->dst_width : config->dst_height;
+    uint64_t den = fit_width ? rot_width : rot_height;
+    if ((config->mode == APP_VIDEO_SCALE_LETTERBOX) && (num > den)) {
+        num = den = 1;
+    }
+
+    // Rounded down to a step of the PPA, or up to keep the display covered
+    uint32_t hw_scale = 0;
+    if (hw) {
+        num *= SCALER_HW_SCALE_STEPS;
+        num = (config->mode == APP_VIDEO_SCALE_FILL) ? (num + den - 1) / den : num / den;
+        den = SCALER_HW_SCALE_STEPS;
+        hw_scale = ((num > 0) && (num < SCALER_HW_SCALE_MAX)) ? (uint32_t)num : 0;
+        if (hw_scale == 0) {
+            num = 1;
+        }
+    }
+
+    // Part of the rotated video shown, and its size on the display. The PPA outputs the part shown times the scale
+    // rounded down, in software the part shown is rounded to the nearest pixel.
+    uint64_t round = hw ? 0 : num / 2;
+    uint32_t vis_width = rot_width;
+    uint32_t vis_height = rot_height;
+    if ((config->dst_width * den + round) / num < vis_width) {
+        vis_width = (config->dst_width * den + round) / num;
+    }
+    if ((config->dst_height * den + round) / num < vis_height) {
+        vis_height = (config->dst_height * den + round) / num;
+    }
+    vis_width = (vis_width > 0) ? vis_width : 1;
+    vis_height = (vis_height > 0) ? vis_height : 1;
+    uint32_t out_width = vis_width * num / den;
+    uint32_t out_height = vis_height * num / den;
+    if (hw_scale > 0) {
+        // The PPA outputs a pixel at least
+        if ((out_width == 0) || (out_height == 0)) {
+            hw_scale = 0;
+        }
+    } else {
+        // A cropped side covers the display, the crop is stretched by less than a pixel of the source. A side too
+        // thin to scale keeps a pixel.
+        out_width = (vis_width < rot_width) ? config->dst_width : (out_width > 0) ? out_width : 1;
+        out_height = (vis_height < rot_height) ? config->dst_height : (out_height > 0) ? out_height : 1;
+    }
+    out_width = (out_width < config->dst_width) ? out_width : config->dst_width;
+    out_height = (out_height < config->dst_height) ? out_height : config->dst_height;
+
+    uint32_t crop_width = quarter ? vis_height : vis_width;
+    uint32_t crop_height = quarter ? vis_width : vis_height;
+    layout->src = (app_video_rect_t) {
+        .x = (src_width - crop_width) / 2,
+        .y = (src_height - crop_height) / 2,
+        .width = crop_width,
+        .height = crop_height,
+    };
+    layout->dst = (app_video_rect_t) {
+        .x = (config->dst_width - out_width) / 2,
+        .y = (config->dst_height - out_height) / 2,
+        .width = out_width,
+        .height = out_height,
+    };
+    layout->hw = hw && (hw_scale > 0);
+
+    return hw_scale;
+}
+
+/**
+ * @brief Get the layout of a source size, computed again only when the size changes
+ */
+static const app_video_layout_t *update_layout(app_video_scaler_t *scaler, uint32_t src_width, uint32_t src_height)
+{
+    if ((scaler->layout_width == src_width) && (scaler->layout_height == src_height)) {
+        return &scaler->layout;
+    }
+
+    bool hw = false;
+#if SOC_PPA_SUPPORTED
+    hw = (scaler->srm_client != NULL);
+#endif
+    scaler->hw_scale = compute_layout(scaler, src_width, src_height, hw, &scaler->layout);
+
+    // The sizes out of the range of the PPA are scaled in software
+    if (hw && !scaler->layout.hw) {
+        compute_layout(scaler, src_width, src_height, false, &scaler->layout);
+    }
+
+    scaler->layout_width = src_width;
+    scaler->layout_height = src_height;
+
+    const app_video_layout_t *layout = &scaler->layout;
+    ESP_LOGI(TAG, "%" PRIu32 "x%" PRIu32 " video: %" PRIu32 "x%" PRIu32 " at (%" PRIu32 ",%" PRIu32 ") shown as "
+             "%" PRIu32 "x%" PRIu32 " at (%" PRIu32 ",%" PRIu32 "), %s",
+             src_width, src_height, layout->src.width, layout->src.height, layout->src.x, layout->src.y,
+             layout->dst.width, layout->dst.height, layout->dst.x, layout->dst.y, layout->hw ? "PPA" : "software");
+
+    return layout;
+}
+
+/**
+ * @brief Get the bars of the display around the video
+ *
+ * @return Number of bars, the empty ones are skipped
+ */
+static uint32_t get_bars(const app_video_scaler_t *scaler, const app_video_layout_t *layout,
+                         app_video_rect_t bars[SCALER_BAR_NUM])
+{
+    const app_video_rect_t *video = &layout->dst;
+    uint32_t width = scaler->config.dst_width;
+    uint32_t height = scaler->config.dst_height;
+    uint32_t right = video->x + video->width;
+    uint32_t bottom = video->y + video->height;
+    const app_video_rect_t all[SCALER_BAR_NUM] = {
+        { 0, 0, width, video->y },
+        { 0, bottom, width, height - bottom },
+        { 0, video->y, video->x, video->height },
+        { right, video->y, width - right, video->height },
+    };
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < SCALER_BAR_NUM; i++) {
+        if ((all[i].width > 0) && (all[i].height > 0)) {
+            bars[count++] = all[i];
+        }
+    }
+    return count;
+}
+
+static inline uint32_t rgb565_spread(uint16_t pixel)
+{
+    return (pixel | ((uint32_t)pixel << 16)) & RGB565_SPREAD_MASK;
+}
+
+static inline uint32_t rgb565_lerp(uint32_t a, uint32_t b, uint32_t weight)
+{
+    return ((a * (32 - weight) + b * weight) >> 5) & RGB565_SPREAD_MASK;
+}
+
+static inline int32_t clamp_coord(int32_t coord, int32_t max)
+{
+    return (coord < 0) ? 0 : (coord > max) ? max : coord;
+}
+
+/**
+ * @brief Position in the source crop of the first pixel of a display row, and its step per pixel
+ */
+typedef struct {
+    int32_t x;
+    int32_t y;
+    int32_t dx;
+    int32_t dy;
+} row_walk_t;
+
+static void scale_row_nearest(const app_video_scaler_t *scaler, const uint8_t *crop, uint32_t src_stride,
+                              int32_t max_x, int32_t max_y, row_walk_t walk, uint8_t *out, uint32_t width)
+{
+    if (scaler->bytes_per_pixel == 2) {
+        uint16_t *out16 = (uint16_t *)out;
+        for (uint32_t i = 0; i < width; i++) {
+            int32_t x = (clamp_coord(walk.x, max_x) + SCALER_HALF) >> SCALER_FRAC_BITS;
+            int32_t y = (clamp_coord(walk.y, max_y) + SCALER_HALF) >> SCALER_FRAC_BITS;
+            out16[i] = ((const uint16_t *)(crop + y * src_stride))[x];
+            walk.x += walk.dx;
+            walk.y += walk.dy;
+        }
+        return;
+    }
+
+    for (uint32_t i = 0; i < width; i++) {
+        int32_t x = (clamp_coord(walk.x, max_x) + SCALER_HALF) >> SCALER_FRAC_BITS;
+        int32_t y = (clamp_coord(walk.y, max_y) + SCALER_HALF) >> SCALER_FRAC_BITS;
+        const uint8_t *pixel = crop + y * src_stride + x * 3;
+        out[0] = pixel[0];
+        out[1] = pixel[1];
+        out[2] = pixel[2];
+        out += 3;
+        walk.x += walk.dx;
+        walk.y += walk.dy;
+    }
+}
+
+static void scale_row_bilinear(const app_video_scaler_t *scaler, const uint8_t *crop, uint32_t src_stride,
+                               int32_t max_x, int32_t max_y, row_walk_t walk, uint8_t *out, uint32_t width)
+{
+    uint32_t bpp = scaler->bytes_per_pixel;
+
+    for (uint32_t i = 0; i < width; i++) {
+        int32_t x = clamp_coord(walk.x, max_x);
+        int32_t y = clamp_coord(walk.y, max_y);
+        walk.x += walk.dx;
+        walk.y += walk.dy;
+
+        // The 4 pixels around the position, the last column and row are repeated
+        const uint8_t *p00 = crop + (y >> SCALER_FRAC_BITS) * src_stride + (x >> SCALER_FRAC_BITS) * bpp;
+        const uint8_t *p01 = (x < max_x) ? p00 + bpp : p00;
+        const uint8_t *p10 = (y < max_y) ? p00 + src_stride : p00;
+        const uint8_t *p11 = (y < max_y) ? p01 + src_stride : p01;
+
+        if (bpp == 2) {
+            uint32_t wx = (x >> (SCALER_FRAC_BITS - 5)) & 0x1F;
+            uint32_t wy = (y >> (SCALER_FRAC_BITS - 5)) & 0x1F;
+            uint32_t top = rgb565_lerp(rgb565_spread(*(const uint16_t *)p00), rgb565_spread(*(const uint16_t *)p01), wx);
+            uint32_t bottom = rgb565_lerp(rgb565_spread(*(const uint16_t *)p10),
+                                          rgb565_spread(*(const uint16_t *)p11), wx);
+            uint32_t pixel = rgb565_lerp(top, bottom, wy);
+            ((uint16_t *)out)[i] = (uint16_t)(pixel | (pixel >> 16));
+            continue;
+        }
+
+        uint32_t wx = (x >> (SCALER_FRAC_BITS - 8)) & 0xFF;
+        uint32_t wy = (y >> (SCALER_FRAC_BITS - 8)) & 0xFF;
+        for (uint32_t c = 0; c < 3; c++) {
+            uint32_t top = p00[c] * (256 - wx) + p01[c] * wx;
+            uint32_t bottom = p10[c] * (256 - wx) + p11[c] * wx;
+            out[i * 3 + c] = (uint8_t)((top * (256 - wy) + bottom * wy) >> 16);
+        }
+    }
+}
+
+/**
+ * @brief Scale, crop and rotate a frame with the CPU, in 16.16 fixed point
+ */
+static void scale_sw(const app_video_scaler_t *scaler, const app_video_layout_t *layout, const uint8_t *src,
+                     uint32_t src_width, uint8_t *dst)
+{
+    const app_video_rect_t *crop_rect = &layout->src;
+    const app_video_rect_t *video = &layout->dst;
+    app_video_rotation_t rotation = scaler->config.rotation;
+    bool quarter = is_quarter_turn(rotation);
+    bool bilinear = (scaler->config.filter == APP_VIDEO_FILTER_BILINEAR);
+    uint32_t bpp = scaler->bytes_per_pixel;
+    uint32_t src_stride = src_width * bpp;
+    uint32_t dst_stride = scaler->config.dst_width * bpp;
+    const uint8_t *crop = src + crop_rect->y * src_stride + crop_rect->x * bpp;
+
+    // Steps in the rotated crop per display pixel, between the pixel centers so that the rotations are exact. The
+    // nearest filter rounds the position, the bilinear filter interpolates it.
+    uint32_t rot_width = quarter ? crop_rect->height : crop_rect->width;
+    uint32_t rot_height = quarter ? crop_rect->width : crop_rect->height;
+    int32_t step_u = (int32_t)(((uint64_t)rot_width << SCALER_FRAC_BITS) / video->width);
+    int32_t step_v = (int32_t)(((uint64_t)rot_height << SCALER_FRAC_BITS) / video->height);
+    int32_t start_u = step_u / 2 - SCALER_HALF;
+    int32_t start_v = step_v / 2 - SCALER_HALF;
+
+    int32_t max_x = (int32_t)(crop_rect->width - 1) << SCALER_FRAC_BITS;
+    int32_t max_y = (int32_t)(crop_rect->height - 1) << SCALER_FRAC_BITS;
+
+    for (uint32_t row = 0; row < video->height; row++) {
+        int32_t v = start_v + (int32_t)row * step_v;
+
+        // The rotated crop at (u, v) is the crop at (x, y)
+        row_walk_t walk;
+        switch (rotation) {
+        case APP_VIDEO_ROTATE_90:
+            walk = (row_walk_t) { max_x - v, start_u, 0, step_u };
+            break;
+        case APP_VIDEO_ROTATE_180:
+            walk = (row_walk_t) { max_x - start_u, max_y - v, -step_u, 0 };
+            break;
+        case APP_VIDEO_ROTATE_270:
+            walk = (row_walk_t) { v, max_y - start_u, 0, -step_u };
+            break;
+        default:
+            walk = (row_walk_t) { start_u, v, step_u, 0 };
+            break;
+        }
+
+        uint8_t *out = dst + (video->y + row) * dst_stride + video->x * bpp;
+        if (bilinear) {
+            scale_row_bilinear(scaler, crop, src_stride, max_x, max_y, walk, out, video->width);
+        } else {
+            scale_row_nearest(scaler, crop, src_stride, max_x, max_y, walk, out, video->width);
+        }
+    }
+}
+
+/**
+ * @brief Clear the bars around the video with the CPU
+ */
+static void clear_bars_sw(const app_video_scaler_t *scaler, const app_video_layout_t *layout, uint8_t *dst)
+{
+    app_video_rect_t bars[SCALER_BAR_NUM];
+    uint32_t count = get_bars(scaler, layout, bars);
+    uint32_t bpp = scaler->bytes_per_pixel;
+    uint32_t dst_stride = scaler->config.dst_width * bpp;
+
+    for (uint32_t i = 0; i < count; i++) {
+        for (uint32_t row = 0; row < bars[i].height; row++) {
+            memset(dst + (bars[i].y + row) * dst_stride + bars[i].x * bpp, 0, bars[i].width * bpp);
+        }
+    }
+}
+
+#if SOC_PPA_SUPPORTED
+/**
+ * @brief Scale, crop and rotate a frame, and clear the bars around it, with the PPA
+ */
+static esp_err_t scale_hw(const app_video_scaler_t *scaler, const app_video_layout_t *layout, const void *src,
+                          uint32_t src_width, uint32_t src_height, void *dst, uint32_t dst_size)
+{
+    static const ppa_srm_rotation_angle_t rotations[] = {
+        [APP_VIDEO_ROTATE_0] = PPA_SRM_ROTATION_ANGLE_0,
+        [APP_VIDEO_ROTATE_90] = PPA_SRM_ROTATION_ANGLE_90,
+        [APP_VIDEO_ROTATE_180] = PPA_SRM_ROTATION_ANGLE_180,
+        [APP_VIDEO_ROTATE_270] = PPA_SRM_ROTATION_ANGLE_270,
+    };
+    bool rgb565 = (scaler->config.pixel_format == APP_VIDEO_PIXEL_RGB565);
+    float scale = (float)scaler->hw_scale / SCALER_HW_SCALE_STEPS;
+
+    ppa_srm_oper_config_t srm_config = {
+        .in.buffer = src,
+        .in.pic_w = src_width,
+        .in.pic_h = src_height,
+        .in.block_w = layout->src.width,
+        .in.block_h = layout->src.height,
+        .in.block_offset_x = layout->src.x,
+        .in.block_offset_y = layout->src.y,
+        .in.srm_cm = rgb565 ? PPA_SRM_COLOR_MODE_RGB565 : PPA_SRM_COLOR_MODE_RGB888,
+
+        .out.buffer = dst,
+        .out.buffer_size = dst_size,
+        .out.pic_w = scaler->config.dst_width,
+        .out.pic_h = scaler->config.dst_height,
+        .out.block_offset_x = layout->dst.x,
+        .out.block_offset_y = layout->dst.y,
+        .out.srm_cm = rgb565 ? PPA_SRM_COLOR_MODE_RGB565 : PPA_SRM_COLOR_MODE_RGB888,
+
+        .rotation_angle = rotations[scaler->config.rotation],
+        .scale_x = scale,
+        .scale_y = scale,
+        .mirror_x = false,
+        .mirror_y = false,
+        .rgb_swap = false,
+        .byte_swap = false,
+        .mode = PPA_TRANS_MODE_BLOCKING,
+    };
+    esp_err_t ret = ppa_do_scale_rotate_mirror(scaler->srm_client, &srm_config);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // The bars are filled by the PPA too, the cache of the CPU never holds a part of the display buffer
+    app_video_rect_t bars[SCALER_BAR_NUM];
+    uint32_t count = get_bars(scaler, layout, bars);
+    for (uint32_t i = 0; (i < count) && (ret == ESP_OK); i++) {
+        ppa_fill_oper_config_t fill_config = {
+            .out.buffer = dst,
+            .out.buffer_size = dst_size,
+            .out.pic_w = scaler->config.dst_width,
+            .out.pic_h = scaler->config.dst_height,
+            .out.block_offset_x = bars[i].x,
+            .out.block_offset_y = bars[i].y,
+            .out.fill_cm = rgb565 ? PPA_FILL_COLOR_MODE_RGB565 : PPA_FILL_COLOR_MODE_RGB888,
+            .fill_block_w = bars[i].width,
+            .fill_block_h = bars[i].height,
+            .fill_argb_color = { .val = 0xFF000000 },
+            .mode = PPA_TRANS_MODE_BLOCKING,
+        };
+        ret = ppa_do_fill(scaler->fill_client, &fill_config);
+    }
+
+    return ret;
+}
+
+static void unregister_ppa(app_video_scaler_t *scaler)
+{
+    if (scaler->srm_client != NULL) {
+        ppa_unregister_client(scaler->srm_client);
+        scaler->srm_client = NULL;
+    }
+    if (scaler->fill_client != NULL) {
+        ppa_unregister_client(scaler->fill_client);
+        scaler->fill_client = NULL;
+    }
+}
+
+static void register_ppa(app_video_scaler_t *scaler)
+{
+    ppa_client_config_t srm_config = {
+        .oper_type = PPA_OPERATION_SRM,
+    };
+    ppa_client_config_t fill_config = {
+        .oper_type = PPA_OPERATION_FILL,
+    };
+
+    if ((ppa_register_client(&srm_config, &scaler->srm_client) != ESP_OK) ||
+            (ppa_register_client(&fill_config, &scaler->fill_client) != ESP_OK)) {
+        ESP_LOGW(TAG, "PPA unavailable, the frames are scaled in software");
+        unregister_ppa(scaler);
+    }
+}
+#endif
+
+esp_err_t app_video_scaler_create(const app_video_scaler_config_t *config, app_video_scaler_handle_t *ret_scaler)
+{
+    if (config == NULL || ret_scaler == NULL || config->dst_width == 0 || config->dst_height == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    app_video_scaler_t *scaler = calloc(1, sizeof(app_video_scaler_t));
+    if (scaler == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    scaler->config = *config;
+    scaler->bytes_per_pixel = (config->pixel_format == APP_VIDEO_PIXEL_RGB888) ? 3 : 2;
+
+#if SOC_PPA_SUPPORTED
+    if (config->use_hw) {
+        register_ppa(scaler);
+    }
+#endif
+
+    *ret_scaler = scaler;
+    return ESP_OK;
+}
+
+esp_err_t app_video_scaler_get_layout(app_video_scaler_handle_t scaler, uint32_t src_width, uint32_t src_height,
+                                      app_video_layout_t *layout)
+{
+    if (scaler == NULL || layout == NULL || src_width == 0 || src_height == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *layout = *update_layout(scaler, src_width, src_height);
+    return ESP_OK;
+}
+
+bool app_video_scaler_is_identity(app_video_scaler_handle_t scaler, uint32_t src_width, uint32_t src_height)
+{
+    // Any mode shows a video of the display size as is
+    return (scaler != NULL) && (scaler->config.rotation == APP_VIDEO_ROTATE_0) &&
+           (src_width == scaler->config.dst_width) && (src_height == scaler->config.dst_height);
+}
+
+esp_err_t app_video_scaler_process(app_video_scaler_handle_t scaler, const void *src, uint32_t src_width,
+                                   uint32_t src_height, void *dst, uint32_t dst_size)
+{
+    if (scaler == NULL || src == NULL || dst == NULL || src_width == 0 || src_height == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (dst_size < scaler->config.dst_width * scaler->config.dst_height * scaler->bytes_per_pixel) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    int64_t start_us = esp_timer_get_time();
+    const app_video_layout_t *layout = update_layout(scaler, src_width, src_height);
+    bool hw = layout->hw;
+
+#if SOC_PPA_SUPPORTED
+    if (hw && (scale_hw(scaler, layout, src, src_width, src_height, dst, dst_size) != ESP_OK)) {
+        scaler->hw_failures++;
+        hw = false;
+    }
+#endif
+
+    if (!hw) {
+        // A layout of the PPA, on a failure of the PPA, is scaled in software as is
+        if (layout->dst.width > 0 && layout->dst.height > 0) {
+            scale_sw(scaler, layout, src, src_width, dst);
+        }
+        clear_bars_sw(scaler, layout, dst);
+    }
+
+    uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start_us);
+    scaler->last_hw = hw;
+    scaler->frames++;
+    scaler->total_us += elapsed_us;
+    if (elapsed_us > scaler->max_us) {
+        scaler->max_us = elapsed_us;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t app_video_scaler_get_stats(app_video_scaler_handle_t scaler, app_video_scaler_stats_t *stats)
+{
+    if (scaler == NULL || stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    stats->hw = scaler->last_hw;
+    stats->frames = scaler->frames;
+    stats->hw_failures = scaler->hw_failures;
+    stats->avg_us = (scaler->frames > 0) ? (uint32_t)(scaler->total_us / scaler->frames) : 0;
+    stats->max_us = scaler->max_us;
+    return ESP_OK;
+}
+
+esp_err_t app_video_scaler_destroy(app_video_scaler_handle_t scaler)
+{
+    if (scaler == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+#if SOC_PPA_SUPPORTED
+    unregister_ppa(scaler);
+#endif
+
+    free(scaler);
+    return ESP_OK;
+}
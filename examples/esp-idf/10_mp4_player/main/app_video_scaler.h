@@ -0,0 +1,162 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Video scaler handle
+ */
+typedef struct app_video_scaler_t* app_video_scaler_handle_t;
+
+/**
+ * @brief Placement of the video on the display, the aspect ratio is always kept
+ */
+typedef enum {
+    APP_VIDEO_SCALE_FIT,        /*!< Scale to the largest size within the display, with bars on two sides */
+    APP_VIDEO_SCALE_FILL,       /*!< Scale to the smallest size covering the display, the overflow is cropped */
+    APP_VIDEO_SCALE_LETTERBOX,  /*!< Native size centered with bars, scaled down only if larger than the display */
+} app_video_scale_mode_t;
+
+/**
+ * @brief Rotation of the video, counter-clockwise
+ */
+typedef enum {
+    APP_VIDEO_ROTATE_0,
+    APP_VIDEO_ROTATE_90,
+    APP_VIDEO_ROTATE_180,
+    APP_VIDEO_ROTATE_270,
+} app_video_rotation_t;
+
+/**
+ * @brief Interpolation of the software scaler
+ */
+typedef enum {
+    APP_VIDEO_FILTER_NEAREST,   /*!< Nearest pixel, the fastest */
+    APP_VIDEO_FILTER_BILINEAR,  /*!< Bilinear interpolation of the 4 nearest pixels */
+} app_video_filter_t;
+
+/**
+ * @brief Pixel format of the source and of the display
+ */
+typedef enum {
+    APP_VIDEO_PIXEL_RGB565,     /*!< RGB565 in native byte order, 2 bytes per pixel */
+    APP_VIDEO_PIXEL_RGB888,     /*!< RGB888, 3 bytes per pixel */
+} app_video_pixel_format_t;
+
+/**
+ * @brief Video scaler configuration structure
+ */
+typedef struct {
+    uint32_t dst_width;                     /*!< Display width */
+    uint32_t dst_height;                    /*!< Display height */
+    app_video_pixel_format_t pixel_format;  /*!< Pixel format of the source and of the display */
+    app_video_scale_mode_t mode;            /*!< Placement of the video */
+    app_video_rotation_t rotation;          /*!< Rotation of the video */
+    app_video_filter_t filter;              /*!< Interpolation of the software scaler */
+    bool use_hw;                            /*!< Use the 2D pixel-processing accelerator (PPA) if the chip has one */
+} app_video_scaler_config_t;
+
+/**
+ * @brief Helper macro to create default video scaler configuration for a RGB565 display
+ */
+#define APP_VIDEO_SCALER_CONFIG_DEFAULT(width, height)  \
+    {                                                   \
+        .dst_width = (width),                           \
+        .dst_height = (height),                         \
+        .pixel_format = APP_VIDEO_PIXEL_RGB565,         \
+        .mode = APP_VIDEO_SCALE_FIT,                    \
+        .rotation = APP_VIDEO_ROTATE_0,                 \
+        .filter = APP_VIDEO_FILTER_BILINEAR,            \
+        .use_hw = true,                                 \
+    }
+
+/**
+ * @brief Rectangle in pixels
+ */
+typedef struct {
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+} app_video_rect_t;
+
+/**
+ * @brief Placement of a video of a given size on the display
+ */
+typedef struct {
+    app_video_rect_t src;       /*!< Part of the source shown, before the rotation */
+    app_video_rect_t dst;       /*!< Part of the display covered by the video, the rest is black */
+    bool hw;                    /*!< True if the frames are scaled by the PPA */
+} app_video_layout_t;
+
+/**
+ * @brief Video scaler statistics structure
+ */
+typedef struct {
+    bool hw;                    /*!< True if the last frame was scaled by the PPA */
+    uint32_t frames;            /*!< Frames scaled */
+    uint32_t hw_failures;       /*!< Frames scaled in software after a failure of the PPA */
+    uint32_t avg_us;            /*!< Average time per frame */
+    uint32_t max_us;            /*!< Maximum time per frame */
+} app_video_scaler_stats_t;
+
+/**
+ * @brief Create a video scaler
+ *
+ * The PPA scales by steps of 1/16, so with it the video can be a few pixels smaller than the display in fit mode. The
+ * software scaler is portable, in 16.16 fixed point, and serves the chips without PPA and the sizes out of its range.
+ *
+ * @param config Video scaler configuration
+ * @param ret_scaler Pointer to store the video scaler handle
+ * @return ESP_OK on success, or an error code
+ */
+esp_err_t app_video_scaler_create(const app_video_scaler_config_t *config, app_video_scaler_handle_t *ret_scaler);
+
+/**
+ * @brief Get the placement of a video of a given size on the display
+ */
+esp_err_t app_video_scaler_get_layout(app_video_scaler_handle_t scaler, uint32_t src_width, uint32_t src_height,
+                                      app_video_layout_t *layout);
+
+/**
+ * @brief Check if a video of a given size covers the display as is, so it can be decoded straight into the display
+ */
+bool app_video_scaler_is_identity(app_video_scaler_handle_t scaler, uint32_t src_width, uint32_t src_height);
+
+/**
+ * @brief Scale, crop and rotate a frame into a display buffer, and clear the bars around it
+ *
+ * @param scaler Video scaler handle
+ * @param src Source frame, with lines of src_width pixels
+ * @param src_width Source width
+ * @param src_height Source height
+ * @param dst Display buffer, aligned on the cache line for the PPA
+ * @param dst_size Size of the display buffer
+ * @return ESP_OK on success, or an error code
+ */
+esp_err_t app_video_scaler_process(app_video_scaler_handle_t scaler, const void *src, uint32_t src_width,
+                                   uint32_t src_height, void *dst, uint32_t dst_size);
+
+/**
+ * @brief Get the video scaler statistics
+ */
+esp_err_t app_video_scaler_get_stats(app_video_scaler_handle_t scaler, app_video_scaler_stats_t *stats);
+
+/**
+ * @brief Destroy a video scaler
+ */
+esp_err_t app_video_scaler_destroy(app_video_scaler_handle_t scaler);
+
+#ifdef __cplusplus
+}
+#endif
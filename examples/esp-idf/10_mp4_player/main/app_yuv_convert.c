@@ -0,0 +1,138 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "app_yuv_convert.h"
+
+#define CONVERT_CHUNK   (64)    /*!< Pixels of a row converted at once, from chroma terms on the stack */
+
+/* BT.601 with the limited range in Q8: R = 1.164 (Y - 16) + 1.596 Cr, G = 1.164 (Y - 16) - 0.391 Cb - 0.813 Cr,
+ * B = 1.164 (Y - 16) + 2.018 Cb */
+#define COEF_Y          (298)
+#define COEF_RV         (409)
+#define COEF_GU         (100)
+#define COEF_GV         (208)
+#define COEF_BU         (516)
+#define COEF_ROUND      (128)
+
+#define MIN(a, b)       (((a) < (b)) ? (a) : (b))
+
+/**
+ * @brief Chroma terms of a chunk of two rows, per pixel, for the channels in the high and the low bits
+ */
+typedef struct {
+    int32_t hi[CONVERT_CHUNK];
+    int32_t g[CONVERT_CHUNK];
+    int32_t lo[CONVERT_CHUNK];
+} chroma_terms_t;
+
+/**
+ * @brief Copy of the last chunk of a row, shorter than a chunk, so the loops always run over a whole chunk
+ */
+typedef struct {
+    uint16_t out[CONVERT_CHUNK * 3 / 2];    /*!< RGB565 or RGB888 */
+    uint8_t y[CONVERT_CHUNK];
+    uint8_t u[CONVERT_CHUNK / 2];
+    uint8_t v[CONVERT_CHUNK / 2];
+} chunk_tail_t;
+
+static inline int32_t clamp_u8(int32_t value)
+{
+    return (value < 0) ? 0 : ((value > 255) ? 255 : value);
+}
+
+/* The loops below run over a whole chunk, without aliasing between their arrays, so the compiler vectorizes them
+ * with its cheapest cost model, the one of -O2 */
+
+static void get_chroma_terms(const uint8_t *restrict u, const uint8_t *restrict v, bool bgr_order,
+                             chroma_terms_t *restrict terms)
+{
+    // The red goes to the high bits in BGR order, the blue otherwise
+    const int32_t hi_u = bgr_order ? 0 : COEF_BU;
+    const int32_t hi_v = bgr_order ? COEF_RV : 0;
+    const int32_t lo_u = bgr_order ? COEF_BU : 0;
+    const int32_t lo_v = bgr_order ? 0 : COEF_RV;
+    for (uint32_t i = 0; i < CONVERT_CHUNK / 2; i++) {
+        int32_t cb = u[i] - 128;
+        int32_t cr = v[i] - 128;
+        int32_t hi = hi_u * cb + hi_v * cr + COEF_ROUND;
+        int32_t g = COEF_ROUND - COEF_GU * cb - COEF_GV * cr;
+        int32_t lo = lo_u * cb + lo_v * cr + COEF_ROUND;
+        terms->hi[2 * i] = hi;
+        terms->hi[2 * i + 1] = hi;
+        terms->g[2 * i] = g;
+        terms->g[2 * i + 1] = g;
+        terms->lo[2 * i] = lo;
+        terms->lo[2 * i + 1] = lo;
+    }
+}
+
+static void chunk_to_rgb565(const uint8_t *restrict y, const chroma_terms_t *restrict terms, uint16_t *restrict out)
+{
+    for (uint32_t x = 0; x < CONVERT_CHUNK; x++) {
+        int32_t luma = COEF_Y * (y[x] - 16);
+        int32_t hi = clamp_u8((luma + terms->hi[x]) >> 8);
+        int32_t g = clamp_u8((luma + terms->g[x]) >> 8);
+        int32_t lo = clamp_u8((luma + terms->lo[x]) >> 8);
+        out[x] = (uint16_t)(((hi & 0xF8) << 8) | ((g & 0xFC) << 3) | (lo >> 3));
+    }
+}
+
+static void chunk_to_rgb888(const uint8_t *restrict y, const chroma_terms_t *restrict terms, uint8_t *restrict out)
+{
+    for (uint32_t x = 0; x < CONVERT_CHUNK; x++) {
+        int32_t luma = COEF_Y * (y[x] - 16);
+        out[3 * x] = (uint8_t)clamp_u8((luma + terms->lo[x]) >> 8);
+        out[3 * x + 1] = (uint8_t)clamp_u8((luma + terms->g[x]) >> 8);
+        out[3 * x + 2] = (uint8_t)clamp_u8((luma + terms->hi[x]) >> 8);
+    }
+}
+
+void app_yuv_convert_rows(const app_yuv_picture_t *picture, uint32_t row, uint32_t rows,
+                          app_video_pixel_format_t format, bool bgr_order, uint8_t *out, uint32_t out_stride)
+{
+    bool rgb888 = (format == APP_VIDEO_PIXEL_RGB888);
+    uint32_t bpp = rgb888 ? 3 : 2;
+    uint32_t end = MIN(row + rows, picture->height);
+    chroma_terms_t terms;
+    chunk_tail_t tail = {0};
+
+    for (uint32_t pair = row; pair < end; pair += 2) {
+        const uint8_t *u = picture->u + (pair / 2) * picture->uv_stride;
+        const uint8_t *v = picture->v + (pair / 2) * picture->uv_stride;
+        uint32_t pair_rows = MIN(2, end - pair);
+
+        for (uint32_t x = 0; x < picture->width; x += CONVERT_CHUNK) {
+            uint32_t pixels = MIN(CONVERT_CHUNK, picture->width - x);
+            bool partial = (pixels < CONVERT_CHUNK);
+            if (partial) {
+                memcpy(tail.u, u + x / 2, (pixels + 1) / 2);
+                memcpy(tail.v, v + x / 2, (pixels + 1) / 2);
+            }
+            get_chroma_terms(partial ? tail.u : u + x / 2, partial ? tail.v : v + x / 2, bgr_order, &terms);
+
+            for (uint32_t i = 0; i < pair_rows; i++) {
+                const uint8_t *y = picture->y + (pair + i) * picture->y_stride + x;
+                uint8_t *dst = out + (pair + i) * out_stride + x * bpp;
+                if (partial) {
+                    memcpy(tail.y, y, pixels);
+                }
+                const uint8_t *chunk_y = partial ? tail.y : y;
+                uint8_t *chunk_out = partial ? (uint8_t *)tail.out : dst;
+                if (rgb888) {
+                    chunk_to_rgb888(chunk_y, &terms, chunk_out);
+                } else {
+                    chunk_to_rgb565(chunk_y, &terms, (uint16_t *)chunk_out);
+                }
+                if (partial) {
+                    memcpy(dst, tail.out, pixels * bpp);
+                }
+            }
+        }
+    }
+}
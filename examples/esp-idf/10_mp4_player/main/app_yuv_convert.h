@@ -0,0 +1,50 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_video_scaler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Planar YUV 4:2:0 picture, e.g. the I420 output of a video decoder
+ */
+typedef struct {
+    const uint8_t *y;       /*!< Luma plane */
+    const uint8_t *u;       /*!< Cb plane, subsampled by 2 in both directions */
+    const uint8_t *v;       /*!< Cr plane, subsampled by 2 in both directions */
+    uint32_t y_stride;      /*!< Bytes between two rows of the luma plane */
+    uint32_t uv_stride;     /*!< Bytes between two rows of the chroma planes */
+    uint32_t width;         /*!< Width in pixels */
+    uint32_t height;        /*!< Height in pixels */
+} app_yuv_picture_t;
+
+/**
+ * @brief Convert rows of a YUV 4:2:0 picture to RGB
+ *
+ * The conversion is BT.601 with the limited range of the video streams, in fixed point. The chroma terms of a chunk of
+ * a row are computed once for the two rows sharing them, then each pixel is converted by the same arithmetic without
+ * lookup table, a loop the compiler vectorizes. The rows are independent, so a picture can be converted by several
+ * tasks at once, each with its own range of rows.
+ *
+ * @param picture YUV picture
+ * @param row First row to convert, even
+ * @param rows Number of rows to convert
+ * @param format Output pixel format, RGB565 in native byte order or RGB888
+ * @param bgr_order True for the blue in the low bits of RGB565 or the first byte of RGB888, as the panels take it
+ * @param out First byte of the first row of the output picture
+ * @param out_stride Bytes between two rows of the output picture
+ */
+void app_yuv_convert_rows(const app_yuv_picture_t *picture, uint32_t row, uint32_t rows,
+                          app_video_pixel_format_t format, bool bgr_order, uint8_t *out, uint32_t out_stride);
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,7 +6,6 @@
 
 #include <inttypes.h>
 #include <string.h>
-#include <dirent.h>
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -22,6 +21,9 @@
 
 #include "bsp/esp-bsp.h"
 #include "app_stream_adapter.h"
+#include "app_video_scaler.h"
+#include "app_playlist.h"
+#include "app_trace_console.h"
 #include "sdkconfig.h"
 
 static const char *TAG = "main";
@@ -34,6 +36,17 @@ static esp_lcd_panel_handle_t lcd_panel;
 static esp_lcd_panel_io_handle_t lcd_io;
 static void *lcd_buffer[CONFIG_BSP_LCD_DPI_BUFFER_NUMS];
 static SemaphoreHandle_t trans_sem;
+static uint32_t lcd_shown_buffer = 0;
+
+/* ===================== Scaling ===================== */
+
+#define ALIGN_UP(num, align) (((num) + ((align) - 1)) & ~((align) - 1))
+#define VIDEO_SIZE_ALIGN    (16)    /*!< The JPEG decoder outputs whole blocks of 16x16 pixels */
+
+static app_video_scaler_handle_t video_scaler;
+static void *scale_buffer[CONFIG_BSP_LCD_DPI_BUFFER_NUMS];
+static uint32_t scale_buffer_size = 0;
+static bool video_scaled = false;
 
 /* ===================== Audio ===================== */
 
@@ -45,11 +58,12 @@ static app_stream_adapter_handle_t stream_adapter;
 
 /* ===================== Playlist ===================== */
 
-#define MAX_MP4_FILES   16
-#define MAX_PATH_LEN   128
+#define MEDIA_FILE_EXT      ".mp4"
+#define PLAYBACK_POLL_MS    (500)
 
-static char mp4_list[MAX_MP4_FILES][MAX_PATH_LEN];
-static int mp4_count = 0;
+static app_playlist_handle_t playlist;
+static TaskHandle_t playlist_task;
+static app_stream_stats_t finished_stats;   /*!< Statistics of the file finished by a gapless switch */
 
 /* ===================== DPI Callback ===================== */
 
@@ -62,7 +76,7 @@ static bool flush_dpi_panel_ready_callback(
     if (trans_sem) {
         xSemaphoreGiveFromISR(trans_sem, &taskAwake);
     }
-    return false;
+    return taskAwake == pdTRUE;
 }
 
 /* ===================== Frame Callback ===================== */
@@ -74,6 +88,28 @@ static esp_err_t display_decoded_frame(uint8_t *buffer,
                                        uint32_t buffer_index,
                                        void *user_data)
 {
+    // The frames of the other sizes are scaled into the frame buffer after the one shown
+    if (video_scaled) {
+        lcd_shown_buffer = (lcd_shown_buffer + 1) % CONFIG_BSP_LCD_DPI_BUFFER_NUMS;
+        esp_err_t ret = app_video_scaler_process(video_scaler, buffer, width, height,
+                                                 lcd_buffer[lcd_shown_buffer], DISPLAY_BUFFER_SIZE);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+
+        buffer = lcd_buffer[lcd_shown_buffer];
+        width = BSP_LCD_H_RES;
+        height = BSP_LCD_V_RES;
+    } else {
+        for (uint32_t i = 0; i < CONFIG_BSP_LCD_DPI_BUFFER_NUMS; i++) {
+            if (lcd_buffer[i] == buffer) {
+                lcd_shown_buffer = i;
+            }
+        }
+    }
+
+    // A frame buffer of the panel is swapped in rather than copied. Once the refresh in progress is done, the panel
+    // scans the new buffer, and the stream adapter can decode into the previous one.
     esp_lcd_panel_draw_bitmap(lcd_panel, 0, 0, width, height, buffer);
 
     xSemaphoreTake(trans_sem, 0);
@@ -82,108 +118,343 @@ static esp_err_t display_decoded_frame(uint8_t *buffer,
     return ESP_OK;
 }
 
-/* ===================== Scan MP4 Files ===================== */
+/* ===================== Video Scaling ===================== */
 
-static void scan_mp4_files(const char *dir_path)
+static void video_scaler_init(void)
 {
-    DIR *dir = opendir(dir_path);
-    if (!dir) {
-        ESP_LOGE(TAG, "Failed to open directory: %s", dir_path);
-        return;
-    }
+    app_video_scaler_config_t config = APP_VIDEO_SCALER_CONFIG_DEFAULT(BSP_LCD_H_RES, BSP_LCD_V_RES);
+
+#if CONFIG_HDMI_VIDEO_SCALE_FILL
+    config.mode = APP_VIDEO_SCALE_FILL;
+#elif CONFIG_HDMI_VIDEO_SCALE_LETTERBOX
+    config.mode = APP_VIDEO_SCALE_LETTERBOX;
+#endif
+
+#if CONFIG_HDMI_VIDEO_ROTATION_90
+    config.rotation = APP_VIDEO_ROTATE_90;
+#elif CONFIG_HDMI_VIDEO_ROTATION_180
+    config.rotation = APP_VIDEO_ROTATE_180;
+#elif CONFIG_HDMI_VIDEO_ROTATION_270
+    config.rotation = APP_VIDEO_ROTATE_270;
+#endif
+
+#if !CONFIG_HDMI_VIDEO_SCALER_HW
+    config.use_hw = false;
+#endif
+#if !CONFIG_HDMI_VIDEO_SCALER_BILINEAR
+    config.filter = APP_VIDEO_FILTER_NEAREST;
+#endif
+
+    ESP_ERROR_CHECK(app_video_scaler_create(&config, &video_scaler));
+}
 
-    struct dirent *entry;
-    mp4_count = 0;
+static void free_scale_buffers(void)
+{
+    for (int i = 0; i < CONFIG_BSP_LCD_DPI_BUFFER_NUMS; i++) {
+        heap_caps_free(scale_buffer[i]);
+        scale_buffer[i] = NULL;
+    }
+    scale_buffer_size = 0;
+}
 
-    while ((entry = readdir(dir)) != NULL) {
-        if (entry->d_type != DT_REG) {
-            continue;
-        }
+static size_t get_scale_buffer_align(void)
+{
+    size_t align = 0;
+    ESP_ERROR_CHECK(esp_cache_get_alignment(MALLOC_CAP_SPIRAM, &align));
+    return align;
+}
 
-        const char *name = entry->d_name;
-        int len = strlen(name);
+/**
+ * Size of the buffers a video of another size than the display is decoded into
+ */
+static uint32_t get_scale_buffer_size(uint32_t width, uint32_t height)
+{
+    return ALIGN_UP(ALIGN_UP(width, VIDEO_SIZE_ALIGN) * ALIGN_UP(height, VIDEO_SIZE_ALIGN) * 2,
+                    get_scale_buffer_align());
+}
 
-        if (len > 4 && strcasecmp(&name[len - 4], ".mp4") == 0) {
-            snprintf(mp4_list[mp4_count],
-                     MAX_PATH_LEN,
-                     "%s/%s",
-                     dir_path,
-                     name);
+/**
+ * Decode a video straight into the frame buffers if it covers the display as is, or else into buffers of its size
+ * which are scaled into the frame buffers
+ */
+static esp_err_t set_video_output(const char *filename)
+{
+    uint32_t width = BSP_LCD_H_RES;
+    uint32_t height = BSP_LCD_V_RES;
+    if (app_stream_adapter_probe_video_info(filename, &width, &height, NULL, NULL) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to probe %s, assuming the display size", filename);
+    }
 
-            ESP_LOGI(TAG, "Found MP4: %s", mp4_list[mp4_count]);
+    video_scaled = !app_video_scaler_is_identity(video_scaler, width, height);
+    if (!video_scaled) {
+        return app_stream_adapter_resize_buffers(stream_adapter, lcd_buffer,
+                                                 CONFIG_BSP_LCD_DPI_BUFFER_NUMS, DISPLAY_BUFFER_SIZE);
+    }
 
-            mp4_count++;
-            if (mp4_count >= MAX_MP4_FILES) {
-                break;
+    size_t align = get_scale_buffer_align();
+    uint32_t size = get_scale_buffer_size(width, height);
+
+    // Kept for the next videos, reallocated only for a larger one
+    if (size > scale_buffer_size) {
+        free_scale_buffers();
+        for (int i = 0; i < CONFIG_BSP_LCD_DPI_BUFFER_NUMS; i++) {
+            scale_buffer[i] = heap_caps_aligned_calloc(align, 1, size, MALLOC_CAP_SPIRAM);
+            if (scale_buffer[i] == NULL) {
+                ESP_LOGE(TAG, "Failed to allocate the buffers of a %" PRIu32 "x%" PRIu32 " video", width, height);
+                free_scale_buffers();
+                return ESP_ERR_NO_MEM;
             }
         }
+        scale_buffer_size = size;
     }
 
-    closedir(dir);
-    ESP_LOGI(TAG, "Total MP4 files: %d", mp4_count);
+    return app_stream_adapter_resize_buffers(stream_adapter, scale_buffer,
+                                             CONFIG_BSP_LCD_DPI_BUFFER_NUMS, scale_buffer_size);
+}
+
+/**
+ * The next video follows the current one without gap only if it is decoded into the same buffers
+ */
+static bool next_video_output_fits(void)
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    if (app_stream_adapter_get_next_info(stream_adapter, &width, &height, NULL, NULL) != ESP_OK) {
+        return false;
+    }
+
+    bool scaled = !app_video_scaler_is_identity(video_scaler, width, height);
+    if (scaled != video_scaled) {
+        return false;
+    }
+    return !scaled || (get_scale_buffer_size(width, height) <= scale_buffer_size);
 }
 
 /* ===================== Playlist Playback ===================== */
 
+static void log_playback_stats(const char *filename, const app_stream_stats_t *stats)
+{
+    ESP_LOGI(TAG,
+             "Finished %s (%" PRIu32 " frames, %" PRIu32 " dropped)",
+             filename,
+             stats->frames_processed,
+             stats->frames_dropped);
+    ESP_LOGI(TAG,
+             "Stage avg/max: extract %" PRIu32 "/%" PRIu32 " us, "
+             "decode %" PRIu32 "/%" PRIu32 " us, present %" PRIu32 "/%" PRIu32 " us",
+             stats->extract.avg_us, stats->extract.max_us,
+             stats->decode.avg_us, stats->decode.max_us,
+             stats->present.avg_us, stats->present.max_us);
+    ESP_LOGI(TAG,
+             "Decode: %" PRIu32 " pictures at %.1f fps end to end, from the compressed frame to the RGB picture",
+             stats->pictures_decoded,
+             stats->decode_fps);
+    ESP_LOGI(TAG,
+             "Frame pool: %" PRIu32 " frames, %" PRIu32 " held at most, %" PRIu32 " dropped",
+             stats->frame_pool.frames_wrapped,
+             stats->frame_pool.frames_in_use_max,
+             stats->frame_pool.wrap_failures);
+    ESP_LOGI(TAG,
+             "File read-ahead: %" PRIu64 " bytes, %" PRIu32 " stalls, %" PRIu32 " us at most, "
+             "%" PRIu32 " restarts",
+             stats->file_source.bytes_read,
+             stats->file_source.stalls,
+             stats->file_source.stall_max_us,
+             stats->file_source.restarts);
+    ESP_LOGI(TAG,
+             "A/V sync (%s clock): offset avg %" PRId32 " ms, min %" PRId32 " ms, "
+             "max %" PRId32 " ms, %" PRIu32 " late frames dropped, %" PRIu32 " early",
+             stats->av_sync.audio_master ? "audio" : "system",
+             stats->av_sync.offset_avg_ms,
+             stats->av_sync.offset_min_ms,
+             stats->av_sync.offset_max_ms,
+             stats->av_sync.frames_dropped,
+             stats->av_sync.frames_repeated);
+    if (g_audio_dev != NULL) {
+        ESP_LOGI(TAG,
+                 "Audio output (%" PRIu32 " Hz to %" PRIu32 " Hz): %" PRIu32 " underruns, %" PRIu32 " ms at most, "
+                 "%" PRIu32 " ms ahead at least, %" PRIu32 " decode pauses",
+                 stats->audio_output.in_rate,
+                 stats->audio_output.out_rate,
+                 stats->audio_output.underruns,
+                 stats->audio_output.underrun_max_ms,
+                 stats->audio_output.level_min_ms,
+                 stats->audio_output.decode_waits);
+    }
+    if (stats->h264.frames > 0) {
+        ESP_LOGI(TAG,
+                 "H.264: %" PRIu32 " frames since start, decode avg %" PRIu32 " us, max %" PRIu32 " us, "
+                 "RGB conversion avg %" PRIu32 " us, max %" PRIu32 " us, %" PRIu32 " reopens",
+                 stats->h264.frames,
+                 stats->h264.decode_avg_us,
+                 stats->h264.decode_max_us,
+                 stats->h264.convert_avg_us,
+                 stats->h264.convert_max_us,
+                 stats->h264.reopens);
+    }
+    if (stats->trace.frames > 0) {
+        ESP_LOGI(TAG,
+                 "Frame time: p50 %" PRIu32 " us, p95 %" PRIu32 " us, p99 %" PRIu32 " us, max %" PRIu32 " us, "
+                 "%.1f%% of the last %" PRIu32 " frames dropped",
+                 stats->trace.frame_p50_us,
+                 stats->trace.frame_p95_us,
+                 stats->trace.frame_p99_us,
+                 stats->trace.frame_max_us,
+                 stats->trace.drop_rate * 100.0f,
+                 stats->trace.frames);
+    }
+    if (video_scaled) {
+        app_video_scaler_stats_t scaler_stats;
+        app_video_scaler_get_stats(video_scaler, &scaler_stats);
+        ESP_LOGI(TAG,
+                 "Scaling (%s): %" PRIu32 " frames since start, avg %" PRIu32 " us, "
+                 "max %" PRIu32 " us",
+                 scaler_stats.hw ? "PPA" : "software",
+                 scaler_stats.frames,
+                 scaler_stats.avg_us,
+                 scaler_stats.max_us);
+    }
+}
+
+/**
+ * Called from the extract task when the preloaded file starts, the statistics are the ones of the previous file
+ */
+static void on_track_changed(const char *filename, void *user_data)
+{
+    app_stream_adapter_get_stats(stream_adapter, &finished_stats);
+    xTaskNotifyGive(playlist_task);
+}
+
+static void playlist_init(void)
+{
+    app_playlist_config_t config = APP_PLAYLIST_CONFIG_DEFAULT();
+    config.path = BSP_SD_MOUNT_POINT "/" CONFIG_HDMI_PLAYLIST_FILE;
+#if CONFIG_HDMI_PLAYLIST_SHUFFLE
+    config.shuffle = true;
+#endif
+#if CONFIG_HDMI_PLAYLIST_LOOP_ONE
+    config.loop = APP_PLAYLIST_LOOP_ONE;
+#elif CONFIG_HDMI_PLAYLIST_LOOP_NONE
+    config.loop = APP_PLAYLIST_LOOP_NONE;
+#endif
+    ESP_ERROR_CHECK(app_playlist_create(&config, &playlist));
+
+    // The files of the playlist come first, then the new files of the SD card
+    if (app_playlist_load(playlist) == ESP_ERR_NOT_FOUND) {
+        ESP_LOGI(TAG, "No playlist yet, it is created from the files of the SD card");
+    }
+    app_playlist_scan(playlist, BSP_SD_MOUNT_POINT, MEDIA_FILE_EXT);
+}
+
+/**
+ * Move to the next file of the playlist, and store it as the one to resume at
+ */
+static esp_err_t playlist_next(const char **filename)
+{
+    esp_err_t ret = app_playlist_next(playlist, filename);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    uint32_t position = 0;
+    app_playlist_get_current(playlist, &position, NULL);
+    ESP_LOGI(TAG, "Playing [%" PRIu32 "/%" PRIu32 "]: %s", position + 1, app_playlist_get_count(playlist),
+             *filename);
+
+    if (app_playlist_save(playlist) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to save the playlist");
+    }
+    return ESP_OK;
+}
+
+static esp_err_t start_file(const char *filename)
+{
+    esp_err_t ret = set_video_output(filename);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set the video output of %s", filename);
+        return ret;
+    }
+
+    app_stream_adapter_set_file(stream_adapter,
+                                filename,
+                                g_audio_dev != NULL);
+
+    ret = app_stream_adapter_start(stream_adapter);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start %s", filename);
+    }
+    return ret;
+}
+
 static void play_media_playlist(void)
 {
-    if (mp4_count == 0) {
+    uint32_t count = app_playlist_get_count(playlist);
+    if (count == 0) {
         ESP_LOGW(TAG, "No MP4 files to play");
         return;
     }
 
-    uint32_t loop_round = 0;
+    playlist_task = xTaskGetCurrentTaskHandle();
 
-    while (1) {
-        ESP_LOGI(TAG, "========== Playlist Loop #%lu ==========", ++loop_round);
+    const char *filename = NULL;
+    bool switched = false;
+    uint32_t failures = 0;
 
-        for (int i = 0; i < mp4_count; i++) {
-            const char *filename = mp4_list[i];
-            ESP_LOGI(TAG, "Playing [%d/%d]: %s", i + 1, mp4_count, filename);
-
-            app_stream_adapter_set_file(stream_adapter,
-                                        filename,
-                                        g_audio_dev != NULL);
+    while (1) {
+        // After a gapless switch, the file plays already
+        if (!switched) {
+            if (playlist_next(&filename) != ESP_OK) {
+                break;
+            }
 
-            esp_err_t ret = app_stream_adapter_start(stream_adapter);
-            if (ret != ESP_OK) {
-                ESP_LOGE(TAG, "Failed to start %s", filename);
+            if (start_file(filename) != ESP_OK) {
+                // Every file failed in a row
+                if (++failures >= count) {
+                    ESP_LOGE(TAG, "No file of the playlist can be played");
+                    break;
+                }
                 continue;
             }
+        }
+        failures = 0;
+        switched = false;
+
+#if CONFIG_HDMI_PLAYLIST_GAPLESS
+        // The next file is opened while this one plays, and follows it without gap if it fits the same buffers
+        const char *next = NULL;
+        if ((app_playlist_peek_next(playlist, &next) == ESP_OK) &&
+                (app_stream_adapter_preload_next(stream_adapter, next) == ESP_OK)) {
+            if (next_video_output_fits()) {
+                app_stream_adapter_queue_next(stream_adapter);
+            } else {
+                ESP_LOGI(TAG, "%s does not fit the buffers of this video, it starts after it", next);
+                app_stream_adapter_clear_next_file(stream_adapter);
+            }
+        }
+#endif
 
-            uint32_t stable_count = 0;
-            uint32_t last_frames = 0;
+        while (1) {
+            if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(PLAYBACK_POLL_MS)) > 0) {
+                log_playback_stats(filename, &finished_stats);
+                switched = (playlist_next(&filename) == ESP_OK);
+                break;
+            }
 
-            while (1) {
+            if (app_stream_adapter_wait_finished(stream_adapter, 0) == ESP_OK) {
                 app_stream_stats_t stats;
-                ret = app_stream_adapter_get_stats(stream_adapter, &stats);
-
-                if (ret == ESP_OK) {
-                    if (stats.frames_processed == last_frames) {
-                        stable_count++;
-                        if (stable_count >= 3) {
-                            ESP_LOGI(TAG,
-                                     "Finished %s (%" PRIu32 " frames)",
-                                     filename,
-                                     stats.frames_processed);
-                            break;
-                        }
-                    } else {
-                        stable_count = 0;
-                        last_frames = stats.frames_processed;
-                    }
-                } else {
-                    ESP_LOGW(TAG, "Stats error, stop playback");
-                    break;
-                }
-
-                vTaskDelay(pdMS_TO_TICKS(500));
+                app_stream_adapter_get_stats(stream_adapter, &stats);
+                log_playback_stats(filename, &stats);
+                break;
             }
+        }
 
+        if (!switched) {
             app_stream_adapter_stop(stream_adapter);
-            vTaskDelay(pdMS_TO_TICKS(200));
         }
     }
+
+    app_stream_adapter_stop(stream_adapter);
+    ESP_LOGI(TAG, "Playlist finished");
 }
 
 /* ===================== app_main ===================== */
@@ -204,14 +475,25 @@ void app_main(void)
     };
     esp_lcd_dpi_panel_register_event_callbacks(lcd_panel, &callbacks, NULL);
 
+    /* The frames are decoded straight into the spare frame buffers of the panel */
     ESP_ERROR_CHECK(
         esp_lcd_dpi_panel_get_frame_buffer(
             lcd_panel,
             CONFIG_BSP_LCD_DPI_BUFFER_NUMS,
+#if CONFIG_BSP_LCD_DPI_BUFFER_NUMS == 3
+            &lcd_buffer[0],
+            &lcd_buffer[1],
+            &lcd_buffer[2])
+#elif CONFIG_BSP_LCD_DPI_BUFFER_NUMS == 2
             &lcd_buffer[0],
             &lcd_buffer[1])
+#else
+            &lcd_buffer[0])
+#endif
     );
 
+    video_scaler_init();
+
     /* ---------- SD Card ---------- */
 
     ESP_ERROR_CHECK(bsp_sdcard_mount());
@@ -233,16 +515,27 @@ void app_main(void)
         .buffer_count  = CONFIG_BSP_LCD_DPI_BUFFER_NUMS,
         .buffer_size   = DISPLAY_BUFFER_SIZE,
         .audio_dev     = g_audio_dev,
-        .jpeg_config   = APP_STREAM_JPEG_CONFIG_DEFAULT_RGB565()
+        .jpeg_config   = APP_STREAM_JPEG_CONFIG_DEFAULT_RGB565(),
+        .track_cb      = on_track_changed,
+#if CONFIG_HDMI_FRAME_TRACE_ENABLED
+        .trace_depth   = CONFIG_HDMI_FRAME_TRACE_DEPTH,
+#endif
     };
 
     ESP_ERROR_CHECK(
         app_stream_adapter_init(&adapter_config, &stream_adapter)
     );
 
+#if CONFIG_HDMI_FRAME_TRACE_CONSOLE
+    /* The playback goes on without the console */
+    if (app_trace_console_start(stream_adapter) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to start the console");
+    }
+#endif
+
     /* ---------- Scan & Play ---------- */
 
-    scan_mp4_files(BSP_SD_MOUNT_POINT);
+    playlist_init();
 
     play_media_playlist();
 }
@@ -0,0 +1,370 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include "private/esp_brookesia_ai_agent_utils.hpp"
+#include "audio_jitter_ring.hpp"
+
+namespace esp_brookesia::ai_framework {
+
+bool AudioJitterRing::begin(const Config &config)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    ESP_UTILS_LOGD(
+        "Param: capacity_bytes(%d), frame_size_max(%d), frame_duration_ms(%d), target_latency_ms(%d), "
+        "max_latency_ms(%d), conceal_frame_num_max(%d)", static_cast<int>(config.capacity_bytes),
+        static_cast<int>(config.frame_size_max), config.frame_duration_ms, config.target_latency_ms,
+        config.max_latency_ms, config.conceal_frame_num_max
+    );
+
+    ESP_UTILS_CHECK_FALSE_RETURN(!checkInitialized(), false, "Already initialized");
+    ESP_UTILS_CHECK_FALSE_RETURN(config.frame_duration_ms > 0, false, "Invalid frame duration");
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        (config.frame_size_max > 0) && (getRecordSize(config.frame_size_max) <= config.capacity_bytes / 2), false,
+        "Frame size max(%d) must be less than half of the capacity(%d)", static_cast<int>(config.frame_size_max),
+        static_cast<int>(config.capacity_bytes)
+    );
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        (config.max_latency_ms == 0) || (config.max_latency_ms >= config.target_latency_ms), false,
+        "Max latency must not be less than the target latency"
+    );
+    ESP_UTILS_CHECK_FALSE_RETURN(config.capacity_bytes <= (UINT32_MAX >> 1) + 1, false, "Capacity is too large");
+
+    uint32_t capacity = 4;
+    while (capacity < config.capacity_bytes) {
+        capacity <<= 1;
+    }
+
+    std::unique_ptr<uint8_t[]> buffer(new (std::nothrow) uint8_t[capacity]);
+    ESP_UTILS_CHECK_NULL_RETURN(buffer, false, "Allocate buffer(%d) failed", static_cast<int>(capacity));
+    std::unique_ptr<uint8_t[]> last_frame;
+    if (config.conceal_frame_num_max > 0) {
+        last_frame.reset(new (std::nothrow) uint8_t[config.frame_size_max]);
+        ESP_UTILS_CHECK_NULL_RETURN(last_frame, false, "Allocate last frame failed");
+    }
+
+    _config = config;
+    _buffer = std::move(buffer);
+    _last_frame = std::move(last_frame);
+    _last_frame_size = 0;
+    _last_frame_duration_us = 0;
+    _capacity = capacity;
+    _write_pos = 0;
+    _read_pos = 0;
+    _frame_num = 0;
+    _level_us = 0;
+    _is_flush_requested = false;
+    _is_stream_ended = false;
+    _is_prebuffering = true;
+    _conceal_num = 0;
+    resetStats();
+
+    return true;
+}
+
+void AudioJitterRing::del()
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    _buffer.reset();
+    _last_frame.reset();
+    _last_frame_size = 0;
+    _capacity = 0;
+    _write_pos = 0;
+    _read_pos = 0;
+    _frame_num = 0;
+    _level_us = 0;
+}
+
+bool AudioJitterRing::push(const void *data, size_t size, uint32_t duration_us)
+{
+    if (!checkInitialized() || (data == nullptr) || (size == 0) || (size > _config.frame_size_max)) {
+        return false;
+    }
+    if (duration_us == 0) {
+        duration_us = static_cast<uint32_t>(_config.frame_duration_ms) * 1000;
+    }
+
+    uint32_t record_size = getRecordSize(size);
+    uint32_t write_pos = _write_pos.load(std::memory_order_relaxed);
+    uint32_t read_pos = _read_pos.load(std::memory_order_acquire);
+    uint32_t free_size = _capacity - (write_pos - read_pos);
+    uint32_t offset = write_pos & (_capacity - 1);
+    uint32_t contiguous_size = _capacity - offset;
+
+    // A record is never split, the tail of the buffer is skipped with a marker instead
+    uint32_t skip_size = (contiguous_size < record_size) ? contiguous_size : 0;
+    if (free_size < skip_size + record_size) {
+        _overflow_drop_count.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (skip_size > 0) {
+        std::memcpy(&_buffer[offset], &RECORD_WRAP_MARKER, sizeof(RECORD_WRAP_MARKER));
+        write_pos += skip_size;
+        offset = 0;
+    }
+
+    uint32_t header[2] = {static_cast<uint32_t>(size), duration_us};
+    std::memcpy(&_buffer[offset], header, RECORD_HEADER_SIZE);
+    std::memcpy(&_buffer[offset + RECORD_HEADER_SIZE], data, size);
+    // Count the frame before publishing it, so the consumer never sees more records than frames
+    _frame_num.fetch_add(1, std::memory_order_relaxed);
+    _level_us.fetch_add(duration_us, std::memory_order_relaxed);
+    _write_pos.store(write_pos + record_size, std::memory_order_release);
+    _push_count.fetch_add(1, std::memory_order_relaxed);
+
+    return true;
+}
+
+void AudioJitterRing::endStream()
+{
+    _is_stream_ended = true;
+}
+
+void AudioJitterRing::requestFlush()
+{
+    _is_flush_requested = true;
+}
+
+AudioJitterRing::PopResult AudioJitterRing::pop(
+    uint8_t *buffer, size_t buffer_size, size_t &size, uint32_t *duration_us
+)
+{
+    if (!checkInitialized()) {
+        return PopResult::Waiting;
+    }
+
+    if (_is_flush_requested.exchange(false)) {
+        dropRecords(getFrameNum());
+        _is_stream_ended = false;
+        _is_prebuffering = true;
+        _conceal_num = 0;
+        _last_frame_size = 0;
+    }
+
+    bool is_stream_ended = _is_stream_ended.load();
+    size_t frame_num = getFrameNum();
+    uint32_t level_us = _level_us.load(std::memory_order_acquire);
+    uint32_t level_ms = level_us / 1000;
+    if (level_ms > _level_max_ms.load(std::memory_order_relaxed)) {
+        _level_max_ms.store(level_ms, std::memory_order_relaxed);
+    }
+
+    if (_is_prebuffering) {
+        if ((level_us < static_cast<uint32_t>(_config.target_latency_ms) * 1000) && !is_stream_ended) {
+            return PopResult::Waiting;
+        }
+        if (frame_num == 0) {
+            _is_stream_ended = false;
+            return PopResult::Waiting;
+        }
+        _is_prebuffering = false;
+    }
+
+    if ((_config.max_latency_ms > 0) && (level_us > static_cast<uint32_t>(_config.max_latency_ms) * 1000)) {
+        size_t trim_num = dropRecordsToLevel(static_cast<uint32_t>(_config.target_latency_ms) * 1000);
+        ESP_UTILS_LOGD("Trim %d frames, level(%dms)", static_cast<int>(trim_num), static_cast<int>(level_ms));
+        _trim_count.fetch_add(static_cast<uint32_t>(trim_num), std::memory_order_relaxed);
+    }
+
+    // Keep a copy of the frame only when it may be needed for concealment
+    bool is_popped = false;
+    uint32_t frame_duration_us = 0;
+    if (_last_frame != nullptr) {
+        is_popped = popRecord(_last_frame.get(), _config.frame_size_max, _last_frame_size, frame_duration_us);
+        if (is_popped) {
+            _last_frame_duration_us = frame_duration_us;
+            size = std::min(_last_frame_size, buffer_size);
+            std::memcpy(buffer, _last_frame.get(), size);
+        }
+    } else {
+        is_popped = popRecord(buffer, buffer_size, size, frame_duration_us);
+    }
+    if (is_popped) {
+        if (duration_us != nullptr) {
+            *duration_us = frame_duration_us;
+        }
+        _conceal_num = 0;
+        _pop_count.fetch_add(1, std::memory_order_relaxed);
+        return PopResult::Frame;
+    }
+
+    // The ring ran dry
+    if (is_stream_ended) {
+        _is_stream_ended = false;
+        _is_prebuffering = true;
+        _conceal_num = 0;
+        _last_frame_size = 0;
+        return PopResult::Waiting;
+    }
+    if (_conceal_num == 0) {
+        _underrun_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    if ((_conceal_num < _config.conceal_frame_num_max) && (_last_frame_size > 0)) {
+        _conceal_num++;
+        size = std::min(_last_frame_size, buffer_size);
+        std::memcpy(buffer, _last_frame.get(), size);
+        if (duration_us != nullptr) {
+            *duration_us = _last_frame_duration_us;
+        }
+        _conceal_count.fetch_add(1, std::memory_order_relaxed);
+        return PopResult::Concealed;
+    }
+
+    ESP_UTILS_LOGD("Underrun, rebuffer");
+    _is_prebuffering = true;
+    _conceal_num = 0;
+    _last_frame_size = 0;
+    _rebuffer_count.fetch_add(1, std::memory_order_relaxed);
+
+    return PopResult::Waiting;
+}
+
+AudioJitterRing::Stats AudioJitterRing::getStats() const
+{
+    return Stats{
+        .push_count = _push_count.load(),
+        .overflow_drop_count = _overflow_drop_count.load(),
+        .pop_count = _pop_count.load(),
+        .underrun_count = _underrun_count.load(),
+        .conceal_count = _conceal_count.load(),
+        .trim_count = _trim_count.load(),
+        .rebuffer_count = _rebuffer_count.load(),
+        .level_ms = getLevelMs(),
+        .level_max_ms = _level_max_ms.load(),
+    };
+}
+
+void AudioJitterRing::resetStats()
+{
+    _push_count = 0;
+    _overflow_drop_count = 0;
+    _pop_count = 0;
+    _underrun_count = 0;
+    _conceal_count = 0;
+    _trim_count = 0;
+    _rebuffer_count = 0;
+    _level_max_ms = 0;
+}
+
+void AudioJitterRing::dumpStats(const char *name) const
+{
+    auto stats = getStats();
+
+    ESP_UTILS_LOGI(
+        "%s ring: push(%u), overflow drop(%u), pop(%u), underrun(%u), conceal(%u), trim(%u), rebuffer(%u), "
+        "level(%ums), level max(%ums)", (name != nullptr) ? name : "Audio",
+        static_cast<unsigned>(stats.push_count), static_cast<unsigned>(stats.overflow_drop_count),
+        static_cast<unsigned>(stats.pop_count), static_cast<unsigned>(stats.underrun_count),
+        static_cast<unsigned>(stats.conceal_count), static_cast<unsigned>(stats.trim_count),
+        static_cast<unsigned>(stats.rebuffer_count), static_cast<unsigned>(stats.level_ms),
+        static_cast<unsigned>(stats.level_max_ms)
+    );
+}
+
+uint32_t AudioJitterRing::getOpusPacketDurationUs(const void *data, size_t size)
+{
+    if ((data == nullptr) || (size == 0)) {
+        return 0;
+    }
+
+    auto packet = static_cast<const uint8_t *>(data);
+    uint8_t config = packet[0] >> 3;
+    uint32_t frame_duration_us = 0;
+    if (config < 12) {
+        // SILK: 10, 20, 40 or 60 ms
+        static constexpr uint32_t SILK_FRAME_DURATIONS_US[] = {10000, 20000, 40000, 60000};
+        frame_duration_us = SILK_FRAME_DURATIONS_US[config & 0x3];
+    } else if (config < 16) {
+        // Hybrid: 10 or 20 ms
+        frame_duration_us = (config & 0x1) ? 20000 : 10000;
+    } else {
+        // CELT: 2.5, 5, 10 or 20 ms
+        frame_duration_us = 2500 << (config & 0x3);
+    }
+
+    uint32_t frame_num = 0;
+    switch (packet[0] & 0x3) {
+    case 0:
+        frame_num = 1;
+        break;
+    case 1:
+    case 2:
+        frame_num = 2;
+        break;
+    default:
+        if (size < 2) {
+            return 0;
+        }
+        frame_num = packet[1] & 0x3F;
+        break;
+    }
+
+    // A packet holds at most 120 ms of audio
+    uint32_t duration_us = frame_num * frame_duration_us;
+    if ((duration_us == 0) || (duration_us > 120000)) {
+        return 0;
+    }
+
+    return duration_us;
+}
+
+bool AudioJitterRing::popRecord(uint8_t *buffer, size_t buffer_size, size_t &size, uint32_t &duration_us)
+{
+    uint32_t read_pos = _read_pos.load(std::memory_order_relaxed);
+    uint32_t write_pos = _write_pos.load(std::memory_order_acquire);
+    if (read_pos == write_pos) {
+        return false;
+    }
+
+    uint32_t offset = read_pos & (_capacity - 1);
+    uint32_t header[2] = {};
+    std::memcpy(&header[0], &_buffer[offset], sizeof(header[0]));
+    if (header[0] == RECORD_WRAP_MARKER) {
+        read_pos += _capacity - offset;
+        offset = 0;
+    }
+    std::memcpy(header, &_buffer[offset], RECORD_HEADER_SIZE);
+
+    if (buffer != nullptr) {
+        size = std::min(static_cast<size_t>(header[0]), buffer_size);
+        std::memcpy(buffer, &_buffer[offset + RECORD_HEADER_SIZE], size);
+    }
+    duration_us = header[1];
+    _read_pos.store(read_pos + getRecordSize(header[0]), std::memory_order_release);
+    _frame_num.fetch_sub(1, std::memory_order_acq_rel);
+    _level_us.fetch_sub(duration_us, std::memory_order_acq_rel);
+
+    return true;
+}
+
+size_t AudioJitterRing::dropRecords(size_t num)
+{
+    size_t size = 0;
+    uint32_t duration_us = 0;
+    size_t dropped_num = 0;
+    while ((dropped_num < num) && popRecord(nullptr, 0, size, duration_us)) {
+        dropped_num++;
+    }
+
+    return dropped_num;
+}
+
+size_t AudioJitterRing::dropRecordsToLevel(uint32_t level_us)
+{
+    size_t size = 0;
+    uint32_t duration_us = 0;
+    size_t dropped_num = 0;
+    while ((_level_us.load(std::memory_order_acquire) > level_us) && popRecord(nullptr, 0, size, duration_us)) {
+        dropped_num++;
+    }
+
+    return dropped_num;
+}
+
+} // namespace esp_brookesia::ai_framework
@@ -0,0 +1,175 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace esp_brookesia::ai_framework {
+
+/**
+ * @brief A lock-free single-producer single-consumer ring of audio frames with jitter control.
+ *
+ * Frames are stored whole (length-prefixed) with their duration, so encoded packets are never split and may have
+ * different lengths. The producer (e.g. the network callback) never blocks: a frame which does not fit is dropped. The
+ * consumer is expected to pop the next frame once the previous one is played, after its duration, and handles the
+ * latency, the sum of the durations of the frames in the ring:
+ *  - Prebuffer: nothing is returned until the fill level reaches the target latency
+ *  - Underrun: the last frame is repeated for a few frames, then the ring goes back to prebuffering
+ *  - Overflow: when the fill level exceeds the maximum latency, the oldest frames are dropped down to the target
+ *
+ * It does not depend on ESP-IDF and can be driven by simulated streams.
+ */
+class AudioJitterRing {
+public:
+    struct Config {
+        size_t capacity_bytes;          // Rounded up to a power of two
+        size_t frame_size_max;          // Larger frames are rejected
+        uint16_t frame_duration_ms;     // Duration of a frame pushed without its own duration
+        uint16_t target_latency_ms;     // Prebuffered before popping, and kept after trimming. 0 means no prebuffer
+        uint16_t max_latency_ms;        // Above this the oldest frames are dropped. 0 means no trimming
+        uint8_t conceal_frame_num_max;  // Number of consecutive missing frames replaced by the last frame
+    };
+
+    enum class PopResult {
+        Frame,          // A frame from the stream
+        Concealed,      // The stream ran dry, the last frame is returned again
+        Waiting,        // Prebuffering or empty, nothing is returned
+    };
+
+    struct Stats {
+        uint32_t push_count;
+        uint32_t overflow_drop_count;   // Frames dropped by the producer because the ring was full
+        uint32_t pop_count;
+        uint32_t underrun_count;        // Times the ring ran dry while playing
+        uint32_t conceal_count;         // Frames replaced by concealment
+        uint32_t trim_count;            // Frames dropped by the consumer because the latency was too high
+        uint32_t rebuffer_count;        // Times the ring went back to prebuffering after an underrun
+        uint32_t level_ms;
+        uint32_t level_max_ms;
+    };
+
+    AudioJitterRing() = default;
+    ~AudioJitterRing() = default;
+
+    AudioJitterRing(const AudioJitterRing &) = delete;
+    AudioJitterRing &operator=(const AudioJitterRing &) = delete;
+
+    bool begin(const Config &config);
+    void del();
+
+    /**
+     * @brief Push a frame, only called from the producer thread. Never blocks.
+     *
+     * @param[in] data         Frame
+     * @param[in] size         Size of the frame
+     * @param[in] duration_us  Duration of the frame, 0 for `frame_duration_ms`
+     *
+     * @return true if success, false if the frame is invalid or the ring is full (the frame is dropped)
+     */
+    bool push(const void *data, size_t size, uint32_t duration_us = 0);
+
+    /**
+     * @brief Mark the end of the current stream, can be called from any thread. The remaining frames are popped
+     *        without waiting for the prebuffer and without concealment, then the ring goes back to prebuffering.
+     */
+    void endStream();
+
+    /**
+     * @brief Drop all the frames, can be called from any thread. The frames are dropped by the next `pop()`.
+     */
+    void requestFlush();
+
+    /**
+     * @brief Pop a frame, only called from the consumer thread
+     *
+     * @param[out] buffer       Buffer of at least `frame_size_max` bytes
+     * @param[in]  buffer_size  Size of the buffer
+     * @param[out] size         Size of the returned frame
+     * @param[out] duration_us  Duration of the returned frame, to wait before the next pop. Can be `nullptr`
+     *
+     * @return The result, `buffer` and `duration_us` are only written for `Frame` and `Concealed`
+     */
+    PopResult pop(uint8_t *buffer, size_t buffer_size, size_t &size, uint32_t *duration_us = nullptr);
+
+    /**
+     * @brief Get the duration of an Opus packet from its TOC byte (RFC 6716, section 3.1), e.g. for `push()`
+     *
+     * @return The duration of all the frames of the packet, or 0 if it is not a valid Opus packet
+     */
+    static uint32_t getOpusPacketDurationUs(const void *data, size_t size);
+
+    Stats getStats() const;
+    void resetStats();
+    void dumpStats(const char *name) const;
+
+    size_t getFrameNum() const
+    {
+        return _frame_num.load(std::memory_order_acquire);
+    }
+    uint32_t getLevelMs() const
+    {
+        return _level_us.load(std::memory_order_acquire) / 1000;
+    }
+    bool isPrebuffering() const
+    {
+        return _is_prebuffering;
+    }
+    bool checkInitialized() const
+    {
+        return (_buffer != nullptr);
+    }
+    const Config &getConfig() const
+    {
+        return _config;
+    }
+
+private:
+    // The size of the frame, then its duration in microseconds
+    static constexpr uint32_t RECORD_HEADER_SIZE = 2 * sizeof(uint32_t);
+    static constexpr uint32_t RECORD_WRAP_MARKER = UINT32_MAX;
+
+    static uint32_t getRecordSize(size_t size)
+    {
+        return (RECORD_HEADER_SIZE + static_cast<uint32_t>(size) + 3) & ~static_cast<uint32_t>(3);
+    }
+
+    bool popRecord(uint8_t *buffer, size_t buffer_size, size_t &size, uint32_t &duration_us);
+    size_t dropRecords(size_t num);
+    size_t dropRecordsToLevel(uint32_t level_us);
+
+    Config _config = {};
+    std::unique_ptr<uint8_t[]> _buffer;
+    uint32_t _capacity = 0;
+    // Free-running byte positions, the capacity is a power of two so the difference stays valid across the wrap
+    std::atomic<uint32_t> _write_pos = 0;
+    std::atomic<uint32_t> _read_pos = 0;
+    std::atomic<size_t> _frame_num = 0;
+    std::atomic<uint32_t> _level_us = 0;
+    std::atomic<bool> _is_flush_requested = false;
+    std::atomic<bool> _is_stream_ended = false;
+
+    // Only accessed by the consumer
+    bool _is_prebuffering = true;
+    uint8_t _conceal_num = 0;
+    std::unique_ptr<uint8_t[]> _last_frame;
+    size_t _last_frame_size = 0;
+    uint32_t _last_frame_duration_us = 0;
+
+    // Written by one side each, read by anyone
+    std::atomic<uint32_t> _push_count = 0;
+    std::atomic<uint32_t> _overflow_drop_count = 0;
+    std::atomic<uint32_t> _pop_count = 0;
+    std::atomic<uint32_t> _underrun_count = 0;
+    std::atomic<uint32_t> _conceal_count = 0;
+    std::atomic<uint32_t> _trim_count = 0;
+    std::atomic<uint32_t> _rebuffer_count = 0;
+    std::atomic<uint32_t> _level_max_ms = 0;
+};
+
+} // namespace esp_brookesia::ai_framework
@@ -18,7 +18,6 @@
 #include "esp_gmf_ringbuffer.h"
 #include "esp_gmf_pool.h"
 #include "esp_gmf_rate_cvt.h"
-#include "esp_g711_enc.h"
 #include "esp_gmf_audio_helper.h"
 #include "esp_audio_simple_player.h"
 #include "esp_audio_simple_player_advance.h"
@@ -57,8 +56,14 @@
 static char *TAG = "AUDIO_PROCESSOR";
 
 typedef struct {
-    esp_asp_handle_t          player;
+    esp_asp_handle_t          player;         // Reads the URL, for `file://` and `http://` prompts
+    esp_asp_handle_t          memory_player;  // Reads `memory_data` through its input callback
+    esp_asp_handle_t          running_player;
     enum audio_player_state_e state;
+    const uint8_t            *memory_data;
+    size_t                    memory_size;
+    size_t                    memory_offset;
+    size_t                    output_size;
 } audio_prompt_t;
 
 typedef struct {
@@ -131,8 +136,23 @@ esp_err_t audio_manager_suspend(bool suspend)
     return esp_gmf_afe_manager_suspend(audio_recorder.afe_manager, suspend);
 }
 
+static int prompt_in_data_callback(uint8_t *data, int data_size, void *ctx)
+{
+    // Only used by the prompts played from memory, returning 0 ends the prompt
+    int read_size = (int)(audio_prompt.memory_size - audio_prompt.memory_offset);
+    if (read_size > data_size) {
+        read_size = data_size;
+    }
+    if (read_size > 0) {
+        memcpy(data, audio_prompt.memory_data + audio_prompt.memory_offset, read_size);
+        audio_prompt.memory_offset += read_size;
+    }
+    return read_size;
+}
+
 static int prompt_out_data_callback(uint8_t *data, int data_size, void *ctx)
 {
+    audio_prompt.output_size += data_size;
     esp_codec_dev_write(audio_manager.play_dev, data, data_size);
     return 0;
 }
@@ -289,7 +309,8 @@ esp_err_t audio_recorder_open(recorder_event_callback_t cb, void *ctx)
     gmf_afe_cfg.wakeup_end = AFE_WAKEUP_END_MS;
     esp_gmf_afe_init(&gmf_afe_cfg, &gmf_afe);
     esp_gmf_pool_register_element(audio_manager.pool, gmf_afe, NULL);
-    const char *name[] = {"ai_afe", "rate_cvt", "encoder"};
+    // The recorder outputs PCM, the agent encodes it with the codec of the robot
+    const char *name[] = {"ai_afe", "rate_cvt"};
     esp_gmf_pool_new_pipeline(audio_manager.pool, NULL, name, sizeof(name) / sizeof(char *), NULL, &audio_recorder.pipe);
     if (audio_recorder.pipe == NULL) {
         ESP_LOGE(TAG, "There is no pipeline");
@@ -303,7 +324,7 @@ esp_err_t audio_recorder_open(recorder_event_callback_t cb, void *ctx)
                                         &outport,
                                         0,
                                         100);
-    esp_gmf_pipeline_reg_el_port(audio_recorder.pipe, "encoder", ESP_GMF_IO_DIR_WRITER, outport);
+    esp_gmf_pipeline_reg_el_port(audio_recorder.pipe, "rate_cvt", ESP_GMF_IO_DIR_WRITER, outport);
 
     esp_gmf_port_handle_t import = NEW_ESP_GMF_PORT_IN_BYTE(recorder_inport_acquire_read,
                                    recorder_inport_release_read,
@@ -317,15 +338,6 @@ esp_err_t audio_recorder_open(recorder_event_callback_t cb, void *ctx)
     esp_gmf_pipeline_get_el_by_name(audio_recorder.pipe, "rate_cvt", &rate_cvt);
     esp_gmf_rate_cvt_set_dest_rate(rate_cvt, 8000);
 
-    esp_gmf_element_handle_t enc_handle = NULL;
-    esp_gmf_pipeline_get_el_by_name(audio_recorder.pipe, "encoder", &enc_handle);
-
-    esp_gmf_info_sound_t info = { 0 };
-    info.sample_rates = 8000;
-    info.channels = 1;
-    info.bits = 16;
-    esp_gmf_audio_helper_reconfig_enc_by_type(ESP_AUDIO_TYPE_G711A, &info, (esp_audio_enc_config_t *)OBJ_GET_CFG(enc_handle));
-
     esp_gmf_task_cfg_t cfg = DEFAULT_ESP_GMF_TASK_CONFIG();
     cfg.ctx = NULL;
     cfg.cb = NULL;
@@ -369,21 +381,18 @@ esp_err_t audio_recorder_close(void)
 
 esp_err_t audio_recorder_read_data(uint8_t *data, int data_size)
 {
-    // TODO: will support opus data
 #if CONFIG_KEY_PRESS_DIALOG_MODE
     esp_codec_dev_read(audio_manager.rec_dev, data, data_size);
     return data_size;
 #else
+    // The ring buffer copies into the given buffer, so nothing is allocated per read
     esp_gmf_data_bus_block_t blk;
-    blk.buf = malloc(data_size);
+    blk.buf = data;
     blk.buf_length = data_size;
     blk.valid_size = 0;
     blk.is_last = false;
     esp_gmf_rb_acquire_read(out_rb, &blk, data_size, portMAX_DELAY);
-    memcpy(data, blk.buf, blk.valid_size);
-
     esp_gmf_rb_release_read(out_rb, &blk, portMAX_DELAY);
-    free(blk.buf);
     return blk.valid_size;
 #endif  /* CONFIG_KEY_PRESS_DIALOG_MODE */
 }
@@ -550,6 +559,8 @@ esp_err_t audio_playback_stop(void)
 
 esp_err_t audio_prompt_open(void)
 {
+    // A player with an input callback reads all its URLs through it, so the prompts from memory have their own player
+    // and the URLs of the other one are opened by their scheme
     esp_asp_cfg_t cfg = {
         .in.cb = NULL,
         .in.user_ctx = NULL,
@@ -558,17 +569,38 @@ esp_err_t audio_prompt_open(void)
         .task_prio = 5,
     };
     esp_gmf_err_t err = esp_audio_simple_player_new(&cfg, &audio_prompt.player);
+    if (err != ESP_GMF_ERR_OK) {
+        ESP_LOGE(TAG, "Create prompt player failed (0x%x)", err);
+        return ESP_FAIL;
+    }
     err = esp_audio_simple_player_set_event(audio_prompt.player, prompt_event_callback, NULL);
+
+    cfg.in.cb = prompt_in_data_callback;
+    if (esp_audio_simple_player_new(&cfg, &audio_prompt.memory_player) != ESP_GMF_ERR_OK) {
+        ESP_LOGE(TAG, "Create prompt memory player failed");
+        esp_audio_simple_player_destroy(audio_prompt.player);
+        audio_prompt.player = NULL;
+        return ESP_FAIL;
+    }
+    esp_audio_simple_player_set_event(audio_prompt.memory_player, prompt_event_callback, NULL);
+    audio_prompt.running_player = NULL;
+    audio_prompt.output_size = 0;
     audio_prompt.state = AUDIO_PLAYER_STATE_IDLE;
     return err;
 }
 
 esp_err_t audio_prompt_close(void)
 {
-    if (audio_prompt.state == AUDIO_PLAYER_STATE_PLAYING) {
-        esp_audio_simple_player_stop(audio_prompt.player);
+    if ((audio_prompt.state == AUDIO_PLAYER_STATE_PLAYING) && (audio_prompt.running_player != NULL)) {
+        esp_audio_simple_player_stop(audio_prompt.running_player);
     }
+    audio_prompt.running_player = NULL;
     esp_err_t err = esp_audio_simple_player_destroy(audio_prompt.player);
+    if (esp_audio_simple_player_destroy(audio_prompt.memory_player) != ESP_OK) {
+        err = ESP_FAIL;
+    }
+    audio_prompt.player = NULL;
+    audio_prompt.memory_player = NULL;
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Audio prompt closing failed");
         return ESP_FAIL;
@@ -583,6 +615,7 @@ esp_err_t audio_prompt_play(const char *url)
         ESP_LOGE(TAG, "audio_prompt is already playing");
         return ESP_OK;
     }
+    audio_prompt.running_player = audio_prompt.player;
     esp_audio_simple_player_run(audio_prompt.player, url, NULL);
     audio_prompt.state = AUDIO_PLAYER_STATE_PLAYING;
     return ESP_OK;
@@ -594,7 +627,9 @@ esp_err_t audio_prompt_stop(void)
         ESP_LOGW(TAG, "audio_prompt_stop, but state is idle");
         return ESP_FAIL;
     }
-    esp_audio_simple_player_stop(audio_prompt.player);
+    if (audio_prompt.running_player != NULL) {
+        esp_audio_simple_player_stop(audio_prompt.running_player);
+    }
     audio_prompt.state = AUDIO_PLAYER_STATE_IDLE;
     return ESP_OK;
 }
@@ -621,6 +656,39 @@ esp_err_t audio_prompt_play_with_block(const char *url, int timeout_ms)
     return audio_prompt_play(url);
 }
 
+esp_err_t audio_prompt_play_from_memory(const char *url, const uint8_t *data, size_t size)
+{
+    if ((url == NULL) || (data == NULL)) {
+        ESP_LOGE(TAG, "Invalid prompt url or data");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (audio_prompt.state == AUDIO_PLAYER_STATE_PLAYING) {
+        ESP_LOGE(TAG, "audio_prompt is already playing");
+        return ESP_OK;
+    }
+    audio_prompt.memory_data = data;
+    audio_prompt.memory_size = size;
+    audio_prompt.memory_offset = 0;
+    audio_prompt.running_player = audio_prompt.memory_player;
+    esp_gmf_err_t err = esp_audio_simple_player_run(audio_prompt.memory_player, url, NULL);
+    if (err != ESP_GMF_ERR_OK) {
+        ESP_LOGE(TAG, "Run prompt(%s) from memory failed (0x%x)", url, err);
+        return ESP_FAIL;
+    }
+    audio_prompt.state = AUDIO_PLAYER_STATE_PLAYING;
+    return ESP_OK;
+}
+
+bool audio_prompt_is_playing(void)
+{
+    return audio_prompt.state == AUDIO_PLAYER_STATE_PLAYING;
+}
+
+size_t audio_prompt_get_output_size(void)
+{
+    return audio_prompt.output_size;
+}
+
 esp_gmf_element_handle_t audio_processor_get_afe_handle(void)
 {
     esp_gmf_element_handle_t safe = NULL;
@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "esp_err.h"
 #include "esp_gmf_afe.h"
 #include "esp_gmf_setup_peripheral.h"
@@ -193,6 +196,37 @@ esp_err_t audio_prompt_stop(void);
 
 esp_err_t audio_prompt_play_with_block(const char *url, int timeout_ms);
 
+/**
+ * @brief  Plays an audio prompt which is already in memory
+ *
+ * @param[in]  url   Raw URL of the prompt, such as `raw://spiffs/wake_up.mp3`. Only its extension is used, to select
+ *                   the decoder
+ * @param[in]  data  Encoded prompt data, it must be kept until the prompt is stopped or finished
+ * @param[in]  size  Size of the data
+ *
+ * @return
+ *       - ESP_OK  On success
+ *       - Other   Appropriate esp_err_t error code on failure
+ */
+esp_err_t audio_prompt_play_from_memory(const char *url, const uint8_t *data, size_t size);
+
+/**
+ * @brief  Checks if an audio prompt is playing
+ *
+ * @return
+ *       - true   A prompt is playing
+ *       - false  No prompt is playing
+ */
+bool audio_prompt_is_playing(void);
+
+/**
+ * @brief  Gets the size of the PCM data written to the codec by the prompts since they were opened
+ *
+ * @return
+ *       - Size in bytes
+ */
+size_t audio_prompt_get_output_size(void);
+
 esp_gmf_element_handle_t audio_processor_get_afe_handle(void);
 
 esp_err_t audio_prompt_play_mute(bool enable_mute);
@@ -0,0 +1,422 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include "private/esp_brookesia_ai_agent_utils.hpp"
+#if ESP_BROOKESIA_AGENT_UPLINK_ENABLE_OPUS
+#   include "esp_opus_enc.h"
+#endif
+#include "audio_uplink_encoder.hpp"
+
+namespace esp_brookesia::ai_framework {
+
+namespace {
+
+constexpr size_t IMA_ADPCM_HEADER_SIZE = 4;
+constexpr int IMA_ADPCM_STEP_INDEX_MAX = 88;
+constexpr int16_t IMA_ADPCM_STEPS[IMA_ADPCM_STEP_INDEX_MAX + 1] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107,
+    118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894,
+    6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767
+};
+constexpr int8_t IMA_ADPCM_INDEX_ADJUSTS[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+// An Opus packet is far smaller than the PCM, the encoder refuses a buffer smaller than its own estimate
+constexpr size_t OPUS_PACKET_SIZE_MIN = 1024;
+
+uint8_t encode_ima_adpcm_sample(int16_t sample, int32_t &predictor, int &step_index)
+{
+    int32_t step = IMA_ADPCM_STEPS[step_index];
+    int32_t diff = sample - predictor;
+    uint8_t code = 0;
+    if (diff < 0) {
+        code = 8;
+        diff = -diff;
+    }
+
+    // Same rounding as the decoder, so the predictors of both sides stay equal
+    int32_t delta = step >> 3;
+    if (diff >= step) {
+        code |= 4;
+        diff -= step;
+        delta += step;
+    }
+    step >>= 1;
+    if (diff >= step) {
+        code |= 2;
+        diff -= step;
+        delta += step;
+    }
+    step >>= 1;
+    if (diff >= step) {
+        code |= 1;
+        delta += step;
+    }
+
+    predictor = std::clamp<int32_t>((code & 8) ? predictor - delta : predictor + delta, INT16_MIN, INT16_MAX);
+    step_index = std::clamp(step_index + IMA_ADPCM_INDEX_ADJUSTS[code & 7], 0, IMA_ADPCM_STEP_INDEX_MAX);
+
+    return code;
+}
+
+} // namespace
+
+AudioUplinkEncoder::~AudioUplinkEncoder()
+{
+    closeOpus();
+}
+
+bool AudioUplinkEncoder::begin(const Config &config, OutputFunction output)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    ESP_UTILS_LOGD(
+        "Param: sample_rate(%d), frame_sample_num(%d), opus_bitrate(%d), codec(%s)",
+        static_cast<int>(config.sample_rate), static_cast<int>(config.frame_sample_num),
+        static_cast<int>(config.opus_bitrate), getCodecName(config.codec)
+    );
+
+    ESP_UTILS_CHECK_FALSE_RETURN(!checkInitialized(), false, "Already initialized");
+    ESP_UTILS_CHECK_FALSE_RETURN(config.sample_rate > 0, false, "Invalid sample rate");
+    ESP_UTILS_CHECK_FALSE_RETURN(config.frame_sample_num > 0, false, "Invalid frame sample number");
+    ESP_UTILS_CHECK_FALSE_RETURN(output, false, "Invalid output function");
+
+    _config = config;
+    size_t packet_size_max = 0;
+    for (auto codec : {
+                Codec::PCM, Codec::G711A, Codec::IMA_ADPCM, Codec::OPUS
+            }) {
+        packet_size_max = std::max(packet_size_max, checkCodecSupported(codec) ? getPacketSizeMax(codec) : 0);
+    }
+    std::unique_ptr<int16_t[]> frame_buffer(new (std::nothrow) int16_t[config.frame_sample_num]);
+    std::unique_ptr<uint8_t[]> packet_buffer(new (std::nothrow) uint8_t[packet_size_max]);
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        (frame_buffer != nullptr) && (packet_buffer != nullptr), false, "Allocate buffers(%d + %d) failed",
+        static_cast<int>(config.frame_sample_num * sizeof(int16_t)), static_cast<int>(packet_size_max)
+    );
+
+    _output = std::move(output);
+    _frame_buffer = std::move(frame_buffer);
+    _frame_sample_num = 0;
+    _packet_buffer = std::move(packet_buffer);
+    _packet_size_max = packet_size_max;
+    _is_codec_requested = false;
+    resetStats();
+    if (!applyCodec(config.codec)) {
+        ESP_UTILS_LOGE("Apply codec(%s) failed", getCodecName(config.codec));
+        del();
+        return false;
+    }
+
+    return true;
+}
+
+void AudioUplinkEncoder::del()
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    closeOpus();
+    _output = nullptr;
+    _frame_buffer.reset();
+    _frame_sample_num = 0;
+    _packet_buffer.reset();
+    _packet_size_max = 0;
+}
+
+bool AudioUplinkEncoder::encode(const int16_t *samples, size_t sample_num)
+{
+    ESP_UTILS_CHECK_FALSE_RETURN(checkInitialized(), false, "Not initialized");
+    ESP_UTILS_CHECK_FALSE_RETURN((samples != nullptr) || (sample_num == 0), false, "Invalid samples");
+
+    if (_is_codec_requested.exchange(false, std::memory_order_acquire)) {
+        Codec codec = _requested_codec.load(std::memory_order_relaxed);
+        if ((codec != _codec) && !applyCodec(codec)) {
+            ESP_UTILS_LOGE("Apply codec(%s) failed, keep %s", getCodecName(codec), getCodecName(_codec));
+        }
+    }
+    _input_bytes.fetch_add(static_cast<uint32_t>(sample_num * sizeof(int16_t)), std::memory_order_relaxed);
+
+    bool ret = true;
+    while (sample_num > 0) {
+        size_t copy_num = std::min(sample_num, _config.frame_sample_num - _frame_sample_num);
+        std::memcpy(&_frame_buffer[_frame_sample_num], samples, copy_num * sizeof(int16_t));
+        _frame_sample_num += copy_num;
+        samples += copy_num;
+        sample_num -= copy_num;
+        if (_frame_sample_num < _config.frame_sample_num) {
+            break;
+        }
+        _frame_sample_num = 0;
+
+        auto start_time = std::chrono::steady_clock::now();
+        size_t size = encodeFrame();
+        uint32_t encode_time_us = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                      std::chrono::steady_clock::now() - start_time
+                                  ).count());
+        if (size == 0) {
+            ESP_UTILS_LOGD("Encode frame failed");
+            ret = false;
+            continue;
+        }
+        _frame_count.fetch_add(1, std::memory_order_relaxed);
+        _encode_time_sum_us.fetch_add(encode_time_us, std::memory_order_relaxed);
+        if (encode_time_us > _encode_time_max_us.load(std::memory_order_relaxed)) {
+            _encode_time_max_us.store(encode_time_us, std::memory_order_relaxed);
+        }
+        if (!_output(_packet_buffer.get(), size)) {
+            _drop_frame_count.fetch_add(1, std::memory_order_relaxed);
+            ret = false;
+            continue;
+        }
+        _output_bytes.fetch_add(static_cast<uint32_t>(size), std::memory_order_relaxed);
+    }
+
+    return ret;
+}
+
+size_t AudioUplinkEncoder::getPacketSizeMax(Codec codec) const
+{
+    size_t sample_num = _config.frame_sample_num;
+
+    switch (codec) {
+    case Codec::PCM:
+        return sample_num * sizeof(int16_t);
+    case Codec::G711A:
+        return sample_num;
+    case Codec::IMA_ADPCM:
+        return IMA_ADPCM_HEADER_SIZE + sample_num / 2;
+    case Codec::OPUS:
+        return std::max(OPUS_PACKET_SIZE_MIN, static_cast<size_t>(
+                            static_cast<uint64_t>(_config.opus_bitrate) * sample_num / _config.sample_rate / 8 * 2
+                        ));
+    default:
+        return 0;
+    }
+}
+
+AudioUplinkEncoder::Stats AudioUplinkEncoder::getStats() const
+{
+    uint32_t frame_count = _frame_count.load(std::memory_order_relaxed);
+
+    return Stats{
+        .frame_count = frame_count,
+        .drop_frame_count = _drop_frame_count.load(std::memory_order_relaxed),
+        .input_bytes = _input_bytes.load(std::memory_order_relaxed),
+        .output_bytes = _output_bytes.load(std::memory_order_relaxed),
+        .encode_time_avg_us = (frame_count > 0) ? static_cast<uint32_t>(
+            _encode_time_sum_us.load(std::memory_order_relaxed) / frame_count
+        ) : 0,
+        .encode_time_max_us = _encode_time_max_us.load(std::memory_order_relaxed),
+    };
+}
+
+void AudioUplinkEncoder::resetStats()
+{
+    _frame_count = 0;
+    _drop_frame_count = 0;
+    _input_bytes = 0;
+    _output_bytes = 0;
+    _encode_time_sum_us = 0;
+    _encode_time_max_us = 0;
+}
+
+void AudioUplinkEncoder::dumpStats(const char *name) const
+{
+    auto stats = getStats();
+
+    ESP_UTILS_LOGI(
+        "%s encoder(%s): frames(%u), drop(%u), input(%u bytes), output(%u bytes), encode time avg(%u us), max(%u us)",
+        (name != nullptr) ? name : "Audio", getCodecName(getCodec()), static_cast<unsigned>(stats.frame_count),
+        static_cast<unsigned>(stats.drop_frame_count), static_cast<unsigned>(stats.input_bytes),
+        static_cast<unsigned>(stats.output_bytes), static_cast<unsigned>(stats.encode_time_avg_us),
+        static_cast<unsigned>(stats.encode_time_max_us)
+    );
+}
+
+bool AudioUplinkEncoder::checkCodecSupported(Codec codec)
+{
+    switch (codec) {
+    case Codec::PCM:
+    case Codec::G711A:
+    case Codec::IMA_ADPCM:
+        return true;
+    case Codec::OPUS:
+        return ESP_BROOKESIA_AGENT_UPLINK_ENABLE_OPUS;
+    default:
+        return false;
+    }
+}
+
+const char *AudioUplinkEncoder::getCodecName(Codec codec)
+{
+    switch (codec) {
+    case Codec::PCM:
+        return "PCM";
+    case Codec::G711A:
+        return "G711A";
+    case Codec::IMA_ADPCM:
+        return "IMA-ADPCM";
+    case Codec::OPUS:
+        return "Opus";
+    default:
+        return "Unknown";
+    }
+}
+
+bool AudioUplinkEncoder::applyCodec(Codec codec)
+{
+    ESP_UTILS_LOGD("Apply codec(%s)", getCodecName(codec));
+
+    ESP_UTILS_CHECK_FALSE_RETURN(checkCodecSupported(codec), false, "Codec(%s) is not supported", getCodecName(codec));
+
+    closeOpus();
+    if (codec == Codec::OPUS) {
+        ESP_UTILS_CHECK_FALSE_RETURN(openOpus(), false, "Open Opus encoder failed");
+    }
+    _codec = codec;
+    _frame_sample_num = 0;
+    _adpcm_step_index = 0;
+
+    return true;
+}
+
+bool AudioUplinkEncoder::openOpus()
+{
+#if ESP_BROOKESIA_AGENT_UPLINK_ENABLE_OPUS
+    esp_opus_enc_config_t config = ESP_OPUS_ENC_CONFIG_DEFAULT();
+    config.sample_rate = _config.sample_rate;
+    config.channel = ESP_AUDIO_MONO;
+    config.bits_per_sample = ESP_AUDIO_BIT16;
+    config.bitrate = _config.opus_bitrate;
+    config.frame_duration = ESP_OPUS_ENC_FRAME_DURATION_ARG;
+    config.application_mode = ESP_OPUS_ENC_APPLICATION_VOIP;
+    config.enable_vbr = true;
+
+    void *handle = nullptr;
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        esp_opus_enc_open(&config, sizeof(config), &handle) == ESP_AUDIO_ERR_OK, false, "Open failed"
+    );
+    int in_size = 0;
+    int out_size = 0;
+    esp_opus_enc_get_frame_size(handle, &in_size, &out_size);
+    // With `ESP_OPUS_ENC_FRAME_DURATION_ARG`, the frame duration is given by the size of each input
+    if ((in_size > 0) && (static_cast<size_t>(in_size) != _config.frame_sample_num * sizeof(int16_t))) {
+        ESP_UTILS_LOGW("Opus frame of %d bytes instead of %d", in_size,
+                       static_cast<int>(_config.frame_sample_num * sizeof(int16_t)));
+    }
+    _opus_handle = handle;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AudioUplinkEncoder::closeOpus()
+{
+#if ESP_BROOKESIA_AGENT_UPLINK_ENABLE_OPUS
+    if (_opus_handle != nullptr) {
+        esp_opus_enc_close(_opus_handle);
+        _opus_handle = nullptr;
+    }
+#endif
+}
+
+size_t AudioUplinkEncoder::encodeFrame()
+{
+    const int16_t *samples = _frame_buffer.get();
+    size_t sample_num = _config.frame_sample_num;
+    uint8_t *packet = _packet_buffer.get();
+
+    switch (_codec.load(std::memory_order_relaxed)) {
+    case Codec::PCM:
+        std::memcpy(packet, samples, sample_num * sizeof(int16_t));
+        return sample_num * sizeof(int16_t);
+    case Codec::G711A:
+        encodeG711A(samples, sample_num, packet);
+        return sample_num;
+    case Codec::IMA_ADPCM:
+        return encodeImaAdpcm(samples, sample_num, packet, _adpcm_step_index);
+#if ESP_BROOKESIA_AGENT_UPLINK_ENABLE_OPUS
+    case Codec::OPUS: {
+        esp_audio_enc_in_frame_t in_frame = {
+            .buffer = reinterpret_cast<uint8_t *>(const_cast<int16_t *>(samples)),
+            .len = static_cast<uint32_t>(sample_num * sizeof(int16_t)),
+        };
+        esp_audio_enc_out_frame_t out_frame = {
+            .buffer = packet,
+            .len = static_cast<uint32_t>(_packet_size_max),
+        };
+        if (esp_opus_enc_process(_opus_handle, &in_frame, &out_frame) != ESP_AUDIO_ERR_OK) {
+            return 0;
+        }
+        return out_frame.encoded_bytes;
+    }
+#endif
+    default:
+        return 0;
+    }
+}
+
+void encodeG711A(const int16_t *samples, size_t sample_num, uint8_t *data)
+{
+    for (size_t i = 0; i < sample_num; i++) {
+        // 13-bit magnitude, the sign is the opposite of the decoded one
+        int32_t value = samples[i] >> 3;
+        uint8_t mask = 0xD5;
+        if (value < 0) {
+            mask = 0x55;
+            value = -value - 1;
+        }
+        int segment = 0;
+        while ((segment < 8) && (value >= (0x20 << segment))) {
+            segment++;
+        }
+        if (segment == 8) {
+            data[i] = 0x7F ^ mask;
+            continue;
+        }
+        uint8_t code = segment << 4;
+        code |= (segment < 2) ? ((value >> 1) & 0x0F) : ((value >> segment) & 0x0F);
+        data[i] = code ^ mask;
+    }
+}
+
+size_t encodeImaAdpcm(const int16_t *samples, size_t sample_num, uint8_t *data, uint8_t &step_index)
+{
+    if (sample_num == 0) {
+        return 0;
+    }
+
+    // The first sample is the predictor, as in a block of a WAV file
+    int32_t predictor = samples[0];
+    int index = std::min<int>(step_index, IMA_ADPCM_STEP_INDEX_MAX);
+    data[0] = static_cast<uint8_t>(predictor & 0xFF);
+    data[1] = static_cast<uint8_t>((predictor >> 8) & 0xFF);
+    data[2] = static_cast<uint8_t>(index);
+    data[3] = 0;
+
+    // The next samples, two per byte, the low nibble first
+    uint8_t *codes = data + IMA_ADPCM_HEADER_SIZE;
+    size_t code_num = sample_num - 1;
+    for (size_t i = 0; i < code_num; i++) {
+        uint8_t code = encode_ima_adpcm_sample(samples[i + 1], predictor, index);
+        if ((i & 1) == 0) {
+            codes[i / 2] = code;
+        } else {
+            codes[i / 2] |= code << 4;
+        }
+    }
+    step_index = static_cast<uint8_t>(index);
+
+    return IMA_ADPCM_HEADER_SIZE + (code_num + 1) / 2;
+}
+
+} // namespace esp_brookesia::ai_framework
@@ -0,0 +1,148 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace esp_brookesia::ai_framework {
+
+/**
+ * @brief Encode the recorded 16-bit mono PCM into the packets sent to the server
+ *
+ * The PCM is gathered into frames of `frame_sample_num` samples, whatever the size of the recorded chunks, and each
+ * frame is encoded into one packet. The buffers are allocated by `begin()`, so encoding never allocates. The codec can
+ * be changed from any thread with `requestCodec()`, it is applied before the next frame and the partial frame is
+ * dropped.
+ *
+ * The IMA-ADPCM packets start with the first sample and the step index (4 bytes, as a block of a WAV file), so each
+ * packet can be decoded alone even if the previous ones are dropped. Opus needs `esp_audio_codec` and is only built
+ * with `ESP_BROOKESIA_AGENT_UPLINK_ENABLE_OPUS`.
+ *
+ * Without Opus it does not depend on ESP-IDF and can be driven by recorded files.
+ */
+class AudioUplinkEncoder {
+public:
+    enum class Codec {
+        PCM,            // 16-bit little-endian, 2 bytes per sample
+        G711A,          // 1 byte per sample
+        IMA_ADPCM,      // 4 bits per sample, and 4 bytes per packet
+        OPUS,
+    };
+
+    struct Config {
+        uint32_t sample_rate;
+        size_t frame_sample_num;        // Samples per packet. With Opus, 120 ms or a duration supported by Opus
+        uint32_t opus_bitrate;          // Bits per second
+        Codec codec;                    // The first codec
+    };
+
+    /**
+     * @brief Send a packet, return false if it is dropped
+     */
+    using OutputFunction = std::function<bool(const uint8_t *data, size_t size)>;
+
+    struct Stats {
+        uint32_t frame_count;           // Packets encoded
+        uint32_t drop_frame_count;      // Packets refused by the output function
+        uint32_t input_bytes;
+        uint32_t output_bytes;
+        uint32_t encode_time_avg_us;    // Per packet
+        uint32_t encode_time_max_us;
+    };
+
+    AudioUplinkEncoder() = default;
+    ~AudioUplinkEncoder();
+
+    AudioUplinkEncoder(const AudioUplinkEncoder &) = delete;
+    AudioUplinkEncoder &operator=(const AudioUplinkEncoder &) = delete;
+
+    bool begin(const Config &config, OutputFunction output);
+    void del();
+
+    /**
+     * @brief Change the codec before the next frame, can be called from any thread
+     */
+    void requestCodec(Codec codec)
+    {
+        _requested_codec.store(codec, std::memory_order_relaxed);
+        _is_codec_requested.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief Encode PCM of any size, only called from the recorder thread. The frames completed are sent.
+     *
+     * @return false if a packet failed to be encoded or was dropped
+     */
+    bool encode(const int16_t *samples, size_t sample_num);
+
+    Codec getCodec() const
+    {
+        return _codec.load(std::memory_order_relaxed);
+    }
+    bool checkInitialized() const
+    {
+        return (_frame_buffer != nullptr);
+    }
+
+    /**
+     * @brief Get the maximum size of a packet of a codec
+     */
+    size_t getPacketSizeMax(Codec codec) const;
+
+    Stats getStats() const;
+    void resetStats();
+    void dumpStats(const char *name) const;
+
+    static bool checkCodecSupported(Codec codec);
+    static const char *getCodecName(Codec codec);
+
+private:
+    bool applyCodec(Codec codec);
+    bool openOpus();
+    void closeOpus();
+    size_t encodeFrame();
+
+    Config _config = {};
+    OutputFunction _output;
+    std::atomic<Codec> _codec = Codec::PCM;
+    std::atomic<Codec> _requested_codec = Codec::PCM;
+    std::atomic<bool> _is_codec_requested = false;
+
+    // The frame being gathered, and its packet
+    std::unique_ptr<int16_t[]> _frame_buffer;
+    size_t _frame_sample_num = 0;
+    std::unique_ptr<uint8_t[]> _packet_buffer;
+    size_t _packet_size_max = 0;
+
+    uint8_t _adpcm_step_index = 0;
+    void *_opus_handle = nullptr;
+
+    // Written by the recorder thread, read by anyone
+    std::atomic<uint32_t> _frame_count = 0;
+    std::atomic<uint32_t> _drop_frame_count = 0;
+    std::atomic<uint32_t> _input_bytes = 0;
+    std::atomic<uint32_t> _output_bytes = 0;
+    std::atomic<uint64_t> _encode_time_sum_us = 0;
+    std::atomic<uint32_t> _encode_time_max_us = 0;
+};
+
+/**
+ * @brief Encode PCM into G.711 A-law
+ */
+void encodeG711A(const int16_t *samples, size_t sample_num, uint8_t *data);
+
+/**
+ * @brief Encode PCM into one IMA-ADPCM packet of `4 + sample_num / 2` bytes
+ *
+ * @param step_index  The step index at the end of the previous packet, updated for the next one
+ */
+size_t encodeImaAdpcm(const int16_t *samples, size_t sample_num, uint8_t *data, uint8_t &step_index);
+
+} // namespace esp_brookesia::ai_framework
@@ -0,0 +1,343 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include "private/esp_brookesia_ai_agent_utils.hpp"
+#include "audio_voice_gate.hpp"
+
+namespace esp_brookesia::ai_framework {
+
+namespace {
+
+constexpr uint32_t VAD_BLOCK_DURATION_MS = 10;
+// About -60 dBFS, a digital silence does not make the faintest noise loud
+constexpr float VAD_NOISE_FLOOR_MIN_DB = 30;
+// The noise floor follows a quiet block in about 50 ms, a loud one in about 20 s
+constexpr float VAD_NOISE_FLOOR_FALL_RATE = 0.2f;
+constexpr float VAD_NOISE_FLOOR_QUIET_RISE_RATE = 0.02f;
+constexpr float VAD_NOISE_FLOOR_LOUD_RISE_RATE = 0.0005f;
+// Energy of the first difference over the energy. About 2 for white noise, below 1 for a voice at 8 kHz.
+constexpr float VAD_NOISY_DIFF_RATIO = 1.2f;
+
+} // namespace
+
+bool VoiceActivityDetector::begin(const Config &config)
+{
+    ESP_UTILS_LOGD(
+        "Param: sample_rate(%d), threshold_db(%d), speech_min_ms(%d), hangover_ms(%d)",
+        static_cast<int>(config.sample_rate), config.threshold_db, config.speech_min_ms, config.hangover_ms
+    );
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        config.sample_rate >= 1000 / VAD_BLOCK_DURATION_MS, false, "Invalid sample rate(%d)",
+        static_cast<int>(config.sample_rate)
+    );
+
+    _config = config;
+    _block_sample_num = config.sample_rate * VAD_BLOCK_DURATION_MS / 1000;
+    _block_duration_ms = VAD_BLOCK_DURATION_MS;
+    reset();
+
+    return true;
+}
+
+void VoiceActivityDetector::reset()
+{
+    _energy_sum = 0;
+    _diff_energy_sum = 0;
+    _sample_num = 0;
+    _last_sample = 0;
+    _has_noise_floor = false;
+    _noise_floor_db = 0;
+    _loud_ms = 0;
+    _quiet_ms = 0;
+    _is_speech = false;
+}
+
+bool VoiceActivityDetector::process(const int16_t *samples, size_t sample_num)
+{
+    if ((samples == nullptr) || (_block_sample_num == 0)) {
+        return _is_speech;
+    }
+
+    for (size_t i = 0; i < sample_num; i++) {
+        int32_t sample = samples[i];
+        int32_t diff = sample - _last_sample;
+        _energy_sum += static_cast<uint64_t>(sample * sample);
+        _diff_energy_sum += static_cast<uint64_t>(static_cast<int64_t>(diff) * diff);
+        _last_sample = static_cast<int16_t>(sample);
+        if (++_sample_num == _block_sample_num) {
+            processBlock();
+        }
+    }
+
+    return _is_speech;
+}
+
+void VoiceActivityDetector::processBlock()
+{
+    float energy = static_cast<float>(_energy_sum) / _sample_num;
+    float level_db = 10 * log10f(energy + 1);
+    float diff_ratio = (energy > 0) ? static_cast<float>(_diff_energy_sum) / _sample_num / energy : 0;
+    _energy_sum = 0;
+    _diff_energy_sum = 0;
+    _sample_num = 0;
+
+    if (!_has_noise_floor) {
+        _noise_floor_db = level_db;
+        _has_noise_floor = true;
+    }
+    float threshold_db = _config.threshold_db * ((diff_ratio > VAD_NOISY_DIFF_RATIO) ? 2 : 1);
+    bool is_loud = (level_db > std::max(_noise_floor_db, VAD_NOISE_FLOOR_MIN_DB) + threshold_db);
+
+    float rate = VAD_NOISE_FLOOR_FALL_RATE;
+    if (level_db > _noise_floor_db) {
+        rate = is_loud ? VAD_NOISE_FLOOR_LOUD_RISE_RATE : VAD_NOISE_FLOOR_QUIET_RISE_RATE;
+    }
+    _noise_floor_db += (level_db - _noise_floor_db) * rate;
+
+    if (is_loud) {
+        _loud_ms += _block_duration_ms;
+        _quiet_ms = 0;
+        if (!_is_speech && (_loud_ms >= _config.speech_min_ms)) {
+            _is_speech = true;
+        }
+        return;
+    }
+
+    _quiet_ms += _block_duration_ms;
+    if (!_is_speech) {
+        _loud_ms = 0;
+    } else if (_quiet_ms >= _config.hangover_ms) {
+        _is_speech = false;
+        _loud_ms = 0;
+    }
+}
+
+bool AudioVoiceGate::begin(const Config &config, OutputFunction output)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    ESP_UTILS_LOGD(
+        "Param: frame_size_max(%d), byte_rate(%d), preroll_ms(%d), onset_ms(%d), end_silence_ms(%d), enable_vad(%d)",
+        static_cast<int>(config.frame_size_max), static_cast<int>(config.byte_rate), config.preroll_ms,
+        config.onset_ms, config.end_silence_ms, config.enable_vad
+    );
+
+    ESP_UTILS_CHECK_FALSE_RETURN(!checkInitialized(), false, "Already initialized");
+    ESP_UTILS_CHECK_FALSE_RETURN(config.frame_size_max > 0, false, "Invalid frame size max");
+    ESP_UTILS_CHECK_FALSE_RETURN(config.byte_rate > 0, false, "Invalid byte rate");
+    ESP_UTILS_CHECK_FALSE_RETURN(output, false, "Invalid output function");
+    if (config.enable_vad) {
+        ESP_UTILS_CHECK_FALSE_RETURN(_vad.begin(config.vad), false, "Begin VAD failed");
+    }
+
+    // One more slot, the oldest frame is usually only partly needed
+    size_t preroll_size = static_cast<size_t>(std::max(config.preroll_ms, config.onset_ms)) * config.byte_rate / 1000;
+    size_t slot_num = (preroll_size + config.frame_size_max - 1) / config.frame_size_max + 1;
+    std::unique_ptr<uint8_t[]> buffer(new (std::nothrow) uint8_t[slot_num * config.frame_size_max]);
+    ESP_UTILS_CHECK_NULL_RETURN(
+        buffer, false, "Allocate pre-roll(%d) failed", static_cast<int>(slot_num * config.frame_size_max)
+    );
+    std::unique_ptr<uint32_t[]> sizes(new (std::nothrow) uint32_t[slot_num]);
+    std::unique_ptr<bool[]> opens(new (std::nothrow) bool[slot_num]);
+    ESP_UTILS_CHECK_FALSE_RETURN((sizes != nullptr) && (opens != nullptr), false, "Allocate pre-roll slots failed");
+
+    _config = config;
+    _output = std::move(output);
+    _preroll_buffer = std::move(buffer);
+    _preroll_sizes = std::move(sizes);
+    _preroll_opens = std::move(opens);
+    _preroll_slot_num = slot_num;
+    _preroll_head = 0;
+    _preroll_frame_num = 0;
+    _is_wakeup_requested = false;
+    _is_streaming = false;
+    _silence_ms = 0;
+    resetStats();
+
+    return true;
+}
+
+void AudioVoiceGate::del()
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    _output = nullptr;
+    _preroll_buffer.reset();
+    _preroll_sizes.reset();
+    _preroll_opens.reset();
+    _preroll_slot_num = 0;
+    _preroll_head = 0;
+    _preroll_frame_num = 0;
+    _is_streaming = false;
+}
+
+void AudioVoiceGate::process(
+    const uint8_t *data, size_t size, const int16_t *samples, size_t sample_num, bool is_open
+)
+{
+    ESP_UTILS_CHECK_FALSE_EXIT(checkInitialized(), "Not initialized");
+    ESP_UTILS_CHECK_FALSE_EXIT(
+        (data != nullptr) && (size > 0) && (size <= _config.frame_size_max), "Invalid frame(%d)",
+        static_cast<int>(size)
+    );
+
+    bool is_speech = false;
+    if (_config.enable_vad) {
+        is_speech = _vad.process(samples, sample_num);
+    }
+
+    if (!is_open) {
+        _is_streaming = false;
+        keepPreroll(data, size, false);
+        return;
+    }
+
+    if (_is_wakeup_requested.exchange(false, std::memory_order_acq_rel)) {
+        _wakeup_count.fetch_add(1, std::memory_order_relaxed);
+        sendPreroll(_config.preroll_ms, true);
+        send(data, size);
+        // The wake word was the last speech
+        _is_streaming = true;
+        _silence_ms = 0;
+        return;
+    }
+
+    if (!_config.enable_vad) {
+        send(data, size);
+        _is_streaming = true;
+        return;
+    }
+
+    if (_is_streaming) {
+        _silence_ms = is_speech ? 0 : _silence_ms + getDurationMs(size);
+        send(data, size);
+        if (_silence_ms >= _config.end_silence_ms) {
+            ESP_UTILS_LOGD("Speech end");
+            _is_streaming = false;
+            _speech_end_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    if (is_speech) {
+        ESP_UTILS_LOGD("Speech start");
+        _speech_start_count.fetch_add(1, std::memory_order_relaxed);
+        sendPreroll(_config.onset_ms, false);
+        send(data, size);
+        _is_streaming = true;
+        _silence_ms = 0;
+        return;
+    }
+
+    _gated_frame_count.fetch_add(1, std::memory_order_relaxed);
+    _gated_bytes.fetch_add(static_cast<uint32_t>(size), std::memory_order_relaxed);
+    keepPreroll(data, size, true);
+}
+
+AudioVoiceGate::Stats AudioVoiceGate::getStats() const
+{
+    return Stats{
+        .wakeup_count = _wakeup_count.load(std::memory_order_relaxed),
+        .speech_start_count = _speech_start_count.load(std::memory_order_relaxed),
+        .speech_end_count = _speech_end_count.load(std::memory_order_relaxed),
+        .sent_frame_count = _sent_frame_count.load(std::memory_order_relaxed),
+        .preroll_frame_count = _preroll_frame_count.load(std::memory_order_relaxed),
+        .drop_frame_count = _drop_frame_count.load(std::memory_order_relaxed),
+        .gated_frame_count = _gated_frame_count.load(std::memory_order_relaxed),
+        .sent_bytes = _sent_bytes.load(std::memory_order_relaxed),
+        .gated_bytes = _gated_bytes.load(std::memory_order_relaxed),
+    };
+}
+
+void AudioVoiceGate::resetStats()
+{
+    _wakeup_count = 0;
+    _speech_start_count = 0;
+    _speech_end_count = 0;
+    _sent_frame_count = 0;
+    _preroll_frame_count = 0;
+    _drop_frame_count = 0;
+    _gated_frame_count = 0;
+    _sent_bytes = 0;
+    _gated_bytes = 0;
+}
+
+void AudioVoiceGate::dumpStats(const char *name) const
+{
+    auto stats = getStats();
+
+    ESP_UTILS_LOGI(
+        "%s gate: wakeup(%u), speech start(%u), speech end(%u), sent(%u frames, %u bytes, %u pre-roll), drop(%u), "
+        "gated(%u frames, %u bytes)", (name != nullptr) ? name : "Audio",
+        static_cast<unsigned>(stats.wakeup_count), static_cast<unsigned>(stats.speech_start_count),
+        static_cast<unsigned>(stats.speech_end_count), static_cast<unsigned>(stats.sent_frame_count),
+        static_cast<unsigned>(stats.sent_bytes), static_cast<unsigned>(stats.preroll_frame_count),
+        static_cast<unsigned>(stats.drop_frame_count), static_cast<unsigned>(stats.gated_frame_count),
+        static_cast<unsigned>(stats.gated_bytes)
+    );
+}
+
+void AudioVoiceGate::send(const uint8_t *data, size_t size)
+{
+    if (!_output(data, size)) {
+        _drop_frame_count.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    _sent_frame_count.fetch_add(1, std::memory_order_relaxed);
+    _sent_bytes.fetch_add(static_cast<uint32_t>(size), std::memory_order_relaxed);
+}
+
+void AudioVoiceGate::sendPreroll(uint32_t duration_ms, bool with_closed)
+{
+    // Go back from the newest frame until the duration is reached
+    size_t frame_num = 0;
+    uint32_t preroll_ms = 0;
+    while ((frame_num < _preroll_frame_num) && (preroll_ms < duration_ms)) {
+        size_t slot = (_preroll_head + _preroll_slot_num - 1 - frame_num) % _preroll_slot_num;
+        if (!with_closed && !_preroll_opens[slot]) {
+            break;
+        }
+        preroll_ms += getDurationMs(_preroll_sizes[slot]);
+        frame_num++;
+    }
+
+    for (size_t i = frame_num; i > 0; i--) {
+        size_t slot = (_preroll_head + _preroll_slot_num - i) % _preroll_slot_num;
+        send(&_preroll_buffer[slot * _config.frame_size_max], _preroll_sizes[slot]);
+    }
+    _preroll_frame_count.fetch_add(static_cast<uint32_t>(frame_num), std::memory_order_relaxed);
+    // The older frames are not sent later, the pre-roll must stay contiguous with the stream
+    _preroll_frame_num = 0;
+}
+
+void AudioVoiceGate::keepPreroll(const uint8_t *data, size_t size, bool is_open)
+{
+    std::memcpy(&_preroll_buffer[_preroll_head * _config.frame_size_max], data, size);
+    _preroll_sizes[_preroll_head] = static_cast<uint32_t>(size);
+    _preroll_opens[_preroll_head] = is_open;
+    _preroll_head = (_preroll_head + 1) % _preroll_slot_num;
+    _preroll_frame_num = std::min(_preroll_frame_num + 1, _preroll_slot_num);
+}
+
+void decodeG711A(const uint8_t *data, size_t size, int16_t *samples)
+{
+    for (size_t i = 0; i < size; i++) {
+        uint8_t value = data[i] ^ 0x55;
+        int32_t magnitude = (value & 0x0F) << 4;
+        int32_t segment = (value & 0x70) >> 4;
+        if (segment == 0) {
+            magnitude += 8;
+        } else {
+            magnitude = (magnitude + 0x108) << (segment - 1);
+        }
+        samples[i] = static_cast<int16_t>((value & 0x80) ? magnitude : -magnitude);
+    }
+}
+
+} // namespace esp_brookesia::ai_framework
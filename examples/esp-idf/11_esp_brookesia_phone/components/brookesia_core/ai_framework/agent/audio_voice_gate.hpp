@@ -0,0 +1,201 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace esp_brookesia::ai_framework {
+
+/**
+ * @brief An energy based voice activity detector for 16-bit mono PCM
+ *
+ * The audio is cut into blocks of 10 ms. A block is loud if its energy is `threshold_db` above the noise floor, which
+ * follows the quiet blocks quickly and the loud ones slowly. The samples of noise like hiss or a fan change faster than
+ * those of a voice, so a loud block whose first difference holds most of its energy only counts if it is twice as
+ * loud. The speech starts after `speech_min_ms` of loud blocks and ends after `hangover_ms` without any.
+ *
+ * It does not depend on ESP-IDF and can be driven by recorded files.
+ */
+class VoiceActivityDetector {
+public:
+    struct Config {
+        uint32_t sample_rate;
+        uint8_t threshold_db;       // Level above the noise floor of a loud block
+        uint16_t speech_min_ms;     // Loud audio before the speech starts, shorter clicks are ignored
+        uint16_t hangover_ms;       // Quiet audio before the speech ends, so it goes on between the syllables
+    };
+
+    bool begin(const Config &config);
+    void reset();
+
+    /**
+     * @brief Process samples of any number, the blocks are cut across the calls
+     *
+     * @return true if the speech goes on at the last sample
+     */
+    bool process(const int16_t *samples, size_t sample_num);
+
+    bool isSpeech() const
+    {
+        return _is_speech;
+    }
+    float getNoiseFloorDb() const
+    {
+        return _noise_floor_db;
+    }
+    const Config &getConfig() const
+    {
+        return _config;
+    }
+
+private:
+    void processBlock();
+
+    Config _config = {};
+    uint32_t _block_sample_num = 0;
+    uint32_t _block_duration_ms = 10;
+
+    // The current block
+    uint64_t _energy_sum = 0;
+    uint64_t _diff_energy_sum = 0;
+    uint32_t _sample_num = 0;
+    int16_t _last_sample = 0;
+
+    bool _has_noise_floor = false;
+    float _noise_floor_db = 0;
+    uint32_t _loud_ms = 0;
+    uint32_t _quiet_ms = 0;
+    bool _is_speech = false;
+};
+
+/**
+ * @brief Decide which recorded frames are sent to the server
+ *
+ * The last `preroll_ms` of frames are always kept, so the audio recorded while the wake word was being detected is not
+ * lost. The next frame processed after `requestWakeup()` sends them first, the wake word included.
+ *
+ * With the VAD, the gate then only sends the speech: it stops `end_silence_ms` after the last speech, and starts again
+ * with the `onset_ms` of audio before the VAD noticed the next speech, so its first syllable is sent too. The frames
+ * recorded while the gate was closed (e.g. while a reply is played) are not part of the onset.
+ *
+ * `process()` is only called from the recorder thread, the other functions from any thread.
+ */
+class AudioVoiceGate {
+public:
+    struct Config {
+        size_t frame_size_max;          // The pre-roll keeps frames of up to this size
+        uint32_t byte_rate;             // Bytes per second of the frames, to get their duration
+        uint16_t preroll_ms;            // Audio sent on wake-up. 0 means none
+        uint16_t onset_ms;              // Audio sent before a speech noticed by the VAD
+        uint16_t end_silence_ms;        // Audio without speech sent before the gate stops
+        bool enable_vad;                // Without it, all the audio is sent while the gate is open
+        VoiceActivityDetector::Config vad;
+    };
+
+    /**
+     * @brief Send a frame, return false if it is dropped
+     */
+    using OutputFunction = std::function<bool(const uint8_t *data, size_t size)>;
+
+    struct Stats {
+        uint32_t wakeup_count;
+        uint32_t speech_start_count;    // Speeches which opened the gate again after a silence
+        uint32_t speech_end_count;      // Silences which closed the gate
+        uint32_t sent_frame_count;
+        uint32_t preroll_frame_count;   // Sent frames recorded before a wake-up or a speech
+        uint32_t drop_frame_count;      // Frames refused by the output function
+        uint32_t gated_frame_count;     // Frames not sent while the gate was open, because there was no speech
+        uint32_t sent_bytes;
+        uint32_t gated_bytes;
+    };
+
+    AudioVoiceGate() = default;
+    ~AudioVoiceGate() = default;
+
+    AudioVoiceGate(const AudioVoiceGate &) = delete;
+    AudioVoiceGate &operator=(const AudioVoiceGate &) = delete;
+
+    bool begin(const Config &config, OutputFunction output);
+    void del();
+
+    /**
+     * @brief Send the pre-roll with the next frame processed while the gate is open
+     */
+    void requestWakeup()
+    {
+        _is_wakeup_requested.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief Process a recorded frame
+     *
+     * @param data        The frame, as it is sent
+     * @param size        Size of the frame
+     * @param samples     The frame as PCM for the VAD, unused without it
+     * @param sample_num  Number of samples
+     * @param is_open     Whether audio may be sent now: the chat is awake, not paused and not playing a reply
+     */
+    void process(const uint8_t *data, size_t size, const int16_t *samples, size_t sample_num, bool is_open);
+
+    bool isStreaming() const
+    {
+        return _is_streaming.load(std::memory_order_relaxed);
+    }
+    bool checkInitialized() const
+    {
+        return (_preroll_buffer != nullptr);
+    }
+
+    Stats getStats() const;
+    void resetStats();
+    void dumpStats(const char *name) const;
+
+private:
+    uint32_t getDurationMs(size_t size) const
+    {
+        return static_cast<uint32_t>(static_cast<uint64_t>(size) * 1000 / _config.byte_rate);
+    }
+    void send(const uint8_t *data, size_t size);
+    void sendPreroll(uint32_t duration_ms, bool with_closed);
+    void keepPreroll(const uint8_t *data, size_t size, bool is_open);
+
+    Config _config = {};
+    OutputFunction _output;
+    VoiceActivityDetector _vad;
+    std::atomic<bool> _is_wakeup_requested = false;
+    std::atomic<bool> _is_streaming = false;
+    uint32_t _silence_ms = 0;
+
+    // A ring of the last frames, each in a slot of `frame_size_max` bytes
+    std::unique_ptr<uint8_t[]> _preroll_buffer;
+    std::unique_ptr<uint32_t[]> _preroll_sizes;
+    std::unique_ptr<bool[]> _preroll_opens;
+    size_t _preroll_slot_num = 0;
+    size_t _preroll_head = 0;
+    size_t _preroll_frame_num = 0;
+
+    // Written by the recorder thread, read by anyone
+    std::atomic<uint32_t> _wakeup_count = 0;
+    std::atomic<uint32_t> _speech_start_count = 0;
+    std::atomic<uint32_t> _speech_end_count = 0;
+    std::atomic<uint32_t> _sent_frame_count = 0;
+    std::atomic<uint32_t> _preroll_frame_count = 0;
+    std::atomic<uint32_t> _drop_frame_count = 0;
+    std::atomic<uint32_t> _gated_frame_count = 0;
+    std::atomic<uint32_t> _sent_bytes = 0;
+    std::atomic<uint32_t> _gated_bytes = 0;
+};
+
+/**
+ * @brief Decode G.711 A-law into PCM, e.g. to run the VAD on a recording of the uplink
+ */
+void decodeG711A(const uint8_t *data, size_t size, int16_t *samples);
+
+} // namespace esp_brookesia::ai_framework
@@ -27,12 +27,36 @@
 #include "private/esp_brookesia_ai_agent_utils.hpp"
 #include "audio_processor.h"
 #include "function_calling.hpp"
+#include "audio_jitter_ring.hpp"
+#include "audio_voice_gate.hpp"
+#include "audio_uplink_encoder.hpp"
 #include "coze_chat_app.hpp"
 
 #define SPEAKING_TIMEOUT_MS         (2000)
 #define SPEAKING_MUTE_DELAY_MS      (2000)
 
-#define AUDIO_RECORDER_READ_SIZE    (1024)
+// The recorder outputs 16-bit mono PCM at 8 kHz, read in frames of 120 ms. An Opus packet can hold 120 ms.
+#define AUDIO_RECORDER_SAMPLE_RATE  (8000)
+#define AUDIO_RECORDER_FRAME_MS     (120)
+#define AUDIO_RECORDER_READ_SIZE    (AUDIO_RECORDER_SAMPLE_RATE * AUDIO_RECORDER_FRAME_MS / 1000 * sizeof(int16_t))
+#if ESP_BROOKESIA_AGENT_UPLINK_ENABLE_OPUS
+// The Opus encoder runs in the read task
+#   define AUDIO_DATA_READ_TASK_STACK_SIZE  (24 * 1024)
+#else
+#   define AUDIO_DATA_READ_TASK_STACK_SIZE  (3096)
+#endif
+
+#define AUDIO_DOWNLINK_RING_SIZE        (64 * 1024)
+#define AUDIO_DOWNLINK_FRAME_SIZE_MAX   (4 * 1024)
+// Large enough for the max latency of PCM, the largest codec
+#define AUDIO_UPLINK_RING_SIZE          (32 * 1024)
+// One packet per recorder frame, whatever the codec
+#define AUDIO_UPLINK_FRAME_DURATION_MS  (AUDIO_RECORDER_FRAME_MS)
+#define AUDIO_UPLINK_BYTE_RATE          (AUDIO_RECORDER_SAMPLE_RATE * sizeof(int16_t))
+#define AUDIO_UPLINK_ONSET_MS           (300)
+#define AUDIO_UPLINK_VAD_SPEECH_MIN_MS  (60)
+#define AUDIO_UPLINK_VAD_HANGOVER_MS    (200)
+#define AUDIO_RING_POLL_INTERVAL_MS     (10)
 
 #define COZE_INTERRUPT_TIMES        (20)
 #define COZE_INTERRUPT_INTERVAL_MS  (100)
@@ -51,6 +75,12 @@ struct coze_chat_t {
     bool                    websocket_connected;
     esp_timer_handle_t      speaking_timeout_timer;
     esp_gmf_oal_thread_t    read_thread;
+    esp_gmf_oal_thread_t    send_thread;
+    esp_gmf_oal_thread_t    feed_thread;
+    AudioJitterRing         downlink_ring;  // Network callback -> playback feeder
+    AudioJitterRing         uplink_ring;    // Recorder -> network sender
+    AudioVoiceGate          uplink_gate;    // Recorder -> uplink encoder, only the speech is sent
+    AudioUplinkEncoder      uplink_encoder; // Uplink gate -> uplink ring
     esp_gmf_oal_thread_t    btn_thread;
     QueueHandle_t           btn_evt_q;
 };
@@ -94,14 +124,18 @@ void CozeChatRobotInfo::dump() const
         "\t-name: %s\n"
         "\t-bot_id: %s\n"
         "\t-voice_id: %s\n"
-        "\t-description: %s\n",
-        name.c_str(), bot_id.c_str(), voice_id.c_str(), description.c_str()
+        "\t-description: %s\n"
+        "\t-uplink_codec: %s\n",
+        name.c_str(), bot_id.c_str(), voice_id.c_str(), description.c_str(),
+        AudioUplinkEncoder::getCodecName(uplink_codec)
     );
 }
 
 bool CozeChatRobotInfo::isValid() const
 {
-    return !name.empty() && !bot_id.empty() && !voice_id.empty() && !description.empty();
+    // Coze has no IMA-ADPCM input
+    return !name.empty() && !bot_id.empty() && !voice_id.empty() && !description.empty() &&
+           (uplink_codec != AudioUplinkEncoder::Codec::IMA_ADPCM) && AudioUplinkEncoder::checkCodecSupported(uplink_codec);
 }
 
 
@@ -209,6 +243,8 @@ static void audio_event_callback(esp_coze_chat_event_t event, char *data, void *
         ESP_UTILS_LOGI("chat stop");
         // change_speaking_state(true);
     } else if (event == ESP_COZE_CHAT_EVENT_CHAT_COMPLETED) {
+        // Let the tail of the reply play even if it is shorter than the target latency
+        coze_chat.downlink_ring.endStream();
         boost::thread([&]() {
             boost::this_thread::sleep_for(boost::chrono::milliseconds(SPEAKING_MUTE_DELAY_MS));
             change_speaking_state(false);
@@ -317,8 +353,14 @@ static void websocket_event_callback(esp_coze_ws_event_t *event)
 static void audio_data_callback(char *data, int len, void *ctx)
 {
     ESP_UTILS_LOGD("audio_data_callback");
+    // Never block the network callback, the playback feeder task drains the ring at the playback pace. The packets
+    // may have different durations, so each one is stored with the duration read from its Opus TOC byte. A packet
+    // which is not Opus counts as one frame of the configured duration
     if (!coze_chat.chat_pause && !coze_chat.chat_sleep && coze_chat.speaking) {
-        audio_playback_feed_data((uint8_t *)data, len);
+        uint32_t duration_us = AudioJitterRing::getOpusPacketDurationUs(data, (len > 0) ? len : 0);
+        if (!coze_chat.downlink_ring.push(data, len, duration_us)) {
+            ESP_UTILS_LOGD("Downlink ring is full, drop %d bytes", len);
+        }
     }
     if (!coze_chat.wakeup_start && !coze_chat.chat_pause && !coze_chat.chat_sleep) {
         change_speaking_state(true);
@@ -483,6 +525,8 @@ static void recorder_event_callback_fn(void *event, void *ctx)
             coze_chat_app_interrupt();
         }
         change_speaking_state(false);
+        // Before the wake-up state, so the first frame sent after it starts with the pre-roll
+        coze_chat.uplink_gate.requestWakeup();
         change_wakeup_state(true);
         coze_chat.wakeup_start = true;
         coze_chat_response_signal();
@@ -510,6 +554,22 @@ static void recorder_event_callback_fn(void *event, void *ctx)
     }
 }
 
+static bool audio_uplink_gate_output(const uint8_t *data, size_t size)
+{
+    return coze_chat.uplink_encoder.encode(reinterpret_cast<const int16_t *>(data), size / sizeof(int16_t));
+}
+
+static bool audio_uplink_encoder_output(const uint8_t *data, size_t size)
+{
+    // The recorder is not blocked by a slow network, the sender task drains the ring instead
+    if (!coze_chat.uplink_ring.push(data, size)) {
+        ESP_UTILS_LOGD("Uplink ring is full, drop %d bytes", static_cast<int>(size));
+        return false;
+    }
+
+    return true;
+}
+
 static void audio_data_read_task(void *pv)
 {
     coze_chat_t *coze_chat = (coze_chat_t *)pv;
@@ -518,13 +578,65 @@ static void audio_data_read_task(void *pv)
     int ret = 0;
     while (true) {
         ret = audio_recorder_read_data(data, AUDIO_RECORDER_READ_SIZE);
-        if (coze_chat->chat_start && coze_chat->wakeup && !coze_chat->chat_pause && !coze_chat->chat_sleep && !coze_chat->speaking) {
-            esp_coze_chat_send_audio_data(coze_chat->chat, (char *)data, ret);
+        if (ret <= 0) {
+            continue;
         }
+        // The gate keeps the frames read while it is closed as the pre-roll of the next wake-up
+        bool is_open = coze_chat->chat_start && coze_chat->wakeup && !coze_chat->chat_pause &&
+                       !coze_chat->chat_sleep && !coze_chat->speaking;
+        coze_chat->uplink_gate.process(
+            data, ret, reinterpret_cast<const int16_t *>(data), ret / sizeof(int16_t), is_open
+        );
         // heap_caps_check_integrity_all(true);
     }
 }
 
+static void audio_data_send_task(void *pv)
+{
+    coze_chat_t *coze_chat = (coze_chat_t *)pv;
+
+    uint8_t *data = (uint8_t *)esp_gmf_oal_calloc(1, AUDIO_RECORDER_READ_SIZE);
+    size_t size = 0;
+    while (true) {
+        if (coze_chat->uplink_ring.pop(data, AUDIO_RECORDER_READ_SIZE, size) != AudioJitterRing::PopResult::Frame) {
+            vTaskDelay(pdMS_TO_TICKS(AUDIO_RING_POLL_INTERVAL_MS));
+            continue;
+        }
+        if (coze_chat->chat_start && (coze_chat->chat != NULL)) {
+            esp_coze_chat_send_audio_data(coze_chat->chat, (char *)data, size);
+        }
+    }
+}
+
+static void audio_playback_feed_task(void *pv)
+{
+    coze_chat_t *coze_chat = (coze_chat_t *)pv;
+
+    uint8_t *data = (uint8_t *)esp_gmf_oal_calloc(1, AUDIO_DOWNLINK_FRAME_SIZE_MAX);
+    size_t size = 0;
+    uint32_t duration_us = 0;
+    int64_t next_feed_us = esp_timer_get_time();
+    while (true) {
+        auto result = coze_chat->downlink_ring.pop(data, AUDIO_DOWNLINK_FRAME_SIZE_MAX, size, &duration_us);
+        if (result == AudioJitterRing::PopResult::Waiting) {
+            vTaskDelay(pdMS_TO_TICKS(AUDIO_RING_POLL_INTERVAL_MS));
+            next_feed_us = esp_timer_get_time();
+            continue;
+        }
+        if (!coze_chat->chat_pause && !coze_chat->chat_sleep) {
+            audio_playback_feed_data(data, size);
+        }
+        // Pop the next frame once this one is played, so the jitter is absorbed by the ring rather than the player
+        // FIFO. The deadline moves by the duration of each frame, so frames of different lengths keep the pace. If the
+        // player is late, the deadline is already passed and the feeder catches up
+        next_feed_us += duration_us;
+        int64_t wait_us = next_feed_us - esp_timer_get_time();
+        if (wait_us >= 1000) {
+            vTaskDelay(pdMS_TO_TICKS(wait_us / 1000));
+        }
+    }
+}
+
 static void audio_pipe_open(void)
 {
     vTaskDelay(pdMS_TO_TICKS(800)); // Delay a little time to stagger other initializations
@@ -560,10 +672,67 @@ esp_err_t coze_chat_app_init(void)
     };
     esp_timer_create(&timer_args, &coze_chat.speaking_timeout_timer);
 
+    AudioJitterRing::Config downlink_config = {
+        .capacity_bytes = AUDIO_DOWNLINK_RING_SIZE,
+        .frame_size_max = AUDIO_DOWNLINK_FRAME_SIZE_MAX,
+        .frame_duration_ms = ESP_BROOKESIA_AGENT_DOWNLINK_FRAME_DURATION_MS,
+        .target_latency_ms = ESP_BROOKESIA_AGENT_DOWNLINK_TARGET_LATENCY_MS,
+        .max_latency_ms = ESP_BROOKESIA_AGENT_DOWNLINK_MAX_LATENCY_MS,
+        .conceal_frame_num_max = ESP_BROOKESIA_AGENT_DOWNLINK_CONCEAL_FRAME_NUM,
+    };
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        coze_chat.downlink_ring.begin(downlink_config), ESP_FAIL, "Begin downlink ring failed"
+    );
+    // The uplink is sent as soon as possible, so there is no prebuffer and no concealment
+    AudioJitterRing::Config uplink_config = {
+        .capacity_bytes = AUDIO_UPLINK_RING_SIZE,
+        .frame_size_max = AUDIO_RECORDER_READ_SIZE,
+        .frame_duration_ms = AUDIO_UPLINK_FRAME_DURATION_MS,
+        .target_latency_ms = 0,
+        .max_latency_ms = ESP_BROOKESIA_AGENT_UPLINK_MAX_LATENCY_MS,
+        .conceal_frame_num_max = 0,
+    };
+    ESP_UTILS_CHECK_FALSE_RETURN(coze_chat.uplink_ring.begin(uplink_config), ESP_FAIL, "Begin uplink ring failed");
+    AudioVoiceGate::Config uplink_gate_config = {
+        .frame_size_max = AUDIO_RECORDER_READ_SIZE,
+        .byte_rate = AUDIO_UPLINK_BYTE_RATE,
+        .preroll_ms = ESP_BROOKESIA_AGENT_UPLINK_PREROLL_MS,
+        .onset_ms = AUDIO_UPLINK_ONSET_MS,
+        .end_silence_ms = ESP_BROOKESIA_AGENT_UPLINK_VAD_END_SILENCE_MS,
+        .enable_vad = ESP_BROOKESIA_AGENT_UPLINK_ENABLE_VAD,
+        .vad = {
+            .sample_rate = AUDIO_RECORDER_SAMPLE_RATE,
+            .threshold_db = ESP_BROOKESIA_AGENT_UPLINK_VAD_THRESHOLD_DB,
+            .speech_min_ms = AUDIO_UPLINK_VAD_SPEECH_MIN_MS,
+            .hangover_ms = AUDIO_UPLINK_VAD_HANGOVER_MS,
+        },
+    };
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        coze_chat.uplink_gate.begin(uplink_gate_config, audio_uplink_gate_output), ESP_FAIL, "Begin uplink gate failed"
+    );
+    // The codec is set by the robot when the chat starts
+    AudioUplinkEncoder::Config uplink_encoder_config = {
+        .sample_rate = AUDIO_RECORDER_SAMPLE_RATE,
+        .frame_sample_num = AUDIO_RECORDER_READ_SIZE / sizeof(int16_t),
+        .opus_bitrate = ESP_BROOKESIA_AGENT_UPLINK_OPUS_BITRATE,
+        .codec = AudioUplinkEncoder::Codec::G711A,
+    };
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        coze_chat.uplink_encoder.begin(uplink_encoder_config, audio_uplink_encoder_output), ESP_FAIL,
+        "Begin uplink encoder failed"
+    );
+
     audio_pipe_open();
 
     esp_gmf_oal_thread_create(
-        &coze_chat.read_thread, "audio_data_read", audio_data_read_task, (void *)&coze_chat, 3096, 12, true, 1
+        &coze_chat.read_thread, "audio_data_read", audio_data_read_task, (void *)&coze_chat,
+        AUDIO_DATA_READ_TASK_STACK_SIZE, 12, true, 1
+    );
+    esp_gmf_oal_thread_create(
+        &coze_chat.send_thread, "audio_data_send", audio_data_send_task, (void *)&coze_chat, 4096, 11, true, 1
+    );
+    esp_gmf_oal_thread_create(
+        &coze_chat.feed_thread, "audio_playback_feed", audio_playback_feed_task, (void *)&coze_chat, 3096, 12, true, 1
     );
 
     return ESP_OK;
@@ -589,7 +758,17 @@ esp_err_t coze_chat_app_start(const CozeChatAgentInfo &agent_info, const CozeCha
     chat_config.bot_id = const_cast<char *>(robot_info.bot_id.c_str());
     chat_config.voice_id = const_cast<char *>(robot_info.voice_id.c_str());
     chat_config.access_token = token_str;
-    chat_config.uplink_audio_type = ESP_COZE_CHAT_AUDIO_TYPE_G711A;
+    switch (robot_info.uplink_codec) {
+    case AudioUplinkEncoder::Codec::PCM:
+        chat_config.uplink_audio_type = ESP_COZE_CHAT_AUDIO_TYPE_PCM;
+        break;
+    case AudioUplinkEncoder::Codec::OPUS:
+        chat_config.uplink_audio_type = ESP_COZE_CHAT_AUDIO_TYPE_OPUS;
+        break;
+    default:
+        chat_config.uplink_audio_type = ESP_COZE_CHAT_AUDIO_TYPE_G711A;
+        break;
+    }
     chat_config.audio_callback = audio_data_callback;
     chat_config.event_callback = audio_event_callback;
     chat_config.ws_event_callback = websocket_event_callback;
@@ -599,6 +778,9 @@ esp_err_t coze_chat_app_start(const CozeChatAgentInfo &agent_info, const CozeCha
     std::lock_guard lock(coze_chat.chat_mutex);
     esp_err_t ret = esp_coze_chat_init(&chat_config, &coze_chat.chat);
     ESP_UTILS_CHECK_FALSE_RETURN(ret == ESP_OK, ret, "esp_coze_chat_init failed(%s)", esp_err_to_name(ret));
+    // The packets of the previous codec are not sent
+    coze_chat.uplink_encoder.requestCodec(robot_info.uplink_codec);
+    coze_chat.uplink_ring.requestFlush();
 
     static auto func_call = FunctionDefinitionList::requestInstance().getJson();
 
@@ -652,6 +834,7 @@ void coze_chat_app_pause(void)
     }
     // esp_gmf_afe_reset_state(audio_processor_get_afe_handle());
     coze_chat.chat_pause = true;
+    coze_chat.uplink_ring.requestFlush();
     change_speaking_state(false);
     // change_wakeup_state(false);
 }
@@ -672,6 +855,7 @@ void coze_chat_app_sleep(void)
         coze_chat_app_interrupt();
     }
     coze_chat.chat_sleep = true;
+    coze_chat.uplink_ring.requestFlush();
     change_wakeup_state(false);
     change_speaking_state(false);
 }
@@ -680,6 +864,9 @@ void coze_chat_app_interrupt(void)
 {
     ESP_UTILS_LOG_TRACE_GUARD();
 
+    // The buffered reply is obsolete
+    coze_chat.downlink_ring.requestFlush();
+
     boost::thread([&]() {
         ESP_UTILS_LOG_TRACE_GUARD();
         for (int i = 0; i < COZE_INTERRUPT_TIMES; i++) {
@@ -694,3 +881,27 @@ void coze_chat_app_interrupt(void)
         }
     }).detach();
 }
+
+void coze_chat_app_get_audio_ring_stats(AudioJitterRing::Stats &downlink, AudioJitterRing::Stats &uplink)
+{
+    downlink = coze_chat.downlink_ring.getStats();
+    uplink = coze_chat.uplink_ring.getStats();
+}
+
+void coze_chat_app_get_uplink_encoder_stats(AudioUplinkEncoder::Stats &stats)
+{
+    stats = coze_chat.uplink_encoder.getStats();
+}
+
+void coze_chat_app_get_uplink_gate_stats(AudioVoiceGate::Stats &stats)
+{
+    stats = coze_chat.uplink_gate.getStats();
+}
+
+void coze_chat_app_dump_audio_ring_stats(void)
+{
+    coze_chat.downlink_ring.dumpStats("Downlink");
+    coze_chat.uplink_ring.dumpStats("Uplink");
+    coze_chat.uplink_gate.dumpStats("Uplink");
+    coze_chat.uplink_encoder.dumpStats("Uplink");
+}
@@ -9,6 +9,9 @@
 #include <string>
 #include "esp_err.h"
 #include "boost/signals2/signal.hpp"
+#include "audio_jitter_ring.hpp"
+#include "audio_voice_gate.hpp"
+#include "audio_uplink_encoder.hpp"
 
 #define COZE_CHAT_ERROR_CODE_INSUFFICIENT_CREDITS_BALANCE_1 (4027)
 #define COZE_CHAT_ERROR_CODE_INSUFFICIENT_CREDITS_BALANCE_2 (4028)
@@ -34,6 +37,9 @@ struct CozeChatRobotInfo {
     std::string bot_id;
     std::string voice_id;
     std::string description;
+    // Codec of the recorded audio sent to Coze: PCM, G711A or Opus
+    esp_brookesia::ai_framework::AudioUplinkEncoder::Codec uplink_codec =
+        esp_brookesia::ai_framework::AudioUplinkEncoder::Codec::G711A;
 };
 
 extern boost::signals2::signal<void(const std::string &emoji)> coze_chat_emoji_signal;
@@ -65,3 +71,30 @@ void coze_chat_app_wakeup(void);
 void coze_chat_app_sleep(void);
 
 void coze_chat_app_interrupt(void);
+
+/**
+ * @brief  Get the statistics of the audio rings between the network and the audio pipelines
+ *
+ * @param[out] downlink  Statistics of the ring from the network to the playback
+ * @param[out] uplink    Statistics of the ring from the recorder to the network
+ */
+void coze_chat_app_get_audio_ring_stats(
+    esp_brookesia::ai_framework::AudioJitterRing::Stats &downlink,
+    esp_brookesia::ai_framework::AudioJitterRing::Stats &uplink
+);
+
+/**
+ * @brief  Get the statistics of the encoder of the audio sent to the network
+ *
+ * @param[out] stats  Statistics of the encoder
+ */
+void coze_chat_app_get_uplink_encoder_stats(esp_brookesia::ai_framework::AudioUplinkEncoder::Stats &stats);
+
+/**
+ * @brief  Get the statistics of the gate which only sends the speech from the recorder to the uplink encoder
+ *
+ * @param[out] stats  Statistics of the gate
+ */
+void coze_chat_app_get_uplink_gate_stats(esp_brookesia::ai_framework::AudioVoiceGate::Stats &stats);
+
+void coze_chat_app_dump_audio_ring_stats(void);
@@ -11,6 +11,42 @@
 
 namespace esp_brookesia::ai_framework {
 
+static void append_json_string(std::string &json, std::string_view text)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    json += '"';
+    for (char c : text) {
+        switch (c) {
+        case '"':
+            json += "\\\"";
+            break;
+        case '\\':
+            json += "\\\\";
+            break;
+        case '\n':
+            json += "\\n";
+            break;
+        case '\r':
+            json += "\\r";
+            break;
+        case '\t':
+            json += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                json += "\\u00";
+                json += hex[(c >> 4) & 0xF];
+                json += hex[c & 0xF];
+            } else {
+                json += c;
+            }
+            break;
+        }
+    }
+    json += '"';
+}
+
 // FunctionParameter implementation
 FunctionParameter::FunctionParameter(const std::string &name, const std::string &description, ValueType type, bool required)
     : name_(name), description_(description), type_(type), required_(required)
@@ -40,23 +76,28 @@ void FunctionParameter::setString(const std::string &value)
 
 std::string FunctionParameter::getDescriptorJson()
 {
-    std::string json_str = "{";
-    json_str += "\"type\":\"";
+    std::string json_str;
+    appendDescriptorJson(json_str);
+    ESP_UTILS_LOGD("FunctionParameter %s JSON descriptor: %s", name_.c_str(), json_str.c_str());
+    return json_str;
+}
+
+void FunctionParameter::appendDescriptorJson(std::string &json) const
+{
+    json += "{\"type\":\"";
     if (type_ == ValueType::Boolean) {
-        json_str += "boolean";
+        json += "boolean";
     } else if (type_ == ValueType::Number) {
-        json_str += "integer";
+        json += "integer";
     } else if (type_ == ValueType::String) {
-        json_str += "string";
+        json += "string";
     }
-    json_str += "\",";
-    json_str += "\"description\":\"" + description_ + "\"";
+    json += "\",\"description\":";
+    append_json_string(json, description_);
     if (type_ == ValueType::Number) {
-        json_str += ",\"minimum\":0,\"maximum\":100";
+        json += ",\"minimum\":0,\"maximum\":100";
     }
-    json_str += "}";
-    ESP_UTILS_LOGD("FunctionParameter %s JSON descriptor: %s", name_.c_str(), json_str.c_str());
-    return json_str;
+    json += "}";
 }
 
 // FunctionDefinition implementation
@@ -64,6 +105,7 @@ FunctionDefinition::FunctionDefinition(const std::string &name, const std::strin
     : name_(name), description_(description)
 {
     ESP_UTILS_LOGD("Created function definition: %s", name.c_str());
+    updateJson();
 }
 
 void FunctionDefinition::addParameter(
@@ -73,7 +115,23 @@ void FunctionDefinition::addParameter(
     ESP_UTILS_LOGD("Param: name(%s), description(%s), type(%d), required(%d)", name.c_str(), description.c_str(),
                    static_cast<int>(type), static_cast<int>(required)
                   );
+    ESP_UTILS_CHECK_FALSE_EXIT(
+        parameters_.size() < PARAMETER_NUM_MAX, "Too many parameters, the max is %d", static_cast<int>(PARAMETER_NUM_MAX)
+    );
+    ESP_UTILS_CHECK_FALSE_EXIT(parameter_table_.find(name) < 0, "Parameter %s already exists", name.c_str());
+
     parameters_.push_back(FunctionParameter(name, description, type, required));
+
+    std::vector<std::string_view> names;
+    for (const auto &param : parameters_) {
+        names.push_back(param.name());
+    }
+    if (!parameter_table_.build(names)) {
+        ESP_UTILS_LOGE("Build parameter table failed");
+        parameters_.pop_back();
+    }
+    arguments_ = parameters_;
+    updateJson();
 }
 
 void FunctionDefinition::setCallback(Callback callback, std::optional<CallbackThreadConfig> thread_config)
@@ -88,97 +146,161 @@ void FunctionDefinition::setCallback(Callback callback, std::optional<CallbackTh
     thread_config_ = thread_config;
 }
 
-bool FunctionDefinition::invoke(const cJSON *args) const
+bool FunctionDefinition::invoke(std::string_view args_json) const
 {
     ESP_UTILS_LOGD("Invoking function: %s", name_.c_str());
-    if (!callback_) {
-        ESP_UTILS_LOGW("Function %s has no callback", name_.c_str());
-        return false;
+
+    resetArguments();
+    if (args_json.empty()) {
+        return finishInvoke();
     }
 
-    // char *param_str = cJSON_Print(args);
-    // if (param_str) {
-    //     ESP_UTILS_LOGI("Parameters JSON: %s", param_str);
-    //     free(param_str);
-    // } else {
-    //     ESP_UTILS_LOGE("Failed to print parameters JSON");
-    // }
-
-    std::vector<FunctionParameter> params = parameters_;
-    for (auto &param : params) {
-        cJSON *value = cJSON_GetObjectItem(args, param.name().c_str());
-        auto name = param.name().c_str();
-        if (!value) {
-            ESP_UTILS_CHECK_FALSE_RETURN(!param.required(), false, "Required parameter %s not found", name);
+    // Bind the arguments while tokenizing, the values are not copied except into the slots
+    JsonTokenizer tokenizer(args_json);
+    bool is_valid = (tokenizer.next().type == JsonTokenizer::TokenType::ObjectBegin);
+    while (is_valid) {
+        JsonTokenizer::Token key = tokenizer.next();
+        if (key.type == JsonTokenizer::TokenType::ObjectEnd) {
+            is_valid = (tokenizer.next().type == JsonTokenizer::TokenType::End);
+            break;
+        }
+        JsonTokenizer::Token value = tokenizer.next();
+        if ((key.type != JsonTokenizer::TokenType::Key) || (value.type == JsonTokenizer::TokenType::Error)) {
+            is_valid = false;
+            break;
+        }
+
+        int slot = findArgumentSlot(key.text, key.has_escape);
+        if (slot < 0) {
+            is_valid = tokenizer.skipValue(value);
             continue;
         }
+        ESP_UTILS_CHECK_FALSE_RETURN(bindArgument(slot, value), false, "Bind argument failed");
+    }
+    if (!is_valid) {
+        ESP_UTILS_LOGW("Arguments of %s are not a valid JSON object, ignore them", name_.c_str());
+        resetArguments();
+    }
 
-        switch (param.type()) {
-        case FunctionParameter::ValueType::Boolean:
-            ESP_UTILS_CHECK_FALSE_RETURN(
-                cJSON_IsBool(value), false, "FunctionParameter %s type mismatch: expected boolean", name
-            );
-            param.setBoolean(cJSON_IsTrue(value));
-            break;
+    return finishInvoke();
+}
 
-        case FunctionParameter::ValueType::Number:
-            ESP_UTILS_CHECK_FALSE_RETURN(
-                cJSON_IsNumber(value), false, "FunctionParameter %s type mismatch: expected number", name
-            );
-            param.setNumber(value->valueint);
-            break;
+void FunctionDefinition::resetArguments() const
+{
+    for (auto &argument : arguments_) {
+        argument.boolean_ = false;
+        argument.number_ = 0;
+        // Keep the capacity for the next call
+        argument.string_.clear();
+    }
+    bound_flags_ = 0;
+}
+
+int FunctionDefinition::findArgumentSlot(std::string_view name, bool has_escape) const
+{
+    if (has_escape) {
+        key_buffer_.clear();
+        if (!JsonTokenizer::unescapeString(name, key_buffer_)) {
+            return -1;
+        }
+        name = key_buffer_;
+    }
 
-        case FunctionParameter::ValueType::String:
+    return parameter_table_.find(name);
+}
+
+bool FunctionDefinition::bindArgument(int slot, const JsonTokenizer::Token &value) const
+{
+    FunctionParameter &argument = arguments_[slot];
+    auto name = argument.name().c_str();
+
+    // Like `cJSON_GetObjectItem()`, the first one of duplicate keys is used
+    if (bound_flags_ & (1U << slot)) {
+        return true;
+    }
+
+    switch (argument.type()) {
+    case FunctionParameter::ValueType::Boolean:
+        ESP_UTILS_CHECK_FALSE_RETURN(
+            (value.type == JsonTokenizer::TokenType::True) || (value.type == JsonTokenizer::TokenType::False), false,
+            "FunctionParameter %s type mismatch: expected boolean", name
+        );
+        argument.setBoolean(value.type == JsonTokenizer::TokenType::True);
+        break;
+
+    case FunctionParameter::ValueType::Number: {
+        int number = 0;
+        ESP_UTILS_CHECK_FALSE_RETURN(
+            (value.type == JsonTokenizer::TokenType::Number) && JsonTokenizer::parseInteger(value.text, number), false,
+            "FunctionParameter %s type mismatch: expected number", name
+        );
+        argument.setNumber(number);
+        break;
+    }
+
+    case FunctionParameter::ValueType::String:
+        ESP_UTILS_CHECK_FALSE_RETURN(
+            value.type == JsonTokenizer::TokenType::String, false, "FunctionParameter %s type mismatch: expected string",
+            name
+        );
+        if (value.has_escape) {
             ESP_UTILS_CHECK_FALSE_RETURN(
-                cJSON_IsString(value), false, "FunctionParameter %s type mismatch: expected string", name
+                JsonTokenizer::unescapeString(value.text, argument.string_), false,
+                "FunctionParameter %s has an invalid string", name
             );
-            param.setString(value->valuestring);
-            break;
+        } else {
+            argument.string_.assign(value.text);
         }
+        ESP_UTILS_LOGD("Set string parameter %s: %s", name, argument.string_.c_str());
+        break;
+    }
+    bound_flags_ |= (1U << slot);
+
+    return true;
+}
+
+bool FunctionDefinition::finishInvoke() const
+{
+    if (!callback_) {
+        ESP_UTILS_LOGW("Function %s has no callback", name_.c_str());
+        return false;
+    }
+
+    for (size_t i = 0; i < arguments_.size(); i++) {
+        ESP_UTILS_CHECK_FALSE_RETURN(
+            !arguments_[i].required() || (bound_flags_ & (1U << i)), false, "Required parameter %s not found",
+            arguments_[i].name().c_str()
+        );
     }
 
     if (thread_config_ != std::nullopt) {
+        // The slots are reused by the next call, so the thread gets its own copy
         esp_utils::thread_config_guard thread_config(*thread_config_);
-        boost::thread([this, params]() {
+        boost::thread([callback = callback_, params = arguments_]() {
             ESP_UTILS_LOG_TRACE_GUARD();
-            callback_(params);
+            callback(params);
         }).detach();
     } else {
-        callback_(params);
+        callback_(arguments_);
     }
 
     return true;
 }
 
-std::string FunctionDefinition::getJson() const
+void FunctionDefinition::updateJson()
 {
-    std::string json = "{";
-    json += "\"name\":\"" + name_ + "\",";
-    json += "\"description\":\"" + description_ + "\",";
-    json += "\"parameters\":{";
-    json += "\"type\":\"object\",";
-    json += "\"properties\":{";
+    std::string json = "{\"name\":";
+    append_json_string(json, name_);
+    json += ",\"description\":";
+    append_json_string(json, description_);
+    json += ",\"parameters\":{\"type\":\"object\",\"properties\":{";
 
     // Add properties
     for (size_t i = 0; i < parameters_.size(); ++i) {
         const auto &param = parameters_[i];
-        json += "\"" + param.name() + "\":{";
-        json += "\"type\":\"";
-        if (param.type() == FunctionParameter::ValueType::Boolean) {
-            json += "boolean";
-        } else if (param.type() == FunctionParameter::ValueType::Number) {
-            json += "integer";
-        } else if (param.type() == FunctionParameter::ValueType::String) {
-            json += "string";
-        }
-        json += "\",";
-        json += "\"description\":\"" + param.description() + "\"";
-
-        // Add min/max for number type
-        if (param.type() == FunctionParameter::ValueType::Number) {
-            json += ",\"minimum\":0,\"maximum\":100";
-        }
-        json += "}";
+        append_json_string(json, param.name());
+        json += ":";
+        param.appendDescriptorJson(json);
         if (i < parameters_.size() - 1) {
             json += ",";
         }
@@ -193,16 +315,14 @@ std::string FunctionDefinition::getJson() const
             if (!first) {
                 json += ",";
             }
-            json += "\"" + param.name() + "\"";
+            append_json_string(json, param.name());
             first = false;
         }
     }
-    json += "]";
-    json += "}";
-    json += "}";
+    json += "]}}";
 
     ESP_UTILS_LOGD("Function %s JSON descriptor: %s", name_.c_str(), json.c_str());
-    return json;
+    json_ = std::move(json);
 }
 
 // FunctionDefinitionList implementation
@@ -214,128 +334,140 @@ FunctionDefinitionList &FunctionDefinitionList::requestInstance()
 
 void FunctionDefinitionList::addFunction(const FunctionDefinition &func)
 {
-    function_index_[func.name()] = functions_.size();
-    functions_.push_back(func);
-    ESP_UTILS_LOGD("Added function to list: %s, index: %zu", func.name().c_str(), functions_.size() - 1);
+    std::lock_guard lock(mutex_);
+
+    int index = function_table_.find(func.name());
+    if (index >= 0) {
+        ESP_UTILS_LOGW("Replace function: %s", func.name().c_str());
+        functions_[index] = func;
+    } else {
+        functions_.push_back(func);
+
+        std::vector<std::string_view> names;
+        for (const auto &function : functions_) {
+            names.push_back(function.name());
+        }
+        if (!function_table_.build(names)) {
+            ESP_UTILS_LOGE("Build function table failed");
+            functions_.pop_back();
+            return;
+        }
+        index = functions_.size() - 1;
+    }
+    updateJson();
+
+    ESP_UTILS_LOGD("Added function to list: %s, index: %d", func.name().c_str(), index);
 }
 
-bool FunctionDefinitionList::invokeFunction(const cJSON *function_call) const
+bool FunctionDefinitionList::invokeFunction(std::string_view name, std::string_view args_json) const
 {
     ESP_UTILS_LOG_TRACE_GUARD();
 
-    ESP_UTILS_CHECK_NULL_RETURN(function_call, false, "Function call parameter is NULL");
+    std::lock_guard lock(mutex_);
 
-    cJSON *function = cJSON_GetObjectItem(function_call, "function");
-    ESP_UTILS_CHECK_NULL_RETURN(function, false, "Function field not found");
+    return dispatch(name, args_json);
+}
 
-    cJSON *name = cJSON_GetObjectItem(function, "name");
-    cJSON *arguments = cJSON_GetObjectItem(function, "arguments");
-    ESP_UTILS_CHECK_FALSE_RETURN((name != nullptr) && cJSON_IsString(name), false, "Name field invalid");
-    ESP_UTILS_CHECK_NULL_RETURN(arguments, false, "Arguments field not found");
+const std::string &FunctionDefinitionList::getJson() const
+{
+    std::lock_guard lock(mutex_);
 
-    ESP_UTILS_LOGD("Processing function call: %s", name->valuestring);
+    return json_;
+}
 
-    if (cJSON_IsString(arguments)) {
-        ESP_UTILS_LOGD("Arguments is string: %s", arguments->valuestring);
+const FunctionDefinition *FunctionDefinitionList::findFunction(std::string_view name) const
+{
+    int index = function_table_.find(name);
 
-        // Parse arguments JSON string
-        cJSON *args_obj = cJSON_Parse(arguments->valuestring);
-        if (args_obj == nullptr) {
-            goto next;
-        }
+    return (index >= 0) ? &functions_[index] : nullptr;
+}
 
-        {
-            // Check if contains action_json_str field
-            cJSON *action_json_str = cJSON_GetObjectItem(args_obj, "action_json_str");
-            if (action_json_str && cJSON_IsString(action_json_str)) {
-                ESP_UTILS_LOGD("Found action_json_str: %s", action_json_str->valuestring);
-
-                // Parse JSON from action_json_str
-                cJSON *action_obj = cJSON_Parse(action_json_str->valuestring);
-                if (!action_obj) {
-                    ESP_UTILS_LOGE("Failed to parse action_json_str: %s", action_json_str->valuestring);
-                    cJSON_Delete(args_obj);
-                    return false;
-                }
-
-                // Get actual function name and arguments
-                cJSON *actual_name = cJSON_GetObjectItem(action_obj, "name");
-                cJSON *actual_args = cJSON_GetObjectItem(action_obj, "arguments");
-
-                if (!actual_name || !cJSON_IsString(actual_name) || !actual_args) {
-                    ESP_UTILS_LOGE("Action JSON missing required fields or wrong types");
-                    cJSON_Delete(action_obj);
-                    cJSON_Delete(args_obj);
-                    return false;
-                }
-
-                // Print debug information
-                char *debug_str = cJSON_Print(action_obj);
-                if (debug_str) {
-                    ESP_UTILS_LOGD("Parsed action JSON: %s", debug_str);
-                    free(debug_str);
-                }
-
-                // Find and call the corresponding function
-                auto it = function_index_.find(actual_name->valuestring);
-                if (it == function_index_.end()) {
-                    ESP_UTILS_LOGE("Function not found: %s", actual_name->valuestring);
-                    cJSON_Delete(action_obj);
-                    cJSON_Delete(args_obj);
-                    return false;
-                }
-
-                ESP_UTILS_LOGD("Found function %s, index: %zu", actual_name->valuestring, it->second);
-
-                // Call the callback function
-                bool result = functions_[it->second].invoke(actual_args);
-
-                cJSON_Delete(action_obj);
-                cJSON_Delete(args_obj);
-                return result;
+bool FunctionDefinitionList::dispatch(std::string_view name, std::string_view args_json) const
+{
+    ESP_UTILS_LOGD("Processing function call: %.*s", static_cast<int>(name.size()), name.data());
+
+    // Check if the arguments only wrap the actual call in `action_json_str`
+    JsonTokenizer tokenizer(args_json);
+    if (tokenizer.next().type == JsonTokenizer::TokenType::ObjectBegin) {
+        for (auto key = tokenizer.next(); key.type == JsonTokenizer::TokenType::Key; key = tokenizer.next()) {
+            JsonTokenizer::Token value = tokenizer.next();
+            if ((key.text == "action_json_str") && (value.type == JsonTokenizer::TokenType::String)) {
+                action_buffer_.clear();
+                ESP_UTILS_CHECK_FALSE_RETURN(
+                    JsonTokenizer::unescapeString(value.text, action_buffer_), false, "Invalid action_json_str"
+                );
+                ESP_UTILS_LOGD("Found action_json_str: %s", action_buffer_.c_str());
+                return dispatchAction(action_buffer_);
             }
-        }
-
-next:
-        // Standard JSON parameter handling
-        auto it = function_index_.find(name->valuestring);
-        if (it == function_index_.end()) {
-            ESP_UTILS_LOGE("Function not found: %s", name->valuestring);
-            if (args_obj != nullptr) {
-                cJSON_Delete(args_obj);
+            if (!tokenizer.skipValue(value)) {
+                break;
             }
-            return false;
         }
+    }
 
-        ESP_UTILS_LOGD("Found function %s, index: %zu", name->valuestring, it->second);
+    const FunctionDefinition *function = findFunction(name);
+    ESP_UTILS_CHECK_NULL_RETURN(
+        function, false, "Function not found: %.*s", static_cast<int>(name.size()), name.data()
+    );
+    ESP_UTILS_LOGD("Found function %s", function->name().c_str());
 
-        // Call the callback function
-        bool result = functions_[it->second].invoke(args_obj);
+    return function->invoke(args_json);
+}
 
-        if (args_obj != nullptr) {
-            cJSON_Delete(args_obj);
-        }
-        return result;
-    } else if (cJSON_IsObject(arguments)) {
-        // Process object type parameters directly
-        auto it = function_index_.find(name->valuestring);
-        if (it == function_index_.end()) {
-            ESP_UTILS_LOGE("Function not found: %s", name->valuestring);
-            return false;
+bool FunctionDefinitionList::dispatchAction(std::string_view action_json) const
+{
+    std::optional<std::string_view> name;
+    std::optional<std::string_view> args_json;
+
+    JsonTokenizer tokenizer(action_json);
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        tokenizer.next().type == JsonTokenizer::TokenType::ObjectBegin, false, "Failed to parse action_json_str: %s",
+        action_buffer_.c_str()
+    );
+    while (true) {
+        JsonTokenizer::Token key = tokenizer.next();
+        if (key.type == JsonTokenizer::TokenType::ObjectEnd) {
+            break;
         }
+        JsonTokenizer::Token value = tokenizer.next();
+        ESP_UTILS_CHECK_FALSE_RETURN(
+            (key.type == JsonTokenizer::TokenType::Key) && (value.type != JsonTokenizer::TokenType::Error), false,
+            "Failed to parse action_json_str: %s", action_buffer_.c_str()
+        );
 
-        ESP_UTILS_LOGD("Found function %s, index: %zu", name->valuestring, it->second);
-
-        // Call the callback function
-        bool result = functions_[it->second].invoke(arguments);
-        return result;
+        if ((key.text == "name") && !name.has_value()) {
+            ESP_UTILS_CHECK_FALSE_RETURN(
+                (value.type == JsonTokenizer::TokenType::String) && !value.has_escape, false,
+                "Action JSON name is not a string"
+            );
+            name = value.text;
+        } else if ((key.text == "arguments") && !args_json.has_value()) {
+            std::string_view source;
+            ESP_UTILS_CHECK_FALSE_RETURN(tokenizer.skipValue(value, &source), false, "Failed to parse action arguments");
+            // Only an object gives arguments
+            args_json = (value.type == JsonTokenizer::TokenType::ObjectBegin) ? source : std::string_view();
+        } else {
+            ESP_UTILS_CHECK_FALSE_RETURN(tokenizer.skipValue(value), false, "Failed to parse action_json_str");
+        }
     }
-
-    ESP_UTILS_LOGE("Arguments is neither string nor object");
-    return false;
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        tokenizer.next().type == JsonTokenizer::TokenType::End, false, "Failed to parse action_json_str: %s",
+        action_buffer_.c_str()
+    );
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        name.has_value() && args_json.has_value(), false, "Action JSON missing required fields or wrong types"
+    );
+
+    const FunctionDefinition *function = findFunction(*name);
+    ESP_UTILS_CHECK_NULL_RETURN(
+        function, false, "Function not found: %.*s", static_cast<int>(name->size()), name->data()
+    );
+    ESP_UTILS_LOGD("Found function %s", function->name().c_str());
+
+    return function->invoke(*args_json);
 }
 
-std::string FunctionDefinitionList::getJson() const
+void FunctionDefinitionList::updateJson()
 {
     std::string json = "{\"functions\":[";
     for (size_t i = 0; i < functions_.size(); ++i) {
@@ -345,7 +477,7 @@ std::string FunctionDefinitionList::getJson() const
         }
     }
     json += "]}";
-    return json;
+    json_ = std::move(json);
 }
 
 } // namespace esp_brookesia::ai_framework
@@ -5,14 +5,17 @@
  */
 #pragma once
 
-#include <map>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <functional>
 #include <vector>
 #include <mutex>
-#include "cJSON.h"
 #include "thread/esp_utils_thread.hpp"
+#include "json_tokenizer.hpp"
+#include "name_hash_table.hpp"
+
+struct cJSON;
 
 namespace esp_brookesia::ai_framework {
 
@@ -63,20 +66,33 @@ public:
     std::string getDescriptorJson();
 
 private:
+    friend class FunctionDefinition;
+
+    void appendDescriptorJson(std::string &json) const;
+
     std::string name_;
     std::string description_;
     ValueType type_;
     bool required_;
-    bool boolean_;
-    int number_;
+    bool boolean_ = false;
+    int number_ = 0;
     std::string string_;
 };
 
+/**
+ * @brief A function which can be called by the agent.
+ *
+ * The parameters are compiled into a perfect hash table, and the arguments are bound into fixed parameter slots which
+ * are reused by each call, so a call does not allocate once the string slots have grown. The descriptor JSON is built
+ * when the definition changes.
+ */
 class FunctionDefinition {
 public:
     using CallbackThreadConfig = esp_utils::ThreadConfig;
     using Callback = std::function<void(const std::vector<FunctionParameter>&)>;
 
+    static constexpr size_t PARAMETER_NUM_MAX = 32;
+
     FunctionDefinition(const std::string &name, const std::string &description);
 
     void addParameter(
@@ -84,18 +100,38 @@ public:
     );
     void setCallback(Callback callback, std::optional<CallbackThreadConfig> thread_config = std::nullopt);
     bool invoke(const cJSON *args) const;
-    std::string name() const
+    /**
+     * @brief Invoke with the arguments given as the text of a JSON object. Empty or invalid text gives no arguments.
+     */
+    bool invoke(std::string_view args_json) const;
+    const std::string &name() const
     {
         return name_;
     }
-    std::string getJson() const;
+    const std::string &getJson() const
+    {
+        return json_;
+    }
 
 private:
+    void resetArguments() const;
+    int findArgumentSlot(std::string_view name, bool has_escape) const;
+    bool bindArgument(int slot, const JsonTokenizer::Token &value) const;
+    bool bindArgument(int slot, const cJSON *value) const;
+    bool finishInvoke() const;
+    void updateJson();
+
     std::string name_;
     std::string description_;
     std::vector<FunctionParameter> parameters_;
+    NameHashTable parameter_table_;
     Callback callback_;
     std::optional<CallbackThreadConfig> thread_config_;
+    std::string json_;
+    // Slots of the arguments of the current call
+    mutable std::vector<FunctionParameter> arguments_;
+    mutable uint32_t bound_flags_ = 0;
+    mutable std::string key_buffer_;
 };
 
 class FunctionDefinitionList {
@@ -106,13 +142,28 @@ public:
     static FunctionDefinitionList &requestInstance();
     void addFunction(const FunctionDefinition &func);
     bool invokeFunction(const cJSON *function_call) const;
-    std::string getJson() const;
+    /**
+     * @brief Invoke a function with the arguments given as the text of a JSON object
+     *
+     * If the arguments only wrap another call as `{"action_json_str": "{\"name\": ..., \"arguments\": {...}}"}`, the
+     * wrapped call is invoked instead.
+     */
+    bool invokeFunction(std::string_view name, std::string_view args_json) const;
+    const std::string &getJson() const;
 
 private:
     FunctionDefinitionList() = default;
 
+    const FunctionDefinition *findFunction(std::string_view name) const;
+    bool dispatch(std::string_view name, std::string_view args_json) const;
+    bool dispatchAction(std::string_view action_json) const;
+    void updateJson();
+
+    mutable std::mutex mutex_;
     std::vector<FunctionDefinition> functions_;
-    std::map<std::string, size_t> function_index_;
+    NameHashTable function_table_;
+    std::string json_;
+    mutable std::string action_buffer_;
 };
 
 } // namespace esp_brookesia::ai_framework
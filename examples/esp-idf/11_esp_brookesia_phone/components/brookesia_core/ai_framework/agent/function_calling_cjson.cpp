@@ -0,0 +1,105 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * The entry points of the function calling which take cJSON items. They are kept apart, so the rest of the function
+ * calling does not depend on cJSON.
+ */
+#include "cJSON.h"
+#include "private/esp_brookesia_ai_agent_utils.hpp"
+#include "function_calling.hpp"
+
+namespace esp_brookesia::ai_framework {
+
+bool FunctionDefinition::invoke(const cJSON *args) const
+{
+    ESP_UTILS_LOGD("Invoking function: %s", name_.c_str());
+
+    resetArguments();
+    if (cJSON_IsObject(args)) {
+        const cJSON *item = nullptr;
+        cJSON_ArrayForEach(item, args) {
+            int slot = (item->string != nullptr) ? parameter_table_.find(item->string) : -1;
+            if (slot >= 0) {
+                ESP_UTILS_CHECK_FALSE_RETURN(bindArgument(slot, item), false, "Bind argument failed");
+            }
+        }
+    }
+
+    return finishInvoke();
+}
+
+bool FunctionDefinition::bindArgument(int slot, const cJSON *value) const
+{
+    FunctionParameter &argument = arguments_[slot];
+    auto name = argument.name().c_str();
+
+    if (bound_flags_ & (1U << slot)) {
+        return true;
+    }
+
+    switch (argument.type()) {
+    case FunctionParameter::ValueType::Boolean:
+        ESP_UTILS_CHECK_FALSE_RETURN(
+            cJSON_IsBool(value), false, "FunctionParameter %s type mismatch: expected boolean", name
+        );
+        argument.setBoolean(cJSON_IsTrue(value));
+        break;
+
+    case FunctionParameter::ValueType::Number:
+        ESP_UTILS_CHECK_FALSE_RETURN(
+            cJSON_IsNumber(value), false, "FunctionParameter %s type mismatch: expected number", name
+        );
+        argument.setNumber(value->valueint);
+        break;
+
+    case FunctionParameter::ValueType::String:
+        ESP_UTILS_CHECK_FALSE_RETURN(
+            cJSON_IsString(value), false, "FunctionParameter %s type mismatch: expected string", name
+        );
+        argument.string_.assign(value->valuestring);
+        ESP_UTILS_LOGD("Set string parameter %s: %s", name, argument.string_.c_str());
+        break;
+    }
+    bound_flags_ |= (1U << slot);
+
+    return true;
+}
+
+bool FunctionDefinitionList::invokeFunction(const cJSON *function_call) const
+{
+    ESP_UTILS_LOG_TRACE_GUARD();
+
+    ESP_UTILS_CHECK_NULL_RETURN(function_call, false, "Function call parameter is NULL");
+
+    cJSON *function = cJSON_GetObjectItem(function_call, "function");
+    ESP_UTILS_CHECK_NULL_RETURN(function, false, "Function field not found");
+
+    cJSON *name = cJSON_GetObjectItem(function, "name");
+    cJSON *arguments = cJSON_GetObjectItem(function, "arguments");
+    ESP_UTILS_CHECK_FALSE_RETURN((name != nullptr) && cJSON_IsString(name), false, "Name field invalid");
+    ESP_UTILS_CHECK_NULL_RETURN(arguments, false, "Arguments field not found");
+
+    std::lock_guard lock(mutex_);
+
+    if (cJSON_IsString(arguments)) {
+        // The arguments are tokenized from the string, without building another cJSON tree
+        ESP_UTILS_LOGD("Arguments is string: %s", arguments->valuestring);
+        return dispatch(name->valuestring, arguments->valuestring);
+    } else if (cJSON_IsObject(arguments)) {
+        // Process object type parameters directly
+        const FunctionDefinition *func = findFunction(name->valuestring);
+        ESP_UTILS_CHECK_NULL_RETURN(func, false, "Function not found: %s", name->valuestring);
+
+        ESP_UTILS_LOGD("Found function %s", name->valuestring);
+
+        return func->invoke(arguments);
+    }
+
+    ESP_UTILS_LOGE("Arguments is neither string nor object");
+    return false;
+}
+
+} // namespace esp_brookesia::ai_framework
@@ -0,0 +1,374 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <charconv>
+#include <climits>
+#include "json_tokenizer.hpp"
+
+namespace esp_brookesia::ai_framework {
+
+JsonTokenizer::JsonTokenizer(std::string_view json)
+    : _json(json)
+{
+}
+
+JsonTokenizer::Token JsonTokenizer::next(void)
+{
+    while (true) {
+        skipSpace();
+        if (_pos >= _json.size()) {
+            return (_expect == Expect::Done) ? makeToken(TokenType::End, _pos, _pos) : fail();
+        }
+
+        size_t begin = _pos;
+        char c = _json[_pos];
+        switch (_expect) {
+        case Expect::Done:
+            return fail();
+        case Expect::CommaOrEnd:
+            if (c == ',') {
+                _pos++;
+                _expect = checkInObject() ? Expect::Key : Expect::Value;
+                continue;
+            }
+            if (c == (checkInObject() ? '}' : ']')) {
+                _pos++;
+                TokenType type = checkInObject() ? TokenType::ObjectEnd : TokenType::ArrayEnd;
+                pop();
+                return makeToken(type, begin, _pos);
+            }
+            return fail();
+        case Expect::KeyOrEnd:
+        case Expect::ValueOrEnd:
+            if (c == ((_expect == Expect::KeyOrEnd) ? '}' : ']')) {
+                _pos++;
+                TokenType type = (_expect == Expect::KeyOrEnd) ? TokenType::ObjectEnd : TokenType::ArrayEnd;
+                pop();
+                return makeToken(type, begin, _pos);
+            }
+            _expect = (_expect == Expect::KeyOrEnd) ? Expect::Key : Expect::Value;
+            continue;
+        case Expect::Key: {
+            size_t end = 0;
+            bool has_escape = false;
+            if ((c != '"') || !scanString(end, has_escape)) {
+                return fail();
+            }
+            skipSpace();
+            if ((_pos >= _json.size()) || (_json[_pos] != ':')) {
+                return fail();
+            }
+            _pos++;
+            _expect = Expect::Value;
+            return makeToken(TokenType::Key, begin + 1, end, has_escape);
+        }
+        case Expect::Value:
+            break;
+        }
+
+        switch (c) {
+        case '{':
+        case '[':
+            if (!push(c == '{')) {
+                return fail();
+            }
+            _pos++;
+            return makeToken((c == '{') ? TokenType::ObjectBegin : TokenType::ArrayBegin, begin, _pos);
+        case '"': {
+            size_t end = 0;
+            bool has_escape = false;
+            if (!scanString(end, has_escape)) {
+                return fail();
+            }
+            finishValue();
+            return makeToken(TokenType::String, begin + 1, end, has_escape);
+        }
+        case 't':
+            if (!scanLiteral("true")) {
+                return fail();
+            }
+            finishValue();
+            return makeToken(TokenType::True, begin, _pos);
+        case 'f':
+            if (!scanLiteral("false")) {
+                return fail();
+            }
+            finishValue();
+            return makeToken(TokenType::False, begin, _pos);
+        case 'n':
+            if (!scanLiteral("null")) {
+                return fail();
+            }
+            finishValue();
+            return makeToken(TokenType::Null, begin, _pos);
+        default: {
+            size_t end = 0;
+            if (!scanNumber(end)) {
+                return fail();
+            }
+            finishValue();
+            return makeToken(TokenType::Number, begin, end);
+        }
+        }
+    }
+}
+
+bool JsonTokenizer::skipValue(const Token &first, std::string_view *source)
+{
+    const char *begin = first.text.data();
+    const char *end = first.text.data() + first.text.size();
+
+    switch (first.type) {
+    case TokenType::ObjectBegin:
+    case TokenType::ArrayBegin: {
+        int depth = _depth - 1;
+        while (_depth > depth) {
+            Token token = next();
+            if ((token.type == TokenType::Error) || (token.type == TokenType::End)) {
+                return false;
+            }
+            end = token.text.data() + token.text.size();
+        }
+        break;
+    }
+    case TokenType::String:
+        // Include the quotes
+        begin--;
+        end++;
+        break;
+    case TokenType::Number:
+    case TokenType::True:
+    case TokenType::False:
+    case TokenType::Null:
+        break;
+    default:
+        return false;
+    }
+
+    if (source != nullptr) {
+        *source = std::string_view(begin, end - begin);
+    }
+
+    return true;
+}
+
+bool JsonTokenizer::unescapeString(std::string_view text, std::string &out)
+{
+    auto parse_hex4 = [&text](size_t pos, uint32_t &value) {
+        if (pos + 4 > text.size()) {
+            return false;
+        }
+        auto result = std::from_chars(text.data() + pos, text.data() + pos + 4, value, 16);
+        return (result.ec == std::errc()) && (result.ptr == text.data() + pos + 4);
+    };
+
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (c != '\\') {
+            out.push_back(c);
+            continue;
+        }
+        if (++i >= text.size()) {
+            return false;
+        }
+        switch (text[i]) {
+        case '"':
+        case '\\':
+        case '/':
+            out.push_back(text[i]);
+            break;
+        case 'b':
+            out.push_back('\b');
+            break;
+        case 'f':
+            out.push_back('\f');
+            break;
+        case 'n':
+            out.push_back('\n');
+            break;
+        case 'r':
+            out.push_back('\r');
+            break;
+        case 't':
+            out.push_back('\t');
+            break;
+        case 'u': {
+            uint32_t code = 0;
+            if (!parse_hex4(i + 1, code)) {
+                return false;
+            }
+            i += 4;
+            // A high surrogate must be followed by a low one
+            if ((code >= 0xD800) && (code <= 0xDBFF)) {
+                uint32_t low = 0;
+                if ((i + 2 >= text.size()) || (text[i + 1] != '\\') || (text[i + 2] != 'u') ||
+                        !parse_hex4(i + 3, low) || (low < 0xDC00) || (low > 0xDFFF)) {
+                    return false;
+                }
+                i += 6;
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+            } else if ((code >= 0xDC00) && (code <= 0xDFFF)) {
+                return false;
+            }
+            // UTF-8
+            if (code < 0x80) {
+                out.push_back(static_cast<char>(code));
+            } else if (code < 0x800) {
+                out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            } else if (code < 0x10000) {
+                out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            } else {
+                out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool JsonTokenizer::parseInteger(std::string_view text, int &value)
+{
+    double number = 0;
+    auto result = std::from_chars(text.data(), text.data() + text.size(), number);
+    if ((result.ec != std::errc()) || (result.ptr != text.data() + text.size())) {
+        return false;
+    }
+
+    if (number >= INT_MAX) {
+        value = INT_MAX;
+    } else if (number <= static_cast<double>(INT_MIN)) {
+        value = INT_MIN;
+    } else {
+        value = static_cast<int>(number);
+    }
+
+    return true;
+}
+
+JsonTokenizer::Token JsonTokenizer::fail(void)
+{
+    _expect = Expect::Done;
+    _pos = _json.size();
+    _depth = 0;
+
+    return Token{TokenType::Error, std::string_view(), false};
+}
+
+bool JsonTokenizer::scanString(size_t &end, bool &has_escape)
+{
+    has_escape = false;
+    for (size_t i = _pos + 1; i < _json.size(); i++) {
+        unsigned char c = _json[i];
+        if (c == '"') {
+            end = i;
+            _pos = i + 1;
+            return true;
+        }
+        if (c < 0x20) {
+            return false;
+        }
+        if (c == '\\') {
+            has_escape = true;
+            i++;
+        }
+    }
+
+    return false;
+}
+
+bool JsonTokenizer::scanNumber(size_t &end)
+{
+    auto is_digit = [this](size_t pos) {
+        return (pos < _json.size()) && (_json[pos] >= '0') && (_json[pos] <= '9');
+    };
+    size_t pos = _pos;
+
+    if ((pos < _json.size()) && (_json[pos] == '-')) {
+        pos++;
+    }
+    if (!is_digit(pos)) {
+        return false;
+    }
+    while (is_digit(pos)) {
+        pos++;
+    }
+    if ((pos < _json.size()) && (_json[pos] == '.')) {
+        if (!is_digit(++pos)) {
+            return false;
+        }
+        while (is_digit(pos)) {
+            pos++;
+        }
+    }
+    if ((pos < _json.size()) && ((_json[pos] == 'e') || (_json[pos] == 'E'))) {
+        pos++;
+        if ((pos < _json.size()) && ((_json[pos] == '+') || (_json[pos] == '-'))) {
+            pos++;
+        }
+        if (!is_digit(pos)) {
+            return false;
+        }
+        while (is_digit(pos)) {
+            pos++;
+        }
+    }
+    end = pos;
+    _pos = pos;
+
+    return true;
+}
+
+bool JsonTokenizer::scanLiteral(std::string_view literal)
+{
+    if (_json.substr(_pos, literal.size()) != literal) {
+        return false;
+    }
+    _pos += literal.size();
+
+    return true;
+}
+
+bool JsonTokenizer::push(bool is_object)
+{
+    if (_depth >= DEPTH_MAX) {
+        return false;
+    }
+    _object_flags = (_object_flags & ~(1U << _depth)) | (static_cast<uint32_t>(is_object) << _depth);
+    _depth++;
+    _expect = is_object ? Expect::KeyOrEnd : Expect::ValueOrEnd;
+
+    return true;
+}
+
+void JsonTokenizer::pop(void)
+{
+    _depth--;
+    finishValue();
+}
+
+void JsonTokenizer::finishValue(void)
+{
+    _expect = (_depth == 0) ? Expect::Done : Expect::CommaOrEnd;
+}
+
+void JsonTokenizer::skipSpace(void)
+{
+    while ((_pos < _json.size()) &&
+            ((_json[_pos] == ' ') || (_json[_pos] == '\t') || (_json[_pos] == '\n') || (_json[_pos] == '\r'))) {
+        _pos++;
+    }
+}
+
+} // namespace esp_brookesia::ai_framework
@@ -0,0 +1,102 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace esp_brookesia::ai_framework {
+
+/**
+ * @brief A pull tokenizer of JSON text, which does not build a tree and does not allocate.
+ *
+ * The tokens point into the source text, which must outlive them. Strings are returned as they are in the source,
+ * without the quotes; the ones with escapes are flagged and can be decoded with `unescapeString()`. The structure is
+ * checked while tokenizing, any error stops the tokenizer.
+ */
+class JsonTokenizer {
+public:
+    static constexpr int DEPTH_MAX = 32;
+
+    enum class TokenType {
+        ObjectBegin,
+        ObjectEnd,
+        ArrayBegin,
+        ArrayEnd,
+        Key,
+        String,
+        Number,
+        True,
+        False,
+        Null,
+        End,        // The end of the text, after a complete value
+        Error,
+    };
+
+    struct Token {
+        TokenType type;
+        std::string_view text;  // Key and string: the content without quotes. Others: the source characters
+        bool has_escape;
+    };
+
+    explicit JsonTokenizer(std::string_view json);
+
+    Token next(void);
+
+    /**
+     * @brief Skip the value which starts with `first`, which must be the last token returned
+     *
+     * @param[out] source The source text of the value, from the first to the last character
+     */
+    bool skipValue(const Token &first, std::string_view *source = nullptr);
+
+    /**
+     * @brief Decode the escapes of a key or string token and append the result to `out`
+     */
+    static bool unescapeString(std::string_view text, std::string &out);
+
+    /**
+     * @brief Convert a number token like cJSON does for `valueint`: truncated and saturated to `int`
+     */
+    static bool parseInteger(std::string_view text, int &value);
+
+private:
+    enum class Expect : uint8_t {
+        Value,
+        ValueOrEnd,     // After `[`
+        Key,
+        KeyOrEnd,       // After `{`
+        CommaOrEnd,
+        Done,
+    };
+
+    Token makeToken(TokenType type, size_t begin, size_t end, bool has_escape = false) const
+    {
+        return Token{type, _json.substr(begin, end - begin), has_escape};
+    }
+    Token fail(void);
+    bool scanString(size_t &end, bool &has_escape);
+    bool scanNumber(size_t &end);
+    bool scanLiteral(std::string_view literal);
+    bool push(bool is_object);
+    void pop(void);
+    void finishValue(void);
+    bool checkInObject(void) const
+    {
+        return (_object_flags >> (_depth - 1)) & 1;
+    }
+    void skipSpace(void);
+
+    std::string_view _json;
+    size_t _pos = 0;
+    int _depth = 0;
+    uint32_t _object_flags = 0;
+    Expect _expect = Expect::Value;
+};
+
+} // namespace esp_brookesia::ai_framework
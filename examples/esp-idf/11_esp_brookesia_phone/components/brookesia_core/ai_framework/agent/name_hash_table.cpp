@@ -0,0 +1,60 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <limits>
+#include "private/esp_brookesia_ai_agent_utils.hpp"
+#include "name_hash_table.hpp"
+
+#define SEED_TRY_NUM_MAX    (64)
+#define SLOT_NUM_MAX        (4096)
+
+namespace esp_brookesia::ai_framework {
+
+bool NameHashTable::build(const std::vector<std::string_view> &names)
+{
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        names.size() <= static_cast<size_t>(std::numeric_limits<int16_t>::max()), false, "Too many names(%d)",
+        static_cast<int>(names.size())
+    );
+
+    _seed = 0;
+    _slots.clear();
+    _names.assign(names.begin(), names.end());
+    if (names.empty()) {
+        return true;
+    }
+
+    // Start with a load factor of 1/2, and double the table when no seed works
+    size_t slot_num = 1;
+    while (slot_num < names.size() * 2) {
+        slot_num <<= 1;
+    }
+    std::vector<int16_t> slots;
+    for (; slot_num <= SLOT_NUM_MAX; slot_num <<= 1) {
+        for (uint32_t seed = 0; seed < SEED_TRY_NUM_MAX; seed++) {
+            slots.assign(slot_num, -1);
+            bool is_collided = false;
+            for (size_t i = 0; (i < names.size()) && !is_collided; i++) {
+                int16_t &slot = slots[hash(names[i], seed) & (slot_num - 1)];
+                is_collided = (slot >= 0);
+                slot = static_cast<int16_t>(i);
+            }
+            if (!is_collided) {
+                ESP_UTILS_LOGD("Build table of %d names: %d slots, seed(%d)", static_cast<int>(names.size()),
+                               static_cast<int>(slot_num), static_cast<int>(seed));
+                _seed = seed;
+                _slots = std::move(slots);
+                return true;
+            }
+        }
+    }
+
+    _names.clear();
+    ESP_UTILS_CHECK_FALSE_RETURN(false, false, "No perfect hash found, check for duplicate names");
+
+    return false;
+}
+
+} // namespace esp_brookesia::ai_framework
@@ -0,0 +1,63 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace esp_brookesia::ai_framework {
+
+/**
+ * @brief A perfect hash table from names to their indexes, built once for a fixed set of names.
+ *
+ * The hash seed and the table size are searched until no two names share a slot, so a lookup is one hash and one
+ * compare.
+ */
+class NameHashTable {
+public:
+    /**
+     * @brief Build the table. The index of a name is its position in `names`, which must not have duplicates.
+     */
+    bool build(const std::vector<std::string_view> &names);
+
+    /**
+     * @return The index of `name`, or -1 if it is not in the table
+     */
+    int find(std::string_view name) const
+    {
+        if (_slots.empty()) {
+            return -1;
+        }
+        int index = _slots[hash(name, _seed) & (_slots.size() - 1)];
+
+        return ((index >= 0) && (_names[index] == name)) ? index : -1;
+    }
+
+    size_t getSize(void) const
+    {
+        return _names.size();
+    }
+
+private:
+    static uint32_t hash(std::string_view name, uint32_t seed)
+    {
+        // FNV-1a, with the seed mixed into the offset basis
+        uint32_t value = 2166136261U ^ seed;
+        for (char c : name) {
+            value = (value ^ static_cast<uint8_t>(c)) * 16777619U;
+        }
+
+        return value ^ (value >> 15);
+    }
+
+    uint32_t _seed = 0;
+    std::vector<int16_t> _slots;
+    std::vector<std::string> _names;
+};
+
+} // namespace esp_brookesia::ai_framework
@@ -30,6 +30,94 @@
 #           define ESP_BROOKESIA_AGENT_ENABLE_DEBUG_LOG  (0)
 #       endif
 #   endif
+
+#   if !defined(ESP_BROOKESIA_AGENT_DOWNLINK_FRAME_DURATION_MS)
+#       if defined(CONFIG_ESP_BROOKESIA_AGENT_DOWNLINK_FRAME_DURATION_MS)
+#           define ESP_BROOKESIA_AGENT_DOWNLINK_FRAME_DURATION_MS  CONFIG_ESP_BROOKESIA_AGENT_DOWNLINK_FRAME_DURATION_MS
+#       else
+#           define ESP_BROOKESIA_AGENT_DOWNLINK_FRAME_DURATION_MS  (60)
+#       endif
+#   endif
+
+#   if !defined(ESP_BROOKESIA_AGENT_DOWNLINK_TARGET_LATENCY_MS)
+#       if defined(CONFIG_ESP_BROOKESIA_AGENT_DOWNLINK_TARGET_LATENCY_MS)
+#           define ESP_BROOKESIA_AGENT_DOWNLINK_TARGET_LATENCY_MS  CONFIG_ESP_BROOKESIA_AGENT_DOWNLINK_TARGET_LATENCY_MS
+#       else
+#           define ESP_BROOKESIA_AGENT_DOWNLINK_TARGET_LATENCY_MS  (180)
+#       endif
+#   endif
+
+#   if !defined(ESP_BROOKESIA_AGENT_DOWNLINK_MAX_LATENCY_MS)
+#       if defined(CONFIG_ESP_BROOKESIA_AGENT_DOWNLINK_MAX_LATENCY_MS)
+#           define ESP_BROOKESIA_AGENT_DOWNLINK_MAX_LATENCY_MS  CONFIG_ESP_BROOKESIA_AGENT_DOWNLINK_MAX_LATENCY_MS
+#       else
+#           define ESP_BROOKESIA_AGENT_DOWNLINK_MAX_LATENCY_MS  (10000)
+#       endif
+#   endif
+
+#   if !defined(ESP_BROOKESIA_AGENT_DOWNLINK_CONCEAL_FRAME_NUM)
+#       if defined(CONFIG_ESP_BROOKESIA_AGENT_DOWNLINK_CONCEAL_FRAME_NUM)
+#           define ESP_BROOKESIA_AGENT_DOWNLINK_CONCEAL_FRAME_NUM  CONFIG_ESP_BROOKESIA_AGENT_DOWNLINK_CONCEAL_FRAME_NUM
+#       else
+#           define ESP_BROOKESIA_AGENT_DOWNLINK_CONCEAL_FRAME_NUM  (2)
+#       endif
+#   endif
+
+#   if !defined(ESP_BROOKESIA_AGENT_UPLINK_MAX_LATENCY_MS)
+#       if defined(CONFIG_ESP_BROOKESIA_AGENT_UPLINK_MAX_LATENCY_MS)
+#           define ESP_BROOKESIA_AGENT_UPLINK_MAX_LATENCY_MS  CONFIG_ESP_BROOKESIA_AGENT_UPLINK_MAX_LATENCY_MS
+#       else
+#           define ESP_BROOKESIA_AGENT_UPLINK_MAX_LATENCY_MS  (2000)
+#       endif
+#   endif
+
+#   if !defined(ESP_BROOKESIA_AGENT_UPLINK_PREROLL_MS)
+#       if defined(CONFIG_ESP_BROOKESIA_AGENT_UPLINK_PREROLL_MS)
+#           define ESP_BROOKESIA_AGENT_UPLINK_PREROLL_MS  CONFIG_ESP_BROOKESIA_AGENT_UPLINK_PREROLL_MS
+#       else
+#           define ESP_BROOKESIA_AGENT_UPLINK_PREROLL_MS  (1500)
+#       endif
+#   endif
+
+#   if !defined(ESP_BROOKESIA_AGENT_UPLINK_ENABLE_VAD)
+#       if defined(CONFIG_ESP_BROOKESIA_AGENT_UPLINK_ENABLE_VAD)
+#           define ESP_BROOKESIA_AGENT_UPLINK_ENABLE_VAD  CONFIG_ESP_BROOKESIA_AGENT_UPLINK_ENABLE_VAD
+#       else
+#           define ESP_BROOKESIA_AGENT_UPLINK_ENABLE_VAD  (0)
+#       endif
+#   endif
+
+#   if !defined(ESP_BROOKESIA_AGENT_UPLINK_VAD_THRESHOLD_DB)
+#       if defined(CONFIG_ESP_BROOKESIA_AGENT_UPLINK_VAD_THRESHOLD_DB)
+#           define ESP_BROOKESIA_AGENT_UPLINK_VAD_THRESHOLD_DB  CONFIG_ESP_BROOKESIA_AGENT_UPLINK_VAD_THRESHOLD_DB
+#       else
+#           define ESP_BROOKESIA_AGENT_UPLINK_VAD_THRESHOLD_DB  (12)
+#       endif
+#   endif
+
+#   if !defined(ESP_BROOKESIA_AGENT_UPLINK_VAD_END_SILENCE_MS)
+#       if defined(CONFIG_ESP_BROOKESIA_AGENT_UPLINK_VAD_END_SILENCE_MS)
+#           define ESP_BROOKESIA_AGENT_UPLINK_VAD_END_SILENCE_MS  CONFIG_ESP_BROOKESIA_AGENT_UPLINK_VAD_END_SILENCE_MS
+#       else
+#           define ESP_BROOKESIA_AGENT_UPLINK_VAD_END_SILENCE_MS  (1000)
+#       endif
+#   endif
+
+#   if !defined(ESP_BROOKESIA_AGENT_UPLINK_ENABLE_OPUS)
+#       if defined(CONFIG_ESP_BROOKESIA_AGENT_UPLINK_ENABLE_OPUS)
+#           define ESP_BROOKESIA_AGENT_UPLINK_ENABLE_OPUS  CONFIG_ESP_BROOKESIA_AGENT_UPLINK_ENABLE_OPUS
+#       else
+#           define ESP_BROOKESIA_AGENT_UPLINK_ENABLE_OPUS  (0)
+#       endif
+#   endif
+
+#   if !defined(ESP_BROOKESIA_AGENT_UPLINK_OPUS_BITRATE)
+#       if defined(CONFIG_ESP_BROOKESIA_AGENT_UPLINK_OPUS_BITRATE)
+#           define ESP_BROOKESIA_AGENT_UPLINK_OPUS_BITRATE  CONFIG_ESP_BROOKESIA_AGENT_UPLINK_OPUS_BITRATE
+#       else
+#           define ESP_BROOKESIA_AGENT_UPLINK_OPUS_BITRATE  (16000)
+#       endif
+#   endif
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -210,6 +210,53 @@ bool Expression::insertEmojiTemporary(const std::string &emoji, uint32_t duratio
     return true;
 }
 
+bool Expression::prefetchEmoji(const std::string &emoji)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    std::lock_guard lock(_mutex);
+
+    ESP_UTILS_LOGD("Param: emoji(%s)", emoji.c_str());
+    ESP_UTILS_CHECK_FALSE_RETURN(_flags.is_begun, false, "Not begun");
+
+    auto it = _emoji_map.find(emoji);
+    ESP_UTILS_CHECK_FALSE_RETURN(it != _emoji_map.end(), false, "Unknown emoji");
+
+    auto [emotion_type, icon_type] = it->second;
+    if ((_emotion_player != nullptr) && (emotion_type != EMOTION_TYPE_NONE)) {
+        ESP_UTILS_CHECK_FALSE_RETURN(_emotion_player->prefetch(emotion_type), false, "Prefetch emotion failed");
+    }
+    if ((_icon_player != nullptr) && (icon_type != ICON_TYPE_NONE)) {
+        ESP_UTILS_CHECK_FALSE_RETURN(_icon_player->prefetch(icon_type), false, "Prefetch icon failed");
+    }
+
+    return true;
+}
+
+bool Expression::getEmotionStats(gui::AnimFrameCache::Stats &cache_stats, gui::AnimPlayer::StartStats &start_stats)
+{
+    std::lock_guard lock(_mutex);
+
+    ESP_UTILS_CHECK_NULL_RETURN(_emotion_player, false, "Emotion player not enabled");
+
+    cache_stats = _emotion_player->getFrameCacheStats();
+    start_stats = _emotion_player->getStartStats();
+
+    return true;
+}
+
+bool Expression::getIconStats(gui::AnimFrameCache::Stats &cache_stats, gui::AnimPlayer::StartStats &start_stats)
+{
+    std::lock_guard lock(_mutex);
+
+    ESP_UTILS_CHECK_NULL_RETURN(_icon_player, false, "Icon player not enabled");
+
+    cache_stats = _icon_player->getFrameCacheStats();
+    start_stats = _icon_player->getStartStats();
+
+    return true;
+}
+
 bool Expression::setEmoji(
     const std::string &emoji, const AnimOperationConfig &emotion_config, const AnimOperationConfig &icon_config
 )
@@ -309,6 +356,11 @@ bool Expression::setEmotion(EmotionType type, gui::AnimPlayer::Operation operati
         goto end;
     }
 
+    // The animation is queued until the current one finishes its loop, decode it meanwhile
+    if (!immediate && (type != EMOTION_TYPE_NONE)) {
+        ESP_UTILS_CHECK_FALSE_RETURN(_emotion_player->prefetch(type), false, "Prefetch emotion failed");
+    }
+
     ESP_UTILS_CHECK_FALSE_RETURN(_emotion_player->sendEvent({
         .index = type,
         .operation = operation,
@@ -338,6 +390,10 @@ bool Expression::setIcon(IconType type, gui::AnimPlayer::Operation operation, bo
         goto end;
     }
 
+    if (!immediate && (type != ICON_TYPE_NONE)) {
+        ESP_UTILS_CHECK_FALSE_RETURN(_icon_player->prefetch(type), false, "Prefetch icon failed");
+    }
+
     ESP_UTILS_CHECK_FALSE_RETURN(_icon_player->sendEvent({
         .index = type,
         .operation = operation,
@@ -63,6 +63,17 @@ public:
         return setEmoji(emoji, AnimOperationConfig{}, AnimOperationConfig{});
     }
     bool insertEmojiTemporary(const std::string &emoji, uint32_t duration_ms = 1000);
+    /**
+     * @brief Decode the animations of an emoji into the frame cache ahead of time, so a later `setEmoji()` with it
+     *        starts without decoding. Needs `frame_cache.enable_prefetch` in the animation player data.
+     */
+    bool prefetchEmoji(const std::string &emoji);
+    /**
+     * @brief Get the frame cache and start stats of the emotion or icon player, e.g. to check that a prefetched emoji
+     *        starts within one frame period. Fails if the player is not enabled.
+     */
+    bool getEmotionStats(gui::AnimFrameCache::Stats &cache_stats, gui::AnimPlayer::StartStats &start_stats);
+    bool getIconStats(gui::AnimFrameCache::Stats &cache_stats, gui::AnimPlayer::StartStats &start_stats);
     bool setSystemIcon(const std::string &icon, const AnimOperationConfig &config);
     bool setSystemIcon(const std::string &icon)
     {
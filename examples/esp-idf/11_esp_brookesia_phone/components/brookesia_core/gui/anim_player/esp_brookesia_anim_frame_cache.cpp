@@ -0,0 +1,329 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>
+#include <cstring>
+#include "esp_heap_caps.h"
+#include "esp_brookesia_gui_internal.h"
+#if !ESP_BROOKESIA_ANIM_PLAYER_ENABLE_DEBUG_LOG
+#   define ESP_BROOKESIA_UTILS_DISABLE_DEBUG_LOG
+#endif
+#include "private/esp_brookesia_anim_player_utils.hpp"
+#include "esp_brookesia_anim_frame_cache.hpp"
+
+#define REGION_DATA_MEM_CAPS            (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+#define REGION_DATA_MEM_CAPS_FALLBACK   (MALLOC_CAP_DEFAULT | MALLOC_CAP_8BIT)
+
+namespace esp_brookesia::gui {
+
+void AnimFrameCache::RegionDataDeleter::operator()(uint8_t *data) const
+{
+    heap_caps_free(data);
+}
+
+AnimFrameCache::Recorder::~Recorder()
+{
+    if (isRecording()) {
+        abort();
+    }
+}
+
+bool AnimFrameCache::Recorder::start(AnimFrameCache &cache, int index)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    ESP_UTILS_LOGD("Param: index(%d)", index);
+
+    if (isRecording()) {
+        abort();
+    }
+    if (!cache.beginRecording(index)) {
+        return false;
+    }
+
+    _animation = std::make_shared<Animation>();
+    if (_animation == nullptr) {
+        cache.endRecording(index);
+        ESP_UTILS_CHECK_FALSE_RETURN(false, false, "Make animation failed");
+    }
+    _cache = &cache;
+    _index = index;
+
+    return true;
+}
+
+bool AnimFrameCache::Recorder::addRegion(int x1, int y1, int x2, int y2, const void *data, size_t size)
+{
+    if (!isRecording()) {
+        return false;
+    }
+
+    // Count the bookkeeping as well, so the budget is close to the real memory usage
+    size_t reserve_size = size + sizeof(Region);
+    if (!_cache->reserve(reserve_size)) {
+        ESP_UTILS_LOGW("Animation(%d) is too large for the cache budget, stop recording", _index);
+        abort();
+        return false;
+    }
+    _animation->size_bytes += reserve_size;
+
+    auto region_data = static_cast<uint8_t *>(heap_caps_malloc(size, REGION_DATA_MEM_CAPS));
+    if (region_data == nullptr) {
+        region_data = static_cast<uint8_t *>(heap_caps_malloc(size, REGION_DATA_MEM_CAPS_FALLBACK));
+    }
+    if (region_data == nullptr) {
+        ESP_UTILS_LOGE("Allocate region data(%d) failed, stop recording", static_cast<int>(size));
+        abort();
+        return false;
+    }
+    std::memcpy(region_data, data, size);
+
+    _animation->regions.push_back(Region{
+        .x1 = x1,
+        .y1 = y1,
+        .x2 = x2,
+        .y2 = y2,
+        .size = size,
+        .data = std::unique_ptr<uint8_t, RegionDataDeleter>(region_data),
+    });
+
+    return true;
+}
+
+void AnimFrameCache::Recorder::endFrame()
+{
+    if (!isRecording()) {
+        return;
+    }
+
+    _animation->frame_ends.push_back(_animation->regions.size());
+}
+
+bool AnimFrameCache::Recorder::finish()
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    if (!isRecording()) {
+        return false;
+    }
+
+    if (_animation->frame_ends.empty()) {
+        ESP_UTILS_LOGW("Animation(%d) has no frame, drop it", _index);
+        abort();
+        return false;
+    }
+
+    auto cache = _cache;
+    auto index = _index;
+    auto animation = std::move(_animation);
+    _cache = nullptr;
+    _index = -1;
+
+    return cache->commit(index, std::move(animation));
+}
+
+void AnimFrameCache::Recorder::abort()
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    if (!isRecording()) {
+        return;
+    }
+
+    ESP_UTILS_LOGD("Abort recording animation(%d)", _index);
+
+    _cache->release(_animation->size_bytes);
+    _cache->endRecording(_index);
+    {
+        std::lock_guard lock(_cache->_mutex);
+        _cache->_stats.record_abort_count++;
+    }
+    _animation.reset();
+    _cache = nullptr;
+    _index = -1;
+}
+
+bool AnimFrameCache::begin(size_t budget_bytes)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    ESP_UTILS_LOGD("Param: budget_bytes(%d)", static_cast<int>(budget_bytes));
+
+    std::lock_guard lock(_mutex);
+
+    _budget_bytes = budget_bytes;
+    _stats = {};
+
+    return true;
+}
+
+void AnimFrameCache::del()
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    clear();
+
+    std::lock_guard lock(_mutex);
+    _budget_bytes = 0;
+}
+
+void AnimFrameCache::clear()
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    std::lock_guard lock(_mutex);
+
+    for (auto &[index, entry] : _entries) {
+        _used_bytes -= entry.animation->size_bytes;
+    }
+    _entries.clear();
+}
+
+AnimFrameCache::AnimationPtr AnimFrameCache::find(int index)
+{
+    std::lock_guard lock(_mutex);
+
+    auto it = _entries.find(index);
+    if (it == _entries.end()) {
+        _stats.miss_count++;
+        return nullptr;
+    }
+
+    _stats.hit_count++;
+    it->second.last_use = ++_use_counter;
+
+    return it->second.animation;
+}
+
+bool AnimFrameCache::contains(int index)
+{
+    std::lock_guard lock(_mutex);
+
+    return (_entries.find(index) != _entries.end());
+}
+
+AnimFrameCache::Stats AnimFrameCache::getStats()
+{
+    std::lock_guard lock(_mutex);
+
+    auto stats = _stats;
+    stats.used_bytes = _used_bytes;
+    stats.budget_bytes = _budget_bytes;
+    stats.animation_num = _entries.size();
+
+    return stats;
+}
+
+void AnimFrameCache::resetStats()
+{
+    std::lock_guard lock(_mutex);
+
+    _stats = {};
+}
+
+void AnimFrameCache::dumpStats()
+{
+    auto stats = getStats();
+
+    ESP_UTILS_LOGI(
+        "Frame cache: hit(%u), miss(%u), evict(%u), record(%u), record abort(%u), animations(%d), used(%d/%d bytes)",
+        static_cast<unsigned>(stats.hit_count), static_cast<unsigned>(stats.miss_count),
+        static_cast<unsigned>(stats.evict_count), static_cast<unsigned>(stats.record_count),
+        static_cast<unsigned>(stats.record_abort_count), static_cast<int>(stats.animation_num),
+        static_cast<int>(stats.used_bytes), static_cast<int>(stats.budget_bytes)
+    );
+}
+
+bool AnimFrameCache::beginRecording(int index)
+{
+    std::lock_guard lock(_mutex);
+
+    if ((_budget_bytes == 0) || (_entries.find(index) != _entries.end()) ||
+            (_recording_indexes.find(index) != _recording_indexes.end())) {
+        return false;
+    }
+    _recording_indexes.insert(index);
+
+    return true;
+}
+
+void AnimFrameCache::endRecording(int index)
+{
+    std::lock_guard lock(_mutex);
+
+    _recording_indexes.erase(index);
+}
+
+bool AnimFrameCache::reserve(size_t size)
+{
+    std::lock_guard lock(_mutex);
+
+    if (size > _budget_bytes) {
+        return false;
+    }
+    while (_used_bytes + size > _budget_bytes) {
+        if (!evictLeastRecentlyUsed()) {
+            return false;
+        }
+    }
+    _used_bytes += size;
+
+    return true;
+}
+
+void AnimFrameCache::release(size_t size)
+{
+    std::lock_guard lock(_mutex);
+
+    _used_bytes -= std::min(size, _used_bytes);
+}
+
+bool AnimFrameCache::commit(int index, std::shared_ptr<Animation> animation)
+{
+    std::lock_guard lock(_mutex);
+
+    _recording_indexes.erase(index);
+    _entries[index] = Entry{
+        .animation = std::move(animation),
+        .last_use = ++_use_counter,
+    };
+    _stats.record_count++;
+
+    ESP_UTILS_LOGD(
+        "Cached animation(%d): frames(%d), regions(%d), size(%d)", index,
+        static_cast<int>(_entries[index].animation->getFrameNum()),
+        static_cast<int>(_entries[index].animation->regions.size()),
+        static_cast<int>(_entries[index].animation->size_bytes)
+    );
+
+    return true;
+}
+
+bool AnimFrameCache::evictLeastRecentlyUsed()
+{
+    // Called with the mutex held. Animations which are being replayed are skipped, so the budget is not exceeded by
+    // memory which is still in use
+    auto victim = _entries.end();
+    for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+        if (it->second.animation.use_count() > 1) {
+            continue;
+        }
+        if ((victim == _entries.end()) || (it->second.last_use < victim->second.last_use)) {
+            victim = it;
+        }
+    }
+    if (victim == _entries.end()) {
+        return false;
+    }
+
+    ESP_UTILS_LOGD("Evict animation(%d)", victim->first);
+    _used_bytes -= victim->second.animation->size_bytes;
+    _entries.erase(victim);
+    _stats.evict_count++;
+
+    return true;
+}
+
+} // namespace esp_brookesia::gui
@@ -0,0 +1,150 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace esp_brookesia::gui {
+
+/**
+ * @brief A byte-bounded cache of decoded animations.
+ *
+ * The decoder only flushes the regions which changed between two frames, so an animation is stored as the sequence
+ * of flushed regions (pixel data and coordinates) grouped by frame, which is recorded while the animation is decoded
+ * for the first time. Replaying it gives exactly the same output without decoding again. Animations are evicted as a
+ * whole in least-recently-used order.
+ */
+class AnimFrameCache {
+public:
+    struct RegionDataDeleter {
+        void operator()(uint8_t *data) const;
+    };
+
+    struct Region {
+        int x1;
+        int y1;
+        int x2;
+        int y2;
+        size_t size;
+        std::unique_ptr<uint8_t, RegionDataDeleter> data;
+    };
+
+    struct Animation {
+        size_t getFrameNum() const
+        {
+            return frame_ends.size();
+        }
+
+        std::vector<Region> regions;
+        std::vector<size_t> frame_ends;     // Index of the first region after each frame
+        size_t size_bytes = 0;
+    };
+    using AnimationPtr = std::shared_ptr<const Animation>;
+
+    struct Stats {
+        uint32_t hit_count;
+        uint32_t miss_count;
+        uint32_t evict_count;
+        uint32_t record_count;          // Number of animations recorded completely
+        uint32_t record_abort_count;    // Number of recordings dropped (interrupted or over the budget)
+        size_t used_bytes;
+        size_t budget_bytes;
+        size_t animation_num;
+    };
+
+    /**
+     * @brief Records the regions of one animation, not thread-safe. Each decoder uses its own recorder.
+     */
+    class Recorder {
+    public:
+        Recorder() = default;
+        ~Recorder();
+
+        Recorder(const Recorder &) = delete;
+        Recorder &operator=(const Recorder &) = delete;
+
+        /**
+         * @brief Start recording an animation. Fails if the animation is already cached or being recorded by another
+         *        recorder.
+         */
+        bool start(AnimFrameCache &cache, int index);
+        bool addRegion(int x1, int y1, int x2, int y2, const void *data, size_t size);
+        void endFrame();
+        bool finish();
+        void abort();
+
+        bool isRecording() const
+        {
+            return (_animation != nullptr);
+        }
+        int getIndex() const
+        {
+            return _index;
+        }
+
+    private:
+        AnimFrameCache *_cache = nullptr;
+        int _index = -1;
+        std::shared_ptr<Animation> _animation;
+    };
+
+    AnimFrameCache() = default;
+    ~AnimFrameCache() = default;
+
+    AnimFrameCache(const AnimFrameCache &) = delete;
+    AnimFrameCache &operator=(const AnimFrameCache &) = delete;
+
+    bool begin(size_t budget_bytes);
+    void del();
+    void clear();
+
+    /**
+     * @brief Get a cached animation and update the hit/miss statistics
+     *
+     * @return The animation if it is cached, otherwise nullptr. The returned animation stays valid even if it is
+     *         evicted meanwhile, and it is not evicted while held by the caller.
+     */
+    AnimationPtr find(int index);
+    bool contains(int index);
+
+    Stats getStats();
+    void resetStats();
+    void dumpStats();
+
+    bool checkEnabled() const
+    {
+        return (_budget_bytes > 0);
+    }
+
+private:
+    struct Entry {
+        AnimationPtr animation;
+        uint32_t last_use;
+    };
+
+    bool beginRecording(int index);
+    void endRecording(int index);
+    bool reserve(size_t size);
+    void release(size_t size);
+    bool commit(int index, std::shared_ptr<Animation> animation);
+    bool evictLeastRecentlyUsed();
+
+    std::mutex _mutex;
+    size_t _budget_bytes = 0;
+    size_t _used_bytes = 0;
+    uint32_t _use_counter = 0;
+    std::map<int, Entry> _entries;
+    std::set<int> _recording_indexes;
+    Stats _stats = {};
+};
+
+} // namespace esp_brookesia::gui
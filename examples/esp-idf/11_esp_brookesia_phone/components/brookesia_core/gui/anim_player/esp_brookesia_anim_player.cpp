@@ -21,6 +21,19 @@
 #define ANIM_EVENT_THREAD_STACK_SIZE        (10 * 1024)
 #define ANIM_EVENT_THREAD_STACK_CAPS_EXT    (true)
 
+#define ANIM_REPLAY_THREAD_NAME             "anim_replay"
+#define ANIM_REPLAY_THREAD_STACK_SIZE       (4 * 1024)
+#define ANIM_REPLAY_THREAD_STACK_CAPS_EXT   (true)
+
+#define ANIM_PREFETCH_THREAD_NAME           "anim_prefetch"
+#define ANIM_PREFETCH_THREAD_STACK_SIZE     (4 * 1024)
+#define ANIM_PREFETCH_THREAD_STACK_CAPS_EXT (true)
+// The prefetch decoder does not wait for the display, so it only needs to run faster than the animations it prepares
+#define ANIM_PREFETCH_FPS                   (100)
+
+// The decoder outputs RGB565
+#define FRAME_CACHE_PIXEL_SIZE              (2)
+
 namespace fs = std::filesystem;
 
 namespace esp_brookesia::gui {
@@ -90,21 +103,11 @@ bool AnimPlayer::begin(const AnimPlayerData &data)
 
                 auto *self = static_cast<AnimPlayer *>(anim_player_get_user_data(handle));
                 ESP_UTILS_CHECK_NULL_EXIT(self, "Invalid user data");
-                auto &canvas_config = self->_canvas_config;
-
-                ESP_UTILS_CHECK_FALSE_EXIT(
-                    (x1 > 0 || y1 > 0 || x2 <= canvas_config.width),
-                    "Invalid coordinates: (%03d,%03d)-(%03d,%03d)", x1, y1, x2, y2
-                );
 
-                int x_start = x1 + canvas_config.coord_x;
-                int y_start = y1 + canvas_config.coord_y;
-                int width = std::min(x2 - x1, canvas_config.width);
-                int height = std::min(y2 - y1, canvas_config.height);
-                int x_end = std::min(x_start + width, canvas_config.coord_x + canvas_config.width);
-                int y_end = std::min(y_start + height, canvas_config.coord_y + canvas_config.height);
-
-                flush_ready_signal(x_start, y_start, x_end, y_end, data, self);
+                if (self->_recorder.isRecording()) {
+                    self->_recorder.addRegion(x1, y1, x2, y2, data, (x2 - x1) * (y2 - y1) * FRAME_CACHE_PIXEL_SIZE);
+                }
+                self->flushRegion(x1, y1, x2, y2, data);
             },
             .update_cb = [](anim_player_handle_t handle, player_event_t event)
             {
@@ -112,51 +115,18 @@ bool AnimPlayer::begin(const AnimPlayerData &data)
 
                 // ESP_UTILS_LOGD("Param: handle(%p), event(%d)", handle, static_cast<int>(event));
 
-                if ((event != PLAYER_EVENT_ALL_FRAME_DONE) && (event != PLAYER_EVENT_IDLE)) {
-                    return;
-                }
-
                 auto *self = static_cast<AnimPlayer *>(anim_player_get_user_data(handle));
                 ESP_UTILS_CHECK_NULL_EXIT(self, "Invalid user data");
 
-                std::unique_lock<std::mutex> lock(self->_player_mutex);
-
-                if (event == PLAYER_EVENT_ALL_FRAME_DONE) {
-                    self->_player_flags.is_frame_done = true;
+                // Only the first pass of an animation is recorded, an interrupted one is dropped
+                if (event == PLAYER_EVENT_ONE_FRAME_DONE) {
+                    self->_recorder.endFrame();
+                } else if (event == PLAYER_EVENT_ALL_FRAME_DONE) {
+                    self->_recorder.finish();
                 } else if (event == PLAYER_EVENT_IDLE) {
-                    self->_player_state = OperationState::Stop;
-
-                    auto &event_wrapper = self->_current_event;
-                    ESP_UTILS_CHECK_NULL_EXIT(event_wrapper, "Invalid current event");
-
-                    if (event_wrapper->event.operation == Operation::PlayOnceStop) {
-                        ESP_UTILS_LOGD("Animation play once stop: %d", event_wrapper->event.index);
-
-                        if (self->_event_queue.empty() && !self->_player_flags.is_starting) {
-                            self->sendEvent({-1, Operation::Stop, {true, true}}, false);
-                        } else {
-                            if (event_wrapper->promise != nullptr) {
-                                event_wrapper->promise->set_value();
-                            }
-                            event_wrapper.reset();
-                        }
-                    } else {
-                        if (event_wrapper->event.operation == Operation::PlayOncePause) {
-                            ESP_UTILS_LOGD("Animation play once pause: %d", event_wrapper->event.index);
-
-                            self->_player_state = OperationState::Pause;
-                        } else {
-                            ESP_UTILS_LOGD("Animation stop: %d", event_wrapper->event.index);
-                        }
-
-                        if (event_wrapper->promise != nullptr) {
-                            event_wrapper->promise->set_value();
-                        }
-                        event_wrapper.reset();
-                    }
+                    self->_recorder.abort();
                 }
-
-                self->_player_condition.notify_all();
+                self->processPlayerEvent(event);
             },
             .user_data = this,
             .flags = {
@@ -176,6 +146,10 @@ bool AnimPlayer::begin(const AnimPlayerData &data)
     }
 
     _event_thread_need_exit = false;
+    if (data.frame_cache.budget_bytes > 0) {
+        ESP_UTILS_CHECK_FALSE_RETURN(beginFrameCache(data), false, "Failed to begin frame cache");
+    }
+
     {
         esp_utils::thread_config_guard thread_config(esp_utils::ThreadConfig{
             .name = ANIM_EVENT_THREAD_NAME,
@@ -230,14 +204,39 @@ bool AnimPlayer::del()
         _event_thread_need_exit = true;
         _event_cv.notify_all();
     }
+    {
+        std::lock_guard lock(_replay_mutex);
+        _replay_cv.notify_all();
+    }
+    {
+        std::lock_guard lock(_prefetch_mutex);
+        _prefetch_cv.notify_all();
+    }
     if (_event_thread.joinable()) {
         _event_thread.join();
     }
+    if (_replay_thread.joinable()) {
+        _replay_thread.join();
+    }
+    if (_prefetch_thread.joinable()) {
+        _prefetch_thread.join();
+    }
 
     if (_player_handle != nullptr) {
         anim_player_deinit(_player_handle);
         _player_handle = nullptr;
     }
+    if (_prefetch_handle != nullptr) {
+        anim_player_deinit(_prefetch_handle);
+        _prefetch_handle = nullptr;
+    }
+    _recorder.abort();
+    _prefetch_recorder.abort();
+    _frame_cache.del();
+    _replay = {};
+    _is_replay_flushing = false;
+    _prefetch_queue = {};
+    _is_prefetch_idle = true;
 
     if (_assets_handle != nullptr) {
         mmap_assets_del(_assets_handle);
@@ -282,7 +281,7 @@ bool AnimPlayer::sendEvent(const Event &event, bool clear_queue, EventFuture *fu
 
     std::shared_ptr<EventWrapper> event_wrapper = nullptr;
     ESP_UTILS_CHECK_EXCEPTION_RETURN(
-        event_wrapper = std::make_shared<EventWrapper>(EventWrapper{event, promise}), false,
+        event_wrapper = std::make_shared<EventWrapper>(EventWrapper{event, promise, Clock::now()}), false,
         "Failed to create event wrapper"
     );
 
@@ -300,6 +299,15 @@ bool AnimPlayer::notifyFlushFinished() const
 {
     // ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
 
+    {
+        std::lock_guard lock(_replay_mutex);
+        if (_is_replay_flushing) {
+            _is_replay_flushing = false;
+            _replay_cv.notify_all();
+            return true;
+        }
+    }
+
     ESP_UTILS_CHECK_NULL_RETURN(_player_handle, false, "Invalid handle");
 
     anim_player_flush_ready(_player_handle);
@@ -307,6 +315,58 @@ bool AnimPlayer::notifyFlushFinished() const
     return true;
 }
 
+bool AnimPlayer::prefetch(int index)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    ESP_UTILS_LOGD("Param: index(%d)", index);
+
+    if (_prefetch_handle == nullptr) {
+        ESP_UTILS_LOGD("Prefetch is not enabled, skip");
+        return true;
+    }
+    ESP_UTILS_CHECK_VALUE_RETURN(
+        index, 0, static_cast<int>(_animation_configs.size()) - 1, false, "Invalid index: %d", index
+    );
+
+    if (_frame_cache.contains(index)) {
+        ESP_UTILS_LOGD("Animation(%d) already cached", index);
+        return true;
+    }
+
+    std::lock_guard lock(_prefetch_mutex);
+    _prefetch_queue.push(index);
+    _prefetch_cv.notify_all();
+
+    return true;
+}
+
+AnimPlayer::StartStats AnimPlayer::getStartStats()
+{
+    std::lock_guard lock(_start_stats_mutex);
+
+    return _start_stats;
+}
+
+void AnimPlayer::resetStartStats()
+{
+    std::lock_guard lock(_start_stats_mutex);
+
+    _start_stats = {};
+}
+
+void AnimPlayer::dumpStartStats()
+{
+    auto stats = getStartStats();
+
+    ESP_UTILS_LOGI(
+        "Start: count(%u), cached(%u), late(%u), latency last(%u us), max(%u us), max cached(%u us)",
+        static_cast<unsigned>(stats.start_count), static_cast<unsigned>(stats.cached_start_count),
+        static_cast<unsigned>(stats.late_start_count), static_cast<unsigned>(stats.last_latency_us),
+        static_cast<unsigned>(stats.max_latency_us), static_cast<unsigned>(stats.max_cached_latency_us)
+    );
+}
+
 bool AnimPlayer::loadAnimationConfig(const AnimPlayerPartitionConfig &partition_config)
 {
     ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
@@ -458,7 +518,7 @@ bool AnimPlayer::processEvent(std::shared_ptr<EventWrapper> event_wrapper)
             }
 
             ESP_UTILS_LOGD("Update current event[%d] to stop", _current_event->event.index);
-            anim_player_update(_player_handle, PLAYER_ACTION_STOP);
+            stopPlayback();
 
             ESP_UTILS_LOGD("Wait player idle");
             ESP_UTILS_CHECK_FALSE_RETURN(waitPlayerIdle(), false, "Failed to wait player idle");
@@ -485,14 +545,35 @@ bool AnimPlayer::processEvent(std::shared_ptr<EventWrapper> event_wrapper)
             uint32_t end = 0;
             bool is_repeat = (event.operation == Operation::PlayLoop);
 
+            if (_frame_cache.checkEnabled()) {
+                auto animation = _frame_cache.find(index);
+                if (animation != nullptr) {
+                    _player_state = OperationState::Play;
+                    beginStartLatency(*event_wrapper, config.fps, true);
+                    ESP_UTILS_CHECK_FALSE_RETURN(
+                        startReplay(std::move(animation), config.fps, is_repeat), false, "Failed to start replay"
+                    );
+                    ESP_UTILS_LOGI(
+                        "Update animation: %d, cached, fps(%d), is_repeat(%d)", index, config.fps, is_repeat
+                    );
+                    break;
+                }
+                {
+                    std::lock_guard lock(_replay_mutex);
+                    _replay.is_active = false;
+                }
+                _recorder.start(_frame_cache, index);
+            }
+
             ESP_UTILS_LOGD("Animation[%d] set src data start", index);
-            ESP_UTILS_CHECK_ERROR_RETURN(
-                anim_player_set_src_data(_player_handle, config.data_address, config.data_length), false,
-                "Failed to set src data"
-            );
+            if (anim_player_set_src_data(_player_handle, config.data_address, config.data_length) != ESP_OK) {
+                _recorder.abort();
+                ESP_UTILS_CHECK_FALSE_RETURN(false, false, "Failed to set src data");
+            }
             ESP_UTILS_LOGD("Animation[%d] set src data end", index);
 
             _player_state = OperationState::Play;
+            beginStartLatency(*event_wrapper, config.fps, false);
             anim_player_get_segment(_player_handle, &start, &end);
             anim_player_set_segment(_player_handle, start, end, config.fps, is_repeat);
             anim_player_update(_player_handle, PLAYER_ACTION_START);
@@ -527,4 +608,365 @@ bool AnimPlayer::processEvent(std::shared_ptr<EventWrapper> event_wrapper)
     return true;
 }
 
+void AnimPlayer::processPlayerEvent(player_event_t event)
+{
+    if ((event != PLAYER_EVENT_ALL_FRAME_DONE) && (event != PLAYER_EVENT_IDLE)) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(_player_mutex);
+
+    if (event == PLAYER_EVENT_ALL_FRAME_DONE) {
+        _player_flags.is_frame_done = true;
+    } else if (event == PLAYER_EVENT_IDLE) {
+        _player_state = OperationState::Stop;
+
+        auto &event_wrapper = _current_event;
+        ESP_UTILS_CHECK_NULL_EXIT(event_wrapper, "Invalid current event");
+
+        if (event_wrapper->event.operation == Operation::PlayOnceStop) {
+            ESP_UTILS_LOGD("Animation play once stop: %d", event_wrapper->event.index);
+
+            if (_event_queue.empty() && !_player_flags.is_starting) {
+                sendEvent({-1, Operation::Stop, {true, true}}, false);
+            } else {
+                if (event_wrapper->promise != nullptr) {
+                    event_wrapper->promise->set_value();
+                }
+                event_wrapper.reset();
+            }
+        } else {
+            if (event_wrapper->event.operation == Operation::PlayOncePause) {
+                ESP_UTILS_LOGD("Animation play once pause: %d", event_wrapper->event.index);
+
+                _player_state = OperationState::Pause;
+            } else {
+                ESP_UTILS_LOGD("Animation stop: %d", event_wrapper->event.index);
+            }
+
+            if (event_wrapper->promise != nullptr) {
+                event_wrapper->promise->set_value();
+            }
+            event_wrapper.reset();
+        }
+    }
+
+    _player_condition.notify_all();
+}
+
+void AnimPlayer::flushRegion(int x1, int y1, int x2, int y2, const void *data)
+{
+    auto &canvas_config = _canvas_config;
+
+    ESP_UTILS_CHECK_FALSE_EXIT(
+        (x1 > 0 || y1 > 0 || x2 <= canvas_config.width),
+        "Invalid coordinates: (%03d,%03d)-(%03d,%03d)", x1, y1, x2, y2
+    );
+
+    int x_start = x1 + canvas_config.coord_x;
+    int y_start = y1 + canvas_config.coord_y;
+    int width = std::min(x2 - x1, canvas_config.width);
+    int height = std::min(y2 - y1, canvas_config.height);
+    int x_end = std::min(x_start + width, canvas_config.coord_x + canvas_config.width);
+    int y_end = std::min(y_start + height, canvas_config.coord_y + canvas_config.height);
+
+    if (_is_start_pending) {
+        endStartLatency();
+    }
+    flush_ready_signal(x_start, y_start, x_end, y_end, data, this);
+}
+
+bool AnimPlayer::beginFrameCache(const AnimPlayerData &data)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    ESP_UTILS_LOGD(
+        "Param: budget_bytes(%d), enable_prefetch(%d)", static_cast<int>(data.frame_cache.budget_bytes),
+        data.frame_cache.enable_prefetch
+    );
+
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        _frame_cache.begin(data.frame_cache.budget_bytes), false, "Failed to begin frame cache"
+    );
+
+    {
+        esp_utils::thread_config_guard thread_config(esp_utils::ThreadConfig{
+            .name = ANIM_REPLAY_THREAD_NAME,
+            .stack_size = ANIM_REPLAY_THREAD_STACK_SIZE,
+            .stack_in_ext = ANIM_REPLAY_THREAD_STACK_CAPS_EXT,
+        });
+        _replay_thread = boost::thread([this] {
+            ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+            while (!_event_thread_need_exit)
+            {
+                std::unique_lock<std::mutex> lock(_replay_mutex);
+                if (_replay.animation == nullptr) {
+                    _replay_cv.wait_for(lock, std::chrono::milliseconds(THREAD_EXIT_CHECK_INTERVAL_MS));
+                    continue;
+                }
+                auto animation = std::move(_replay.animation);
+                auto fps = _replay.fps;
+                auto is_repeat = _replay.is_repeat;
+                lock.unlock();
+
+                replayAnimation(*animation, fps, is_repeat);
+                // Release the animation before reporting idle, so it can be evicted as soon as it is not played
+                animation.reset();
+                if (_event_thread_need_exit) {
+                    break;
+                }
+                processPlayerEvent(PLAYER_EVENT_IDLE);
+            }
+        });
+    }
+
+    if (!data.frame_cache.enable_prefetch) {
+        return true;
+    }
+
+    anim_player_config_t config = {
+        .flush_cb = [](anim_player_handle_t handle, int x1, int y1, int x2, int y2, const void *data)
+        {
+            auto *self = static_cast<AnimPlayer *>(anim_player_get_user_data(handle));
+            ESP_UTILS_CHECK_NULL_EXIT(self, "Invalid user data");
+
+            // Nothing is displayed, the region is only recorded
+            self->_prefetch_recorder.addRegion(x1, y1, x2, y2, data, (x2 - x1) * (y2 - y1) * FRAME_CACHE_PIXEL_SIZE);
+            anim_player_flush_ready(handle);
+        },
+        .update_cb = [](anim_player_handle_t handle, player_event_t event)
+        {
+            auto *self = static_cast<AnimPlayer *>(anim_player_get_user_data(handle));
+            ESP_UTILS_CHECK_NULL_EXIT(self, "Invalid user data");
+
+            if (event == PLAYER_EVENT_ONE_FRAME_DONE) {
+                self->_prefetch_recorder.endFrame();
+            } else if (event == PLAYER_EVENT_ALL_FRAME_DONE) {
+                self->_prefetch_recorder.finish();
+            } else if (event == PLAYER_EVENT_IDLE) {
+                self->_prefetch_recorder.abort();
+
+                std::lock_guard lock(self->_prefetch_mutex);
+                self->_is_prefetch_idle = true;
+                self->_prefetch_cv.notify_all();
+            }
+        },
+        .user_data = this,
+        .flags = {
+            .swap = static_cast<unsigned char>(data.flags.enable_data_swap_bytes),
+        },
+        .task = {
+            // Lower than the player, so the prefetch never delays the displayed animation
+            .task_priority = std::max(data.task.task_priority - 1, 1),
+            .task_stack = data.task.task_stack,
+            .task_affinity = data.task.task_affinity,
+            .task_stack_caps = static_cast<unsigned>(
+                (data.task.task_stack_in_ext ? MALLOC_CAP_SPIRAM : MALLOC_CAP_DEFAULT) | MALLOC_CAP_8BIT
+            ),
+        },
+    };
+    _prefetch_handle = anim_player_init(&config);
+    ESP_UTILS_CHECK_NULL_RETURN(_prefetch_handle, false, "Failed to create prefetch player");
+
+    {
+        esp_utils::thread_config_guard thread_config(esp_utils::ThreadConfig{
+            .name = ANIM_PREFETCH_THREAD_NAME,
+            .stack_size = ANIM_PREFETCH_THREAD_STACK_SIZE,
+            .stack_in_ext = ANIM_PREFETCH_THREAD_STACK_CAPS_EXT,
+        });
+        _prefetch_thread = boost::thread([this] {
+            ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+            while (!_event_thread_need_exit)
+            {
+                std::unique_lock<std::mutex> lock(_prefetch_mutex);
+                if (_prefetch_queue.empty()) {
+                    _prefetch_cv.wait_for(lock, std::chrono::milliseconds(THREAD_EXIT_CHECK_INTERVAL_MS));
+                    continue;
+                }
+                auto index = _prefetch_queue.front();
+                _prefetch_queue.pop();
+                lock.unlock();
+
+                if (!prefetchAnimation(index)) {
+                    ESP_UTILS_LOGE("Failed to prefetch animation(%d)", index);
+                }
+            }
+        });
+    }
+
+    return true;
+}
+
+void AnimPlayer::stopPlayback()
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    {
+        std::lock_guard lock(_replay_mutex);
+        if (_replay.is_active) {
+            _replay.need_stop = true;
+            _replay_cv.notify_all();
+            return;
+        }
+    }
+
+    anim_player_update(_player_handle, PLAYER_ACTION_STOP);
+}
+
+bool AnimPlayer::startReplay(AnimFrameCache::AnimationPtr animation, int fps, bool is_repeat)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    ESP_UTILS_CHECK_NULL_RETURN(animation, false, "Invalid animation");
+    ESP_UTILS_CHECK_FALSE_RETURN(_replay_thread.joinable(), false, "Replay thread not running");
+
+    std::lock_guard lock(_replay_mutex);
+    _replay.is_active = true;
+    _replay.need_stop = false;
+    _replay.fps = fps;
+    _replay.is_repeat = is_repeat;
+    _replay.animation = std::move(animation);
+    _replay_cv.notify_all();
+
+    return true;
+}
+
+bool AnimPlayer::replayAnimation(const AnimFrameCache::Animation &animation, int fps, bool is_repeat)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    ESP_UTILS_LOGD(
+        "Param: frames(%d), fps(%d), is_repeat(%d)", static_cast<int>(animation.getFrameNum()), fps, is_repeat
+    );
+
+    auto need_stop = [this]() {
+        return _replay.need_stop || _event_thread_need_exit;
+    };
+    auto frame_interval = std::chrono::microseconds(1000000 / std::max(fps, 1));
+    auto next_frame_time = Clock::now();
+
+    do {
+        size_t region_index = 0;
+        for (auto frame_end : animation.frame_ends) {
+            for (; region_index < frame_end; region_index++) {
+                auto &region = animation.regions[region_index];
+                {
+                    std::lock_guard lock(_replay_mutex);
+                    if (need_stop()) {
+                        return false;
+                    }
+                    _is_replay_flushing = true;
+                }
+
+                // The region data is kept by the animation until `notifyFlushFinished()` is called
+                flushRegion(region.x1, region.y1, region.x2, region.y2, region.data.get());
+
+                std::unique_lock<std::mutex> lock(_replay_mutex);
+                while (_is_replay_flushing && !need_stop()) {
+                    _replay_cv.wait_for(lock, std::chrono::milliseconds(THREAD_EXIT_CHECK_INTERVAL_MS));
+                }
+                if (need_stop()) {
+                    _is_replay_flushing = false;
+                    return false;
+                }
+            }
+
+            // Keep the frame rate, but do not try to catch up if the display is slower than the animation
+            auto now = Clock::now();
+            next_frame_time = std::max(next_frame_time + frame_interval, now);
+            std::unique_lock<std::mutex> lock(_replay_mutex);
+            if (_replay_cv.wait_until(lock, next_frame_time, need_stop)) {
+                return false;
+            }
+        }
+        processPlayerEvent(PLAYER_EVENT_ALL_FRAME_DONE);
+    } while (is_repeat);
+
+    return true;
+}
+
+bool AnimPlayer::prefetchAnimation(int index)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    ESP_UTILS_LOGD("Param: index(%d)", index);
+
+    // Skip if cached or being recorded by the player
+    if (!_prefetch_recorder.start(_frame_cache, index)) {
+        ESP_UTILS_LOGD("Animation(%d) no need to prefetch", index);
+        return true;
+    }
+
+    {
+        std::lock_guard lock(_prefetch_mutex);
+        _is_prefetch_idle = false;
+    }
+
+    auto &config = _animation_configs[index];
+    if (anim_player_set_src_data(_prefetch_handle, config.data_address, config.data_length) != ESP_OK) {
+        _prefetch_recorder.abort();
+        std::lock_guard lock(_prefetch_mutex);
+        _is_prefetch_idle = true;
+        ESP_UTILS_CHECK_FALSE_RETURN(false, false, "Failed to set src data");
+    }
+
+    uint32_t start = 0;
+    uint32_t end = 0;
+    anim_player_get_segment(_prefetch_handle, &start, &end);
+    anim_player_set_segment(_prefetch_handle, start, end, ANIM_PREFETCH_FPS, false);
+    anim_player_update(_prefetch_handle, PLAYER_ACTION_START);
+
+    std::unique_lock<std::mutex> lock(_prefetch_mutex);
+    while (!_is_prefetch_idle && !_event_thread_need_exit) {
+        _prefetch_cv.wait_for(lock, std::chrono::milliseconds(THREAD_EXIT_CHECK_INTERVAL_MS));
+    }
+    if (!_is_prefetch_idle) {
+        anim_player_update(_prefetch_handle, PLAYER_ACTION_STOP);
+    }
+    ESP_UTILS_LOGD("Animation(%d) prefetched", index);
+
+    return true;
+}
+
+void AnimPlayer::beginStartLatency(const EventWrapper &event_wrapper, int fps, bool is_cached)
+{
+    std::lock_guard lock(_start_stats_mutex);
+
+    _start_pending.send_time = event_wrapper.send_time;
+    _start_pending.frame_period_us = 1000000 / std::max(fps, 1);
+    _start_pending.is_cached = is_cached;
+    _is_start_pending = true;
+}
+
+void AnimPlayer::endStartLatency()
+{
+    std::lock_guard lock(_start_stats_mutex);
+
+    // Only the first region flushed after the play event is counted
+    if (!_is_start_pending.exchange(false)) {
+        return;
+    }
+
+    auto latency_us = static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - _start_pending.send_time).count()
+    );
+    auto &stats = _start_stats;
+    stats.start_count++;
+    stats.last_latency_us = latency_us;
+    stats.max_latency_us = std::max(stats.max_latency_us, latency_us);
+    if (_start_pending.is_cached) {
+        stats.cached_start_count++;
+        stats.max_cached_latency_us = std::max(stats.max_cached_latency_us, latency_us);
+    }
+    if (latency_us > static_cast<uint32_t>(_start_pending.frame_period_us)) {
+        stats.late_start_count++;
+        ESP_UTILS_LOGD(
+            "Late start: %u us, frame period %d us, cached(%d)", static_cast<unsigned>(latency_us),
+            _start_pending.frame_period_us, _start_pending.is_cached
+        );
+    }
+}
+
 } // namespace esp_brookesia::gui
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <future>
 #include <mutex>
@@ -16,6 +17,7 @@
 #include "boost/thread.hpp"
 #include "esp_mmap_assets.h"
 #include "anim_player.h"
+#include "esp_brookesia_anim_frame_cache.hpp"
 
 namespace esp_brookesia::gui {
 
@@ -71,6 +73,10 @@ struct AnimPlayerData {
     struct {
         int enable_data_swap_bytes: 1;
     } flags;
+    struct {
+        size_t budget_bytes;        // Memory budget of the decoded animations, 0 means the cache is disabled
+        bool enable_prefetch;       // Create an extra decoder to fill the cache by `AnimPlayer::prefetch()`
+    } frame_cache;
 };
 
 class AnimPlayer {
@@ -109,6 +115,18 @@ public:
 
     using EventFuture = std::future<void>;
 
+    /**
+     * @brief Time from a play event sent to the first region of the animation flushed
+     */
+    struct StartStats {
+        uint32_t start_count;
+        uint32_t cached_start_count;    // Number of animations started from the frame cache
+        uint32_t late_start_count;      // Number of animations started later than one frame period
+        uint32_t last_latency_us;
+        uint32_t max_latency_us;
+        uint32_t max_cached_latency_us;
+    };
+
     using FlushReadySignal = boost::signals2::signal <
                              void(int x_start, int y_start, int x_end, int y_end, const void *data, AnimPlayer *player)
                              >;
@@ -132,14 +150,42 @@ public:
 
     bool notifyFlushFinished() const;
 
+    /**
+     * @brief Decode an animation into the frame cache in the background, so it starts without decoding when it is
+     *        played. Does nothing if the animation is already cached or `frame_cache.enable_prefetch` is not set.
+     *
+     * @param[in] index  Animation index
+     *
+     * @return true if success or nothing to do, otherwise false
+     */
+    bool prefetch(int index);
+
+    AnimFrameCache::Stats getFrameCacheStats()
+    {
+        return _frame_cache.getStats();
+    }
+    void resetFrameCacheStats()
+    {
+        _frame_cache.resetStats();
+    }
+    void dumpFrameCacheStats()
+    {
+        _frame_cache.dumpStats();
+    }
+    StartStats getStartStats();
+    void resetStartStats();
+    void dumpStartStats();
+
     static FlushReadySignal flush_ready_signal;
     static AnimationStopSignal animation_stop_signal;
 
 private:
     using EventPromise = std::promise<void>;
+    using Clock = std::chrono::steady_clock;
     struct EventWrapper {
         Event event;
         std::shared_ptr<EventPromise> promise;
+        Clock::time_point send_time;
     };
 
     bool loadAnimationConfig(const AnimPlayerPartitionConfig &partition_config);
@@ -149,6 +195,15 @@ private:
     bool waitPlayerIdle();
     bool waitPlayerState(OperationState state);
     bool processEvent(std::shared_ptr<EventWrapper> event_wrapper);
+    void processPlayerEvent(player_event_t event);
+    void flushRegion(int x1, int y1, int x2, int y2, const void *data);
+    bool beginFrameCache(const AnimPlayerData &data);
+    void stopPlayback();
+    bool startReplay(AnimFrameCache::AnimationPtr animation, int fps, bool is_repeat);
+    bool replayAnimation(const AnimFrameCache::Animation &animation, int fps, bool is_repeat);
+    bool prefetchAnimation(int index);
+    void beginStartLatency(const EventWrapper &event_wrapper, int fps, bool is_cached);
+    void endStartLatency();
 
     bool _is_begun = false;
     AnimPlayerCanvasConfig _canvas_config = {};
@@ -171,6 +226,42 @@ private:
     std::condition_variable _player_condition;
     anim_player_handle_t _player_handle = nullptr;
     mmap_assets_handle_t _assets_handle = nullptr;
+
+    // Frame cache, the recorder is only used by the player task
+    AnimFrameCache _frame_cache;
+    AnimFrameCache::Recorder _recorder;
+
+    // Replay of cached animations, which replaces the player while `is_active` is set
+    struct {
+        bool is_active;
+        bool need_stop;
+        int fps;
+        bool is_repeat;
+        AnimFrameCache::AnimationPtr animation;
+    } _replay = {};
+    boost::thread _replay_thread;
+    mutable bool _is_replay_flushing = false;  // Set by the replay thread, cleared by `notifyFlushFinished()`
+    mutable std::mutex _replay_mutex;
+    mutable std::condition_variable _replay_cv;
+
+    // Prefetch, uses another player instance which decodes without flushing
+    AnimFrameCache::Recorder _prefetch_recorder;
+    anim_player_handle_t _prefetch_handle = nullptr;
+    boost::thread _prefetch_thread;
+    std::queue<int> _prefetch_queue;
+    bool _is_prefetch_idle = true;
+    std::mutex _prefetch_mutex;
+    std::condition_variable _prefetch_cv;
+
+    // Start latency, measured by the first flush after a play event
+    std::atomic<bool> _is_start_pending = false;
+    struct {
+        Clock::time_point send_time;
+        int frame_period_us;
+        bool is_cached;
+    } _start_pending = {};
+    StartStats _start_stats = {};
+    std::mutex _start_stats_mutex;
 };
 
 } // namespace esp_brookesia::gui
@@ -107,6 +107,29 @@
 #           define ESP_BROOKESIA_LVGL_TIMER_ENABLE_DEBUG_LOG  (0)
 #       endif
 #   endif
+#   if !defined(ESP_BROOKESIA_LVGL_TRANSITION_ENABLE_DEBUG_LOG)
+#       if defined(CONFIG_ESP_BROOKESIA_LVGL_TRANSITION_ENABLE_DEBUG_LOG)
+#           define ESP_BROOKESIA_LVGL_TRANSITION_ENABLE_DEBUG_LOG  CONFIG_ESP_BROOKESIA_LVGL_TRANSITION_ENABLE_DEBUG_LOG
+#       else
+#           define ESP_BROOKESIA_LVGL_TRANSITION_ENABLE_DEBUG_LOG  (0)
+#       endif
+#   endif
+#endif
+
+#if !defined(ESP_BROOKESIA_LVGL_LOCK_ENABLE_METRICS)
+#   if defined(CONFIG_ESP_BROOKESIA_LVGL_LOCK_ENABLE_METRICS)
+#       define ESP_BROOKESIA_LVGL_LOCK_ENABLE_METRICS  CONFIG_ESP_BROOKESIA_LVGL_LOCK_ENABLE_METRICS
+#   else
+#       define ESP_BROOKESIA_LVGL_LOCK_ENABLE_METRICS  (0)
+#   endif
+#endif
+
+#if !defined(ESP_BROOKESIA_LVGL_LOCK_DEADLOCK_REPORT_MS)
+#   if defined(CONFIG_ESP_BROOKESIA_LVGL_LOCK_DEADLOCK_REPORT_MS)
+#       define ESP_BROOKESIA_LVGL_LOCK_DEADLOCK_REPORT_MS  CONFIG_ESP_BROOKESIA_LVGL_LOCK_DEADLOCK_REPORT_MS
+#   else
+#       define ESP_BROOKESIA_LVGL_LOCK_DEADLOCK_REPORT_MS  (5000)
+#   endif
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -11,5 +11,7 @@
 #include "esp_brookesia_lv_helper.hpp"
 #include "esp_brookesia_lv_lock.hpp"
 #include "esp_brookesia_lv_object.hpp"
+#include "esp_brookesia_lv_object_pool.hpp"
 #include "esp_brookesia_lv_screen.hpp"
 #include "esp_brookesia_lv_timer.hpp"
+#include "esp_brookesia_lv_transition.hpp"
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <string>
 #include <cmath>
+#include <vector>
 #include "esp_brookesia_gui_internal.h"
 #if !ESP_BROOKESIA_LVGL_HELPER_ENABLE_DEBUG_LOG
 #   define ESP_BROOKESIA_UTILS_DISABLE_DEBUG_LOG
@@ -21,6 +22,42 @@
 
 namespace esp_brookesia::gui {
 
+namespace {
+
+struct ScaleStep {
+    uint32_t offset;        // Offset of the first source sample
+    uint32_t next_offset;   // Offset of the second source sample
+    uint32_t weight;        // Weight of the second sample, out of 256
+};
+
+/**
+ * @brief Map the centers of the destination pixels to the source, in 16.16 fixed point
+ */
+void computeScaleSteps(int src_len, int dst_len, uint32_t unit, std::vector<ScaleStep> &steps)
+{
+    int64_t step = (static_cast<int64_t>(src_len) << 16) / dst_len;
+    int64_t pos = step / 2 - (1 << 15);
+    int64_t pos_max = static_cast<int64_t>(src_len - 1) << 16;
+
+    steps.resize(dst_len);
+    for (int i = 0; i < dst_len; i++, pos += step) {
+        int64_t clamped_pos = std::clamp<int64_t>(pos, 0, pos_max);
+        uint32_t index = static_cast<uint32_t>(clamped_pos >> 16);
+        uint32_t next_index = std::min<uint32_t>(index + 1, src_len - 1);
+        steps[i] = {index * unit, next_index * unit, static_cast<uint32_t>((clamped_pos & 0xFFFF) >> 8)};
+    }
+}
+
+inline uint32_t blendBilinear(uint32_t c00, uint32_t c01, uint32_t c10, uint32_t c11, uint32_t wx, uint32_t wy)
+{
+    uint32_t top = c00 * (256 - wx) + c01 * wx;
+    uint32_t bottom = c10 * (256 - wx) + c11 * wx;
+
+    return (top * (256 - wy) + bottom * wy) >> 16;
+}
+
+} // namespace
+
 lv_color_t toLvColor(uint32_t color)
 {
     return lv_color_hex(color);
@@ -285,6 +322,105 @@ lv_indev_t *getLvInputDev(const lv_display_t *display, lv_indev_type_t type)
     return indev;
 }
 
+void initLvBufferLayer(lv_layer_t *layer, lv_draw_buf_t *draw_buf)
+{
+    lv_area_t buf_area = {0, 0, (int32_t)draw_buf->header.w - 1, (int32_t)draw_buf->header.h - 1};
+
+    lv_layer_init(layer);
+    layer->draw_buf = draw_buf;
+    layer->color_format = static_cast<lv_color_format_t>(draw_buf->header.cf);
+    layer->buf_area = buf_area;
+    layer->_clip_area = buf_area;
+    layer->phy_clip_area = buf_area;
+}
+
+bool finishLvBufferLayer(lv_layer_t *layer)
+{
+    lv_display_t *display = lv_display_get_default();
+    ESP_UTILS_CHECK_NULL_RETURN(display, false, "No default display");
+
+    while (layer->draw_task_head != nullptr) {
+        lv_draw_dispatch_wait_for_request();
+        if (!lv_draw_dispatch_layer(display, layer)) {
+            lv_draw_wait_for_finish();
+            lv_draw_dispatch_request();
+        }
+    }
+
+    return true;
+}
+
+bool scaleLvImage(const lv_image_dsc_t *src, lv_draw_buf_t *dst)
+{
+    ESP_UTILS_CHECK_NULL_RETURN(src, false, "Invalid source");
+    ESP_UTILS_CHECK_NULL_RETURN(dst, false, "Invalid destination");
+    ESP_UTILS_CHECK_FALSE_RETURN(src->header.cf == dst->header.cf, false, "Color formats differ");
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        (src->header.w > 0) && (src->header.h > 0) && (dst->header.w > 0) && (dst->header.h > 0), false, "Empty image"
+    );
+
+    uint32_t pixel_size = 0;
+    switch (src->header.cf) {
+    case LV_COLOR_FORMAT_RGB565:
+        pixel_size = 2;
+        break;
+    case LV_COLOR_FORMAT_RGB888:
+        pixel_size = 3;
+        break;
+    case LV_COLOR_FORMAT_XRGB8888:
+    case LV_COLOR_FORMAT_ARGB8888:
+        pixel_size = 4;
+        break;
+    default:
+        ESP_UTILS_CHECK_FALSE_RETURN(false, false, "Unsupported color format(%d)", (int)src->header.cf);
+    }
+    uint32_t src_stride = (src->header.stride > 0) ? src->header.stride : src->header.w * pixel_size;
+    uint32_t dst_stride = dst->header.stride;
+
+    std::vector<ScaleStep> x_steps;
+    std::vector<ScaleStep> y_steps;
+    computeScaleSteps(src->header.w, dst->header.w, pixel_size, x_steps);
+    computeScaleSteps(src->header.h, dst->header.h, src_stride, y_steps);
+
+    for (uint32_t y = 0; y < dst->header.h; y++) {
+        const ScaleStep &y_step = y_steps[y];
+        const uint8_t *row0 = src->data + y_step.offset;
+        const uint8_t *row1 = src->data + y_step.next_offset;
+        uint8_t *dst_row = dst->data + y * dst_stride;
+
+        if (pixel_size == 2) {
+            auto dst_pixels = reinterpret_cast<uint16_t *>(dst_row);
+            for (uint32_t x = 0; x < dst->header.w; x++) {
+                const ScaleStep &x_step = x_steps[x];
+                uint16_t c00 = *reinterpret_cast<const uint16_t *>(row0 + x_step.offset);
+                uint16_t c01 = *reinterpret_cast<const uint16_t *>(row0 + x_step.next_offset);
+                uint16_t c10 = *reinterpret_cast<const uint16_t *>(row1 + x_step.offset);
+                uint16_t c11 = *reinterpret_cast<const uint16_t *>(row1 + x_step.next_offset);
+                uint32_t r = blendBilinear(c00 >> 11, c01 >> 11, c10 >> 11, c11 >> 11, x_step.weight, y_step.weight);
+                uint32_t g = blendBilinear(
+                                 (c00 >> 5) & 0x3F, (c01 >> 5) & 0x3F, (c10 >> 5) & 0x3F, (c11 >> 5) & 0x3F, x_step.weight,
+                                 y_step.weight
+                             );
+                uint32_t b = blendBilinear(c00 & 0x1F, c01 & 0x1F, c10 & 0x1F, c11 & 0x1F, x_step.weight, y_step.weight);
+                dst_pixels[x] = static_cast<uint16_t>((r << 11) | (g << 5) | b);
+            }
+            continue;
+        }
+        for (uint32_t x = 0; x < dst->header.w; x++) {
+            const ScaleStep &x_step = x_steps[x];
+            for (uint32_t i = 0; i < pixel_size; i++) {
+                dst_row[x * pixel_size + i] = static_cast<uint8_t>(blendBilinear(
+                                                  row0[x_step.offset + i], row0[x_step.next_offset + i],
+                                                  row1[x_step.offset + i], row1[x_step.next_offset + i], x_step.weight,
+                                                  y_step.weight
+                                              ));
+            }
+        }
+    }
+
+    return true;
+}
+
 lv_anim_path_cb_t getLvAnimPathCb(StyleAnimation::AnimationPathType type)
 {
     ESP_UTILS_CHECK_FALSE_RETURN(
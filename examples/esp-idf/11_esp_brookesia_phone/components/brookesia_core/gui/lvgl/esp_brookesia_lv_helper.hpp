@@ -70,6 +70,21 @@ bool getLvInternalFontBySize(uint8_t size_px, const lv_font_t **font);
 lv_color_t getLvRandomColor(void);
 lv_indev_t *getLvInputDev(const lv_display_t *display, lv_indev_type_t type);
 lv_anim_path_cb_t getLvAnimPathCb(esp_brookesia::gui::StyleAnimation::AnimationPathType type);
+
+/**
+ * @brief Draw into a buffer outside of the display refresh, like `lv_canvas_init_layer()` and
+ *        `lv_canvas_finish_layer()` without a canvas object. `finishLvBufferLayer()` returns when all the draw tasks
+ *        are done.
+ */
+void initLvBufferLayer(lv_layer_t *layer, lv_draw_buf_t *draw_buf);
+bool finishLvBufferLayer(lv_layer_t *layer);
+
+/**
+ * @brief Scale an image into `dst` once, so it can be drawn at scale 1:1 instead of being transformed at every frame.
+ *        It is bilinear, with the source offsets and weights of each row and column computed before the pixels.
+ *        `dst` has the size of the result and the color format of `src`: RGB565, RGB888, XRGB8888 or ARGB8888.
+ */
+bool scaleLvImage(const lv_image_dsc_t *src, lv_draw_buf_t *dst);
 } // namespace esp_brookesia::gui
 
 #define ESP_BROOKESIA_MAKE_LV_OBJ_PTR(type, parent) \
@@ -3,6 +3,8 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <algorithm>
+#include <cstring>
 #include "esp_brookesia_gui_internal.h"
 #if !ESP_BROOKESIA_LVGL_LOCK_ENABLE_DEBUG_LOG
 #   define ESP_BROOKESIA_UTILS_DISABLE_DEBUG_LOG
@@ -25,18 +27,59 @@ void LvLock::registerCallbacks(LockCallback lock_cb, UnlockCallback unlock_cb)
     auto &inst = getInstance();
     inst.lock_cb_ = std::move(lock_cb);
     inst.unlock_cb_ = std::move(unlock_cb);
+
+    LvLockGuard gui_guard;
+    if (inst.post_timer_ == nullptr) {
+        inst.createPostTimer();
+    }
 }
 
-bool LvLock::lock(int timeout_ms)
+void LvLock::unregisterCallbacks()
 {
     ESP_UTILS_LOG_TRACE_GUARD();
 
-    ESP_UTILS_LOGD("Param: timeout_ms(%d)", timeout_ms);
+    auto &inst = getInstance();
+    if (!inst.lock_cb_) {
+        return;
+    }
+
+    {
+        LvLockGuard gui_guard;
+        inst.deletePostTimer();
+    }
+    inst.lock_cb_ = nullptr;
+    inst.unlock_cb_ = nullptr;
+}
+
+bool LvLock::lock(int timeout_ms, const char *call_site)
+{
+    ESP_UTILS_LOG_TRACE_GUARD();
+
+    ESP_UTILS_LOGD("Param: timeout_ms(%d), call_site(%s)", timeout_ms, call_site);
 
     ESP_UTILS_CHECK_FALSE_RETURN(lock_cb_.operator bool(), false, "Lock callback not registered");
-    ESP_UTILS_CHECK_FALSE_RETURN(lock_cb_(timeout_ms), false, "Lock callback failed");
-    lock_count_++;
-    ESP_UTILS_LOGD("Locked count: %d", static_cast<int>(lock_count_));
+
+    // Re-entry from the owner thread, no need to call the backend again
+    if (isLockedByCurrentThread()) {
+        owner_depth_++;
+        recordLock(call_site, true, false, 0);
+        ESP_UTILS_LOGD("Locked depth: %d", static_cast<int>(owner_depth_));
+        return true;
+    }
+
+    auto wait_start = Clock::now();
+    bool is_locked = lockBackend(timeout_ms, call_site);
+    auto lock_time = Clock::now();
+    auto wait_us = std::chrono::duration_cast<std::chrono::microseconds>(lock_time - wait_start).count();
+    recordLock(call_site, false, !is_locked, static_cast<uint32_t>(wait_us));
+    ESP_UTILS_CHECK_FALSE_RETURN(is_locked, false, "Lock callback failed");
+
+    owner_ = std::this_thread::get_id();
+    owner_depth_ = 1;
+    owner_call_site_ = call_site;
+    owner_lock_time_us_ = std::chrono::duration_cast<std::chrono::microseconds>(lock_time.time_since_epoch()).count();
+    owner_generation_++;
+    ESP_UTILS_LOGD("Locked depth: %d", static_cast<int>(owner_depth_));
 
     return true;
 }
@@ -46,20 +89,275 @@ bool LvLock::unlock()
     ESP_UTILS_LOG_TRACE_GUARD();
 
     ESP_UTILS_CHECK_FALSE_RETURN(unlock_cb_.operator bool(), false, "Unlock callback not registered");
+    ESP_UTILS_CHECK_FALSE_RETURN(isLockedByCurrentThread(), false, "Not locked by current thread");
+
+    if (--owner_depth_ > 0) {
+        ESP_UTILS_LOGD("Locked depth: %d", static_cast<int>(owner_depth_));
+        return true;
+    }
+
+    auto now_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()).count();
+    auto hold_us = now_us - owner_lock_time_us_.load();
+    const char *call_site = owner_call_site_.load();
+    owner_call_site_ = nullptr;
+    owner_ = std::thread::id();
     ESP_UTILS_CHECK_FALSE_RETURN(unlock_cb_(), false, "Unlock callback failed");
-    if (lock_count_ > 0) {
-        lock_count_--;
+    recordHold(call_site, static_cast<uint32_t>(hold_us));
+    ESP_UTILS_LOGD("Locked depth: 0");
+
+    return true;
+}
+
+bool LvLock::post(PostFunction fn)
+{
+    ESP_UTILS_LOG_TRACE_GUARD();
+
+    ESP_UTILS_CHECK_FALSE_RETURN(fn.operator bool(), false, "Invalid function");
+
+    auto &inst = getInstance();
+    {
+        std::lock_guard<std::mutex> lock(inst.post_mutex_);
+        ESP_UTILS_CHECK_NULL_RETURN(inst.post_timer_, false, "Post timer not created, register the callbacks first");
+        inst.post_queue_.push_back(std::move(fn));
     }
-    ESP_UTILS_LOGD("Locked count: %d", static_cast<int>(lock_count_));
+    inst.post_pending_ = true;
 
     return true;
 }
 
-LvLockGuard::LvLockGuard()
+std::vector<LvLock::CallSiteStats> LvLock::getStats()
+{
+#if ESP_BROOKESIA_LVGL_LOCK_ENABLE_METRICS
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return std::vector<CallSiteStats>(stats_.begin(), stats_.begin() + stats_num_);
+#else
+    return {};
+#endif
+}
+
+void LvLock::resetStats()
+{
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_num_ = 0;
+}
+
+void LvLock::dumpStats()
+{
+#if ESP_BROOKESIA_LVGL_LOCK_ENABLE_METRICS
+    auto stats = getStats();
+    std::sort(stats.begin(), stats.end(), [](const CallSiteStats & a, const CallSiteStats & b) {
+        return a.wait_max_us > b.wait_max_us;
+    });
+
+    ESP_UTILS_LOGI("LVGL lock stats (%d call sites), histogram bounds(us): <100/<1k/<5k/<10k/<50k/<100k/<500k/>=500k",
+                   static_cast<int>(stats.size()));
+    for (auto &s : stats) {
+        ESP_UTILS_LOGI(
+            "%s: lock(%u), reentry(%u), timeout(%u), deadlock report(%u), wait max(%uus) [%u/%u/%u/%u/%u/%u/%u/%u], "
+            "hold max(%uus) [%u/%u/%u/%u/%u/%u/%u/%u]", s.call_site, s.lock_count, s.reentry_count,
+            s.timeout_count, s.deadlock_report_count, s.wait_max_us, s.wait_histogram[0], s.wait_histogram[1],
+            s.wait_histogram[2], s.wait_histogram[3], s.wait_histogram[4], s.wait_histogram[5], s.wait_histogram[6],
+            s.wait_histogram[7],
+            s.hold_max_us, s.hold_histogram[0], s.hold_histogram[1], s.hold_histogram[2], s.hold_histogram[3],
+            s.hold_histogram[4], s.hold_histogram[5], s.hold_histogram[6], s.hold_histogram[7]
+        );
+    }
+#else
+    ESP_UTILS_LOGW("Metrics are disabled, enable `CONFIG_ESP_BROOKESIA_LVGL_LOCK_ENABLE_METRICS` first");
+#endif
+}
+
+bool LvLock::lockBackend(int timeout_ms, const char *call_site)
+{
+    const int report_ms = ESP_BROOKESIA_LVGL_LOCK_DEADLOCK_REPORT_MS;
+
+    if ((report_ms <= 0) || ((timeout_ms >= 0) && (timeout_ms <= report_ms))) {
+        return lock_cb_(timeout_ms);
+    }
+
+    // Wait in slices, so a wait which is long enough to be a deadlock can be reported while still waiting
+    auto wait_start = Clock::now();
+    auto report_start = wait_start;
+    uint32_t generation = owner_generation_.load();
+    while (true) {
+        auto slice_start = Clock::now();
+        int waited_ms = static_cast<int>(
+                            std::chrono::duration_cast<std::chrono::milliseconds>(slice_start - wait_start).count()
+                        );
+        int slice_ms = (timeout_ms < 0) ? report_ms : std::clamp(timeout_ms - waited_ms, 0, report_ms);
+        if (lock_cb_(slice_ms)) {
+            return true;
+        }
+
+        auto now = Clock::now();
+        waited_ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(now - wait_start).count());
+        if ((timeout_ms >= 0) && (waited_ms >= timeout_ms)) {
+            return false;
+        }
+        // Another thread took the lock in the meantime, so the lock is contended rather than stuck
+        uint32_t new_generation = owner_generation_.load();
+        if (new_generation != generation) {
+            generation = new_generation;
+            report_start = now;
+            continue;
+        }
+        // Nobody holds the lock through `LvLock` and the backend gave up before its timeout, it is an error
+        auto slice_end = slice_start + std::chrono::milliseconds(slice_ms - BACKEND_TIMEOUT_TOLERANCE_MS);
+        if ((owner_.load() == std::thread::id()) && (now < slice_end)) {
+            return false;
+        }
+        if (now - report_start >= std::chrono::milliseconds(report_ms)) {
+            report_start = now;
+            reportPossibleDeadlock(call_site, static_cast<uint32_t>(waited_ms));
+        }
+    }
+}
+
+void LvLock::reportPossibleDeadlock(const char *call_site, uint32_t waited_ms)
+{
+#if ESP_BROOKESIA_LVGL_LOCK_ENABLE_METRICS
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        auto stats = getCallSiteStats(call_site);
+        if (stats != nullptr) {
+            stats->deadlock_report_count++;
+        }
+    }
+#endif
+
+    const char *owner_call_site = owner_call_site_.load();
+    if (owner_call_site == nullptr) {
+        // The lock is held outside `LvLock`, e.g. by the LVGL task itself while running timers
+        ESP_UTILS_LOGW(
+            "Possible deadlock: `%s` has waited for %ums, the owner is unknown (held outside LvLock)", call_site, waited_ms
+        );
+        return;
+    }
+
+    auto now_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()).count();
+    auto held_ms = (now_us - owner_lock_time_us_.load()) / 1000;
+    ESP_UTILS_LOGW(
+        "Possible deadlock: `%s` has waited for %ums, the lock is held by `%s` (thread hash: 0x%x) for %dms",
+        call_site, waited_ms, owner_call_site, static_cast<unsigned>(std::hash<std::thread::id>()(owner_.load())),
+        static_cast<int>(held_ms)
+    );
+}
+
+void LvLock::recordLock(const char *call_site, bool is_reentry, bool is_timeout, uint32_t wait_us)
+{
+#if ESP_BROOKESIA_LVGL_LOCK_ENABLE_METRICS
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    auto stats = getCallSiteStats(call_site);
+    if (stats == nullptr) {
+        return;
+    }
+
+    if (is_reentry) {
+        stats->reentry_count++;
+        return;
+    }
+    if (is_timeout) {
+        stats->timeout_count++;
+    } else {
+        stats->lock_count++;
+    }
+    stats->wait_max_us = std::max(stats->wait_max_us, wait_us);
+    stats->wait_histogram[getHistogramBucket(wait_us)]++;
+#endif
+}
+
+void LvLock::recordHold(const char *call_site, uint32_t hold_us)
+{
+#if ESP_BROOKESIA_LVGL_LOCK_ENABLE_METRICS
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    auto stats = getCallSiteStats(call_site);
+    if (stats == nullptr) {
+        return;
+    }
+
+    stats->hold_max_us = std::max(stats->hold_max_us, hold_us);
+    stats->hold_histogram[getHistogramBucket(hold_us)]++;
+#endif
+}
+
+LvLock::CallSiteStats *LvLock::getCallSiteStats(const char *call_site)
+{
+    if (call_site == nullptr) {
+        call_site = "unknown";
+    }
+
+    // Call sites are string literals, compare the pointers first and the content only as a fallback
+    for (size_t i = 0; i < stats_num_; i++) {
+        if ((stats_[i].call_site == call_site) || (strcmp(stats_[i].call_site, call_site) == 0)) {
+            return &stats_[i];
+        }
+    }
+    if (stats_num_ >= stats_.size()) {
+        return nullptr;
+    }
+
+    auto &stats = stats_[stats_num_++];
+    stats = {};
+    stats.call_site = call_site;
+
+    return &stats;
+}
+
+void LvLock::createPostTimer()
+{
+    // Called with the lock held, so it is safe to create the LVGL timer here
+    auto timer = lv_timer_create(onPostTimerCallback, POST_TIMER_PERIOD_MS, this);
+    ESP_UTILS_CHECK_NULL_EXIT(timer, "Create post timer failed");
+
+    std::lock_guard<std::mutex> lock(post_mutex_);
+    post_timer_ = timer;
+}
+
+void LvLock::deletePostTimer()
+{
+    // Called with the lock held, the timer callback can not run meanwhile
+    lv_timer_t *timer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(post_mutex_);
+        std::swap(timer, post_timer_);
+        post_queue_.clear();
+        post_pending_ = false;
+    }
+    if (timer != nullptr) {
+        lv_timer_delete(timer);
+    }
+}
+
+size_t LvLock::getHistogramBucket(uint32_t time_us)
+{
+    auto it = std::upper_bound(HISTOGRAM_BOUNDS_US.begin(), HISTOGRAM_BOUNDS_US.end(), time_us);
+
+    return static_cast<size_t>(it - HISTOGRAM_BOUNDS_US.begin());
+}
+
+void LvLock::onPostTimerCallback(lv_timer_t *t)
+{
+    auto inst = static_cast<LvLock *>(lv_timer_get_user_data(t));
+    if ((inst == nullptr) || !inst->post_pending_) {
+        return;
+    }
+
+    std::deque<PostFunction> post_queue;
+    {
+        std::lock_guard<std::mutex> lock(inst->post_mutex_);
+        post_queue.swap(inst->post_queue_);
+        inst->post_pending_ = false;
+    }
+    for (auto &fn : post_queue) {
+        fn();
+    }
+}
+
+LvLockGuard::LvLockGuard(const char *call_site)
 {
     ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
 
-    locked_ = LvLock::getInstance().lock();
+    locked_ = LvLock::getInstance().lock(-1, call_site);
 }
 
 LvLockGuard::~LvLockGuard()
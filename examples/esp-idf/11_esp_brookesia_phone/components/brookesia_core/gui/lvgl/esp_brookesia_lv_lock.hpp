@@ -5,8 +5,15 @@
  */
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <deque>
 #include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "lvgl.h"
 
 namespace esp_brookesia::gui {
 
@@ -14,27 +21,130 @@ class LvLock {
 public:
     using LockCallback = std::function<bool(int timeout_ms)>;
     using UnlockCallback = std::function<bool()>;
+    using PostFunction = std::function<void()>;
 
-    bool lock(int timeout_ms = -1);
+    /**
+     * @brief Upper bounds (in microseconds) of the wait/hold time histogram buckets, the last bucket has no bound
+     */
+    static constexpr std::array<uint32_t, 7> HISTOGRAM_BOUNDS_US = {
+        100, 1000, 5000, 10000, 50000, 100000, 500000
+    };
+    static constexpr size_t HISTOGRAM_BUCKET_NUM = HISTOGRAM_BOUNDS_US.size() + 1;
+    static constexpr size_t CALL_SITE_NUM_MAX = 32;
+    static constexpr uint32_t POST_TIMER_PERIOD_MS = 10;
+
+    struct CallSiteStats {
+        const char *call_site;
+        uint32_t lock_count;
+        uint32_t reentry_count;
+        uint32_t timeout_count;
+        uint32_t deadlock_report_count;
+        uint32_t wait_max_us;
+        uint32_t hold_max_us;
+        std::array<uint32_t, HISTOGRAM_BUCKET_NUM> wait_histogram;
+        std::array<uint32_t, HISTOGRAM_BUCKET_NUM> hold_histogram;
+    };
+
+    /**
+     * @brief Lock the GUI. Nested calls from the thread which already owns the lock only increase a depth counter and
+     *        do not call the lock callback again.
+     *
+     * @param[in] timeout_ms  Timeout in milliseconds, -1 means wait forever
+     * @param[in] call_site   Name used to group the contention metrics, defaults to the calling function
+     *
+     * @return true if success, otherwise false
+     */
+    bool lock(int timeout_ms = -1, const char *call_site = __builtin_FUNCTION());
     bool unlock();
 
+    /**
+     * @brief Queue a function to be run on the LVGL thread, without blocking on the lock. Queued functions are run by
+     *        an LVGL timer, which is created by `registerCallbacks()`.
+     *
+     * @param[in] fn  Function to run
+     *
+     * @return true if success, otherwise false
+     */
+    static bool post(PostFunction fn);
+
+    /**
+     * @brief Get a snapshot of the contention metrics, only available when
+     *        `CONFIG_ESP_BROOKESIA_LVGL_LOCK_ENABLE_METRICS` is enabled
+     */
+    std::vector<CallSiteStats> getStats();
+    void resetStats();
+    void dumpStats();
+
+    bool isLockedByCurrentThread() const
+    {
+        return owner_.load() == std::this_thread::get_id();
+    }
+
     static LvLock &getInstance();
+
+    /**
+     * @brief Register the callbacks of the lock backend and create the timer running the posted functions, LVGL must
+     *        be initialized
+     *
+     * @param[in] lock_cb    Take the lock, return false only if the timeout expires
+     * @param[in] unlock_cb  Release the lock
+     */
     static void registerCallbacks(LockCallback lock_cb, UnlockCallback unlock_cb);
 
+    /**
+     * @brief Delete the timer running the posted functions, drop the functions not run yet and unregister the
+     *        callbacks. Call it before `lv_deinit()`.
+     */
+    static void unregisterCallbacks();
+
 private:
+    using Clock = std::chrono::steady_clock;
+
+    // The backend may give up to one RTOS tick before its timeout
+    static constexpr int BACKEND_TIMEOUT_TOLERANCE_MS = 10;
+
     LvLock() = default;
     ~LvLock() = default;
     LvLock(const LvLock &) = delete;
     LvLock &operator=(const LvLock &) = delete;
 
+    bool lockBackend(int timeout_ms, const char *call_site);
+    void reportPossibleDeadlock(const char *call_site, uint32_t waited_ms);
+    void recordLock(const char *call_site, bool is_reentry, bool is_timeout, uint32_t wait_us);
+    void recordHold(const char *call_site, uint32_t hold_us);
+    CallSiteStats *getCallSiteStats(const char *call_site);
+    void createPostTimer();
+    void deletePostTimer();
+
+    static size_t getHistogramBucket(uint32_t time_us);
+    static void onPostTimerCallback(lv_timer_t *t);
+
     LockCallback lock_cb_;
     UnlockCallback unlock_cb_;
-    std::atomic<size_t> lock_count_ = 0;
+
+    // Owner tracking, only the owner thread writes these. The call site and lock time are atomic because the deadlock
+    // report reads them from a waiting thread
+    std::atomic<std::thread::id> owner_{};
+    size_t owner_depth_ = 0;
+    std::atomic<const char *> owner_call_site_ = nullptr;
+    std::atomic<int64_t> owner_lock_time_us_ = 0;
+    // Increased each time the backend is taken through `LvLock`, a waiting thread sees whether the lock changed hands
+    std::atomic<uint32_t> owner_generation_ = 0;
+
+    std::mutex stats_mutex_;
+    std::array<CallSiteStats, CALL_SITE_NUM_MAX> stats_{};
+    size_t stats_num_ = 0;
+
+    std::mutex post_mutex_;
+    std::deque<PostFunction> post_queue_;
+    std::atomic<bool> post_pending_ = false;
+    // Created and deleted with the lock held, read by `post()` with `post_mutex_` held
+    lv_timer_t *post_timer_ = nullptr;
 };
 
 class LvLockGuard {
 public:
-    LvLockGuard();
+    LvLockGuard(const char *call_site = __builtin_FUNCTION());
     ~LvLockGuard();
 
     LvLockGuard(const LvLockGuard &) = delete;
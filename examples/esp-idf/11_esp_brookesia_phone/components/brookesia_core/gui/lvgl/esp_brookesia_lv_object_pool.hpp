@@ -0,0 +1,176 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace esp_brookesia::gui {
+
+/**
+ * @brief A pool of widgets built from LVGL objects, such as `phone::RecentsScreenSnapshot`
+ *
+ * A widget taken by `acquire()` goes back to the pool when its pointer is released. The pool resets it, usually by
+ * hiding its objects, and keeps it with its objects and styles, so the next `acquire()` only has to bind the new
+ * content. Creating and deleting the objects of a widget each time it is shown and hidden fragments the LVGL heap over
+ * a long uptime, a pool keeps them in place.
+ *
+ * The pool must outlive the widgets it hands out, and it is used with the LVGL lock held, like the widgets.
+ */
+template <typename T>
+class LvObjectPool {
+public:
+    using CreateFunction = std::function<std::unique_ptr<T>(void)>;
+    using ResetFunction = std::function<bool(T &)>;
+
+    class Releaser {
+    public:
+        Releaser() = default;
+        explicit Releaser(LvObjectPool *pool):
+            _pool(pool)
+        {
+        }
+
+        void operator()(T *item) const
+        {
+            if (_pool != nullptr) {
+                _pool->release(item);
+            } else {
+                delete item;
+            }
+        }
+
+    private:
+        LvObjectPool *_pool = nullptr;
+    };
+    using ItemPtr = std::unique_ptr<T, Releaser>;
+
+    struct Stats {
+        int create_num;     // Widgets created by the pool
+        int reuse_num;      // Widgets handed out again
+        int destroy_num;    // Widgets deleted, because the pool was full or the reset failed
+        int free_num;       // Widgets kept in the pool
+        int used_num;       // Widgets handed out and not released yet
+    };
+
+    /**
+     * @brief Create a pool
+     *
+     * @param create Create and begin a widget, return `nullptr` on failure
+     * @param reset Reset a released widget, so it is ready to be bound again. It is deleted if this returns `false`.
+     * @param free_num_max Maximum number of released widgets kept, the others are deleted
+     */
+    LvObjectPool(CreateFunction create, ResetFunction reset, size_t free_num_max):
+        _create(std::move(create)),
+        _reset(std::move(reset)),
+        _free_num_max(free_num_max)
+    {
+        _free_items.reserve(free_num_max);
+    }
+    ~LvObjectPool()
+    {
+        clear();
+    }
+
+    LvObjectPool(const LvObjectPool &) = delete;
+    LvObjectPool &operator=(const LvObjectPool &) = delete;
+
+    /**
+     * @brief Take a released widget, or create one if the pool is empty
+     *
+     * @param is_reused Set to `true` if the widget was released before, it still shows its last content
+     *
+     * @return The widget, or `nullptr` if it can not be created
+     */
+    ItemPtr acquire(bool *is_reused = nullptr)
+    {
+        std::unique_ptr<T> item;
+        bool reused = !_free_items.empty();
+        if (reused) {
+            item = std::move(_free_items.back());
+            _free_items.pop_back();
+            _stats.reuse_num++;
+        } else if (_create) {
+            item = _create();
+            _stats.create_num += (item != nullptr);
+        }
+        if (is_reused != nullptr) {
+            *is_reused = reused;
+        }
+        if (item == nullptr) {
+            return ItemPtr(nullptr, Releaser(this));
+        }
+        _stats.used_num++;
+
+        return ItemPtr(item.release(), Releaser(this));
+    }
+
+    /**
+     * @brief Create widgets until the pool keeps `num` of them, so the first ones shown are not created on demand
+     */
+    bool reserve(size_t num)
+    {
+        num = std::min(num, _free_num_max);
+        while (_free_items.size() < num) {
+            std::unique_ptr<T> item = _create ? _create() : nullptr;
+            if ((item == nullptr) || (_reset && !_reset(*item))) {
+                return false;
+            }
+            _stats.create_num++;
+            _free_items.push_back(std::move(item));
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Delete the widgets kept in the pool. Call it before the parent of the widgets is deleted.
+     */
+    void clear()
+    {
+        _stats.destroy_num += _free_items.size();
+        _free_items.clear();
+    }
+
+    Stats getStats() const
+    {
+        Stats stats = _stats;
+        stats.free_num = static_cast<int>(_free_items.size());
+
+        return stats;
+    }
+    size_t getFreeNumMax() const
+    {
+        return _free_num_max;
+    }
+
+private:
+    void release(T *item)
+    {
+        if (item == nullptr) {
+            return;
+        }
+        _stats.used_num--;
+
+        std::unique_ptr<T> item_ptr(item);
+        if ((_free_items.size() >= _free_num_max) || (_reset && !_reset(*item))) {
+            _stats.destroy_num++;
+            return;
+        }
+        _free_items.push_back(std::move(item_ptr));
+    }
+
+    CreateFunction _create;
+    ResetFunction _reset;
+    size_t _free_num_max;
+    std::vector<std::unique_ptr<T>> _free_items;
+    Stats _stats = {};
+};
+
+} // namespace esp_brookesia::gui
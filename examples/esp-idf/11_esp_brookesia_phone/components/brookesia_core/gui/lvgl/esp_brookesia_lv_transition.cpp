@@ -0,0 +1,245 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>
+#include <chrono>
+#include "esp_brookesia_gui_internal.h"
+#if !ESP_BROOKESIA_LVGL_TRANSITION_ENABLE_DEBUG_LOG
+#   define ESP_BROOKESIA_UTILS_DISABLE_DEBUG_LOG
+#endif
+#include "private/esp_brookesia_lv_utils.hpp"
+#include "esp_brookesia_lv_helper.hpp"
+#include "esp_brookesia_lv_transition.hpp"
+
+namespace esp_brookesia::gui {
+
+namespace {
+
+int64_t get_time_us()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()
+           ).count();
+}
+
+} // namespace
+
+LvTransition::LvTransition(lv_display_t *display):
+    _display((display != nullptr) ? display : lv_display_get_default())
+{
+    _attribute.path_type = StyleAnimation::ANIM_PATH_TYPE_LINEAR;
+}
+
+LvTransition::~LvTransition()
+{
+    ESP_UTILS_LOGD("Destroy(@0x%p)", this);
+
+    lv_async_call_cancel(onFinishAsyncCallback, this);
+    removeEventCallbacks();
+}
+
+void LvTransition::setStyleAttribute(const StyleAnimation &attribute)
+{
+    ESP_UTILS_LOGD("Param: attribute(%p)", &attribute);
+
+    _attribute = attribute;
+}
+
+void LvTransition::setExecutionMethod(ExecutionMethod method)
+{
+    _execution_method = method;
+}
+
+void LvTransition::setCompletedMethod(CompletedMethod method)
+{
+    _completed_method = method;
+}
+
+bool LvTransition::start(int start_value, int end_value)
+{
+    ESP_UTILS_LOGD("Start(%d -> %d)", start_value, end_value);
+    ESP_UTILS_CHECK_NULL_RETURN(_display, false, "No display");
+    ESP_UTILS_CHECK_NULL_RETURN(_execution_method, false, "No execution method");
+
+    ESP_UTILS_CHECK_FALSE_RETURN(addEventCallbacks(), false, "Add event callbacks failed");
+
+    _is_running = true;
+    _is_finishing = false;
+    _has_vsync = false;
+    _start_value = start_value;
+    _end_value = end_value;
+    _start_tick = lv_tick_get();
+    _last_frame_tick = _start_tick;
+    _render_start_us = 0;
+    _render_time_sum_us = 0;
+    _stats = {};
+
+    // The first frame shows the start value
+    step(_start_tick);
+
+    return true;
+}
+
+bool LvTransition::stop(void)
+{
+    ESP_UTILS_LOGD("Stop");
+
+    if (!_is_running) {
+        return true;
+    }
+    _is_running = false;
+    _stats.duration_ms = lv_tick_elaps(_start_tick);
+    if (lv_async_call(onFinishAsyncCallback, this) != LV_RESULT_OK) {
+        removeEventCallbacks();
+    }
+
+    return true;
+}
+
+void LvTransition::step(uint32_t tick)
+{
+    uint32_t elapsed_ms = tick - _start_tick;
+    int value = _end_value;
+
+    if (elapsed_ms < static_cast<uint32_t>(std::max(_attribute.duration_ms, 0))) {
+        lv_anim_t anim;
+        lv_anim_init(&anim);
+        anim.start_value = _start_value;
+        anim.current_value = _start_value;
+        anim.end_value = _end_value;
+        anim.duration = _attribute.duration_ms;
+        anim.act_time = elapsed_ms;
+        lv_anim_path_cb_t path_cb = getLvAnimPathCb(_attribute.path_type);
+        value = (path_cb != nullptr) ? path_cb(&anim) : lv_anim_path_linear(&anim);
+    } else {
+        // Finish once the frame of the end value is rendered
+        _is_finishing = true;
+    }
+    _execution_method(value);
+
+    // Keep the refresh running even if the value changes nothing on the screen
+    lv_timer_t *refresh_timer = lv_display_get_refr_timer(_display);
+    if (refresh_timer != nullptr) {
+        lv_timer_resume(refresh_timer);
+    }
+}
+
+void LvTransition::finish(void)
+{
+    ESP_UTILS_LOGD(
+        "Finish: %d frames(%d late), %d ms, render avg %d us", _stats.frame_num, _stats.late_frame_num,
+        (int)_stats.duration_ms, (int)_stats.render_time_avg_us
+    );
+
+    _is_running = false;
+    _is_finishing = false;
+    _stats.duration_ms = lv_tick_elaps(_start_tick);
+    // The callbacks can not be removed while the display sends its events
+    if (lv_async_call(onFinishAsyncCallback, this) != LV_RESULT_OK) {
+        ESP_UTILS_LOGW("Remove event callbacks later failed");
+    }
+
+    if (_completed_method) {
+        // The transition may be started again or deleted by the method
+        CompletedMethod method = _completed_method;
+        method();
+    }
+}
+
+bool LvTransition::addEventCallbacks(void)
+{
+    if (_is_callback_added) {
+        return true;
+    }
+
+    lv_display_add_event_cb(_display, onRefreshEventCallback, LV_EVENT_REFR_START, this);
+    lv_display_add_event_cb(_display, onRefreshEventCallback, LV_EVENT_REFR_READY, this);
+    // Some display drivers only send `LV_EVENT_VSYNC` when it is requested
+    if (!lv_display_register_vsync_event(_display, onVsyncEventCallback, this)) {
+        ESP_UTILS_LOGD("Register vsync event failed, pace by the refresh only");
+    }
+    _is_callback_added = true;
+
+    return true;
+}
+
+void LvTransition::removeEventCallbacks(void)
+{
+    if (!_is_callback_added) {
+        return;
+    }
+
+    lv_display_remove_event_cb_with_user_data(_display, onRefreshEventCallback, this);
+    lv_display_unregister_vsync_event(_display, onVsyncEventCallback, this);
+    _is_callback_added = false;
+}
+
+void LvTransition::onVsyncEventCallback(lv_event_t *event)
+{
+    auto transition = static_cast<LvTransition *>(lv_event_get_user_data(event));
+    ESP_UTILS_CHECK_NULL_EXIT(transition, "Invalid transition");
+
+    if (!transition->_is_running || transition->_is_finishing) {
+        return;
+    }
+    transition->_has_vsync = true;
+    transition->_stats.vsync_num++;
+    transition->step(lv_tick_get());
+}
+
+void LvTransition::onRefreshEventCallback(lv_event_t *event)
+{
+    auto transition = static_cast<LvTransition *>(lv_event_get_user_data(event));
+    ESP_UTILS_CHECK_NULL_EXIT(transition, "Invalid transition");
+
+    if (!transition->_is_running) {
+        return;
+    }
+
+    if (lv_event_get_code(event) == LV_EVENT_REFR_START) {
+        transition->_render_start_us = get_time_us();
+        if (!transition->_has_vsync && !transition->_is_finishing) {
+            transition->step(lv_tick_get());
+        }
+        return;
+    }
+
+    // LV_EVENT_REFR_READY
+    if (transition->_render_start_us == 0) {
+        return;
+    }
+    Stats &stats = transition->_stats;
+    uint32_t tick = lv_tick_get();
+    uint32_t interval_ms = tick - transition->_last_frame_tick;
+    uint32_t render_time_us = static_cast<uint32_t>(get_time_us() - transition->_render_start_us);
+    lv_timer_t *refresh_timer = lv_display_get_refr_timer(transition->_display);
+    uint32_t period_ms = (refresh_timer != nullptr) ? refresh_timer->period : LV_DEF_REFR_PERIOD;
+
+    transition->_last_frame_tick = tick;
+    transition->_render_time_sum_us += render_time_us;
+    stats.frame_num++;
+    stats.late_frame_num += ((stats.frame_num > 1) && (interval_ms * 2 > period_ms * 3));
+    stats.frame_interval_max_ms = (stats.frame_num > 1) ? std::max(stats.frame_interval_max_ms, interval_ms) : 0;
+    stats.render_time_avg_us = static_cast<uint32_t>(transition->_render_time_sum_us / stats.frame_num);
+    stats.render_time_max_us = std::max(stats.render_time_max_us, render_time_us);
+
+    if (transition->_is_finishing) {
+        transition->finish();
+    }
+}
+
+void LvTransition::onFinishAsyncCallback(void *user_data)
+{
+    auto transition = static_cast<LvTransition *>(user_data);
+    ESP_UTILS_CHECK_NULL_EXIT(transition, "Invalid transition");
+
+    // Started again meanwhile
+    if (transition->_is_running) {
+        return;
+    }
+    transition->removeEventCallbacks();
+}
+
+} // namespace esp_brookesia::gui
@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <functional>
+#include <memory>
+#include "lvgl.h"
+#include "style/esp_brookesia_gui_style.hpp"
+
+namespace esp_brookesia::gui {
+
+/**
+ * @brief An animation stepped by the frames of a display
+ *
+ * An `lv_anim_t` runs on its own timer, so a frame may show two steps at once or none. A transition computes one step
+ * at the start of each refresh of its display, or at each `LV_EVENT_VSYNC` if the display driver sends them. The value
+ * of a step is computed from the time of the frame, so a late frame jumps ahead instead of slowing the transition
+ * down. The frames of each transition are counted, see `getStats()`.
+ */
+class LvTransition {
+public:
+    struct Stats {
+        int frame_num;                  // Frames rendered during the transition
+        int late_frame_num;             // Frames which came more than 1.5 refresh periods after the previous one
+        int vsync_num;                  // Steps paced by `LV_EVENT_VSYNC`, the others by the refresh
+        uint32_t duration_ms;           // From the start to the last frame
+        uint32_t frame_interval_max_ms;
+        uint32_t render_time_avg_us;    // From `LV_EVENT_REFR_START` to `LV_EVENT_REFR_READY`
+        uint32_t render_time_max_us;
+    };
+
+    using ExecutionMethod = std::function<void(int value)>;
+    using CompletedMethod = std::function<void(void)>;
+
+    /**
+     * @brief Create a transition on a display, the default one if `display` is `nullptr`
+     */
+    LvTransition(lv_display_t *display = nullptr);
+    ~LvTransition();
+
+    LvTransition(const LvTransition &) = delete;
+    LvTransition &operator=(const LvTransition &) = delete;
+
+    /**
+     * @brief Set the duration and the path. The start and end values are given to `start()`, the delay is ignored.
+     */
+    void setStyleAttribute(const StyleAnimation &attribute);
+    void setExecutionMethod(ExecutionMethod method);
+    void setCompletedMethod(CompletedMethod method);
+
+    /**
+     * @brief Apply `start_value` at once, then one step per frame until `end_value`
+     */
+    bool start(int start_value, int end_value);
+
+    /**
+     * @brief Stop at the current value, the completed method is not called
+     */
+    bool stop(void);
+
+    bool isRunning(void) const
+    {
+        return _is_running;
+    }
+
+    /**
+     * @brief Get the statistics of the running transition, or of the last one
+     */
+    const Stats &getStats(void) const
+    {
+        return _stats;
+    }
+
+private:
+    void step(uint32_t tick);
+    void finish(void);
+    bool addEventCallbacks(void);
+    void removeEventCallbacks(void);
+
+    static void onVsyncEventCallback(lv_event_t *event);
+    static void onRefreshEventCallback(lv_event_t *event);
+    static void onFinishAsyncCallback(void *user_data);
+
+    lv_display_t *_display = nullptr;
+    StyleAnimation _attribute = {};
+    ExecutionMethod _execution_method;
+    CompletedMethod _completed_method;
+
+    bool _is_running = false;
+    bool _is_callback_added = false;
+    bool _is_finishing = false;
+    bool _has_vsync = false;
+    int _start_value = 0;
+    int _end_value = 0;
+    uint32_t _start_tick = 0;
+    uint32_t _last_frame_tick = 0;
+    int64_t _render_start_us = 0;
+    uint64_t _render_time_sum_us = 0;
+    Stats _stats = {};
+};
+
+using LvTransitionUniquePtr = std::unique_ptr<LvTransition>;
+
+} // namespace esp_brookesia::gui
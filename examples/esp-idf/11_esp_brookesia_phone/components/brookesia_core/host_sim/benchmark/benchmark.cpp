@@ -0,0 +1,408 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * UI performance benchmark of the phone system. For every resolution stylesheet it installs a set of apps, launches
+ * and closes them, swipes the app launcher, updates the status bar, opens the recents screen and drags its snapshots,
+ * then reports the frame times, the rendered area and the heap high-water marks of every scenario, and the frames of
+ * the snapshot transitions.
+ *
+ * Usage: brookesia_host_benchmark [--quick] [--apps <num>] [--resolution <width>x<height>]
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "esp_lib_utils.h"
+#include "gui/lvgl/esp_brookesia_lv_lock.hpp"
+#include "systems/phone/esp_brookesia_phone.hpp"
+#include "systems/phone/stylesheets/esp_brookesia_phone_stylesheets.hpp"
+#include "systems/phone/assets/esp_brookesia_phone_assets.h"
+#include "sim_device.hpp"
+
+using namespace esp_brookesia;
+using namespace esp_brookesia::host_sim;
+
+namespace {
+
+constexpr uint32_t FRAME_PERIOD_MS = LV_DEF_REFR_PERIOD;
+constexpr uint32_t SETTLE_TIME_MS = 1000;
+constexpr uint32_t SWIPE_TIME_MS = 200;
+constexpr uint32_t STATUS_BAR_UPDATE_PERIOD_MS = 1000;
+constexpr int DRAW_BUFFER_LINES = 40;
+constexpr int APP_LIST_ITEM_NUM = 20;
+
+struct Resolution {
+    int width;
+    int height;
+    const systems::phone::Stylesheet *stylesheet;
+};
+
+const Resolution RESOLUTIONS[] = {
+    {320, 240, &systems::phone::STYLESHEET_320_240_DARK},
+    {320, 480, &systems::phone::STYLESHEET_320_480_DARK},
+    {480, 480, &systems::phone::STYLESHEET_480_480_DARK},
+    {480, 800, &systems::phone::STYLESHEET_480_800_DARK},
+    {800, 480, &systems::phone::STYLESHEET_800_480_DARK},
+    {720, 1280, &systems::phone::STYLESHEET_720_1280_DARK},
+    {800, 1280, &systems::phone::STYLESHEET_800_1280_DARK},
+    {1024, 600, &systems::phone::STYLESHEET_1024_600_DARK},
+    {1280, 800, &systems::phone::STYLESHEET_1280_800_DARK},
+};
+
+struct Options {
+    bool is_quick = false;
+    int app_num = 12;
+    int swipe_num = 6;
+    int status_bar_update_num = 30;
+    int width = 0;
+    int height = 0;
+};
+
+/**
+ * @brief A typical app screen: a title and a scrollable list, closed by the back navigation
+ */
+class BenchApp: public systems::phone::App {
+public:
+    // The core keeps a pointer to the name, it must outlive the app. Without an icon, the default one is used.
+    BenchApp(const std::string &name, const void *launcher_icon):
+        App(name.c_str(), launcher_icon, true),
+        _name(name)
+    {
+    }
+
+    bool run() override
+    {
+        lv_obj_t *screen = lv_screen_active();
+        lv_obj_t *title = lv_label_create(screen);
+        lv_label_set_text(title, _name.c_str());
+        lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 10);
+
+        lv_obj_t *list = lv_list_create(screen);
+        lv_obj_set_size(list, lv_pct(90), lv_pct(80));
+        lv_obj_align(list, LV_ALIGN_BOTTOM_MID, 0, -10);
+        for (int i = 0; i < APP_LIST_ITEM_NUM; i++) {
+            lv_list_add_button(list, LV_SYMBOL_FILE, ("Item " + std::to_string(i)).c_str());
+        }
+
+        return true;
+    }
+
+    bool back() override
+    {
+        return notifyCoreClosed();
+    }
+
+private:
+    const std::string &_name;
+};
+
+struct Report {
+    const char *scenario;
+    std::vector<SimDevice::Frame> frames;
+    uint32_t handler_max_us;
+    uint32_t obj_num;
+};
+
+uint32_t get_percentile(std::vector<uint32_t> &values, int percentile)
+{
+    if (values.empty()) {
+        return 0;
+    }
+    size_t index = std::min(values.size() - 1, values.size() * percentile / 100);
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+
+    return values[index];
+}
+
+size_t get_process_hwm_kb()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::strtoul(line.c_str() + 6, nullptr, 10);
+        }
+    }
+
+    return 0;
+}
+
+uint32_t get_object_num(lv_display_t *display)
+{
+    uint32_t obj_num = 0;
+    auto count = [](lv_obj_t *obj, void *user_data) {
+        (*static_cast<uint32_t *>(user_data))++;
+        return LV_OBJ_TREE_WALK_NEXT;
+    };
+    lv_obj_tree_walk(lv_display_get_screen_active(display), count, &obj_num);
+    lv_obj_tree_walk(lv_display_get_layer_top(display), count, &obj_num);
+    lv_obj_tree_walk(lv_display_get_layer_sys(display), count, &obj_num);
+
+    return obj_num;
+}
+
+void print_report(const Report &report, int screen_pixel_num)
+{
+    std::vector<uint32_t> render_us;
+    uint64_t area_num = 0;
+    uint64_t pixel_num = 0;
+    for (auto &frame : report.frames) {
+        render_us.push_back(frame.render_us);
+        area_num += frame.area_num;
+        pixel_num += frame.pixel_num;
+    }
+    size_t frame_num = std::max<size_t>(1, report.frames.size());
+
+    printf(
+        "  %-16s frames %5zu | render us p50 %6u p95 %6u p99 %6u max %6u | handler max %6u us | "
+        "areas/frame %5.1f | redraw/frame %5.1f%% | objects %5u\n", report.scenario, report.frames.size(),
+        get_percentile(render_us, 50), get_percentile(render_us, 95), get_percentile(render_us, 99),
+        get_percentile(render_us, 100), report.handler_max_us, static_cast<double>(area_num) / frame_num,
+        100.0 * pixel_num / frame_num / screen_pixel_num, report.obj_num
+    );
+}
+
+template <typename Func>
+Report run_scenario(SimDevice &device, const char *scenario, Func &&func)
+{
+    device.takeFrames();
+    device.takeHandlerMaxUs();
+    func([&](uint32_t duration_ms) {
+        device.stepFor(duration_ms, FRAME_PERIOD_MS);
+    });
+
+    return Report{scenario, device.takeFrames(), device.takeHandlerMaxUs(), get_object_num(device.getDisplay())};
+}
+
+bool run_resolution(const Resolution &resolution, const Options &options)
+{
+    printf("\n%dx%d, %d apps\n", resolution.width, resolution.height, options.app_num);
+
+    lv_init();
+    gui::LvLock::registerCallbacks([](int) {
+        lv_lock();
+        return true;
+    }, []() {
+        lv_unlock();
+        return true;
+    });
+
+    SimDevice device;
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        device.begin(resolution.width, resolution.height, DRAW_BUFFER_LINES), false, "Begin device failed"
+    );
+
+    bool ret = false;
+    std::vector<Report> reports;
+    std::vector<std::string> app_names(options.app_num);
+    std::vector<std::unique_ptr<BenchApp>> apps;
+    std::vector<int> app_ids;
+    lv_mem_monitor_t mem_monitor = {};
+    gui::LvTransition::Stats transition_stats = {};
+    int transition_num = 0;
+    auto phone = std::make_unique<systems::phone::Phone>(device.getDisplay());
+    int x_center = resolution.width / 2;
+    int y_center = resolution.height / 2;
+
+    ESP_UTILS_CHECK_FALSE_GOTO(phone->setTouchDevice(device.getTouch()), end, "Set touch device failed");
+    ESP_UTILS_CHECK_FALSE_GOTO(phone->addStylesheet(resolution.stylesheet), end, "Add stylesheet failed");
+    ESP_UTILS_CHECK_FALSE_GOTO(phone->activateStylesheet(resolution.stylesheet), end, "Activate stylesheet failed");
+
+    reports.push_back(run_scenario(device, "begin", [&](auto settle) {
+        ret = phone->begin();
+        settle(SETTLE_TIME_MS);
+    }));
+    ESP_UTILS_CHECK_FALSE_GOTO(ret, end, "Begin phone failed");
+
+    reports.push_back(run_scenario(device, "install", [&](auto settle) {
+        for (int i = 0; i < options.app_num; i++) {
+            app_names[i] = "App " + std::to_string(i);
+            // Half of the apps have their own icon, which is not of the size of the stylesheet icons
+            apps.push_back(std::make_unique<BenchApp>(
+                               app_names[i], (i % 2 == 0) ? nullptr : &esp_brookesia_image_small_app_launcher_default_98_98
+                           ));
+            app_ids.push_back(phone->installApp(apps.back().get()));
+        }
+        settle(SETTLE_TIME_MS);
+    }));
+    ESP_UTILS_CHECK_FALSE_GOTO(
+        std::find(app_ids.begin(), app_ids.end(), -1) == app_ids.end(), end, "Install app failed"
+    );
+
+    // Every app stays running in the background, so the recents screen has a snapshot for each of them
+    reports.push_back(run_scenario(device, "launch", [&](auto settle) {
+        for (int id : app_ids) {
+            systems::base::Context::AppEventData event = {id, systems::base::Context::AppEventType::START, nullptr};
+            ret = phone->sendAppEvent(&event) && ret;
+            settle(SETTLE_TIME_MS);
+            ret = phone->sendNavigateEvent(systems::base::Manager::NavigateType::HOME) && ret;
+            settle(SETTLE_TIME_MS);
+        }
+    }));
+    ESP_UTILS_CHECK_FALSE_GOTO(ret, end, "Launch app failed");
+
+    reports.push_back(run_scenario(device, "launcher swipe", [&](auto settle) {
+        for (int i = 0; i < options.swipe_num; i++) {
+            int offset = resolution.width / 3 * ((i % 2 == 0) ? 1 : -1);
+            device.swipe(x_center + offset, y_center, x_center - offset, y_center, SWIPE_TIME_MS, FRAME_PERIOD_MS);
+            settle(SETTLE_TIME_MS);
+        }
+    }));
+
+    // Like a device which polls its clock, battery and Wi-Fi every second, with a battery percent around a level
+    // boundary and an unstable Wi-Fi signal
+    reports.push_back(run_scenario(device, "status bar", [&](auto settle) {
+        systems::phone::StatusBar *status_bar = phone->getDisplay().getStatusBar();
+        ret = (status_bar != nullptr);
+        for (int i = 0; ret && (i < options.status_bar_update_num); i++) {
+            ret = status_bar->setClock(9 + i / 60, i % 60) && ret;
+            ret = status_bar->setBatteryPercent(false, 50 + (i % 3) - 1) && ret;
+            ret = status_bar->setWifiIconState(1 + i % 3) && ret;
+            settle(STATUS_BAR_UPDATE_PERIOD_MS);
+        }
+    }));
+    ESP_UTILS_CHECK_FALSE_GOTO(ret, end, "Update status bar failed");
+
+    reports.push_back(run_scenario(device, "recents screen", [&](auto settle) {
+        ret = phone->sendNavigateEvent(systems::base::Manager::NavigateType::RECENTS_SCREEN);
+        settle(SETTLE_TIME_MS);
+    }));
+    ESP_UTILS_CHECK_FALSE_GOTO(ret, end, "Show recents screen failed");
+
+    // Drag the current snapshot down and release it, so it moves back to its origin
+    reports.push_back(run_scenario(device, "recents drag", [&](auto settle) {
+        const systems::phone::RecentsScreen *recents_screen = phone->getDisplay().getRecentsScreen();
+        const gui::LvTransition *transition = (recents_screen != nullptr) ? recents_screen->getSnapshotTransition() :
+                                              nullptr;
+        for (int i = 0; (transition != nullptr) && (i < options.swipe_num); i++) {
+            device.swipe(
+                x_center, y_center, x_center, y_center + resolution.height / 6, SWIPE_TIME_MS, FRAME_PERIOD_MS
+            );
+            settle(SETTLE_TIME_MS);
+            auto &stats = transition->getStats();
+            if (stats.frame_num > 0) {
+                transition_num++;
+                transition_stats.frame_num += stats.frame_num;
+                transition_stats.late_frame_num += stats.late_frame_num;
+                transition_stats.vsync_num += stats.vsync_num;
+                transition_stats.duration_ms = std::max(transition_stats.duration_ms, stats.duration_ms);
+                transition_stats.frame_interval_max_ms =
+                    std::max(transition_stats.frame_interval_max_ms, stats.frame_interval_max_ms);
+                transition_stats.render_time_avg_us += stats.render_time_avg_us;
+                transition_stats.render_time_max_us =
+                    std::max(transition_stats.render_time_max_us, stats.render_time_max_us);
+            }
+        }
+        ret = phone->sendNavigateEvent(systems::base::Manager::NavigateType::HOME);
+        settle(SETTLE_TIME_MS);
+    }));
+    ESP_UTILS_CHECK_FALSE_GOTO(ret, end, "Hide recents screen failed");
+
+    reports.push_back(run_scenario(device, "close", [&](auto settle) {
+        for (int id : app_ids) {
+            systems::base::Context::AppEventData event = {id, systems::base::Context::AppEventType::START, nullptr};
+            ret = phone->sendAppEvent(&event) && ret;
+            settle(SETTLE_TIME_MS);
+            ret = phone->sendNavigateEvent(systems::base::Manager::NavigateType::BACK) && ret;
+            settle(SETTLE_TIME_MS);
+        }
+    }));
+    ESP_UTILS_CHECK_FALSE_GOTO(ret, end, "Close app failed");
+    ESP_UTILS_CHECK_FALSE_GOTO(phone->getManager().getRunningAppCount() == 0, end, "Apps are still running");
+
+    for (int id : app_ids) {
+        ESP_UTILS_CHECK_FALSE_GOTO(ret = phone->uninstallApp(id), end, "Uninstall app(%d) failed", id);
+    }
+
+    for (auto &report : reports) {
+        print_report(report, resolution.width * resolution.height);
+    }
+    if (transition_num > 0) {
+        printf(
+            "  snapshot transitions %d: frames/transition %.1f (%d late, %d by vsync) | duration max %u ms | "
+            "frame interval max %u ms | render us avg %u max %u\n", transition_num,
+            static_cast<double>(transition_stats.frame_num) / transition_num, transition_stats.late_frame_num,
+            transition_stats.vsync_num, transition_stats.duration_ms, transition_stats.frame_interval_max_ms,
+            transition_stats.render_time_avg_us / transition_num, transition_stats.render_time_max_us
+        );
+    } else {
+        printf("  snapshot transitions: none\n");
+    }
+    lv_mem_monitor(&mem_monitor);
+    printf(
+        "  heap: lvgl max used %zu KB (now %zu KB), process high-water %zu KB\n", mem_monitor.max_used / 1024,
+        (mem_monitor.total_size - mem_monitor.free_size) / 1024, get_process_hwm_kb()
+    );
+
+end:
+    phone.reset();
+    apps.clear();
+    device.del();
+    gui::LvLock::unregisterCallbacks();
+    lv_deinit();
+
+    return ret;
+}
+
+bool parse_options(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            options.is_quick = true;
+            options.app_num = 4;
+            options.swipe_num = 2;
+            options.status_bar_update_num = 5;
+        } else if ((strcmp(argv[i], "--apps") == 0) && (i + 1 < argc)) {
+            options.app_num = std::atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "--resolution") == 0) && (i + 1 < argc)) {
+            if (sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+
+    return (options.app_num > 0);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        printf("Usage: %s [--quick] [--apps <num>] [--resolution <width>x<height>]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    esp_utils::host_log_level = ESP_UTILS_LOG_LEVEL_ERROR;
+
+    int run_num = 0;
+    for (auto &resolution : RESOLUTIONS) {
+        if ((options.width > 0) && ((resolution.width != options.width) || (resolution.height != options.height))) {
+            continue;
+        }
+        // The quick run only covers the smallest and the most common resolution
+        if (options.is_quick && (options.width == 0) && (resolution.width * resolution.height > 800 * 480)) {
+            continue;
+        }
+        if (!run_resolution(resolution, options)) {
+            printf("%dx%d failed\n", resolution.width, resolution.height);
+            return EXIT_FAILURE;
+        }
+        run_num++;
+    }
+    if (run_num == 0) {
+        printf("No resolution matched\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,311 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * Benchmark of the function calling of the agent. It registers a set of functions, then dispatches 1000 generated
+ * calls: plain arguments, escaped strings, calls wrapped in `action_json_str` and invalid ones. It checks every
+ * result and reports the time and the heap allocations per call.
+ *
+ * Usage: brookesia_host_function_calling_benchmark [--quick]
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+#include "esp_lib_utils.h"
+#include "ai_framework/agent/function_calling.hpp"
+
+using namespace esp_brookesia::ai_framework;
+
+namespace {
+
+std::atomic<uint64_t> alloc_count{0};
+
+constexpr int CALL_NUM = 1000;
+constexpr int ROUND_NUM = 200;
+constexpr int QUICK_ROUND_NUM = 5;
+
+struct Call {
+    std::string name;
+    std::string args_json;
+    bool is_valid;
+    int64_t checksum;
+};
+
+// Sum of what the callbacks received, compared with the sum expected by the generator
+int64_t received_checksum = 0;
+int received_num = 0;
+
+int64_t get_string_checksum(const std::string &value)
+{
+    int64_t sum = 0;
+    for (unsigned char c : value) {
+        sum = (sum * 31 + c) % 1000003;
+    }
+
+    return sum;
+}
+
+void on_function_called(const std::vector<FunctionParameter> &params)
+{
+    for (const auto &param : params) {
+        switch (param.type()) {
+        case FunctionParameter::ValueType::Boolean:
+            received_checksum += param.boolean() ? 7 : 3;
+            break;
+        case FunctionParameter::ValueType::Number:
+            received_checksum += param.number();
+            break;
+        case FunctionParameter::ValueType::String:
+            received_checksum += get_string_checksum(param.string());
+            break;
+        }
+    }
+    received_num++;
+}
+
+void register_functions(void)
+{
+    using ValueType = FunctionParameter::ValueType;
+    auto &list = FunctionDefinitionList::requestInstance();
+
+    FunctionDefinition set_volume("set_volume", "Set the speaker volume");
+    set_volume.addParameter("volume", "Volume in percent", ValueType::Number);
+    FunctionDefinition set_brightness("set_brightness", "Set the screen brightness");
+    set_brightness.addParameter("brightness", "Brightness in percent", ValueType::Number);
+    FunctionDefinition switch_wifi("switch_wifi", "Turn Wi-Fi on or off");
+    switch_wifi.addParameter("on", "Whether Wi-Fi is on", ValueType::Boolean);
+    FunctionDefinition play_music("play_music", "Play a song, \"title\" is required");
+    play_music.addParameter("title", "Title of the song", ValueType::String);
+    play_music.addParameter("artist", "Artist of the song", ValueType::String, false);
+    play_music.addParameter("loop", "Whether to repeat the song", ValueType::Boolean, false);
+    FunctionDefinition set_alarm("set_alarm", "Set an alarm");
+    set_alarm.addParameter("hour", "Hour, 0 to 23", ValueType::Number);
+    set_alarm.addParameter("minute", "Minute, 0 to 59", ValueType::Number);
+    set_alarm.addParameter("label", "Label of the alarm", ValueType::String, false);
+    FunctionDefinition open_app("open_app", "Open an app by its name");
+    open_app.addParameter("name", "Name of the app", ValueType::String);
+    FunctionDefinition terminate_chat("terminate_chat", "Back down. 退下吧");
+
+    for (auto *function : {
+                &set_volume, &set_brightness, &switch_wifi, &play_music, &set_alarm, &open_app, &terminate_chat
+            }) {
+        function->setCallback(on_function_called);
+        list.addFunction(*function);
+    }
+}
+
+std::string escape_json_string(const std::string &text)
+{
+    std::string out;
+    for (char c : text) {
+        if ((c == '"') || (c == '\\')) {
+            out += '\\';
+        }
+        out += c;
+    }
+
+    return out;
+}
+
+std::vector<Call> generate_calls(void)
+{
+    static const char *const titles[] = {"Yesterday", "Clair de lune", "月亮代表我的心", "Don't Stop Me Now"};
+    static const char *const apps[] = {"Settings", "Calculator", "Music Player", "2048"};
+    std::vector<Call> calls;
+    uint32_t seed = 1;
+    auto random = [&seed](int max) {
+        seed = seed * 1103515245 + 12345;
+        return static_cast<int>((seed >> 16) % (max + 1));
+    };
+
+    for (int i = 0; i < CALL_NUM; i++) {
+        Call call = {"", "", true, 0};
+        int value = random(100);
+        std::string title = titles[random(3)];
+        switch (i % 10) {
+        case 0:
+        case 1:
+            call.name = "set_volume";
+            call.args_json = "{\"volume\": " + std::to_string(value) + "}";
+            call.checksum = value;
+            break;
+        case 2:
+            call.name = "set_brightness";
+            call.args_json = "{ \"brightness\" : " + std::to_string(value) + ".0, \"unit\": \"percent\" }";
+            call.checksum = value;
+            break;
+        case 3:
+            call.name = "switch_wifi";
+            call.args_json = std::string("{\"on\":") + ((value % 2) ? "true" : "false") + "}";
+            call.checksum = (value % 2) ? 7 : 3;
+            break;
+        case 4:
+            // An escaped quote and a unicode escape
+            call.name = "play_music";
+            call.args_json = "{\"title\":\"" + escape_json_string(title) + "\",\"artist\":\"Beyonc\\u00e9\"}";
+            call.checksum = get_string_checksum(title) + get_string_checksum("Beyoncé") + 3;
+            break;
+        case 5:
+            call.name = "set_alarm";
+            call.args_json = "{\"hour\":" + std::to_string(value % 24) + ",\"minute\":" + std::to_string(value % 60) +
+                             ",\"label\":\"Wake up\\n\",\"extra\":{\"nested\":[1,2,{\"a\":null}]}}";
+            call.checksum = value % 24 + value % 60 + get_string_checksum("Wake up\n");
+            break;
+        case 6:
+            call.name = "open_app";
+            call.args_json = std::string("{\"name\":\"") + apps[value % 4] + "\"}";
+            call.checksum = get_string_checksum(apps[value % 4]);
+            break;
+        case 7: {
+            // The actual call is wrapped in `action_json_str`
+            std::string action = "{\"name\":\"set_volume\",\"arguments\":{\"volume\":" + std::to_string(value) + "}}";
+            call.name = "action";
+            call.args_json = "{\"action_json_str\":\"" + escape_json_string(action) + "\"}";
+            call.checksum = value;
+            break;
+        }
+        case 8:
+            call.name = "terminate_chat";
+            call.args_json = "{}";
+            break;
+        default:
+            // Invalid: a type mismatch, a missing required parameter and an unknown function
+            call.is_valid = false;
+            switch (value % 3) {
+            case 0:
+                call.name = "set_volume";
+                call.args_json = "{\"volume\":\"loud\"}";
+                break;
+            case 1:
+                call.name = "set_alarm";
+                call.args_json = "{\"hour\":7}";
+                break;
+            default:
+                call.name = "make_coffee";
+                call.args_json = "{}";
+                break;
+            }
+            break;
+        }
+        calls.push_back(std::move(call));
+    }
+
+    return calls;
+}
+
+bool run_calls(const std::vector<Call> &calls, int64_t &expected_checksum, int &expected_num)
+{
+    auto &list = FunctionDefinitionList::requestInstance();
+    for (const auto &call : calls) {
+        if (list.invokeFunction(call.name, call.args_json) != call.is_valid) {
+            printf("Call %s(%s) should %s\n", call.name.c_str(), call.args_json.c_str(),
+                   call.is_valid ? "succeed" : "fail");
+            return false;
+        }
+        if (call.is_valid) {
+            expected_checksum += call.checksum;
+            expected_num++;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+void *operator new(size_t size)
+{
+    alloc_count.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+int main(int argc, char **argv)
+{
+    bool is_quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !is_quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    // The invalid calls are expected to fail, do not print their errors
+    esp_utils::host_log_level = ESP_UTILS_LOG_LEVEL_NONE;
+
+    auto start = std::chrono::steady_clock::now();
+    register_functions();
+    const std::string &descriptor = FunctionDefinitionList::requestInstance().getJson();
+    auto register_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now() - start
+                       ).count();
+    printf("Registered functions in %lld us, descriptor %zu bytes\n", static_cast<long long>(register_us),
+           descriptor.size());
+
+    std::vector<Call> calls = generate_calls();
+    int64_t expected_checksum = 0;
+    int expected_num = 0;
+
+    // The first round grows the string slots
+    if (!run_calls(calls, expected_checksum, expected_num)) {
+        return EXIT_FAILURE;
+    }
+
+    int round_num = is_quick ? QUICK_ROUND_NUM : ROUND_NUM;
+    std::vector<double> round_ns_per_call;
+    round_ns_per_call.reserve(round_num);
+    uint64_t alloc_start = alloc_count.load();
+    for (int i = 0; i < round_num; i++) {
+        start = std::chrono::steady_clock::now();
+        if (!run_calls(calls, expected_checksum, expected_num)) {
+            return EXIT_FAILURE;
+        }
+        auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - start
+                          ).count();
+        round_ns_per_call.push_back(static_cast<double>(elapsed_ns) / calls.size());
+    }
+    uint64_t alloc_num = alloc_count.load() - alloc_start;
+
+    // The descriptor is built once, getting it again must not copy it
+    alloc_start = alloc_count.load();
+    bool is_descriptor_cached = (&FunctionDefinitionList::requestInstance().getJson() == &descriptor) &&
+                                (alloc_count.load() == alloc_start);
+
+    std::sort(round_ns_per_call.begin(), round_ns_per_call.end());
+    printf(
+        "%d calls x %d rounds: ns/call p50 %.0f min %.0f max %.0f | allocations/call %.3f | descriptor cached %s\n",
+        CALL_NUM, round_num, round_ns_per_call[round_ns_per_call.size() / 2], round_ns_per_call.front(),
+        round_ns_per_call.back(), static_cast<double>(alloc_num) / (static_cast<double>(CALL_NUM) * round_num),
+        is_descriptor_cached ? "yes" : "no"
+    );
+
+    if ((received_num != expected_num) || (received_checksum != expected_checksum)) {
+        printf("Arguments mismatch: %d calls received (%d expected), checksum %lld (%lld expected)\n", received_num,
+               expected_num, static_cast<long long>(received_checksum), static_cast<long long>(expected_checksum));
+        return EXIT_FAILURE;
+    }
+    if ((alloc_num != 0) || !is_descriptor_cached) {
+        printf("The dispatcher allocates after the first round\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,374 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * Benchmark of the speaker keyboard. It types a text with mode switches, once with the keys drawn by `lv_keyboard`
+ * and once from the cached key layers, then reports the frame times of both runs and checks that the keyboard
+ * pixels are the same after every press and release. The word prediction is run on a generated dictionary and its
+ * lookup time per keystroke is reported.
+ *
+ * Usage: brookesia_host_keyboard_benchmark [--quick] [--words <num>]
+ */
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "esp_lib_utils.h"
+#include "gui/lvgl/esp_brookesia_lv_lock.hpp"
+#include "gui/lvgl/esp_brookesia_lv_helper.hpp"
+#include "systems/phone/esp_brookesia_phone.hpp"
+#include "systems/phone/stylesheets/esp_brookesia_phone_stylesheets.hpp"
+#include "systems/speaker/widgets/keyboard/esp_brookesia_keyboard.hpp"
+#include "systems/speaker/stylesheets/360x360/dark/keyboard.hpp"
+#include "sim_device.hpp"
+
+using namespace esp_brookesia;
+using namespace esp_brookesia::host_sim;
+using systems::speaker::Keyboard;
+using systems::speaker::KeyboardData;
+
+namespace {
+
+constexpr int SCREEN_SIZE = 360;
+constexpr int DRAW_BUFFER_LINES = 40;
+constexpr uint32_t FRAME_PERIOD_MS = LV_DEF_REFR_PERIOD;
+constexpr uint32_t PRESS_TIME_MS = 60;
+constexpr uint32_t RELEASE_TIME_MS = 90;
+constexpr uint32_t SETTLE_TIME_MS = 500;
+constexpr const char *TEXT = "Hello brookesia 2025. The quick brown fox jumps over the lazy dog? Tell me the weather.";
+constexpr const char *TEXT_QUICK = "Hello brookesia 2025. The weather?";
+constexpr const char *DICTIONARY_PATH = "brookesia_keyboard_dictionary.txt";
+
+struct Options {
+    bool is_quick = false;
+    int word_num = 20000;
+};
+
+struct RunResult {
+    std::vector<SimDevice::Frame> frames;
+    std::vector<uint64_t> hashes;   // Of the keyboard pixels, while each key is pressed and after it is released
+    std::vector<uint32_t> lookup_us;
+    std::vector<uint32_t> lookup_visits;
+    std::string text;
+};
+
+uint32_t get_percentile(std::vector<uint32_t> values, int percentile)
+{
+    if (values.empty()) {
+        return 0;
+    }
+    size_t index = std::min(values.size() - 1, values.size() * percentile / 100);
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+
+    return values[index];
+}
+
+lv_obj_t *find_keyboard(lv_obj_t *parent)
+{
+    lv_obj_t *keyboard = nullptr;
+    lv_obj_tree_walk(parent, [](lv_obj_t *obj, void *user_data) {
+        if (lv_obj_check_type(obj, &lv_keyboard_class)) {
+            *static_cast<lv_obj_t **>(user_data) = obj;
+            return LV_OBJ_TREE_WALK_END;
+        }
+        return LV_OBJ_TREE_WALK_NEXT;
+    }, &keyboard);
+
+    return keyboard;
+}
+
+/**
+ * @brief Convert a text into the keys to press, with the mode keys of the speaker key maps
+ */
+std::vector<std::string> get_keys(const char *text)
+{
+    std::vector<std::string> keys;
+    bool is_number_mode = false;
+    for (const char *c = text; *c != '\0'; c++) {
+        bool is_digit = std::isdigit(static_cast<unsigned char>(*c));
+        if (is_digit != is_number_mode) {
+            keys.push_back(is_digit ? "123" : "abc");
+            is_number_mode = is_digit;
+        }
+        if (*c == ' ') {
+            keys.push_back(is_number_mode ? "abc" : "Space");
+            if (is_number_mode) {
+                keys.push_back("Space");
+                is_number_mode = false;
+            }
+        } else if (std::isupper(static_cast<unsigned char>(*c))) {
+            keys.insert(keys.end(), {"ABC", std::string(1, *c), "abc"});
+        } else if (std::islower(static_cast<unsigned char>(*c)) || is_digit) {
+            keys.push_back(std::string(1, *c));
+        } else {
+            // The punctuations are on the special map
+            keys.insert(keys.end(), {",.?!", std::string(1, *c), "abc"});
+        }
+    }
+
+    return keys;
+}
+
+bool get_key_center(lv_obj_t *keyboard, const std::string &key, lv_point_t &center)
+{
+    auto btnm = reinterpret_cast<lv_buttonmatrix_t *>(keyboard);
+    lv_area_t coords;
+    lv_obj_get_coords(keyboard, &coords);
+    for (uint32_t i = 0; i < btnm->btn_cnt; i++) {
+        const char *text = lv_buttonmatrix_get_button_text(keyboard, i);
+        if ((text != nullptr) && (key == text)) {
+            center.x = coords.x1 + (btnm->button_areas[i].x1 + btnm->button_areas[i].x2) / 2;
+            center.y = coords.y1 + (btnm->button_areas[i].y1 + btnm->button_areas[i].y2) / 2;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+uint64_t get_pixels_hash(const SimDevice &device, const lv_area_t &area)
+{
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    const uint16_t *framebuffer = device.getFramebuffer();
+    for (int y = area.y1; y <= area.y2; y++) {
+        for (int x = area.x1; x <= area.x2; x++) {
+            hash = (hash ^ framebuffer[y * device.getWidth() + x]) * 0x100000001b3ULL;
+        }
+    }
+
+    return hash;
+}
+
+bool run_typing(
+    SimDevice &device, Keyboard &keyboard, lv_obj_t *text_edit, const std::vector<std::string> &keys, bool cached,
+    RunResult &result
+)
+{
+    ESP_UTILS_CHECK_FALSE_RETURN(keyboard.setLayerCacheEnabled(cached), false, "Set layer cache failed");
+    ESP_UTILS_CHECK_FALSE_RETURN(keyboard.setMode(LV_KEYBOARD_MODE_TEXT_LOWER), false, "Set mode failed");
+    lv_textarea_set_text(text_edit, "");
+    device.stepFor(SETTLE_TIME_MS, FRAME_PERIOD_MS);
+    device.takeFrames();
+
+    lv_obj_t *keyboard_obj = find_keyboard(lv_layer_top());
+    ESP_UTILS_CHECK_NULL_RETURN(keyboard_obj, false, "Keyboard not found");
+    lv_area_t area;
+    lv_obj_get_coords(keyboard_obj, &area);
+
+    const auto &predictor = keyboard.getPredictor();
+    for (auto &key : keys) {
+        lv_point_t center;
+        ESP_UTILS_CHECK_FALSE_RETURN(get_key_center(keyboard_obj, key, center), false, "Key(%s) not found", key.c_str());
+
+        device.setPointer(center.x, center.y, true);
+        device.stepFor(PRESS_TIME_MS, FRAME_PERIOD_MS);
+        result.hashes.push_back(get_pixels_hash(device, area));
+        device.releasePointer();
+        device.stepFor(RELEASE_TIME_MS, FRAME_PERIOD_MS);
+        result.hashes.push_back(get_pixels_hash(device, area));
+
+        if (predictor.isLoaded()) {
+            result.lookup_us.push_back(predictor.getLastLookupInfo().time_us);
+            result.lookup_visits.push_back(predictor.getLastLookupInfo().visit_num);
+        }
+    }
+    result.frames = device.takeFrames();
+    result.text = lv_textarea_get_text(text_edit);
+
+    return true;
+}
+
+void print_run(const char *name, const RunResult &result)
+{
+    std::vector<uint32_t> render_us;
+    uint64_t pixel_num = 0;
+    for (auto &frame : result.frames) {
+        render_us.push_back(frame.render_us);
+        pixel_num += frame.pixel_num;
+    }
+    printf(
+        "  %-14s frames %5zu | render us p50 %6u p95 %6u p99 %6u max %6u | pixels/frame %7.0f\n", name,
+        result.frames.size(), get_percentile(render_us, 50), get_percentile(render_us, 95),
+        get_percentile(render_us, 99), get_percentile(render_us, 100),
+        static_cast<double>(pixel_num) / std::max<size_t>(1, result.frames.size())
+    );
+}
+
+/**
+ * @brief Generate a dictionary with Zipf-like weights, and the words of the typed text
+ */
+bool write_dictionary(const char *path, int word_num, const char *text)
+{
+    std::ofstream file(path, std::ios::trunc);
+    ESP_UTILS_CHECK_FALSE_RETURN(file.is_open(), false, "Open file(%s) failed", path);
+
+    std::mt19937 random(2025);
+    const char *letters = "etaoinshrdlcumwfgypbvkjxqz";
+    for (int i = 0; i < word_num; i++) {
+        std::string word;
+        int length = 2 + random() % 9;
+        for (int j = 0; j < length; j++) {
+            // Favour the frequent letters
+            word += letters[std::min<int>(25, (random() % 26) * (random() % 26) / 25)];
+        }
+        file << word << ' ' << (60000 / (1 + i / 4)) << '\n';
+    }
+    std::string word;
+    for (const char *c = text; ; c++) {
+        if (std::isalpha(static_cast<unsigned char>(*c))) {
+            word += static_cast<char>(std::tolower(static_cast<unsigned char>(*c)));
+        } else {
+            if (!word.empty()) {
+                file << word << " 30000\n";
+            }
+            word.clear();
+        }
+        if (*c == '\0') {
+            break;
+        }
+    }
+
+    return file.good();
+}
+
+bool run(const Options &options)
+{
+    lv_init();
+    gui::LvLock::registerCallbacks([](int) {
+        lv_lock();
+        return true;
+    }, []() {
+        lv_unlock();
+        return true;
+    });
+
+    SimDevice device;
+    ESP_UTILS_CHECK_FALSE_RETURN(device.begin(SCREEN_SIZE, SCREEN_SIZE, DRAW_BUFFER_LINES), false, "Begin device failed");
+
+    bool ret = false;
+    const char *text = options.is_quick ? TEXT_QUICK : TEXT;
+    std::vector<std::string> keys = get_keys(text);
+    RunResult results[2];
+    std::unique_ptr<Keyboard> keyboard;
+    std::unique_ptr<gui::LvObject> parent;
+    lv_obj_t *text_edit = nullptr;
+    KeyboardData data = systems::speaker::STYLESHEET_360_360_DARK_KEYBOARD_DATA;
+    // The phone only provides the system context, its stylesheet is of the closest resolution
+    auto phone = std::make_unique<systems::phone::Phone>(device.getDisplay());
+    auto &context = static_cast<systems::base::Context &>(*phone);
+    int mismatch_num = 0;
+    int64_t load_start_us = 0;
+
+    ESP_UTILS_CHECK_FALSE_GOTO(phone->setTouchDevice(device.getTouch()), end, "Set touch device failed");
+    ESP_UTILS_CHECK_FALSE_GOTO(
+        phone->addStylesheet(&systems::phone::STYLESHEET_320_240_DARK), end, "Add stylesheet failed"
+    );
+    ESP_UTILS_CHECK_FALSE_GOTO(
+        phone->activateStylesheet(&systems::phone::STYLESHEET_320_240_DARK), end, "Activate stylesheet failed"
+    );
+    ESP_UTILS_CHECK_FALSE_GOTO(phone->begin(), end, "Begin phone failed");
+    device.stepFor(SETTLE_TIME_MS, FRAME_PERIOD_MS);
+
+    ESP_UTILS_CHECK_FALSE_GOTO(
+        Keyboard::calibrateData(gui::StyleSize::RECT(SCREEN_SIZE, SCREEN_SIZE), context.getDisplay(), data), end,
+        "Calibrate keyboard data failed"
+    );
+    parent = std::make_unique<gui::LvObject>(lv_obj_create(lv_layer_top()));
+    lv_obj_remove_style_all(parent->getNativeHandle());
+    lv_obj_set_size(parent->getNativeHandle(), SCREEN_SIZE, SCREEN_SIZE);
+    keyboard = std::make_unique<Keyboard>(context, data);
+    ESP_UTILS_CHECK_FALSE_GOTO(keyboard->begin(parent.get()), end, "Begin keyboard failed");
+    text_edit = lv_textarea_create(lv_layer_top());
+    lv_obj_set_size(text_edit, SCREEN_SIZE, SCREEN_SIZE / 4);
+    lv_obj_align(text_edit, LV_ALIGN_TOP_MID, 0, 0);
+    ESP_UTILS_CHECK_FALSE_GOTO(keyboard->setTextEdit(text_edit), end, "Set text edit failed");
+
+    ESP_UTILS_CHECK_FALSE_GOTO(
+        write_dictionary(DICTIONARY_PATH, options.word_num, text), end, "Write dictionary failed"
+    );
+    load_start_us = get_time_us();
+    ret = keyboard->loadDictionary(DICTIONARY_PATH);
+    std::remove(DICTIONARY_PATH);
+    ESP_UTILS_CHECK_FALSE_GOTO(ret, end, "Load dictionary failed");
+    printf(
+        "\nDictionary: %d words, %zu KB, loaded in %u ms\n", keyboard->getPredictor().getWordNum(),
+        keyboard->getPredictor().getMemorySize() / 1024, static_cast<uint32_t>((get_time_us() - load_start_us) / 1000)
+    );
+
+    printf("\n%dx%d keyboard, %zu keys\n", SCREEN_SIZE, SCREEN_SIZE, keys.size());
+    ESP_UTILS_CHECK_FALSE_GOTO(
+        ret = run_typing(device, *keyboard, text_edit, keys, false, results[0]), end, "Run without cache failed"
+    );
+    ESP_UTILS_CHECK_FALSE_GOTO(
+        ret = run_typing(device, *keyboard, text_edit, keys, true, results[1]), end, "Run with cache failed"
+    );
+    print_run("lv_keyboard", results[0]);
+    print_run("cached layers", results[1]);
+
+    for (size_t i = 0; i < results[0].hashes.size(); i++) {
+        mismatch_num += (results[0].hashes[i] != results[1].hashes[i]);
+    }
+    printf("  keyboard pixels: %d of %zu steps differ\n", mismatch_num, results[0].hashes.size());
+    printf("  text: %s\n", results[1].text.c_str());
+    ESP_UTILS_CHECK_FALSE_GOTO(ret = (mismatch_num == 0), end, "The cached layers are not drawn the same");
+    ESP_UTILS_CHECK_FALSE_GOTO(ret = (results[0].text == results[1].text), end, "The typed texts differ");
+    ESP_UTILS_CHECK_FALSE_GOTO(
+        ret = (results[1].text == text), end, "The typed text is not the expected one"
+    );
+
+    printf(
+        "  prediction: lookup us p50 %u p99 %u max %u | visits p50 %u max %u\n",
+        get_percentile(results[1].lookup_us, 50), get_percentile(results[1].lookup_us, 99),
+        get_percentile(results[1].lookup_us, 100), get_percentile(results[1].lookup_visits, 50),
+        get_percentile(results[1].lookup_visits, 100)
+    );
+
+end:
+    keyboard.reset();
+    parent.reset();
+    phone.reset();
+    device.del();
+    gui::LvLock::unregisterCallbacks();
+    lv_deinit();
+
+    return ret;
+}
+
+bool parse_options(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            options.is_quick = true;
+            options.word_num = 3000;
+        } else if ((strcmp(argv[i], "--words") == 0) && (i + 1 < argc)) {
+            options.word_num = std::atoi(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+
+    return (options.word_num > 0);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        printf("Usage: %s [--quick] [--words <num>]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    esp_utils::host_log_level = ESP_UTILS_LOG_LEVEL_ERROR;
+
+    return run(options) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,183 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include "esp_lib_utils.h"
+#include "sim_device.hpp"
+
+namespace esp_brookesia::host_sim {
+
+uint32_t SimDevice::_tick_ms = 0;
+
+uint64_t get_time_us()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()
+           ).count();
+}
+
+SimDevice::~SimDevice()
+{
+    del();
+}
+
+bool SimDevice::begin(int width, int height, int buffer_lines)
+{
+    ESP_UTILS_CHECK_FALSE_RETURN(_display == nullptr, false, "Already begun");
+    ESP_UTILS_CHECK_FALSE_RETURN((width > 0) && (height > 0) && (buffer_lines > 0), false, "Invalid size");
+
+    lv_tick_set_cb(onTickGet);
+
+    size_t buffer_size = width * buffer_lines * lv_color_format_get_size(LV_COLOR_FORMAT_RGB565);
+    // LVGL requires the draw buffer to be aligned, `aligned_alloc()` also requires the size to be a multiple of it
+    size_t alloc_size = (buffer_size + LV_DRAW_BUF_ALIGN - 1) / LV_DRAW_BUF_ALIGN * LV_DRAW_BUF_ALIGN;
+    _draw_buffer.reset(static_cast<uint8_t *>(std::aligned_alloc(LV_DRAW_BUF_ALIGN, alloc_size)));
+    ESP_UTILS_CHECK_NULL_RETURN(_draw_buffer, false, "Allocate draw buffer failed");
+    _framebuffer.reset(new uint16_t[width * height]());
+
+    _display = lv_display_create(width, height);
+    ESP_UTILS_CHECK_NULL_RETURN(_display, false, "Create display failed");
+    lv_display_set_color_format(_display, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(_display, _draw_buffer.get(), nullptr, buffer_size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(_display, onFlush);
+    lv_display_set_user_data(_display, this);
+    lv_display_add_event_cb(_display, onRefreshEvent, LV_EVENT_REFR_START, this);
+    lv_display_add_event_cb(_display, onRefreshEvent, LV_EVENT_REFR_READY, this);
+
+    _touch = lv_indev_create();
+    ESP_UTILS_CHECK_NULL_RETURN(_touch, false, "Create touch failed");
+    lv_indev_set_type(_touch, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_display(_touch, _display);
+    lv_indev_set_read_cb(_touch, onTouchRead);
+    lv_indev_set_driver_data(_touch, this);
+
+    _width = width;
+    _height = height;
+    _frames.clear();
+    _handler_max_us = 0;
+
+    return true;
+}
+
+void SimDevice::del()
+{
+    if (_touch != nullptr) {
+        lv_indev_delete(_touch);
+        _touch = nullptr;
+    }
+    if (_display != nullptr) {
+        lv_display_delete(_display);
+        _display = nullptr;
+    }
+    _draw_buffer.reset();
+    _framebuffer.reset();
+    _frames.clear();
+}
+
+void SimDevice::step(uint32_t ms)
+{
+    _tick_ms += ms;
+
+    uint64_t start_us = get_time_us();
+    lv_timer_handler();
+    _handler_max_us = std::max(_handler_max_us, static_cast<uint32_t>(get_time_us() - start_us));
+}
+
+void SimDevice::stepFor(uint32_t duration_ms, uint32_t period_ms)
+{
+    for (uint32_t elapsed_ms = 0; elapsed_ms < duration_ms; elapsed_ms += period_ms) {
+        step(period_ms);
+    }
+}
+
+void SimDevice::setPointer(int x, int y, bool is_pressed)
+{
+    _point.x = x;
+    _point.y = y;
+    _is_pressed = is_pressed;
+}
+
+void SimDevice::releasePointer()
+{
+    _is_pressed = false;
+}
+
+void SimDevice::swipe(int x_start, int y_start, int x_end, int y_end, uint32_t duration_ms, uint32_t period_ms)
+{
+    int step_num = std::max<int>(1, duration_ms / period_ms);
+    for (int i = 0; i <= step_num; i++) {
+        setPointer(x_start + (x_end - x_start) * i / step_num, y_start + (y_end - y_start) * i / step_num, true);
+        step(period_ms);
+    }
+    releasePointer();
+    step(period_ms);
+}
+
+std::vector<SimDevice::Frame> SimDevice::takeFrames()
+{
+    std::vector<Frame> frames;
+    frames.swap(_frames);
+
+    return frames;
+}
+
+uint32_t SimDevice::takeHandlerMaxUs()
+{
+    uint32_t handler_max_us = _handler_max_us;
+    _handler_max_us = 0;
+
+    return handler_max_us;
+}
+
+uint32_t SimDevice::onTickGet()
+{
+    return _tick_ms;
+}
+
+void SimDevice::onFlush(lv_display_t *display, const lv_area_t *area, uint8_t *px_map)
+{
+    auto device = static_cast<SimDevice *>(lv_display_get_user_data(display));
+    int width = lv_area_get_width(area);
+    int height = lv_area_get_height(area);
+
+    // Copy into the framebuffer like a real panel driver would, so the flush cost is part of the figures
+    auto src = reinterpret_cast<const uint16_t *>(px_map);
+    for (int y = 0; y < height; y++) {
+        std::memcpy(&device->_framebuffer[(area->y1 + y) * device->_width + area->x1], src, width * sizeof(uint16_t));
+        src += width;
+    }
+    device->_frame.area_num++;
+    device->_frame.pixel_num += width * height;
+
+    lv_display_flush_ready(display);
+}
+
+void SimDevice::onTouchRead(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    auto device = static_cast<SimDevice *>(lv_indev_get_driver_data(indev));
+
+    data->point = device->_point;
+    data->state = device->_is_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+void SimDevice::onRefreshEvent(lv_event_t *event)
+{
+    auto device = static_cast<SimDevice *>(lv_event_get_user_data(event));
+
+    if (lv_event_get_code(event) == LV_EVENT_REFR_START) {
+        device->_frame = {};
+        device->_refresh_start_us = get_time_us();
+        return;
+    }
+    // Only the refreshes which redraw something are frames
+    if (device->_frame.pixel_num > 0) {
+        device->_frame.render_us = static_cast<uint32_t>(get_time_us() - device->_refresh_start_us);
+        device->_frames.push_back(device->_frame);
+    }
+}
+
+} // namespace esp_brookesia::host_sim
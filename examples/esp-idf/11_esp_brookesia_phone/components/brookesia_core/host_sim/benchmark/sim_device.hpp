@@ -0,0 +1,114 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include "lvgl.h"
+
+namespace esp_brookesia::host_sim {
+
+/**
+ * @brief A headless LVGL device: an RGB565 framebuffer display, a scripted pointer and a simulated tick.
+ *
+ * The time only moves in `step()`, so a run is deterministic and does not depend on the host speed. The wall-clock
+ * time spent in `lv_timer_handler()` and in the rendering of every frame is recorded as the performance figures.
+ */
+class SimDevice {
+public:
+    struct Frame {
+        uint32_t render_us;         // From `LV_EVENT_REFR_START` to `LV_EVENT_REFR_READY`
+        uint32_t area_num;          // Number of flushed areas
+        uint32_t pixel_num;         // Number of flushed pixels
+    };
+
+    SimDevice() = default;
+    ~SimDevice();
+
+    SimDevice(const SimDevice &) = delete;
+    SimDevice &operator=(const SimDevice &) = delete;
+
+    bool begin(int width, int height, int buffer_lines);
+    void del();
+
+    /**
+     * @brief Advance the simulated time by `ms` and run the LVGL timers
+     */
+    void step(uint32_t ms);
+    void stepFor(uint32_t duration_ms, uint32_t period_ms);
+
+    void setPointer(int x, int y, bool is_pressed);
+    void releasePointer();
+
+    /**
+     * @brief Move the pointer from one point to another with a pressed touch, then release it. The frames rendered
+     *        meanwhile are recorded as usual.
+     */
+    void swipe(int x_start, int y_start, int x_end, int y_end, uint32_t duration_ms, uint32_t period_ms);
+
+    /**
+     * @brief Take the frames rendered since the last call
+     */
+    std::vector<Frame> takeFrames();
+
+    /**
+     * @brief Take the longest wall-clock time spent in `lv_timer_handler()` since the last call, in microseconds
+     */
+    uint32_t takeHandlerMaxUs();
+
+    lv_display_t *getDisplay() const
+    {
+        return _display;
+    }
+    lv_indev_t *getTouch() const
+    {
+        return _touch;
+    }
+    int getWidth() const
+    {
+        return _width;
+    }
+    int getHeight() const
+    {
+        return _height;
+    }
+    /**
+     * @brief Get the RGB565 pixels flushed so far, `getWidth()` x `getHeight()`
+     */
+    const uint16_t *getFramebuffer() const
+    {
+        return _framebuffer.get();
+    }
+
+private:
+    static uint32_t onTickGet();
+    static void onFlush(lv_display_t *display, const lv_area_t *area, uint8_t *px_map);
+    static void onTouchRead(lv_indev_t *indev, lv_indev_data_t *data);
+    static void onRefreshEvent(lv_event_t *event);
+
+    int _width = 0;
+    int _height = 0;
+    lv_display_t *_display = nullptr;
+    lv_indev_t *_touch = nullptr;
+    std::unique_ptr<uint8_t, decltype(&std::free)> _draw_buffer{nullptr, std::free};
+    std::unique_ptr<uint16_t[]> _framebuffer;
+
+    lv_point_t _point = {};
+    bool _is_pressed = false;
+
+    uint64_t _refresh_start_us = 0;
+    Frame _frame = {};
+    std::vector<Frame> _frames;
+    uint32_t _handler_max_us = 0;
+
+    static uint32_t _tick_ms;
+};
+
+uint64_t get_time_us();
+
+} // namespace esp_brookesia::host_sim
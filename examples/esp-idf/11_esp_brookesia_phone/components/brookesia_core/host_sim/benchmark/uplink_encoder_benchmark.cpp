@@ -0,0 +1,343 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * Benchmark of the uplink encoder of the agent. It generates speech-like PCM at 8 kHz and feeds it to the encoder in
+ * chunks of uneven sizes, as the recorder may return them, with each codec built on the host. It decodes the packets
+ * and reports the encode time per 120 ms packet, the CPU load, the bytes per second, the SNR and the heap allocations
+ * while encoding. It fails if a packet has an unexpected size, if the SNR is too low or if encoding allocates.
+ *
+ * Opus needs `esp_audio_codec`, so it is only measured on the device (see `coze_chat_app_dump_audio_ring_stats()`).
+ *
+ * Usage: brookesia_host_uplink_encoder_benchmark [--quick]
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <vector>
+#include "esp_lib_utils.h"
+#include "agent/audio_uplink_encoder.hpp"
+#include "agent/audio_voice_gate.hpp"
+
+using namespace esp_brookesia::ai_framework;
+
+namespace {
+
+constexpr uint32_t SAMPLE_RATE = 8000;
+constexpr size_t FRAME_SAMPLE_NUM = 960;
+constexpr uint32_t FRAME_DURATION_MS = FRAME_SAMPLE_NUM * 1000 / SAMPLE_RATE;
+constexpr int AUDIO_DURATION_S = 60;
+constexpr int QUICK_AUDIO_DURATION_S = 10;
+constexpr int ROUND_NUM = 20;
+constexpr int QUICK_ROUND_NUM = 3;
+// The recorder may return less than a frame, or more if the reads are late
+constexpr size_t CHUNK_SAMPLE_NUMS[] = {960, 700, 1220, 480, 1440, 960, 37, 883};
+
+std::atomic<uint64_t> alloc_count{0};
+
+struct CodecInfo {
+    AudioUplinkEncoder::Codec codec;
+    size_t packet_size;
+    double snr_min_db;
+};
+
+const CodecInfo CODEC_INFOS[] = {
+    {AudioUplinkEncoder::Codec::PCM, FRAME_SAMPLE_NUM * 2, 90},
+    {AudioUplinkEncoder::Codec::G711A, FRAME_SAMPLE_NUM, 30},
+    {AudioUplinkEncoder::Codec::IMA_ADPCM, 4 + FRAME_SAMPLE_NUM / 2, 15},
+    {AudioUplinkEncoder::Codec::OPUS, 0, 0},
+};
+
+/**
+ * @brief Generate speech-like audio: voiced syllables and fricatives in words, pauses and a little room noise
+ */
+std::vector<int16_t> generate_audio(int duration_s)
+{
+    std::mt19937 random(1);
+    std::normal_distribution<float> noise(0, 1);
+    std::uniform_real_distribution<float> pitch(100, 220);
+    std::uniform_real_distribution<float> level(2000, 9000);
+    std::uniform_int_distribution<int> syllable_ms(100, 260);
+    std::uniform_int_distribution<int> pause_ms(30, 600);
+    std::bernoulli_distribution is_fricative(0.25);
+
+    std::vector<float> audio(static_cast<size_t>(duration_s) * SAMPLE_RATE, 0);
+    size_t pos = 0;
+    while (pos < audio.size()) {
+        size_t num = std::min(audio.size() - pos, static_cast<size_t>(syllable_ms(random)) * SAMPLE_RATE / 1000);
+        if (is_fricative(random)) {
+            float last = 0;
+            for (size_t i = 0; i < num; i++) {
+                float value = noise(random);
+                audio[pos + i] += 1200 * (value - last);
+                last = value;
+            }
+        } else {
+            float f0 = pitch(random);
+            float amplitude = level(random);
+            float phase = 0;
+            for (size_t i = 0; i < num; i++) {
+                float envelope = std::min({1.0f, i / 160.0f, (num - i) / 160.0f});
+                phase += 2 * M_PI * f0 * (1 - 0.1f * i / num) / SAMPLE_RATE;
+                float value = 0;
+                for (int k = 1; k * f0 < 3400; k++) {
+                    value += sinf(k * phase) / (k * k);
+                }
+                audio[pos + i] += amplitude * envelope * value * 0.5f;
+            }
+        }
+        pos += num + static_cast<size_t>(pause_ms(random)) * SAMPLE_RATE / 1000;
+    }
+
+    // Whole packets, so that each round starts with an empty frame
+    std::vector<int16_t> samples(audio.size() / FRAME_SAMPLE_NUM * FRAME_SAMPLE_NUM);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = static_cast<int16_t>(std::clamp(audio[i] + 20 * noise(random), -32768.0f, 32767.0f));
+    }
+
+    return samples;
+}
+
+/**
+ * @brief Decode an IMA-ADPCM packet, the reference decoder of the IMA recommendation
+ */
+void decode_ima_adpcm(const uint8_t *data, size_t sample_num, int16_t *samples)
+{
+    static const int16_t STEPS[89] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+        107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+        876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871,
+        5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623,
+        27086, 29794, 32767
+    };
+    static const int INDEX_ADJUSTS[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+    int predictor = static_cast<int16_t>(data[0] | (data[1] << 8));
+    int index = data[2];
+    samples[0] = static_cast<int16_t>(predictor);
+    for (size_t i = 1; i < sample_num; i++) {
+        uint8_t code = data[4 + (i - 1) / 2];
+        code = ((i - 1) & 1) ? (code >> 4) : (code & 0x0F);
+        int step = STEPS[index];
+        int delta = step >> 3;
+        delta += (code & 4) ? step : 0;
+        delta += (code & 2) ? step >> 1 : 0;
+        delta += (code & 1) ? step >> 2 : 0;
+        predictor = std::clamp((code & 8) ? predictor - delta : predictor + delta, -32768, 32767);
+        index = std::clamp(index + INDEX_ADJUSTS[code & 7], 0, 88);
+        samples[i] = static_cast<int16_t>(predictor);
+    }
+}
+
+double get_snr_db(const std::vector<int16_t> &reference, const std::vector<int16_t> &decoded)
+{
+    double signal = 0;
+    double error = 0;
+    for (size_t i = 0; i < decoded.size(); i++) {
+        signal += static_cast<double>(reference[i]) * reference[i];
+        error += static_cast<double>(reference[i] - decoded[i]) * (reference[i] - decoded[i]);
+    }
+
+    return 10 * log10(signal / std::max(error, 1.0));
+}
+
+/**
+ * @brief Encode the audio with a codec, and check its packets
+ */
+bool run_codec(const CodecInfo &info, const std::vector<int16_t> &audio, int round_num)
+{
+    const char *name = AudioUplinkEncoder::getCodecName(info.codec);
+    if (!AudioUplinkEncoder::checkCodecSupported(info.codec)) {
+        printf("%-9s | not built on the host\n", name);
+        return true;
+    }
+
+    size_t packet_num_max = audio.size() / FRAME_SAMPLE_NUM;
+    std::vector<uint8_t> packets(packet_num_max * info.packet_size);
+    size_t packet_num = 0;
+    bool is_size_valid = true;
+    AudioUplinkEncoder encoder;
+    auto output = [&](const uint8_t *data, size_t size) {
+        if ((size != info.packet_size) || (packet_num >= packet_num_max)) {
+            is_size_valid = false;
+            return false;
+        }
+        memcpy(&packets[packet_num * info.packet_size], data, size);
+        packet_num++;
+        return true;
+    };
+    AudioUplinkEncoder::Config config = {
+        .sample_rate = SAMPLE_RATE,
+        .frame_sample_num = FRAME_SAMPLE_NUM,
+        .opus_bitrate = 16000,
+        .codec = info.codec,
+    };
+    if (!encoder.begin(config, output)) {
+        printf("Begin encoder(%s) failed\n", name);
+        return false;
+    }
+
+    std::vector<double> round_us_per_packet;
+    round_us_per_packet.reserve(round_num);
+    uint64_t alloc_start = alloc_count.load();
+    for (int round = 0; round < round_num; round++) {
+        packet_num = 0;
+        auto start = std::chrono::steady_clock::now();
+        size_t pos = 0;
+        for (int i = 0; pos < audio.size(); i++) {
+            size_t num = std::min(audio.size() - pos, CHUNK_SAMPLE_NUMS[i % std::size(CHUNK_SAMPLE_NUMS)]);
+            encoder.encode(&audio[pos], num);
+            pos += num;
+        }
+        auto elapsed_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        round_us_per_packet.push_back(elapsed_us / std::max<size_t>(packet_num, 1));
+    }
+    uint64_t alloc_num = alloc_count.load() - alloc_start;
+    auto stats = encoder.getStats();
+    encoder.del();
+
+    std::vector<int16_t> decoded(packet_num * FRAME_SAMPLE_NUM);
+    for (size_t i = 0; i < packet_num; i++) {
+        const uint8_t *packet = &packets[i * info.packet_size];
+        int16_t *samples = &decoded[i * FRAME_SAMPLE_NUM];
+        switch (info.codec) {
+        case AudioUplinkEncoder::Codec::PCM:
+            memcpy(samples, packet, info.packet_size);
+            break;
+        case AudioUplinkEncoder::Codec::G711A:
+            decodeG711A(packet, FRAME_SAMPLE_NUM, samples);
+            break;
+        case AudioUplinkEncoder::Codec::IMA_ADPCM:
+            decode_ima_adpcm(packet, FRAME_SAMPLE_NUM, samples);
+            break;
+        default:
+            break;
+        }
+    }
+    double snr_db = get_snr_db(audio, decoded);
+
+    std::sort(round_us_per_packet.begin(), round_us_per_packet.end());
+    double us_per_packet = round_us_per_packet[round_us_per_packet.size() / 2];
+    printf(
+        "%-9s | %5zu B/packet | %6.0f B/s | %5.1f us/packet (max %4u us) | CPU %.4f %% | SNR %5.1f dB | "
+        "allocations %llu\n", name, info.packet_size, info.packet_size * 1000.0 / FRAME_DURATION_MS, us_per_packet,
+        static_cast<unsigned>(stats.encode_time_max_us), us_per_packet / (FRAME_DURATION_MS * 1000.0) * 100, snr_db,
+        static_cast<unsigned long long>(alloc_num)
+    );
+
+    bool ret = true;
+    if (!is_size_valid || (packet_num != packet_num_max)) {
+        printf("FAILED: %zu packets of %zu expected, sizes %s\n", packet_num, packet_num_max,
+               is_size_valid ? "valid" : "invalid");
+        ret = false;
+    }
+    if (snr_db < info.snr_min_db) {
+        printf("FAILED: SNR %.1f dB below %.1f dB\n", snr_db, info.snr_min_db);
+        ret = false;
+    }
+    if (alloc_num != 0) {
+        printf("FAILED: encoding allocated %llu times\n", static_cast<unsigned long long>(alloc_num));
+        ret = false;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Change the codec while encoding, the next packet must use the new one
+ */
+bool run_codec_change(const std::vector<int16_t> &audio)
+{
+    std::vector<size_t> sizes;
+    sizes.reserve(16);
+    AudioUplinkEncoder encoder;
+    AudioUplinkEncoder::Config config = {
+        .sample_rate = SAMPLE_RATE,
+        .frame_sample_num = FRAME_SAMPLE_NUM,
+        .opus_bitrate = 16000,
+        .codec = AudioUplinkEncoder::Codec::G711A,
+    };
+    auto output = [&](const uint8_t *data, size_t size) {
+        sizes.push_back(size);
+        return true;
+    };
+    if (!encoder.begin(config, output)) {
+        printf("Begin encoder failed\n");
+        return false;
+    }
+
+    uint64_t alloc_start = alloc_count.load();
+    encoder.encode(&audio[0], FRAME_SAMPLE_NUM + 100);
+    encoder.requestCodec(AudioUplinkEncoder::Codec::IMA_ADPCM);
+    encoder.encode(&audio[FRAME_SAMPLE_NUM + 100], FRAME_SAMPLE_NUM);
+    encoder.requestCodec(AudioUplinkEncoder::Codec::PCM);
+    encoder.encode(&audio[2 * FRAME_SAMPLE_NUM + 100], 2 * FRAME_SAMPLE_NUM);
+    uint64_t alloc_num = alloc_count.load() - alloc_start;
+    bool is_codec_valid = encoder.getCodec() == AudioUplinkEncoder::Codec::PCM;
+    encoder.del();
+
+    const std::vector<size_t> expected_sizes = {
+        FRAME_SAMPLE_NUM, 4 + FRAME_SAMPLE_NUM / 2, 2 * FRAME_SAMPLE_NUM, 2 * FRAME_SAMPLE_NUM
+    };
+    if ((sizes != expected_sizes) || !is_codec_valid || (alloc_num != 0)) {
+        printf("FAILED: codec change, %zu packets, %llu allocations\n", sizes.size(),
+               static_cast<unsigned long long>(alloc_num));
+        return false;
+    }
+    printf("Codec change: G711A -> IMA-ADPCM -> PCM, the partial frames are dropped\n");
+
+    return true;
+}
+
+} // namespace
+
+void *operator new(size_t size)
+{
+    alloc_count.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+int main(int argc, char **argv)
+{
+    bool is_quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !is_quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    esp_utils::host_log_level = ESP_UTILS_LOG_LEVEL_ERROR;
+
+    int duration_s = is_quick ? QUICK_AUDIO_DURATION_S : AUDIO_DURATION_S;
+    int round_num = is_quick ? QUICK_ROUND_NUM : ROUND_NUM;
+    std::vector<int16_t> audio = generate_audio(duration_s);
+    printf("%d s of audio at %u Hz, %u ms packets, %d rounds\n", duration_s, static_cast<unsigned>(SAMPLE_RATE),
+           static_cast<unsigned>(FRAME_DURATION_MS), round_num);
+
+    bool ret = true;
+    for (const auto &info : CODEC_INFOS) {
+        ret = run_codec(info, audio, round_num) && ret;
+    }
+    ret = run_codec_change(audio) && ret;
+
+    return ret ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,289 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * Heap fragmentation benchmark of the phone widgets. It opens and closes apps for many cycles, half of them with a
+ * status icon, and shows the recents screen now and then. Every 1000 cycles it reports the LVGL heap and the widget
+ * pools of the recents screen and the status bar. It fails if a pool still creates widgets after the warm-up or if the
+ * used heap grows.
+ *
+ * Build with `CONFIG_ESP_BROOKESIA_PHONE_RECENTS_SCREEN_SNAPSHOT_POOL_SIZE` and
+ * `CONFIG_ESP_BROOKESIA_PHONE_STATUS_BAR_ICON_POOL_SIZE` set to 0 in `sdkconfig.h` to compare without the pools.
+ *
+ * Usage: brookesia_host_widget_pool_benchmark [--quick] [--cycles <num>]
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "esp_lib_utils.h"
+#include "gui/lvgl/esp_brookesia_lv_lock.hpp"
+#include "systems/phone/esp_brookesia_phone.hpp"
+#include "systems/phone/stylesheets/esp_brookesia_phone_stylesheets.hpp"
+#include "systems/phone/assets/esp_brookesia_phone_assets.h"
+#include "sim_device.hpp"
+
+using namespace esp_brookesia;
+using namespace esp_brookesia::host_sim;
+
+namespace {
+
+constexpr int WIDTH = 480;
+constexpr int HEIGHT = 480;
+constexpr uint32_t FRAME_PERIOD_MS = LV_DEF_REFR_PERIOD;
+constexpr uint32_t SETTLE_TIME_MS = 1000;
+constexpr uint32_t STEP_TIME_MS = 3 * FRAME_PERIOD_MS;
+constexpr int DRAW_BUFFER_LINES = 40;
+constexpr int APP_NUM = 4;
+constexpr int RECENTS_SCREEN_PERIOD = 10;
+constexpr int WARMUP_CYCLE_NUM = 2 * APP_NUM * RECENTS_SCREEN_PERIOD;
+constexpr int REPORT_PERIOD = 1000;
+// The objects of the apps themselves are created and deleted with them, so the used heap may move by a few blocks
+constexpr size_t USED_GROWTH_MAX = 1024;
+
+struct Options {
+    int cycle_num = 10000;
+};
+
+/**
+ * @brief An app with a small screen, and a status icon if it is given one
+ */
+class PoolApp: public systems::phone::App {
+public:
+    // The core keeps a pointer to the name, it must outlive the app
+    PoolApp(const std::string &name, const void *status_icon):
+        App(
+            systems::base::App::Config::SIMPLE_CONSTRUCTOR(name.c_str(), nullptr, true),
+            systems::phone::App::Config::SIMPLE_CONSTRUCTOR(status_icon, true, true)
+        )
+    {
+    }
+
+    bool run() override
+    {
+        lv_obj_t *label = lv_label_create(lv_screen_active());
+        lv_label_set_text(label, "Pool");
+        lv_obj_center(label);
+
+        return true;
+    }
+
+    bool back() override
+    {
+        return notifyCoreClosed();
+    }
+};
+
+struct HeapInfo {
+    size_t used;
+    size_t free_biggest;
+    int frag_pct;
+};
+
+HeapInfo get_heap_info()
+{
+    lv_mem_monitor_t monitor = {};
+    lv_mem_monitor(&monitor);
+
+    return {monitor.total_size - monitor.free_size, monitor.free_biggest_size, monitor.frag_pct};
+}
+
+/**
+ * @brief Get the number of widgets created by a pool which keeps widgets, a pool of size 0 creates each of them
+ */
+template <typename Pool>
+int get_pool_create_num(const Pool *pool)
+{
+    return ((pool != nullptr) && (pool->getFreeNumMax() > 0)) ? pool->getStats().create_num : 0;
+}
+
+template <typename Pool>
+void print_pool(const char *name, const Pool *pool)
+{
+    if (pool == nullptr) {
+        printf(" | %s none", name);
+        return;
+    }
+    auto stats = pool->getStats();
+    printf(
+        " | %s created %d reused %d deleted %d", name, stats.create_num, stats.reuse_num, stats.destroy_num
+    );
+}
+
+bool run(const Options &options)
+{
+    lv_init();
+    gui::LvLock::registerCallbacks([](int) {
+        lv_lock();
+        return true;
+    }, []() {
+        lv_unlock();
+        return true;
+    });
+
+    SimDevice device;
+    ESP_UTILS_CHECK_FALSE_RETURN(device.begin(WIDTH, HEIGHT, DRAW_BUFFER_LINES), false, "Begin device failed");
+
+    bool ret = false;
+    std::vector<std::string> app_names(APP_NUM);
+    std::vector<std::unique_ptr<PoolApp>> apps;
+    std::vector<int> app_ids;
+    auto phone = std::make_unique<systems::phone::Phone>(device.getDisplay());
+    const systems::phone::RecentsScreen *recents_screen = nullptr;
+    const systems::phone::StatusBar *status_bar = nullptr;
+    HeapInfo warmup_heap = {};
+    HeapInfo heap = {};
+    int warmup_create_num = 0;
+    int create_num = 0;
+    size_t used_max = 0;
+
+    auto send_app_start = [&](int id) {
+        systems::base::Context::AppEventData event = {id, systems::base::Context::AppEventType::START, nullptr};
+        return phone->sendAppEvent(&event);
+    };
+    auto send_navigate = [&](systems::base::Manager::NavigateType type) {
+        return phone->sendNavigateEvent(type);
+    };
+    auto get_create_num = [&]() {
+        return get_pool_create_num(recents_screen->getSnapshotPool()) +
+               get_pool_create_num(status_bar->getIconPool());
+    };
+
+    ESP_UTILS_CHECK_FALSE_GOTO(phone->setTouchDevice(device.getTouch()), end, "Set touch device failed");
+    ESP_UTILS_CHECK_FALSE_GOTO(
+        phone->addStylesheet(&systems::phone::STYLESHEET_480_480_DARK), end, "Add stylesheet failed"
+    );
+    ESP_UTILS_CHECK_FALSE_GOTO(
+        phone->activateStylesheet(&systems::phone::STYLESHEET_480_480_DARK), end, "Activate stylesheet failed"
+    );
+    ESP_UTILS_CHECK_FALSE_GOTO(phone->begin(), end, "Begin phone failed");
+    recents_screen = phone->getDisplay().getRecentsScreen();
+    status_bar = phone->getDisplay().getStatusBar();
+    ESP_UTILS_CHECK_FALSE_GOTO(
+        (recents_screen != nullptr) && (status_bar != nullptr), end, "No recents screen or status bar"
+    );
+
+    for (int i = 0; i < APP_NUM; i++) {
+        app_names[i] = "App " + std::to_string(i);
+        apps.push_back(std::make_unique<PoolApp>(
+                           app_names[i], (i % 2 == 0) ? &esp_brookesia_image_small_app_launcher_default_98_98 : nullptr
+                       ));
+        app_ids.push_back(phone->installApp(apps.back().get()));
+        ESP_UTILS_CHECK_FALSE_GOTO(app_ids.back() >= 0, end, "Install app(%d) failed", i);
+    }
+    device.stepFor(SETTLE_TIME_MS, FRAME_PERIOD_MS);
+
+    // The first app stays in the background, so the recents screen always has a snapshot besides the cycled one
+    ret = send_app_start(app_ids[0]) && send_navigate(systems::base::Manager::NavigateType::HOME);
+    ESP_UTILS_CHECK_FALSE_GOTO(ret, end, "Start background app failed");
+    device.stepFor(SETTLE_TIME_MS, FRAME_PERIOD_MS);
+
+    printf("%dx%d, %d apps, %d cycles\n", WIDTH, HEIGHT, APP_NUM, options.cycle_num);
+    for (int cycle = 0; cycle < WARMUP_CYCLE_NUM + options.cycle_num; cycle++) {
+        int id = app_ids[1 + cycle % (APP_NUM - 1)];
+        ret = send_app_start(id);
+        device.stepFor(STEP_TIME_MS, FRAME_PERIOD_MS);
+        if (cycle % RECENTS_SCREEN_PERIOD == 0) {
+            ret = send_navigate(systems::base::Manager::NavigateType::RECENTS_SCREEN) && ret;
+            device.stepFor(STEP_TIME_MS, FRAME_PERIOD_MS);
+            ret = send_navigate(systems::base::Manager::NavigateType::HOME) && ret;
+            device.stepFor(STEP_TIME_MS, FRAME_PERIOD_MS);
+            ret = send_app_start(id) && ret;
+            device.stepFor(STEP_TIME_MS, FRAME_PERIOD_MS);
+        }
+        ret = send_navigate(systems::base::Manager::NavigateType::BACK) && ret;
+        device.stepFor(STEP_TIME_MS, FRAME_PERIOD_MS);
+        ESP_UTILS_CHECK_FALSE_GOTO(ret, end, "Cycle(%d) failed", cycle);
+
+        heap = get_heap_info();
+        if (cycle < WARMUP_CYCLE_NUM) {
+            warmup_heap = heap;
+            warmup_create_num = get_create_num();
+            continue;
+        }
+        used_max = std::max(used_max, heap.used);
+        int count = cycle - WARMUP_CYCLE_NUM + 1;
+        if ((count % REPORT_PERIOD == 0) || (count == options.cycle_num)) {
+            printf(
+                "  cycle %5d | heap used %6zu B frag %3d%% biggest free %7zu B", count, heap.used, heap.frag_pct,
+                heap.free_biggest
+            );
+            print_pool("snapshots", recents_screen->getSnapshotPool());
+            print_pool("icons", status_bar->getIconPool());
+            printf("\n");
+        }
+    }
+    ESP_UTILS_CHECK_FALSE_GOTO(phone->getManager().getRunningAppCount() == 1, end, "Apps are still running");
+
+    create_num = get_create_num();
+    printf(
+        "after warm-up: heap used %+lld B (max %+lld B), frag %d%% -> %d%%, biggest free %zu -> %zu B, "
+        "pooled widgets created %d\n", static_cast<long long>(heap.used) - static_cast<long long>(warmup_heap.used),
+        static_cast<long long>(used_max) - static_cast<long long>(warmup_heap.used), warmup_heap.frag_pct,
+        heap.frag_pct, warmup_heap.free_biggest, heap.free_biggest, create_num - warmup_create_num
+    );
+    if (create_num != warmup_create_num) {
+        printf("FAILED: the pools created %d widgets after the warm-up\n", create_num - warmup_create_num);
+        ret = false;
+    }
+    if (heap.used > warmup_heap.used + USED_GROWTH_MAX) {
+        printf("FAILED: the used heap grew by %zu B\n", heap.used - warmup_heap.used);
+        ret = false;
+    }
+
+    ESP_UTILS_CHECK_FALSE_GOTO(
+        send_app_start(app_ids[0]) && send_navigate(systems::base::Manager::NavigateType::BACK), end,
+        "Close background app failed"
+    );
+    for (int id : app_ids) {
+        ESP_UTILS_CHECK_FALSE_GOTO(phone->uninstallApp(id), end, "Uninstall app(%d) failed", id);
+    }
+
+end:
+    phone.reset();
+    apps.clear();
+    device.del();
+    gui::LvLock::unregisterCallbacks();
+    lv_deinit();
+
+    return ret;
+}
+
+bool parse_options(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            options.cycle_num = 300;
+        } else if ((strcmp(argv[i], "--cycles") == 0) && (i + 1 < argc)) {
+            options.cycle_num = std::atoi(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+
+    return (options.cycle_num > 0);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        printf("Usage: %s [--quick] [--cycles <num>]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    esp_utils::host_log_level = ESP_UTILS_LOG_LEVEL_ERROR;
+
+    if (!run(options)) {
+        printf("Benchmark failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,59 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * LVGL configuration of the host simulator, it follows `sdkconfig.defaults` of the phone example where it matters
+ * for rendering. Options which are not defined here use the LVGL defaults.
+ */
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH              16
+
+/* The builtin allocator is used so the heap high-water mark can be read with `lv_mem_monitor()` */
+#define LV_USE_STDLIB_MALLOC        LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_STRING        LV_STDLIB_CLIB
+#define LV_USE_STDLIB_SPRINTF       LV_STDLIB_CLIB
+#define LV_MEM_SIZE                 (16 * 1024 * 1024U)
+
+#define LV_USE_OS                   LV_OS_PTHREAD
+#define LV_DEF_REFR_PERIOD          15
+#define LV_DRAW_SW_DRAW_UNIT_CNT    1
+
+#define LV_OBJ_STYLE_CACHE          1
+#define LV_USE_SNAPSHOT             1
+#define LV_USE_FLOAT                1
+#define LV_USE_MATRIX               1
+
+#define LV_USE_LOG                  1
+#define LV_LOG_LEVEL                LV_LOG_LEVEL_WARN
+#define LV_LOG_PRINTF               1
+
+#define LV_FONT_MONTSERRAT_8        1
+#define LV_FONT_MONTSERRAT_10       1
+#define LV_FONT_MONTSERRAT_12       1
+#define LV_FONT_MONTSERRAT_14       1
+#define LV_FONT_MONTSERRAT_16       1
+#define LV_FONT_MONTSERRAT_18       1
+#define LV_FONT_MONTSERRAT_20       1
+#define LV_FONT_MONTSERRAT_22       1
+#define LV_FONT_MONTSERRAT_24       1
+#define LV_FONT_MONTSERRAT_26       1
+#define LV_FONT_MONTSERRAT_28       1
+#define LV_FONT_MONTSERRAT_30       1
+#define LV_FONT_MONTSERRAT_32       1
+#define LV_FONT_MONTSERRAT_34       1
+#define LV_FONT_MONTSERRAT_36       1
+#define LV_FONT_MONTSERRAT_38       1
+#define LV_FONT_MONTSERRAT_40       1
+#define LV_FONT_MONTSERRAT_42       1
+#define LV_FONT_MONTSERRAT_44       1
+#define LV_FONT_FMT_TXT_LARGE       1
+#define LV_USE_FONT_COMPRESSED      1
+
+#define LV_BUILD_EXAMPLES           0
+#define LV_BUILD_DEMOS              0
+
+#endif /* LV_CONF_H */
@@ -0,0 +1,39 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * Configuration of the host simulator, in place of the one generated by menuconfig. Only the modules which do not
+ * depend on the ESP-IDF drivers are enabled.
+ */
+#pragma once
+
+// Only the function calling, the uplink voice gate and the uplink encoder of the agent are built, the rest depends on `esp-audio` and the Coze SDK
+#define CONFIG_ESP_BROOKESIA_ENABLE_AI_FRAMEWORK            1
+#define CONFIG_ESP_BROOKESIA_AI_FRAMEWORK_ENABLE_AGENT      1
+
+#define CONFIG_ESP_BROOKESIA_ENABLE_GUI                     1
+#define CONFIG_ESP_BROOKESIA_GUI_ENABLE_ANIM_PLAYER         0
+#define CONFIG_ESP_BROOKESIA_GUI_ENABLE_SQUARELINE          1
+#define CONFIG_ESP_BROOKESIA_SQUARELINE_ENABLE_UI_COMP      1
+#define CONFIG_ESP_BROOKESIA_SQUARELINE_ENABLE_UI_HELPERS   1
+#define CONFIG_ESP_BROOKESIA_LVGL_LOCK_ENABLE_METRICS       1
+// Short, so the LvLock test sees the deadlock reports quickly
+#define CONFIG_ESP_BROOKESIA_LVGL_LOCK_DEADLOCK_REPORT_MS   200
+
+#define CONFIG_ESP_BROOKESIA_ENABLE_SERVICES                1
+#define CONFIG_ESP_BROOKESIA_SERVICES_ENABLE_STORAGE_NVS    1
+
+#define CONFIG_ESP_BROOKESIA_ENABLE_SYSTEMS                 1
+#define CONFIG_ESP_BROOKESIA_SYSTEMS_ENABLE_PHONE           1
+#define CONFIG_ESP_BROOKESIA_PHONE_APP_LAUNCHER_REALIZED_PAGE_RANGE              1
+#define CONFIG_ESP_BROOKESIA_PHONE_APP_LAUNCHER_ENABLE_ICON_IMAGE_CACHE          1
+#define CONFIG_ESP_BROOKESIA_PHONE_APP_LAUNCHER_ICON_IMAGE_CACHE_IDLE_SIZE_KB    256
+#define CONFIG_ESP_BROOKESIA_PHONE_RECENTS_SCREEN_SNAPSHOT_POOL_SIZE            4
+#define CONFIG_ESP_BROOKESIA_PHONE_RECENTS_SCREEN_ENABLE_SNAPSHOT_IMAGE_CACHE   1
+#define CONFIG_ESP_BROOKESIA_PHONE_RECENTS_SCREEN_SNAPSHOT_MOVE_BACK_DURATION_MS 150
+#define CONFIG_ESP_BROOKESIA_PHONE_STATUS_BAR_BATTERY_HYSTERESIS_PERCENT         2
+#define CONFIG_ESP_BROOKESIA_PHONE_STATUS_BAR_WIFI_UPDATE_INTERVAL_MS            3000
+#define CONFIG_ESP_BROOKESIA_PHONE_STATUS_BAR_ICON_POOL_SIZE                     2
+#define CONFIG_ESP_BROOKESIA_SYSTEMS_ENABLE_SPEAKER         0
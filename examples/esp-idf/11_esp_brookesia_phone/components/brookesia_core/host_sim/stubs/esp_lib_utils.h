@@ -0,0 +1,218 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * Host replacement of `esp-lib-utils`, covering only the part used by `brookesia_core`. The log and check macros keep
+ * the same semantics, the messages are printed with `printf()`.
+ */
+#pragma once
+
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#define ESP_UTILS_LOG_LEVEL_DEBUG       (0)
+#define ESP_UTILS_LOG_LEVEL_INFO        (1)
+#define ESP_UTILS_LOG_LEVEL_WARNING     (2)
+#define ESP_UTILS_LOG_LEVEL_ERROR       (3)
+#define ESP_UTILS_LOG_LEVEL_NONE        (4)
+
+#if !defined(ESP_UTILS_CONF_LOG_LEVEL)
+#   define ESP_UTILS_CONF_LOG_LEVEL     ESP_UTILS_LOG_LEVEL_INFO
+#endif
+
+#if !defined(ESP_UTILS_LOG_TAG)
+#   define ESP_UTILS_LOG_TAG            "Utils"
+#endif
+
+namespace esp_utils {
+
+/**
+ * @brief Runtime log level, messages below it are not printed. The simulator raises it to keep the benchmark output
+ *        readable.
+ */
+inline int host_log_level = ESP_UTILS_LOG_LEVEL_INFO;
+
+class function_guard {
+public:
+    using Function = std::function<void()>;
+
+    explicit function_guard(Function func): _func(std::move(func)) {}
+    ~function_guard()
+    {
+        if (_func) {
+            _func();
+        }
+    }
+
+    function_guard(const function_guard &) = delete;
+    function_guard &operator=(const function_guard &) = delete;
+
+    void release()
+    {
+        _func = nullptr;
+    }
+
+private:
+    Function _func;
+};
+
+struct ThreadConfig {
+    const char *name = nullptr;
+    int core_id = -1;
+    int priority = 0;
+    size_t stack_size = 0;
+    bool stack_in_ext = false;
+};
+
+/**
+ * @brief The thread attributes only matter on FreeRTOS, threads use the host defaults
+ */
+class thread_config_guard {
+public:
+    explicit thread_config_guard(const ThreadConfig &) {}
+};
+
+template <typename T>
+class PluginRegistry {
+public:
+    using Factory = std::function<std::shared_ptr<T>()>;
+
+    struct PluginInfo {
+        std::string name;
+        Factory factory;
+    };
+
+    static void registerPlugin(const std::string &name, Factory factory)
+    {
+        std::lock_guard lock(getMutex());
+        getPlugins()[name] = PluginInfo{name, std::move(factory)};
+    }
+
+    static std::shared_ptr<T> get(const std::string &name)
+    {
+        std::lock_guard lock(getMutex());
+        auto &instances = getInstances();
+        auto instance_it = instances.find(name);
+        if (instance_it != instances.end()) {
+            return instance_it->second;
+        }
+        auto &plugins = getPlugins();
+        auto plugin_it = plugins.find(name);
+        if (plugin_it == plugins.end()) {
+            return nullptr;
+        }
+        auto instance = plugin_it->second.factory();
+        instances[name] = instance;
+
+        return instance;
+    }
+
+    static void forEach(const std::function<void(const PluginInfo &)> &func)
+    {
+        std::map<std::string, PluginInfo> plugins;
+        {
+            std::lock_guard lock(getMutex());
+            plugins = getPlugins();
+        }
+        for (auto &[name, plugin] : plugins) {
+            func(plugin);
+        }
+    }
+
+private:
+    static std::mutex &getMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+    static std::map<std::string, PluginInfo> &getPlugins()
+    {
+        static std::map<std::string, PluginInfo> plugins;
+        return plugins;
+    }
+    static std::map<std::string, std::shared_ptr<T>> &getInstances()
+    {
+        static std::map<std::string, std::shared_ptr<T>> instances;
+        return instances;
+    }
+};
+
+template <typename T>
+struct PluginRegistrar {
+    PluginRegistrar(const std::string &name, typename PluginRegistry<T>::Factory factory)
+    {
+        PluginRegistry<T>::registerPlugin(name, std::move(factory));
+    }
+};
+
+} // namespace esp_utils
+
+#define ESP_UTILS_REGISTER_PLUGIN_WITH_CONSTRUCTOR(base_type, plugin_type, name, constructor) \
+    static esp_utils::PluginRegistrar<base_type> _esp_utils_registrar_##plugin_type(name, constructor)
+#define ESP_UTILS_REGISTER_PLUGIN(base_type, plugin_type, name) \
+    ESP_UTILS_REGISTER_PLUGIN_WITH_CONSTRUCTOR(base_type, plugin_type, name, []() { \
+        return std::make_shared<plugin_type>(); \
+    })
+
+/* Log */
+#define ESP_UTILS_LOG_IMPL(level, letter, fmt, ...) do { \
+        if ((level) >= esp_utils::host_log_level) { \
+            printf(letter " [" ESP_UTILS_LOG_TAG "] %s(%d): " fmt "\n", __func__, __LINE__, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#if ESP_UTILS_CONF_LOG_LEVEL <= ESP_UTILS_LOG_LEVEL_DEBUG
+#   define ESP_UTILS_LOGD_IMPL_FUNC(fmt, ...) ESP_UTILS_LOG_IMPL(ESP_UTILS_LOG_LEVEL_DEBUG, "D", fmt, ##__VA_ARGS__)
+#else
+#   define ESP_UTILS_LOGD_IMPL_FUNC(fmt, ...)
+#endif
+#define ESP_UTILS_LOGD(fmt, ...) ESP_UTILS_LOGD_IMPL_FUNC(fmt, ##__VA_ARGS__)
+#define ESP_UTILS_LOGI(fmt, ...) ESP_UTILS_LOG_IMPL(ESP_UTILS_LOG_LEVEL_INFO, "I", fmt, ##__VA_ARGS__)
+#define ESP_UTILS_LOGW(fmt, ...) ESP_UTILS_LOG_IMPL(ESP_UTILS_LOG_LEVEL_WARNING, "W", fmt, ##__VA_ARGS__)
+#define ESP_UTILS_LOGE(fmt, ...) ESP_UTILS_LOG_IMPL(ESP_UTILS_LOG_LEVEL_ERROR, "E", fmt, ##__VA_ARGS__)
+
+#define ESP_UTILS_LOG_TRACE_ENTER()
+#define ESP_UTILS_LOG_TRACE_EXIT()
+#define ESP_UTILS_LOG_TRACE_ENTER_WITH_THIS()
+#define ESP_UTILS_LOG_TRACE_EXIT_WITH_THIS()
+#define ESP_UTILS_LOG_TRACE_GUARD()
+#define ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS()
+
+/* Check */
+#define ESP_UTILS_CHECK_NULL_RETURN(x, ret, fmt, ...) do { \
+        if ((x) == nullptr) { ESP_UTILS_LOGE(fmt, ##__VA_ARGS__); return ret; } \
+    } while (0)
+#define ESP_UTILS_CHECK_NULL_GOTO(x, goto_tag, fmt, ...) do { \
+        if ((x) == nullptr) { ESP_UTILS_LOGE(fmt, ##__VA_ARGS__); goto goto_tag; } \
+    } while (0)
+#define ESP_UTILS_CHECK_NULL_EXIT(x, fmt, ...) do { \
+        if ((x) == nullptr) { ESP_UTILS_LOGE(fmt, ##__VA_ARGS__); return; } \
+    } while (0)
+#define ESP_UTILS_CHECK_FALSE_RETURN(x, ret, fmt, ...) do { \
+        if (!(x)) { ESP_UTILS_LOGE(fmt, ##__VA_ARGS__); return ret; } \
+    } while (0)
+#define ESP_UTILS_CHECK_FALSE_GOTO(x, goto_tag, fmt, ...) do { \
+        if (!(x)) { ESP_UTILS_LOGE(fmt, ##__VA_ARGS__); goto goto_tag; } \
+    } while (0)
+#define ESP_UTILS_CHECK_FALSE_EXIT(x, fmt, ...) do { \
+        if (!(x)) { ESP_UTILS_LOGE(fmt, ##__VA_ARGS__); return; } \
+    } while (0)
+#define ESP_UTILS_CHECK_ERROR_RETURN(x, ret, fmt, ...) do { \
+        if ((x) != 0) { ESP_UTILS_LOGE(fmt, ##__VA_ARGS__); return ret; } \
+    } while (0)
+#define ESP_UTILS_CHECK_VALUE_RETURN(x, min, max, ret, fmt, ...) do { \
+        if (((x) < (min)) || ((x) > (max))) { ESP_UTILS_LOGE(fmt, ##__VA_ARGS__); return ret; } \
+    } while (0)
+#define ESP_UTILS_CHECK_VALUE_EXIT(x, min, max, fmt, ...) do { \
+        if (((x) < (min)) || ((x) > (max))) { ESP_UTILS_LOGE(fmt, ##__VA_ARGS__); return; } \
+    } while (0)
+#define ESP_UTILS_CHECK_EXCEPTION_RETURN(x, ret, fmt, ...) do { \
+        try { x; } catch (const std::exception &e) { ESP_UTILS_LOGE(fmt ": %s", ##__VA_ARGS__, e.what()); return ret; } \
+    } while (0)
@@ -0,0 +1,36 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * Host controls of the NVS of the simulator. Without a file, the NVS is kept in memory only. With a file, standing for
+ * the flash, every commit writes all the namespaces to it, and a restart drops what was set but not committed since, as
+ * a reboot of the board does.
+ */
+#pragma once
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Back the NVS with a file, and load it if it exists
+ *
+ * @param path Path of the file, NULL to keep the NVS in memory only
+ * @return ESP_OK on success, ESP_FAIL if the file is damaged, the NVS is then empty
+ */
+esp_err_t nvs_host_set_file(const char *path);
+
+/**
+ * @brief Reload the NVS from its file, as after a reboot, the open handles are closed
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE without a file, ESP_FAIL if the file is damaged
+ */
+esp_err_t nvs_host_restart(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,404 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "nvs_flash.h"
+#include "nvs.h"
+#include "nvs_host.h"
+
+namespace {
+
+struct Entry {
+    nvs_type_t type;
+    std::vector<uint8_t> data;
+};
+
+using Namespace = std::map<std::string, Entry>;
+
+std::mutex s_mutex;
+std::map<std::string, Namespace> s_namespaces;
+std::map<nvs_handle_t, std::string> s_handles;
+nvs_handle_t s_next_handle = 1;
+std::string s_file_path;
+
+// File of the committed namespaces: the magic, then per entry the namespace, the key, the type and the data, each
+// string and the data after its length, in little-endian
+constexpr uint32_t FILE_MAGIC = 0x4E565348;
+
+void writeU32(std::vector<uint8_t> &out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void writeBytes(std::vector<uint8_t> &out, const void *data, size_t size)
+{
+    writeU32(out, static_cast<uint32_t>(size));
+    auto bytes = static_cast<const uint8_t *>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+bool readU32(const std::vector<uint8_t> &in, size_t &pos, uint32_t &value)
+{
+    if (in.size() - pos < 4) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= static_cast<uint32_t>(in[pos++]) << (8 * i);
+    }
+    return true;
+}
+
+bool readBytes(const std::vector<uint8_t> &in, size_t &pos, std::vector<uint8_t> &data)
+{
+    uint32_t size = 0;
+    if (!readU32(in, pos, size) || (in.size() - pos < size)) {
+        return false;
+    }
+    data.assign(in.begin() + pos, in.begin() + pos + size);
+    pos += size;
+    return true;
+}
+
+// Written to a temporary file then renamed, so the file holds either the previous commit or this one
+esp_err_t saveFile()
+{
+    if (s_file_path.empty()) {
+        return ESP_OK;
+    }
+    std::vector<uint8_t> out;
+    writeU32(out, FILE_MAGIC);
+    for (auto &[ns_name, ns] : s_namespaces) {
+        for (auto &[key, entry] : ns) {
+            writeBytes(out, ns_name.data(), ns_name.size());
+            writeBytes(out, key.data(), key.size());
+            writeU32(out, entry.type);
+            writeBytes(out, entry.data.data(), entry.data.size());
+        }
+    }
+
+    auto tmp_path = s_file_path + ".tmp";
+    FILE *file = fopen(tmp_path.c_str(), "wb");
+    if (file == nullptr) {
+        return ESP_FAIL;
+    }
+    bool is_written = (fwrite(out.data(), 1, out.size(), file) == out.size());
+    is_written = (fclose(file) == 0) && is_written;
+    if (!is_written || (rename(tmp_path.c_str(), s_file_path.c_str()) != 0)) {
+        remove(tmp_path.c_str());
+        return ESP_FAIL;
+    }
+
+    return ESP_OK;
+}
+
+// A missing file is an erased flash
+esp_err_t loadFile()
+{
+    s_namespaces.clear();
+    FILE *file = fopen(s_file_path.c_str(), "rb");
+    if (file == nullptr) {
+        return ESP_OK;
+    }
+    std::vector<uint8_t> in;
+    uint8_t buffer[4096];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        in.insert(in.end(), buffer, buffer + size);
+    }
+    fclose(file);
+
+    size_t pos = 0;
+    uint32_t magic = 0;
+    if (!readU32(in, pos, magic) || (magic != FILE_MAGIC)) {
+        return ESP_FAIL;
+    }
+    while (pos < in.size()) {
+        std::vector<uint8_t> ns_name;
+        std::vector<uint8_t> key;
+        uint32_t type = 0;
+        Entry entry;
+        if (!readBytes(in, pos, ns_name) || !readBytes(in, pos, key) || !readU32(in, pos, type) ||
+                !readBytes(in, pos, entry.data)) {
+            s_namespaces.clear();
+            return ESP_FAIL;
+        }
+        entry.type = static_cast<nvs_type_t>(type);
+        s_namespaces[std::string(ns_name.begin(), ns_name.end())][std::string(key.begin(), key.end())] = entry;
+    }
+
+    return ESP_OK;
+}
+
+Namespace *getNamespace(nvs_handle_t handle)
+{
+    auto it = s_handles.find(handle);
+    return (it == s_handles.end()) ? nullptr : &s_namespaces[it->second];
+}
+
+esp_err_t setEntry(nvs_handle_t handle, const char *key, nvs_type_t type, const void *data, size_t size)
+{
+    std::lock_guard lock(s_mutex);
+    auto ns = getNamespace(handle);
+    if ((ns == nullptr) || (key == nullptr) || (strlen(key) >= NVS_KEY_NAME_MAX_SIZE)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    auto bytes = static_cast<const uint8_t *>(data);
+    (*ns)[key] = Entry{type, std::vector<uint8_t>(bytes, bytes + size)};
+
+    return ESP_OK;
+}
+
+esp_err_t getEntry(nvs_handle_t handle, const char *key, nvs_type_t type, void *out, size_t *size)
+{
+    std::lock_guard lock(s_mutex);
+    auto ns = getNamespace(handle);
+    if ((ns == nullptr) || (key == nullptr)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    auto it = ns->find(key);
+    if (it == ns->end()) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (it->second.type != type) {
+        return ESP_ERR_NVS_TYPE_MISMATCH;
+    }
+    // Same convention as NVS: a null output only queries the length
+    if (out == nullptr) {
+        *size = it->second.data.size();
+        return ESP_OK;
+    }
+    if (*size < it->second.data.size()) {
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    memcpy(out, it->second.data.data(), it->second.data.size());
+    *size = it->second.data.size();
+
+    return ESP_OK;
+}
+
+} // namespace
+
+struct nvs_opaque_iterator_t {
+    std::vector<nvs_entry_info_t> entries;
+    size_t index;
+};
+
+extern "C" {
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:
+        return "ESP_OK";
+    case ESP_FAIL:
+        return "ESP_FAIL";
+    case ESP_ERR_INVALID_ARG:
+        return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_NVS_NOT_FOUND:
+        return "ESP_ERR_NVS_NOT_FOUND";
+    case ESP_ERR_NVS_TYPE_MISMATCH:
+        return "ESP_ERR_NVS_TYPE_MISMATCH";
+    case ESP_ERR_NVS_INVALID_LENGTH:
+        return "ESP_ERR_NVS_INVALID_LENGTH";
+    default:
+        return "ESP_ERR_UNKNOWN";
+    }
+}
+
+esp_err_t nvs_flash_init(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    std::lock_guard lock(s_mutex);
+    s_namespaces.clear();
+
+    return saveFile();
+}
+
+esp_err_t nvs_host_set_file(const char *path)
+{
+    std::lock_guard lock(s_mutex);
+    s_file_path = (path != nullptr) ? path : "";
+    if (s_file_path.empty()) {
+        return ESP_OK;
+    }
+
+    return loadFile();
+}
+
+esp_err_t nvs_host_restart(void)
+{
+    std::lock_guard lock(s_mutex);
+    if (s_file_path.empty()) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_handles.clear();
+
+    return loadFile();
+}
+
+esp_err_t nvs_open(const char *namespace_name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    if ((namespace_name == nullptr) || (out_handle == nullptr)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    std::lock_guard lock(s_mutex);
+    *out_handle = s_next_handle++;
+    s_handles[*out_handle] = namespace_name;
+
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    std::lock_guard lock(s_mutex);
+    s_handles.erase(handle);
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    std::lock_guard lock(s_mutex);
+    if (getNamespace(handle) == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return saveFile();
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t handle)
+{
+    std::lock_guard lock(s_mutex);
+    auto ns = getNamespace(handle);
+    if (ns == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ns->clear();
+
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    std::lock_guard lock(s_mutex);
+    auto ns = getNamespace(handle);
+    if ((ns == nullptr) || (key == nullptr)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return (ns->erase(key) > 0) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_set_i32(nvs_handle_t handle, const char *key, int32_t value)
+{
+    return setEntry(handle, key, NVS_TYPE_I32, &value, sizeof(value));
+}
+
+esp_err_t nvs_set_str(nvs_handle_t handle, const char *key, const char *value)
+{
+    if (value == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return setEntry(handle, key, NVS_TYPE_STR, value, strlen(value) + 1);
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    if ((value == nullptr) && (length > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return setEntry(handle, key, NVS_TYPE_BLOB, value, length);
+}
+
+esp_err_t nvs_get_i32(nvs_handle_t handle, const char *key, int32_t *out_value)
+{
+    size_t size = sizeof(*out_value);
+    return getEntry(handle, key, NVS_TYPE_I32, out_value, &size);
+}
+
+esp_err_t nvs_get_str(nvs_handle_t handle, const char *key, char *out_value, size_t *length)
+{
+    return getEntry(handle, key, NVS_TYPE_STR, out_value, length);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    return getEntry(handle, key, NVS_TYPE_BLOB, out_value, length);
+}
+
+esp_err_t nvs_entry_find(const char *part_name, const char *namespace_name, nvs_type_t type, nvs_iterator_t *output_iterator)
+{
+    if (output_iterator == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *output_iterator = nullptr;
+
+    std::lock_guard lock(s_mutex);
+    auto iterator = new nvs_opaque_iterator_t{};
+    for (auto &[ns_name, ns] : s_namespaces) {
+        if ((namespace_name != nullptr) && (ns_name != namespace_name)) {
+            continue;
+        }
+        for (auto &[key, entry] : ns) {
+            if ((type != NVS_TYPE_ANY) && (entry.type != type)) {
+                continue;
+            }
+            nvs_entry_info_t info = {};
+            strncpy(info.namespace_name, ns_name.c_str(), sizeof(info.namespace_name) - 1);
+            strncpy(info.key, key.c_str(), sizeof(info.key) - 1);
+            info.type = entry.type;
+            iterator->entries.push_back(info);
+        }
+    }
+    if (iterator->entries.empty()) {
+        delete iterator;
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    *output_iterator = iterator;
+
+    return ESP_OK;
+}
+
+esp_err_t nvs_entry_next(nvs_iterator_t *iterator)
+{
+    if ((iterator == nullptr) || (*iterator == nullptr)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (++(*iterator)->index >= (*iterator)->entries.size()) {
+        delete *iterator;
+        *iterator = nullptr;
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t nvs_entry_info(const nvs_iterator_t iterator, nvs_entry_info_t *out_info)
+{
+    if ((iterator == nullptr) || (out_info == nullptr)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out_info = iterator->entries[iterator->index];
+
+    return ESP_OK;
+}
+
+void nvs_release_iterator(nvs_iterator_t iterator)
+{
+    delete iterator;
+}
+
+} // extern "C"
@@ -0,0 +1,23 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * The large wallpaper is declared in `esp_brookesia_phone_assets.h` but its source is not part of the phone assets.
+ * It is replaced by one pixel of the same solid color, so the 1280x800 stylesheet can be linked and rendered.
+ */
+#include "lvgl.h"
+
+static const uint8_t esp_brookesia_image_large_wallpaper_dark_720_720_map[] = {
+    0x1a, 0x1a, 0x1a,
+};
+
+const lv_image_dsc_t esp_brookesia_image_large_wallpaper_dark_720_720 = {
+    .header.cf = LV_COLOR_FORMAT_RGB888,
+    .header.magic = LV_IMAGE_HEADER_MAGIC,
+    .header.w = 1,
+    .header.h = 1,
+    .data_size = 3,
+    .data = esp_brookesia_image_large_wallpaper_dark_720_720_map,
+};
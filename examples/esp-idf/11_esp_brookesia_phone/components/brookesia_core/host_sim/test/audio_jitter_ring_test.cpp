@@ -0,0 +1,542 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * Test of the jitter ring of the AI agent downlink. It plays streams of 60 ms frames which lose frames and arrive late
+ * by a random delay (in order, like TCP), some with network stalls, and pops one frame per frame duration as the
+ * player does. Each frame carries its sequence number and a pattern, so a frame played twice, out of order or damaged
+ * is noticed. Then it reads the duration of Opus packets, and plays a stream of packets of 20 to 120 ms, popping each
+ * one after the duration of the previous one. Then a producer and a consumer thread share a small ring to check it
+ * across the wrap without a lock.
+ *
+ * Usage: brookesia_host_audio_jitter_ring_test [--quick]
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "esp_lib_utils.h"
+#include "agent/audio_jitter_ring.hpp"
+
+using namespace esp_brookesia::ai_framework;
+
+namespace {
+
+constexpr int FRAME_MS = 60;
+constexpr int FRAME_NUM = 500;
+constexpr size_t FRAME_SIZE_MAX = 256;
+constexpr int SEED_NUM = 20;
+constexpr int QUICK_SEED_NUM = 3;
+
+// The frame duration, target latency and concealment of the agent downlink, the maximum latency is lower so the
+// bursts after the stalls are trimmed
+const AudioJitterRing::Config RING_CONFIG = {
+    .capacity_bytes = 8 * 1024,
+    .frame_size_max = FRAME_SIZE_MAX,
+    .frame_duration_ms = FRAME_MS,
+    .target_latency_ms = 3 * FRAME_MS,
+    .max_latency_ms = 1000,
+    .conceal_frame_num_max = 2,
+};
+
+struct Network {
+    const char *name;
+    int loss_percent;
+    int jitter_ms;
+    int stall_ms;               // Nothing arrives for this long, every `stall_interval` frames
+    int stall_interval;
+};
+
+const Network NETWORKS[] = {
+    {"clean", 0, 0, 0, 0},
+    {"lossy", 5, 150, 0, 0},
+    {"bad", 15, 300, 0, 0},
+    {"stalls", 2, 100, 1500, 150},
+};
+
+int failure_num = 0;
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+// Encoded frames have different sizes, the content only depends on the sequence
+size_t get_frame_size(int sequence)
+{
+    return 64 + (sequence * 37) % (FRAME_SIZE_MAX - 64 + 1);
+}
+
+void fill_frame(uint8_t *frame, int sequence)
+{
+    size_t size = get_frame_size(sequence);
+    memcpy(frame, &sequence, sizeof(sequence));
+    for (size_t i = sizeof(sequence); i < size; i++) {
+        frame[i] = static_cast<uint8_t>(sequence + i);
+    }
+}
+
+// Returns the sequence of the frame, or -1 if it is damaged
+int check_frame(const uint8_t *frame, size_t size)
+{
+    int sequence = 0;
+    if (size < sizeof(sequence)) {
+        return -1;
+    }
+    memcpy(&sequence, frame, sizeof(sequence));
+    if ((sequence < 0) || (size != get_frame_size(sequence))) {
+        return -1;
+    }
+    for (size_t i = sizeof(sequence); i < size; i++) {
+        if (frame[i] != static_cast<uint8_t>(sequence + i)) {
+            return -1;
+        }
+    }
+    return sequence;
+}
+
+struct StreamResult {
+    AudioJitterRing::Stats stats;
+    int lost_num;
+};
+
+StreamResult play_stream(const Network &network, uint32_t seed)
+{
+    std::mt19937 random(seed);
+    auto get_random = [&random](int max) {
+        return std::uniform_int_distribution<int>(0, max)(random);
+    };
+
+    // (arrival ms, sequence), frames are delayed by the jitter and the stalls but never reordered
+    std::vector<std::pair<int, int>> arrivals;
+    int arrival_ms = 0;
+    int stall_end_ms = 0;
+    for (int i = 0; i < FRAME_NUM; i++) {
+        int send_ms = i * FRAME_MS;
+        if ((network.stall_interval > 0) && (i > 0) && (i % network.stall_interval == 0)) {
+            stall_end_ms = send_ms + network.stall_ms;
+        }
+        arrival_ms = std::max({arrival_ms, send_ms + get_random(network.jitter_ms), stall_end_ms});
+        if (get_random(99) >= network.loss_percent) {
+            arrivals.emplace_back(arrival_ms, i);
+        }
+    }
+
+    AudioJitterRing ring;
+    TEST_CHECK(ring.begin(RING_CONFIG), "%s: begin failed", network.name);
+
+    uint8_t frame[FRAME_SIZE_MAX] = {};
+    size_t size = 0;
+    size_t arrival_index = 0;
+    int last_sequence = -1;
+    int played_num = 0;
+    int concealed_num = 0;
+    int concealed_run = 0;
+    bool is_ordered = true;
+    bool is_intact = true;
+    bool is_level_kept = true;
+    bool is_conceal_bounded = true;
+    for (int now_ms = 0; now_ms < FRAME_NUM * FRAME_MS + 5000; now_ms += FRAME_MS) {
+        for (; (arrival_index < arrivals.size()) && (arrivals[arrival_index].first <= now_ms); arrival_index++) {
+            fill_frame(frame, arrivals[arrival_index].second);
+            TEST_CHECK(ring.push(frame, get_frame_size(arrivals[arrival_index].second)), "%s: push failed",
+                       network.name);
+        }
+        if (arrival_index == arrivals.size()) {
+            ring.endStream();
+        }
+
+        switch (ring.pop(frame, sizeof(frame), size)) {
+        case AudioJitterRing::PopResult::Frame: {
+            int sequence = check_frame(frame, size);
+            is_intact &= (sequence >= 0);
+            is_ordered &= (sequence > last_sequence);
+            last_sequence = std::max(last_sequence, sequence);
+            played_num++;
+            concealed_run = 0;
+            break;
+        }
+        case AudioJitterRing::PopResult::Concealed:
+            // The last frame is played again
+            is_intact &= (check_frame(frame, size) == last_sequence);
+            concealed_num++;
+            concealed_run++;
+            is_conceal_bounded &= (concealed_run <= RING_CONFIG.conceal_frame_num_max);
+            break;
+        default:
+            concealed_run = 0;
+            break;
+        }
+        is_level_kept &= (ring.getLevelMs() <= RING_CONFIG.max_latency_ms);
+    }
+
+    auto stats = ring.getStats();
+    TEST_CHECK(is_intact, "%s(seed %u): a frame is damaged", network.name, seed);
+    TEST_CHECK(is_ordered, "%s(seed %u): a frame is played twice or out of order", network.name, seed);
+    TEST_CHECK(is_level_kept, "%s(seed %u): latency above %d ms", network.name, seed, RING_CONFIG.max_latency_ms);
+    TEST_CHECK(is_conceal_bounded, "%s(seed %u): more than %d frames concealed in a row", network.name, seed,
+               RING_CONFIG.conceal_frame_num_max);
+    TEST_CHECK(stats.push_count == arrivals.size(), "%s(seed %u): %u of %d frames pushed", network.name, seed,
+               stats.push_count, static_cast<int>(arrivals.size()));
+    TEST_CHECK(stats.push_count == stats.pop_count + stats.trim_count, "%s(seed %u): %u pushed, %u popped, %u trimmed",
+               network.name, seed, stats.push_count, stats.pop_count, stats.trim_count);
+    TEST_CHECK(stats.pop_count == static_cast<uint32_t>(played_num), "%s(seed %u): %u popped, %d played",
+               network.name, seed, stats.pop_count, played_num);
+    TEST_CHECK(stats.conceal_count == static_cast<uint32_t>(concealed_num), "%s(seed %u): %u concealed, %d played",
+               network.name, seed, stats.conceal_count, concealed_num);
+    TEST_CHECK(stats.overflow_drop_count == 0, "%s(seed %u): %u frames dropped on push", network.name, seed,
+               stats.overflow_drop_count);
+    TEST_CHECK(ring.getFrameNum() == 0, "%s(seed %u): %d frames left", network.name, seed,
+               static_cast<int>(ring.getFrameNum()));
+    ring.del();
+
+    return {stats, FRAME_NUM - static_cast<int>(arrivals.size())};
+}
+
+void test_networks(int seed_num)
+{
+    printf("%-8s %8s %8s %8s %8s %8s %8s %10s\n", "network", "lost", "played", "underrun", "conceal", "trim",
+           "rebuffer", "level max");
+    for (const auto &network : NETWORKS) {
+        double lost = 0;
+        double played = 0;
+        double underrun = 0;
+        double conceal = 0;
+        double trim = 0;
+        double rebuffer = 0;
+        uint32_t level_max_ms = 0;
+        for (int seed = 1; seed <= seed_num; seed++) {
+            auto result = play_stream(network, seed);
+            lost += result.lost_num;
+            played += result.stats.pop_count;
+            underrun += result.stats.underrun_count;
+            conceal += result.stats.conceal_count;
+            trim += result.stats.trim_count;
+            rebuffer += result.stats.rebuffer_count;
+            level_max_ms = std::max(level_max_ms, result.stats.level_max_ms);
+
+            if (network.loss_percent == 0 && network.jitter_ms == 0) {
+                TEST_CHECK((result.stats.underrun_count == 0) && (result.stats.trim_count == 0),
+                           "Clean stream: %u underruns, %u trimmed", result.stats.underrun_count,
+                           result.stats.trim_count);
+            }
+            if (network.stall_ms > RING_CONFIG.max_latency_ms) {
+                TEST_CHECK(result.stats.trim_count > 0, "%s(seed %d): the burst after a stall is not trimmed",
+                           network.name, seed);
+            }
+        }
+        printf("%-8s %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f %8u ms\n", network.name, lost / seed_num, played / seed_num,
+               underrun / seed_num, conceal / seed_num, trim / seed_num, rebuffer / seed_num,
+               static_cast<unsigned>(level_max_ms));
+    }
+}
+
+void test_burst_and_flush(void)
+{
+    AudioJitterRing ring;
+    TEST_CHECK(ring.begin(RING_CONFIG), "Begin failed");
+
+    uint8_t frame[FRAME_SIZE_MAX] = {};
+    size_t size = 0;
+
+    // A burst above the maximum latency is trimmed down to the target latency
+    for (int i = 0; i < 30; i++) {
+        fill_frame(frame, i);
+        TEST_CHECK(ring.push(frame, get_frame_size(i)), "Push %d failed", i);
+    }
+    TEST_CHECK(ring.pop(frame, sizeof(frame), size) == AudioJitterRing::PopResult::Frame, "Burst: no frame");
+    TEST_CHECK(check_frame(frame, size) > 0, "Burst: the oldest frames are not dropped");
+    TEST_CHECK(ring.getLevelMs() <= RING_CONFIG.target_latency_ms, "Burst: %u ms left", ring.getLevelMs());
+
+    // A flush drops the frames and prebuffers again
+    ring.requestFlush();
+    TEST_CHECK(ring.pop(frame, sizeof(frame), size) == AudioJitterRing::PopResult::Waiting, "Flush: not waiting");
+    TEST_CHECK(ring.getFrameNum() == 0, "Flush: %d frames left", static_cast<int>(ring.getFrameNum()));
+    TEST_CHECK(ring.isPrebuffering(), "Flush: not prebuffering");
+
+    // Frames too large or empty are rejected
+    TEST_CHECK(!ring.push(frame, FRAME_SIZE_MAX + 1), "Frame larger than the maximum pushed");
+    TEST_CHECK(!ring.push(frame, 0), "Empty frame pushed");
+
+    ring.del();
+}
+
+void test_opus_durations(void)
+{
+    struct Packet {
+        uint8_t data[2];
+        size_t size;
+        uint32_t duration_us;
+    };
+    const Packet PACKETS[] = {
+        {{0x00}, 1, 10000},         // SILK NB 10 ms, one frame
+        {{0x08}, 1, 20000},         // SILK NB 20 ms
+        {{0x10}, 1, 40000},         // SILK NB 40 ms
+        {{0x18}, 1, 60000},         // SILK NB 60 ms
+        {{0x19}, 1, 120000},        // SILK NB 60 ms, two frames
+        {{0x52}, 1, 80000},         // SILK WB 40 ms, two frames of different sizes
+        {{0x60}, 1, 10000},         // Hybrid SWB 10 ms
+        {{0x78}, 1, 20000},         // Hybrid FB 20 ms
+        {{0x80}, 1, 2500},          // CELT NB 2.5 ms
+        {{0xF0}, 1, 10000},         // CELT FB 10 ms
+        {{0xF8}, 1, 20000},         // CELT FB 20 ms
+        {{0xF9}, 1, 40000},         // CELT FB 20 ms, two frames
+        {{0xFB, 0x06}, 2, 120000},  // CELT FB 20 ms, six frames
+        {{0xFB, 0x86}, 2, 120000},  // The VBR and padding flags do not count
+        {{0x83, 0x30}, 2, 120000},  // CELT NB 2.5 ms, 48 frames
+        {{0x83, 0x31}, 2, 0},       // 49 frames, more than 120 ms
+        {{0x1B, 0x03}, 2, 0},       // Three frames of 60 ms, more than 120 ms
+        {{0xFB, 0x00}, 2, 0},       // No frame
+        {{0xFB}, 1, 0},             // The frame count is missing
+        {{0xF8}, 0, 0},             // Empty
+    };
+
+    for (const auto &packet : PACKETS) {
+        uint32_t duration_us = AudioJitterRing::getOpusPacketDurationUs(packet.data, packet.size);
+        TEST_CHECK(duration_us == packet.duration_us, "Opus packet 0x%02X 0x%02X(%d bytes): %u us, expected %u us",
+                   packet.data[0], packet.data[1], static_cast<int>(packet.size), static_cast<unsigned>(duration_us),
+                   static_cast<unsigned>(packet.duration_us));
+    }
+    TEST_CHECK(AudioJitterRing::getOpusPacketDurationUs(nullptr, 1) == 0, "Opus packet: null accepted");
+}
+
+// A packet of 20, 40, 60 or 120 ms, its TOC byte first, then the sequence and a pattern
+size_t make_opus_packet(uint8_t *packet, int sequence, uint32_t &duration_us)
+{
+    static const struct {
+        uint8_t toc[2];
+        uint32_t duration_us;
+    } TOCS[] = {
+        {{0xF8}, 20000},        // CELT 20 ms
+        {{0x6A}, 40000},        // Hybrid 20 ms, two frames
+        {{0x18}, 60000},        // SILK 60 ms
+        {{0xFB, 0x06}, 120000}, // CELT 20 ms, six frames
+        {{0xF9}, 40000},        // CELT 20 ms, two frames
+    };
+    const auto &toc = TOCS[(sequence * 7 + sequence / 3) % (sizeof(TOCS) / sizeof(TOCS[0]))];
+
+    size_t size = 2 + get_frame_size(sequence) / 2;
+    packet[0] = toc.toc[0];
+    packet[1] = toc.toc[1];
+    memcpy(&packet[2], &sequence, sizeof(sequence));
+    for (size_t i = 2 + sizeof(sequence); i < size; i++) {
+        packet[i] = static_cast<uint8_t>(sequence + i);
+    }
+    duration_us = toc.duration_us;
+
+    return size;
+}
+
+void test_mixed_durations(int seed_num)
+{
+    // The server sends the packets in real time, they arrive in order with up to 100 ms of jitter
+    constexpr int JITTER_MS = 100;
+    constexpr int POLL_MS = 10;
+
+    uint32_t level_max_ms = 0;
+    uint32_t pop_num = 0;
+    for (int seed = 0; seed <= seed_num; seed++) {
+        // Seed 0 has no jitter
+        std::mt19937 random(seed);
+        struct Arrival {
+            int64_t time_us;
+            int sequence;
+        };
+        std::vector<Arrival> arrivals;
+        int64_t send_us = 0;
+        int64_t arrival_us = 0;
+        for (int i = 0; i < FRAME_NUM; i++) {
+            uint8_t packet[FRAME_SIZE_MAX] = {};
+            uint32_t duration_us = 0;
+            make_opus_packet(packet, i, duration_us);
+            int64_t jitter_us = (seed == 0) ? 0 : std::uniform_int_distribution<int>(0, JITTER_MS * 1000)(random);
+            arrival_us = std::max(arrival_us, send_us + jitter_us);
+            arrivals.push_back({arrival_us, i});
+            send_us += duration_us;
+        }
+
+        AudioJitterRing ring;
+        TEST_CHECK(ring.begin(RING_CONFIG), "Mixed: begin failed");
+
+        // The feeder of the agent: pop a packet, then wait for its duration before the next pop
+        uint8_t packet[FRAME_SIZE_MAX] = {};
+        size_t size = 0;
+        size_t arrival_index = 0;
+        int64_t level_us = 0;
+        int last_sequence = -1;
+        bool is_intact = true;
+        bool is_ordered = true;
+        bool is_duration_kept = true;
+        bool is_level_kept = true;
+        for (int64_t now_us = 0; (arrival_index < arrivals.size()) || (ring.getFrameNum() > 0);) {
+            for (; (arrival_index < arrivals.size()) && (arrivals[arrival_index].time_us <= now_us); arrival_index++) {
+                uint32_t duration_us = 0;
+                size_t packet_size = make_opus_packet(packet, arrivals[arrival_index].sequence, duration_us);
+                TEST_CHECK(ring.push(packet, packet_size, AudioJitterRing::getOpusPacketDurationUs(packet, packet_size)),
+                           "Mixed: push failed");
+                level_us += duration_us;
+            }
+            if (arrival_index == arrivals.size()) {
+                ring.endStream();
+            }
+            is_level_kept &= (ring.getLevelMs() == level_us / 1000);
+
+            uint32_t duration_us = 0;
+            auto result = ring.pop(packet, sizeof(packet), size, &duration_us);
+            if (result == AudioJitterRing::PopResult::Waiting) {
+                now_us += POLL_MS * 1000;
+                continue;
+            }
+            if (result == AudioJitterRing::PopResult::Frame) {
+                int sequence = -1;
+                if (size >= 2 + sizeof(sequence)) {
+                    memcpy(&sequence, &packet[2], sizeof(sequence));
+                }
+                uint32_t expected_duration_us = 0;
+                uint8_t expected[FRAME_SIZE_MAX] = {};
+                size_t expected_size = (sequence >= 0) ? make_opus_packet(expected, sequence, expected_duration_us) : 0;
+                is_intact &= (size == expected_size) && (memcmp(packet, expected, size) == 0);
+                is_ordered &= (sequence > last_sequence);
+                is_duration_kept &= (duration_us == expected_duration_us);
+                last_sequence = std::max(last_sequence, sequence);
+                level_us -= expected_duration_us;
+            }
+            now_us += duration_us;
+            is_level_kept &= (ring.getLevelMs() <= RING_CONFIG.max_latency_ms);
+        }
+
+        auto stats = ring.getStats();
+        TEST_CHECK(is_intact, "Mixed(seed %d): a packet is damaged", seed);
+        TEST_CHECK(is_ordered, "Mixed(seed %d): a packet is played twice or out of order", seed);
+        TEST_CHECK(is_duration_kept, "Mixed(seed %d): a packet is popped with another duration", seed);
+        TEST_CHECK(is_level_kept, "Mixed(seed %d): the level is not the duration of the packets", seed);
+        // The jitter is less than the target latency, so the pace of the feeder follows the server
+        TEST_CHECK((stats.underrun_count == 0) && (stats.trim_count == 0) && (stats.overflow_drop_count == 0),
+                   "Mixed(seed %d): %u underruns, %u trimmed, %u dropped on push", seed, stats.underrun_count,
+                   stats.trim_count, stats.overflow_drop_count);
+        TEST_CHECK(stats.pop_count == FRAME_NUM, "Mixed(seed %d): %u of %d packets popped", seed, stats.pop_count,
+                   FRAME_NUM);
+        level_max_ms = std::max(level_max_ms, stats.level_max_ms);
+        pop_num += stats.pop_count;
+        ring.del();
+    }
+    printf("Mixed durations: %u packets popped, level max %u ms\n", static_cast<unsigned>(pop_num),
+           static_cast<unsigned>(level_max_ms));
+
+    // A burst of long packets is trimmed by duration down to the target latency, not by packet count
+    AudioJitterRing ring;
+    TEST_CHECK(ring.begin(RING_CONFIG), "Mixed burst: begin failed");
+    uint8_t packet[FRAME_SIZE_MAX] = {};
+    size_t size = 0;
+    uint32_t duration_us = 0;
+    for (int i = 0; i < 20; i++) {
+        size_t packet_size = make_opus_packet(packet, i, duration_us);
+        TEST_CHECK(ring.push(packet, packet_size, duration_us), "Mixed burst: push %d failed", i);
+    }
+    TEST_CHECK(ring.pop(packet, sizeof(packet), size, &duration_us) == AudioJitterRing::PopResult::Frame,
+               "Mixed burst: no packet");
+    TEST_CHECK((ring.getLevelMs() + duration_us / 1000 <= RING_CONFIG.target_latency_ms) &&
+               (ring.getLevelMs() + duration_us / 1000 + 120 > RING_CONFIG.target_latency_ms),
+               "Mixed burst: %u ms left after a packet of %u ms", ring.getLevelMs(), duration_us / 1000);
+    ring.del();
+}
+
+void test_threads(int frame_num)
+{
+    // A small ring and short frames, so the positions wrap often and the threads are on each other's heels
+    constexpr int THREAD_FRAME_MS = 2;
+    AudioJitterRing ring;
+    TEST_CHECK(ring.begin(AudioJitterRing::Config{
+        .capacity_bytes = 1024,
+        .frame_size_max = FRAME_SIZE_MAX,
+        .frame_duration_ms = THREAD_FRAME_MS,
+        .target_latency_ms = 3 * THREAD_FRAME_MS,
+        .max_latency_ms = 20 * THREAD_FRAME_MS,
+        .conceal_frame_num_max = 2,
+    }), "Begin failed");
+
+    // Both threads follow the same clock, the producer is late by a random delay
+    auto start = std::chrono::steady_clock::now();
+    auto get_frame_time = [start](int index) {
+        return start + std::chrono::milliseconds(index * THREAD_FRAME_MS);
+    };
+    std::atomic<bool> is_producer_done = false;
+    std::thread producer([&]() {
+        std::mt19937 random(1);
+        uint8_t frame[FRAME_SIZE_MAX] = {};
+        for (int i = 0; i < frame_num; i++) {
+            std::this_thread::sleep_until(get_frame_time(i) + std::chrono::microseconds(random() % 5000));
+            fill_frame(frame, i);
+            ring.push(frame, get_frame_size(i));
+        }
+        ring.endStream();
+        is_producer_done = true;
+    });
+
+    uint8_t frame[FRAME_SIZE_MAX] = {};
+    size_t size = 0;
+    int last_sequence = -1;
+    bool is_ordered = true;
+    bool is_intact = true;
+    for (int i = 0; !is_producer_done || (ring.getFrameNum() > 0); i++) {
+        auto result = ring.pop(frame, sizeof(frame), size);
+        if (result == AudioJitterRing::PopResult::Frame) {
+            int sequence = check_frame(frame, size);
+            is_intact &= (sequence >= 0);
+            is_ordered &= (sequence > last_sequence);
+            last_sequence = std::max(last_sequence, sequence);
+        }
+        std::this_thread::sleep_until(get_frame_time(i + 1));
+    }
+    producer.join();
+
+    auto stats = ring.getStats();
+    printf("Threads: %u pushed, %u dropped on push, %u popped, %u trimmed, %u concealed\n", stats.push_count,
+           stats.overflow_drop_count, stats.pop_count, stats.trim_count, stats.conceal_count);
+    TEST_CHECK(is_intact, "Threads: a frame is damaged");
+    TEST_CHECK(is_ordered, "Threads: a frame is played twice or out of order");
+    TEST_CHECK(stats.push_count + stats.overflow_drop_count == static_cast<uint32_t>(frame_num),
+               "Threads: %u pushed and %u dropped of %d", stats.push_count, stats.overflow_drop_count, frame_num);
+    TEST_CHECK(stats.push_count == stats.pop_count + stats.trim_count, "Threads: %u pushed, %u popped, %u trimmed",
+               stats.push_count, stats.pop_count, stats.trim_count);
+    ring.del();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    bool is_quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !is_quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The rejected frames are expected
+    esp_utils::host_log_level = ESP_UTILS_LOG_LEVEL_NONE;
+
+    test_networks(is_quick ? QUICK_SEED_NUM : SEED_NUM);
+    test_burst_and_flush();
+    test_opus_durations();
+    test_mixed_durations(is_quick ? QUICK_SEED_NUM : SEED_NUM);
+    test_threads(is_quick ? 1000 : 10000);
+
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+
+    return EXIT_SUCCESS;
+}
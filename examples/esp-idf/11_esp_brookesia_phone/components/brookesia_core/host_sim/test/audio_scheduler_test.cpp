@@ -0,0 +1,466 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * Test of the audio scheduler of the AI buddy. It checks the basic cases, then drives the scheduler with bursts of
+ * Wi-Fi and agent events in simulated time, the same way as the audio thread of the AI buddy does, and checks each
+ * audio which starts against a simple reference model.
+ *
+ * Usage: brookesia_host_audio_scheduler_test [--quick]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "esp_lib_utils.h"
+#include "speaker/esp_brookesia_speaker_audio_scheduler.hpp"
+
+using namespace esp_brookesia::systems::speaker;
+
+namespace {
+
+constexpr int TICK_MS = 50;
+constexpr int SLOT_NUM = 64;
+constexpr int SIM_DURATION_MS = 30 * 60 * 1000;
+constexpr int QUICK_SIM_DURATION_MS = 3 * 60 * 1000;
+
+enum Priority {
+    PriorityReminder,
+    PriorityStatus,
+    PriorityResponse,
+    PriorityNum,
+};
+
+enum AudioId {
+    WifiNeedConnect,
+    WifiConnected,
+    WifiDisconnected,
+    ServerConnected,
+    ServerDisconnected,
+    ServerConnecting,
+    MicOn,
+    MicOff,
+    WakeUp,
+    ResponseFirst,
+    ResponseLast = ResponseFirst + 3,
+    SleepFirst,
+    SleepLast = SleepFirst + 3,
+    AudioIdNum,
+};
+
+struct AudioInfo {
+    Priority priority;
+    int duration_ms;
+};
+
+AudioInfo audio_infos[AudioIdNum];
+
+int failure_num = 0;
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+AudioScheduler create_scheduler(int event_num = AudioIdNum)
+{
+    return AudioScheduler(AudioScheduler::Config{
+        .tick_ms = TICK_MS,
+        .slot_num = SLOT_NUM,
+        .event_num = event_num,
+        .priority_num = PriorityNum,
+    });
+}
+
+void test_repeat(void)
+{
+    auto scheduler = create_scheduler();
+    AudioScheduler::Event event = {};
+    std::vector<int64_t> start_times;
+
+    auto handle = scheduler.schedule({ServerConnecting, PriorityReminder, 3, 20 * 1000}, 1000);
+    for (int64_t now_ms = 1000; now_ms < 100 * 1000; now_ms += 10) {
+        scheduler.advance(now_ms);
+        while (scheduler.takeReady(now_ms, event)) {
+            start_times.push_back(now_ms);
+        }
+    }
+    TEST_CHECK(
+        (start_times == std::vector<int64_t> {1000, 21000, 41000}), "Repeat times: %d plays",
+        static_cast<int>(start_times.size())
+    );
+    TEST_CHECK(!scheduler.isPending(handle) && (scheduler.getPendingNum() == 0), "Finished event is still pending");
+
+    // Play once when the count is 0, forever when it is negative
+    scheduler.schedule({MicOn, PriorityResponse, 0, 0}, 100 * 1000);
+    int play_num = 0;
+    while (scheduler.takeReady(100 * 1000, event)) {
+        play_num++;
+    }
+    TEST_CHECK(play_num == 1, "Count 0 played %d times", play_num);
+    handle = scheduler.schedule({WifiNeedConnect, PriorityReminder, -1, 100}, 100 * 1000);
+    play_num = 0;
+    for (int64_t now_ms = 100 * 1000; now_ms < 110 * 1000; now_ms += 10) {
+        scheduler.advance(now_ms);
+        while (scheduler.takeReady(now_ms, event)) {
+            play_num++;
+        }
+    }
+    TEST_CHECK(play_num == 100, "Endless event played %d times in 10 s", play_num);
+    TEST_CHECK(scheduler.cancel(handle), "Cancel endless event failed");
+}
+
+void test_cancel(void)
+{
+    auto scheduler = create_scheduler(2);
+    AudioScheduler::Event event = {};
+
+    auto handle = scheduler.schedule({WifiNeedConnect, PriorityReminder, 3, 20 * 1000}, 0, 10 * 1000);
+    TEST_CHECK(scheduler.getWaitTimeMs(0) == 10 * 1000, "Wait time %d", scheduler.getWaitTimeMs(0));
+    scheduler.advance(5000);
+    TEST_CHECK(scheduler.cancel(handle), "Cancel pending event failed");
+    TEST_CHECK(!scheduler.cancel(handle), "Cancel twice succeeded");
+    TEST_CHECK(scheduler.getWaitTimeMs(5000) == -1, "Nothing should be pending");
+    scheduler.advance(60 * 1000);
+    TEST_CHECK(!scheduler.takeReady(60 * 1000, event), "Cancelled event is ready");
+
+    // A new event in the same entry is not cancelled by the old handle
+    auto new_handle = scheduler.schedule({WifiConnected, PriorityStatus, 0, 0}, 60 * 1000, 100);
+    TEST_CHECK(new_handle != handle, "Handle is reused");
+    TEST_CHECK(!scheduler.cancel(handle) && scheduler.isPending(new_handle), "Old handle cancelled new event");
+
+    // The pool is full
+    scheduler.schedule({MicOn, PriorityResponse, 0, 0}, 60 * 1000);
+    TEST_CHECK(
+        scheduler.schedule({MicOff, PriorityResponse, 0, 0}, 60 * 1000) == AudioScheduler::INVALID_HANDLE,
+        "Schedule succeeded with a full pool"
+    );
+    TEST_CHECK(!scheduler.cancel(AudioScheduler::INVALID_HANDLE), "Cancel invalid handle succeeded");
+    scheduler.clear();
+    TEST_CHECK(scheduler.getPendingNum() == 0, "Clear left %d events", scheduler.getPendingNum());
+}
+
+void test_priority(void)
+{
+    auto scheduler = create_scheduler();
+    AudioScheduler::Event event = {};
+
+    scheduler.schedule({ServerConnecting, PriorityReminder, 0, 0}, 0);
+    scheduler.schedule({WifiConnected, PriorityStatus, 0, 0}, 0);
+    scheduler.schedule({ServerConnected, PriorityStatus, 0, 0}, 0);
+    scheduler.schedule({WakeUp, PriorityResponse, 0, 0}, 0, 1);
+    TEST_CHECK(scheduler.getReadyPriority() == PriorityStatus, "Ready priority %d", scheduler.getReadyPriority());
+    scheduler.advance(TICK_MS);
+
+    std::vector<int> ids;
+    while (scheduler.takeReady(TICK_MS, event)) {
+        ids.push_back(event.id);
+    }
+    TEST_CHECK(
+        (ids == std::vector<int> {WakeUp, WifiConnected, ServerConnected, ServerConnecting}), "Wrong priority order"
+    );
+    TEST_CHECK(scheduler.getReadyPriority() == -1, "Ready priority %d", scheduler.getReadyPriority());
+}
+
+void test_time_jump(void)
+{
+    auto scheduler = create_scheduler();
+    AudioScheduler::Event event = {};
+
+    // More than a revolution of the wheel passes between two advances
+    scheduler.advance(0);
+    scheduler.schedule({WifiNeedConnect, PriorityReminder, 0, 0}, 0, 10 * 1000);
+    scheduler.schedule({ServerDisconnected, PriorityStatus, 0, 0}, 0, 100 * 1000);
+    scheduler.advance(60 * 60 * 1000);
+    int ready_num = 0;
+    while (scheduler.takeReady(60 * 60 * 1000, event)) {
+        ready_num++;
+    }
+    TEST_CHECK(ready_num == 2, "%d events ready after a time jump", ready_num);
+
+    // An event due after several revolutions is neither early nor late
+    scheduler.schedule({ServerDisconnected, PriorityStatus, 0, 0}, 60 * 60 * 1000, 20 * 1000);
+    int64_t start_ms = -1;
+    for (int64_t now_ms = 60 * 60 * 1000; (now_ms < 60 * 60 * 1000 + 30 * 1000) && (start_ms < 0); now_ms += 1) {
+        scheduler.advance(now_ms);
+        if (scheduler.takeReady(now_ms, event)) {
+            start_ms = now_ms;
+        }
+    }
+    TEST_CHECK(start_ms == 60 * 60 * 1000 + 20 * 1000, "Started at %lld", static_cast<long long>(start_ms));
+}
+
+/**
+ * The reference model: the pending events of each audio, in a plain array
+ */
+struct ModelAudio {
+    bool is_pending;
+    int64_t due_ms;
+    int repeat_count;
+    int repeat_interval_ms;
+};
+
+struct Simulator {
+    AudioScheduler scheduler = create_scheduler();
+    AudioScheduler::Handle handles[AudioIdNum] = {};
+    ModelAudio model[AudioIdNum] = {};
+    int64_t send_times[AudioIdNum] = {};
+    int playing_id = -1;
+    int64_t playing_end_ms = 0;
+    int play_num = 0;
+    int preempt_num = 0;
+    int operation_num = 0;
+    int max_late_ms = 0;
+    std::vector<int> response_latencies;
+
+    void send(int id, int64_t now_ms, int repeat_count = 0, int repeat_interval_ms = 0, int delay_ms = 0)
+    {
+        scheduler.cancel(handles[id]);
+        AudioScheduler::Event event = {id, audio_infos[id].priority, repeat_count, repeat_interval_ms};
+        handles[id] = scheduler.schedule(event, now_ms, delay_ms);
+        TEST_CHECK(handles[id] != AudioScheduler::INVALID_HANDLE, "Schedule %d failed", id);
+        model[id] = {true, now_ms + std::max(delay_ms, 0), std::max(repeat_count, 1), repeat_interval_ms};
+        if (repeat_count < 0) {
+            model[id].repeat_count = -1;
+        }
+        send_times[id] = now_ms;
+        operation_num++;
+    }
+
+    void stop(int id)
+    {
+        scheduler.cancel(handles[id]);
+        handles[id] = AudioScheduler::INVALID_HANDLE;
+        model[id].is_pending = false;
+        operation_num++;
+    }
+
+    // Same as the loop of the audio thread of the AI buddy
+    void run(int64_t now_ms)
+    {
+        scheduler.advance(now_ms);
+        if ((playing_id >= 0) && (now_ms >= playing_end_ms)) {
+            playing_id = -1;
+        }
+
+        while (true) {
+            int playing_priority = (playing_id >= 0) ? audio_infos[playing_id].priority : -1;
+            int ready_priority = scheduler.getReadyPriority();
+            if ((ready_priority < 0) || (ready_priority <= playing_priority)) {
+                break;
+            }
+
+            AudioScheduler::Event event = {};
+            scheduler.takeReady(now_ms, event);
+            checkStart(event.id, now_ms);
+            if (playing_id >= 0) {
+                preempt_num++;
+            }
+            playing_id = event.id;
+            playing_end_ms = now_ms + audio_infos[event.id].duration_ms;
+            play_num++;
+        }
+        checkWaiting(now_ms);
+    }
+
+    void checkStart(int id, int64_t now_ms)
+    {
+        ModelAudio &audio = model[id];
+        TEST_CHECK(audio.is_pending, "Audio %d started but is not pending", id);
+        TEST_CHECK(now_ms >= audio.due_ms, "Audio %d started %d ms early", id, static_cast<int>(audio.due_ms - now_ms));
+        if (audio_infos[id].priority == PriorityResponse) {
+            response_latencies.push_back(static_cast<int>(now_ms - send_times[id]));
+        }
+
+        if ((audio.repeat_count < 0) || (audio.repeat_count > 1)) {
+            if (audio.repeat_count > 0) {
+                audio.repeat_count--;
+            }
+            audio.due_ms = now_ms + std::max(audio.repeat_interval_ms, 1);
+        } else {
+            audio.is_pending = false;
+        }
+    }
+
+    // An audio which is due only waits for an audio which is at least as urgent
+    void checkWaiting(int64_t now_ms)
+    {
+        int playing_priority = (playing_id >= 0) ? audio_infos[playing_id].priority : -1;
+        int pending_num = 0;
+        for (int id = 0; id < AudioIdNum; id++) {
+            const ModelAudio &audio = model[id];
+            if (!audio.is_pending) {
+                continue;
+            }
+            pending_num++;
+            if ((now_ms >= audio.due_ms) && (audio_infos[id].priority > playing_priority)) {
+                int late_ms = static_cast<int>(now_ms - audio.due_ms);
+                max_late_ms = std::max(max_late_ms, late_ms);
+                TEST_CHECK(late_ms < TICK_MS, "Audio %d is %d ms late", id, late_ms);
+            }
+        }
+        TEST_CHECK(
+            pending_num == scheduler.getPendingNum(), "%d events are pending, %d expected",
+            scheduler.getPendingNum(), pending_num
+        );
+    }
+};
+
+void test_bursts(int duration_ms)
+{
+    Simulator simulator;
+    std::mt19937 generator(1);
+    auto random = [&generator](int max) {
+        return static_cast<int>(generator() % (max + 1));
+    };
+
+    for (int id = 0; id < AudioIdNum; id++) {
+        audio_infos[id].duration_ms = 300 + random(1700);
+    }
+
+    bool is_wifi_connected = true;
+    int64_t next_burst_ms = 0;
+    std::vector<int64_t> operation_times;
+    for (int64_t now_ms = 0; now_ms < duration_ms; now_ms++) {
+        // A burst is up to 20 events in 50 ms, the bursts are 1 to 8 s apart
+        if (now_ms == next_burst_ms) {
+            int event_num = 1 + random(19);
+            operation_times.clear();
+            for (int i = 0; i < event_num; i++) {
+                operation_times.push_back(now_ms + random(49));
+            }
+            std::sort(operation_times.begin(), operation_times.end());
+            next_burst_ms = now_ms + 1000 + random(7000);
+        }
+
+        while (!operation_times.empty() && (operation_times.front() == now_ms)) {
+            operation_times.erase(operation_times.begin());
+            switch (random(7)) {
+            case 0:
+                // Wi-Fi flaps
+                if (is_wifi_connected) {
+                    simulator.send(WifiDisconnected, now_ms);
+                    simulator.send(WifiNeedConnect, now_ms, 3, 20 * 1000, 10 * 1000);
+                } else {
+                    simulator.stop(WifiNeedConnect);
+                    simulator.send(WifiConnected, now_ms);
+                }
+                is_wifi_connected = !is_wifi_connected;
+                break;
+            case 1:
+                simulator.stop(ServerDisconnected);
+                simulator.send(ServerConnecting, now_ms, 3, 20 * 1000);
+                break;
+            case 2:
+                simulator.stop(ServerConnecting);
+                simulator.send(ServerConnected, now_ms);
+                break;
+            case 3:
+                simulator.send(ServerDisconnected, now_ms, 3, 20 * 1000);
+                break;
+            case 4:
+                simulator.stop(MicOff);
+                simulator.send(MicOn, now_ms);
+                simulator.send(WakeUp, now_ms);
+                break;
+            case 5:
+                simulator.send(ResponseFirst + random(ResponseLast - ResponseFirst), now_ms);
+                break;
+            case 6:
+                simulator.send(SleepFirst + random(SleepLast - SleepFirst), now_ms);
+                break;
+            default:
+                simulator.stop(MicOn);
+                simulator.send(MicOff, now_ms);
+                break;
+            }
+        }
+        simulator.run(now_ms);
+    }
+
+    std::sort(simulator.response_latencies.begin(), simulator.response_latencies.end());
+    auto &latencies = simulator.response_latencies;
+    printf(
+        "Bursts in %d s: %d operations, %d plays, %d preempted | response latency ms p50 %d p99 %d max %d | "
+        "max late %d ms\n", duration_ms / 1000, simulator.operation_num, simulator.play_num, simulator.preempt_num,
+        latencies.empty() ? 0 : latencies[latencies.size() / 2],
+        latencies.empty() ? 0 : latencies[latencies.size() * 99 / 100], latencies.empty() ? 0 : latencies.back(),
+        simulator.max_late_ms
+    );
+    TEST_CHECK(simulator.play_num > 0, "Nothing played");
+    TEST_CHECK(simulator.preempt_num > 0, "Nothing preempted");
+}
+
+void test_operation_time(int round_num)
+{
+    auto scheduler = create_scheduler();
+    std::vector<AudioScheduler::Handle> handles(AudioIdNum);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < round_num; round++) {
+        int64_t now_ms = round * 10;
+        for (int id = 0; id < AudioIdNum; id++) {
+            handles[id] = scheduler.schedule({id, id % PriorityNum, 3, 20 * 1000}, now_ms, (id * 997) % 30000);
+        }
+        scheduler.advance(now_ms);
+        for (int id = 0; id < AudioIdNum; id++) {
+            scheduler.cancel(handles[id]);
+        }
+    }
+    auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - start
+                      ).count();
+    printf("Schedule + cancel: %.0f ns per event\n", static_cast<double>(elapsed_ns) / (round_num * AudioIdNum));
+    TEST_CHECK(scheduler.getPendingNum() == 0, "%d events left", scheduler.getPendingNum());
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    bool is_quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !is_quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    // Failures of the scheduler, such as a full pool, are expected by the tests
+    esp_utils::host_log_level = ESP_UTILS_LOG_LEVEL_NONE;
+
+    for (int id = 0; id < AudioIdNum; id++) {
+        audio_infos[id].priority = PriorityResponse;
+        audio_infos[id].duration_ms = 1000;
+    }
+    for (int id : {
+                WifiNeedConnect, ServerConnecting
+            }) {
+        audio_infos[id].priority = PriorityReminder;
+    }
+    for (int id : {
+                WifiConnected, WifiDisconnected, ServerConnected, ServerDisconnected
+            }) {
+        audio_infos[id].priority = PriorityStatus;
+    }
+
+    test_repeat();
+    test_cancel();
+    test_priority();
+    test_time_jump();
+    test_bursts(is_quick ? QUICK_SIM_DURATION_MS : SIM_DURATION_MS);
+    test_operation_time(is_quick ? 10000 : 1000000);
+
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,180 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * Test of the touch sampler of the phone gesture. It replays touch traces recorded on a 1024x600 panel and checks the
+ * velocity and the predicted end point of each one, then checks that a fling never predicts a point out of the
+ * display.
+ *
+ * Usage: brookesia_host_gesture_sampler_test [--quick]
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "esp_lib_utils.h"
+#include "phone/widgets/gesture/esp_brookesia_gesture_sampler.hpp"
+
+using namespace esp_brookesia::systems::phone;
+
+namespace {
+
+constexpr int DISPLAY_WIDTH = 1024;
+constexpr int DISPLAY_HEIGHT = 600;
+
+/* Touch traces recorded on a 1024x600 panel, the driver is read every 8~12ms */
+const GestureSampler::Sample trace_fling_left[] = {
+    {900, 300, 0}, {892, 301, 10}, {870, 301, 18}, {835, 302, 28}, {790, 303, 36}, {731, 303, 46}, {668, 304, 54},
+    {600, 305, 64}, {530, 305, 72},
+};
+const GestureSampler::Sample trace_slow_drag_up[] = {
+    {512, 550, 0}, {512, 548, 12}, {513, 545, 24}, {513, 543, 36}, {513, 540, 48}, {514, 538, 60}, {514, 535, 72},
+    {514, 533, 84}, {515, 530, 96}, {515, 528, 108},
+};
+const GestureSampler::Sample trace_hold_after_swipe[] = {
+    {100, 300, 0}, {140, 300, 10}, {190, 300, 20}, {240, 300, 30}, {241, 300, 40}, {241, 300, 50}, {241, 300, 60},
+    {241, 300, 70}, {241, 300, 80}, {241, 300, 90}, {241, 300, 100}, {241, 300, 110}, {241, 300, 120},
+};
+
+int failure_num = 0;
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+template <size_t N>
+void replay(GestureSampler &sampler, const GestureSampler::Sample (&trace)[N])
+{
+    sampler.reset();
+    for (const auto &sample : trace) {
+        sampler.push(sample.x, sample.y, sample.tick_ms);
+    }
+}
+
+bool is_on_display(int x, int y)
+{
+    return (x >= 0) && (x < DISPLAY_WIDTH) && (y >= 0) && (y < DISPLAY_HEIGHT);
+}
+
+void test_recorded_traces(void)
+{
+    GestureSampler sampler;
+    float vx = 0;
+    float vy = 0;
+    int x = 0;
+    int y = 0;
+
+    replay(sampler, trace_fling_left);
+    TEST_CHECK(sampler.estimateVelocity(vx, vy), "Fling left: no velocity");
+    // The finger is still accelerating, so the fit must be faster than the average speed (370px / 72ms)
+    TEST_CHECK(vx < -370.0f / 72, "Fling left: vx %.3f px/ms", vx);
+    TEST_CHECK(fabsf(vy) < 0.2f, "Fling left: vy %.3f px/ms", vy);
+    TEST_CHECK(sampler.predictEndPoint(x, y) && (x < 530), "Fling left: predicted x %d", x);
+    printf("Fling left: %.2f, %.2f px/ms, stops at (%d, %d) without bounds\n", vx, vy, x, y);
+
+    replay(sampler, trace_slow_drag_up);
+    TEST_CHECK(sampler.estimateVelocity(vx, vy), "Slow drag up: no velocity");
+    TEST_CHECK(fabsf(vy + 0.2f) < 0.05f, "Slow drag up: vy %.3f px/ms", vy);
+    TEST_CHECK(sampler.predictEndPoint(x, y) && (abs(y - 528) <= 10), "Slow drag up: predicted y %d", y);
+
+    replay(sampler, trace_hold_after_swipe);
+    TEST_CHECK(sampler.estimateVelocity(vx, vy), "Hold after swipe: no velocity");
+    TEST_CHECK(fabsf(vx) < 0.01f, "Hold after swipe: vx %.3f px/ms", vx);
+    TEST_CHECK(sampler.predictEndPoint(x, y) && (x == 241) && (y == 300), "Hold after swipe: predicted (%d, %d)", x, y);
+
+    sampler.reset();
+    TEST_CHECK(!sampler.predictEndPoint(x, y), "Prediction without sample");
+    sampler.push(0, 0, 0);
+    TEST_CHECK(!sampler.estimateVelocity(vx, vy), "Velocity with a single sample");
+}
+
+void test_bounds(void)
+{
+    GestureSampler sampler;
+    int x = 0;
+    int y = 0;
+
+    // The recorded fling would stop far out of the display
+    replay(sampler, trace_fling_left);
+    TEST_CHECK(sampler.predictEndPoint(x, y) && (x < 0), "Unbounded fling left stops at %d", x);
+
+    // It stops on the left border, along its path from the last point (530, 305)
+    float vx = 0;
+    float vy = 0;
+    TEST_CHECK(sampler.estimateVelocity(vx, vy), "Fling left: no velocity");
+    int path_y = 305 + (int)lroundf(530 * vy / -vx);
+    sampler.setBounds(DISPLAY_WIDTH, DISPLAY_HEIGHT);
+    TEST_CHECK(
+        sampler.predictEndPoint(x, y) && (x == 0) && (abs(y - path_y) <= 1), "Fling left stops at (%d, %d), not (0, %d)",
+        x, y, path_y
+    );
+
+    // A diagonal fling towards the bottom right corner stops on the border, along its path
+    sampler.reset();
+    for (int i = 0; i < 8; i++) {
+        sampler.push(500 + i * 40, 300 + i * 20, i * 10);
+    }
+    TEST_CHECK(sampler.predictEndPoint(x, y) && is_on_display(x, y), "Diagonal fling stops at (%d, %d)", x, y);
+    TEST_CHECK((x == DISPLAY_WIDTH - 1) || (y == DISPLAY_HEIGHT - 1), "Diagonal fling stops inside at (%d, %d)", x, y);
+    // The last point is (780, 440), the path goes 2 px right for 1 px down
+    TEST_CHECK(abs((x - 780) - 2 * (y - 440)) <= 2, "Diagonal fling leaves its path at (%d, %d)", x, y);
+
+    // Flings in all the directions from all over the display
+    int checked = 0;
+    for (int start_y = 0; start_y < DISPLAY_HEIGHT; start_y += 75) {
+        for (int start_x = 0; start_x < DISPLAY_WIDTH; start_x += 128) {
+            for (int angle = 0; angle < 360; angle += 15) {
+                float rad = angle * 3.14159265f / 180;
+                sampler.reset();
+                for (int i = 0; i < 6; i++) {
+                    sampler.push(start_x + (int)lroundf(cosf(rad) * 30 * i), start_y + (int)lroundf(sinf(rad) * 30 * i),
+                                 i * 10);
+                }
+                TEST_CHECK(
+                    sampler.predictEndPoint(x, y) && is_on_display(x, y), "Fling from (%d, %d) at %d deg stops at (%d, %d)",
+                    start_x, start_y, angle, x, y
+                );
+                checked++;
+            }
+        }
+    }
+    printf("Bounded flings: %d checked\n", checked);
+
+    // A point reported out of the display by the driver
+    sampler.reset();
+    sampler.push(DISPLAY_WIDTH + 5, -3, 0);
+    TEST_CHECK(sampler.predictEndPoint(x, y) && is_on_display(x, y), "Point out of the display predicts (%d, %d)", x, y);
+
+    // No bounds again
+    sampler.setBounds(0, 0);
+    replay(sampler, trace_fling_left);
+    TEST_CHECK(sampler.predictEndPoint(x, y) && (x < 0), "Fling left with the bounds removed stops at %d", x);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    bool is_quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !is_quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    test_recorded_traces();
+    test_bounds();
+
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+
+    return EXIT_SUCCESS;
+}
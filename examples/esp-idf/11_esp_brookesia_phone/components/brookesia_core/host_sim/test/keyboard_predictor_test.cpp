@@ -0,0 +1,276 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * Test of the word prediction of the speaker keyboard. It checks the parsing of the dictionary and the basic cases,
+ * then compares the predictions on a generated dictionary with a brute force search, and reports the lookup time.
+ *
+ * Usage: brookesia_host_keyboard_predictor_test [--quick]
+ */
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "esp_lib_utils.h"
+#include "speaker/widgets/keyboard/esp_brookesia_keyboard_predictor.hpp"
+
+using namespace esp_brookesia::systems::speaker;
+
+namespace {
+
+constexpr int WORD_NUM_MAX = 3;
+
+int failure_num = 0;
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+std::string to_lower(std::string_view text)
+{
+    std::string lower(text);
+    for (auto &c : lower) {
+        c = ((c >= 'A') && (c <= 'Z')) ? (c - 'A' + 'a') : c;
+    }
+
+    return lower;
+}
+
+std::vector<std::string> predict(KeyboardPredictor &predictor, std::string_view prefix, int word_num_max = WORD_NUM_MAX)
+{
+    std::vector<std::string_view> words(word_num_max);
+    int word_num = predictor.predict(prefix, words.data(), word_num_max);
+
+    return std::vector<std::string>(words.begin(), words.begin() + word_num);
+}
+
+void test_basic(void)
+{
+    KeyboardPredictor predictor;
+
+    TEST_CHECK(!predictor.isLoaded() && predict(predictor, "a").empty(), "Empty predictor predicted");
+    TEST_CHECK(!predictor.load(""), "Empty dictionary loaded");
+    TEST_CHECK(!predictor.load("\n  \n\t\n"), "Blank dictionary loaded");
+
+    // Repeated words with another case, a default weight, blank lines, CRLF, a UTF-8 word and clamped weights
+    TEST_CHECK(predictor.load(
+                   "hello 10\n"
+                   "help 30\r\n"
+                   "\n"
+                   "helium 5\n"
+                   "HELLO 20\n"
+                   "  world\n"
+                   "caf\xc3\xa9 7\n"
+                   "hel 100000\n"
+                   "helm -3\n"
+                   "hello 15"
+               ), "Load failed");
+    TEST_CHECK(predictor.getWordNum() == 7, "%d words", predictor.getWordNum());
+    TEST_CHECK(
+        (predict(predictor, "He") == std::vector<std::string> {"hel", "help", "HELLO"}), "Wrong prediction of `He`"
+    );
+    TEST_CHECK((predict(predictor, "hell") == std::vector<std::string> {"HELLO"}), "Wrong prediction of `hell`");
+    TEST_CHECK((predict(predictor, "help") == std::vector<std::string> {"help"}), "A word is not its own prediction");
+    TEST_CHECK((predict(predictor, "helm") == std::vector<std::string> {"helm"}), "Zero weight word is lost");
+    TEST_CHECK((predict(predictor, "w") == std::vector<std::string> {"world"}), "Wrong prediction of `w`");
+    TEST_CHECK(
+        (predict(predictor, "caf") == std::vector<std::string> {"caf\xc3\xa9"}), "Wrong prediction of a UTF-8 word"
+    );
+    TEST_CHECK(
+        (predict(predictor, "", 2) == std::vector<std::string> {"hel", "help"}), "Wrong prediction of an empty prefix"
+    );
+    TEST_CHECK(predict(predictor, "x").empty(), "Prediction without match");
+    TEST_CHECK(predict(predictor, "hello!").empty(), "Prediction longer than the words");
+    TEST_CHECK(predict(predictor, "he ").empty(), "Prediction of a prefix with a space");
+    TEST_CHECK(
+        predict(predictor, std::string(KeyboardPredictor::PREFIX_LEN_MAX + 1, 'h')).empty(), "Too long prefix"
+    );
+    TEST_CHECK(predict(predictor, "he", 0).empty(), "Prediction without room");
+
+    predictor.clear();
+    TEST_CHECK(!predictor.isLoaded() && predict(predictor, "he").empty(), "Cleared predictor predicted");
+}
+
+struct Reference {
+    std::map<std::string, int> weights;     // Lowercase word to its highest weight
+
+    /**
+     * @brief Get the weights of the best words starting with `prefix`, in order
+     */
+    std::vector<int> predict(const std::string &prefix, int word_num_max) const
+    {
+        std::vector<int> result;
+        for (auto it = weights.lower_bound(prefix); (it != weights.end()) && (it->first.rfind(prefix, 0) == 0); it++) {
+            result.push_back(it->second);
+        }
+        std::sort(result.begin(), result.end(), std::greater<int>());
+        result.resize(std::min<size_t>(result.size(), word_num_max));
+
+        return result;
+    }
+};
+
+std::string generate_dictionary(int word_num, std::mt19937 &random, Reference &reference)
+{
+    const char *letters = "etaoinshrdlcumwfgypbvkjxqzETAOIN";
+    std::string dictionary;
+    for (int i = 0; i < word_num; i++) {
+        std::string word;
+        int length = 1 + random() % 10;
+        for (int j = 0; j < length; j++) {
+            word += letters[(random() % 32) * (random() % 32) / 32];
+        }
+        // Few distinct weights, so that many words have the same weight
+        int weight = (random() % 4 == 0) ? static_cast<int>(random() % 100) : static_cast<int>(random() % 70000);
+        dictionary += word + " " + std::to_string(weight) + "\n";
+
+        int &reference_weight = reference.weights[to_lower(word)];
+        reference_weight = std::max(reference_weight, std::min(weight, static_cast<int>(KeyboardPredictor::WEIGHT_MAX)));
+    }
+
+    return dictionary;
+}
+
+void test_reference(int word_num, int prefix_num)
+{
+    std::mt19937 random(36);
+    Reference reference;
+    KeyboardPredictor predictor(1 << 30);
+    TEST_CHECK(predictor.load(generate_dictionary(word_num, random, reference)), "Load failed");
+    TEST_CHECK(
+        predictor.getWordNum() == static_cast<int>(reference.weights.size()), "%d words, expected %d",
+        predictor.getWordNum(), static_cast<int>(reference.weights.size())
+    );
+
+    std::vector<std::string> keys;
+    for (auto &[key, weight] : reference.weights) {
+        keys.push_back(key);
+    }
+    for (int i = 0; (i < prefix_num) && (failure_num < 10); i++) {
+        const std::string &key = keys[random() % keys.size()];
+        std::string prefix = key.substr(0, random() % (key.size() + 1));
+        if (!prefix.empty() && (random() % 2 == 0)) {
+            prefix[0] = std::toupper(static_cast<unsigned char>(prefix[0]));
+        }
+        int word_num_max = 1 + random() % 5;
+
+        std::vector<int> expected = reference.predict(to_lower(prefix), word_num_max);
+        std::vector<std::string> words = predict(predictor, prefix, word_num_max);
+        std::vector<int> weights;
+        for (auto &word : words) {
+            std::string lower = to_lower(word);
+            auto it = reference.weights.find(lower);
+            TEST_CHECK(
+                (it != reference.weights.end()) && (lower.rfind(to_lower(prefix), 0) == 0), "`%s` predicted `%s`",
+                prefix.c_str(), word.c_str()
+            );
+            weights.push_back((it != reference.weights.end()) ? it->second : -1);
+        }
+        TEST_CHECK(weights == expected, "Wrong weights of `%s`, %d words", prefix.c_str(), static_cast<int>(words.size()));
+    }
+}
+
+void test_budget(int word_num)
+{
+    constexpr int VISIT_NUM_MAX = 16;
+
+    std::mt19937 random(37);
+    Reference reference;
+    KeyboardPredictor predictor(VISIT_NUM_MAX);
+    TEST_CHECK(predictor.load(generate_dictionary(word_num, random, reference)), "Load failed");
+
+    for (const char *prefix : {
+                "", "e", "et", "eta", "t"
+            }) {
+        std::vector<std::string> words = predict(predictor, prefix, 5);
+        int visit_num = predictor.getLastLookupInfo().visit_num;
+        TEST_CHECK(visit_num <= VISIT_NUM_MAX, "`%s` visited %d nodes", prefix, visit_num);
+        // The words found within the budget are still the best ones
+        std::vector<int> expected = reference.predict(prefix, words.size());
+        for (size_t i = 0; i < words.size(); i++) {
+            TEST_CHECK(
+                reference.weights.at(to_lower(words[i])) == expected[i], "`%s` predicted `%s` out of order", prefix,
+                words[i].c_str()
+            );
+        }
+    }
+}
+
+void test_lookup_time(int word_num, int lookup_num)
+{
+    std::mt19937 random(38);
+    Reference reference;
+    KeyboardPredictor predictor;
+    std::string dictionary = generate_dictionary(word_num, random, reference);
+
+    auto start = std::chrono::steady_clock::now();
+    TEST_CHECK(predictor.load(dictionary), "Load failed");
+    auto load_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::steady_clock::now() - start
+                   ).count();
+
+    std::vector<std::string> keys;
+    for (auto &[key, weight] : reference.weights) {
+        keys.push_back(key);
+    }
+    int predict_num = 0;
+    int64_t time_us = 0;
+    int64_t visit_num = 0;
+    int visit_num_max = 0;
+    std::vector<std::string_view> words(WORD_NUM_MAX);
+    for (int i = 0; i < lookup_num; i++) {
+        // Like typing a word, one more letter at a time
+        const std::string &key = keys[random() % keys.size()];
+        for (size_t length = 1; length <= key.size(); length++) {
+            predictor.predict(std::string_view(key).substr(0, length), words.data(), WORD_NUM_MAX);
+            predict_num++;
+            time_us += predictor.getLastLookupInfo().time_us;
+            visit_num += predictor.getLastLookupInfo().visit_num;
+            visit_num_max = std::max(visit_num_max, predictor.getLastLookupInfo().visit_num);
+        }
+    }
+    printf(
+        "%d words in %zu KB, loaded in %lld ms | %d lookups: %.2f us avg, %d us max, %.1f visits avg, %d max\n",
+        predictor.getWordNum(), predictor.getMemorySize() / 1024, static_cast<long long>(load_us / 1000),
+        predict_num, static_cast<double>(time_us) / predict_num, predictor.getLookupTimeMaxUs(),
+        static_cast<double>(visit_num) / predict_num, visit_num_max
+    );
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    bool is_quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !is_quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    // Invalid dictionaries are expected by the tests
+    esp_utils::host_log_level = ESP_UTILS_LOG_LEVEL_NONE;
+
+    test_basic();
+    test_reference(is_quick ? 5000 : 50000, is_quick ? 2000 : 20000);
+    test_budget(is_quick ? 5000 : 50000);
+    test_lookup_time(is_quick ? 20000 : 100000, is_quick ? 1000 : 10000);
+
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,276 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * Test of the GUI lock. It checks the timer running the posted functions over two LVGL sessions, then waits on the
+ * lock held by another thread, held outside `LvLock`, passed between threads and failing in the backend. A deadlock
+ * must be reported only when the lock does not change hands for `CONFIG_ESP_BROOKESIA_LVGL_LOCK_DEADLOCK_REPORT_MS`.
+ *
+ * Usage: brookesia_host_lv_lock_test [--quick]
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "esp_lib_utils.h"
+#include "sdkconfig.h"
+#include "lvgl.h"
+#include "lvgl/esp_brookesia_lv_lock.hpp"
+
+using namespace esp_brookesia;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr int REPORT_MS = CONFIG_ESP_BROOKESIA_LVGL_LOCK_DEADLOCK_REPORT_MS;
+
+// The lock of the display, as taken by the LVGL task
+std::timed_mutex gui_mutex;
+std::atomic<bool> is_backend_broken = false;
+
+int failure_num = 0;
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+void register_callbacks(void)
+{
+    gui::LvLock::registerCallbacks([](int timeout_ms) {
+        if (is_backend_broken) {
+            return false;
+        }
+        if (timeout_ms < 0) {
+            gui_mutex.lock();
+            return true;
+        }
+        return gui_mutex.try_lock_for(std::chrono::milliseconds(timeout_ms));
+    }, []() {
+        gui_mutex.unlock();
+        return true;
+    });
+}
+
+int get_timer_num(void)
+{
+    int num = 0;
+    for (lv_timer_t *timer = lv_timer_get_next(nullptr); timer != nullptr; timer = lv_timer_get_next(timer)) {
+        num++;
+    }
+    return num;
+}
+
+int get_elapsed_ms(Clock::time_point start)
+{
+    return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+}
+
+gui::LvLock::CallSiteStats get_stats(const char *call_site)
+{
+    for (auto &stats : gui::LvLock::getInstance().getStats()) {
+        if (strcmp(stats.call_site, call_site) == 0) {
+            return stats;
+        }
+    }
+    return {};
+}
+
+// Hold the lock from another thread through `LvLock` for a while
+std::thread hold_in_thread(const char *call_site, int hold_ms, std::atomic<bool> &is_locked)
+{
+    is_locked = false;
+    std::thread thread([ =, &is_locked]() {
+        auto &lock = gui::LvLock::getInstance();
+        lock.lock(-1, call_site);
+        is_locked = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(hold_ms));
+        lock.unlock();
+    });
+    while (!is_locked) {
+        std::this_thread::yield();
+    }
+    return thread;
+}
+
+void test_post_timer(void)
+{
+    std::atomic<int> run_num = 0;
+
+    TEST_CHECK(!gui::LvLock::post([&]() { run_num++; }), "Post without the callbacks");
+
+    for (int session = 0; session < 2; session++) {
+        lv_init();
+        int timer_num = get_timer_num();
+        register_callbacks();
+        TEST_CHECK(get_timer_num() == timer_num + 1, "Session %d: %d timers", session, get_timer_num() - timer_num);
+
+        // From another thread, without the lock
+        std::thread([&]() {
+            TEST_CHECK(gui::LvLock::post([&]() { run_num++; }), "Session %d: post failed", session);
+        }).join();
+        {
+            gui::LvLockGuard gui_guard;
+            lv_tick_inc(gui::LvLock::POST_TIMER_PERIOD_MS);
+            lv_timer_handler();
+        }
+        TEST_CHECK(run_num == session + 1, "Session %d: %d functions run", session, run_num.load());
+
+        // The functions not run yet are dropped with the timer
+        TEST_CHECK(gui::LvLock::post([&]() { run_num++; }), "Session %d: post failed", session);
+        gui::LvLock::unregisterCallbacks();
+        TEST_CHECK(get_timer_num() == timer_num, "Session %d: timer left", session);
+        TEST_CHECK(!gui::LvLock::post([&]() { run_num++; }), "Session %d: post after unregister", session);
+        lv_deinit();
+    }
+    TEST_CHECK(run_num == 2, "%d functions run", run_num.load());
+}
+
+void test_held_by_owner(void)
+{
+    auto &lock = gui::LvLock::getInstance();
+    std::atomic<bool> is_locked;
+
+    // The owner does not release the lock for a few report intervals
+    auto owner = hold_in_thread("stuck_owner", REPORT_MS * 3 + REPORT_MS / 2, is_locked);
+    auto start = Clock::now();
+    TEST_CHECK(lock.lock(-1, "wait_stuck_owner"), "Lock after a stuck owner failed");
+    int waited_ms = get_elapsed_ms(start);
+    lock.unlock();
+    owner.join();
+    auto stats = get_stats("wait_stuck_owner");
+    printf("Stuck owner: waited %d ms, %u deadlock reports\n", waited_ms, stats.deadlock_report_count);
+    TEST_CHECK(stats.deadlock_report_count == 3, "Stuck owner: %u deadlock reports", stats.deadlock_report_count);
+
+    // The timeout is kept, whatever the report interval
+    owner = hold_in_thread("timeout_owner", REPORT_MS * 3, is_locked);
+    start = Clock::now();
+    TEST_CHECK(!lock.lock(REPORT_MS * 2 + REPORT_MS / 2, "wait_timeout"), "Lock held by another thread succeeded");
+    waited_ms = get_elapsed_ms(start);
+    owner.join();
+    stats = get_stats("wait_timeout");
+    TEST_CHECK(
+        (waited_ms >= REPORT_MS * 2 + REPORT_MS / 2) && (waited_ms < REPORT_MS * 3), "Timeout: waited %d ms", waited_ms
+    );
+    TEST_CHECK((stats.timeout_count == 1) && (stats.deadlock_report_count == 2), "Timeout: %u timeouts, %u reports",
+               stats.timeout_count, stats.deadlock_report_count);
+}
+
+void test_held_outside(void)
+{
+    // The lock is held by the LVGL task itself, e.g. while it renders
+    std::atomic<bool> is_locked = false;
+    std::thread lvgl_task([&]() {
+        gui_mutex.lock();
+        is_locked = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(REPORT_MS * 2 + REPORT_MS / 2));
+        gui_mutex.unlock();
+    });
+    while (!is_locked) {
+        std::this_thread::yield();
+    }
+
+    auto &lock = gui::LvLock::getInstance();
+    TEST_CHECK(lock.lock(-1, "wait_outside"), "Lock after the LVGL task failed");
+    lock.unlock();
+    lvgl_task.join();
+    auto stats = get_stats("wait_outside");
+    TEST_CHECK(stats.deadlock_report_count == 2, "Held outside: %u deadlock reports", stats.deadlock_report_count);
+}
+
+void test_contended(int round_num)
+{
+    // Two threads pass the lock to each other, each one holds it for less than the report interval
+    std::atomic<bool> is_running = true;
+    std::atomic<int> lock_num = 0;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 2; i++) {
+        threads.emplace_back([&]() {
+            auto &lock = gui::LvLock::getInstance();
+            while (is_running) {
+                lock.lock(-1, "contended_owner");
+                lock_num++;
+                std::this_thread::sleep_for(std::chrono::milliseconds(REPORT_MS / 2));
+                lock.unlock();
+                // Give the waiting threads a chance, the mutex is not fair
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+    }
+    while (lock_num == 0) {
+        std::this_thread::yield();
+    }
+
+    auto &lock = gui::LvLock::getInstance();
+    int wait_max_ms = 0;
+    for (int i = 0; i < round_num; i++) {
+        auto start = Clock::now();
+        TEST_CHECK(lock.lock(-1, "wait_contended"), "Contended lock failed");
+        wait_max_ms = std::max(wait_max_ms, get_elapsed_ms(start));
+        lock.unlock();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    is_running = false;
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    auto stats = get_stats("wait_contended");
+    printf("Contended: %d locks by the other threads, wait max %d ms\n", lock_num.load(), wait_max_ms);
+    TEST_CHECK(stats.deadlock_report_count == 0, "Contended: %u deadlock reports", stats.deadlock_report_count);
+}
+
+void test_broken_backend(void)
+{
+    // Nobody holds the lock and the backend fails at once, the wait must not go on forever
+    is_backend_broken = true;
+    auto start = Clock::now();
+    TEST_CHECK(!gui::LvLock::getInstance().lock(-1, "wait_broken"), "Lock with a broken backend succeeded");
+    int waited_ms = get_elapsed_ms(start);
+    is_backend_broken = false;
+    auto stats = get_stats("wait_broken");
+    TEST_CHECK(waited_ms < REPORT_MS, "Broken backend: waited %d ms", waited_ms);
+    TEST_CHECK(stats.deadlock_report_count == 0, "Broken backend: %u deadlock reports", stats.deadlock_report_count);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    bool is_quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !is_quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The deadlock reports and the failures are expected
+    esp_utils::host_log_level = ESP_UTILS_LOG_LEVEL_NONE;
+
+    test_post_timer();
+
+    lv_init();
+    register_callbacks();
+    test_held_by_owner();
+    test_held_outside();
+    test_contended(is_quick ? 20 : 200);
+    test_broken_backend();
+    gui::LvLock::unregisterCallbacks();
+    lv_deinit();
+
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,346 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * Test of the NVS storage service, on the NVS of the host simulator backed by a file. It checks that the blobs with a
+ * bad CRC32 are dropped when loading, that the updates of the write-behind mode are merged into one commit, and that
+ * `flushNVS()` commits all the pending updates before the other events. Then it restarts the NVS from its file, as a
+ * reboot does, and checks that what was flushed is read back with its CRC and what was still pending is not.
+ *
+ * Usage: brookesia_host_storage_nvs_test [--quick]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "esp_lib_utils.h"
+#include "esp_rom_crc.h"
+#include "nvs_flash.h"
+#include "nvs.h"
+#include "nvs_host.h"
+#include "storage_nvs/esp_brookesia_service_storage_nvs.hpp"
+
+using namespace esp_brookesia::services;
+
+namespace {
+
+// Same as the service
+constexpr const char *NVS_NAMESPACE = "storage";
+constexpr auto FUTURE_TIMEOUT = std::chrono::seconds(5);
+constexpr int UPDATE_NUM = 200;
+constexpr int QUICK_UPDATE_NUM = 20;
+
+struct Settings {
+    int32_t brightness;
+    int32_t volume;
+    char wifi_ssid[32];
+};
+
+int failure_num = 0;
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+std::vector<uint8_t> make_stored_blob(const void *data, size_t size)
+{
+    auto bytes = static_cast<const uint8_t *>(data);
+    std::vector<uint8_t> blob(bytes, bytes + size);
+    uint32_t crc = esp_rom_crc32_le(0, bytes, size);
+    for (size_t i = 0; i < sizeof(crc); i++) {
+        blob.push_back(static_cast<uint8_t>(crc >> (8 * i)));
+    }
+    return blob;
+}
+
+bool write_raw_blob(const char *key, const std::vector<uint8_t> &blob)
+{
+    nvs_handle_t handle;
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        return false;
+    }
+    bool ret = (nvs_set_blob(handle, key, blob.data(), blob.size()) == ESP_OK) && (nvs_commit(handle) == ESP_OK);
+    nvs_close(handle);
+    return ret;
+}
+
+bool erase_raw_key(const char *key)
+{
+    nvs_handle_t handle;
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        return false;
+    }
+    bool ret = (nvs_erase_key(handle, key) == ESP_OK) && (nvs_commit(handle) == ESP_OK);
+    nvs_close(handle);
+    return ret;
+}
+
+bool read_raw_blob(const char *key, std::vector<uint8_t> &blob)
+{
+    nvs_handle_t handle;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+    size_t size = 0;
+    bool ret = (nvs_get_blob(handle, key, nullptr, &size) == ESP_OK);
+    if (ret) {
+        blob.resize(size);
+        ret = (nvs_get_blob(handle, key, blob.data(), &size) == ESP_OK);
+    }
+    nvs_close(handle);
+    return ret;
+}
+
+bool read_raw_i32(const char *key, int32_t &value)
+{
+    nvs_handle_t handle;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+    bool ret = (nvs_get_i32(handle, key, &value) == ESP_OK);
+    nvs_close(handle);
+    return ret;
+}
+
+bool wait_future(StorageNVS::EventFuture &future)
+{
+    return (future.wait_for(FUTURE_TIMEOUT) == std::future_status::ready) && future.get();
+}
+
+// Reload the parameters from NVS, as `begin()` does
+bool reload(StorageNVS &storage)
+{
+    StorageNVS::EventFuture future;
+    return storage.sendEvent({.operation = StorageNVS::Operation::UpdateParam}, &future) && wait_future(future);
+}
+
+void test_crc(StorageNVS &storage)
+{
+    const Settings good = {.brightness = 80, .volume = 30, .wifi_ssid = "brookesia"};
+    Settings bad = {.brightness = 10, .volume = 90, .wifi_ssid = "corrupted"};
+
+    // Stored before the service starts, as left by a previous boot
+    auto bad_blob = make_stored_blob(&bad, sizeof(bad));
+    bad_blob[4] ^= 0x01;
+    TEST_CHECK(write_raw_blob("good", make_stored_blob(&good, sizeof(good))), "Write good blob failed");
+    TEST_CHECK(write_raw_blob("bad", bad_blob), "Write bad blob failed");
+    TEST_CHECK(write_raw_blob("short", {0x12, 0x34}), "Write short blob failed");
+
+    TEST_CHECK(storage.begin(), "Begin failed");
+
+    Settings loaded = {};
+    TEST_CHECK(storage.getLocalParamStruct("good", loaded) && (memcmp(&loaded, &good, sizeof(good)) == 0),
+               "Good blob not loaded");
+    TEST_CHECK(!storage.getLocalParamStruct("bad", loaded), "Blob with a bad CRC loaded");
+    TEST_CHECK(!storage.getLocalParamStruct("short", loaded), "Blob shorter than its CRC loaded");
+    TEST_CHECK(storage.getStats().crc_error_count == 1, "%u CRC errors", storage.getStats().crc_error_count);
+    // As the owners of the keys would do with their default values
+    TEST_CHECK(erase_raw_key("bad") && erase_raw_key("short"), "Erase bad keys failed");
+
+    // A blob saved by the service carries the CRC of its data, little-endian
+    StorageNVS::EventFuture future;
+    storage.setWriteBehindWindow(0);
+    TEST_CHECK(storage.setLocalParamStruct("saved", good, nullptr, &future) && wait_future(future), "Save failed");
+    std::vector<uint8_t> stored;
+    TEST_CHECK(read_raw_blob("saved", stored) && (stored == make_stored_blob(&good, sizeof(good))),
+               "Saved blob is %d bytes, not data + CRC32", static_cast<int>(stored.size()));
+
+    // Corrupted after it was saved, every bit of the data or of the CRC is checked
+    int rejected_num = 0;
+    for (size_t bit = 0; bit < stored.size() * 8; bit += 7) {
+        auto corrupted = stored;
+        corrupted[bit / 8] ^= static_cast<uint8_t>(1 << (bit % 8));
+        auto crc_error_count = storage.getStats().crc_error_count;
+        TEST_CHECK(write_raw_blob("saved", corrupted) && reload(storage), "Reload failed");
+        if (storage.getStats().crc_error_count == crc_error_count + 1) {
+            rejected_num++;
+        }
+    }
+    TEST_CHECK(rejected_num == static_cast<int>((stored.size() * 8 + 6) / 7), "%d corrupted blobs rejected",
+               rejected_num);
+    TEST_CHECK(write_raw_blob("saved", stored), "Restore blob failed");
+    printf("CRC: %d corrupted blobs rejected\n", rejected_num);
+}
+
+void test_coalescing(StorageNVS &storage, int update_num)
+{
+    storage.setWriteBehindWindow(60 * 1000);
+    auto stats = storage.getStats();
+    int32_t stored = 0;
+    TEST_CHECK(!read_raw_i32("brightness", stored), "Key written before the test");
+
+    // Many updates of two keys, e.g. a slider being dragged
+    std::vector<StorageNVS::EventFuture> futures(update_num * 2);
+    for (int i = 0; i < update_num; i++) {
+        TEST_CHECK(storage.setLocalParam("brightness", i, nullptr, &futures[i * 2]), "Set brightness failed");
+        TEST_CHECK(storage.setLocalParam("theme", "theme_" + std::to_string(i), nullptr, &futures[i * 2 + 1]),
+                   "Set theme failed");
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    TEST_CHECK(storage.getStats().commit_count == stats.commit_count, "Committed inside the write-behind window");
+    TEST_CHECK(!read_raw_i32("brightness", stored), "Written inside the write-behind window");
+
+    StorageNVS::EventFuture flush_future;
+    TEST_CHECK(storage.flushNVS(nullptr, &flush_future) && wait_future(flush_future), "Flush failed");
+    int resolved_num = 0;
+    for (auto &future : futures) {
+        resolved_num += wait_future(future) ? 1 : 0;
+    }
+    auto new_stats = storage.getStats();
+    printf(
+        "Coalescing: %d updates, %u merged, %u commits\n", update_num * 2,
+        new_stats.coalesced_count - stats.coalesced_count, new_stats.commit_count - stats.commit_count
+    );
+    TEST_CHECK(resolved_num == update_num * 2, "%d of %d updates resolved", resolved_num, update_num * 2);
+    TEST_CHECK(new_stats.update_count - stats.update_count == static_cast<uint32_t>(update_num * 2), "%u updates",
+               new_stats.update_count - stats.update_count);
+    TEST_CHECK(new_stats.coalesced_count - stats.coalesced_count == static_cast<uint32_t>((update_num - 1) * 2),
+               "%u updates merged", new_stats.coalesced_count - stats.coalesced_count);
+    TEST_CHECK(new_stats.commit_count - stats.commit_count == 1, "%u commits",
+               new_stats.commit_count - stats.commit_count);
+    TEST_CHECK(read_raw_i32("brightness", stored) && (stored == update_num - 1), "Stored brightness %d", stored);
+
+    // Nothing left to commit
+    TEST_CHECK(storage.flushNVS(nullptr, &flush_future) && wait_future(flush_future), "Second flush failed");
+    TEST_CHECK(storage.getStats().commit_count == new_stats.commit_count, "Second flush committed");
+}
+
+void test_flush_order(StorageNVS &storage)
+{
+    storage.setWriteBehindWindow(60 * 1000);
+
+    // The pending updates are committed before an erase, so the erase wins
+    StorageNVS::EventFuture set_future;
+    StorageNVS::EventFuture erase_future;
+    auto commit_count = storage.getStats().commit_count;
+    TEST_CHECK(storage.setLocalParam("volume", 42, nullptr, &set_future), "Set volume failed");
+    TEST_CHECK(storage.eraseNVS(nullptr, &erase_future), "Erase failed");
+    TEST_CHECK(wait_future(set_future) && wait_future(erase_future), "Set or erase failed");
+    int32_t stored = 0;
+    TEST_CHECK(!read_raw_i32("volume", stored), "Update committed after the erase");
+    TEST_CHECK(storage.getStats().commit_count == commit_count + 1, "%u commits",
+               storage.getStats().commit_count - commit_count);
+
+    // Once the window is over, the pending updates are committed without flush
+    storage.setWriteBehindWindow(50);
+    commit_count = storage.getStats().commit_count;
+    TEST_CHECK(storage.setLocalParam("volume", 7, nullptr, &set_future), "Set volume failed");
+    TEST_CHECK(storage.setLocalParam("volume", 8), "Set volume failed");
+    TEST_CHECK(wait_future(set_future), "Update not committed after the window");
+    TEST_CHECK(read_raw_i32("volume", stored) && (stored == 8), "Stored volume %d", stored);
+    TEST_CHECK(storage.getStats().commit_count == commit_count + 1, "%u commits",
+               storage.getStats().commit_count - commit_count);
+
+    // Without the window, every update is committed
+    storage.setWriteBehindWindow(0);
+    commit_count = storage.getStats().commit_count;
+    for (int i = 0; i < 5; i++) {
+        TEST_CHECK(storage.setLocalParam("volume", i, nullptr, &set_future) && wait_future(set_future),
+                   "Set volume failed");
+    }
+    TEST_CHECK(storage.getStats().commit_count == commit_count + 5, "%u commits",
+               storage.getStats().commit_count - commit_count);
+}
+
+void test_restart(StorageNVS &storage)
+{
+    storage.setWriteBehindWindow(60 * 1000);
+    const Settings settings = {.brightness = 55, .volume = 12, .wifi_ssid = "after_reboot"};
+    std::vector<uint8_t> stored;
+    int32_t boots = 0;
+
+    // Still in the write-behind window, so a reboot loses them
+    StorageNVS::EventFuture struct_future;
+    StorageNVS::EventFuture boots_future;
+    TEST_CHECK(storage.setLocalParamStruct("restart", settings, nullptr, &struct_future), "Set struct failed");
+    TEST_CHECK(storage.setLocalParam("boots", 1, nullptr, &boots_future), "Set boots failed");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    TEST_CHECK(nvs_host_restart() == ESP_OK, "Restart failed");
+    TEST_CHECK(!read_raw_blob("restart", stored) && !read_raw_i32("boots", boots),
+               "Pending updates survived a restart");
+
+    // Flushed, they survive it, the blob with the CRC32 of its data
+    StorageNVS::EventFuture flush_future;
+    TEST_CHECK(storage.flushNVS(nullptr, &flush_future) && wait_future(flush_future), "Flush failed");
+    TEST_CHECK(wait_future(struct_future) && wait_future(boots_future), "Pending updates not resolved");
+    TEST_CHECK(nvs_host_restart() == ESP_OK, "Restart failed");
+    TEST_CHECK(read_raw_i32("boots", boots) && (boots == 1), "Stored boots %d after a restart", boots);
+    TEST_CHECK(read_raw_blob("restart", stored) && (stored.size() == sizeof(settings) + sizeof(uint32_t)),
+               "Blob of %d bytes after a restart", static_cast<int>(stored.size()));
+    if (stored.size() == sizeof(settings) + sizeof(uint32_t)) {
+        uint32_t crc = 0;
+        for (size_t i = 0; i < sizeof(crc); i++) {
+            crc |= static_cast<uint32_t>(stored[sizeof(settings) + i]) << (8 * i);
+        }
+        TEST_CHECK(crc == esp_rom_crc32_le(0, stored.data(), sizeof(settings)), "CRC32 of the blob differs");
+        TEST_CHECK(memcmp(stored.data(), &settings, sizeof(settings)) == 0, "Data of the blob differs");
+    }
+
+    // The service loads it again, as at boot
+    auto crc_error_count = storage.getStats().crc_error_count;
+    Settings loaded = {};
+    TEST_CHECK(reload(storage) && storage.getLocalParamStruct("restart", loaded) &&
+               (memcmp(&loaded, &settings, sizeof(settings)) == 0), "Blob not loaded after a restart");
+    TEST_CHECK(storage.getStats().crc_error_count == crc_error_count, "CRC error after a restart");
+
+    // Damaged in the flash, it is dropped at the next boot
+    auto corrupted = make_stored_blob(&settings, sizeof(settings));
+    corrupted[0] ^= 0x80;
+    TEST_CHECK(write_raw_blob("restart", corrupted) && (nvs_host_restart() == ESP_OK) && reload(storage),
+               "Reload of a damaged blob failed");
+    TEST_CHECK(storage.getStats().crc_error_count == crc_error_count + 1, "Damaged blob after a restart not dropped");
+    TEST_CHECK(erase_raw_key("restart"), "Erase damaged key failed");
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    bool is_quick = (argc > 1) && (strcmp(argv[1], "--quick") == 0);
+    if ((argc > 2) || ((argc == 2) && !is_quick)) {
+        printf("Usage: %s [--quick]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The CRC errors are expected
+    esp_utils::host_log_level = ESP_UTILS_LOG_LEVEL_NONE;
+
+    // The flash of the NVS
+    char dir_path[] = "/tmp/brookesia_host_nvs_XXXXXX";
+    if (mkdtemp(dir_path) == nullptr) {
+        printf("Failed to create a temporary directory\n");
+        return EXIT_FAILURE;
+    }
+    std::string file_path = std::string(dir_path) + "/nvs.bin";
+    TEST_CHECK(nvs_host_set_file(file_path.c_str()) == ESP_OK, "Set NVS file failed");
+
+    TEST_CHECK(nvs_flash_erase() == ESP_OK, "Erase NVS failed");
+    auto &storage = StorageNVS::requestInstance();
+    test_crc(storage);
+    test_coalescing(storage, is_quick ? QUICK_UPDATE_NUM : UPDATE_NUM);
+    test_flush_order(storage);
+    test_restart(storage);
+
+    remove(file_path.c_str());
+    rmdir(dir_path);
+
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+    } else {
+        printf("All checks passed\n");
+    }
+
+    // The event thread of the service never ends, leave without destroying the service under it
+    fflush(stdout);
+    _Exit((failure_num > 0) ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,681 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/**
+ * Test of the uplink voice gate of the AI agent. It checks the G.711 A-law decoding, the pre-roll and the onset, then
+ * generates scenes of a wake word and a request (quiet, noisy, with a pause and a follow-up, wake word only), writes
+ * them as WAV files and reads them back. Each scene is recorded in frames of 120 ms, the same way as the agent, and
+ * sent both through the gate and as the agent did without it: every frame read after the wake word is detected. It
+ * reports the time from the detection to the first upload, the part of the request which is sent and the bytes sent.
+ *
+ * Usage: brookesia_host_voice_gate_test [--quick] [--wav <file> --wake-ms <ms>]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include "esp_lib_utils.h"
+#include "agent/audio_voice_gate.hpp"
+
+using namespace esp_brookesia::ai_framework;
+
+namespace {
+
+constexpr uint32_t SAMPLE_RATE = 8000;
+constexpr size_t FRAME_SIZE = 960;
+constexpr uint32_t FRAME_DURATION_MS = FRAME_SIZE * 1000 / SAMPLE_RATE;
+// Time taken by the wake word engine to notice the end of the wake word
+constexpr uint32_t WAKE_DETECT_DELAY_MS = 300;
+constexpr int SEED_NUM = 20;
+constexpr int QUICK_SEED_NUM = 3;
+
+// Same as `coze_chat_app_init()` with the default options
+const AudioVoiceGate::Config GATE_CONFIG = {
+    .frame_size_max = FRAME_SIZE,
+    .byte_rate = SAMPLE_RATE,
+    .preroll_ms = 1500,
+    .onset_ms = 300,
+    .end_silence_ms = 1000,
+    .enable_vad = true,
+    .vad = {
+        .sample_rate = SAMPLE_RATE,
+        .threshold_db = 12,
+        .speech_min_ms = 60,
+        .hangover_ms = 200,
+    },
+};
+
+int failure_num = 0;
+
+#define TEST_CHECK(condition, fmt, ...) \
+    do { \
+        if (!(condition)) { \
+            printf("FAILED(line %d): " fmt "\n", __LINE__, ##__VA_ARGS__); \
+            failure_num++; \
+        } \
+    } while (0)
+
+struct Interval {
+    uint32_t start_ms;
+    uint32_t end_ms;
+};
+
+struct Scene {
+    const char *name;
+    Interval wake_word;
+    std::vector<Interval> requests;
+    uint32_t duration_ms;
+    float noise_rms;            // Background noise, low-passed like a room
+    float hum_amplitude;        // 50 Hz mains hum
+    int expected_speech_start_num;
+};
+
+struct Result {
+    uint32_t first_upload_ms;   // From the wake word detection, UINT32_MAX if nothing is sent
+    uint32_t request_ms;
+    uint32_t request_sent_ms;
+    uint32_t wake_word_sent_ms;
+    uint32_t sent_bytes;
+    AudioVoiceGate::Stats stats;
+};
+
+/*
+ * G.711 A-law encoder, the reference of ITU-T G.191
+ */
+uint8_t encode_g711a(int16_t sample)
+{
+    static const int16_t SEGMENT_ENDS[8] = {0x1F, 0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF};
+
+    int value = sample >> 3;
+    uint8_t mask = 0xD5;
+    if (value < 0) {
+        mask = 0x55;
+        value = -value - 1;
+    }
+    int segment = 0;
+    while ((segment < 8) && (value > SEGMENT_ENDS[segment])) {
+        segment++;
+    }
+    if (segment >= 8) {
+        return 0x7F ^ mask;
+    }
+    uint8_t code = segment << 4;
+    code |= (segment < 2) ? ((value >> 1) & 0x0F) : ((value >> segment) & 0x0F);
+
+    return code ^ mask;
+}
+
+/*
+ * WAV files of 16-bit PCM
+ */
+void write_u32(std::ofstream &file, uint32_t value)
+{
+    uint8_t bytes[4] = {
+        static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value >> 16),
+        static_cast<uint8_t>(value >> 24)
+    };
+    file.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+}
+
+void write_u16(std::ofstream &file, uint16_t value)
+{
+    uint8_t bytes[2] = {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8)};
+    file.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+}
+
+bool write_wav(const std::string &path, const std::vector<int16_t> &samples, uint32_t sample_rate)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    uint32_t data_size = static_cast<uint32_t>(samples.size() * sizeof(int16_t));
+    file.write("RIFF", 4);
+    write_u32(file, 36 + data_size);
+    file.write("WAVEfmt ", 8);
+    write_u32(file, 16);
+    write_u16(file, 1);
+    write_u16(file, 1);
+    write_u32(file, sample_rate);
+    write_u32(file, sample_rate * sizeof(int16_t));
+    write_u16(file, sizeof(int16_t));
+    write_u16(file, 16);
+    file.write("data", 4);
+    write_u32(file, data_size);
+    for (int16_t sample : samples) {
+        write_u16(file, static_cast<uint16_t>(sample));
+    }
+
+    return static_cast<bool>(file);
+}
+
+uint32_t read_le(const uint8_t *bytes, int size)
+{
+    uint32_t value = 0;
+    for (int i = size - 1; i >= 0; i--) {
+        value = (value << 8) | bytes[i];
+    }
+
+    return value;
+}
+
+/**
+ * @brief Read the first channel of a WAV file of 16-bit PCM, resampled to 8 kHz
+ */
+bool read_wav(const std::string &path, std::vector<int16_t> &samples)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if ((bytes.size() < 12) || (memcmp(bytes.data(), "RIFF", 4) != 0) || (memcmp(&bytes[8], "WAVE", 4) != 0)) {
+        printf("%s is not a WAV file\n", path.c_str());
+        return false;
+    }
+
+    uint32_t channel_num = 0;
+    uint32_t sample_rate = 0;
+    size_t pos = 12;
+    while (pos + 8 <= bytes.size()) {
+        uint32_t chunk_size = read_le(&bytes[pos + 4], 4);
+        const uint8_t *chunk = &bytes[pos + 8];
+        size_t chunk_end = std::min(bytes.size(), pos + 8 + chunk_size);
+        if ((memcmp(&bytes[pos], "fmt ", 4) == 0) && (chunk_size >= 16)) {
+            uint32_t format = read_le(chunk, 2);
+            channel_num = read_le(chunk + 2, 2);
+            sample_rate = read_le(chunk + 4, 4);
+            if ((format != 1) || (read_le(chunk + 14, 2) != 16) || (channel_num == 0) || (sample_rate == 0)) {
+                printf("%s is not 16-bit PCM\n", path.c_str());
+                return false;
+            }
+        } else if ((memcmp(&bytes[pos], "data", 4) == 0) && (channel_num > 0)) {
+            size_t frame_num = (chunk_end - pos - 8) / (2 * channel_num);
+            size_t sample_num = frame_num * SAMPLE_RATE / sample_rate;
+            samples.resize(sample_num);
+            for (size_t i = 0; i < sample_num; i++) {
+                double src = static_cast<double>(i) * sample_rate / SAMPLE_RATE;
+                size_t index = std::min(static_cast<size_t>(src), frame_num - 1);
+                size_t next = std::min(index + 1, frame_num - 1);
+                double ratio = src - index;
+                auto get = [&](size_t frame) {
+                    return static_cast<int16_t>(read_le(chunk + frame * 2 * channel_num, 2));
+                };
+                samples[i] = static_cast<int16_t>(std::lround(get(index) * (1 - ratio) + get(next) * ratio));
+            }
+            return true;
+        }
+        pos += 8 + chunk_size + (chunk_size & 1);
+    }
+    printf("%s has no audio\n", path.c_str());
+
+    return false;
+}
+
+/*
+ * Scenes
+ */
+class SceneGenerator {
+public:
+    explicit SceneGenerator(uint32_t seed): _random(seed) {}
+
+    std::vector<int16_t> generate(const Scene &scene)
+    {
+        std::vector<float> audio(static_cast<size_t>(scene.duration_ms) * SAMPLE_RATE / 1000, 0);
+
+        addWords(audio, scene.wake_word);
+        for (const auto &request : scene.requests) {
+            addWords(audio, request);
+        }
+
+        std::normal_distribution<float> noise(0, 1);
+        float low_pass = 0;
+        for (size_t i = 0; i < audio.size(); i++) {
+            // A one pole low-pass keeps about a third of the power of white noise
+            low_pass = 0.7f * low_pass + 0.3f * noise(_random);
+            audio[i] += scene.noise_rms * low_pass * 2.4f;
+            audio[i] += scene.hum_amplitude * sinf(2 * M_PI * 50 * i / SAMPLE_RATE);
+        }
+
+        std::vector<int16_t> samples(audio.size());
+        for (size_t i = 0; i < audio.size(); i++) {
+            samples[i] = static_cast<int16_t>(std::clamp(audio[i], -32768.0f, 32767.0f));
+        }
+
+        return samples;
+    }
+
+private:
+    /**
+     * @brief Fill an interval with syllables: a voiced vowel, sometimes after a fricative, with short gaps
+     */
+    void addWords(std::vector<float> &audio, const Interval &interval)
+    {
+        std::uniform_int_distribution<uint32_t> syllable_ms(120, 260);
+        std::uniform_int_distribution<uint32_t> gap_ms(20, 90);
+        std::uniform_real_distribution<float> pitch(100, 220);
+        std::uniform_real_distribution<float> level(3000, 9000);
+        std::bernoulli_distribution has_fricative(0.3);
+
+        uint32_t time_ms = interval.start_ms;
+        while (time_ms + 80 < interval.end_ms) {
+            uint32_t duration_ms = std::min(syllable_ms(_random), interval.end_ms - time_ms);
+            if (has_fricative(_random) && (duration_ms > 150)) {
+                addFricative(audio, time_ms, 60);
+                time_ms += 60;
+                duration_ms -= 60;
+            }
+            addVowel(audio, time_ms, duration_ms, pitch(_random), level(_random));
+            time_ms += duration_ms + gap_ms(_random);
+        }
+    }
+
+    void addVowel(std::vector<float> &audio, uint32_t start_ms, uint32_t duration_ms, float pitch, float level)
+    {
+        size_t start = static_cast<size_t>(start_ms) * SAMPLE_RATE / 1000;
+        size_t num = static_cast<size_t>(duration_ms) * SAMPLE_RATE / 1000;
+        int harmonic_num = static_cast<int>(3400 / pitch);
+        float phase = 0;
+        for (size_t i = 0; (i < num) && (start + i < audio.size()); i++) {
+            // 20 ms fades, and the pitch falls a little as in a statement
+            float envelope = std::min({1.0f, i / (0.02f * SAMPLE_RATE), (num - i) / (0.02f * SAMPLE_RATE)});
+            phase += 2 * M_PI * pitch * (1 - 0.1f * i / num) / SAMPLE_RATE;
+            float value = 0;
+            for (int k = 1; k <= harmonic_num; k++) {
+                value += sinf(k * phase) / k;
+            }
+            audio[start + i] += level * envelope * value * 0.5f;
+        }
+    }
+
+    void addFricative(std::vector<float> &audio, uint32_t start_ms, uint32_t duration_ms)
+    {
+        std::normal_distribution<float> noise(0, 1);
+        size_t start = static_cast<size_t>(start_ms) * SAMPLE_RATE / 1000;
+        size_t num = static_cast<size_t>(duration_ms) * SAMPLE_RATE / 1000;
+        float last = 0;
+        for (size_t i = 0; (i < num) && (start + i < audio.size()); i++) {
+            // The first difference of white noise, a hiss
+            float value = noise(_random);
+            audio[start + i] += 1500 * (value - last);
+            last = value;
+        }
+    }
+
+    std::mt19937 _random;
+};
+
+std::vector<Scene> get_scenes(void)
+{
+    return {
+        {"quiet", {1000, 1600}, {{1750, 3750}}, 8000, 20, 0, 0},
+        // The speech is about 18 dB above the noise
+        {"noisy", {1000, 1600}, {{1750, 3750}}, 8000, 250, 150, 0},
+        // A pause in the request, then a follow-up after a silence
+        {"pause", {1000, 1600}, {{1750, 2750}, {3250, 4250}, {7250, 8750}}, 11000, 20, 0, 1},
+        {"wake word only", {1000, 1600}, {}, 8000, 250, 150, 0},
+    };
+}
+
+/*
+ * Recording
+ */
+uint32_t get_overlap_ms(const Interval &a, const Interval &b)
+{
+    uint32_t start = std::max(a.start_ms, b.start_ms);
+    uint32_t end = std::min(a.end_ms, b.end_ms);
+
+    return (end > start) ? end - start : 0;
+}
+
+/**
+ * @brief Record the samples in frames, and send them through the gate, or as the agent did without it
+ *
+ * @param sent_frames  Set for each frame sent
+ */
+bool record(
+    const std::vector<int16_t> &samples, uint32_t wake_detect_ms, bool with_gate, std::vector<bool> &sent_frames,
+    Result &result, double &process_time_us
+)
+{
+    size_t frame_num = samples.size() / FRAME_SIZE;
+    std::vector<std::vector<uint8_t>> frames(frame_num, std::vector<uint8_t>(FRAME_SIZE));
+    for (size_t i = 0; i < frame_num; i++) {
+        for (size_t j = 0; j < FRAME_SIZE; j++) {
+            frames[i][j] = encode_g711a(samples[i * FRAME_SIZE + j]);
+        }
+    }
+
+    sent_frames.assign(frame_num, false);
+    result = {};
+    result.first_upload_ms = UINT32_MAX;
+    size_t current_frame = 0;
+    uint32_t current_ms = 0;
+    auto output = [&](const uint8_t *data, size_t size) {
+        if (result.first_upload_ms == UINT32_MAX) {
+            result.first_upload_ms = current_ms - wake_detect_ms;
+        }
+        // The pre-roll frames are older than the current one, and each frame is sent once
+        for (size_t i = current_frame + 1; i > 0; i--) {
+            if (!sent_frames[i - 1] && (size == FRAME_SIZE) && (memcmp(frames[i - 1].data(), data, size) == 0)) {
+                sent_frames[i - 1] = true;
+                break;
+            }
+        }
+        result.sent_bytes += size;
+        return true;
+    };
+
+    AudioVoiceGate gate;
+    if (with_gate && !gate.begin(GATE_CONFIG, output)) {
+        printf("Begin gate failed\n");
+        return false;
+    }
+
+    std::vector<int16_t> pcm(FRAME_SIZE);
+    bool is_wakeup = false;
+    auto start_time = std::chrono::steady_clock::now();
+    for (current_frame = 0; current_frame < frame_num; current_frame++) {
+        // A frame is read at the end of its recording
+        current_ms = (current_frame + 1) * FRAME_DURATION_MS;
+        if (!is_wakeup && (current_ms >= wake_detect_ms)) {
+            is_wakeup = true;
+            if (with_gate) {
+                gate.requestWakeup();
+            }
+        }
+        const uint8_t *data = frames[current_frame].data();
+        if (with_gate) {
+            decodeG711A(data, FRAME_SIZE, pcm.data());
+            gate.process(data, FRAME_SIZE, pcm.data(), FRAME_SIZE, is_wakeup);
+        } else if (is_wakeup) {
+            output(data, FRAME_SIZE);
+        }
+    }
+    process_time_us = std::chrono::duration<double, std::micro>(
+                          std::chrono::steady_clock::now() - start_time
+                      ).count() / std::max<size_t>(frame_num, 1);
+    if (with_gate) {
+        result.stats = gate.getStats();
+        gate.del();
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get how much of the intervals is in the sent frames
+ */
+void get_sent_ms(
+    const std::vector<bool> &sent_frames, const std::vector<Interval> &intervals, uint32_t &total_ms, uint32_t &sent_ms
+)
+{
+    total_ms = 0;
+    sent_ms = 0;
+    for (const auto &interval : intervals) {
+        total_ms += interval.end_ms - interval.start_ms;
+        for (size_t i = 0; i < sent_frames.size(); i++) {
+            Interval frame = {
+                static_cast<uint32_t>(i * FRAME_DURATION_MS), static_cast<uint32_t>((i + 1) * FRAME_DURATION_MS)
+            };
+            sent_ms += sent_frames[i] ? get_overlap_ms(frame, interval) : 0;
+        }
+    }
+}
+
+/*
+ * Tests
+ */
+void test_g711a(void)
+{
+    for (int value = -32768; value <= 32767; value += 7) {
+        uint8_t code = encode_g711a(static_cast<int16_t>(value));
+        int16_t decoded = 0;
+        decodeG711A(&code, 1, &decoded);
+        // The step of the largest segment is 1024
+        TEST_CHECK(
+            std::abs(decoded - value) <= std::max(16, std::abs(value) / 16), "%d is decoded as %d", value, decoded
+        );
+    }
+}
+
+void test_preroll(void)
+{
+    // Frames of 100 ms, the value of each byte is the index of the frame
+    constexpr size_t SIZE = 800;
+    std::vector<int> sent;
+    auto output = [&](const uint8_t *data, size_t size) {
+        sent.push_back(data[0]);
+        return (data[0] != 13);
+    };
+    std::vector<uint8_t> frame(SIZE);
+    std::vector<int16_t> silence(SIZE, 0);
+    std::vector<int16_t> voice(SIZE);
+    for (size_t i = 0; i < SIZE; i++) {
+        voice[i] = static_cast<int16_t>(8000 * sinf(2 * M_PI * 200 * i / SAMPLE_RATE));
+    }
+
+    // Without the VAD, the pre-roll then every frame
+    AudioVoiceGate::Config config = GATE_CONFIG;
+    config.frame_size_max = SIZE;
+    config.preroll_ms = 350;
+    config.enable_vad = false;
+    AudioVoiceGate gate;
+    TEST_CHECK(gate.begin(config, output), "Begin failed");
+    TEST_CHECK(!gate.begin(config, output), "Begin twice");
+    for (int i = 0; i < 10; i++) {
+        std::fill(frame.begin(), frame.end(), i);
+        gate.process(frame.data(), SIZE, nullptr, 0, false);
+    }
+    TEST_CHECK(sent.empty(), "%d frames sent while closed", static_cast<int>(sent.size()));
+    gate.requestWakeup();
+    for (int i = 10; i < 14; i++) {
+        std::fill(frame.begin(), frame.end(), i);
+        gate.process(frame.data(), SIZE, nullptr, 0, true);
+    }
+    TEST_CHECK(
+        (sent == std::vector<int>{6, 7, 8, 9, 10, 11, 12, 13}), "Sent %d frames from %d", static_cast<int>(sent.size()),
+        sent.empty() ? -1 : sent[0]
+    );
+    auto stats = gate.getStats();
+    TEST_CHECK(stats.wakeup_count == 1, "%u wake-ups", stats.wakeup_count);
+    TEST_CHECK(stats.preroll_frame_count == 4, "%u pre-roll frames", stats.preroll_frame_count);
+    TEST_CHECK(stats.sent_frame_count == 7, "%u frames sent", stats.sent_frame_count);
+    TEST_CHECK(stats.drop_frame_count == 1, "%u frames dropped", stats.drop_frame_count);
+    gate.del();
+
+    // With the VAD, the onset before the speech but not the frames recorded while closed
+    sent.clear();
+    config.enable_vad = true;
+    config.onset_ms = 300;
+    TEST_CHECK(gate.begin(config, output), "Begin failed");
+    std::fill(frame.begin(), frame.end(), 0);
+    for (int i = 0; i < 10; i++) {
+        gate.process(frame.data(), SIZE, silence.data(), SIZE, false);
+    }
+    for (int i = 1; i < 3; i++) {
+        std::fill(frame.begin(), frame.end(), i);
+        gate.process(frame.data(), SIZE, silence.data(), SIZE, true);
+    }
+    TEST_CHECK(sent.empty(), "%d frames sent without speech", static_cast<int>(sent.size()));
+    std::fill(frame.begin(), frame.end(), 3);
+    gate.process(frame.data(), SIZE, voice.data(), SIZE, true);
+    TEST_CHECK((sent == std::vector<int>{1, 2, 3}), "Sent %d frames", static_cast<int>(sent.size()));
+    stats = gate.getStats();
+    TEST_CHECK(stats.speech_start_count == 1, "%u speech starts", stats.speech_start_count);
+    TEST_CHECK(stats.gated_frame_count == 2, "%u frames gated", stats.gated_frame_count);
+    // Stops after the end silence
+    for (int i = 0; i < 20; i++) {
+        gate.process(frame.data(), SIZE, silence.data(), SIZE, true);
+    }
+    TEST_CHECK(!gate.isStreaming(), "Still streaming after a silence");
+    TEST_CHECK(gate.getStats().speech_end_count == 1, "%u speech ends", gate.getStats().speech_end_count);
+    gate.del();
+}
+
+void test_scenes(int seed_num, const std::filesystem::path &dir)
+{
+    printf(
+        "%-15s | %-13s | %-15s | %-14s | %-10s | %-9s | %s\n", "scene", "first upload", "request sent", "wake word sent",
+        "bytes sent", "starts", "process"
+    );
+    auto scenes = get_scenes();
+    for (size_t scene_index = 0; scene_index < scenes.size(); scene_index++) {
+        const Scene &scene = scenes[scene_index];
+        uint32_t wake_detect_ms = scene.wake_word.end_ms + WAKE_DETECT_DELAY_MS;
+        double sum[2][5] = {};
+        double process_time_us = 0;
+        for (int seed = 0; seed < seed_num; seed++) {
+            SceneGenerator generator(seed);
+            std::string path = (dir / ("scene_" + std::to_string(scene_index) + ".wav")).string();
+            std::vector<int16_t> samples;
+            uint32_t baseline_bytes = 0;
+            TEST_CHECK(write_wav(path, generator.generate(scene), SAMPLE_RATE), "Write %s failed", path.c_str());
+            TEST_CHECK(read_wav(path, samples), "Read %s failed", path.c_str());
+
+            for (int with_gate = 0; with_gate < 2; with_gate++) {
+                std::vector<bool> sent_frames;
+                Result result = {};
+                double time_us = 0;
+                if (!record(samples, wake_detect_ms, with_gate, sent_frames, result, time_us)) {
+                    failure_num++;
+                    return;
+                }
+                uint32_t wake_word_ms = 0;
+                get_sent_ms(sent_frames, scene.requests, result.request_ms, result.request_sent_ms);
+                get_sent_ms(sent_frames, {scene.wake_word}, wake_word_ms, result.wake_word_sent_ms);
+
+                double *values = sum[with_gate];
+                values[0] += result.first_upload_ms;
+                values[1] += (result.request_ms > 0) ? 100.0 * result.request_sent_ms / result.request_ms : 100;
+                values[2] += 100.0 * result.wake_word_sent_ms / wake_word_ms;
+                values[3] += result.sent_bytes;
+                values[4] += result.stats.speech_start_count;
+                if (!with_gate) {
+                    baseline_bytes = result.sent_bytes;
+                    continue;
+                }
+                process_time_us += time_us;
+
+                TEST_CHECK(
+                    result.first_upload_ms < FRAME_DURATION_MS, "%s(%d): first upload %u ms after the wake word",
+                    scene.name, seed, result.first_upload_ms
+                );
+                TEST_CHECK(
+                    result.request_sent_ms == result.request_ms, "%s(%d): %u of %u ms of the request sent", scene.name,
+                    seed, result.request_sent_ms, result.request_ms
+                );
+                TEST_CHECK(
+                    result.wake_word_sent_ms == wake_word_ms, "%s(%d): %u of %u ms of the wake word sent", scene.name,
+                    seed, result.wake_word_sent_ms, wake_word_ms
+                );
+                TEST_CHECK(
+                    static_cast<int>(result.stats.speech_start_count) == scene.expected_speech_start_num,
+                    "%s(%d): %u speech starts instead of %d", scene.name, seed, result.stats.speech_start_count,
+                    scene.expected_speech_start_num
+                );
+                TEST_CHECK(
+                    result.sent_bytes < baseline_bytes, "%s(%d): %u bytes sent instead of %u without the gate",
+                    scene.name, seed, result.sent_bytes, baseline_bytes
+                );
+            }
+        }
+        for (int with_gate = 1; with_gate >= 0; with_gate--) {
+            const double *values = sum[with_gate];
+            printf(
+                "%-15s | %10.0f ms | %13.1f %% | %12.1f %% | %10.0f | %9.1f |", with_gate ? scene.name : "  without gate",
+                values[0] / seed_num, values[1] / seed_num, values[2] / seed_num, values[3] / seed_num,
+                values[4] / seed_num
+            );
+            if (with_gate) {
+                printf(" %.2f us/frame", process_time_us / seed_num);
+            }
+            printf("\n");
+        }
+    }
+}
+
+bool test_wav(const std::string &path, uint32_t wake_detect_ms)
+{
+    std::vector<int16_t> samples;
+    if (!read_wav(path, samples)) {
+        return false;
+    }
+    printf("%s: %zu ms, wake word detected at %u ms\n", path.c_str(), samples.size() * 1000 / SAMPLE_RATE,
+           wake_detect_ms);
+    for (int with_gate = 0; with_gate < 2; with_gate++) {
+        std::vector<bool> sent_frames;
+        Result result = {};
+        double time_us = 0;
+        if (!record(samples, wake_detect_ms, with_gate, sent_frames, result, time_us)) {
+            return false;
+        }
+        printf(
+            "  %-12s first upload %u ms, %u bytes sent", with_gate ? "gate" : "without gate",
+            result.first_upload_ms, result.sent_bytes
+        );
+        if (with_gate) {
+            printf(
+                " (%u pre-roll frames), %u speech starts, %u speech ends, %.1f us/frame",
+                result.stats.preroll_frame_count, result.stats.speech_start_count, result.stats.speech_end_count,
+                time_us
+            );
+        }
+        printf("\n");
+    }
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    bool is_quick = false;
+    std::string wav_path;
+    long wake_ms = -1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            is_quick = true;
+        } else if ((strcmp(argv[i], "--wav") == 0) && (i + 1 < argc)) {
+            wav_path = argv[++i];
+        } else if ((strcmp(argv[i], "--wake-ms") == 0) && (i + 1 < argc)) {
+            wake_ms = std::atol(argv[++i]);
+        } else {
+            wake_ms = -2;
+            break;
+        }
+    }
+    if ((wake_ms == -2) || (wav_path.empty() != (wake_ms < 0))) {
+        printf("Usage: %s [--quick] [--wav <file> --wake-ms <ms>]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    // Failures of the gate, such as a second `begin()`, are expected by the tests
+    esp_utils::host_log_level = ESP_UTILS_LOG_LEVEL_NONE;
+
+    if (!wav_path.empty()) {
+        return test_wav(wav_path, static_cast<uint32_t>(wake_ms)) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "brookesia_voice_gate_test";
+    std::filesystem::create_directories(dir);
+
+    test_g711a();
+    test_preroll();
+    test_scenes(is_quick ? QUICK_SEED_NUM : SEED_NUM, dir);
+
+    std::filesystem::remove_all(dir);
+    if (failure_num > 0) {
+        printf("%d checks failed\n", failure_num);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+
+    return EXIT_SUCCESS;
+}
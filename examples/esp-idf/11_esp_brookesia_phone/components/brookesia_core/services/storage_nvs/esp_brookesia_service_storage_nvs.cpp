@@ -5,6 +5,7 @@
  */
 #include <map>
 #include <chrono>
+#include "esp_rom_crc.h"
 #include "nvs_flash.h"
 #include "nvs.h"
 #include "private/esp_brookesia_service_storage_nvs_utils.hpp"
@@ -18,6 +19,9 @@
 #define EVENT_THREAD_STACK_CAPS_EXT         (false)
 #define EVENT_WAIT_FINISH_TIMEOUT_MS_MAX    (60 * 60 * 1000)
 
+// Blobs are stored as `data + CRC32(data)`, the CRC is little-endian
+#define BLOB_CRC_SIZE                       (sizeof(uint32_t))
+
 namespace esp_brookesia::services {
 
 static const std::map<nvs_type_t, const char *> type_str_pair = {
@@ -45,6 +49,16 @@ void StorageNVS::Event::dump() const
     );
 }
 
+static uint32_t calculate_blob_crc(const uint8_t *data, size_t len)
+{
+    return esp_rom_crc32_le(0, data, len);
+}
+
+StorageNVS::StorageNVS():
+    _write_behind_window_ms(ESP_BROOKESIA_STORAGE_NVS_WRITE_BEHIND_WINDOW_MS)
+{
+}
+
 bool StorageNVS::begin()
 {
     ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
@@ -81,16 +95,35 @@ bool StorageNVS::begin()
 
             while (true) {
                 std::unique_lock<std::mutex> lock(_event_mutex);
-                _event_cv.wait(lock, [this] {
+                auto has_event = [this] {
                     return !_event_queue.empty();
-                });
+                };
+                if (_pending_updates.empty()) {
+                    _event_cv.wait(lock, has_event);
+                } else if (!_event_cv.wait_until(lock, _pending_deadline, has_event)) {
+                    // The write-behind window is over
+                    lock.unlock();
+                    flushPendingUpdates();
+                    continue;
+                }
 
                 while (!_event_queue.empty()) {
                     auto event_wrapper = _event_queue.front();
                     _event_queue.pop();
 
                     lock.unlock();
+                    if ((event_wrapper.event.operation == Operation::UpdateNVS) && (_write_behind_window_ms > 0)) {
+                        // The promise is fulfilled when the update is committed
+                        deferEvent(event_wrapper);
+                        lock.lock();
+                        continue;
+                    }
+                    // Commit the pending updates first, so the events are still processed in order
+                    auto is_flushed = flushPendingUpdates();
                     auto ret = processEvent(event_wrapper.event);
+                    if (event_wrapper.event.operation == Operation::FlushNVS) {
+                        ret = ret && is_flushed;
+                    }
                     lock.lock();
 
                     if (event_wrapper.promise != nullptr) {
@@ -148,9 +181,17 @@ bool StorageNVS::setLocalParam(const Key &key, const Value &value, const void *s
 
     ESP_UTILS_LOGD(
         "Param: key(%s), value(%s), future(%p)", key.c_str(), std::holds_alternative<int>(value) ?
-        std::to_string(std::get<int>(value)).c_str() : std::get<std::string>(value).c_str(), future
+        std::to_string(std::get<int>(value)).c_str() : std::holds_alternative<std::string>(value) ?
+        std::get<std::string>(value).c_str() : "<blob>", future
     );
 
+    if (std::holds_alternative<Blob>(value)) {
+        auto &blob = std::get<Blob>(value);
+        ESP_UTILS_CHECK_VALUE_RETURN(
+            blob.size(), 1, NVS_VALUE_BLOB_MAX_LEN, false, "Invalid blob size(%d)", static_cast<int>(blob.size())
+        );
+    }
+
     {
         std::lock_guard<std::mutex> lock(_params_mutex);
         _local_params[key] = value;
@@ -194,6 +235,20 @@ bool StorageNVS::eraseNVS(const void *sender, EventFuture *future)
     return true;
 }
 
+bool StorageNVS::flushNVS(const void *sender, EventFuture *future)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    ESP_UTILS_LOGD("Param: future(%p)", future);
+
+    ESP_UTILS_CHECK_FALSE_RETURN(sendEvent({
+        .sender = sender,
+        .operation = Operation::FlushNVS,
+    }, future), false, "Send flush NVS event failed");
+
+    return true;
+}
+
 boost::signals2::connection StorageNVS::connectEventSignal(EventSignal::slot_type slot)
 {
     ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
@@ -212,7 +267,8 @@ bool StorageNVS::processEvent(const Event &event)
 
     switch (event.operation) {
     case Operation::UpdateNVS: {
-        ESP_UTILS_CHECK_FALSE_RETURN(doEventOperationUpdateNVS(event.key), false, "Update NVS failed");
+        _stats.update_count++;
+        ESP_UTILS_CHECK_FALSE_RETURN(doEventOperationUpdateNVS({event.key}), false, "Update NVS failed");
         break;
     }
     case Operation::UpdateParam: {
@@ -223,6 +279,9 @@ bool StorageNVS::processEvent(const Event &event)
         ESP_UTILS_CHECK_FALSE_RETURN(doEventOperationEraseNVS(), false, "Erase NVS failed");
         break;
     }
+    case Operation::FlushNVS:
+        // Pending updates are committed before any other event is processed, nothing left to do here
+        break;
     default:
         ESP_UTILS_CHECK_FALSE_RETURN(false, false, "Invalid operation(%d)", static_cast<int>(event.operation));
     }
@@ -232,19 +291,72 @@ bool StorageNVS::processEvent(const Event &event)
     return true;
 }
 
-bool StorageNVS::doEventOperationUpdateNVS(const Key &key)
+void StorageNVS::deferEvent(const EventWrapper &event_wrapper)
 {
     ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
 
-    ESP_UTILS_LOGD("Param: key(%s)", key.c_str());
+    auto &key = event_wrapper.event.key;
+    ESP_UTILS_LOGD("Defer update of key(%s)", key.c_str());
 
-    std::lock_guard<std::mutex> lock(_params_mutex);
+    _stats.update_count++;
+    if (_pending_updates.empty()) {
+        _pending_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(_write_behind_window_ms);
+    }
 
-    auto it = _local_params.find(key);
-    ESP_UTILS_CHECK_FALSE_RETURN(
-        it != _local_params.end(), false, "Invalid NVS key(%s)", key.c_str()
-    );
-    ESP_UTILS_LOGD("Update key(%s) NVS parameter", key.c_str());
+    auto it = _pending_updates.find(key);
+    if (it == _pending_updates.end()) {
+        it = _pending_updates.emplace(key, PendingUpdate{ .event = event_wrapper.event }).first;
+    } else {
+        // The value is read from the local parameters when committing, so only the latest sender is kept
+        _stats.coalesced_count++;
+        it->second.event = event_wrapper.event;
+    }
+    if (event_wrapper.promise != nullptr) {
+        it->second.promises.push_back(event_wrapper.promise);
+    }
+}
+
+bool StorageNVS::flushPendingUpdates()
+{
+    if (_pending_updates.empty()) {
+        return true;
+    }
+
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    std::map<Key, PendingUpdate> pending_updates;
+    pending_updates.swap(_pending_updates);
+
+    std::vector<Key> keys;
+    keys.reserve(pending_updates.size());
+    for (auto &[key, _] : pending_updates) {
+        keys.push_back(key);
+    }
+    ESP_UTILS_LOGD("Flush %d pending updates", static_cast<int>(keys.size()));
+
+    auto ret = doEventOperationUpdateNVS(keys);
+    if (!ret) {
+        ESP_UTILS_LOGE("Update NVS failed");
+    }
+    for (auto &[_, update] : pending_updates) {
+        if (ret) {
+            _event_signal(update.event);
+        }
+        for (auto &promise : update.promises) {
+            promise->set_value(ret);
+        }
+    }
+
+    return ret;
+}
+
+bool StorageNVS::doEventOperationUpdateNVS(const std::vector<Key> &keys)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    ESP_UTILS_LOGD("Param: keys(%d)", static_cast<int>(keys.size()));
+
+    std::lock_guard<std::mutex> lock(_params_mutex);
 
     nvs_handle_t nvs_handle;
     ESP_UTILS_CHECK_ERROR_RETURN(
@@ -255,30 +367,56 @@ bool StorageNVS::doEventOperationUpdateNVS(const Key &key)
         nvs_close(nvs_handle);
     });
 
-    auto &value = it->second;
-    const char *key_str = key.c_str();
-
-    if (std::holds_alternative<int>(value)) {
-        auto value_int = std::get<int>(value);
-        ESP_UTILS_LOGD("Set key(%s) value(%d)", key_str, value_int);
-
-        ESP_UTILS_CHECK_ERROR_RETURN(
-            nvs_set_i32(nvs_handle, key_str, static_cast<int32_t>(value_int)), false, "Set NVS parameter failed"
-        );
-    } else if (std::holds_alternative<std::string>(value)) {
-        auto value_str = std::get<std::string>(value);
-        ESP_UTILS_LOGD("Set key(%s) value(%s)", key_str, value_str.c_str());
-
-        ESP_UTILS_CHECK_ERROR_RETURN(
-            nvs_set_str(nvs_handle, key_str, value_str.c_str()), false, "Set NVS parameter failed"
-        );
-    } else {
-        ESP_UTILS_CHECK_FALSE_RETURN(false, false, "Invalid NVS key(%s) value type", key_str);
+    // Set all the keys and commit them at once, a bad key does not block the others
+    bool ret = true;
+    for (auto &key : keys) {
+        auto it = _local_params.find(key);
+        if (it == _local_params.end()) {
+            ESP_UTILS_LOGE("Invalid NVS key(%s)", key.c_str());
+            ret = false;
+            continue;
+        }
+        ESP_UTILS_LOGD("Update key(%s) NVS parameter", key.c_str());
+
+        auto &value = it->second;
+        const char *key_str = key.c_str();
+        esp_err_t err = ESP_OK;
+
+        if (std::holds_alternative<int>(value)) {
+            auto value_int = std::get<int>(value);
+            ESP_UTILS_LOGD("Set key(%s) value(%d)", key_str, value_int);
+
+            err = nvs_set_i32(nvs_handle, key_str, static_cast<int32_t>(value_int));
+        } else if (std::holds_alternative<std::string>(value)) {
+            auto &value_str = std::get<std::string>(value);
+            ESP_UTILS_LOGD("Set key(%s) value(%s)", key_str, value_str.c_str());
+
+            err = nvs_set_str(nvs_handle, key_str, value_str.c_str());
+        } else if (std::holds_alternative<Blob>(value)) {
+            auto &value_blob = std::get<Blob>(value);
+            ESP_UTILS_LOGD("Set key(%s) blob(%d bytes)", key_str, static_cast<int>(value_blob.size()));
+
+            uint32_t crc = calculate_blob_crc(value_blob.data(), value_blob.size());
+            Blob data(value_blob);
+            for (size_t i = 0; i < BLOB_CRC_SIZE; i++) {
+                data.push_back(static_cast<uint8_t>(crc >> (8 * i)));
+            }
+            err = nvs_set_blob(nvs_handle, key_str, data.data(), data.size());
+        } else {
+            ESP_UTILS_LOGE("Invalid NVS key(%s) value type", key_str);
+            ret = false;
+            continue;
+        }
+        if (err != ESP_OK) {
+            ESP_UTILS_LOGE("Set NVS key(%s) failed(%s)", key_str, esp_err_to_name(err));
+            ret = false;
+        }
     }
 
     ESP_UTILS_CHECK_ERROR_RETURN(nvs_commit(nvs_handle), false, "Commit NVS failed");
+    _stats.commit_count++;
 
-    return true;
+    return ret;
 }
 
 bool StorageNVS::doEventOperationUpdateParam()
@@ -344,6 +482,41 @@ bool StorageNVS::doEventOperationUpdateParam()
             }
             break;
         }
+        case NVS_TYPE_BLOB: {
+            size_t len = 0;
+            ret = nvs_get_blob(nvs_handle, info.key, nullptr, &len);
+            if (ret != ESP_OK) {
+                ESP_UTILS_LOGE("\t- Get key(%s) size failed", info.key);
+                break;
+            }
+            if ((len <= BLOB_CRC_SIZE) || (len > NVS_VALUE_BLOB_MAX_LEN + BLOB_CRC_SIZE)) {
+                ESP_UTILS_LOGE("\t- Invalid key(%s) blob size(%d)", info.key, static_cast<int>(len));
+                break;
+            }
+            Blob value_blob(len);
+            ret = nvs_get_blob(nvs_handle, info.key, value_blob.data(), &len);
+            if (ret != ESP_OK) {
+                ESP_UTILS_LOGE("\t- Get key(%s) value failed", info.key);
+                break;
+            }
+            uint32_t crc = 0;
+            for (size_t i = 0; i < BLOB_CRC_SIZE; i++) {
+                crc |= static_cast<uint32_t>(value_blob[len - BLOB_CRC_SIZE + i]) << (8 * i);
+            }
+            value_blob.resize(len - BLOB_CRC_SIZE);
+            if (crc != calculate_blob_crc(value_blob.data(), value_blob.size())) {
+                // Keep the stored data, the owner of the key falls back to its default value and overwrites it
+                _stats.crc_error_count++;
+                ESP_UTILS_LOGE("\t- Key(%s) blob CRC mismatch, skip it", info.key);
+                break;
+            }
+            ESP_UTILS_LOGI(
+                "\t- Found key(%s): type(%s), size(%d)", info.key, type_str_it->second,
+                static_cast<int>(value_blob.size())
+            );
+            _local_params[info.key] = Value(std::move(value_blob));
+            break;
+        }
         default:
             ESP_UTILS_LOGI("\t- Skip key(%s): type(%s)", info.key, type_str_it->second);
             break;
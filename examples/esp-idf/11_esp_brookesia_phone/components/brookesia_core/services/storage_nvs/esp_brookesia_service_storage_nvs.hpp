@@ -5,30 +5,45 @@
  */
 #pragma once
 
+#include <atomic>
 #include <bitset>
+#include <chrono>
+#include <cstring>
 #include <queue>
 #include <future>
+#include <type_traits>
 #include <variant>
 #include <string>
+#include <vector>
 #include "boost/thread.hpp"
 #include "boost/signals2.hpp"
 
 namespace esp_brookesia::services {
 
 constexpr size_t NVS_VALUE_STR_MAX_LEN = 128;
+constexpr size_t NVS_VALUE_BLOB_MAX_LEN = 1024;
 
 class StorageNVS {
 public:
     using Key = std::string;
-    using Value = std::variant<int, std::string>;
+    using Blob = std::vector<uint8_t>;
+    using Value = std::variant<int, std::string, Blob>;
 
     enum class Operation {
         UpdateNVS,
         UpdateParam,
         EraseNVS,
+        FlushNVS,
         Max,
     };
 
+    struct Stats {
+        uint32_t update_count;      // Number of `UpdateNVS` events processed
+        uint32_t coalesced_count;   // Number of updates merged into a later one of the same key
+        uint32_t commit_count;      // Number of `nvs_commit()` calls
+        uint32_t crc_error_count;   // Number of blobs dropped because of CRC mismatch when loading
+    };
+
     struct Event {
         void dump() const;
 
@@ -54,6 +69,63 @@ public:
     bool getLocalParam(const Key &key, Value &value);
     bool eraseNVS(const void *sender = nullptr, EventFuture *future = nullptr);
 
+    /**
+     * @brief Store a trivially copyable struct as a blob. The blob is saved with a CRC32 and dropped when loading if
+     *        the check fails.
+     */
+    template <typename T>
+    bool setLocalParamStruct(const Key &key, const T &data, const void *sender = nullptr, EventFuture *future = nullptr)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be stored as blob");
+        static_assert(sizeof(T) <= NVS_VALUE_BLOB_MAX_LEN, "Type is too large to be stored as blob");
+
+        auto bytes = reinterpret_cast<const uint8_t *>(&data);
+        return setLocalParam(key, Value(Blob(bytes, bytes + sizeof(T))), sender, future);
+    }
+    template <typename T>
+    bool getLocalParamStruct(const Key &key, T &data)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be stored as blob");
+
+        Value value;
+        if (!getLocalParam(key, value) || !std::holds_alternative<Blob>(value) ||
+                (std::get<Blob>(value).size() != sizeof(T))) {
+            return false;
+        }
+        std::memcpy(&data, std::get<Blob>(value).data(), sizeof(T));
+
+        return true;
+    }
+
+    /**
+     * @brief Enable the write-behind mode. Updates are kept in RAM and committed together once the first pending update
+     *        is older than `window_ms`, updates of the same key in between are merged. Set to 0 to write every update
+     *        immediately.
+     */
+    void setWriteBehindWindow(uint32_t window_ms)
+    {
+        _write_behind_window_ms = window_ms;
+    }
+    uint32_t getWriteBehindWindow() const
+    {
+        return _write_behind_window_ms;
+    }
+
+    /**
+     * @brief Commit all pending updates of the write-behind mode now
+     */
+    bool flushNVS(const void *sender = nullptr, EventFuture *future = nullptr);
+
+    Stats getStats() const
+    {
+        return {
+            .update_count = _stats.update_count,
+            .coalesced_count = _stats.coalesced_count,
+            .commit_count = _stats.commit_count,
+            .crc_error_count = _stats.crc_error_count,
+        };
+    }
+
     boost::signals2::connection connectEventSignal(EventSignal::slot_type slot);
 
     static StorageNVS &requestInstance()
@@ -69,16 +141,35 @@ private:
         std::shared_ptr<EventPromise> promise;
     };
 
-    StorageNVS() = default;
+    struct PendingUpdate {
+        Event event;
+        std::vector<std::shared_ptr<EventPromise>> promises;
+    };
+
+    StorageNVS();
 
     bool processEvent(const Event &event);
-    bool doEventOperationUpdateNVS(const Key &key);
+    void deferEvent(const EventWrapper &event_wrapper);
+    bool flushPendingUpdates();
+    bool doEventOperationUpdateNVS(const std::vector<Key> &keys);
     bool doEventOperationUpdateParam();
     bool doEventOperationEraseNVS();
 
     std::map<Key, Value> _local_params;
     std::mutex _params_mutex;
 
+    // Only accessed by the event thread
+    std::map<Key, PendingUpdate> _pending_updates;
+    std::chrono::steady_clock::time_point _pending_deadline;
+
+    std::atomic<uint32_t> _write_behind_window_ms = 0;
+    struct {
+        std::atomic<uint32_t> update_count;
+        std::atomic<uint32_t> coalesced_count;
+        std::atomic<uint32_t> commit_count;
+        std::atomic<uint32_t> crc_error_count;
+    } _stats = {};
+
     std::queue<EventWrapper> _event_queue;
     std::mutex _event_mutex;
     std::condition_variable _event_cv;
@@ -147,6 +147,72 @@
 #   endif
 #endif
 
+#if ESP_BROOKESIA_SYSTEMS_ENABLE_PHONE
+#   if !defined(ESP_BROOKESIA_PHONE_APP_LAUNCHER_REALIZED_PAGE_RANGE)
+#       if defined(CONFIG_ESP_BROOKESIA_PHONE_APP_LAUNCHER_REALIZED_PAGE_RANGE)
+#           define ESP_BROOKESIA_PHONE_APP_LAUNCHER_REALIZED_PAGE_RANGE  CONFIG_ESP_BROOKESIA_PHONE_APP_LAUNCHER_REALIZED_PAGE_RANGE
+#       else
+#           define ESP_BROOKESIA_PHONE_APP_LAUNCHER_REALIZED_PAGE_RANGE  (1)
+#       endif
+#   endif
+#   if !defined(ESP_BROOKESIA_PHONE_APP_LAUNCHER_ENABLE_ICON_IMAGE_CACHE)
+#       if defined(CONFIG_ESP_BROOKESIA_PHONE_APP_LAUNCHER_ENABLE_ICON_IMAGE_CACHE)
+#           define ESP_BROOKESIA_PHONE_APP_LAUNCHER_ENABLE_ICON_IMAGE_CACHE  CONFIG_ESP_BROOKESIA_PHONE_APP_LAUNCHER_ENABLE_ICON_IMAGE_CACHE
+#       else
+#           define ESP_BROOKESIA_PHONE_APP_LAUNCHER_ENABLE_ICON_IMAGE_CACHE  (0)
+#       endif
+#   endif
+#   if !defined(ESP_BROOKESIA_PHONE_APP_LAUNCHER_ICON_IMAGE_CACHE_IDLE_SIZE_KB)
+#       if defined(CONFIG_ESP_BROOKESIA_PHONE_APP_LAUNCHER_ICON_IMAGE_CACHE_IDLE_SIZE_KB)
+#           define ESP_BROOKESIA_PHONE_APP_LAUNCHER_ICON_IMAGE_CACHE_IDLE_SIZE_KB  CONFIG_ESP_BROOKESIA_PHONE_APP_LAUNCHER_ICON_IMAGE_CACHE_IDLE_SIZE_KB
+#       else
+#           define ESP_BROOKESIA_PHONE_APP_LAUNCHER_ICON_IMAGE_CACHE_IDLE_SIZE_KB  (0)
+#       endif
+#   endif
+#   if !defined(ESP_BROOKESIA_PHONE_RECENTS_SCREEN_SNAPSHOT_POOL_SIZE)
+#       if defined(CONFIG_ESP_BROOKESIA_PHONE_RECENTS_SCREEN_SNAPSHOT_POOL_SIZE)
+#           define ESP_BROOKESIA_PHONE_RECENTS_SCREEN_SNAPSHOT_POOL_SIZE  CONFIG_ESP_BROOKESIA_PHONE_RECENTS_SCREEN_SNAPSHOT_POOL_SIZE
+#       else
+#           define ESP_BROOKESIA_PHONE_RECENTS_SCREEN_SNAPSHOT_POOL_SIZE  (0)
+#       endif
+#   endif
+#   if !defined(ESP_BROOKESIA_PHONE_RECENTS_SCREEN_ENABLE_SNAPSHOT_IMAGE_CACHE)
+#       if defined(CONFIG_ESP_BROOKESIA_PHONE_RECENTS_SCREEN_ENABLE_SNAPSHOT_IMAGE_CACHE)
+#           define ESP_BROOKESIA_PHONE_RECENTS_SCREEN_ENABLE_SNAPSHOT_IMAGE_CACHE  CONFIG_ESP_BROOKESIA_PHONE_RECENTS_SCREEN_ENABLE_SNAPSHOT_IMAGE_CACHE
+#       else
+#           define ESP_BROOKESIA_PHONE_RECENTS_SCREEN_ENABLE_SNAPSHOT_IMAGE_CACHE  (0)
+#       endif
+#   endif
+#   if !defined(ESP_BROOKESIA_PHONE_RECENTS_SCREEN_SNAPSHOT_MOVE_BACK_DURATION_MS)
+#       if defined(CONFIG_ESP_BROOKESIA_PHONE_RECENTS_SCREEN_SNAPSHOT_MOVE_BACK_DURATION_MS)
+#           define ESP_BROOKESIA_PHONE_RECENTS_SCREEN_SNAPSHOT_MOVE_BACK_DURATION_MS  CONFIG_ESP_BROOKESIA_PHONE_RECENTS_SCREEN_SNAPSHOT_MOVE_BACK_DURATION_MS
+#       else
+#           define ESP_BROOKESIA_PHONE_RECENTS_SCREEN_SNAPSHOT_MOVE_BACK_DURATION_MS  (0)
+#       endif
+#   endif
+#   if !defined(ESP_BROOKESIA_PHONE_STATUS_BAR_BATTERY_HYSTERESIS_PERCENT)
+#       if defined(CONFIG_ESP_BROOKESIA_PHONE_STATUS_BAR_BATTERY_HYSTERESIS_PERCENT)
+#           define ESP_BROOKESIA_PHONE_STATUS_BAR_BATTERY_HYSTERESIS_PERCENT  CONFIG_ESP_BROOKESIA_PHONE_STATUS_BAR_BATTERY_HYSTERESIS_PERCENT
+#       else
+#           define ESP_BROOKESIA_PHONE_STATUS_BAR_BATTERY_HYSTERESIS_PERCENT  (0)
+#       endif
+#   endif
+#   if !defined(ESP_BROOKESIA_PHONE_STATUS_BAR_WIFI_UPDATE_INTERVAL_MS)
+#       if defined(CONFIG_ESP_BROOKESIA_PHONE_STATUS_BAR_WIFI_UPDATE_INTERVAL_MS)
+#           define ESP_BROOKESIA_PHONE_STATUS_BAR_WIFI_UPDATE_INTERVAL_MS  CONFIG_ESP_BROOKESIA_PHONE_STATUS_BAR_WIFI_UPDATE_INTERVAL_MS
+#       else
+#           define ESP_BROOKESIA_PHONE_STATUS_BAR_WIFI_UPDATE_INTERVAL_MS  (0)
+#       endif
+#   endif
+#   if !defined(ESP_BROOKESIA_PHONE_STATUS_BAR_ICON_POOL_SIZE)
+#       if defined(CONFIG_ESP_BROOKESIA_PHONE_STATUS_BAR_ICON_POOL_SIZE)
+#           define ESP_BROOKESIA_PHONE_STATUS_BAR_ICON_POOL_SIZE  CONFIG_ESP_BROOKESIA_PHONE_STATUS_BAR_ICON_POOL_SIZE
+#       else
+#           define ESP_BROOKESIA_PHONE_STATUS_BAR_ICON_POOL_SIZE  (0)
+#       endif
+#   endif
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////// Speaker //////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -173,6 +239,55 @@
 #           error "`ESP_BROOKESIA_SPEAKER_FS_MOUNT_POINT` is not set"
 #       endif
 #   endif
+#   if !defined(ESP_BROOKESIA_SPEAKER_AI_BUDDY_PRELOAD_AUDIO)
+#       if defined(CONFIG_ESP_BROOKESIA_SPEAKER_AI_BUDDY_PRELOAD_AUDIO)
+#           define ESP_BROOKESIA_SPEAKER_AI_BUDDY_PRELOAD_AUDIO  CONFIG_ESP_BROOKESIA_SPEAKER_AI_BUDDY_PRELOAD_AUDIO
+#       else
+#           define ESP_BROOKESIA_SPEAKER_AI_BUDDY_PRELOAD_AUDIO  (0)
+#       endif
+#   endif
+#   if !defined(ESP_BROOKESIA_SPEAKER_KEYBOARD_ENABLE_LAYER_CACHE)
+#       if defined(CONFIG_ESP_BROOKESIA_SPEAKER_KEYBOARD_ENABLE_LAYER_CACHE)
+#           define ESP_BROOKESIA_SPEAKER_KEYBOARD_ENABLE_LAYER_CACHE  CONFIG_ESP_BROOKESIA_SPEAKER_KEYBOARD_ENABLE_LAYER_CACHE
+#       else
+#           define ESP_BROOKESIA_SPEAKER_KEYBOARD_ENABLE_LAYER_CACHE  (0)
+#       endif
+#   endif
+#   if !defined(ESP_BROOKESIA_SPEAKER_KEYBOARD_LAYER_CACHE_NUM)
+#       if defined(CONFIG_ESP_BROOKESIA_SPEAKER_KEYBOARD_LAYER_CACHE_NUM)
+#           define ESP_BROOKESIA_SPEAKER_KEYBOARD_LAYER_CACHE_NUM  CONFIG_ESP_BROOKESIA_SPEAKER_KEYBOARD_LAYER_CACHE_NUM
+#       else
+#           define ESP_BROOKESIA_SPEAKER_KEYBOARD_LAYER_CACHE_NUM  (4)
+#       endif
+#   endif
+#   if !defined(ESP_BROOKESIA_SPEAKER_KEYBOARD_ENABLE_PREDICTION)
+#       if defined(CONFIG_ESP_BROOKESIA_SPEAKER_KEYBOARD_ENABLE_PREDICTION)
+#           define ESP_BROOKESIA_SPEAKER_KEYBOARD_ENABLE_PREDICTION  CONFIG_ESP_BROOKESIA_SPEAKER_KEYBOARD_ENABLE_PREDICTION
+#       else
+#           define ESP_BROOKESIA_SPEAKER_KEYBOARD_ENABLE_PREDICTION  (0)
+#       endif
+#   endif
+#   if !defined(ESP_BROOKESIA_SPEAKER_KEYBOARD_DICTIONARY_PATH)
+#       if defined(CONFIG_ESP_BROOKESIA_SPEAKER_KEYBOARD_DICTIONARY_PATH)
+#           define ESP_BROOKESIA_SPEAKER_KEYBOARD_DICTIONARY_PATH  CONFIG_ESP_BROOKESIA_SPEAKER_KEYBOARD_DICTIONARY_PATH
+#       else
+#           define ESP_BROOKESIA_SPEAKER_KEYBOARD_DICTIONARY_PATH  ""
+#       endif
+#   endif
+#   if !defined(ESP_BROOKESIA_SPEAKER_KEYBOARD_PREDICTION_NUM)
+#       if defined(CONFIG_ESP_BROOKESIA_SPEAKER_KEYBOARD_PREDICTION_NUM)
+#           define ESP_BROOKESIA_SPEAKER_KEYBOARD_PREDICTION_NUM  CONFIG_ESP_BROOKESIA_SPEAKER_KEYBOARD_PREDICTION_NUM
+#       else
+#           define ESP_BROOKESIA_SPEAKER_KEYBOARD_PREDICTION_NUM  (3)
+#       endif
+#   endif
+#   if !defined(ESP_BROOKESIA_SPEAKER_KEYBOARD_PREDICTION_BUDGET_US)
+#       if defined(CONFIG_ESP_BROOKESIA_SPEAKER_KEYBOARD_PREDICTION_BUDGET_US)
+#           define ESP_BROOKESIA_SPEAKER_KEYBOARD_PREDICTION_BUDGET_US  CONFIG_ESP_BROOKESIA_SPEAKER_KEYBOARD_PREDICTION_BUDGET_US
+#       else
+#           define ESP_BROOKESIA_SPEAKER_KEYBOARD_PREDICTION_BUDGET_US  (1000)
+#       endif
+#   endif
 #endif
 
 #if ESP_BROOKESIA_SPEAKER_ENABLE_DEBUG_LOG
@@ -1132,7 +1132,12 @@ process:
     }
 
     if (state & RECENTS_SCREEN_SNAPSHOT_MOVE_BACK) {
-        recents_screen->moveSnapshotY(target_app_id, recents_screen->getSnapshotOriginY(target_app_id));
+        // The move is only seen if the recents screen stays
+        if (state & (RECENTS_SCREEN_HIDE | RECENTS_SCREEN_APP_CLOSE)) {
+            recents_screen->moveSnapshotY(target_app_id, recents_screen->getSnapshotOriginY(target_app_id));
+        } else {
+            recents_screen->animateSnapshotY(target_app_id, recents_screen->getSnapshotOriginY(target_app_id));
+        }
         ESP_UTILS_LOGD("Recents screen move snapshot back");
     }
 
@@ -3,6 +3,8 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <algorithm>
+#include <cstdlib>
 #include <limits>
 #include <memory>
 #if __has_include("src/misc/lv_area.h")
@@ -34,9 +36,12 @@ AppLauncher::AppLauncher(base::Context &core, const AppLauncherData &data):
     _table_page_icon_count_max(0),
     _table_page_pad_row(0),
     _table_page_pad_column(0),
+    _icon_order(0),
     _main_obj(nullptr),
     _table_obj(nullptr),
-    _indicator_obj(nullptr)
+    _indicator_obj(nullptr),
+    _icon_pool_obj(nullptr),
+    _icon_image_cache(ESP_BROOKESIA_PHONE_APP_LAUNCHER_ICON_IMAGE_CACHE_IDLE_SIZE_KB * 1024)
 {
 }
 
@@ -53,6 +58,7 @@ bool AppLauncher::begin(lv_obj_t *parent)
     gui::LvObjSharedPtr main_obj = nullptr;
     gui::LvObjSharedPtr table_obj = nullptr;
     gui::LvObjSharedPtr indicator_obj = nullptr;
+    gui::LvObjSharedPtr icon_pool_obj = nullptr;
     vector <MixObject> mix_objs;
 
     ESP_UTILS_LOGD("Begin(0x%p)", this);
@@ -69,6 +75,9 @@ bool AppLauncher::begin(lv_obj_t *parent)
     // Spot
     indicator_obj = ESP_BROOKESIA_LV_OBJ(obj, main_obj.get());
     ESP_UTILS_CHECK_NULL_RETURN(indicator_obj, false, "Create indicator_obj failed");
+    // Icon pool
+    icon_pool_obj = ESP_BROOKESIA_LV_OBJ(obj, main_obj.get());
+    ESP_UTILS_CHECK_NULL_RETURN(icon_pool_obj, false, "Create icon_pool_obj failed");
     // Mix objects
     for (int i = 0; i < _data.table.default_num; i++) {
         ESP_UTILS_CHECK_FALSE_RETURN(createMixObject(table_obj, indicator_obj, mix_objs), false,
@@ -91,6 +100,9 @@ bool AppLauncher::begin(lv_obj_t *parent)
     lv_obj_add_style(indicator_obj.get(), _system_context.getDisplay().getCoreContainerStyle(), 0);
     lv_obj_set_flex_flow(indicator_obj.get(), LV_FLEX_FLOW_ROW);
     lv_obj_set_flex_align(indicator_obj.get(), LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    // Icon pool, the recycled icons are hidden in it
+    lv_obj_add_style(icon_pool_obj.get(), _system_context.getDisplay().getCoreContainerStyle(), 0);
+    lv_obj_add_flag(icon_pool_obj.get(), LV_OBJ_FLAG_HIDDEN);
     // Event
     ESP_UTILS_CHECK_FALSE_RETURN(_system_context.registerDateUpdateEventCallback(onDataUpdateEventCallback, this), false,
                                  "Register data update event callback failed");
@@ -99,6 +111,7 @@ bool AppLauncher::begin(lv_obj_t *parent)
     _main_obj = main_obj;
     _table_obj = table_obj;
     _indicator_obj = indicator_obj;
+    _icon_pool_obj = icon_pool_obj;
     _mix_objs = mix_objs;
 
     /* Update */
@@ -131,11 +144,15 @@ bool AppLauncher::del(void)
         ret = false;
     }
 
+    // The icons must release their images before the cache is cleared
+    _id_mix_icon_map.clear();
+    _icon_pool.clear();
     _main_obj.reset();
     _table_obj.reset();
     _indicator_obj.reset();
+    _icon_pool_obj.reset();
     _mix_objs.clear();
-    _id_mix_icon_map.clear();
+    _icon_image_cache.clear();
 
     return ret;
 }
@@ -170,12 +187,14 @@ bool AppLauncher::addIcon(uint8_t page_index, const AppLauncherIcon::Info &info)
         }
     }
     mix_icon.current_page_index = page_index;
+    mix_icon.order = _icon_order++;
+    mix_icon.info = info;
 
-    mix_icon.icon = make_shared<AppLauncherIcon>(_system_context, info, _data.icon);
-    ESP_UTILS_CHECK_NULL_RETURN(mix_icon.icon, false, "Create icon failed");
-
-    ESP_UTILS_CHECK_FALSE_RETURN(mix_icon.icon->begin(_mix_objs[page_index].page_obj.get()), false,
-                                 "Begin icon failed");
+    // Only the realized pages have icon objects
+    if (_mix_objs[page_index].is_realized) {
+        mix_icon.icon = acquireIcon(page_index, info);
+        ESP_UTILS_CHECK_NULL_RETURN(mix_icon.icon, false, "Acquire icon failed");
+    }
 
     auto res = _id_mix_icon_map.insert(pair<int, MixIcon>(info.id, mix_icon));
     ESP_UTILS_CHECK_FALSE_RETURN(res.second, false, "Insert icon failed");
@@ -194,15 +213,30 @@ bool AppLauncher::removeIcon(int id)
 
     auto res = _id_mix_icon_map.find(id);
     ESP_UTILS_CHECK_FALSE_RETURN(res != _id_mix_icon_map.end(), false, "Icon not found");
-    ESP_UTILS_CHECK_NULL_RETURN(res->second.icon, false, "Invalid icon");
     current_page_index = res->second.current_page_index;
     ESP_UTILS_CHECK_VALUE_RETURN(current_page_index, 0, (int)_mix_objs.size() - 1, false, "Table index out of range");
 
+    if (res->second.icon != nullptr) {
+        ESP_UTILS_CHECK_FALSE_RETURN(releaseIcon(res->second.icon), false, "Release icon failed");
+    }
     _mix_objs[current_page_index].page_icon_count--;
     _id_mix_icon_map.erase(id);
 
     if ((_mix_objs[current_page_index].page_icon_count == 0) && (_mix_objs.size() > _data.table.default_num)) {
         ESP_UTILS_CHECK_FALSE_RETURN(destoryMixObject(current_page_index, _mix_objs), false, "Destroy mix object failed");
+        // The following pages move down by one
+        for (auto &id_icon : _id_mix_icon_map) {
+            if (id_icon.second.current_page_index > current_page_index) {
+                id_icon.second.current_page_index--;
+            }
+            if (id_icon.second.target_page_index > current_page_index) {
+                id_icon.second.target_page_index--;
+            }
+        }
+        if (_table_current_page_index > current_page_index) {
+            _table_current_page_index--;
+        }
+        ESP_UTILS_CHECK_FALSE_RETURN(updateRealizedPages(), false, "Update realized pages failed");
     }
 
     return true;
@@ -211,16 +245,30 @@ bool AppLauncher::removeIcon(int id)
 bool AppLauncher::changeIconTable(int id, uint8_t new_table_index)
 {
     ESP_UTILS_LOGD("Change icon(%d) table to %d", id, new_table_index);
-    ESP_UTILS_CHECK_VALUE_RETURN(new_table_index, 0, (int)_mix_objs.size(), false, "Table index out of range");
+    ESP_UTILS_CHECK_VALUE_RETURN(new_table_index, 0, (int)_mix_objs.size() - 1, false, "Table index out of range");
     ESP_UTILS_CHECK_FALSE_RETURN(checkInitialized(), false, "Not initialized");
 
     auto res = _id_mix_icon_map.find(id);
     ESP_UTILS_CHECK_FALSE_RETURN(res != _id_mix_icon_map.end(), false, "Icon not found");
-    ESP_UTILS_CHECK_NULL_RETURN(res->second.icon, false, "Invalid icon");
 
-    ESP_UTILS_CHECK_FALSE_RETURN(res->second.icon->del(), false, "Delete icon failed");
-    ESP_UTILS_CHECK_FALSE_RETURN(res->second.icon->begin(_mix_objs[new_table_index].page_obj.get()), false,
-                                 "Begin icon failed");
+    // The icon is placed after the others of the new page
+    MixIcon &mix_icon = res->second;
+    mix_icon.order = _icon_order++;
+    if (!_mix_objs[new_table_index].is_realized) {
+        if (mix_icon.icon != nullptr) {
+            ESP_UTILS_CHECK_FALSE_RETURN(releaseIcon(mix_icon.icon), false, "Release icon failed");
+        }
+    } else if (mix_icon.icon == nullptr) {
+        mix_icon.icon = acquireIcon(new_table_index, mix_icon.info);
+        ESP_UTILS_CHECK_NULL_RETURN(mix_icon.icon, false, "Acquire icon failed");
+    } else {
+        ESP_UTILS_CHECK_FALSE_RETURN(mix_icon.icon->setParent(_mix_objs[new_table_index].page_obj.get()), false,
+                                     "Move icon failed");
+        ESP_UTILS_CHECK_FALSE_RETURN(
+            mix_icon.icon->toggleClickable(_mix_objs[new_table_index].is_icon_clickable), false,
+            "Toggle icon clickable failed"
+        );
+    }
 
     if (res->second.current_page_index < (int)_mix_objs.size()) {
         _mix_objs[res->second.current_page_index].page_icon_count--;
@@ -248,6 +296,7 @@ bool AppLauncher::scrollToPage(uint8_t index)
 
     _table_current_page_index = index;
 
+    ESP_UTILS_CHECK_FALSE_RETURN(updateRealizedPages(), false, "Update realized pages failed");
     ESP_UTILS_CHECK_FALSE_RETURN(updateActiveSpot(), false, "Update active spot failed");
 
     return true;
@@ -411,7 +460,7 @@ bool AppLauncher::createMixObject(gui::LvObjSharedPtr &table_obj, gui::LvObjShar
     lv_obj_add_style(spot_obj.get(), _system_context.getDisplay().getCoreContainerStyle(), 0);
     lv_obj_set_style_radius(spot_obj.get(), LV_RADIUS_CIRCLE, 0);
 
-    mix_objs.push_back({0, page_main_obj, page_obj, spot_obj});
+    mix_objs.push_back({0, page_main_obj, page_obj, spot_obj, false, true});
 
     return true;
 }
@@ -458,13 +507,125 @@ bool AppLauncher::updateMixByNewData(uint8_t index, vector<MixObject> &mix_objs)
     return true;
 }
 
+shared_ptr<AppLauncherIcon> AppLauncher::acquireIcon(uint8_t page_index, const AppLauncherIcon::Info &info)
+{
+    shared_ptr<AppLauncherIcon> icon = nullptr;
+    lv_obj_t *page_obj = _mix_objs[page_index].page_obj.get();
+
+    ESP_UTILS_LOGD("Acquire icon(%d) for page(%d), pool: %d", info.id, page_index, (int)_icon_pool.size());
+
+    if (!_icon_pool.empty()) {
+        icon = _icon_pool.back();
+        _icon_pool.pop_back();
+        ESP_UTILS_CHECK_FALSE_RETURN(icon->bind(info), nullptr, "Bind icon failed");
+        ESP_UTILS_CHECK_FALSE_RETURN(icon->setParent(page_obj), nullptr, "Move icon failed");
+    } else {
+        icon = make_shared<AppLauncherIcon>(
+                   _system_context, info, _data.icon,
+                   ESP_BROOKESIA_PHONE_APP_LAUNCHER_ENABLE_ICON_IMAGE_CACHE ? &_icon_image_cache : nullptr
+               );
+        ESP_UTILS_CHECK_NULL_RETURN(icon, nullptr, "Create icon failed");
+        ESP_UTILS_CHECK_FALSE_RETURN(icon->begin(page_obj), nullptr, "Begin icon failed");
+    }
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        icon->toggleClickable(_mix_objs[page_index].is_icon_clickable), nullptr, "Toggle icon clickable failed"
+    );
+
+    return icon;
+}
+
+bool AppLauncher::releaseIcon(shared_ptr<AppLauncherIcon> &icon)
+{
+    ESP_UTILS_CHECK_NULL_RETURN(icon, false, "Invalid icon");
+    ESP_UTILS_LOGD("Release icon(%d), pool: %d", icon->getInfo().id, (int)_icon_pool.size());
+
+    // One page of spare icons is enough to scroll page by page, the others are deleted
+    if (_icon_pool.size() < _table_page_icon_count_max) {
+        ESP_UTILS_CHECK_FALSE_RETURN(icon->setParent(_icon_pool_obj.get()), false, "Move icon failed");
+        _icon_pool.push_back(icon);
+    }
+    icon.reset();
+
+    return true;
+}
+
+bool AppLauncher::realizePage(uint8_t index)
+{
+    vector<MixIcon *> mix_icons;
+
+    ESP_UTILS_LOGD("Realize page(%d)", index);
+    ESP_UTILS_CHECK_VALUE_RETURN(index, 0, (int)_mix_objs.size() - 1, false, "Table page index out of range");
+
+    if (_mix_objs[index].is_realized) {
+        return true;
+    }
+
+    for (auto &id_icon : _id_mix_icon_map) {
+        if (id_icon.second.current_page_index == index) {
+            mix_icons.push_back(&id_icon.second);
+        }
+    }
+    sort(mix_icons.begin(), mix_icons.end(), [](const MixIcon * a, const MixIcon * b) {
+        return a->order < b->order;
+    });
+    for (auto mix_icon : mix_icons) {
+        mix_icon->icon = acquireIcon(index, mix_icon->info);
+        ESP_UTILS_CHECK_NULL_RETURN(mix_icon->icon, false, "Acquire icon(%d) failed", mix_icon->info.id);
+    }
+    _mix_objs[index].is_realized = true;
+
+    return true;
+}
+
+bool AppLauncher::virtualizePage(uint8_t index)
+{
+    ESP_UTILS_LOGD("Virtualize page(%d)", index);
+    ESP_UTILS_CHECK_VALUE_RETURN(index, 0, (int)_mix_objs.size() - 1, false, "Table page index out of range");
+
+    for (auto &id_icon : _id_mix_icon_map) {
+        if ((id_icon.second.current_page_index == index) && (id_icon.second.icon != nullptr)) {
+            ESP_UTILS_CHECK_FALSE_RETURN(releaseIcon(id_icon.second.icon), false, "Release icon failed");
+        }
+    }
+    _mix_objs[index].is_realized = false;
+
+    return true;
+}
+
+bool AppLauncher::updateRealizedPages(void)
+{
+    ESP_UTILS_LOGD("Update realized pages around page(%d)", _table_current_page_index);
+
+    if (_table_current_page_index < 0) {
+        return true;
+    }
+
+    // Virtualize first, so the released icons are reused by the realized pages
+    for (size_t i = 0; i < _mix_objs.size(); i++) {
+        if (_mix_objs[i].is_realized &&
+                (abs((int)i - _table_current_page_index) > ESP_BROOKESIA_PHONE_APP_LAUNCHER_REALIZED_PAGE_RANGE)) {
+            ESP_UTILS_CHECK_FALSE_RETURN(virtualizePage(i), false, "Virtualize page(%d) failed", (int)i);
+        }
+    }
+    for (size_t i = 0; i < _mix_objs.size(); i++) {
+        if (!_mix_objs[i].is_realized &&
+                (abs((int)i - _table_current_page_index) <= ESP_BROOKESIA_PHONE_APP_LAUNCHER_REALIZED_PAGE_RANGE)) {
+            ESP_UTILS_CHECK_FALSE_RETURN(realizePage(i), false, "Realize page(%d) failed", (int)i);
+        }
+    }
+
+    return true;
+}
+
 bool AppLauncher::togglePageIconClickable(uint8_t page_index, bool clickable)
 {
     ESP_UTILS_LOGD("Toggle page(%d) icon %s", page_index, clickable ? "clickable" : "unclickable");
     ESP_UTILS_CHECK_VALUE_RETURN(page_index, 0, (int)_mix_objs.size() - 1, false, "Table page index out of range");
 
+    // Also applied to the icons when the page is realized
+    _mix_objs[page_index].is_icon_clickable = clickable;
     for (auto &icon : _id_mix_icon_map) {
-        if (icon.second.current_page_index == page_index) {
+        if ((icon.second.current_page_index == page_index) && (icon.second.icon != nullptr)) {
             ESP_UTILS_CHECK_FALSE_RETURN(
                 icon.second.icon->toggleClickable(clickable), false, "Toggle icon clickable failed"
             );
@@ -621,8 +782,12 @@ bool AppLauncher::updateByNewData(void)
             }
         }
 next:
-        ESP_UTILS_CHECK_FALSE_RETURN(id_icon.second.icon->updateByNewData(), false, "Update icon style failed");
+        if (id_icon.second.icon != nullptr) {
+            ESP_UTILS_CHECK_FALSE_RETURN(id_icon.second.icon->updateByNewData(), false, "Update icon style failed");
+        }
     }
+    // The pooled icons are updated when they are bound again
+    ESP_UTILS_CHECK_FALSE_RETURN(updateRealizedPages(), false, "Update realized pages failed");
 
     return true;
 }
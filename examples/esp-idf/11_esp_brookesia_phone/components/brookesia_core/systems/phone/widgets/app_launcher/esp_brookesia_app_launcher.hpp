@@ -70,17 +70,26 @@ private:
         gui::LvObjSharedPtr page_main_obj;
         gui::LvObjSharedPtr page_obj;
         gui::LvObjSharedPtr spot_obj;
+        bool is_realized;           // Whether the icons of the page have objects
+        bool is_icon_clickable;
     };
     struct MixIcon {
         uint8_t current_page_index;
         uint8_t target_page_index;
-        std::shared_ptr<AppLauncherIcon> icon;
+        uint32_t order;             // The icons of a page are placed in this order
+        AppLauncherIcon::Info info;
+        std::shared_ptr<AppLauncherIcon> icon;  // `nullptr` if the page is not realized
     };
 
     bool createMixObject(gui::LvObjSharedPtr &table_obj, gui::LvObjSharedPtr &indicator_obj,
                          std::vector<MixObject> &mix_objs);
     bool destoryMixObject(uint8_t index, std::vector<MixObject> &mix_objs);
     bool updateMixByNewData(uint8_t index, std::vector<MixObject> &mix_objs);
+    std::shared_ptr<AppLauncherIcon> acquireIcon(uint8_t page_index, const AppLauncherIcon::Info &info);
+    bool releaseIcon(std::shared_ptr<AppLauncherIcon> &icon);
+    bool realizePage(uint8_t index);
+    bool virtualizePage(uint8_t index);
+    bool updateRealizedPages(void);
     bool togglePageIconClickable(uint8_t page_index, bool clickable);
     bool toggleCurrentPageIconClickable(bool clickable);
     bool updateActiveSpot(void);
@@ -97,11 +106,16 @@ private:
     uint8_t _table_page_icon_count_max;
     int _table_page_pad_row;
     int _table_page_pad_column;
+    uint32_t _icon_order;
     gui::LvObjSharedPtr _main_obj;
     gui::LvObjSharedPtr _table_obj;
     gui::LvObjSharedPtr _indicator_obj;
+    gui::LvObjSharedPtr _icon_pool_obj;
+    AppLauncherIconImageCache _icon_image_cache;
     std::vector <MixObject> _mix_objs;
     std::map <int, MixIcon> _id_mix_icon_map;
+    // Icons of the virtualized pages, kept to be reused by the pages which are realized
+    std::vector<std::shared_ptr<AppLauncherIcon>> _icon_pool;
 };
 
 } // namespace esp_brookesia::systems::phone
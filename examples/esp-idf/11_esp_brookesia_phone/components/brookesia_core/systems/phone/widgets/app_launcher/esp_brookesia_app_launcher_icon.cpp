@@ -3,6 +3,7 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <algorithm>
 #include "esp_brookesia_systems_internal.h"
 #if !ESP_BROOKESIA_PHONE_APP_LAUNCHER_ENABLE_DEBUG_LOG
 #   define ESP_BROOKESIA_UTILS_DISABLE_DEBUG_LOG
@@ -15,13 +16,17 @@ using namespace esp_brookesia::gui;
 
 namespace esp_brookesia::systems::phone {
 
-AppLauncherIcon::AppLauncherIcon(base::Context &core, const Info &info, const Data &data):
+AppLauncherIcon::AppLauncherIcon(
+    base::Context &core, const Info &info, const Data &data, AppLauncherIconImageCache *image_cache
+):
     _system_context(core),
     _info(info),
     _data(data),
+    _image_cache(image_cache),
     _flags{},
     _image_default_zoom(LV_SCALE_NONE),
     _image_press_zoom(LV_SCALE_NONE),
+    _cached_image(nullptr),
     _main_obj(nullptr),
     _icon_main_obj(nullptr),
     _icon_image_obj(nullptr),
@@ -78,7 +83,7 @@ bool AppLauncherIcon::begin(lv_obj_t *parent)
     // Image
     lv_obj_add_style(icon_image_obj.get(), _system_context.getDisplay().getCoreContainerStyle(), 0);
     lv_obj_center(icon_image_obj.get());
-    lv_img_set_src(icon_image_obj.get(), _info.image.resource);
+    // The source is set by `updateImage()`
     lv_obj_set_style_img_recolor(icon_image_obj.get(), lv_color_hex(_info.image.recolor.color), 0);
     lv_obj_set_style_img_recolor_opa(icon_image_obj.get(), _info.image.recolor.opacity, 0);
     // lv_obj_set_size(icon_image_obj.get(), LV_SIZE_CONTENT, LV_SIZE_CONTENT);
@@ -122,6 +127,8 @@ bool AppLauncherIcon::del(void)
     _icon_main_obj.reset();
     _icon_image_obj.reset();
     _name_label.reset();
+    // The image object is deleted, so the cached image is no longer used
+    releaseImage();
 
     return true;
 }
@@ -141,11 +148,40 @@ bool AppLauncherIcon::toggleClickable(bool clickable)
     return true;
 }
 
-bool AppLauncherIcon::updateByNewData(void)
+bool AppLauncherIcon::bind(const Info &info)
 {
-    float h_factor = 0;
-    float w_factor = 0;
+    ESP_UTILS_LOGD("Bind(%d->%d: @0x%p)", _info.id, info.id, this);
+    ESP_UTILS_CHECK_NULL_RETURN(info.name, false, "Invalid name");
+    ESP_UTILS_CHECK_NULL_RETURN(info.image.resource, false, "Invalid image resource");
+
+    _info = info;
+    if (!checkInitialized()) {
+        return true;
+    }
+
+    lv_obj_set_style_img_recolor(_icon_image_obj.get(), lv_color_hex(_info.image.recolor.color), 0);
+    lv_obj_set_style_img_recolor_opa(_icon_image_obj.get(), _info.image.recolor.opacity, 0);
+    lv_label_set_text_static(_name_label.get(), _info.name);
+    _flags.is_pressed_losted = false;
+    ESP_UTILS_CHECK_FALSE_RETURN(updateByNewData(), false, "Update object style failed");
+
+    return true;
+}
+
+bool AppLauncherIcon::setParent(lv_obj_t *parent)
+{
+    ESP_UTILS_LOGD("Set parent(%d: @0x%p)", _info.id, this);
+    ESP_UTILS_CHECK_NULL_RETURN(parent, false, "Invalid parent object");
+    ESP_UTILS_CHECK_FALSE_RETURN(checkInitialized(), false, "Icon is not initialized");
+
+    // The icon is moved to the end of the children of the new parent
+    lv_obj_set_parent(_main_obj.get(), parent);
+
+    return true;
+}
 
+bool AppLauncherIcon::updateByNewData(void)
+{
     ESP_UTILS_LOGD("Update(%d: @0x%p)", _info.id, this);
     ESP_UTILS_CHECK_FALSE_RETURN(checkInitialized(), false, "Icon is not initialized");
 
@@ -159,34 +195,54 @@ bool AppLauncherIcon::updateByNewData(void)
     lv_obj_set_style_text_color(_name_label.get(), lv_color_hex(_data.label.text_color.color), 0);
     lv_obj_set_style_text_opa(_name_label.get(), _data.label.text_color.opacity, 0);
     // Image
-    // Calculate the multiple of the size between the target and the image.
-    h_factor = (float)(_data.image.default_size.width) / ((lv_img_dsc_t *)_info.image.resource)->header.h;
-    w_factor = (float)(_data.image.default_size.height) / ((lv_img_dsc_t *)_info.image.resource)->header.w;
-    // Scale the image to a suitable size.
-    // So you don’t have to consider the size of the source image.
-    if (h_factor < w_factor) {
-        _image_default_zoom = (int)(h_factor * LV_SCALE_NONE);
-        lv_image_set_scale(_icon_image_obj.get(), _image_default_zoom);
-    } else {
-        _image_default_zoom = (int)(w_factor * LV_SCALE_NONE);
-        lv_image_set_scale(_icon_image_obj.get(), _image_default_zoom);
-    }
+    ESP_UTILS_CHECK_FALSE_RETURN(updateImage(), false, "Update image failed");
     lv_obj_set_size(_icon_image_obj.get(), _data.image.default_size.width, _data.image.default_size.height);
     lv_obj_refr_size(_icon_image_obj.get());
-    // Calculate the multiple of the size between the target and the image.
-    h_factor = (float)(_data.image.press_size.width) / ((lv_img_dsc_t *)_info.image.resource)->header.h;
-    w_factor = (float)(_data.image.press_size.height) / ((lv_img_dsc_t *)_info.image.resource)->header.w;
-    // Scale the image to a suitable size.
-    // So you don’t have to consider the size of the source image.
-    if (h_factor < w_factor) {
-        _image_press_zoom = (int)(h_factor * LV_SCALE_NONE);
+
+    return true;
+}
+
+bool AppLauncherIcon::updateImage(void)
+{
+    const lv_image_header_t &header = ((const lv_image_dsc_t *)_info.image.resource)->header;
+    const lv_image_dsc_t *cached_image = nullptr;
+
+    ESP_UTILS_CHECK_FALSE_RETURN((header.w > 0) && (header.h > 0), false, "Invalid image size");
+
+    // Scale the image to a suitable size, so you don’t have to consider the size of the source image
+    _image_default_zoom = (int)(min((float)_data.image.default_size.width / header.w,
+                                    (float)_data.image.default_size.height / header.h) * LV_SCALE_NONE);
+    _image_press_zoom = (int)(min((float)_data.image.press_size.width / header.w,
+                                  (float)_data.image.press_size.height / header.h) * LV_SCALE_NONE);
+    ESP_UTILS_CHECK_FALSE_RETURN(_image_default_zoom > 0, false, "Invalid image default size");
+
+    // Draw a pre-scaled copy of the image if possible, then only the press effect is scaled at draw time
+    if ((_image_cache != nullptr) && (_image_default_zoom != LV_SCALE_NONE)) {
+        cached_image = _image_cache->acquire(_info.image.resource, _image_default_zoom);
+    }
+    if (cached_image != nullptr) {
+        _image_press_zoom = _image_press_zoom * LV_SCALE_NONE / _image_default_zoom;
+        _image_default_zoom = LV_SCALE_NONE;
+        lv_image_set_src(_icon_image_obj.get(), cached_image);
     } else {
-        _image_press_zoom = (int)(w_factor * LV_SCALE_NONE);
+        lv_image_set_src(_icon_image_obj.get(), _info.image.resource);
     }
+    lv_image_set_scale(_icon_image_obj.get(), _image_default_zoom);
+    // Release the old image after the new one is acquired and shown, so an unchanged image is not scaled again
+    releaseImage();
+    _cached_image = cached_image;
 
     return true;
 }
 
+void AppLauncherIcon::releaseImage(void)
+{
+    if (_cached_image != nullptr) {
+        _image_cache->release(_cached_image);
+        _cached_image = nullptr;
+    }
+}
+
 void AppLauncherIcon::onIconTouchEventCallback(lv_event_t *event)
 {
     AppLauncherIcon *icon = nullptr;
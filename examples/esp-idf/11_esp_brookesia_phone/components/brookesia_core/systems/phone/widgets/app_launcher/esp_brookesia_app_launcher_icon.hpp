@@ -9,6 +9,7 @@
 #include <map>
 #include "systems/base/esp_brookesia_base_context.hpp"
 #include "lvgl/esp_brookesia_lv_helper.hpp"
+#include "esp_brookesia_app_launcher_icon_cache.hpp"
 
 namespace esp_brookesia::systems::phone {
 
@@ -35,13 +36,26 @@ public:
         } label;
     };
 
-    AppLauncherIcon(base::Context &core, const Info &info, const Data &data);
+    AppLauncherIcon(
+        base::Context &core, const Info &info, const Data &data, AppLauncherIconImageCache *image_cache = nullptr
+    );
     ~AppLauncherIcon();
 
     bool begin(lv_obj_t *parent);
     bool del(void);
     bool toggleClickable(bool clickable);
 
+    /**
+     * @brief Show another app with the existing objects, so the icon can be recycled
+     */
+    bool bind(const Info &info);
+    bool setParent(lv_obj_t *parent);
+
+    const Info &getInfo(void) const
+    {
+        return _info;
+    }
+
     bool checkInitialized(void) const
     {
         return (_main_obj != nullptr);
@@ -50,11 +64,14 @@ public:
     bool updateByNewData(void);
 
 private:
+    bool updateImage(void);
+    void releaseImage(void);
     static void onIconTouchEventCallback(lv_event_t *event);
 
     base::Context &_system_context;
     Info _info;
     const Data &_data;
+    AppLauncherIconImageCache *_image_cache;
 
     struct {
         uint8_t is_pressed_losted: 1;
@@ -62,6 +79,7 @@ private:
     } _flags;
     int _image_default_zoom;
     int _image_press_zoom;
+    const lv_image_dsc_t *_cached_image;
     gui::LvObjSharedPtr _main_obj;
     gui::LvObjSharedPtr _icon_main_obj;
     gui::LvObjSharedPtr _icon_image_obj;
@@ -0,0 +1,157 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>
+#include "esp_brookesia_systems_internal.h"
+#if !ESP_BROOKESIA_PHONE_APP_LAUNCHER_ENABLE_DEBUG_LOG
+#   define ESP_BROOKESIA_UTILS_DISABLE_DEBUG_LOG
+#endif
+#include "phone/private/esp_brookesia_phone_utils.hpp"
+#include "lvgl/esp_brookesia_lv_helper.hpp"
+#include "esp_brookesia_app_launcher_icon_cache.hpp"
+
+using namespace std;
+
+namespace esp_brookesia::systems::phone {
+
+AppLauncherIconImageCache::AppLauncherIconImageCache(size_t idle_size_max):
+    _idle_size_max(idle_size_max),
+    _size(0),
+    _use_count(0)
+{
+}
+
+AppLauncherIconImageCache::~AppLauncherIconImageCache()
+{
+    ESP_UTILS_LOGD("Destroy(@0x%p)", this);
+    if (!_entries.empty()) {
+        ESP_UTILS_LOGW("Destroy with %d images in use", (int)_entries.size());
+    }
+    while (!_entries.empty()) {
+        destroyEntry(_entries.size() - 1);
+    }
+}
+
+const lv_image_dsc_t *AppLauncherIconImageCache::acquire(const void *src, int scale)
+{
+    ESP_UTILS_CHECK_NULL_RETURN(src, nullptr, "Invalid source");
+    ESP_UTILS_CHECK_FALSE_RETURN(scale > 0, nullptr, "Invalid scale");
+
+    if (lv_image_src_get_type(src) != LV_IMAGE_SRC_VARIABLE) {
+        return nullptr;
+    }
+
+    for (auto &entry : _entries) {
+        if ((entry.src == src) && (entry.scale == scale)) {
+            entry.ref_count++;
+            entry.last_use = ++_use_count;
+            return reinterpret_cast<const lv_image_dsc_t *>(entry.draw_buf);
+        }
+    }
+
+    lv_draw_buf_t *draw_buf = createScaledImage(static_cast<const lv_image_dsc_t *>(src), scale);
+    if (draw_buf == nullptr) {
+        ESP_UTILS_LOGW("Scale image(@0x%p) failed", src);
+        return nullptr;
+    }
+    _entries.push_back({src, scale, draw_buf, 1, ++_use_count});
+    _size += draw_buf->data_size;
+    ESP_UTILS_LOGD(
+        "Scale image(@0x%p) to %dx%d, cache size: %d", src, (int)draw_buf->header.w, (int)draw_buf->header.h,
+        (int)_size
+    );
+
+    return reinterpret_cast<const lv_image_dsc_t *>(draw_buf);
+}
+
+void AppLauncherIconImageCache::release(const lv_image_dsc_t *image)
+{
+    auto it = find_if(_entries.begin(), _entries.end(), [image](const Entry & entry) {
+        return reinterpret_cast<const lv_image_dsc_t *>(entry.draw_buf) == image;
+    });
+    ESP_UTILS_CHECK_FALSE_EXIT(it != _entries.end(), "Image(@0x%p) not found", image);
+    ESP_UTILS_CHECK_FALSE_EXIT(it->ref_count > 0, "Image(@0x%p) is not in use", image);
+
+    it->ref_count--;
+    if (it->ref_count == 0) {
+        trim(_idle_size_max);
+    }
+}
+
+void AppLauncherIconImageCache::clear(void)
+{
+    trim(0);
+}
+
+lv_draw_buf_t *AppLauncherIconImageCache::createScaledImage(const lv_image_dsc_t *src, int scale)
+{
+    int width = max<int>(1, (src->header.w * scale + LV_SCALE_NONE / 2) / LV_SCALE_NONE);
+    int height = max<int>(1, (src->header.h * scale + LV_SCALE_NONE / 2) / LV_SCALE_NONE);
+
+    lv_draw_buf_t *draw_buf = lv_draw_buf_create(width, height, LV_COLOR_FORMAT_ARGB8888, LV_STRIDE_AUTO);
+    ESP_UTILS_CHECK_NULL_RETURN(draw_buf, nullptr, "Create draw buffer(%dx%d) failed", width, height);
+    lv_draw_buf_clear(draw_buf, nullptr);
+
+    lv_layer_t layer;
+    gui::initLvBufferLayer(&layer, draw_buf);
+
+    // Scale the source image around its center, which is placed at the center of the buffer
+    lv_draw_image_dsc_t image_dsc;
+    lv_draw_image_dsc_init(&image_dsc);
+    image_dsc.src = src;
+    image_dsc.scale_x = scale;
+    image_dsc.scale_y = scale;
+    image_dsc.pivot.x = src->header.w / 2;
+    image_dsc.pivot.y = src->header.h / 2;
+    image_dsc.antialias = 1;
+    lv_area_t image_area = {0, 0, (int32_t)src->header.w - 1, (int32_t)src->header.h - 1};
+    lv_area_move(&image_area, width / 2 - image_dsc.pivot.x, height / 2 - image_dsc.pivot.y);
+    lv_draw_image(&layer, &image_dsc, &image_area);
+    if (!gui::finishLvBufferLayer(&layer)) {
+        lv_draw_buf_destroy(draw_buf);
+        ESP_UTILS_CHECK_FALSE_RETURN(false, nullptr, "Draw image failed");
+    }
+
+    return draw_buf;
+}
+
+void AppLauncherIconImageCache::destroyEntry(size_t index)
+{
+    lv_draw_buf_t *draw_buf = _entries[index].draw_buf;
+
+    // The decoded image may still be in the LVGL image cache
+    lv_image_cache_drop(draw_buf);
+    _size -= draw_buf->data_size;
+    lv_draw_buf_destroy(draw_buf);
+    _entries.erase(_entries.begin() + index);
+}
+
+void AppLauncherIconImageCache::trim(size_t idle_size_max)
+{
+    size_t idle_size = 0;
+    for (auto &entry : _entries) {
+        if (entry.ref_count == 0) {
+            idle_size += entry.draw_buf->data_size;
+        }
+    }
+
+    while (idle_size > idle_size_max) {
+        size_t oldest_index = _entries.size();
+        for (size_t i = 0; i < _entries.size(); i++) {
+            if ((_entries[i].ref_count == 0) &&
+                    ((oldest_index == _entries.size()) || (_entries[i].last_use < _entries[oldest_index].last_use))) {
+                oldest_index = i;
+            }
+        }
+        if (oldest_index == _entries.size()) {
+            break;
+        }
+        idle_size -= _entries[oldest_index].draw_buf->data_size;
+        ESP_UTILS_LOGD("Free image(@0x%p)", _entries[oldest_index].src);
+        destroyEntry(oldest_index);
+    }
+}
+
+} // namespace esp_brookesia::systems::phone
@@ -0,0 +1,67 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "lvgl.h"
+
+namespace esp_brookesia::systems::phone {
+
+/**
+ * @brief Pre-scaled icon images of the app launcher.
+ *
+ * An image is scaled once with the LVGL software renderer into an ARGB8888 draw buffer, so the icons are drawn
+ * without a transformation. The images are reference counted, the unused ones are kept until their total size
+ * exceeds `idle_size_max`, then the least recently used ones are freed.
+ */
+class AppLauncherIconImageCache {
+public:
+    AppLauncherIconImageCache(size_t idle_size_max);
+    ~AppLauncherIconImageCache();
+
+    AppLauncherIconImageCache(const AppLauncherIconImageCache &) = delete;
+    AppLauncherIconImageCache &operator=(const AppLauncherIconImageCache &) = delete;
+
+    /**
+     * @brief Get the image `src` scaled by `scale` (`LV_SCALE_NONE` is 1:1)
+     *
+     * @return The scaled image, or `nullptr` if the source is not a variable image or the scaling failed. Each image
+     *         returned must be given back with `release()`.
+     */
+    const lv_image_dsc_t *acquire(const void *src, int scale);
+    void release(const lv_image_dsc_t *image);
+
+    /**
+     * @brief Free all the unused images
+     */
+    void clear(void);
+
+    size_t getSize(void) const
+    {
+        return _size;
+    }
+
+private:
+    struct Entry {
+        const void *src;
+        int scale;
+        lv_draw_buf_t *draw_buf;
+        int ref_count;
+        uint32_t last_use;
+    };
+
+    static lv_draw_buf_t *createScaledImage(const lv_image_dsc_t *src, int scale);
+    void destroyEntry(size_t index);
+    void trim(size_t idle_size_max);
+
+    size_t _idle_size_max;
+    size_t _size;
+    uint32_t _use_count;
+    std::vector<Entry> _entries;
+};
+
+} // namespace esp_brookesia::systems::phone
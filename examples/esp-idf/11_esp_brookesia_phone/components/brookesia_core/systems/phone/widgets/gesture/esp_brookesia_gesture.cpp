@@ -5,6 +5,7 @@
  */
 #include <limits>
 #include <cmath>
+#include <map>
 #include "esp_brookesia_systems_internal.h"
 #if !ESP_BROOKESIA_PHONE_GESTURE_ENABLE_DEBUG_LOG
 #   define ESP_BROOKESIA_UTILS_DISABLE_DEBUG_LOG
@@ -17,6 +18,9 @@ using namespace esp_brookesia::gui;
 
 namespace esp_brookesia::systems::phone {
 
+// LVGL only passes the input device to its read callback, so keep track of which gesture hooked which device
+static map<lv_indev_t *, Gesture *> touch_read_hooks;
+
 Gesture::Gesture(base::Context &core_in, const Gesture::Data &data_in)
     : core(core_in)
     , data(data_in)
@@ -100,10 +104,18 @@ bool Gesture::begin(lv_obj_t *parent)
     _release_event_code = release_event_code;
     _indicator_bars = indicator_bars;
     _indicator_bar_scale_back_anims = indicator_bar_scale_back_anims;
+    _flags.is_detect_timer_running = true;
 
     // Update the object style
     ESP_UTILS_CHECK_FALSE_GOTO(updateByNewData(), err, "Update failed");
 
+    // Feed the sampler from the touch read callback, then the detect timer only needs to run while touched
+    if (installTouchReadHook()) {
+        ESP_UTILS_CHECK_FALSE_GOTO(controlDetectTimer(false), err, "Pause detect timer failed");
+    } else {
+        ESP_UTILS_LOGW("Install touch read hook failed, fall back to polling");
+    }
+
     return true;
 
 err:
@@ -116,8 +128,12 @@ bool Gesture::del(void)
 {
     ESP_UTILS_LOGD("Delete(0x%p)", this);
 
+    uninstallTouchReadHook();
     _direction_tan_threshold = 0;
     _touch_start_tick = 0;
+    _sampler.reset();
+    _flags.is_touch_pressed = false;
+    _flags.is_detect_timer_running = false;
     _detect_timer.reset();
     resetGestureInfo();
     _event_mask_obj.reset();
@@ -206,6 +222,15 @@ bool Gesture::calibrateData(const gui::StyleSize &screen_size, const base::Displ
     ESP_UTILS_CHECK_VALUE_RETURN(data.threshold.vertical_edge, 1, parent_h, false, "Invalid top edge threshold");
     ESP_UTILS_CHECK_FALSE_RETURN(data.threshold.speed_slow_px_per_ms > 0, false, "Invalid speed slow threshold");
     ESP_UTILS_CHECK_FALSE_RETURN(data.threshold.duration_short_ms > 0, false, "Invalid duration short threshold");
+    // Sampler
+    if ((data.sampler.fit_sample_num == 0) && (data.sampler.fit_window_ms == 0) &&
+            (data.sampler.deceleration_px_per_ms2 == 0)) {
+        data.sampler = GestureSampler::CONFIG_DEFAULT;
+    }
+    ESP_UTILS_CHECK_VALUE_RETURN(data.sampler.fit_sample_num, 2, GestureSampler::SAMPLE_NUM_MAX, false,
+                                 "Invalid sampler fit sample number");
+    ESP_UTILS_CHECK_FALSE_RETURN(data.sampler.fit_window_ms > 0, false, "Invalid sampler fit window");
+    ESP_UTILS_CHECK_FALSE_RETURN(data.sampler.deceleration_px_per_ms2 > 0, false, "Invalid sampler deceleration");
     // Left/Right indicator bar
     for (int i = 0; i < static_cast<int>(Gesture::IndicatorBarType::MAX); i++) {
         if (!data.flags.enable_indicator_bars[i]) {
@@ -404,6 +429,9 @@ bool Gesture::updateByNewData(void)
     lv_align_t align = LV_ALIGN_DEFAULT;
     // Timer
     lv_timer_set_period(_detect_timer.get(), data.detect_period_ms);
+    // Sampler
+    ESP_UTILS_CHECK_FALSE_RETURN(_sampler.setConfig(data.sampler), false, "Set sampler config failed");
+    _sampler.setBounds(core.getData().screen_size.width, core.getData().screen_size.height);
     // Mask
     lv_obj_set_size(_event_mask_obj.get(), core.getData().screen_size.width, core.getData().screen_size.height);
     // Indicator bar
@@ -458,6 +486,65 @@ bool Gesture::updateByNewData(void)
     return true;
 }
 
+bool Gesture::installTouchReadHook(void)
+{
+    ESP_UTILS_LOGD("Install touch read hook");
+    ESP_UTILS_CHECK_NULL_RETURN(_touch_device, false, "Invalid touch device");
+
+    if (_flags.is_touch_read_hooked) {
+        return true;
+    }
+
+    lv_indev_read_cb_t read_cb = lv_indev_get_read_cb(_touch_device);
+    ESP_UTILS_CHECK_NULL_RETURN(read_cb, false, "Touch device has no read callback");
+    ESP_UTILS_CHECK_FALSE_RETURN(read_cb != onTouchReadCallback, false, "Touch device is hooked by another gesture");
+
+    _touch_read_cb = read_cb;
+    touch_read_hooks[_touch_device] = this;
+    lv_indev_set_read_cb(_touch_device, onTouchReadCallback);
+    _flags.is_touch_read_hooked = true;
+
+    return true;
+}
+
+void Gesture::uninstallTouchReadHook(void)
+{
+    if (!_flags.is_touch_read_hooked) {
+        return;
+    }
+
+    ESP_UTILS_LOGD("Uninstall touch read hook");
+
+    // Only restore the original callback if nobody has replaced ours in the meantime
+    if (lv_indev_get_read_cb(_touch_device) == onTouchReadCallback) {
+        lv_indev_set_read_cb(_touch_device, _touch_read_cb);
+    }
+    touch_read_hooks.erase(_touch_device);
+    _touch_read_cb = nullptr;
+    _flags.is_touch_read_hooked = false;
+}
+
+bool Gesture::controlDetectTimer(bool run)
+{
+    ESP_UTILS_CHECK_NULL_RETURN(_detect_timer, false, "Invalid detect timer");
+
+    if (run == _flags.is_detect_timer_running) {
+        return true;
+    }
+
+    ESP_UTILS_LOGD("Control detect timer(%d)", run);
+    if (run) {
+        lv_timer_resume(_detect_timer.get());
+        // Run at the next `lv_timer_handler()` instead of waiting for a whole period
+        lv_timer_ready(_detect_timer.get());
+    } else {
+        lv_timer_pause(_detect_timer.get());
+    }
+    _flags.is_detect_timer_running = run;
+
+    return true;
+}
+
 void Gesture::onDataUpdateEventCallback(lv_event_t *event)
 {
     Gesture *gesture = nullptr;
@@ -471,6 +558,30 @@ void Gesture::onDataUpdateEventCallback(lv_event_t *event)
     ESP_UTILS_CHECK_FALSE_EXIT(gesture->updateByNewData(), "Update gesture object style failed");
 }
 
+void Gesture::onTouchReadCallback(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    // This is called for every read of the touch device, so keep it light and avoid logging
+    auto it = touch_read_hooks.find(indev);
+    if ((it == touch_read_hooks.end()) || (it->second->_touch_read_cb == nullptr)) {
+        return;
+    }
+
+    Gesture *gesture = it->second;
+    gesture->_touch_read_cb(indev, data);
+
+    bool pressed = (data->state == LV_INDEV_STATE_PRESSED);
+    if (pressed) {
+        // Note: the point is in the driver's coordinates, which are the same as `lv_indev_get_point()` unless the
+        // display is rotated by LVGL itself
+        if (!gesture->_flags.is_touch_pressed) {
+            gesture->_sampler.reset();
+        }
+        gesture->_sampler.push(data->point.x, data->point.y, lv_tick_get());
+        gesture->controlDetectTimer(true);
+    }
+    gesture->_flags.is_touch_pressed = pressed;
+}
+
 void Gesture::onTouchDetectTimerCallback(struct _lv_timer_t *t)
 {
     bool touched = false;
@@ -490,6 +601,13 @@ void Gesture::onTouchDetectTimerCallback(struct _lv_timer_t *t)
 
     // Check if touched and save the last touch point
     touched = gesture->readTouchPoint(info.stop_x, info.stop_y);
+    // Without the read hook, the sampler can only be fed here
+    if (!gesture->_flags.is_touch_read_hooked && touched) {
+        if (!gesture->checkGestureStart()) {
+            gesture->_sampler.reset();
+        }
+        gesture->_sampler.push(info.stop_x, info.stop_y, lv_tick_get());
+    }
 
     // Process the stop area
     info.stop_area = Gesture::AREA_CENTER;
@@ -498,8 +616,11 @@ void Gesture::onTouchDetectTimerCallback(struct _lv_timer_t *t)
     info.stop_area |= (info.stop_x < data.threshold.horizontal_edge) ? Gesture::AREA_LEFT_EDGE : 0;
     info.stop_area |= ((display_w - info.stop_x) < data.threshold.horizontal_edge) ? Gesture::AREA_RIGHT_EDGE : 0;
 
-    // If not touched before and now, just ignore and return
+    // If not touched before and now, just ignore and return. The timer will be resumed by the next touch
     if (!gesture->checkGestureStart() && !touched) {
+        if (gesture->_flags.is_touch_read_hooked) {
+            gesture->controlDetectTimer(false);
+        }
         return;
     }
 
@@ -547,8 +668,25 @@ void Gesture::onTouchDetectTimerCallback(struct _lv_timer_t *t)
 
     // Process the distance and speed
     info.distance_px = (float)sqrt(distance_x * distance_x + distance_y * distance_y);
-    info.speed_px_per_ms = (info.duration_ms > 0) ? (info.distance_px / info.duration_ms) :
-                           numeric_limits<float>::infinity();
+    info.predict_stop_x = info.stop_x;
+    info.predict_stop_y = info.stop_y;
+    if (gesture->_sampler.estimateVelocity(info.velocity_x_px_per_ms, info.velocity_y_px_per_ms)) {
+        GestureSampler::Sample last_sample = {};
+        // If the finger stopped moving before this moment (some drivers only report changed points), it has no speed
+        if (gesture->_sampler.getLastSample(last_sample) &&
+                (lv_tick_elaps(last_sample.tick_ms) > data.sampler.fit_window_ms)) {
+            info.velocity_x_px_per_ms = 0;
+            info.velocity_y_px_per_ms = 0;
+        } else {
+            gesture->_sampler.predictEndPoint(info.predict_stop_x, info.predict_stop_y);
+        }
+        info.speed_px_per_ms = (float)sqrt(info.velocity_x_px_per_ms * info.velocity_x_px_per_ms +
+                                           info.velocity_y_px_per_ms * info.velocity_y_px_per_ms);
+    } else {
+        // Not enough samples, fall back to the average speed
+        info.speed_px_per_ms = (info.duration_ms > 0) ? (info.distance_px / info.duration_ms) :
+                               numeric_limits<float>::infinity();
+    }
     info.flags.slow_speed = (info.speed_px_per_ms < data.threshold.speed_slow_px_per_ms);
 
     /* Process the direction */
@@ -587,6 +725,9 @@ event_process:
     lv_obj_send_event(gesture->_event_mask_obj.get(), event_code, (void *)&gesture->_event_data);
     if (event_code == gesture->_release_event_code) {
         gesture->resetGestureInfo();
+        if (gesture->_flags.is_touch_read_hooked && !gesture->_flags.is_touch_pressed) {
+            gesture->controlDetectTimer(false);
+        }
     }
 }
 
@@ -7,6 +7,7 @@
 
 #include "systems/base/esp_brookesia_base_context.hpp"
 #include "lvgl/esp_brookesia_lv_helper.hpp"
+#include "esp_brookesia_gesture_sampler.hpp"
 
 namespace esp_brookesia::systems::phone {
 
@@ -52,6 +53,7 @@ public:
         struct {
             uint8_t enable_indicator_bars[static_cast<int>(Gesture::IndicatorBarType::MAX)];
         } flags;
+        GestureSampler::Config sampler;     // All zero means `GestureSampler::CONFIG_DEFAULT`
     };
 
     enum Direction {
@@ -83,6 +85,10 @@ public:
         uint32_t duration_ms;
         float speed_px_per_ms;
         float distance_px;
+        float velocity_x_px_per_ms;
+        float velocity_y_px_per_ms;
+        int predict_stop_x;
+        int predict_stop_y;
         struct {
             uint8_t slow_speed: 1;
             uint8_t short_duration: 1;
@@ -147,8 +153,12 @@ private:
     };
     void resetGestureInfo(void);
     bool updateByNewData(void);
+    bool installTouchReadHook(void);
+    void uninstallTouchReadHook(void);
+    bool controlDetectTimer(bool run);
 
     static void onDataUpdateEventCallback(lv_event_t *event);
+    static void onTouchReadCallback(lv_indev_t *indev, lv_indev_data_t *data);
     static void onTouchDetectTimerCallback(struct _lv_timer_t *t);
     static void onIndicatorBarScaleBackAnimationExecuteCallback(void *var, int32_t value);
     static void onIndicatorBarScaleBackAnimationReadyCallback(lv_anim_t *anim);
@@ -163,6 +173,10 @@ private:
         .stop_y = -1,
         .duration_ms = 0,
         .distance_px = 0,
+        .velocity_x_px_per_ms = 0,
+        .velocity_y_px_per_ms = 0,
+        .predict_stop_x = -1,
+        .predict_stop_y = -1,
         .flags = {
             .slow_speed = 0,
             .short_duration = 0,
@@ -172,13 +186,19 @@ private:
     // Core
     lv_indev_t *_touch_device = nullptr;
 
+    lv_indev_read_cb_t _touch_read_cb = nullptr;
+
     struct {
         std::array<bool, static_cast<int>(Gesture::IndicatorBarType::MAX)>  is_indicator_bar_scale_back_anim_running;
+        bool is_touch_read_hooked;
+        bool is_touch_pressed;
+        bool is_detect_timer_running;
     } _flags = {};
     float _direction_tan_threshold = 0;
     std::array<int, static_cast<int>(Gesture::IndicatorBarType::MAX)>  _indicator_bar_min_lengths;
     std::array<int, static_cast<int>(Gesture::IndicatorBarType::MAX)>  _indicator_bar_max_lengths;
     uint32_t _touch_start_tick = 0;
+    GestureSampler _sampler;
     ESP_Brookesia_LvTimer_t _detect_timer;
     ESP_Brookesia_LvObj_t _event_mask_obj;
     std::array<ESP_Brookesia_LvObj_t, static_cast<int>(Gesture::IndicatorBarType::MAX)>  _indicator_bars;
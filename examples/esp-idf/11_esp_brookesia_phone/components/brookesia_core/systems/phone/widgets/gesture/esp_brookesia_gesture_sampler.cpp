@@ -0,0 +1,170 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>
+#include <cmath>
+#include "esp_brookesia_systems_internal.h"
+#if !ESP_BROOKESIA_PHONE_GESTURE_ENABLE_DEBUG_LOG
+#   define ESP_BROOKESIA_UTILS_DISABLE_DEBUG_LOG
+#endif
+#include "phone/private/esp_brookesia_phone_utils.hpp"
+#include "esp_brookesia_gesture_sampler.hpp"
+
+namespace esp_brookesia::systems::phone {
+
+GestureSampler::GestureSampler(const Config &config)
+{
+    ESP_UTILS_CHECK_FALSE_EXIT(setConfig(config), "Set config failed");
+}
+
+void GestureSampler::reset(void)
+{
+    _head = 0;
+    _sample_num = 0;
+}
+
+void GestureSampler::push(int x, int y, uint32_t tick_ms)
+{
+    // Drivers may report the same point several times between two LVGL ticks, only keep the latest one
+    if (_sample_num > 0) {
+        Sample &last = _samples[(_head + SAMPLE_NUM_MAX - 1) % SAMPLE_NUM_MAX];
+        if (last.tick_ms == tick_ms) {
+            last.x = x;
+            last.y = y;
+            return;
+        }
+    }
+
+    _samples[_head] = {
+        .x = x,
+        .y = y,
+        .tick_ms = tick_ms,
+    };
+    _head = (_head + 1) % SAMPLE_NUM_MAX;
+    if (_sample_num < SAMPLE_NUM_MAX) {
+        _sample_num++;
+    }
+}
+
+bool GestureSampler::setConfig(const Config &config)
+{
+    ESP_UTILS_CHECK_VALUE_RETURN(config.fit_sample_num, 2, SAMPLE_NUM_MAX, false, "Invalid fit sample number");
+    ESP_UTILS_CHECK_FALSE_RETURN(config.fit_window_ms > 0, false, "Invalid fit window");
+    ESP_UTILS_CHECK_FALSE_RETURN(config.deceleration_px_per_ms2 > 0, false, "Invalid deceleration");
+
+    _config = config;
+
+    return true;
+}
+
+void GestureSampler::setBounds(int width, int height)
+{
+    _bound_width = std::max(width, 0);
+    _bound_height = std::max(height, 0);
+}
+
+bool GestureSampler::estimateVelocity(float &vx_px_per_ms, float &vy_px_per_ms) const
+{
+    if (_sample_num < 2) {
+        return false;
+    }
+
+    // Collect the samples inside the fit window, time is relative to the latest sample to keep the sums small
+    const Sample &latest = getSampleFromLatest(0);
+    size_t fit_num = 0;
+    float sum_t = 0;
+    float sum_x = 0;
+    float sum_y = 0;
+    for (size_t i = 0; (i < _sample_num) && (i < _config.fit_sample_num); i++) {
+        const Sample &sample = getSampleFromLatest(i);
+        uint32_t age_ms = latest.tick_ms - sample.tick_ms;
+        if (age_ms > _config.fit_window_ms) {
+            break;
+        }
+        sum_t -= (float)age_ms;
+        sum_x += sample.x;
+        sum_y += sample.y;
+        fit_num++;
+    }
+    if (fit_num < 2) {
+        return false;
+    }
+
+    float mean_t = sum_t / fit_num;
+    float mean_x = sum_x / fit_num;
+    float mean_y = sum_y / fit_num;
+    float s_tt = 0;
+    float s_tx = 0;
+    float s_ty = 0;
+    for (size_t i = 0; i < fit_num; i++) {
+        const Sample &sample = getSampleFromLatest(i);
+        float dt = -(float)(latest.tick_ms - sample.tick_ms) - mean_t;
+        s_tt += dt * dt;
+        s_tx += dt * (sample.x - mean_x);
+        s_ty += dt * (sample.y - mean_y);
+    }
+    if (s_tt <= 0) {
+        return false;
+    }
+
+    vx_px_per_ms = s_tx / s_tt;
+    vy_px_per_ms = s_ty / s_tt;
+
+    return true;
+}
+
+bool GestureSampler::predictEndPoint(int &x, int &y) const
+{
+    Sample latest = {};
+    float vx = 0;
+    float vy = 0;
+
+    if (!getLastSample(latest)) {
+        return false;
+    }
+
+    x = latest.x;
+    y = latest.y;
+    // With a constant deceleration `a`, the remaining travel is `v^2 / (2 * a)` along the velocity direction
+    float speed = estimateVelocity(vx, vy) ? sqrtf(vx * vx + vy * vy) : 0;
+    if (speed > 0) {
+        float travel = speed * speed / (2 * _config.deceleration_px_per_ms2);
+        float dir_x = vx / speed;
+        float dir_y = vy / speed;
+        // Stop the travel where the path meets the border, so the direction of the fling is kept
+        if ((_bound_width > 0) && (dir_x != 0)) {
+            float border_x = (dir_x > 0) ? (_bound_width - 1) : 0;
+            travel = std::min(travel, std::max((border_x - latest.x) / dir_x, 0.0f));
+        }
+        if ((_bound_height > 0) && (dir_y != 0)) {
+            float border_y = (dir_y > 0) ? (_bound_height - 1) : 0;
+            travel = std::min(travel, std::max((border_y - latest.y) / dir_y, 0.0f));
+        }
+        x = latest.x + (int)lroundf(dir_x * travel);
+        y = latest.y + (int)lroundf(dir_y * travel);
+    }
+    // The driver may report a point out of the display
+    if (_bound_width > 0) {
+        x = std::clamp(x, 0, _bound_width - 1);
+    }
+    if (_bound_height > 0) {
+        y = std::clamp(y, 0, _bound_height - 1);
+    }
+
+    return true;
+}
+
+bool GestureSampler::getLastSample(Sample &sample) const
+{
+    if (_sample_num == 0) {
+        return false;
+    }
+
+    sample = getSampleFromLatest(0);
+
+    return true;
+}
+
+} // namespace esp_brookesia::systems::phone
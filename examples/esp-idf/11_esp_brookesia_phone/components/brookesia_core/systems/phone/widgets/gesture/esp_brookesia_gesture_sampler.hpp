@@ -0,0 +1,105 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace esp_brookesia::systems::phone {
+
+/**
+ * @brief A small ring of timestamped touch points, used to estimate the velocity of a gesture.
+ *
+ * The sampler is fed directly from the touch device read callback, so it sees every point reported by the driver
+ * instead of only the ones picked up by the detect timer. It does not depend on LVGL and can be driven by recorded
+ * touch traces.
+ */
+class GestureSampler {
+public:
+    static constexpr size_t SAMPLE_NUM_MAX = 16;
+
+    struct Sample {
+        int x;
+        int y;
+        uint32_t tick_ms;
+    };
+
+    struct Config {
+        uint8_t fit_sample_num;         // Number of the latest samples used by the least-squares fit
+        uint16_t fit_window_ms;         // Samples older than this (relative to the latest one) are ignored
+        float deceleration_px_per_ms2;  // Deceleration used to predict where a fling would stop
+    };
+
+    static constexpr Config CONFIG_DEFAULT = {
+        .fit_sample_num = 8,
+        .fit_window_ms = 100,
+        .deceleration_px_per_ms2 = 0.005f,
+    };
+
+    GestureSampler() = default;
+    GestureSampler(const Config &config);
+
+    void reset(void);
+    void push(int x, int y, uint32_t tick_ms);
+    bool setConfig(const Config &config);
+
+    /**
+     * @brief Set the size of the display, the predicted end point stops at its border
+     *
+     * @param width   Width of the display, 0 to not bound the prediction
+     * @param height  Height of the display, 0 to not bound the prediction
+     */
+    void setBounds(int width, int height);
+
+    /**
+     * @brief Estimate the velocity with a least-squares line fit of `x(t)` and `y(t)` over the latest samples
+     *
+     * @param[out] vx_px_per_ms  Velocity in x axis
+     * @param[out] vy_px_per_ms  Velocity in y axis
+     *
+     * @return true if there are at least two usable samples, otherwise false
+     */
+    bool estimateVelocity(float &vx_px_per_ms, float &vy_px_per_ms) const;
+
+    /**
+     * @brief Predict the point where the gesture would stop if the finger was lifted now, assuming a constant
+     *        deceleration along the estimated velocity
+     *
+     * @note  With the bounds set, a fling stops where its path meets the border of the display
+     *
+     * @param[out] x  Predicted x coordinate
+     * @param[out] y  Predicted y coordinate
+     *
+     * @return true if success, otherwise false (no sample)
+     */
+    bool predictEndPoint(int &x, int &y) const;
+
+    bool getLastSample(Sample &sample) const;
+    size_t getSampleNum(void) const
+    {
+        return _sample_num;
+    }
+    const Config &getConfig(void) const
+    {
+        return _config;
+    }
+
+private:
+    const Sample &getSampleFromLatest(size_t index) const
+    {
+        return _samples[(_head + SAMPLE_NUM_MAX - 1 - index) % SAMPLE_NUM_MAX];
+    }
+
+    Config _config = CONFIG_DEFAULT;
+    int _bound_width = 0;
+    int _bound_height = 0;
+    std::array<Sample, SAMPLE_NUM_MAX> _samples = {};
+    size_t _head = 0;
+    size_t _sample_num = 0;
+};
+
+} // namespace esp_brookesia::systems::phone
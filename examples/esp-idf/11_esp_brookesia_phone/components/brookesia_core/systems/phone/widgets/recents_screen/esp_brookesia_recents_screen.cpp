@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <cmath>
+#include <vector>
 #include "esp_brookesia_systems_internal.h"
 #if !ESP_BROOKESIA_PHONE_RECENTS_SCREEN_ENABLE_DEBUG_LOG
 #   define ESP_BROOKESIA_UTILS_DISABLE_DEBUG_LOG
@@ -14,6 +15,9 @@
 #define MEMORY_LABEL_TEXT_FORMAT        "%d + %d %s of %d + %d %s available"
 #define MEMORY_LABEL_TEXT_UNIT          "KB"
 
+#define SNAPSHOT_POOL_SIZE              (ESP_BROOKESIA_PHONE_RECENTS_SCREEN_SNAPSHOT_POOL_SIZE)
+#define SNAPSHOT_MOVE_BACK_DURATION_MS  (ESP_BROOKESIA_PHONE_RECENTS_SCREEN_SNAPSHOT_MOVE_BACK_DURATION_MS)
+
 using namespace std;
 using namespace esp_brookesia::gui;
 
@@ -121,6 +125,33 @@ bool RecentsScreen::begin(lv_obj_t *parent)
     lv_label_set_text_fmt(_memory_label.get(), MEMORY_LABEL_TEXT_FORMAT, 0, 0, _data.memory.label_unit_text,
                           0, 0, _data.memory.label_unit_text);
 
+    // The snapshots are kept when their apps are closed, and bound to the next apps
+    _snapshot_pool = make_unique<SnapshotPool>([this]() -> unique_ptr<RecentsScreenSnapshot> {
+        auto snapshot = make_unique<RecentsScreenSnapshot>(_system_context, _data.snapshot_table.snapshot);
+        ESP_UTILS_CHECK_NULL_RETURN(snapshot, nullptr, "Create snapshot failed");
+        ESP_UTILS_CHECK_FALSE_RETURN(snapshot->begin(_snapshot_table.get()), nullptr, "Begin snapshot failed");
+        return snapshot;
+    }, [](RecentsScreenSnapshot & snapshot) {
+        return snapshot.reset();
+    }, SNAPSHOT_POOL_SIZE);
+    ESP_UTILS_CHECK_NULL_GOTO(_snapshot_pool, err, "Create snapshot pool failed");
+    ESP_UTILS_CHECK_FALSE_GOTO(_snapshot_pool->reserve(SNAPSHOT_POOL_SIZE), err, "Reserve snapshots failed");
+
+    _snapshot_transition = make_unique<LvTransition>(lv_obj_get_display(_main_obj.get()));
+    ESP_UTILS_CHECK_NULL_GOTO(_snapshot_transition, err, "Create snapshot transition failed");
+    _snapshot_transition->setStyleAttribute({0, 0, SNAPSHOT_MOVE_BACK_DURATION_MS, 0, StyleAnimation::ANIM_PATH_TYPE_EASE_OUT});
+    _snapshot_transition->setExecutionMethod([this](int value) {
+        auto it = _id_snapshot_map.find(_snapshot_transition_id);
+        if (it == _id_snapshot_map.end()) {
+            _snapshot_transition->stop();
+            return;
+        }
+        lv_obj_set_y(it->second->getDragObj(), value);
+    });
+    _snapshot_transition->setCompletedMethod([this]() {
+        _snapshot_transition_id = -1;
+    });
+
     return true;
 
 err:
@@ -144,13 +175,17 @@ bool RecentsScreen::del(void)
         ret = false;
     }
 
+    // Delete the snapshots before their parent
+    _snapshot_transition.reset();
+    _snapshot_transition_id = -1;
+    _id_snapshot_map.clear();
+    _snapshot_pool.reset();
     _main_obj.reset();
     _memory_obj.reset();
     _memory_label.reset();
     _snapshot_table.reset();
     _trash_obj.reset();
     _trash_icon.reset();
-    _id_snapshot_map.clear();
 
     return ret;
 }
@@ -171,21 +206,19 @@ bool RecentsScreen::setVisible(bool visible) const
 
 bool RecentsScreen::addSnapshot(const RecentsScreenSnapshot::Conf &conf)
 {
-    shared_ptr<RecentsScreenSnapshot> snapshot = nullptr;
-
     ESP_UTILS_LOGD("Add snapshot(%d)", conf.id);
     ESP_UTILS_CHECK_FALSE_RETURN(checkInitialized(), false, "Not initialized");
 
-    snapshot = make_shared<RecentsScreenSnapshot>(_system_context, conf, _data.snapshot_table.snapshot);
-    ESP_UTILS_CHECK_NULL_RETURN(snapshot, false, "Create snapshot failed");
+    SnapshotPool::ItemPtr snapshot = _snapshot_pool->acquire();
+    ESP_UTILS_CHECK_NULL_RETURN(snapshot, false, "Acquire snapshot failed");
 
-    ESP_UTILS_CHECK_FALSE_RETURN(snapshot->begin(_snapshot_table.get()), false, "Begin snapshot failed");
+    ESP_UTILS_CHECK_FALSE_RETURN(snapshot->setConf(conf), false, "Set snapshot conf failed");
 
     if (checkSnapshotExist(conf.id)) {
         ESP_UTILS_LOGW("Already exist, override it");
-        _id_snapshot_map[conf.id] = snapshot;
+        _id_snapshot_map[conf.id] = std::move(snapshot);
     } else {
-        auto ret = _id_snapshot_map.insert(std::pair<int, shared_ptr<RecentsScreenSnapshot>>(conf.id, snapshot));
+        auto ret = _id_snapshot_map.emplace(conf.id, std::move(snapshot));
         ESP_UTILS_CHECK_FALSE_RETURN(ret.second, false, "Insert snapshot failed");
     }
 
@@ -200,6 +233,7 @@ bool RecentsScreen::removeSnapshot(int id)
     ESP_UTILS_CHECK_FALSE_RETURN(checkInitialized(), false, "Not initialized");
     ESP_UTILS_CHECK_FALSE_RETURN(checkSnapshotExist(id), false, "Snapshot is not exist");
 
+    stopSnapshotTransition(id);
     int num = _id_snapshot_map.erase(id);
     ESP_UTILS_CHECK_FALSE_RETURN(num > 0, false, "Remove snapshot failed");
 
@@ -255,11 +289,36 @@ bool RecentsScreen::moveSnapshotY(int id, int y)
     drag_obj = _id_snapshot_map.at(id)->getDragObj();
     ESP_UTILS_CHECK_NULL_RETURN(drag_obj, false, "Invalid snapshot drag object");
 
+    stopSnapshotTransition(id);
     lv_obj_set_y(drag_obj, y);
 
     return true;
 }
 
+bool RecentsScreen::animateSnapshotY(int id, int y)
+{
+    ESP_UTILS_LOGD("Animate snapshot(%d) to y(%d)", id, y);
+    ESP_UTILS_CHECK_FALSE_RETURN(checkInitialized(), false, "Not initialized");
+    ESP_UTILS_CHECK_FALSE_RETURN(checkSnapshotExist(id), false, "Snapshot is not exist");
+
+    int current_y = _id_snapshot_map.at(id)->getCurrentY();
+    if ((SNAPSHOT_MOVE_BACK_DURATION_MS <= 0) || (current_y == y)) {
+        return moveSnapshotY(id, y);
+    }
+
+    // Only one snapshot can be dragged at a time, so the transition is shared
+    if ((_snapshot_transition_id != id) && (_snapshot_transition_id >= 0)) {
+        stopSnapshotTransition(_snapshot_transition_id);
+    }
+    _snapshot_transition_id = id;
+    if (!_snapshot_transition->start(current_y, y)) {
+        ESP_UTILS_LOGE("Start snapshot transition failed, move it at once");
+        return moveSnapshotY(id, y);
+    }
+
+    return true;
+}
+
 bool RecentsScreen::updateSnapshotImage(int id)
 {
     ESP_UTILS_LOGD("Update snapshot(%d) image", id);
@@ -506,6 +565,16 @@ bool RecentsScreen::calibrateData(const gui::StyleSize &screen_size, const base:
     return true;
 }
 
+void RecentsScreen::stopSnapshotTransition(int id)
+{
+    if ((_snapshot_transition == nullptr) || (_snapshot_transition_id != id)) {
+        return;
+    }
+
+    _snapshot_transition->stop();
+    _snapshot_transition_id = -1;
+}
+
 bool RecentsScreen::updateByNewData(void)
 {
     float h_factor = 0;
@@ -590,7 +659,7 @@ void RecentsScreen::onTrashTouchEventCallback(lv_event_t *event)
 {
     lv_event_code_t event_code = lv_event_get_code(event);
     RecentsScreen *recents_screen = (RecentsScreen *)lv_event_get_user_data(event);
-    std::unordered_map<int, std::shared_ptr<RecentsScreenSnapshot>> id_snapshot_map;
+    std::vector<int> snapshot_ids;
 
     ESP_UTILS_LOGD("Trash touch event callback");
     ESP_UTILS_CHECK_NULL_EXIT(recents_screen, "Invalid recents_screen object");
@@ -601,11 +670,14 @@ void RecentsScreen::onTrashTouchEventCallback(lv_event_t *event)
         if (recents_screen->_is_trash_pressed_losted) {
             break;
         }
-        // Since the snapshot may be deleted during the loop, we need to copy the map first
-        id_snapshot_map = recents_screen->_id_snapshot_map;
-        for (auto &it : id_snapshot_map) {
+        // Since the snapshot may be deleted during the loop, we need to copy the ids first
+        snapshot_ids.reserve(recents_screen->_id_snapshot_map.size());
+        for (auto &it : recents_screen->_id_snapshot_map) {
+            snapshot_ids.push_back(it.first);
+        }
+        for (int id : snapshot_ids) {
             lv_obj_send_event(recents_screen->getEventObject(), recents_screen->getSnapshotDeletedEventCode(),
-                              reinterpret_cast<void *>(it.first));
+                              reinterpret_cast<void *>(id));
         }
         // Send this event to notify that trash icon is clicked
         lv_obj_send_event(recents_screen->getEventObject(), recents_screen->getSnapshotDeletedEventCode(),
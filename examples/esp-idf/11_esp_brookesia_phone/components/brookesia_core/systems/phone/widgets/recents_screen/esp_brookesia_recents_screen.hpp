@@ -9,12 +9,16 @@
 #include <unordered_map>
 #include "systems/base/esp_brookesia_base_context.hpp"
 #include "lvgl/esp_brookesia_lv_helper.hpp"
+#include "lvgl/esp_brookesia_lv_object_pool.hpp"
+#include "lvgl/esp_brookesia_lv_transition.hpp"
 #include "esp_brookesia_recents_screen_snapshot.hpp"
 
 namespace esp_brookesia::systems::phone {
 
 class RecentsScreen {
 public:
+    using SnapshotPool = gui::LvObjectPool<RecentsScreenSnapshot>;
+
     struct Data {
         struct {
             int y_start;
@@ -66,6 +70,11 @@ public:
     bool scrollToSnapshotById(int id);
     bool scrollToSnapshotByIndex(uint8_t index);
     bool moveSnapshotY(int id, int y);
+    /**
+     * @brief Move a snapshot to `y` with one step at each refresh of the display. The move stops if the snapshot is
+     *        moved by `moveSnapshotY()` or removed meanwhile.
+     */
+    bool animateSnapshotY(int id, int y);
     bool updateSnapshotImage(int id);
     bool setMemoryLabel(int internal_free, int internal_total, int external_free, int external_total) const;
 
@@ -93,11 +102,20 @@ public:
     {
         return (int)_id_snapshot_map.size();
     }
+    const SnapshotPool *getSnapshotPool(void) const
+    {
+        return _snapshot_pool.get();
+    }
+    const gui::LvTransition *getSnapshotTransition(void) const
+    {
+        return _snapshot_transition.get();
+    }
 
     static bool calibrateData(const gui::StyleSize &screen_size, const base::Display &display, Data &data);
 
 private:
     bool updateByNewData(void);
+    void stopSnapshotTransition(int id);
 
     static void onDataUpdateEventCallback(lv_event_t *event);
     static void onTrashTouchEventCallback(lv_event_t *event);
@@ -115,7 +133,11 @@ private:
     ESP_Brookesia_LvObj_t _snapshot_table;
     ESP_Brookesia_LvObj_t _trash_obj;
     ESP_Brookesia_LvObj_t _trash_icon;
-    std::unordered_map<int, std::shared_ptr<RecentsScreenSnapshot>> _id_snapshot_map;
+    // The snapshots are taken from the pool, so it must be declared before them
+    std::unique_ptr<SnapshotPool> _snapshot_pool;
+    std::unordered_map<int, SnapshotPool::ItemPtr> _id_snapshot_map;
+    int _snapshot_transition_id = -1;
+    gui::LvTransitionUniquePtr _snapshot_transition;
 };
 
 } // namespace esp_brookesia::systems::phone
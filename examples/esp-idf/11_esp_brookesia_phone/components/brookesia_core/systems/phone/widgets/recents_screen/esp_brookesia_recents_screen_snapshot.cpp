@@ -10,6 +10,8 @@
 #include "phone/private/esp_brookesia_phone_utils.hpp"
 #include "esp_brookesia_recents_screen_snapshot.hpp"
 
+#define ENABLE_SNAPSHOT_IMAGE_CACHE     (ESP_BROOKESIA_PHONE_RECENTS_SCREEN_ENABLE_SNAPSHOT_IMAGE_CACHE)
+
 using namespace std;
 using namespace esp_brookesia::gui;
 
@@ -21,7 +23,13 @@ RecentsScreenSnapshot::RecentsScreenSnapshot(
     const RecentsScreenSnapshot::Data &data
 )
     : _system_context(core)
-    , _conf(conf)
+    , _conf(&conf)
+    , _data(data)
+{
+}
+
+RecentsScreenSnapshot::RecentsScreenSnapshot(base::Context &core, const RecentsScreenSnapshot::Data &data)
+    : _system_context(core)
     , _data(data)
 {
 }
@@ -46,9 +54,11 @@ bool RecentsScreenSnapshot::begin(lv_obj_t *parent)
 
     ESP_UTILS_LOGD("Begin@0x%p)", this);
     ESP_UTILS_CHECK_NULL_RETURN(parent, false, "Invalid parent object");
-    ESP_UTILS_CHECK_NULL_RETURN(_conf.name, false, "Invalid name");
-    ESP_UTILS_CHECK_NULL_RETURN(_conf.snapshot_image_resource, false, "Invalid snapshot image");
-    ESP_UTILS_CHECK_NULL_RETURN(_conf.icon_image_resource, false, "Invalid icon image");
+    if (_conf != nullptr) {
+        ESP_UTILS_CHECK_NULL_RETURN(_conf->name, false, "Invalid name");
+        ESP_UTILS_CHECK_NULL_RETURN(_conf->snapshot_image_resource, false, "Invalid snapshot image");
+        ESP_UTILS_CHECK_NULL_RETURN(_conf->icon_image_resource, false, "Invalid icon image");
+    }
     ESP_UTILS_CHECK_FALSE_RETURN(!checkInitialized(), false, "Snapshot is already initialized");
 
     /* Create objects */
@@ -71,6 +81,9 @@ bool RecentsScreenSnapshot::begin(lv_obj_t *parent)
     // Main
     lv_obj_add_style(main_obj.get(), _system_context.getDisplay().getCoreContainerStyle(), 0);
     lv_obj_clear_flag(main_obj.get(), LV_OBJ_FLAG_SCROLLABLE);
+    if (_conf == nullptr) {
+        lv_obj_add_flag(main_obj.get(), LV_OBJ_FLAG_HIDDEN);
+    }
     // Drag
     lv_obj_add_style(drag_obj.get(), _system_context.getDisplay().getCoreContainerStyle(), 0);
     lv_obj_center(drag_obj.get());
@@ -85,10 +98,8 @@ bool RecentsScreenSnapshot::begin(lv_obj_t *parent)
     lv_obj_add_style(title_icon.get(), _system_context.getDisplay().getCoreContainerStyle(), 0);
     // lv_obj_set_size(title_icon.get(), LV_SIZE_CONTENT, LV_SIZE_CONTENT);
     lv_image_set_inner_align(title_icon.get(), LV_IMAGE_ALIGN_CENTER);
-    lv_img_set_src(title_icon.get(), _conf.icon_image_resource);
     // Tile label
     lv_obj_add_style(title_label.get(), _system_context.getDisplay().getCoreContainerStyle(), 0);
-    lv_label_set_text_static(title_label.get(), _conf.name);
     // Snapshot
     lv_obj_add_style(snapshot_obj.get(), _system_context.getDisplay().getCoreContainerStyle(), 0);
     lv_obj_align(snapshot_obj.get(), LV_ALIGN_BOTTOM_MID, 0, 0);
@@ -138,6 +149,41 @@ bool RecentsScreenSnapshot::del(void)
     _title_label.reset();
     _snapshot_obj.reset();
     _snapshot_image.reset();
+    releaseScaledImage();
+
+    return true;
+}
+
+bool RecentsScreenSnapshot::setConf(const Conf &conf)
+{
+    ESP_UTILS_LOGD("Set conf(%d)@0x%p)", conf.id, this);
+    ESP_UTILS_CHECK_FALSE_RETURN(checkInitialized(), false, "Not initialized");
+    ESP_UTILS_CHECK_NULL_RETURN(conf.name, false, "Invalid name");
+    ESP_UTILS_CHECK_NULL_RETURN(conf.snapshot_image_resource, false, "Invalid snapshot image");
+    ESP_UTILS_CHECK_NULL_RETURN(conf.icon_image_resource, false, "Invalid icon image");
+
+    _conf = &conf;
+    lv_obj_move_foreground(_main_obj.get());
+    lv_obj_clear_flag(_main_obj.get(), LV_OBJ_FLAG_HIDDEN);
+    ESP_UTILS_CHECK_FALSE_RETURN(updateByNewData(), false, "Update failed");
+    _origin_y = getCurrentY();
+
+    return true;
+}
+
+bool RecentsScreenSnapshot::reset(void)
+{
+    ESP_UTILS_LOGD("Reset@0x%p)", this);
+    ESP_UTILS_CHECK_FALSE_RETURN(checkInitialized(), false, "Not initialized");
+
+    // The name and the images belong to the app, they may be freed once it is closed
+    _conf = nullptr;
+    lv_obj_add_flag(_main_obj.get(), LV_OBJ_FLAG_HIDDEN);
+    lv_obj_center(_drag_obj.get());
+    lv_label_set_text_static(_title_label.get(), "");
+    lv_image_set_src(_title_icon.get(), nullptr);
+    lv_image_set_src(_snapshot_image.get(), nullptr);
+    releaseScaledImage();
 
     return true;
 }
@@ -155,6 +201,7 @@ int RecentsScreenSnapshot::getCurrentY(void) const
 bool RecentsScreenSnapshot::updateByNewData(void)
 {
     int app_img_zoom = 0;
+    const void *snapshot_image_resource = nullptr;
     float h_factor = 0;
     float w_factor = 0;
 
@@ -168,9 +215,22 @@ bool RecentsScreenSnapshot::updateByNewData(void)
     // Title
     lv_obj_set_size(_title_obj.get(), _data.title.main_size.width, _data.title.main_size.height);
     lv_obj_set_style_pad_column(_title_obj.get(), _data.title.main_layout_column_pad, 0);
+    // Title label
+    lv_obj_set_style_text_font(_title_label.get(), (lv_font_t *)_data.title.text_font.font_resource, 0);
+    lv_obj_set_style_text_color(_title_label.get(), lv_color_hex(_data.title.text_color.color), 0);
+    lv_obj_set_style_text_opa(_title_label.get(), _data.title.text_color.opacity, 0);
+    // Snapshot
+    lv_obj_set_size(_snapshot_obj.get(), _data.image.main_size.width, _data.image.main_size.height);
+    lv_obj_set_style_radius(_snapshot_obj.get(), _data.image.radius, 0);
+    // The rest depends on the app
+    if (_conf == nullptr) {
+        return true;
+    }
+
     // Title icon
-    h_factor = (float)(_data.title.icon_size.height) / ((const lv_img_dsc_t *)_conf.icon_image_resource)->header.h;
-    w_factor = (float)(_data.title.icon_size.width) / ((const lv_img_dsc_t *)_conf.icon_image_resource)->header.w;
+    lv_img_set_src(_title_icon.get(), _conf->icon_image_resource);
+    h_factor = (float)(_data.title.icon_size.height) / ((const lv_img_dsc_t *)_conf->icon_image_resource)->header.h;
+    w_factor = (float)(_data.title.icon_size.width) / ((const lv_img_dsc_t *)_conf->icon_image_resource)->header.w;
     if (h_factor < w_factor) {
         lv_image_set_scale(_title_icon.get(), (int)(h_factor * LV_SCALE_NONE));
     } else {
@@ -179,31 +239,76 @@ bool RecentsScreenSnapshot::updateByNewData(void)
     lv_obj_set_size(_title_icon.get(), _data.title.icon_size.width, _data.title.icon_size.height);
     lv_obj_refr_size(_title_icon.get());
     // Title label
-    lv_obj_set_style_text_font(_title_label.get(), (lv_font_t *)_data.title.text_font.font_resource, 0);
-    lv_obj_set_style_text_color(_title_label.get(), lv_color_hex(_data.title.text_color.color), 0);
-    lv_obj_set_style_text_opa(_title_label.get(), _data.title.text_color.opacity, 0);
-    // Snapshot
-    lv_obj_set_size(_snapshot_obj.get(), _data.image.main_size.width, _data.image.main_size.height);
-    lv_obj_set_style_radius(_snapshot_obj.get(), _data.image.radius, 0);
+    lv_label_set_text_static(_title_label.get(), _conf->name);
     // Snapshot image
-    if (_conf.snapshot_image_resource != _conf.icon_image_resource) {
-        h_factor = (float)(_data.image.main_size.height) / ((const lv_img_dsc_t *)_conf.snapshot_image_resource)->header.h;
-        w_factor = (float)(_data.image.main_size.width) / ((const lv_img_dsc_t *)_conf.snapshot_image_resource)->header.w;
+    snapshot_image_resource = _conf->snapshot_image_resource;
+    if (_conf->snapshot_image_resource != _conf->icon_image_resource) {
+        h_factor = (float)(_data.image.main_size.height) / ((const lv_img_dsc_t *)_conf->snapshot_image_resource)->header.h;
+        w_factor = (float)(_data.image.main_size.width) / ((const lv_img_dsc_t *)_conf->snapshot_image_resource)->header.w;
         if (h_factor < w_factor) {
             app_img_zoom = (int)(h_factor * LV_SCALE_NONE);
         } else {
             app_img_zoom = (int)(w_factor * LV_SCALE_NONE);
         }
-        lv_image_set_scale(_snapshot_image.get(), app_img_zoom);
+        // The snapshot is taken again before each update, so it is scaled again too
+        if (ENABLE_SNAPSHOT_IMAGE_CACHE && updateScaledImage(app_img_zoom)) {
+            snapshot_image_resource = _scaled_image;
+            lv_image_set_scale(_snapshot_image.get(), LV_SCALE_NONE);
+        } else {
+            releaseScaledImage();
+            lv_image_set_scale(_snapshot_image.get(), app_img_zoom);
+        }
         lv_obj_align(_snapshot_image.get(), LV_ALIGN_TOP_MID, 0, 0);
     } else {
+        releaseScaledImage();
         lv_image_set_scale(_snapshot_image.get(), LV_SCALE_NONE);
         lv_obj_center(_snapshot_image.get());
     }
     lv_obj_set_size(_snapshot_image.get(), _data.image.main_size.width, _data.image.main_size.height);
-    lv_img_set_src(_snapshot_image.get(), _conf.snapshot_image_resource);
+    lv_img_set_src(_snapshot_image.get(), snapshot_image_resource);
+
+    return true;
+}
+
+bool RecentsScreenSnapshot::updateScaledImage(int scale)
+{
+    auto src = static_cast<const lv_image_dsc_t *>(_conf->snapshot_image_resource);
+    int width = max<int>(1, (src->header.w * scale + LV_SCALE_NONE / 2) / LV_SCALE_NONE);
+    int height = max<int>(1, (src->header.h * scale + LV_SCALE_NONE / 2) / LV_SCALE_NONE);
+    lv_color_format_t color_format = static_cast<lv_color_format_t>(src->header.cf);
+
+    // Keep the buffer while the size and the color format are the same
+    if ((_scaled_image != nullptr) && ((_scaled_image->header.w != width) || (_scaled_image->header.h != height) ||
+                                       (_scaled_image->header.cf != color_format))) {
+        releaseScaledImage();
+    }
+    if (_scaled_image == nullptr) {
+        _scaled_image = lv_draw_buf_create(width, height, color_format, LV_STRIDE_AUTO);
+        ESP_UTILS_CHECK_NULL_RETURN(_scaled_image, false, "Create scaled image(%dx%d) failed", width, height);
+    }
+    if (!gui::scaleLvImage(src, _scaled_image)) {
+        ESP_UTILS_LOGD("Scale snapshot image failed, transform it instead");
+        releaseScaledImage();
+        return false;
+    }
+    // The image may have been decoded with its previous content
+    lv_image_cache_drop(_scaled_image);
 
     return true;
 }
 
+void RecentsScreenSnapshot::releaseScaledImage(void)
+{
+    if (_scaled_image == nullptr) {
+        return;
+    }
+
+    if ((_snapshot_image != nullptr) && (lv_image_get_src(_snapshot_image.get()) == _scaled_image)) {
+        lv_image_set_src(_snapshot_image.get(), nullptr);
+    }
+    lv_image_cache_drop(_scaled_image);
+    lv_draw_buf_destroy(_scaled_image);
+    _scaled_image = nullptr;
+}
+
 } // namespace esp_brookesia::systems::phone
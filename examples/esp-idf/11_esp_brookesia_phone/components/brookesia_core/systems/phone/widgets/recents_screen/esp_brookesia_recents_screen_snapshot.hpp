@@ -43,11 +43,24 @@ public:
     RecentsScreenSnapshot &operator=(RecentsScreenSnapshot &&) = delete;
 
     RecentsScreenSnapshot(base::Context &core, const Conf &conf, const Data &data);
+    /**
+     * @brief Create a snapshot without an app, such as for a `gui::LvObjectPool`. It is hidden until `setConf()`.
+     */
+    RecentsScreenSnapshot(base::Context &core, const Data &data);
     ~RecentsScreenSnapshot();
 
     bool begin(lv_obj_t *parent);
     bool del(void);
 
+    /**
+     * @brief Bind the snapshot to an app, then show it after the other snapshots of its parent
+     */
+    bool setConf(const Conf &conf);
+    /**
+     * @brief Unbind the snapshot from its app, hide it and move it back to its origin
+     */
+    bool reset(void);
+
     bool checkInitialized(void) const
     {
         return (_main_obj != nullptr);
@@ -69,8 +82,11 @@ public:
     bool updateByNewData(void);
 
 private:
+    bool updateScaledImage(int scale);
+    void releaseScaledImage(void);
+
     base::Context &_system_context;
-    const Conf &_conf;
+    const Conf *_conf = nullptr;
     const Data &_data;
 
     int _origin_y = 0;
@@ -81,6 +97,8 @@ private:
     ESP_Brookesia_LvObj_t _title_label;
     ESP_Brookesia_LvObj_t _snapshot_obj;
     ESP_Brookesia_LvObj_t _snapshot_image;
+    // The snapshot image scaled to the size of `_snapshot_image`, so it is not transformed at every frame
+    lv_draw_buf_t *_scaled_image = nullptr;
 };
 
 } // namespace esp_brookesia::systems::phone
@@ -14,6 +14,8 @@
 #include "lvgl/esp_brookesia_lv_helper.hpp"
 #include "esp_brookesia_status_bar.hpp"
 
+#define ICON_POOL_SIZE  (ESP_BROOKESIA_PHONE_STATUS_BAR_ICON_POOL_SIZE)
+
 using namespace std;
 using namespace esp_brookesia::gui;
 
@@ -42,6 +44,16 @@ bool StatusBar::begin(lv_obj_t *parent)
     ESP_UTILS_CHECK_FALSE_RETURN(!checkMainInitialized(), false, "Already initialized");
 
     ESP_UTILS_CHECK_FALSE_GOTO(beginMain(parent), err, "Begin main failed");
+    // The icons of the apps are added and removed as they start and close, keep their objects to reuse them
+    _icon_pool = make_unique<IconPool>([this]() -> unique_ptr<StatusBarIcon> {
+        auto icon = make_unique<StatusBarIcon>();
+        ESP_UTILS_CHECK_NULL_RETURN(icon, nullptr, "Create icon failed");
+        ESP_UTILS_CHECK_FALSE_RETURN(icon->begin(_system_context, _area_objs[0].get()), nullptr, "Begin icon failed");
+        return icon;
+    }, [](StatusBarIcon & icon) {
+        return icon.reset();
+    }, ICON_POOL_SIZE);
+    ESP_UTILS_CHECK_NULL_GOTO(_icon_pool, err, "Create icon pool failed");
     ESP_UTILS_CHECK_FALSE_GOTO(beginWifi(), err, "Begin wifi failed");
     ESP_UTILS_CHECK_FALSE_GOTO(beginBattery(), err, "Begin battery failed");
     ESP_UTILS_CHECK_FALSE_GOTO(beginClock(), err, "Begin clock failed");
@@ -72,6 +84,9 @@ bool StatusBar::del(void)
         ret = false;
     }
 
+    // Give the icons back and delete them before their parents
+    _id_icon_map.clear();
+    _icon_pool.reset();
     if (!delMain()) {
         ESP_UTILS_LOGE("Delete main failed");
         ret = false;
@@ -84,8 +99,12 @@ bool StatusBar::del(void)
         ESP_UTILS_LOGE("Delete clock failed");
         ret = false;
     }
+    if (!delWifi()) {
+        ESP_UTILS_LOGE("Delete wifi failed");
+        ret = false;
+    }
 
-    _id_icon_map.clear();
+    _digit_atlas.del();
 
     return ret;
 }
@@ -114,12 +133,15 @@ bool StatusBar::addIcon(const StatusBarIcon::Data &data, uint8_t area_index, int
     ESP_UTILS_LOGD("Add icon(%d) in area(%d)", id, area_index);
     ESP_UTILS_CHECK_FALSE_RETURN(checkMainInitialized(), false, "Not initialized");
 
-    shared_ptr<StatusBarIcon> icon = make_shared<StatusBarIcon>(data);
+    ESP_UTILS_CHECK_FALSE_RETURN(area_index < _area_objs.size(), false, "Invalid area index(%d)", area_index);
+    ESP_UTILS_CHECK_FALSE_RETURN(_id_icon_map.find(id) == _id_icon_map.end(), false, "Icon id(%d) exists", id);
+
+    IconPool::ItemPtr icon = _icon_pool->acquire();
     ESP_UTILS_CHECK_NULL_RETURN(icon, false, "Alloc icon failed");
 
-    ESP_UTILS_CHECK_FALSE_RETURN(icon->begin(_system_context, _area_objs[area_index].get()), false, "Init icon failed");
+    ESP_UTILS_CHECK_FALSE_RETURN(icon->setData(data, _area_objs[area_index].get()), false, "Init icon failed");
 
-    auto ret = _id_icon_map.insert(pair <int, shared_ptr<StatusBarIcon>> (id, icon));
+    auto ret = _id_icon_map.emplace(id, std::move(icon));
     ESP_UTILS_CHECK_FALSE_RETURN(ret.second, false, "Insert icon failed");
 
     return true;
@@ -141,14 +163,14 @@ bool StatusBar::removeIcon(int id)
 
 bool StatusBar::setIconState(int id, int state) const
 {
-    shared_ptr<StatusBarIcon> icon = nullptr;
+    StatusBarIcon *icon = nullptr;
 
     ESP_UTILS_LOGD("Set icon(%d) state(%d)", id, state);
 
     auto ret = _id_icon_map.find(id);
     ESP_UTILS_CHECK_FALSE_RETURN(ret != _id_icon_map.end(), false, "Icon not found");
 
-    icon = ret->second;
+    icon = ret->second.get();
     ESP_UTILS_CHECK_NULL_RETURN(icon, false, "Found invalid icon");
 
     ESP_UTILS_CHECK_FALSE_RETURN(icon->setCurrentState(state), false, "Set icon state failed");
@@ -335,6 +357,13 @@ bool StatusBar::updateMainByNewData(void)
     lv_obj_set_style_text_opa(_main_obj.get(), _data.main.text_color.opacity, 0);
     lv_obj_set_style_bg_color(_main_obj.get(), lv_color_hex(_data.main.background_color.color), 0);
     lv_obj_set_style_bg_opa(_main_obj.get(), _data.main.background_color.opacity, 0);
+    // The digits of the clock and the battery percent are images, render them with the new text style
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        _digit_atlas.update(
+            (lv_font_t *)_data.main.text_font.font_resource, lv_color_hex(_data.main.text_color.color),
+            _data.main.text_color.opacity
+        ), false, "Update digit atlas failed"
+    );
 
     lv_flex_align_t main_align = LV_FLEX_ALIGN_START;
     for (size_t i = 0; i < _area_objs.size(); i++) {
@@ -379,16 +408,37 @@ bool StatusBar::delMain(void)
 bool StatusBar::beginBattery(void)
 {
     ESP_Brookesia_LvObj_t battery_label = nullptr;
+    ESP_Brookesia_LvObj_t battery_percent_sign_label = nullptr;
+    unique_ptr<StatusBarDigitStrip> battery_percent_strip = nullptr;
 
     ESP_UTILS_LOGD("Begin battery(0x%p)", this);
     ESP_UTILS_CHECK_FALSE_RETURN(!checkBatteryInitialized(), false, "Already initialized");
 
     if (_data.flags.enable_battery_label) {
-        battery_label = ESP_BROOKESIA_LV_OBJ(label, _area_objs[_data.battery.area_index].get());
+        // The battery label is a "100" digit strip and a "%" label
+        battery_label = ESP_BROOKESIA_LV_OBJ(obj, _area_objs[_data.battery.area_index].get());
         ESP_UTILS_CHECK_NULL_RETURN(battery_label, false, "Create battery label failed");
+        battery_percent_strip = make_unique<StatusBarDigitStrip>(_digit_atlas);
+        ESP_UTILS_CHECK_NULL_RETURN(battery_percent_strip, false, "Alloc battery percent strip failed");
+        ESP_UTILS_CHECK_FALSE_RETURN(
+            battery_percent_strip->begin(_system_context, battery_label.get(), 3), false,
+            "Begin battery percent strip failed"
+        );
+        battery_percent_sign_label = ESP_BROOKESIA_LV_OBJ(label, battery_label.get());
+        ESP_UTILS_CHECK_NULL_RETURN(battery_percent_sign_label, false, "Create battery percent sign label failed");
 
         lv_obj_add_style(battery_label.get(), _system_context.getDisplay().getCoreContainerStyle(), 0);
+        lv_obj_set_size(battery_label.get(), LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+        lv_obj_set_flex_flow(battery_label.get(), LV_FLEX_FLOW_ROW);
+        lv_obj_set_flex_align(battery_label.get(), LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+        lv_obj_set_style_pad_column(battery_label.get(), 0, 0);
+        lv_obj_clear_flag(battery_label.get(), LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_add_style(battery_percent_sign_label.get(), _system_context.getDisplay().getCoreContainerStyle(), 0);
+        lv_label_set_text(battery_percent_sign_label.get(), "%");
+
         _battery_label = battery_label;
+        _battery_percent_sign_label = battery_percent_sign_label;
+        _battery_percent_strip = std::move(battery_percent_strip);
     }
     if (_data.flags.enable_battery_icon) {
         ESP_UTILS_CHECK_FALSE_RETURN(addIcon(_data.battery.icon_data, _data.battery.area_index, _battery_id), false,
@@ -424,8 +474,13 @@ bool StatusBar::updateBatteryByNewData(void)
             lv_obj_add_flag(_battery_label.get(), LV_OBJ_FLAG_HIDDEN);
             ESP_UTILS_LOGE("Battery label out of area, hide it");
         } else {
-            lv_obj_set_style_text_color(_battery_label.get(), lv_color_hex(_data.main.text_color.color), 0);
-            lv_obj_set_style_text_opa(_battery_label.get(), _data.main.text_color.opacity, 0);
+            ESP_UTILS_CHECK_FALSE_RETURN(
+                _battery_percent_strip->updateByNewData(), false, "Update battery percent strip failed"
+            );
+            lv_obj_set_style_text_color(
+                _battery_percent_sign_label.get(), lv_color_hex(_data.main.text_color.color), 0
+            );
+            lv_obj_set_style_text_opa(_battery_percent_sign_label.get(), _data.main.text_color.opacity, 0);
         }
     }
 
@@ -443,7 +498,11 @@ bool StatusBar::delBattery(void)
     if (checkMainInitialized() && _id_icon_map.find(_battery_id) != _id_icon_map.end()) {
         ESP_UTILS_CHECK_FALSE_RETURN(removeIcon(_battery_id), false, "Remove battery icon failed");
     }
+    // The strip must be deleted before its parent
+    _battery_percent_strip.reset();
+    _battery_percent_sign_label.reset();
     _battery_label.reset();
+    _battery_percent = -1;
     _is_battery_initialed = false;
 
     return true;
@@ -454,15 +513,28 @@ bool StatusBar::setBatteryPercent(bool charge_flag, int percent) const
     ESP_UTILS_LOGD("Set battery percent(0x%p: %d%%)", this, percent);
 
     percent = max(min(percent, 100), 1);
-    if (_data.flags.enable_battery_label && (_battery_label != nullptr)) {
-        lv_label_set_text_fmt(_battery_label.get(), "%d%%", percent);
+    if (_data.flags.enable_battery_label && (_battery_percent_strip != nullptr) && (_battery_percent != percent)) {
+        ESP_UTILS_CHECK_FALSE_RETURN(
+            _battery_percent_strip->setValue(percent, false), false, "Set battery percent strip failed"
+        );
+        _battery_percent = percent;
     }
 
     if (_data.flags.enable_battery_icon) {
         if (charge_flag) {
             _battery_state = 4;
         } else {
-            _battery_state = (int)((percent - 1) / 25);
+            int state = (int)((percent - 1) / 25);
+            // Keep the current level until the percent is beyond its range by the hysteresis
+            if ((_battery_state >= 0) && (_battery_state < 4) && (state != _battery_state)) {
+                int state_percent_min = _battery_state * 25 + 1;
+                int state_percent_max = state_percent_min + 24;
+                if ((percent >= state_percent_min - ESP_BROOKESIA_PHONE_STATUS_BAR_BATTERY_HYSTERESIS_PERCENT) &&
+                        (percent <= state_percent_max + ESP_BROOKESIA_PHONE_STATUS_BAR_BATTERY_HYSTERESIS_PERCENT)) {
+                    state = _battery_state;
+                }
+            }
+            _battery_state = state;
         }
         ESP_UTILS_CHECK_FALSE_RETURN(setIconState(_battery_id, _battery_state), false, "Set battery icon state failed");
     }
@@ -508,44 +580,102 @@ bool StatusBar::hideBatteryIcon(void) const
 
 bool StatusBar::beginWifi(void)
 {
+    ESP_Brookesia_LvTimer_t wifi_update_timer = nullptr;
+
     ESP_UTILS_LOGD("Begin wifi(0x%p)", this);
 
     ESP_UTILS_CHECK_FALSE_RETURN(addIcon(_data.wifi.icon_data, _data.wifi.area_index, _wifi_id), false,
                                  "Add wifi icon failed");
+
+    wifi_update_timer = ESP_BROOKESIA_LV_TIMER(
+                            onWifiUpdateTimerCallback, ESP_BROOKESIA_PHONE_STATUS_BAR_WIFI_UPDATE_INTERVAL_MS, this
+                        );
+    ESP_UTILS_CHECK_NULL_GOTO(wifi_update_timer, err, "Create wifi update timer failed");
+    lv_timer_pause(wifi_update_timer.get());
+    _wifi_update_timer = wifi_update_timer;
+
     ESP_UTILS_CHECK_FALSE_GOTO(setWifiIconState(0), err, "Set wifi state failed");
 
     return true;
 
 err:
-    ESP_UTILS_CHECK_FALSE_RETURN(removeIcon(_wifi_id), false, "Delete wifi failed");
+    ESP_UTILS_CHECK_FALSE_RETURN(delWifi(), false, "Delete wifi failed");
 
     return false;
 }
 
+bool StatusBar::delWifi(void)
+{
+    ESP_UTILS_LOGD("Delete wifi(0x%p)", this);
+
+    if (checkMainInitialized() && _id_icon_map.find(_wifi_id) != _id_icon_map.end()) {
+        ESP_UTILS_CHECK_FALSE_RETURN(removeIcon(_wifi_id), false, "Remove wifi icon failed");
+    }
+    _wifi_update_timer.reset();
+    _wifi_state = -1;
+    _wifi_pending_state = -1;
+
+    return true;
+}
+
 bool StatusBar::setWifiIconState(int state) const
 {
     ESP_UTILS_LOGD("Set wifi icon state(0x%p: %d)", this, state);
-    ESP_UTILS_CHECK_FALSE_RETURN(setIconState(_wifi_id, state), false, "Set wifi icon state failed");
+
+    // Only the changes between the signal levels are throttled, the connection changes are shown at once
+    bool is_signal_change = (_wifi_state > static_cast<int>(WifiState::DISCONNECTED)) &&
+                            (state > static_cast<int>(WifiState::DISCONNECTED)) && (state != _wifi_state);
+    uint32_t elapsed = lv_tick_elaps(_wifi_state_tick);
+    if (is_signal_change && (_wifi_update_timer != nullptr) &&
+            (elapsed < ESP_BROOKESIA_PHONE_STATUS_BAR_WIFI_UPDATE_INTERVAL_MS)) {
+        ESP_UTILS_LOGD("Delay wifi icon state(%d)", state);
+        if (_wifi_pending_state < 0) {
+            lv_timer_set_period(_wifi_update_timer.get(), ESP_BROOKESIA_PHONE_STATUS_BAR_WIFI_UPDATE_INTERVAL_MS - elapsed);
+            lv_timer_reset(_wifi_update_timer.get());
+            lv_timer_resume(_wifi_update_timer.get());
+        }
+        _wifi_pending_state = state;
+
+        return true;
+    }
+
+    ESP_UTILS_CHECK_FALSE_RETURN(applyWifiIconState(state), false, "Apply wifi icon state failed");
 
     return true;
 }
 
 bool StatusBar::setWifiIconState(WifiState state) const
 {
-    ESP_UTILS_LOGD("Set wifi icon state(0x%p: %d)", this, static_cast<int>(state));
     ESP_UTILS_CHECK_FALSE_RETURN(
-        setIconState(_wifi_id, static_cast<int>(state)), false, "Set wifi icon state failed"
+        setWifiIconState(static_cast<int>(state)), false, "Set wifi icon state failed"
     );
 
     return true;
 }
 
+bool StatusBar::applyWifiIconState(int state) const
+{
+    ESP_UTILS_LOGD("Apply wifi icon state(0x%p: %d)", this, state);
+
+    if (_wifi_pending_state >= 0) {
+        _wifi_pending_state = -1;
+        lv_timer_pause(_wifi_update_timer.get());
+    }
+    if (state != _wifi_state) {
+        _wifi_state_tick = lv_tick_get();
+    }
+    _wifi_state = state;
+    ESP_UTILS_CHECK_FALSE_RETURN(setIconState(_wifi_id, state), false, "Set wifi icon state failed");
+
+    return true;
+}
+
 bool StatusBar::beginClock(void)
 {
     ESP_Brookesia_LvObj_t clock_obj = nullptr;
-    ESP_Brookesia_LvObj_t clock_hour_label = nullptr;
+    unique_ptr<StatusBarDigitStrip> clock_hour_strip = nullptr;
     ESP_Brookesia_LvObj_t clock_dot_label = nullptr;
-    ESP_Brookesia_LvObj_t clock_min_label = nullptr;
+    unique_ptr<StatusBarDigitStrip> clock_min_strip = nullptr;
     ESP_Brookesia_LvObj_t clock_period_label = nullptr;
 
     ESP_UTILS_LOGD("Begin clock(0x%p)", this);
@@ -555,18 +685,22 @@ bool StatusBar::beginClock(void)
     clock_obj = ESP_BROOKESIA_LV_OBJ(obj, _area_objs[_data.clock.area_index].get());
     ESP_UTILS_CHECK_NULL_RETURN(clock_obj, false, "Alloc clock object failed");
 
-    clock_hour_label = ESP_BROOKESIA_LV_OBJ(label, clock_obj.get());
-    ESP_UTILS_CHECK_NULL_RETURN(clock_hour_label, false, "Alloc clock hour label failed");
-    lv_obj_add_style(clock_hour_label.get(), _system_context.getDisplay().getCoreContainerStyle(), 0);
+    clock_hour_strip = make_unique<StatusBarDigitStrip>(_digit_atlas);
+    ESP_UTILS_CHECK_NULL_RETURN(clock_hour_strip, false, "Alloc clock hour strip failed");
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        clock_hour_strip->begin(_system_context, clock_obj.get(), 2), false, "Begin clock hour strip failed"
+    );
 
     clock_dot_label = ESP_BROOKESIA_LV_OBJ(label, clock_obj.get());
     ESP_UTILS_CHECK_NULL_RETURN(clock_dot_label, false, "Alloc clock dot label failed");
     lv_obj_add_style(clock_dot_label.get(), _system_context.getDisplay().getCoreContainerStyle(), 0);
     lv_label_set_text(clock_dot_label.get(), ":");
 
-    clock_min_label = ESP_BROOKESIA_LV_OBJ(label, clock_obj.get());
-    ESP_UTILS_CHECK_NULL_RETURN(clock_min_label, false, "Alloc clock min label failed");
-    lv_obj_add_style(clock_min_label.get(), _system_context.getDisplay().getCoreContainerStyle(), 0);
+    clock_min_strip = make_unique<StatusBarDigitStrip>(_digit_atlas);
+    ESP_UTILS_CHECK_NULL_RETURN(clock_min_strip, false, "Alloc clock min strip failed");
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        clock_min_strip->begin(_system_context, clock_obj.get(), 2), false, "Begin clock min strip failed"
+    );
 
     clock_period_label = ESP_BROOKESIA_LV_OBJ(label, clock_obj.get());
     ESP_UTILS_CHECK_NULL_RETURN(clock_period_label, false, "Alloc clock period label failed");
@@ -581,9 +715,9 @@ bool StatusBar::beginClock(void)
     lv_obj_clear_flag(clock_obj.get(), LV_OBJ_FLAG_SCROLLABLE);
 
     _clock_obj = clock_obj;
-    _clock_hour_label = clock_hour_label;
+    _clock_hour_strip = std::move(clock_hour_strip);
     _clock_dot_label = clock_dot_label;
-    _clock_min_label = clock_min_label;
+    _clock_min_strip = std::move(clock_min_strip);
     _clock_period_label = clock_period_label;
 
     ESP_UTILS_CHECK_FALSE_GOTO(updateClockByNewData(), err, "Update clock style failed");
@@ -612,10 +746,8 @@ bool StatusBar::updateClockByNewData(void)
         lv_obj_add_flag(_clock_obj.get(), LV_OBJ_FLAG_HIDDEN);
         ESP_UTILS_LOGE("Clock out of area, hide it");
     } else {
-        lv_obj_set_style_text_color(_clock_hour_label.get(), lv_color_hex(_data.main.text_color.color), 0);
-        lv_obj_set_style_text_opa(_clock_hour_label.get(), _data.main.text_color.opacity, 0);
-        lv_obj_set_style_text_color(_clock_min_label.get(), lv_color_hex(_data.main.text_color.color), 0);
-        lv_obj_set_style_text_opa(_clock_min_label.get(), _data.main.text_color.opacity, 0);
+        ESP_UTILS_CHECK_FALSE_RETURN(_clock_hour_strip->updateByNewData(), false, "Update clock hour strip failed");
+        ESP_UTILS_CHECK_FALSE_RETURN(_clock_min_strip->updateByNewData(), false, "Update clock min strip failed");
         lv_obj_set_style_text_color(_clock_dot_label.get(), lv_color_hex(_data.main.text_color.color), 0);
         lv_obj_set_style_text_opa(_clock_dot_label.get(), _data.main.text_color.opacity, 0);
         lv_obj_set_style_text_color(_clock_period_label.get(), lv_color_hex(_data.main.text_color.color), 0);
@@ -633,10 +765,11 @@ bool StatusBar::delClock(void)
         return true;
     }
 
+    // The strips must be deleted before their parent
+    _clock_hour_strip.reset();
+    _clock_min_strip.reset();
     _clock_obj.reset();
-    _clock_hour_label.reset();
     _clock_dot_label.reset();
-    _clock_min_label.reset();
     _clock_period_label.reset();
 
     return true;
@@ -680,11 +813,11 @@ bool StatusBar::setClock(int hour, int minute, bool is_pm) const
                 hour = 12;
             }
         }
-        lv_label_set_text_fmt(_clock_hour_label.get(), "%02d", hour);
+        ESP_UTILS_CHECK_FALSE_RETURN(_clock_hour_strip->setValue(hour, true), false, "Set clock hour failed");
     }
     if (_clock_min != minute) {
         _clock_min = minute;
-        lv_label_set_text_fmt(_clock_min_label.get(), "%02d", minute);
+        ESP_UTILS_CHECK_FALSE_RETURN(_clock_min_strip->setValue(minute, true), false, "Set clock min failed");
     }
     if (_clock_format == ClockFormat::FORMAT_12H) {
         lv_label_set_text(_clock_period_label.get(), is_pm ? " PM " : " AM ");
@@ -733,4 +866,22 @@ void StatusBar::onDataUpdateEventCallback(lv_event_t *event)
     }
 }
 
+void StatusBar::onWifiUpdateTimerCallback(lv_timer_t *t)
+{
+    StatusBar *status_bar = nullptr;
+
+    ESP_UTILS_CHECK_NULL_EXIT(t, "Invalid timer object");
+
+    ESP_UTILS_LOGD("Wifi update timer callback");
+    status_bar = (StatusBar *)lv_timer_get_user_data(t);
+    ESP_UTILS_CHECK_NULL_EXIT(status_bar, "Invalid status bar object");
+
+    if (status_bar->_wifi_pending_state >= 0) {
+        ESP_UTILS_CHECK_FALSE_EXIT(
+            status_bar->applyWifiIconState(status_bar->_wifi_pending_state), "Apply wifi icon state failed"
+        );
+    }
+    lv_timer_pause(t);
+}
+
 } // namespace esp_brookesia::systems::phone
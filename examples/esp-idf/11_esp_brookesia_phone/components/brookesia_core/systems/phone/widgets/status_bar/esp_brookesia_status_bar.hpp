@@ -11,7 +11,9 @@
 #include <map>
 #include "systems/base/esp_brookesia_base_context.hpp"
 #include "lvgl/esp_brookesia_lv_helper.hpp"
+#include "lvgl/esp_brookesia_lv_object_pool.hpp"
 #include "esp_brookesia_status_bar_icon.hpp"
+#include "esp_brookesia_status_bar_digit_strip.hpp"
 
 namespace esp_brookesia::systems::phone {
 
@@ -19,6 +21,8 @@ class StatusBar {
 public:
     static constexpr int AREA_NUM_MAX = 3;
 
+    using IconPool = gui::LvObjectPool<StatusBarIcon>;
+
     enum class AreaAlign {
         UNKNOWN = 0,
         START,
@@ -114,6 +118,10 @@ public:
     bool setClock(int hour, int min) const;
 
     bool checkVisible(void) const;
+    const IconPool *getIconPool(void) const
+    {
+        return _icon_pool.get();
+    }
 
     static bool calibrateIconData(const Data &bar_data, const base::Display &display,
                                   StatusBarIcon::Data &icon_data);
@@ -138,6 +146,8 @@ private:
     }
 
     bool beginWifi(void);
+    bool delWifi(void);
+    bool applyWifiIconState(int state) const;
 
     bool beginClock(void);
     bool updateClockByNewData(void);
@@ -149,6 +159,7 @@ private:
 
 
     static void onDataUpdateEventCallback(lv_event_t *event);
+    static void onWifiUpdateTimerCallback(lv_timer_t *t);
 
     // Core
     base::Context &_system_context;
@@ -156,24 +167,33 @@ private:
     // Main
     ESP_Brookesia_LvObj_t _main_obj;
     std::vector<ESP_Brookesia_LvObj_t> _area_objs;
-    std::map <int, std::shared_ptr<StatusBarIcon>> _id_icon_map;
+    std::unique_ptr<IconPool> _icon_pool;
+    std::map <int, IconPool::ItemPtr> _id_icon_map;
+    StatusBarDigitAtlas _digit_atlas;
     // Battery
     int _battery_id = -1;
     bool _is_battery_initialed = false;
     mutable int _battery_state = -1;
+    mutable int _battery_percent = -1;
     bool _is_battery_lable_out_of_area = false;
     ESP_Brookesia_LvObj_t _battery_label;
+    ESP_Brookesia_LvObj_t _battery_percent_sign_label;
+    std::unique_ptr<StatusBarDigitStrip> _battery_percent_strip;
     // Wifi
     int _wifi_id = -1;
+    mutable int _wifi_state = -1;
+    mutable int _wifi_pending_state = -1;
+    mutable uint32_t _wifi_state_tick = 0;
+    ESP_Brookesia_LvTimer_t _wifi_update_timer;
     // Clock
     mutable int _clock_hour = -1;
     mutable int _clock_min = -1;
     mutable ClockFormat _clock_format = ClockFormat::FORMAT_24H;
     bool _is_clock_out_of_area = false;
     ESP_Brookesia_LvObj_t _clock_obj;
-    ESP_Brookesia_LvObj_t _clock_hour_label;
+    std::unique_ptr<StatusBarDigitStrip> _clock_hour_strip;
     ESP_Brookesia_LvObj_t _clock_dot_label;
-    ESP_Brookesia_LvObj_t _clock_min_label;
+    std::unique_ptr<StatusBarDigitStrip> _clock_min_strip;
     ESP_Brookesia_LvObj_t _clock_period_label;
 };
 
@@ -0,0 +1,228 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>
+#include "esp_brookesia_systems_internal.h"
+#if !ESP_BROOKESIA_PHONE_STATUS_BAR_ENABLE_DEBUG_LOG
+#   define ESP_BROOKESIA_UTILS_DISABLE_DEBUG_LOG
+#endif
+#include "phone/private/esp_brookesia_phone_utils.hpp"
+#include "esp_brookesia_status_bar_digit_strip.hpp"
+
+using namespace std;
+using namespace esp_brookesia::gui;
+
+namespace esp_brookesia::systems::phone {
+
+StatusBarDigitAtlas::~StatusBarDigitAtlas()
+{
+    del();
+}
+
+bool StatusBarDigitAtlas::update(const lv_font_t *font, lv_color_t color, lv_opa_t opa)
+{
+    static const char *const digit_texts[DIGIT_NUM] = {"0", "1", "2", "3", "4", "5", "6", "7", "8", "9"};
+    int cell_width = 0;
+    int cell_height = 0;
+
+    ESP_UTILS_LOGD("Update digit atlas(@0x%p)", this);
+    ESP_UTILS_CHECK_NULL_RETURN(font, false, "Invalid font");
+
+    // All the cells have the width of the widest digit, so the number does not move when a digit changes
+    for (int i = 0; i < DIGIT_NUM; i++) {
+        cell_width = max<int>(cell_width, lv_font_get_glyph_width(font, '0' + i, 0));
+    }
+    cell_height = lv_font_get_line_height(font);
+    ESP_UTILS_CHECK_FALSE_RETURN((cell_width > 0) && (cell_height > 0), false, "Invalid digit size");
+
+    lv_draw_buf_t *draw_buf = lv_draw_buf_create(
+                                  cell_width, cell_height * DIGIT_NUM, LV_COLOR_FORMAT_ARGB8888, LV_STRIDE_AUTO
+                              );
+    ESP_UTILS_CHECK_NULL_RETURN(draw_buf, false, "Create draw buffer failed");
+    lv_draw_buf_clear(draw_buf, nullptr);
+
+    lv_layer_t layer;
+    initLvBufferLayer(&layer, draw_buf);
+    lv_draw_label_dsc_t label_dsc;
+    lv_draw_label_dsc_init(&label_dsc);
+    label_dsc.font = font;
+    label_dsc.color = color;
+    label_dsc.opa = opa;
+    label_dsc.align = LV_TEXT_ALIGN_CENTER;
+    for (int i = 0; i < DIGIT_NUM; i++) {
+        lv_area_t cell_area = {0, i * cell_height, cell_width - 1, (i + 1) * cell_height - 1};
+        label_dsc.text = digit_texts[i];
+        lv_draw_label(&layer, &label_dsc, &cell_area);
+    }
+    if (!finishLvBufferLayer(&layer)) {
+        lv_draw_buf_destroy(draw_buf);
+        ESP_UTILS_CHECK_FALSE_RETURN(false, false, "Draw digits failed");
+    }
+
+    del();
+    _draw_buf = draw_buf;
+    _cell_width = cell_width;
+    _cell_height = cell_height;
+    for (int i = 0; i < DIGIT_NUM; i++) {
+        lv_image_dsc_t &image = _digit_images[i];
+        image = {};
+        image.header.magic = LV_IMAGE_HEADER_MAGIC;
+        image.header.cf = LV_COLOR_FORMAT_ARGB8888;
+        image.header.w = cell_width;
+        image.header.h = cell_height;
+        image.header.stride = draw_buf->header.stride;
+        image.data_size = draw_buf->header.stride * cell_height;
+        image.data = draw_buf->data + i * image.data_size;
+    }
+
+    return true;
+}
+
+void StatusBarDigitAtlas::del(void)
+{
+    if (_draw_buf == nullptr) {
+        return;
+    }
+
+    // The LVGL image cache may still have the old digits
+    for (auto &image : _digit_images) {
+        lv_image_cache_drop(&image);
+    }
+    lv_draw_buf_destroy(_draw_buf);
+    _draw_buf = nullptr;
+}
+
+StatusBarDigitStrip::StatusBarDigitStrip(const StatusBarDigitAtlas &atlas):
+    _atlas(atlas)
+{
+}
+
+StatusBarDigitStrip::~StatusBarDigitStrip()
+{
+    ESP_UTILS_LOGD("Destroy(@0x%p)", this);
+    if (!del()) {
+        ESP_UTILS_LOGE("Delete failed");
+    }
+}
+
+bool StatusBarDigitStrip::begin(base::Context &core, lv_obj_t *parent, int cell_num)
+{
+    gui::LvObjSharedPtr main_obj = nullptr;
+    vector<gui::LvObjSharedPtr> cell_objs;
+
+    ESP_UTILS_LOGD("Begin(@0x%p)", this);
+    ESP_UTILS_CHECK_NULL_RETURN(parent, false, "Invalid parent");
+    ESP_UTILS_CHECK_FALSE_RETURN(cell_num > 0, false, "Invalid cell number");
+    ESP_UTILS_CHECK_FALSE_RETURN(!checkInitialized(), false, "Already initialized");
+
+    /* Create objects */
+    main_obj = ESP_BROOKESIA_LV_OBJ(obj, parent);
+    ESP_UTILS_CHECK_NULL_RETURN(main_obj, false, "Create main object failed");
+    for (int i = 0; i < cell_num; i++) {
+        gui::LvObjSharedPtr cell_obj = ESP_BROOKESIA_LV_OBJ(image, main_obj.get());
+        ESP_UTILS_CHECK_NULL_RETURN(cell_obj, false, "Create cell(%d) failed", i);
+        cell_objs.push_back(cell_obj);
+    }
+
+    /* Setup objects style */
+    lv_obj_add_style(main_obj.get(), core.getDisplay().getCoreContainerStyle(), 0);
+    lv_obj_set_size(main_obj.get(), LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+    lv_obj_set_flex_flow(main_obj.get(), LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(main_obj.get(), LV_FLEX_ALIGN_END, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_style_pad_column(main_obj.get(), 0, 0);
+    lv_obj_clear_flag(main_obj.get(), LV_OBJ_FLAG_SCROLLABLE);
+    for (auto &cell_obj : cell_objs) {
+        lv_obj_add_style(cell_obj.get(), core.getDisplay().getCoreContainerStyle(), 0);
+        lv_obj_add_flag(cell_obj.get(), LV_OBJ_FLAG_HIDDEN);
+    }
+
+    /* Save objects */
+    _main_obj = main_obj;
+    _cell_objs = cell_objs;
+    _cell_digits.assign(cell_num, CELL_BLANK);
+
+    ESP_UTILS_CHECK_FALSE_GOTO(updateByNewData(), err, "Update failed");
+
+    return true;
+
+err:
+    ESP_UTILS_CHECK_FALSE_RETURN(del(), false, "Delete failed");
+
+    return false;
+}
+
+bool StatusBarDigitStrip::del(void)
+{
+    ESP_UTILS_LOGD("Delete(@0x%p)", this);
+
+    if (!checkInitialized()) {
+        return true;
+    }
+
+    _main_obj.reset();
+    _cell_objs.clear();
+    _cell_digits.clear();
+
+    return true;
+}
+
+bool StatusBarDigitStrip::setValue(int value, bool zero_padding)
+{
+    ESP_UTILS_LOGD("Set value(%d)", value);
+    ESP_UTILS_CHECK_FALSE_RETURN(checkInitialized(), false, "Not initialized");
+    ESP_UTILS_CHECK_FALSE_RETURN(value >= 0, false, "Invalid value(%d)", value);
+
+    // Fill the cells from the last one, only the cells whose digit changed are redrawn
+    for (int i = _cell_objs.size() - 1; i >= 0; i--) {
+        int digit = value % 10;
+        if ((value == 0) && !zero_padding && (i != (int)_cell_objs.size() - 1)) {
+            digit = CELL_BLANK;
+        }
+        ESP_UTILS_CHECK_FALSE_RETURN(setCellDigit(i, digit), false, "Set cell(%d) failed", i);
+        value /= 10;
+    }
+
+    return true;
+}
+
+bool StatusBarDigitStrip::updateByNewData(void)
+{
+    ESP_UTILS_LOGD("Update(@0x%p)", this);
+    ESP_UTILS_CHECK_FALSE_RETURN(checkInitialized(), false, "Not initialized");
+    ESP_UTILS_CHECK_FALSE_RETURN(_atlas.checkInitialized(), false, "Atlas is not initialized");
+
+    for (size_t i = 0; i < _cell_objs.size(); i++) {
+        lv_obj_set_size(_cell_objs[i].get(), _atlas.getCellWidth(), _atlas.getCellHeight());
+        // The images are at the same addresses, set them again to load the new digits
+        if (_cell_digits[i] != CELL_BLANK) {
+            lv_image_set_src(_cell_objs[i].get(), _atlas.getDigitImage(_cell_digits[i]));
+        }
+    }
+
+    return true;
+}
+
+bool StatusBarDigitStrip::setCellDigit(size_t index, int digit)
+{
+    lv_obj_t *cell_obj = _cell_objs[index].get();
+
+    if (_cell_digits[index] == digit) {
+        return true;
+    }
+
+    if (digit == CELL_BLANK) {
+        lv_obj_add_flag(cell_obj, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_image_set_src(cell_obj, _atlas.getDigitImage(digit));
+        if (_cell_digits[index] == CELL_BLANK) {
+            lv_obj_clear_flag(cell_obj, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+    _cell_digits[index] = digit;
+
+    return true;
+}
+
+} // namespace esp_brookesia::systems::phone
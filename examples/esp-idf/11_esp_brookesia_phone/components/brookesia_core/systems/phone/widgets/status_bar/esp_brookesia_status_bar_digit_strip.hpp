@@ -0,0 +1,106 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <array>
+#include <vector>
+#include "systems/base/esp_brookesia_base_context.hpp"
+#include "lvgl/esp_brookesia_lv_helper.hpp"
+
+namespace esp_brookesia::systems::phone {
+
+/**
+ * @brief The glyphs `0` to `9` of a font, rendered once into one ARGB8888 buffer. The digits are stacked vertically
+ *        in cells of the same size, so each of them is an image which points into the buffer.
+ */
+class StatusBarDigitAtlas {
+public:
+    static constexpr int DIGIT_NUM = 10;
+
+    StatusBarDigitAtlas() = default;
+    ~StatusBarDigitAtlas();
+
+    StatusBarDigitAtlas(const StatusBarDigitAtlas &) = delete;
+    StatusBarDigitAtlas &operator=(const StatusBarDigitAtlas &) = delete;
+
+    /**
+     * @brief Render the digits again. The images keep their addresses, the users must set them again.
+     */
+    bool update(const lv_font_t *font, lv_color_t color, lv_opa_t opa);
+    void del(void);
+
+    bool checkInitialized(void) const
+    {
+        return (_draw_buf != nullptr);
+    }
+    const lv_image_dsc_t *getDigitImage(int digit) const
+    {
+        return &_digit_images[digit];
+    }
+    int getCellWidth(void) const
+    {
+        return _cell_width;
+    }
+    int getCellHeight(void) const
+    {
+        return _cell_height;
+    }
+
+private:
+    lv_draw_buf_t *_draw_buf = nullptr;
+    std::array<lv_image_dsc_t, DIGIT_NUM> _digit_images = {};
+    int _cell_width = 0;
+    int _cell_height = 0;
+};
+
+/**
+ * @brief A number shown with one image per digit, taken from a `StatusBarDigitAtlas`.
+ *
+ * The cells have a fixed size, so changing a digit only redraws its cell, without a new text layout.
+ */
+class StatusBarDigitStrip {
+public:
+    StatusBarDigitStrip(const StatusBarDigitAtlas &atlas);
+    ~StatusBarDigitStrip();
+
+    StatusBarDigitStrip(const StatusBarDigitStrip &) = delete;
+    StatusBarDigitStrip &operator=(const StatusBarDigitStrip &) = delete;
+
+    bool begin(base::Context &core, lv_obj_t *parent, int cell_num);
+    bool del(void);
+
+    /**
+     * @brief Show a number, right aligned. The unused leading cells show `0` if `zero_padding` is true, else they are
+     *        hidden.
+     */
+    bool setValue(int value, bool zero_padding);
+
+    /**
+     * @brief Apply the atlas after `StatusBarDigitAtlas::update()`
+     */
+    bool updateByNewData(void);
+
+    bool checkInitialized(void) const
+    {
+        return (_main_obj != nullptr);
+    }
+    lv_obj_t *getMainObj(void) const
+    {
+        return _main_obj.get();
+    }
+
+private:
+    static constexpr int CELL_BLANK = -1;
+
+    bool setCellDigit(size_t index, int digit);
+
+    const StatusBarDigitAtlas &_atlas;
+    gui::LvObjSharedPtr _main_obj;
+    std::vector<gui::LvObjSharedPtr> _cell_objs;
+    std::vector<int> _cell_digits;
+};
+
+} // namespace esp_brookesia::systems::phone
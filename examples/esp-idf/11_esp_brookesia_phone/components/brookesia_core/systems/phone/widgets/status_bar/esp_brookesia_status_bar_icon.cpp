@@ -19,7 +19,11 @@ using namespace esp_brookesia::gui;
 namespace esp_brookesia::systems::phone {
 
 StatusBarIcon::StatusBarIcon(const StatusBarIcon::Data &data)
-    : _data(data)
+    : _data(&data)
+{
+}
+
+StatusBarIcon::StatusBarIcon()
 {
 }
 
@@ -34,8 +38,6 @@ StatusBarIcon::~StatusBarIcon()
 bool StatusBarIcon::begin(base::Context &core, lv_obj_t *parent)
 {
     ESP_Brookesia_LvObj_t main_obj = nullptr;
-    ESP_Brookesia_LvObj_t image_obj = nullptr;
-    vector<ESP_Brookesia_LvObj_t> image_objs;
 
     ESP_UTILS_LOGD("Begin(@0x%p)", this);
     ESP_UTILS_CHECK_NULL_RETURN(parent, false, "Invalid parent");
@@ -45,30 +47,23 @@ bool StatusBarIcon::begin(base::Context &core, lv_obj_t *parent)
     // Main
     main_obj = ESP_BROOKESIA_LV_OBJ(obj, parent);
     ESP_UTILS_CHECK_NULL_RETURN(main_obj, false, "Create main object failed");
-    // Image
-    for (int i = 0; i < _data.icon.image_num; i++) {
-        image_obj = ESP_BROOKESIA_LV_OBJ(img, main_obj.get());
-        ESP_UTILS_CHECK_NULL_RETURN(image_obj, false, "Create icon image[%d] failed", i);
-        image_objs.push_back(image_obj);
-    }
 
     /* Setup objects style */
     // Main
     lv_obj_add_style(main_obj.get(), core.getDisplay().getCoreContainerStyle(), 0);
     lv_obj_clear_flag(main_obj.get(), LV_OBJ_FLAG_SCROLLABLE);
-    // Image
-    for (auto &image_obj_tmp : image_objs) {
-        lv_obj_add_style(image_obj_tmp.get(), core.getDisplay().getCoreContainerStyle(), 0);
-        lv_obj_align(image_obj_tmp.get(), LV_ALIGN_CENTER, 0, 0);
-        lv_obj_set_size(image_obj_tmp.get(), LV_SIZE_CONTENT, LV_SIZE_CONTENT);
-        // lv_image_set_size_mode(image_obj_tmp.get(), LV_IMG_SIZE_MODE_REAL);
-        lv_obj_add_flag(image_obj_tmp.get(), LV_OBJ_FLAG_HIDDEN);
-    }
-    lv_obj_clear_flag(image_objs[0].get(), LV_OBJ_FLAG_HIDDEN);
 
     // Save objects
+    _core = &core;
     _main_obj = main_obj;
-    _image_objs = image_objs;
+
+    // Image
+    if (_data == nullptr) {
+        lv_obj_add_flag(_main_obj.get(), LV_OBJ_FLAG_HIDDEN);
+        return true;
+    }
+    ESP_UTILS_CHECK_FALSE_GOTO(setImageNum(_data->icon.image_num), err, "Create images failed");
+    lv_obj_clear_flag(_image_objs[0].get(), LV_OBJ_FLAG_HIDDEN);
 
     // Update style
     ESP_UTILS_CHECK_FALSE_GOTO(updateByNewData(), err, "Update failed");
@@ -89,8 +84,73 @@ bool StatusBarIcon::del(void)
         return true;
     }
 
-    _main_obj.reset();
     _image_objs.clear();
+    _main_obj.reset();
+
+    return true;
+}
+
+bool StatusBarIcon::setData(const Data &data, lv_obj_t *parent)
+{
+    ESP_UTILS_LOGD("Set data(@0x%p)", &data);
+    ESP_UTILS_CHECK_NULL_RETURN(parent, false, "Invalid parent");
+    ESP_UTILS_CHECK_FALSE_RETURN(checkInitialized(), false, "Icon is not initialized");
+
+    if (lv_obj_get_parent(_main_obj.get()) != parent) {
+        lv_obj_set_parent(_main_obj.get(), parent);
+    }
+    ESP_UTILS_CHECK_FALSE_RETURN(setImageNum(data.icon.image_num), false, "Set image number failed");
+    for (size_t i = 0; i < _image_objs.size(); i++) {
+        if (i == 0) {
+            lv_obj_clear_flag(_image_objs[i].get(), LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_add_flag(_image_objs[i].get(), LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+    // Same place as a new icon, the last one of the area
+    lv_obj_move_foreground(_main_obj.get());
+    lv_obj_clear_flag(_main_obj.get(), LV_OBJ_FLAG_HIDDEN);
+
+    _data = &data;
+    _current_state = 0;
+    _is_out_of_parent = false;
+    ESP_UTILS_CHECK_FALSE_RETURN(updateByNewData(), false, "Update failed");
+
+    return true;
+}
+
+bool StatusBarIcon::reset(void)
+{
+    ESP_UTILS_LOGD("Reset(@0x%p)", this);
+    ESP_UTILS_CHECK_FALSE_RETURN(checkInitialized(), false, "Icon is not initialized");
+
+    lv_obj_add_flag(_main_obj.get(), LV_OBJ_FLAG_HIDDEN);
+    // Don't keep the images of a closed app
+    for (auto &image_obj : _image_objs) {
+        lv_image_set_src(image_obj.get(), nullptr);
+    }
+    _data = nullptr;
+
+    return true;
+}
+
+bool StatusBarIcon::setImageNum(int num)
+{
+    ESP_UTILS_CHECK_VALUE_RETURN(num, 1, IMAGE_NUM_MAX, false, "Invalid image number");
+
+    while (static_cast<int>(_image_objs.size()) > num) {
+        _image_objs.pop_back();
+    }
+    while (static_cast<int>(_image_objs.size()) < num) {
+        ESP_Brookesia_LvObj_t image_obj = ESP_BROOKESIA_LV_OBJ(img, _main_obj.get());
+        ESP_UTILS_CHECK_NULL_RETURN(image_obj, false, "Create icon image[%d] failed", static_cast<int>(_image_objs.size()));
+        lv_obj_add_style(image_obj.get(), _core->getDisplay().getCoreContainerStyle(), 0);
+        lv_obj_align(image_obj.get(), LV_ALIGN_CENTER, 0, 0);
+        lv_obj_set_size(image_obj.get(), LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+        // lv_image_set_size_mode(image_obj.get(), LV_IMG_SIZE_MODE_REAL);
+        lv_obj_add_flag(image_obj.get(), LV_OBJ_FLAG_HIDDEN);
+        _image_objs.push_back(image_obj);
+    }
 
     return true;
 }
@@ -142,8 +202,13 @@ bool StatusBarIcon::updateByNewData(void)
     ESP_UTILS_LOGD("Update(0x%p)", this);
     ESP_UTILS_CHECK_FALSE_RETURN(checkInitialized(), false, "Icon is not initialized");
 
+    // A pooled icon without data
+    if (_data == nullptr) {
+        return true;
+    }
+
     // Update main object style
-    lv_obj_set_size(main_obj.get(), _data.size.width, _data.size.height);
+    lv_obj_set_size(main_obj.get(), _data->size.width, _data->size.height);
     if (_is_out_of_parent && _current_state >= 0) {
         _is_out_of_parent = false;
         lv_obj_clear_flag(main_obj.get(), LV_OBJ_FLAG_HIDDEN);
@@ -156,14 +221,14 @@ bool StatusBarIcon::updateByNewData(void)
 
     // Update the size of the image object
     for (int i = 0; i < image_resource_num; i++) {
-        img_dsc = (const lv_img_dsc_t *)_data.icon.images[i].resource;
+        img_dsc = (const lv_img_dsc_t *)_data->icon.images[i].resource;
         image_obj = _image_objs[i];
         lv_img_set_src(image_obj.get(), img_dsc);
-        lv_obj_set_style_img_recolor(image_obj.get(), lv_color_hex(_data.icon.images[i].recolor.color), 0);
-        lv_obj_set_style_img_recolor_opa(image_obj.get(), _data.icon.images[i].recolor.opacity, 0);
+        lv_obj_set_style_img_recolor(image_obj.get(), lv_color_hex(_data->icon.images[i].recolor.color), 0);
+        lv_obj_set_style_img_recolor_opa(image_obj.get(), _data->icon.images[i].recolor.opacity, 0);
         // Calculate the multiple of the size between the target and the image.
-        h_factor = (float)(_data.size.height) / img_dsc->header.h;
-        w_factor = (float)(_data.size.width) / img_dsc->header.w;
+        h_factor = (float)(_data->size.height) / img_dsc->header.h;
+        w_factor = (float)(_data->size.width) / img_dsc->header.w;
         // Scale the image to a suitable size.
         // So you don’t have to consider the size of the source image.
         if (h_factor < w_factor) {
@@ -32,12 +32,26 @@ public:
     StatusBarIcon &operator=(StatusBarIcon &&) = delete;
 
     StatusBarIcon(const Data &data);
+    /**
+     * @brief Create an icon without data, for a pool. It stays hidden until `setData()` is called.
+     */
+    StatusBarIcon();
     ~StatusBarIcon();
 
     bool begin(base::Context &core, lv_obj_t *parent);
     bool del(void);
     bool setCurrentState(int state);
 
+    /**
+     * @brief Bind new data and move the icon to the end of `parent`, its objects are reused
+     */
+    bool setData(const Data &data, lv_obj_t *parent);
+
+    /**
+     * @brief Hide the icon and drop its data, so it can be kept in a pool
+     */
+    bool reset(void);
+
     bool checkInitialized(void) const
     {
         return (_main_obj != nullptr);
@@ -46,7 +60,10 @@ public:
     bool updateByNewData(void);
 
 private:
-    const Data &_data;
+    bool setImageNum(int num);
+
+    base::Context *_core = nullptr;
+    const Data *_data = nullptr;
 
     bool _is_out_of_parent = false;
     int _current_state = 0;
@@ -3,7 +3,11 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
-#include <random>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include "esp_heap_caps.h"
 #include "esp_wifi.h"
 #include "esp_brookesia_systems_internal.h"
 #if !ESP_BROOKESIA_SPEAKER_AI_BUDDY_ENABLE_DEBUG_LOG
@@ -16,10 +20,15 @@
 #define AUDIO_EVENT_THREAD_STACK_SIZE           (10 * 1024)
 #define AUDIO_EVENT_THREAD_STACK_CAPS_EXT       (true)
 
-#define AUDIO_PLAY_TIMEOUT_MS                   (10 * 1000)
-#define AUDIO_PROCESS_LOOP_TIMEOUT_MS           (100)
+#define AUDIO_SCHEDULER_TICK_MS                 (50)
+#define AUDIO_SCHEDULER_SLOT_NUM                (64)
+#define AUDIO_PLAYING_CHECK_INTERVAL_MS         (10)
 #define AUDIO_PLAY_LOOP_COUNT                   (3)
 
+#define AUDIO_FILE_URL_PREFIX                   "file://"
+#define AUDIO_RAW_URL_PREFIX                    "raw://"
+#define AUDIO_DATA_MEM_CAPS                     (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+
 #define AUDIO_WIFI_NEED_CONNECT_REPEAT_INTERVAL_MS      (20 * 1000)
 #define AUDIO_WIFI_NEED_CONNECT_DELAY_MS                (10 * 1000)
 #define AUDIO_SERVER_CONNECTING_REPEAT_INTERVAL_MS      (20 * 1000)
@@ -62,6 +71,17 @@ bool AI_Buddy::begin(const Data &data)
         expression.begin(data.expression.data, &_emoji_map, &_system_icon_map), false, "Expression begin failed"
     );
 
+    AudioScheduler::Config audio_scheduler_config = {
+        .tick_ms = AUDIO_SCHEDULER_TICK_MS,
+        .slot_num = AUDIO_SCHEDULER_SLOT_NUM,
+        .event_num = static_cast<int>(AUDIO_TYPE_NUM),
+        .priority_num = static_cast<int>(AudioPriority::Max),
+    };
+    ESP_UTILS_CHECK_EXCEPTION_RETURN(
+        _audio_scheduler = std::make_unique<AudioScheduler>(audio_scheduler_config), false,
+        "New audio scheduler failed"
+    );
+
     esp_err_t ret = esp_event_loop_create_default();
     if (ret == ESP_ERR_INVALID_STATE) {
         ESP_UTILS_LOGW("Default event loop already created");
@@ -102,54 +122,7 @@ bool AI_Buddy::begin(const Data &data)
             .stack_in_ext = AUDIO_EVENT_THREAD_STACK_CAPS_EXT,
         });
         _audio_event_thread = boost::thread([this]() {
-            ESP_UTILS_LOG_TRACE_GUARD();
-
-            while (true) {
-                std::unique_lock<std::recursive_mutex> lock(_audio_event_mutex);
-                _audio_event_cv.wait_for(lock, boost::chrono::milliseconds(AUDIO_PROCESS_LOOP_TIMEOUT_MS));
-
-                if (_audio_current_process_infos.empty() && _audio_next_process_infos.empty()) {
-                    continue;
-                }
-
-                // Remove stopped audio from current process infos
-                if (!_audio_removed_process_infos.empty()) {
-                    for (auto type : _audio_removed_process_infos) {
-                        ESP_UTILS_LOGD("Remove audio: %s", getAudioName(type).c_str());
-                        _audio_current_process_infos.remove_if([type](const AudioProcessInfo & info) {
-                            return info.event.type == type;
-                        });
-                    }
-                    _audio_removed_process_infos.clear();
-                }
-
-                // Merge next process infos to current process infos
-                if (!_audio_next_process_infos.empty()) {
-                    _audio_current_process_infos.splice(_audio_current_process_infos.end(), _audio_next_process_infos);
-                }
-
-                // Process audio events
-                lock.unlock();
-                for (auto &info : _audio_current_process_infos) {
-                    if (!processAudioEvent(info)) {
-                        ESP_UTILS_LOGE("Process audio event failed");
-                    }
-                    if (!_audio_removed_process_infos.empty()) {
-                        break;
-                    }
-                }
-
-                // Remove finished audio from current process infos
-                for (auto it = _audio_current_process_infos.begin(); it != _audio_current_process_infos.end();) {
-                    auto &info = *it;
-                    if (info.event.repeat_count == 0) {
-                        ESP_UTILS_LOGI("Stop audio: %s", getAudioName(info.event.type).c_str());
-                        it = _audio_current_process_infos.erase(it);
-                    } else {
-                        it++;
-                    }
-                }
-            }
+            runAudioEventThread();
         });
     }
 
@@ -471,6 +444,24 @@ bool AI_Buddy::del()
 
     std::lock_guard lock(_mutex);
 
+    if (_audio_event_thread.joinable()) {
+        {
+            std::lock_guard audio_lock(_audio_event_mutex);
+            _audio_event_thread_exit = true;
+            _audio_event_cv.notify_all();
+        }
+        _audio_event_thread.join();
+    }
+    {
+        std::lock_guard audio_lock(_audio_event_mutex);
+        _audio_event_thread_exit = false;
+        _audio_scheduler = nullptr;
+        _audio_handles.fill(AudioScheduler::INVALID_HANDLE);
+        for (auto &audio_data : _audio_datas) {
+            audio_data = {};
+        }
+    }
+
     _flags = {};
     for (auto &connection : _agent_connections) {
         connection.disconnect();
@@ -515,11 +506,30 @@ void AI_Buddy::sendAudioEvent(const AudioEvent &event)
 {
     ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
 
-    ESP_UTILS_LOGD("Param: type(%s)", getAudioName(event.type).c_str());
+    scheduleAudio(event, 0);
+}
+
+void AI_Buddy::scheduleAudio(const AudioEvent &event, int delay_ms)
+{
+    ESP_UTILS_LOGD("Param: type(%s), delay_ms(%d)", getAudioName(event.type), delay_ms);
+
+    auto index = static_cast<size_t>(event.type);
+    ESP_UTILS_CHECK_FALSE_EXIT(index < AUDIO_TYPE_NUM, "Invalid audio type(%d)", static_cast<int>(index));
 
     std::lock_guard lock(_audio_event_mutex);
-    stopAudio(event.type);
-    _audio_next_process_infos.push_back({event, esp_timer_get_time() / 1000, 0});
+    ESP_UTILS_CHECK_NULL_EXIT(_audio_scheduler, "Audio scheduler is not created");
+
+    // An audio is only scheduled once, the new event replaces the pending one
+    _audio_scheduler->cancel(_audio_handles[index]);
+    _audio_handles[index] = _audio_scheduler->schedule({
+        .id = static_cast<int>(event.type),
+        .priority = static_cast<int>(_audio_infos[index].priority),
+        .repeat_count = event.repeat_count,
+        .repeat_interval_ms = event.repeat_interval_ms,
+    }, esp_timer_get_time() / 1000, delay_ms);
+    ESP_UTILS_CHECK_FALSE_EXIT(
+        _audio_handles[index] != AudioScheduler::INVALID_HANDLE, "Schedule audio(%s) failed", getAudioName(event.type)
+    );
     _audio_event_cv.notify_all();
 }
 
@@ -527,19 +537,167 @@ void AI_Buddy::stopAudio(AudioType type)
 {
     ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
 
-    ESP_UTILS_LOGD("Param: type(%s)", getAudioName(type).c_str());
+    ESP_UTILS_LOGD("Param: type(%s)", getAudioName(type));
+
+    auto index = static_cast<size_t>(type);
+    ESP_UTILS_CHECK_FALSE_EXIT(index < AUDIO_TYPE_NUM, "Invalid audio type(%d)", static_cast<int>(index));
 
     std::lock_guard lock(_audio_event_mutex);
-    _audio_next_process_infos.remove_if([type](const AudioProcessInfo & info) {
-        return info.event.type == type;
-    });
+    if (_audio_scheduler != nullptr) {
+        _audio_scheduler->cancel(_audio_handles[index]);
+    }
+    _audio_handles[index] = AudioScheduler::INVALID_HANDLE;
+}
 
-    auto it = std::find(_audio_removed_process_infos.begin(), _audio_removed_process_infos.end(), type);
-    if (it != _audio_removed_process_infos.end()) {
-        ESP_UTILS_LOGD("Audio type already in removed process infos: %d", static_cast<int>(type));
-        return;
+void AI_Buddy::runAudioEventThread()
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+#if ESP_BROOKESIA_SPEAKER_AI_BUDDY_PRELOAD_AUDIO
+    if (!preloadAudios()) {
+        ESP_UTILS_LOGW("Preload audios failed, play the others from files");
     }
-    _audio_removed_process_infos.push_back(type);
+#endif
+
+    // The priority of the audio which is playing. An audio played by others, such as the boot music, is never stopped
+    int playing_priority = -1;
+    std::unique_lock lock(_audio_event_mutex);
+    while (!_audio_event_thread_exit) {
+        int64_t now_ms = esp_timer_get_time() / 1000;
+        _audio_scheduler->advance(now_ms);
+
+        bool is_playing = audio_prompt_is_playing();
+        if (!is_playing) {
+            playing_priority = -1;
+        } else if (playing_priority < 0) {
+            playing_priority = std::numeric_limits<int>::max();
+        }
+
+        int ready_priority = _audio_scheduler->getReadyPriority();
+        if ((ready_priority >= 0) && (ready_priority > playing_priority)) {
+            AudioScheduler::Event event = {};
+            _audio_scheduler->takeReady(now_ms, event);
+            lock.unlock();
+
+            if (is_playing) {
+                ESP_UTILS_LOGI("Stop audio: %s", getAudioName(_audio_playing_type));
+                if (audio_prompt_stop() != ESP_OK) {
+                    ESP_UTILS_LOGW("Stop audio failed");
+                }
+            }
+            if (playAudio(static_cast<AudioType>(event.id))) {
+                playing_priority = event.priority;
+            } else {
+                ESP_UTILS_LOGE("Play audio failed");
+            }
+
+            lock.lock();
+            continue;
+        }
+
+        // If an audio waits for the playing one, check the end of the playing one often
+        int wait_ms = (ready_priority >= 0) ? AUDIO_PLAYING_CHECK_INTERVAL_MS : _audio_scheduler->getWaitTimeMs(now_ms);
+        if (wait_ms < 0) {
+            _audio_event_cv.wait(lock);
+        } else {
+            _audio_event_cv.wait_for(lock, boost::chrono::milliseconds(wait_ms));
+        }
+    }
+}
+
+bool AI_Buddy::playAudio(AudioType type)
+{
+    auto index = static_cast<size_t>(type);
+    ESP_UTILS_CHECK_FALSE_RETURN(index < AUDIO_TYPE_NUM, false, "Invalid audio type(%d)", static_cast<int>(index));
+
+    const AudioData &audio_data = _audio_datas[index];
+    ESP_UTILS_LOGI(
+        "Play audio: %s(%d ms) from %s", getAudioName(type), _audio_infos[index].duration_ms,
+        (audio_data.data != nullptr) ? "memory" : "file"
+    );
+    if (audio_data.data != nullptr) {
+        ESP_UTILS_CHECK_FALSE_RETURN(
+            audio_prompt_play_from_memory(audio_data.url.c_str(), audio_data.data.get(), audio_data.size) == ESP_OK,
+            false, "Play audio from memory failed"
+        );
+    } else {
+        ESP_UTILS_CHECK_FALSE_RETURN(audio_prompt_play(_audio_infos[index].url) == ESP_OK, false, "Play audio failed");
+    }
+    _audio_playing_type = type;
+
+    return true;
+}
+
+bool AI_Buddy::preloadAudios()
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    size_t total_size = 0;
+    for (size_t i = 0; i < AUDIO_TYPE_NUM; i++) {
+        // `file://spiffs/xxx.mp3` is the file `/spiffs/xxx.mp3`
+        const char *url = _audio_infos[i].url;
+        ESP_UTILS_CHECK_FALSE_RETURN(
+            strncmp(url, AUDIO_FILE_URL_PREFIX, strlen(AUDIO_FILE_URL_PREFIX)) == 0, false, "Invalid audio url(%s)", url
+        );
+        const char *name = url + strlen(AUDIO_FILE_URL_PREFIX);
+        std::string path = std::string("/") + name;
+
+        FILE *file = fopen(path.c_str(), "rb");
+        ESP_UTILS_CHECK_NULL_RETURN(file, false, "Open audio file(%s) failed", path.c_str());
+        esp_utils::function_guard close_function([file]() {
+            fclose(file);
+        });
+        ESP_UTILS_CHECK_FALSE_RETURN(fseek(file, 0, SEEK_END) == 0, false, "Seek audio file(%s) failed", path.c_str());
+        long size = ftell(file);
+        ESP_UTILS_CHECK_FALSE_RETURN(
+            size > 0, false, "Invalid audio file(%s) size(%d)", path.c_str(), static_cast<int>(size)
+        );
+        rewind(file);
+
+        std::unique_ptr<uint8_t, AudioDataDeleter> data(static_cast<uint8_t *>(heap_caps_malloc(size, AUDIO_DATA_MEM_CAPS)));
+        ESP_UTILS_CHECK_NULL_RETURN(data, false, "Allocate audio data(%d) failed", static_cast<int>(size));
+        ESP_UTILS_CHECK_FALSE_RETURN(
+            fread(data.get(), 1, size, file) == static_cast<size_t>(size), false, "Read audio file(%s) failed",
+            path.c_str()
+        );
+
+        _audio_datas[i] = AudioData{
+            .data = std::move(data),
+            .size = static_cast<size_t>(size),
+            .url = std::string(AUDIO_RAW_URL_PREFIX) + name,
+        };
+        total_size += size;
+    }
+    ESP_UTILS_LOGI("Preloaded %d audios(%d bytes)", static_cast<int>(AUDIO_TYPE_NUM), static_cast<int>(total_size));
+
+    return true;
+}
+
+void AI_Buddy::AudioDataDeleter::operator()(uint8_t *data) const
+{
+    heap_caps_free(data);
+}
+
+AI_Buddy::RandomAudios::RandomAudios(std::initializer_list<std::pair<float, AudioType>> audios)
+{
+    float cumulative_weight = 0.0f;
+    for (const auto &[weight, type] : audios) {
+        cumulative_weight += weight;
+        _cumulative_weights.push_back(cumulative_weight);
+        _types.push_back(type);
+    }
+}
+
+AI_Buddy::AudioType AI_Buddy::RandomAudios::pick(std::mt19937 &generator) const
+{
+    if (_types.empty()) {
+        return AudioType::Max;
+    }
+
+    std::uniform_real_distribution<float> distribution(0.0f, _cumulative_weights.back());
+    auto it = std::upper_bound(_cumulative_weights.begin(), _cumulative_weights.end(), distribution(generator));
+
+    return _types[std::min<size_t>(it - _cumulative_weights.begin(), _types.size() - 1)];
 }
 
 bool AI_Buddy::processOnWiFiEvent(int32_t event_id, void *event_data)
@@ -595,115 +753,43 @@ bool AI_Buddy::processOnIpEvent(int32_t event_id, void *event_data)
     return true;
 }
 
-bool AI_Buddy::processAudioEvent(AudioProcessInfo &info)
-{
-    // ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
-
-    auto it = _audio_file_map.find(info.event.type);
-    ESP_UTILS_CHECK_FALSE_RETURN(
-        it != _audio_file_map.end(), false, "Invalid audio type(%d)", static_cast<int>(info.event.type)
-    );
-
-    // If the audio has been played before, check if the playback interval has been reached, if not, skip playback
-    if ((info.last_play_time_ms != 0) && (info.last_play_time_ms + info.event.repeat_interval_ms) > (esp_timer_get_time() / 1000)) {
-        return true;
-    }
-
-    // If the audio is playing other audio, use the interval time of the audio as the timeout time
-    int64_t timeout_ms = 0;
-    if (_audio_playing_type != AudioType::Max) {
-        auto it_playing = _audio_file_map.find(_audio_playing_type);
-        ESP_UTILS_CHECK_FALSE_RETURN(
-            it_playing != _audio_file_map.end(), false, "Invalid audio type(%d)", static_cast<int>(_audio_playing_type)
-        );
-        timeout_ms = it_playing->second.second;
-    }
-
-    ESP_UTILS_LOGI("Play audio: %s(create_time_ms: %d, last_play_time_ms: %d) with timeout_ms: %d",
-                   getAudioName(info.event.type).c_str(), static_cast<int>(info.create_time_ms),
-                   static_cast<int>(info.last_play_time_ms), static_cast<int>(timeout_ms)
-                  );
-    ESP_UTILS_CHECK_FALSE_RETURN(
-        audio_prompt_play_with_block(it->second.first.c_str(), -1) == ESP_OK, false, "Play audio failed"
-    );
-    _audio_playing_type = info.event.type;
-
-    info.last_play_time_ms = esp_timer_get_time() / 1000;
-    if (info.event.repeat_count > 0) {
-        info.event.repeat_count--;
-    }
-
-    return true;
-}
-
 void AI_Buddy::playWiFiNeedConnectAudio()
 {
     ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
 
     if (isWiFiValid()) {
         ESP_UTILS_LOGD("WiFi is valid");
+        return;
     }
 
+    // Wait for delay time to ensure the WiFi is connected, the audio is stopped when the WiFi gets IP
     ESP_UTILS_LOGD("WiFi is not valid, play audio in %d ms", AUDIO_WIFI_NEED_CONNECT_DELAY_MS);
-    {
-        esp_utils::thread_config_guard thread_config(esp_utils::ThreadConfig{
-            .name = "wifi_check",
-            .stack_size = 4 * 1024,
-            .stack_in_ext = true,
-        });
-        boost::thread([this]() {
-            ESP_UTILS_LOG_TRACE_GUARD();
-            // Wait for delay time to ensure the WiFi is connected
-            boost::this_thread::sleep_for(boost::chrono::milliseconds(AUDIO_WIFI_NEED_CONNECT_DELAY_MS));
-            if (!isWiFiValid()) {
-                sendAudioEvent({AudioType::WifiNeedConnect, AUDIO_PLAY_LOOP_COUNT, AUDIO_WIFI_NEED_CONNECT_REPEAT_INTERVAL_MS});
-            }
-        }).detach();
-    }
+    AudioEvent event = {AudioType::WifiNeedConnect, AUDIO_PLAY_LOOP_COUNT, AUDIO_WIFI_NEED_CONNECT_REPEAT_INTERVAL_MS};
+    scheduleAudio(event, AUDIO_WIFI_NEED_CONNECT_DELAY_MS);
 }
 
 bool AI_Buddy::playRandomAudio(const RandomAudios &audios)
 {
     ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
 
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-
-    float total_probability = 0.0f;
-    for (const auto &pair : audios) {
-        total_probability += pair.first;
-    }
-
-    std::uniform_real_distribution<> dis(0.0f, total_probability);
-    float random_value = dis(gen);
-    ESP_UTILS_LOGD("Random value: %f", random_value);
-
-    float cumulative_probability = 0.0f;
     AudioType selected_audio = AudioType::Max;
-
-    for (const auto &pair : audios) {
-        cumulative_probability += pair.first;
-        if (random_value <= cumulative_probability) {
-            selected_audio = pair.second;
-            break;
-        }
+    {
+        std::lock_guard lock(_audio_event_mutex);
+        selected_audio = audios.pick(_audio_random_generator);
     }
     ESP_UTILS_CHECK_FALSE_RETURN(selected_audio != AudioType::Max, false, "Invalid audio type");
 
-    auto it = _audio_file_map.find(selected_audio);
-    ESP_UTILS_CHECK_FALSE_RETURN(it != _audio_file_map.end(), false, "Invalid audio type");
-
     sendAudioEvent({selected_audio});
 
     return true;
 }
 
-std::string AI_Buddy::getAudioName(AudioType type) const
+const char *AI_Buddy::getAudioName(AudioType type) const
 {
-    auto it = _audio_file_map.find(type);
-    ESP_UTILS_CHECK_FALSE_RETURN(it != _audio_file_map.end(), "", "Invalid audio type");
+    auto index = static_cast<size_t>(type);
+    ESP_UTILS_CHECK_FALSE_RETURN(index < AUDIO_TYPE_NUM, "", "Invalid audio type");
 
-    return it->second.first;
+    return _audio_infos[index].url;
 }
 
 } // namespace esp_brookesia::systems::speaker
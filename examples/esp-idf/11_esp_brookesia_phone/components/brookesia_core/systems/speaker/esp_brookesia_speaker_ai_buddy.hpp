@@ -5,12 +5,15 @@
  */
 #pragma once
 
+#include <array>
 #include <memory>
+#include <random>
 #include "esp_netif.h"
 #include "boost/thread.hpp"
 #include "agent/esp_brookesia_ai_agent.hpp"
 #include "expression/esp_brookesia_ai_expression.hpp"
 #include "assets/esp_brookesia_speaker_assets.h"
+#include "esp_brookesia_speaker_audio_scheduler.hpp"
 
 namespace esp_brookesia::systems::speaker {
 
@@ -111,21 +114,48 @@ public:
     void sendAudioEvent(const AudioEvent &event);
 
 private:
-    struct AudioProcessInfo {
-        AudioEvent event;
-        int64_t create_time_ms;
-        int64_t last_play_time_ms;
+    // A more urgent audio stops the one which is playing
+    enum class AudioPriority {
+        Reminder,
+        Status,
+        Response,
+        Max,
+    };
+    struct AudioInfo {
+        const char *url;
+        int duration_ms;
+        AudioPriority priority;
+    };
+    struct AudioDataDeleter {
+        void operator()(uint8_t *data) const;
+    };
+    struct AudioData {
+        std::unique_ptr<uint8_t, AudioDataDeleter> data;
+        size_t size;
+        std::string url;
     };
-    using AudioInfo = std::pair<std::string, int>;
-    using RandomAudios = std::vector<std::pair<float, AudioType>>;
+    class RandomAudios {
+    public:
+        RandomAudios(std::initializer_list<std::pair<float, AudioType>> audios);
+
+        AudioType pick(std::mt19937 &generator) const;
+
+    private:
+        std::vector<float> _cumulative_weights;
+        std::vector<AudioType> _types;
+    };
+    static constexpr size_t AUDIO_TYPE_NUM = static_cast<size_t>(AudioType::Max);
 
     AI_Buddy() = default;
 
+    void scheduleAudio(const AudioEvent &event, int delay_ms);
     void stopAudio(AudioType type);
-    bool processAudioEvent(AudioProcessInfo &info);
+    void runAudioEventThread();
+    bool playAudio(AudioType type);
+    bool preloadAudios();
     void playWiFiNeedConnectAudio();
     bool playRandomAudio(const RandomAudios &audios);
-    std::string getAudioName(AudioType type) const;
+    const char *getAudioName(AudioType type) const;
 
     bool processOnWiFiEvent(int32_t event_id, void *event_data);
     bool processOnIpEvent(int32_t event_id, void *event_data);
@@ -143,11 +173,13 @@ private:
     std::vector<boost::signals2::connection> _agent_connections;
 
     boost::thread _audio_event_thread;
-    std::vector<AudioType> _audio_removed_process_infos;
-    std::list<AudioProcessInfo> _audio_current_process_infos;
-    std::list<AudioProcessInfo> _audio_next_process_infos;
+    bool _audio_event_thread_exit = false;
+    std::unique_ptr<AudioScheduler> _audio_scheduler;
+    std::array<AudioScheduler::Handle, AUDIO_TYPE_NUM> _audio_handles = {};
+    std::array<AudioData, AUDIO_TYPE_NUM> _audio_datas = {};
     AudioType _audio_playing_type = AudioType::Max;
-    std::recursive_mutex _audio_event_mutex;
+    std::mt19937 _audio_random_generator{std::random_device{}()};
+    std::mutex _audio_event_mutex;
     boost::condition_variable_any _audio_event_cv;
 
     esp_event_handler_instance_t _wifi_event_handler = nullptr;
@@ -191,27 +223,28 @@ private:
         {"volume_up", ExpressionIconSystemVolumeUp},
         {"wifi_disconnected", ExpressionIconSystemWifiDisconnected},
     };
-    inline static std::map<AudioType, AudioInfo> _audio_file_map = {
-        {AudioType::WifiNeedConnect,      {"file://spiffs/wifi_need_connect.mp3", 4 * 1000}},
-        {AudioType::WifiConnected,        {"file://spiffs/wifi_connect_success.mp3", 2 * 1000}},
-        {AudioType::WifiDisconnected,     {"file://spiffs/wifi_disconnect.mp3", 4 * 1000}},
-        {AudioType::ServerConnected,      {"file://spiffs/server_connected.mp3", 2 * 1000}},
-        {AudioType::ServerDisconnected,   {"file://spiffs/server_disconnect.mp3", 2 * 1000}},
-        {AudioType::ServerConnecting,     {"file://spiffs/server_connecting.mp3", 3 * 1000}},
-        {AudioType::MicOn,                {"file://spiffs/mic_open.mp3", 2 * 1000}},
-        {AudioType::MicOff,               {"file://spiffs/mic_close.mp3", 5 * 1000}},
-        {AudioType::WakeUp,               {"file://spiffs/wake_up.mp3", 3 * 1000}},
-        {AudioType::ResponseLaiLo,        {"file://spiffs/response_lai_lo.mp3", 2 * 1000}},
-        {AudioType::ResponseWoZaiTingNe,  {"file://spiffs/response_wo_zai_ting_ne.mp3", 2 * 1000}},
-        {AudioType::ResponseWoZai,        {"file://spiffs/response_wo_zai.mp3", 2 * 1000}},
-        {AudioType::ResponseZaiNe,        {"file://spiffs/response_zai_ne.mp3", 1 * 1000}},
-        {AudioType::SleepBaiBaiLo,        {"file://spiffs/sleep_bai_bai_lo.mp3", 2 * 1000}},
-        {AudioType::SleepHaoDe,           {"file://spiffs/sleep_hao_de.mp3", 3 * 1000}},
-        {AudioType::SleepWoTuiXiaLe,      {"file://spiffs/sleep_wo_tui_xia_le.mp3", 2 * 1000}},
-        {AudioType::SleepXianZheYangLo,   {"file://spiffs/sleep_xian_zhe_yang_lo.mp3", 3 * 1000}},
-        {AudioType::InvalidConfig,        {"file://spiffs/invalid_config_file.mp3", 5 * 1000}},
-        {AudioType::CozeErrorInsufficientCreditsBalance, {"file://spiffs/coze_error_credits.mp3", 7 * 1000}},
-    };
+    // In the order of `AudioType`
+    inline static const std::array<AudioInfo, AUDIO_TYPE_NUM> _audio_infos = {{
+        {"file://spiffs/wifi_need_connect.mp3", 4 * 1000, AudioPriority::Reminder},        // WifiNeedConnect
+        {"file://spiffs/wifi_connect_success.mp3", 2 * 1000, AudioPriority::Status},      // WifiConnected
+        {"file://spiffs/wifi_disconnect.mp3", 4 * 1000, AudioPriority::Status},           // WifiDisconnected
+        {"file://spiffs/server_connected.mp3", 2 * 1000, AudioPriority::Status},          // ServerConnected
+        {"file://spiffs/server_disconnect.mp3", 2 * 1000, AudioPriority::Status},         // ServerDisconnected
+        {"file://spiffs/server_connecting.mp3", 3 * 1000, AudioPriority::Reminder},       // ServerConnecting
+        {"file://spiffs/mic_open.mp3", 2 * 1000, AudioPriority::Response},                // MicOn
+        {"file://spiffs/mic_close.mp3", 5 * 1000, AudioPriority::Response},               // MicOff
+        {"file://spiffs/wake_up.mp3", 3 * 1000, AudioPriority::Response},                 // WakeUp
+        {"file://spiffs/response_lai_lo.mp3", 2 * 1000, AudioPriority::Response},         // ResponseLaiLo
+        {"file://spiffs/response_wo_zai_ting_ne.mp3", 2 * 1000, AudioPriority::Response}, // ResponseWoZaiTingNe
+        {"file://spiffs/response_wo_zai.mp3", 2 * 1000, AudioPriority::Response},         // ResponseWoZai
+        {"file://spiffs/response_zai_ne.mp3", 1 * 1000, AudioPriority::Response},         // ResponseZaiNe
+        {"file://spiffs/sleep_bai_bai_lo.mp3", 2 * 1000, AudioPriority::Response},        // SleepBaiBaiLo
+        {"file://spiffs/sleep_hao_de.mp3", 3 * 1000, AudioPriority::Response},            // SleepHaoDe
+        {"file://spiffs/sleep_wo_tui_xia_le.mp3", 2 * 1000, AudioPriority::Response},     // SleepWoTuiXiaLe
+        {"file://spiffs/sleep_xian_zhe_yang_lo.mp3", 3 * 1000, AudioPriority::Response},  // SleepXianZheYangLo
+        {"file://spiffs/invalid_config_file.mp3", 5 * 1000, AudioPriority::Reminder},     // InvalidConfig
+        {"file://spiffs/coze_error_credits.mp3", 7 * 1000, AudioPriority::Reminder},      // CozeErrorInsufficientCreditsBalance
+    }};
     inline static RandomAudios _response_audios = {
         {0.25, AudioType::ResponseLaiLo},
         {0.25, AudioType::ResponseWoZaiTingNe},
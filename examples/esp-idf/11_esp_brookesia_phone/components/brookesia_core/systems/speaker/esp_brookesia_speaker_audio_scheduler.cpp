@@ -0,0 +1,270 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>
+#include <limits>
+#include "esp_brookesia_systems_internal.h"
+#if !ESP_BROOKESIA_SPEAKER_AI_BUDDY_ENABLE_DEBUG_LOG
+#   define ESP_BROOKESIA_UTILS_DISABLE_DEBUG_LOG
+#endif
+#include "private/esp_brookesia_speaker_utils.hpp"
+#include "esp_brookesia_speaker_audio_scheduler.hpp"
+
+#define HANDLE_INDEX_BITS   (16)
+#define HANDLE_INDEX_MASK   ((1U << HANDLE_INDEX_BITS) - 1)
+
+namespace esp_brookesia::systems::speaker {
+
+AudioScheduler::AudioScheduler(const Config &config)
+{
+    _tick_ms = std::max(config.tick_ms, 1);
+    _priority_num = std::clamp(config.priority_num, 1, PRIORITY_NUM_MAX);
+    if (_priority_num != config.priority_num) {
+        ESP_UTILS_LOGW("Priority number(%d) is limited to %d", config.priority_num, _priority_num);
+    }
+
+    int slot_num = 1;
+    while (slot_num < config.slot_num) {
+        slot_num <<= 1;
+    }
+    _slots.resize(slot_num);
+    _ready_lists.resize(_priority_num);
+
+    int event_num = std::clamp(config.event_num, 0, static_cast<int>(HANDLE_INDEX_MASK));
+    _entries.resize(event_num);
+    for (int i = 0; i < event_num; i++) {
+        _entries[i].next = (i + 1 < event_num) ? (i + 1) : -1;
+        _entries[i].generation = 1;
+        _entries[i].state = EntryState::Free;
+    }
+    _free_head = (event_num > 0) ? 0 : -1;
+}
+
+AudioScheduler::Handle AudioScheduler::schedule(const Event &event, int64_t now_ms, int delay_ms)
+{
+    ESP_UTILS_CHECK_FALSE_RETURN(_free_head >= 0, INVALID_HANDLE, "No free entry for event(%d)", event.id);
+
+    int index = _free_head;
+    Entry &entry = _entries[index];
+    _free_head = entry.next;
+    entry.event = event;
+    entry.event.priority = std::clamp(event.priority, 0, _priority_num - 1);
+    _pending_num++;
+    wait(index, now_ms, delay_ms);
+
+    return (static_cast<Handle>(entry.generation) << HANDLE_INDEX_BITS) | static_cast<Handle>(index);
+}
+
+bool AudioScheduler::cancel(Handle handle)
+{
+    int index = getEntryIndex(handle);
+    if (index < 0) {
+        return false;
+    }
+
+    Entry &entry = _entries[index];
+    ESP_UTILS_LOGD("Cancel event(%d)", entry.event.id);
+    remove(getEntryList(entry), index);
+    release(index);
+
+    return true;
+}
+
+void AudioScheduler::clear()
+{
+    for (int i = 0; i < static_cast<int>(_entries.size()); i++) {
+        if (_entries[i].state != EntryState::Free) {
+            remove(getEntryList(_entries[i]), i);
+            release(i);
+        }
+    }
+}
+
+void AudioScheduler::advance(int64_t now_ms)
+{
+    int64_t target_tick = now_ms / _tick_ms;
+    if (_current_tick < 0) {
+        _current_tick = target_tick;
+        return;
+    }
+    if (target_tick <= _current_tick) {
+        return;
+    }
+
+    // Each slot only needs to be visited once, even if more than a revolution has passed
+    int64_t slot_visit_num = std::min<int64_t>(target_tick - _current_tick, _slots.size());
+    int64_t slot_mask = _slots.size() - 1;
+    for (int64_t tick = _current_tick + 1; (tick <= _current_tick + slot_visit_num) && (_waiting_num > 0); tick++) {
+        List &slot = _slots[tick & slot_mask];
+        for (int index = slot.head; index >= 0;) {
+            Entry &entry = _entries[index];
+            int next = entry.next;
+            if (entry.due_tick <= target_tick) {
+                remove(slot, index);
+                entry.state = EntryState::Ready;
+                pushBack(_ready_lists[entry.event.priority], index);
+                _ready_mask |= (1U << entry.event.priority);
+            }
+            index = next;
+        }
+    }
+    _current_tick = target_tick;
+}
+
+bool AudioScheduler::takeReady(int64_t now_ms, Event &event)
+{
+    int priority = getReadyPriority();
+    if (priority < 0) {
+        return false;
+    }
+
+    int index = _ready_lists[priority].head;
+    Entry &entry = _entries[index];
+    remove(_ready_lists[priority], index);
+    event = entry.event;
+
+    if ((entry.event.repeat_count < 0) || (entry.event.repeat_count > 1)) {
+        if (entry.event.repeat_count > 0) {
+            entry.event.repeat_count--;
+        }
+        wait(index, now_ms, std::max(entry.event.repeat_interval_ms, 1));
+    } else {
+        release(index);
+    }
+
+    return true;
+}
+
+int AudioScheduler::getReadyPriority() const
+{
+    if (_ready_mask == 0) {
+        return -1;
+    }
+
+    return std::numeric_limits<uint32_t>::digits - 1 - __builtin_clz(_ready_mask);
+}
+
+int AudioScheduler::getWaitTimeMs(int64_t now_ms) const
+{
+    if (_ready_mask != 0) {
+        return 0;
+    }
+    if (_waiting_num == 0) {
+        return -1;
+    }
+
+    // Look for the nearest event in the next revolution, then among the ones after it
+    int64_t due_tick = std::numeric_limits<int64_t>::max();
+    int64_t slot_mask = _slots.size() - 1;
+    for (int64_t tick = _current_tick + 1; tick <= _current_tick + static_cast<int64_t>(_slots.size()); tick++) {
+        for (int index = _slots[tick & slot_mask].head; index >= 0; index = _entries[index].next) {
+            due_tick = std::min(due_tick, _entries[index].due_tick);
+        }
+        if (due_tick <= tick) {
+            break;
+        }
+    }
+
+    int64_t wait_time_ms = due_tick * _tick_ms - now_ms;
+    return static_cast<int>(std::clamp<int64_t>(wait_time_ms, 0, std::numeric_limits<int>::max()));
+}
+
+bool AudioScheduler::isPending(Handle handle) const
+{
+    return getEntryIndex(handle) >= 0;
+}
+
+int AudioScheduler::getEntryIndex(Handle handle) const
+{
+    int index = static_cast<int>(handle & HANDLE_INDEX_MASK);
+    if ((handle == INVALID_HANDLE) || (index >= static_cast<int>(_entries.size()))) {
+        return -1;
+    }
+
+    const Entry &entry = _entries[index];
+    if ((entry.state == EntryState::Free) || (entry.generation != (handle >> HANDLE_INDEX_BITS))) {
+        return -1;
+    }
+
+    return index;
+}
+
+AudioScheduler::List &AudioScheduler::getEntryList(const Entry &entry)
+{
+    if (entry.state == EntryState::Ready) {
+        return _ready_lists[entry.event.priority];
+    }
+
+    return _slots[entry.due_tick & (_slots.size() - 1)];
+}
+
+void AudioScheduler::pushBack(List &list, int index)
+{
+    Entry &entry = _entries[index];
+    entry.prev = list.tail;
+    entry.next = -1;
+    if (list.tail >= 0) {
+        _entries[list.tail].next = index;
+    } else {
+        list.head = index;
+    }
+    list.tail = index;
+}
+
+void AudioScheduler::remove(List &list, int index)
+{
+    Entry &entry = _entries[index];
+    if (entry.prev >= 0) {
+        _entries[entry.prev].next = entry.next;
+    } else {
+        list.head = entry.next;
+    }
+    if (entry.next >= 0) {
+        _entries[entry.next].prev = entry.prev;
+    } else {
+        list.tail = entry.prev;
+    }
+
+    if (entry.state == EntryState::Ready) {
+        if (_ready_lists[entry.event.priority].head < 0) {
+            _ready_mask &= ~(1U << entry.event.priority);
+        }
+    } else if (entry.state == EntryState::Waiting) {
+        _waiting_num--;
+    }
+    entry.state = EntryState::Free;
+}
+
+void AudioScheduler::wait(int index, int64_t now_ms, int delay_ms)
+{
+    Entry &entry = _entries[index];
+    if (delay_ms <= 0) {
+        entry.state = EntryState::Ready;
+        pushBack(_ready_lists[entry.event.priority], index);
+        _ready_mask |= (1U << entry.event.priority);
+        return;
+    }
+
+    if (_current_tick < 0) {
+        _current_tick = now_ms / _tick_ms;
+    }
+    // Round up, so the event is never early
+    entry.due_tick = std::max((now_ms + delay_ms + _tick_ms - 1) / _tick_ms, _current_tick + 1);
+    entry.state = EntryState::Waiting;
+    pushBack(_slots[entry.due_tick & (_slots.size() - 1)], index);
+    _waiting_num++;
+}
+
+void AudioScheduler::release(int index)
+{
+    Entry &entry = _entries[index];
+    entry.state = EntryState::Free;
+    entry.generation = (entry.generation == std::numeric_limits<uint16_t>::max()) ? 1 : (entry.generation + 1);
+    entry.next = _free_head;
+    _free_head = index;
+    _pending_num--;
+}
+
+} // namespace esp_brookesia::systems::speaker
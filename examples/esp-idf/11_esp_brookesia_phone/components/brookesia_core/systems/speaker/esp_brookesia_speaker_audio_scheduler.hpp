@@ -0,0 +1,141 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace esp_brookesia::systems::speaker {
+
+/**
+ * @brief A timer wheel of audio events with priorities
+ *
+ * The events are kept in a fixed pool. A delayed event waits in the wheel slot of its due tick, then moves to the
+ * ready queue of its priority. The ready event with the highest priority is taken first, events of the same priority
+ * are taken in order. An event is referred to by its handle until it is finished or cancelled, so cancelling it is
+ * O(1). A handle of a finished event is not valid anymore, even if its entry is reused.
+ *
+ * The scheduler is not thread-safe, the caller should lock it.
+ */
+class AudioScheduler {
+public:
+    using Handle = uint32_t;
+
+    struct Config {
+        int tick_ms;
+        int slot_num;
+        int event_num;
+        int priority_num;
+    };
+
+    struct Event {
+        int id;
+        int priority;
+        int repeat_count;
+        int repeat_interval_ms;
+    };
+
+    static constexpr Handle INVALID_HANDLE = 0;
+    static constexpr int PRIORITY_NUM_MAX = 32;
+
+    /**
+     * @brief Create a scheduler
+     *
+     * @param config `slot_num` is rounded up to a power of 2, `priority_num` is limited to `PRIORITY_NUM_MAX`
+     */
+    AudioScheduler(const Config &config);
+
+    /**
+     * @brief Schedule an event
+     *
+     * @param event The event. The higher `priority` is, the more urgent the event is. It is played `repeat_count`
+     *              times (at least once, forever if negative), `repeat_interval_ms` apart
+     * @param now_ms Current time
+     * @param delay_ms Delay of the first play. If it is not positive, the event is ready at once
+     *
+     * @return The handle of the event, or `INVALID_HANDLE` if all the entries are used
+     */
+    Handle schedule(const Event &event, int64_t now_ms, int delay_ms = 0);
+
+    /**
+     * @brief Cancel an event
+     *
+     * @return true if the event was pending, false if it is finished or the handle is invalid
+     */
+    bool cancel(Handle handle);
+    void clear();
+
+    /**
+     * @brief Move the events whose time has come to the ready queues
+     */
+    void advance(int64_t now_ms);
+
+    /**
+     * @brief Take the ready event with the highest priority
+     *
+     * If the event should be played again, it is scheduled after its interval and keeps its handle.
+     *
+     * @return true if an event is taken
+     */
+    bool takeReady(int64_t now_ms, Event &event);
+
+    /**
+     * @brief Get the highest priority of the ready events, or -1 if no event is ready
+     */
+    int getReadyPriority() const;
+
+    /**
+     * @brief Get the time until the next event is ready, 0 if one is ready, or -1 if no event is pending
+     */
+    int getWaitTimeMs(int64_t now_ms) const;
+
+    bool isPending(Handle handle) const;
+    int getPendingNum() const
+    {
+        return _pending_num;
+    }
+
+private:
+    enum class EntryState : uint8_t {
+        Free,
+        Waiting,
+        Ready,
+    };
+
+    struct List {
+        int head = -1;
+        int tail = -1;
+    };
+
+    struct Entry {
+        Event event;
+        int64_t due_tick;
+        int prev;
+        int next;
+        uint16_t generation;
+        EntryState state;
+    };
+
+    int getEntryIndex(Handle handle) const;
+    List &getEntryList(const Entry &entry);
+    void pushBack(List &list, int index);
+    void remove(List &list, int index);
+    void wait(int index, int64_t now_ms, int delay_ms);
+    void release(int index);
+
+    int _tick_ms = 0;
+    int _priority_num = 0;
+    int64_t _current_tick = -1;
+    int _pending_num = 0;
+    int _waiting_num = 0;
+    uint32_t _ready_mask = 0;
+    int _free_head = -1;
+    std::vector<Entry> _entries;
+    std::vector<List> _slots;
+    std::vector<List> _ready_lists;
+};
+
+} // namespace esp_brookesia::systems::speaker
@@ -138,6 +138,10 @@ constexpr AI_Buddy::Data STYLESHEET_360_360_DARK_AI_BUDDY_DATA = {
                     .flags = {
                         .enable_data_swap_bytes = true,
                     },
+                    .frame_cache = {
+                        .budget_bytes = 2 * 1024 * 1024,
+                        .enable_prefetch = true,
+                    },
                 },
             },
             .icon = {
@@ -203,6 +207,10 @@ constexpr AI_Buddy::Data STYLESHEET_360_360_DARK_AI_BUDDY_DATA = {
                     .flags = {
                         .enable_data_swap_bytes = true,
                     },
+                    .frame_cache = {
+                        .budget_bytes = 256 * 1024,
+                        .enable_prefetch = false,
+                    },
                 },
             },
             .flags = {
@@ -3,13 +3,18 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <algorithm>
+#include <array>
+#include <cctype>
 #include <memory>
+#include <string>
 #include "esp_brookesia_systems_internal.h"
 #if !ESP_BROOKESIA_SPEAKER_KEYBOARD_ENABLE_DEBUG_LOG
 #   define ESP_BROOKESIA_UTILS_DISABLE_DEBUG_LOG
 #endif
 #include "speaker/private/esp_brookesia_speaker_utils.hpp"
 #include "style/esp_brookesia_gui_style.hpp"
+#include "lvgl/esp_brookesia_lv_helper.hpp"
 #include "esp_brookesia_keyboard.hpp"
 
 namespace esp_brookesia::systems::speaker {
@@ -22,6 +27,8 @@ namespace esp_brookesia::systems::speaker {
 
 #define TEXT_EDIT_SEND_CONFIRM_EVENT_LEN_MIN    8
 
+#define KEYBOARD_PREDICTION_NUM                 ESP_BROOKESIA_SPEAKER_KEYBOARD_PREDICTION_NUM
+
 #define LV_KB_BTN(width)    LV_BUTTONMATRIX_CTRL_POPOVER | width
 #define LV_KB_PHR(width)    (lv_buttonmatrix_ctrl_t)width
 #define LV_KB_PHR_STR       "  "
@@ -91,12 +98,18 @@ static const std::vector<std::string_view> keyboard_special_str = {
 
 Keyboard::Keyboard(base::Context &core, const KeyboardData &data):
     _system_context(core),
-    _data(data)
+    _data(data),
+    _is_layer_cache_enabled(ESP_BROOKESIA_SPEAKER_KEYBOARD_ENABLE_LAYER_CACHE)
 {
+    _predictions.reserve(KEYBOARD_PREDICTION_NUM);
 }
 
 Keyboard::~Keyboard(void)
 {
+    ESP_UTILS_LOGD("Destroy(0x%p)", this);
+    if (!del()) {
+        ESP_UTILS_LOGE("Delete failed");
+    }
 }
 
 bool Keyboard::begin(const gui::LvObject *parent)
@@ -143,6 +156,24 @@ bool Keyboard::begin(const gui::LvObject *parent)
             keyboard->processOnKeyboardDrawTask(e), "Process on keyboard draw task failed"
         );
     }, LV_EVENT_DRAW_TASK_ADDED, this);
+    _keyboard->addEventCallback([](lv_event_t *e) -> void {
+        ESP_UTILS_CHECK_NULL_EXIT(e, "Invalid event");
+
+        auto keyboard = (Keyboard *)lv_event_get_user_data(e);
+        ESP_UTILS_CHECK_NULL_EXIT(keyboard, "Invalid keyboard");
+
+        ESP_UTILS_CHECK_FALSE_EXIT(
+            keyboard->processOnKeyboardDrawMain(e), "Process on keyboard draw main failed"
+        );
+    }, static_cast<lv_event_code_t>(LV_EVENT_DRAW_MAIN | LV_EVENT_PREPROCESS), this);
+    _keyboard->addEventCallback([](lv_event_t *e) -> void {
+        ESP_UTILS_CHECK_NULL_EXIT(e, "Invalid event");
+
+        auto keyboard = (Keyboard *)lv_event_get_user_data(e);
+        ESP_UTILS_CHECK_NULL_EXIT(keyboard, "Invalid keyboard");
+
+        keyboard->invalidateLayers();
+    }, LV_EVENT_SIZE_CHANGED, this);
     lv_keyboard_set_map(
         _keyboard->getNativeHandle(), LV_KEYBOARD_MODE_TEXT_LOWER, default_kb_map_lc, default_kb_ctrl_map
     );
@@ -158,6 +189,13 @@ bool Keyboard::begin(const gui::LvObject *parent)
 
     ESP_UTILS_CHECK_FALSE_GOTO(updateByNewData(), err, "Update by new data failed");
 
+#if ESP_BROOKESIA_SPEAKER_KEYBOARD_ENABLE_PREDICTION
+    if (!_predictor.isLoaded() &&
+            !loadDictionary(ESP_BROOKESIA_SPEAKER_FS_MOUNT_POINT "/" ESP_BROOKESIA_SPEAKER_KEYBOARD_DICTIONARY_PATH)) {
+        ESP_UTILS_LOGW("No dictionary, the word prediction is disabled");
+    }
+#endif
+
     ESP_UTILS_LOG_TRACE_EXIT_WITH_THIS();
     return true;
 
@@ -174,6 +212,15 @@ bool Keyboard::del(void)
 {
     ESP_UTILS_LOG_TRACE_ENTER_WITH_THIS();
 
+    if (_is_layer_render_pending) {
+        lv_async_call_cancel(onRenderLayerAsync, this);
+        _is_layer_render_pending = false;
+    }
+    for (auto &layer : _layers) {
+        destroyLayer(layer);
+    }
+    _layers.clear();
+    _predictions.clear();
     _main_object = nullptr;
     _keyboard = nullptr;
 
@@ -271,6 +318,7 @@ end:
         on_keyboard_value_changed_signal(std::string_view(text));
     }
     _last_keyboard_mode = current_keyboard_mode;
+    updatePrediction();
     return true;
 }
 
@@ -293,66 +341,40 @@ bool Keyboard::processOnKeyboardDrawTask(lv_event_t *e)
 
     {
         auto key_id = base_dsc->id1;
-        bool pressed = false;
         auto keyboard = _keyboard.get()->getNativeHandle();
-        if ((lv_buttonmatrix_get_selected_button(keyboard) == key_id) && lv_obj_has_state(keyboard, LV_STATE_PRESSED)) {
+        bool pressed = false;
+        if (_rendering_layer != nullptr) {
+            pressed = _is_rendering_pressed;
+        } else if ((lv_buttonmatrix_get_selected_button(keyboard) == key_id) &&
+                   lv_obj_has_state(keyboard, LV_STATE_PRESSED)) {
             pressed = true;
         }
 
         const char *text = lv_buttonmatrix_get_button_text(keyboard, key_id);
+        KeyColors colors = getKeyColors(text, pressed);
         // Change the color for normal and active buttons
         lv_draw_fill_dsc_t *fill_draw_dsc = lv_draw_task_get_fill_dsc(draw_task);
         if (fill_draw_dsc) {
-            lv_color_t inactive_color = gui::toLvColor(_data.keyboard.normal_button_inactive_background_color.color);
-            lv_opa_t inactive_opa = _data.keyboard.normal_button_inactive_background_color.opacity;
-            lv_color_t active_color = gui::toLvColor(_data.keyboard.normal_button_active_background_color.color);
-            lv_opa_t active_opa = _data.keyboard.normal_button_active_background_color.opacity;
-
-            if (strcmp(text, LV_SYMBOL_OK) == 0) {
-                inactive_color = gui::toLvColor(
-                                     _is_keyboard_ok_enabled ? _data.keyboard.ok_button_enabled_background_color.color :
-                                     _data.keyboard.ok_button_disabled_background_color.color
-                                 );
-                inactive_opa = _is_keyboard_ok_enabled ? _data.keyboard.ok_button_enabled_background_color.opacity :
-                               _data.keyboard.ok_button_disabled_background_color.opacity;
-                active_color = gui::toLvColor(_data.keyboard.ok_button_active_background_color.color);
-                active_opa = _data.keyboard.ok_button_active_background_color.opacity;
-            } else if (std::find(keyboard_special_str.begin(), keyboard_special_str.end(), text) != keyboard_special_str.end()) {
-                inactive_color = gui::toLvColor(_data.keyboard.special_button_inactive_background_color.color);
-                inactive_opa = _data.keyboard.special_button_inactive_background_color.opacity;
-                active_color = gui::toLvColor(_data.keyboard.special_button_active_background_color.color);
-                active_opa = _data.keyboard.special_button_active_background_color.opacity;
+            fill_draw_dsc->color = colors.background_color;
+            fill_draw_dsc->opa = colors.background_opa;
+
+            // Keep the area of the key, to copy it from the pressed layer
+            if ((_rendering_layer != nullptr) && !_is_rendering_pressed) {
+                lv_area_t area;
+                lv_draw_task_get_area(draw_task, &area);
+                lv_area_move(&area, -keyboard->coords.x1, -keyboard->coords.y1);
+                auto &key_areas = _rendering_layer->key_areas;
+                if (key_areas.size() <= key_id) {
+                    key_areas.resize(key_id + 1, KeyArea{{}, false});
+                }
+                key_areas[key_id] = {area, true};
             }
-
-            fill_draw_dsc->color = (pressed && (strcmp(text, LV_KB_PHR_STR) != 0)) ? active_color : inactive_color;
-            fill_draw_dsc->opa = (pressed && (strcmp(text, LV_KB_PHR_STR) != 0)) ? active_opa : inactive_opa;
         }
         // Change the text font and color
         lv_draw_label_dsc_t *label_draw_dsc = lv_draw_task_get_label_dsc(draw_task);
         if (label_draw_dsc) {
             const lv_font_t *font = static_cast<const lv_font_t *>(_data.keyboard.button_text_font.font_resource);
 
-            lv_color_t inactive_color = gui::toLvColor(_data.keyboard.normal_button_inactive_text_color.color);
-            lv_opa_t inactive_opa = _data.keyboard.normal_button_inactive_text_color.opacity;
-            lv_color_t active_color = gui::toLvColor(_data.keyboard.normal_button_active_text_color.color);
-            lv_opa_t active_opa = _data.keyboard.normal_button_active_text_color.opacity;
-
-            if (strcmp(text, LV_SYMBOL_OK) == 0) {
-                inactive_color = gui::toLvColor(
-                                     !_is_keyboard_ok_enabled ? _data.keyboard.ok_button_disabled_text_color.color :
-                                     _data.keyboard.normal_button_inactive_text_color.color
-                                 );
-                inactive_opa = !_is_keyboard_ok_enabled ? _data.keyboard.ok_button_disabled_text_color.opacity :
-                               _data.keyboard.normal_button_inactive_text_color.opacity;
-                active_color = gui::toLvColor(_data.keyboard.ok_button_active_text_color.color);
-                active_opa = _data.keyboard.ok_button_active_text_color.opacity;
-            } else if (std::find(keyboard_special_str.begin(), keyboard_special_str.end(), text) != keyboard_special_str.end()) {
-                inactive_color = gui::toLvColor(_data.keyboard.special_button_inactive_text_color.color);
-                inactive_opa = _data.keyboard.special_button_inactive_text_color.opacity;
-                active_color = gui::toLvColor(_data.keyboard.special_button_active_text_color.color);
-                active_opa = _data.keyboard.special_button_active_text_color.opacity;
-            }
-
             // Use the internal symbol font for the symbol buttons
             if (std::find(keyboard_symbol_str.begin(), keyboard_symbol_str.end(), text) != keyboard_symbol_str.end()) {
                 ESP_UTILS_CHECK_FALSE_RETURN(
@@ -361,8 +383,8 @@ bool Keyboard::processOnKeyboardDrawTask(lv_event_t *e)
             }
 
             label_draw_dsc->font = font;
-            label_draw_dsc->color = pressed ? active_color : inactive_color;
-            label_draw_dsc->opa = pressed ? active_opa : inactive_opa;
+            label_draw_dsc->color = colors.text_color;
+            label_draw_dsc->opa = colors.text_opa;
         }
 
         on_keyboard_draw_task_signal(e);
@@ -372,6 +394,335 @@ end:
     return true;
 }
 
+bool Keyboard::processOnKeyboardDrawMain(lv_event_t *e)
+{
+    ESP_UTILS_CHECK_FALSE_RETURN(isBegun(), false, "Not begun");
+
+    auto keyboard = _keyboard->getNativeHandle();
+    lv_layer_t *layer = lv_event_get_layer(e);
+    lv_area_t layer_area = keyboard->coords;
+    int32_t ext_draw_size = lv_obj_get_ext_draw_size(keyboard);
+    lv_area_increase(&layer_area, ext_draw_size, ext_draw_size);
+
+    if (_rendering_layer != nullptr) {
+        // Render the layer over the opaque background of the main object, so it is drawn without blending
+        if (_data.main.background_color.opacity == LV_OPA_COVER) {
+            lv_draw_rect_dsc_t rect_dsc;
+            lv_draw_rect_dsc_init(&rect_dsc);
+            rect_dsc.bg_color = gui::toLvColor(_data.main.background_color.color);
+            rect_dsc.bg_opa = LV_OPA_COVER;
+            lv_draw_rect(layer, &rect_dsc, &layer_area);
+        }
+        return true;
+    }
+    if (!_is_layer_cache_enabled) {
+        return true;
+    }
+
+    bool is_pressed = lv_obj_has_state(keyboard, LV_STATE_PRESSED);
+    KeyLayer *key_layer = getLayer(lv_buttonmatrix_get_map(keyboard));
+    if (key_layer == nullptr) {
+        // Draw the keys as usual this time, the layer is rendered once the keys are released
+        if (!is_pressed && !_is_layer_render_pending) {
+            ESP_UTILS_CHECK_FALSE_RETURN(
+                lv_async_call(onRenderLayerAsync, this) == LV_RESULT_OK, false, "Request layer render failed"
+            );
+            _is_layer_render_pending = true;
+        }
+        return true;
+    }
+    if ((key_layer->released->header.w != lv_area_get_width(&layer_area)) ||
+            (key_layer->released->header.h != lv_area_get_height(&layer_area))) {
+        invalidateLayers();
+        return true;
+    }
+
+    uint32_t key_id = lv_buttonmatrix_get_selected_button(keyboard);
+    const KeyArea *key_area = nullptr;
+    if (is_pressed && (key_id != LV_BUTTONMATRIX_BUTTON_NONE)) {
+        if ((key_id >= key_layer->key_areas.size()) || !key_layer->key_areas[key_id].is_valid) {
+            return true;
+        }
+        key_area = &key_layer->key_areas[key_id];
+    }
+
+    lv_draw_image_dsc_t image_dsc;
+    lv_draw_image_dsc_init(&image_dsc);
+    image_dsc.src = key_layer->released;
+    lv_draw_image(layer, &image_dsc, &layer_area);
+    // Copy the pressed key from the pressed layer
+    if (key_area != nullptr) {
+        lv_area_t area = key_area->area;
+        lv_area_move(&area, keyboard->coords.x1, keyboard->coords.y1);
+        lv_area_t clip_area_ori = layer->_clip_area;
+        if (lv_area_intersect(&layer->_clip_area, &clip_area_ori, &area)) {
+            image_dsc.src = key_layer->pressed;
+            lv_draw_image(layer, &image_dsc, &layer_area);
+        }
+        layer->_clip_area = clip_area_ori;
+    }
+    key_layer->last_use = ++_layer_use_count;
+
+    // Skip the drawing of the button matrix
+    lv_event_stop_processing(e);
+
+    return true;
+}
+
+Keyboard::KeyColors Keyboard::getKeyColors(const char *text, bool pressed) const
+{
+    lv_color_t inactive_color = gui::toLvColor(_data.keyboard.normal_button_inactive_background_color.color);
+    lv_opa_t inactive_opa = _data.keyboard.normal_button_inactive_background_color.opacity;
+    lv_color_t active_color = gui::toLvColor(_data.keyboard.normal_button_active_background_color.color);
+    lv_opa_t active_opa = _data.keyboard.normal_button_active_background_color.opacity;
+    lv_color_t inactive_text_color = gui::toLvColor(_data.keyboard.normal_button_inactive_text_color.color);
+    lv_opa_t inactive_text_opa = _data.keyboard.normal_button_inactive_text_color.opacity;
+    lv_color_t active_text_color = gui::toLvColor(_data.keyboard.normal_button_active_text_color.color);
+    lv_opa_t active_text_opa = _data.keyboard.normal_button_active_text_color.opacity;
+
+    if (strcmp(text, LV_SYMBOL_OK) == 0) {
+        inactive_color = gui::toLvColor(
+                             _is_keyboard_ok_enabled ? _data.keyboard.ok_button_enabled_background_color.color :
+                             _data.keyboard.ok_button_disabled_background_color.color
+                         );
+        inactive_opa = _is_keyboard_ok_enabled ? _data.keyboard.ok_button_enabled_background_color.opacity :
+                       _data.keyboard.ok_button_disabled_background_color.opacity;
+        active_color = gui::toLvColor(_data.keyboard.ok_button_active_background_color.color);
+        active_opa = _data.keyboard.ok_button_active_background_color.opacity;
+        inactive_text_color = gui::toLvColor(
+                                  !_is_keyboard_ok_enabled ? _data.keyboard.ok_button_disabled_text_color.color :
+                                  _data.keyboard.normal_button_inactive_text_color.color
+                              );
+        inactive_text_opa = !_is_keyboard_ok_enabled ? _data.keyboard.ok_button_disabled_text_color.opacity :
+                            _data.keyboard.normal_button_inactive_text_color.opacity;
+        active_text_color = gui::toLvColor(_data.keyboard.ok_button_active_text_color.color);
+        active_text_opa = _data.keyboard.ok_button_active_text_color.opacity;
+    } else if (std::find(keyboard_special_str.begin(), keyboard_special_str.end(), text) != keyboard_special_str.end()) {
+        inactive_color = gui::toLvColor(_data.keyboard.special_button_inactive_background_color.color);
+        inactive_opa = _data.keyboard.special_button_inactive_background_color.opacity;
+        active_color = gui::toLvColor(_data.keyboard.special_button_active_background_color.color);
+        active_opa = _data.keyboard.special_button_active_background_color.opacity;
+        inactive_text_color = gui::toLvColor(_data.keyboard.special_button_inactive_text_color.color);
+        inactive_text_opa = _data.keyboard.special_button_inactive_text_color.opacity;
+        active_text_color = gui::toLvColor(_data.keyboard.special_button_active_text_color.color);
+        active_text_opa = _data.keyboard.special_button_active_text_color.opacity;
+    }
+
+    // The placeholders never look pressed
+    bool is_background_active = pressed && (strcmp(text, LV_KB_PHR_STR) != 0);
+
+    return {
+        .background_color = is_background_active ? active_color : inactive_color,
+        .background_opa = is_background_active ? active_opa : inactive_opa,
+        .text_color = pressed ? active_text_color : inactive_text_color,
+        .text_opa = pressed ? active_text_opa : inactive_text_opa,
+    };
+}
+
+bool Keyboard::renderLayer(void)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    ESP_UTILS_CHECK_FALSE_RETURN(isBegun(), false, "Not begun");
+
+    auto keyboard = _keyboard->getNativeHandle();
+    auto map = lv_buttonmatrix_get_map(keyboard);
+    // Only render the keys when they are released, the layer is requested again by the next drawing otherwise
+    if (!_is_layer_cache_enabled || (getLayer(map) != nullptr) || lv_obj_has_state(keyboard, LV_STATE_PRESSED)) {
+        return true;
+    }
+
+    if (_layers.size() >= ESP_BROOKESIA_SPEAKER_KEYBOARD_LAYER_CACHE_NUM) {
+        auto oldest = std::min_element(_layers.begin(), _layers.end(), [](const KeyLayer & a, const KeyLayer & b) {
+            return a.last_use < b.last_use;
+        });
+        destroyLayer(*oldest);
+        _layers.erase(oldest);
+    }
+
+    lv_color_format_t color_format = LV_COLOR_FORMAT_ARGB8888;
+    if (_data.main.background_color.opacity == LV_OPA_COVER) {
+        color_format = lv_display_get_color_format(lv_obj_get_display(keyboard));
+    }
+    KeyLayer layer = {map, nullptr, nullptr, {}, ++_layer_use_count};
+    _rendering_layer = &layer;
+    _is_rendering_pressed = false;
+    layer.released = lv_snapshot_take(keyboard, color_format);
+    if (layer.released != nullptr) {
+        _is_rendering_pressed = true;
+        layer.pressed = lv_snapshot_take(keyboard, color_format);
+    }
+    _rendering_layer = nullptr;
+
+    if ((layer.released == nullptr) || (layer.pressed == nullptr)) {
+        destroyLayer(layer);
+        _is_layer_cache_enabled = false;
+        ESP_UTILS_LOGE("Render layer failed, the keys are drawn without cache");
+        return false;
+    }
+    ESP_UTILS_LOGD(
+        "Rendered layer of map(0x%p): %dx%d, %d bytes", map, (int)layer.released->header.w,
+        (int)layer.released->header.h, (int)(layer.released->data_size + layer.pressed->data_size)
+    );
+    _layers.push_back(std::move(layer));
+
+    return true;
+}
+
+void Keyboard::destroyLayer(KeyLayer &layer)
+{
+    for (auto draw_buf : {
+                layer.released, layer.pressed
+            }) {
+        if (draw_buf != nullptr) {
+            // The image may still be in the LVGL image cache
+            lv_image_cache_drop(draw_buf);
+            lv_draw_buf_destroy(draw_buf);
+        }
+    }
+    layer.released = nullptr;
+    layer.pressed = nullptr;
+}
+
+Keyboard::KeyLayer *Keyboard::getLayer(const char *const *map)
+{
+    auto it = std::find_if(_layers.begin(), _layers.end(), [map](const KeyLayer & layer) {
+        return layer.map == map;
+    });
+
+    return (it == _layers.end()) ? nullptr : &(*it);
+}
+
+void Keyboard::onRenderLayerAsync(void *user_data)
+{
+    auto keyboard = static_cast<Keyboard *>(user_data);
+    ESP_UTILS_CHECK_NULL_EXIT(keyboard, "Invalid keyboard");
+
+    keyboard->_is_layer_render_pending = false;
+    ESP_UTILS_CHECK_FALSE_EXIT(keyboard->renderLayer(), "Render layer failed");
+}
+
+void Keyboard::updatePrediction(void)
+{
+    if (!_predictor.isLoaded()) {
+        return;
+    }
+
+    std::array<std::string_view, KEYBOARD_PREDICTION_NUM> words;
+    int word_num = 0;
+    std::string_view prefix;
+    if (getPredictionPrefix(prefix) && !prefix.empty()) {
+        word_num = _predictor.predict(prefix, words.data(), words.size());
+
+        auto &lookup = _predictor.getLastLookupInfo();
+        if (lookup.time_us > ESP_BROOKESIA_SPEAKER_KEYBOARD_PREDICTION_BUDGET_US) {
+            ESP_UTILS_LOGW(
+                "Prediction of `%.*s` took %d us (budget: %d us), %d nodes visited", (int)prefix.size(), prefix.data(),
+                lookup.time_us, ESP_BROOKESIA_SPEAKER_KEYBOARD_PREDICTION_BUDGET_US, lookup.visit_num
+            );
+        } else {
+            ESP_UTILS_LOGD(
+                "Prediction of `%.*s`: %d words, %d us, %d nodes visited", (int)prefix.size(), prefix.data(),
+                word_num, lookup.time_us, lookup.visit_num
+            );
+        }
+    }
+    if ((word_num == 0) && _predictions.empty()) {
+        return;
+    }
+
+    _predictions.assign(words.begin(), words.begin() + word_num);
+    on_keyboard_prediction_signal(_predictions);
+}
+
+bool Keyboard::getPredictionPrefix(std::string_view &prefix) const
+{
+    ESP_UTILS_CHECK_FALSE_RETURN(isBegun(), false, "Not begun");
+
+    lv_obj_t *text_edit = lv_keyboard_get_textarea(_keyboard->getNativeHandle());
+    if (text_edit == nullptr) {
+        return false;
+    }
+
+    auto is_word_byte = [](uint8_t byte) {
+        return std::isalnum(byte) || (byte == '\'') || (byte >= 0x80);
+    };
+    const char *text = lv_textarea_get_text(text_edit);
+    uint32_t end = lv_text_encoded_get_byte_id(text, lv_textarea_get_cursor_pos(text_edit));
+    uint32_t start = end;
+    while ((start > 0) && is_word_byte(text[start - 1])) {
+        start--;
+    }
+    // The word is too long to be predicted
+    if (end - start > KeyboardPredictor::PREFIX_LEN_MAX) {
+        start = end;
+    }
+    prefix = std::string_view(text + start, end - start);
+
+    return true;
+}
+
+bool Keyboard::setLayerCacheEnabled(bool enabled)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    ESP_UTILS_LOGD("Param: enabled(%d)", enabled);
+
+    _is_layer_cache_enabled = enabled;
+    invalidateLayers();
+
+    return true;
+}
+
+void Keyboard::invalidateLayers(void)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    for (auto &layer : _layers) {
+        destroyLayer(layer);
+    }
+    _layers.clear();
+    if (isBegun()) {
+        lv_obj_invalidate(_keyboard->getNativeHandle());
+    }
+}
+
+bool Keyboard::loadDictionary(const char *path)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    ESP_UTILS_CHECK_FALSE_RETURN(_predictor.loadFile(path), false, "Load dictionary failed");
+    _predictions.clear();
+
+    return true;
+}
+
+bool Keyboard::applyPrediction(std::string_view word)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    ESP_UTILS_LOGD("Param: word(%.*s)", (int)word.size(), word.data());
+    ESP_UTILS_CHECK_FALSE_RETURN(isBegun(), false, "Not begun");
+
+    std::string_view prefix;
+    ESP_UTILS_CHECK_FALSE_RETURN(getPredictionPrefix(prefix), false, "No text edit");
+
+    // The word is copied first, it may be a prediction of the current text
+    std::string text(word);
+    text += ' ';
+    auto text_edit = lv_keyboard_get_textarea(_keyboard->getNativeHandle());
+    for (uint8_t byte : prefix) {
+        // Delete one character for each leading byte
+        if ((byte & 0xC0) != 0x80) {
+            lv_textarea_delete_char(text_edit);
+        }
+    }
+    lv_textarea_add_text(text_edit, text.c_str());
+    updatePrediction();
+
+    return true;
+}
+
 bool Keyboard::setTextEdit(lv_obj_t *text_edit) const
 {
     ESP_UTILS_LOG_TRACE_ENTER_WITH_THIS();
@@ -391,7 +742,11 @@ bool Keyboard::setOkEnabled(bool enabled)
 
     ESP_UTILS_CHECK_FALSE_RETURN(isBegun(), false, "Not begun");
 
-    _is_keyboard_ok_enabled = enabled;
+    if (_is_keyboard_ok_enabled != enabled) {
+        _is_keyboard_ok_enabled = enabled;
+        // The OK key is in the cached layers
+        invalidateLayers();
+    }
 
     ESP_UTILS_LOG_TRACE_EXIT_WITH_THIS();
     return true;
@@ -472,6 +827,7 @@ bool Keyboard::updateByNewData(void)
     ESP_UTILS_CHECK_FALSE_RETURN(
         _keyboard->setStyleAttribute(_data.keyboard.button_text_font), false, "Set button text font failed"
     );
+    invalidateLayers();
 
     ESP_UTILS_LOG_TRACE_EXIT_WITH_THIS();
     return true;
@@ -6,9 +6,11 @@
 #pragma once
 
 #include <string_view>
+#include <vector>
 #include "lvgl/esp_brookesia_lv.hpp"
 #include "systems/base/esp_brookesia_base_context.hpp"
 #include "boost/signals2/signal.hpp"
+#include "esp_brookesia_keyboard_predictor.hpp"
 
 namespace esp_brookesia::systems::speaker {
 
@@ -39,12 +41,25 @@ struct KeyboardData {
     } keyboard;
 };
 
+/**
+ * @brief The keyboard of the speaker, an `lv_keyboard` with its own key colors
+ *
+ * Each key map is rendered once into two cached layers, one with all the keys released and one with all the keys
+ * pressed. The keyboard is then drawn from the released layer, and the pressed key is copied from the pressed layer
+ * over it, so neither a key press nor a mode switch draws the keys again. A layer is rendered the first time its map
+ * is shown, and rendered again after the styles or the OK key state are changed.
+ *
+ * When a dictionary is loaded, the words which complete the word before the cursor are sent by
+ * `on_keyboard_prediction_signal` after each key.
+ */
 class Keyboard {
 public:
     using OnKeyboardValueChangedSignal = boost::signals2::signal<void(const std::string_view &text)>;
     using OnKeyboardValueChangedSignalSlot = OnKeyboardValueChangedSignal::slot_type;
     using OnKeyboardDrawTaskSignal = boost::signals2::signal<void(lv_event_t *e)>;
     using OnKeyboardDrawTaskSignalSlot = OnKeyboardDrawTaskSignal::slot_type;
+    using OnKeyboardPredictionSignal = boost::signals2::signal<void(const std::vector<std::string_view> &words)>;
+    using OnKeyboardPredictionSignalSlot = OnKeyboardPredictionSignal::slot_type;
 
     Keyboard(base::Context &core, const KeyboardData &data);
     ~Keyboard();
@@ -59,6 +74,24 @@ public:
     bool setMode(lv_keyboard_mode_t mode) const;
     bool setTextEdit(lv_obj_t *text_edit) const;
     bool setOkEnabled(bool enabled);
+    /**
+     * @brief Enable or disable the cached key layers, the keys are drawn by `lv_keyboard` when they are disabled
+     */
+    bool setLayerCacheEnabled(bool enabled);
+    /**
+     * @brief Drop the cached key layers, so they are rendered again. Call it when the keys drawn are customized
+     *        differently by `on_keyboard_draw_task_signal`, which is only sent when a layer is rendered.
+     */
+    void invalidateLayers(void);
+
+    /**
+     * @brief Load the dictionary of the word prediction, see `KeyboardPredictor`
+     */
+    bool loadDictionary(const char *path);
+    /**
+     * @brief Replace the word before the cursor with a predicted word, followed by a space
+     */
+    bool applyPrediction(std::string_view word);
 
     bool isBegun(void) const
     {
@@ -70,6 +103,14 @@ public:
     }
     bool getArea(lv_area_t &area) const;
     bool getTextEdit(lv_obj_t *&text_edit) const;
+    const std::vector<std::string_view> &getPredictions(void) const
+    {
+        return _predictions;
+    }
+    const KeyboardPredictor &getPredictor(void) const
+    {
+        return _predictor;
+    }
 
     static bool calibrateData(
         const gui::StyleSize &screen_size, const base::Display &display, KeyboardData &data
@@ -77,11 +118,41 @@ public:
 
     OnKeyboardValueChangedSignal on_keyboard_value_changed_signal;
     OnKeyboardDrawTaskSignal on_keyboard_draw_task_signal;
+    OnKeyboardPredictionSignal on_keyboard_prediction_signal;
 private:
+    struct KeyArea {
+        lv_area_t area;     // Relative to the keyboard
+        bool is_valid;
+    };
+
+    struct KeyLayer {
+        const char *const *map;
+        lv_draw_buf_t *released;
+        lv_draw_buf_t *pressed;
+        std::vector<KeyArea> key_areas;
+        uint32_t last_use;
+    };
+
+    struct KeyColors {
+        lv_color_t background_color;
+        lv_opa_t background_opa;
+        lv_color_t text_color;
+        lv_opa_t text_opa;
+    };
+
     bool updateByNewData(void);
+    KeyColors getKeyColors(const char *text, bool pressed) const;
+
+    bool renderLayer(void);
+    void destroyLayer(KeyLayer &layer);
+    KeyLayer *getLayer(const char *const *map);
+    void updatePrediction(void);
+    bool getPredictionPrefix(std::string_view &prefix) const;
 
     bool processOnKeyboardValueChanged(lv_event_t *e);
     bool processOnKeyboardDrawTask(lv_event_t *e);
+    bool processOnKeyboardDrawMain(lv_event_t *e);
+    static void onRenderLayerAsync(void *user_data);
 
     base::Context &_system_context;
     const KeyboardData &_data;
@@ -91,6 +162,17 @@ private:
     gui::LvObjectUniquePtr _keyboard{nullptr};
     int _last_keyboard_mode = static_cast<int>(LV_KEYBOARD_MODE_TEXT_LOWER);
 
+    bool _is_layer_cache_enabled = false;
+    bool _is_layer_render_pending = false;
+    uint32_t _layer_use_count = 0;
+    std::vector<KeyLayer> _layers;
+    // The layer being rendered, and whether its keys are drawn pressed
+    KeyLayer *_rendering_layer = nullptr;
+    bool _is_rendering_pressed = false;
+
+    KeyboardPredictor _predictor;
+    std::vector<std::string_view> _predictions;
+
     static const std::vector<std::string_view> _keyboard_symbol_str;
     static const std::vector<std::string_view> _keyboard_special_str;
 };
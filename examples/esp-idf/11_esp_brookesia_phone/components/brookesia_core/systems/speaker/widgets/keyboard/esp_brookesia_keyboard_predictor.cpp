@@ -0,0 +1,300 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include "esp_brookesia_systems_internal.h"
+#if !ESP_BROOKESIA_SPEAKER_KEYBOARD_ENABLE_DEBUG_LOG
+#   define ESP_BROOKESIA_UTILS_DISABLE_DEBUG_LOG
+#endif
+#include "speaker/private/esp_brookesia_speaker_utils.hpp"
+#include "esp_brookesia_keyboard_predictor.hpp"
+
+#define WORD_LEN_MAX        (std::numeric_limits<uint8_t>::max())
+#define HEAP_SIZE_DEFAULT   (256)
+
+namespace esp_brookesia::systems::speaker {
+
+namespace {
+
+int64_t get_time_us()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()
+           ).count();
+}
+
+/**
+ * A heap item is a node, or a word found, ordered by weight. On equal weights a word comes before a node, and the
+ * lower index first, which is the alphabetical order for the nodes of the same depth.
+ */
+uint64_t to_heap_item(int weight, bool is_word, uint32_t index)
+{
+    return (static_cast<uint64_t>(weight) << 33) | (static_cast<uint64_t>(is_word) << 32) |
+           (std::numeric_limits<uint32_t>::max() - index);
+}
+
+bool is_heap_item_word(uint64_t item)
+{
+    return (item >> 32) & 1;
+}
+
+uint32_t get_heap_item_index(uint64_t item)
+{
+    return std::numeric_limits<uint32_t>::max() - static_cast<uint32_t>(item);
+}
+
+} // namespace
+
+KeyboardPredictor::KeyboardPredictor(int visit_num_max):
+    _visit_num_max(std::max(visit_num_max, 1))
+{
+}
+
+bool KeyboardPredictor::loadFile(const char *path)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    ESP_UTILS_CHECK_NULL_RETURN(path, false, "Invalid path");
+    ESP_UTILS_LOGD("Param: path(%s)", path);
+
+    std::unique_ptr<FILE, decltype(&fclose)> file(fopen(path, "rb"), fclose);
+    ESP_UTILS_CHECK_NULL_RETURN(file, false, "Open file(%s) failed", path);
+
+    ESP_UTILS_CHECK_FALSE_RETURN(fseek(file.get(), 0, SEEK_END) == 0, false, "Seek file failed");
+    long size = ftell(file.get());
+    ESP_UTILS_CHECK_FALSE_RETURN(size >= 0, false, "Get file size failed");
+    ESP_UTILS_CHECK_FALSE_RETURN(fseek(file.get(), 0, SEEK_SET) == 0, false, "Seek file failed");
+
+    std::string dictionary(size, '\0');
+    ESP_UTILS_CHECK_FALSE_RETURN(
+        fread(dictionary.data(), 1, size, file.get()) == static_cast<size_t>(size), false, "Read file failed"
+    );
+    ESP_UTILS_CHECK_FALSE_RETURN(load(dictionary), false, "Load dictionary failed");
+
+    ESP_UTILS_LOGI(
+        "Loaded %d words from %s, %d nodes, %d bytes", getWordNum(), path, static_cast<int>(_nodes.size()),
+        static_cast<int>(getMemorySize())
+    );
+
+    return true;
+}
+
+bool KeyboardPredictor::load(std::string_view dictionary)
+{
+    ESP_UTILS_LOG_TRACE_GUARD_WITH_THIS();
+
+    clear();
+
+    // Parse the lines, `word [weight]`
+    std::string text;
+    std::vector<Word> words;
+    size_t line_start = 0;
+    while (line_start < dictionary.size()) {
+        size_t line_end = dictionary.find('\n', line_start);
+        if (line_end == std::string_view::npos) {
+            line_end = dictionary.size();
+        }
+        std::string_view line = dictionary.substr(line_start, line_end - line_start);
+        line_start = line_end + 1;
+
+        size_t word_start = 0;
+        while ((word_start < line.size()) && !isWordByte(line[word_start])) {
+            word_start++;
+        }
+        size_t word_end = word_start;
+        while ((word_end < line.size()) && isWordByte(line[word_end])) {
+            word_end++;
+        }
+        if ((word_end == word_start) || (word_end - word_start > WORD_LEN_MAX)) {
+            continue;
+        }
+
+        long weight = 1;
+        if (word_end < line.size()) {
+            std::string weight_str(line.substr(word_end));
+            char *weight_end = nullptr;
+            weight = strtol(weight_str.c_str(), &weight_end, 10);
+            if (weight_end == weight_str.c_str()) {
+                weight = 1;
+            }
+        }
+        words.push_back({
+            static_cast<uint32_t>(text.size()), static_cast<uint16_t>(std::clamp<long>(weight, 0, WEIGHT_MAX)),
+            static_cast<uint8_t>(word_end - word_start)
+        });
+        text.append(line.substr(word_start, word_end - word_start));
+    }
+    ESP_UTILS_CHECK_FALSE_RETURN(!words.empty(), false, "No word in the dictionary");
+
+    // Sort the words by their keys, only keep the highest weight of a key
+    auto get_key = [&text](const Word & word, size_t depth) {
+        return toKey(text[word.offset + depth]);
+    };
+    auto key_less = [&](const Word & a, const Word & b) {
+        size_t length = std::min(a.length, b.length);
+        for (size_t i = 0; i < length; i++) {
+            if (get_key(a, i) != get_key(b, i)) {
+                return get_key(a, i) < get_key(b, i);
+            }
+        }
+        return a.length < b.length;
+    };
+    std::sort(words.begin(), words.end(), [&](const Word & a, const Word & b) {
+        if (key_less(a, b) || key_less(b, a)) {
+            return key_less(a, b);
+        }
+        return a.weight > b.weight;
+    });
+    for (size_t i = 0; i < words.size(); i++) {
+        if ((i > 0) && !key_less(words[i - 1], words[i])) {
+            continue;
+        }
+        _words.push_back({static_cast<uint32_t>(_word_text.size()), words[i].weight, words[i].length});
+        _word_text.append(text, words[i].offset, words[i].length);
+    }
+    _words.shrink_to_fit();
+    _word_text.shrink_to_fit();
+
+    // Build the trie breadth first, so the children of a node are contiguous
+    auto get_letter = [this](const Word & word, size_t depth) {
+        return toKey(_word_text[word.offset + depth]);
+    };
+    struct Range {
+        uint32_t node;
+        uint32_t begin;
+        uint32_t end;
+        uint32_t depth;
+    };
+    std::vector<Range> ranges;
+    _nodes.push_back({0, 0, 0, 0, 0});
+    ranges.push_back({0, 0, static_cast<uint32_t>(_words.size()), 0});
+    for (size_t range_index = 0; range_index < ranges.size(); range_index++) {
+        Range range = ranges[range_index];
+        uint32_t begin = range.begin;
+        // The shortest key is the first one, it ends at this node
+        if (_words[begin].length == range.depth) {
+            _nodes[range.node].word = begin + 1;
+            _nodes[range.node].weight_max = _words[begin].weight;
+            begin++;
+        }
+
+        _nodes[range.node].first_child = _nodes.size();
+        while (begin < range.end) {
+            uint8_t letter = get_letter(_words[begin], range.depth);
+            uint32_t end = begin;
+            uint16_t weight_max = 0;
+            while ((end < range.end) && (get_letter(_words[end], range.depth) == letter)) {
+                weight_max = std::max(weight_max, _words[end].weight);
+                end++;
+            }
+            ranges.push_back({static_cast<uint32_t>(_nodes.size()), begin, end, range.depth + 1});
+            _nodes.push_back({0, 0, weight_max, 0, letter});
+            _nodes[range.node].child_num++;
+            _nodes[range.node].weight_max = std::max(_nodes[range.node].weight_max, weight_max);
+            begin = end;
+        }
+    }
+    _nodes.shrink_to_fit();
+    _heap.reserve(HEAP_SIZE_DEFAULT);
+
+    ESP_UTILS_LOGD("Built %d words into %d nodes", getWordNum(), static_cast<int>(_nodes.size()));
+
+    return true;
+}
+
+void KeyboardPredictor::clear()
+{
+    _nodes = {};
+    _words = {};
+    _word_text = {};
+    _last_lookup = {};
+    _lookup_time_max_us = 0;
+}
+
+int KeyboardPredictor::predict(std::string_view prefix, std::string_view *words, int word_num_max)
+{
+    int64_t start_us = get_time_us();
+    int word_num = 0;
+    int visit_num = 0;
+
+    if (isLoaded() && (words != nullptr) && (word_num_max > 0) && (prefix.size() <= PREFIX_LEN_MAX)) {
+        int node_index = 0;
+        for (size_t i = 0; (i < prefix.size()) && (node_index >= 0); i++) {
+            node_index = isWordByte(prefix[i]) ? findChild(_nodes[node_index], toKey(prefix[i])) : -1;
+            visit_num++;
+        }
+
+        _heap.clear();
+        if (node_index >= 0) {
+            _heap.push_back(to_heap_item(_nodes[node_index].weight_max, false, node_index));
+        }
+        while (!_heap.empty() && (word_num < word_num_max) && (visit_num < _visit_num_max)) {
+            std::pop_heap(_heap.begin(), _heap.end());
+            uint64_t item = _heap.back();
+            _heap.pop_back();
+
+            uint32_t index = get_heap_item_index(item);
+            if (is_heap_item_word(item)) {
+                words[word_num++] = std::string_view(&_word_text[_words[index].offset], _words[index].length);
+                continue;
+            }
+
+            const Node &node = _nodes[index];
+            visit_num++;
+            if (node.word > 0) {
+                _heap.push_back(to_heap_item(_words[node.word - 1].weight, true, node.word - 1));
+                std::push_heap(_heap.begin(), _heap.end());
+            }
+            for (uint32_t child = node.first_child; child < node.first_child + node.child_num; child++) {
+                _heap.push_back(to_heap_item(_nodes[child].weight_max, false, child));
+                std::push_heap(_heap.begin(), _heap.end());
+            }
+        }
+    }
+
+    _last_lookup.visit_num = visit_num;
+    _last_lookup.time_us = static_cast<int>(get_time_us() - start_us);
+    _lookup_time_max_us = std::max(_lookup_time_max_us, _last_lookup.time_us);
+
+    return word_num;
+}
+
+size_t KeyboardPredictor::getMemorySize() const
+{
+    return _nodes.capacity() * sizeof(Node) + _words.capacity() * sizeof(Word) + _word_text.capacity() +
+           _heap.capacity() * sizeof(uint64_t);
+}
+
+bool KeyboardPredictor::isWordByte(uint8_t byte)
+{
+    // Any printable ASCII or UTF-8 byte
+    return (byte > ' ') && (byte != 0x7F);
+}
+
+uint8_t KeyboardPredictor::toKey(uint8_t byte)
+{
+    return ((byte >= 'A') && (byte <= 'Z')) ? (byte - 'A' + 'a') : byte;
+}
+
+int KeyboardPredictor::findChild(const Node &node, uint8_t letter) const
+{
+    auto begin = _nodes.begin() + node.first_child;
+    auto end = begin + node.child_num;
+    auto it = std::lower_bound(begin, end, letter, [](const Node & child, uint8_t letter) {
+        return child.letter < letter;
+    });
+    if ((it == end) || (it->letter != letter)) {
+        return -1;
+    }
+
+    return static_cast<int>(it - _nodes.begin());
+}
+
+} // namespace esp_brookesia::systems::speaker
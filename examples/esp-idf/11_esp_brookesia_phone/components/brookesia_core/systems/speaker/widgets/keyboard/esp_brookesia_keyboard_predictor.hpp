@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace esp_brookesia::systems::speaker {
+
+/**
+ * @brief Word completion of the keyboard
+ *
+ * The dictionary is a text with one word per line, optionally followed by its weight, such as `hello 1200`. The words
+ * with a higher weight are suggested first. It is built into a flat trie: the children of a node are contiguous and
+ * sorted by letter, and each node keeps the highest weight below it. A lookup walks down the prefix, then visits the
+ * nodes best first, so it stops as soon as the best words are found. The letters are matched case-insensitively and
+ * the words are returned as they are written in the dictionary.
+ */
+class KeyboardPredictor {
+public:
+    struct LookupInfo {
+        int visit_num;      // Number of visited nodes
+        int time_us;        // Time of the lookup
+    };
+
+    static constexpr int WEIGHT_MAX = UINT16_MAX;
+    static constexpr int PREFIX_LEN_MAX = 32;
+
+    /**
+     * @brief Create a predictor
+     *
+     * @param visit_num_max Maximum number of nodes visited by a lookup, it bounds the time of a lookup
+     */
+    KeyboardPredictor(int visit_num_max = 512);
+
+    KeyboardPredictor(const KeyboardPredictor &) = delete;
+    KeyboardPredictor &operator=(const KeyboardPredictor &) = delete;
+
+    /**
+     * @brief Build the trie from a dictionary file
+     */
+    bool loadFile(const char *path);
+
+    /**
+     * @brief Build the trie from a dictionary text. Invalid lines are skipped, a repeated word keeps its highest
+     *        weight.
+     */
+    bool load(std::string_view dictionary);
+    void clear();
+
+    /**
+     * @brief Find the words which start with `prefix`, the best first
+     *
+     * @param prefix The prefix, at most `PREFIX_LEN_MAX` bytes. The prefix itself is returned if it is a word.
+     * @param words Receives the words, they are valid until the dictionary is changed
+     * @param word_num_max Maximum number of words
+     *
+     * @return The number of words found
+     */
+    int predict(std::string_view prefix, std::string_view *words, int word_num_max);
+
+    bool isLoaded() const
+    {
+        return !_nodes.empty();
+    }
+    int getWordNum() const
+    {
+        return static_cast<int>(_words.size());
+    }
+    size_t getMemorySize() const;
+    const LookupInfo &getLastLookupInfo() const
+    {
+        return _last_lookup;
+    }
+    int getLookupTimeMaxUs() const
+    {
+        return _lookup_time_max_us;
+    }
+
+private:
+    struct Node {
+        uint32_t first_child;
+        uint32_t word;          // Index of the word which ends here plus 1, 0 if no word ends here
+        uint16_t weight_max;    // Highest weight of the words from this node
+        uint8_t child_num;
+        uint8_t letter;
+    };
+
+    struct Word {
+        uint32_t offset;
+        uint16_t weight;
+        uint8_t length;
+    };
+
+    static bool isWordByte(uint8_t byte);
+    static uint8_t toKey(uint8_t byte);
+    int findChild(const Node &node, uint8_t letter) const;
+
+    int _visit_num_max;
+    std::vector<Node> _nodes;
+    std::vector<Word> _words;
+    std::string _word_text;
+    std::vector<uint64_t> _heap;
+    LookupInfo _last_lookup = {};
+    int _lookup_time_max_us = 0;
+};
+
+} // namespace esp_brookesia::systems::speaker
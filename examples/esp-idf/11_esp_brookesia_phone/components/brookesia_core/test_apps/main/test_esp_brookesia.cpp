@@ -3,15 +3,30 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <functional>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_heap_caps.h"
 #include "esp_log.h"
+#include "esp_partition.h"
 #include "unity.h"
 #include "unity_test_runner.h"
 #include "unity_test_utils_memory.h"
 #include "lvgl.h"
 #include "esp_brookesia.hpp"
+#if CONFIG_ESP_BROOKESIA_GUI_ENABLE_ANIM_PLAYER
+#include "gui/anim_player/esp_brookesia_anim_frame_cache.hpp"
+#endif
+#if CONFIG_ESP_BROOKESIA_ENABLE_AI_FRAMEWORK
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "esp_vfs.h"
+#include "agent/audio_processor.h"
+#endif
 
 using namespace esp_brookesia;
 using namespace esp_brookesia::systems::phone;
@@ -95,6 +110,267 @@ TEST_CASE("test esp-brookesia to add stylesheet", "[esp-brookesia][phone][add_st
 }
 #endif
 
+#if CONFIG_ESP_BROOKESIA_GUI_ENABLE_ANIM_PLAYER
+static bool test_anim_frame_cache_record(gui::AnimFrameCache &cache, int index, int frame_num, size_t region_size)
+{
+    gui::AnimFrameCache::Recorder recorder;
+    std::vector<uint8_t> data(region_size, static_cast<uint8_t>(index));
+
+    if (!recorder.start(cache, index)) {
+        return false;
+    }
+    for (int i = 0; i < frame_num; i++) {
+        if (!recorder.addRegion(0, 0, 1, 1, data.data(), data.size())) {
+            return false;
+        }
+        recorder.endFrame();
+    }
+
+    return recorder.finish();
+}
+
+TEST_CASE("test esp-brookesia anim frame cache", "[esp-brookesia][gui][anim_frame_cache]")
+{
+    constexpr size_t REGION_SIZE = 64;
+    constexpr size_t ANIMATION_SIZE = 2 * (REGION_SIZE + sizeof(gui::AnimFrameCache::Region));
+    gui::AnimFrameCache cache;
+
+    TEST_ASSERT_TRUE(cache.begin(2 * ANIMATION_SIZE));
+
+    ESP_LOGI(TAG, "Record two animations");
+    TEST_ASSERT_TRUE(test_anim_frame_cache_record(cache, 0, 2, REGION_SIZE));
+    TEST_ASSERT_TRUE(test_anim_frame_cache_record(cache, 1, 2, REGION_SIZE));
+    TEST_ASSERT_FALSE(test_anim_frame_cache_record(cache, 1, 2, REGION_SIZE));
+
+    ESP_LOGI(TAG, "Check hit and miss");
+    auto animation = cache.find(0);
+    TEST_ASSERT_NOT_NULL(animation.get());
+    TEST_ASSERT_EQUAL(2, animation->getFrameNum());
+    TEST_ASSERT_EQUAL_UINT8(0, animation->regions[1].data.get()[0]);
+    TEST_ASSERT_NULL(cache.find(2).get());
+
+    ESP_LOGI(TAG, "Evict the least recently used animation");
+    animation.reset();
+    TEST_ASSERT_TRUE(test_anim_frame_cache_record(cache, 2, 2, REGION_SIZE));
+    TEST_ASSERT_TRUE(cache.contains(0));
+    TEST_ASSERT_FALSE(cache.contains(1));
+
+    // The size is only known at the end, so the other animations have been evicted to make room meanwhile
+    ESP_LOGI(TAG, "Drop an animation larger than the budget");
+    TEST_ASSERT_FALSE(test_anim_frame_cache_record(cache, 3, 5, REGION_SIZE));
+    TEST_ASSERT_FALSE(cache.contains(3));
+
+    auto stats = cache.getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.hit_count);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.miss_count);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.evict_count);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.record_count);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.record_abort_count);
+    TEST_ASSERT_EQUAL(0, stats.used_bytes);
+
+    cache.del();
+}
+#endif
+
+#if CONFIG_ESP_BROOKESIA_SYSTEMS_ENABLE_SPEAKER
+static bool test_wait_until(const std::function<bool()> &condition, int timeout_ms)
+{
+    for (int i = 0; (i < timeout_ms / 10) && !condition(); i++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    return condition();
+}
+
+TEST_CASE("test esp-brookesia expression prefetched emoji start", "[esp-brookesia][ai_framework][expression]")
+{
+    // The speaker assets are flashed with the speaker system, not with the test app
+    if (esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "anim_emotion") == nullptr) {
+        TEST_IGNORE_MESSAGE("No animation partition");
+    }
+
+    // The emotion player has a 2 MB cache with the prefetch, the icon player a 256 KB cache without it
+    auto &data = ESP_BROOKESIA_SPEAKER_360_360_DARK_STYLESHEET.ai_buddy.expression.data;
+    auto emotion_fps = std::get<gui::AnimPlayerPartitionConfig>(data.emotion.data.source).fps[0];
+    auto icon_fps = std::get<gui::AnimPlayerPartitionConfig>(data.icon.data.source).fps[0];
+    ai_framework::Expression::EmojiMap emoji_map = {{"first", {0, 0}}, {"second", {1, 1}}};
+    ai_framework::Expression::SystemIconMap system_icon_map = {{"icon", 0}};
+    ai_framework::Expression expression;
+
+    // Flush at once, as if the display was infinitely fast, so only the start of the animations is measured
+    auto connection = gui::AnimPlayer::flush_ready_signal.connect(
+    [](int x_start, int y_start, int x_end, int y_end, const void *flush_data, gui::AnimPlayer *player) {
+        player->notifyFlushFinished();
+    });
+    TEST_ASSERT_TRUE(expression.begin(data, &emoji_map, &system_icon_map));
+
+    gui::AnimFrameCache::Stats cache_stats = {};
+    gui::AnimPlayer::StartStats start_stats = {};
+    auto get_emotion_stats = [&]() {
+        return expression.getEmotionStats(cache_stats, start_stats);
+    };
+    auto get_icon_stats = [&]() {
+        return expression.getIconStats(cache_stats, start_stats);
+    };
+
+    ESP_LOGI(TAG, "Prefetch the emotion, then play it");
+    TEST_ASSERT_TRUE(expression.prefetchEmoji("first"));
+    TEST_ASSERT_TRUE(test_wait_until([&]() {
+        return get_emotion_stats() && (cache_stats.record_count + cache_stats.record_abort_count > 0);
+    }, 5000));
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, cache_stats.record_count, "The emotion does not fit in the cache");
+    TEST_ASSERT_TRUE(expression.setEmoji("first"));
+    TEST_ASSERT_TRUE(test_wait_until([&]() {
+        return get_emotion_stats() && (start_stats.start_count > 0);
+    }, 1000));
+    ESP_LOGI(TAG, "Emotion started in %d us", static_cast<int>(start_stats.last_latency_us));
+    TEST_ASSERT_EQUAL_UINT32(1, start_stats.cached_start_count);
+    TEST_ASSERT_LESS_THAN_UINT32(1000000 / emotion_fps, start_stats.max_cached_latency_us);
+
+    // The icon is recorded during its first pass, so it starts from the cache the next time
+    ESP_LOGI(TAG, "Play the icon again once it is cached");
+    TEST_ASSERT_TRUE(test_wait_until([&]() {
+        return get_icon_stats() && (cache_stats.record_count + cache_stats.record_abort_count > 0);
+    }, 5000));
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, cache_stats.record_count, "The icon does not fit in the cache");
+    TEST_ASSERT_TRUE(expression.setEmoji("second"));
+    TEST_ASSERT_TRUE(test_wait_until([&]() {
+        return get_icon_stats() && (start_stats.start_count >= 2);
+    }, 1000));
+    TEST_ASSERT_TRUE(expression.setEmoji("first"));
+    TEST_ASSERT_TRUE(test_wait_until([&]() {
+        return get_icon_stats() && (start_stats.cached_start_count > 0);
+    }, 1000));
+    ESP_LOGI(TAG, "Icon started in %d us", static_cast<int>(start_stats.last_latency_us));
+    TEST_ASSERT_EQUAL_UINT32(1, start_stats.cached_start_count);
+    TEST_ASSERT_LESS_THAN_UINT32(1000000 / icon_fps, start_stats.max_cached_latency_us);
+
+    TEST_ASSERT_TRUE(expression.del());
+    connection.disconnect();
+}
+#endif
+
+#if CONFIG_ESP_BROOKESIA_ENABLE_AI_FRAMEWORK
+#define TEST_PROMPT_VFS_BASE_PATH   "/prompt_test"
+
+// A file system holding one WAV file in memory, so the prompts can be read with `file://` without a flash partition
+static std::vector<uint8_t> test_prompt_wav;
+static size_t test_prompt_wav_offset;
+
+static std::vector<uint8_t> test_prompt_make_wav(int sample_rate, int duration_ms)
+{
+    auto append = [](std::vector<uint8_t> &wav, uint32_t value, int size) {
+        for (int i = 0; i < size; i++) {
+            wav.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    };
+    uint32_t data_size = sample_rate * duration_ms / 1000 * sizeof(int16_t);
+    std::vector<uint8_t> wav;
+    wav.insert(wav.end(), {'R', 'I', 'F', 'F'});
+    append(wav, 36 + data_size, 4);
+    wav.insert(wav.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+    append(wav, 16, 4);
+    append(wav, 1, 2);                  // PCM
+    append(wav, 1, 2);                  // Mono
+    append(wav, sample_rate, 4);
+    append(wav, sample_rate * sizeof(int16_t), 4);
+    append(wav, sizeof(int16_t), 2);
+    append(wav, 16, 2);
+    wav.insert(wav.end(), {'d', 'a', 't', 'a'});
+    append(wav, data_size, 4);
+    for (uint32_t i = 0; i < data_size / sizeof(int16_t); i++) {
+        append(wav, static_cast<uint16_t>(8000 * std::sin(2 * M_PI * 440 * i / sample_rate)), 2);
+    }
+    return wav;
+}
+
+static int test_prompt_vfs_open(const char *path, int flags, int mode)
+{
+    test_prompt_wav_offset = 0;
+    return (strcmp(path, "/tone.wav") == 0) ? 0 : -1;
+}
+
+static ssize_t test_prompt_vfs_read(int fd, void *dst, size_t size)
+{
+    size = std::min(size, test_prompt_wav.size() - test_prompt_wav_offset);
+    memcpy(dst, test_prompt_wav.data() + test_prompt_wav_offset, size);
+    test_prompt_wav_offset += size;
+    return size;
+}
+
+static off_t test_prompt_vfs_lseek(int fd, off_t offset, int mode)
+{
+    off_t base = (mode == SEEK_CUR) ? test_prompt_wav_offset : ((mode == SEEK_END) ? test_prompt_wav.size() : 0);
+    test_prompt_wav_offset = std::min(static_cast<size_t>(std::max<off_t>(base + offset, 0)), test_prompt_wav.size());
+    return test_prompt_wav_offset;
+}
+
+static int test_prompt_vfs_fstat(int fd, struct stat *st)
+{
+    memset(st, 0, sizeof(*st));
+    st->st_mode = S_IFREG;
+    st->st_size = test_prompt_wav.size();
+    return 0;
+}
+
+static int test_prompt_vfs_close(int fd)
+{
+    return 0;
+}
+
+static size_t test_prompt_play_until_done(const std::function<esp_err_t()> &play)
+{
+    size_t output_size = audio_prompt_get_output_size();
+    TEST_ASSERT_EQUAL(ESP_OK, play());
+    for (int i = 0; (i < 300) && audio_prompt_is_playing(); i++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    TEST_ASSERT_FALSE_MESSAGE(audio_prompt_is_playing(), "The prompt did not finish");
+    return audio_prompt_get_output_size() - output_size;
+}
+
+TEST_CASE("test esp-brookesia audio prompt from file and memory", "[esp-brookesia][ai_framework][audio_prompt]")
+{
+    test_prompt_wav = test_prompt_make_wav(16000, 200);
+    esp_vfs_t vfs = {};
+    vfs.flags = ESP_VFS_FLAG_DEFAULT;
+    vfs.open = test_prompt_vfs_open;
+    vfs.read = test_prompt_vfs_read;
+    vfs.lseek = test_prompt_vfs_lseek;
+    vfs.fstat = test_prompt_vfs_fstat;
+    vfs.close = test_prompt_vfs_close;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_vfs_register(TEST_PROMPT_VFS_BASE_PATH, &vfs, NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, audio_prompt_open());
+
+    // The prompts from memory use their own player, so the `file://` prompts are still read from the file, before and
+    // after a prompt from memory
+    ESP_LOGI(TAG, "Play a prompt from a file");
+    auto play_file = []() {
+        return audio_prompt_play("file:/" TEST_PROMPT_VFS_BASE_PATH "/tone.wav");
+    };
+    size_t output_size = test_prompt_play_until_done(play_file);
+    ESP_LOGI(TAG, "Prompt from a file: %d bytes", static_cast<int>(output_size));
+    TEST_ASSERT_GREATER_THAN_MESSAGE(0, output_size, "No output from the file prompt");
+
+    ESP_LOGI(TAG, "Play a prompt from memory");
+    output_size = test_prompt_play_until_done([]() {
+        return audio_prompt_play_from_memory(
+            "raw:/" TEST_PROMPT_VFS_BASE_PATH "/tone.wav", test_prompt_wav.data(), test_prompt_wav.size()
+        );
+    });
+    ESP_LOGI(TAG, "Prompt from memory: %d bytes", static_cast<int>(output_size));
+    TEST_ASSERT_GREATER_THAN_MESSAGE(0, output_size, "No output from the memory prompt");
+
+    ESP_LOGI(TAG, "Play a prompt from a file again");
+    output_size = test_prompt_play_until_done(play_file);
+    TEST_ASSERT_GREATER_THAN_MESSAGE(0, output_size, "No output from the file prompt after a memory prompt");
+
+    TEST_ASSERT_EQUAL(ESP_OK, audio_prompt_close());
+    TEST_ASSERT_EQUAL(ESP_OK, esp_vfs_unregister(TEST_PROMPT_VFS_BASE_PATH));
+    test_prompt_wav.clear();
+    test_prompt_wav.shrink_to_fit();
+}
+#endif
+
 // TEST_CASE("test esp-brookesia to install and uninstall APPs", "[esp-brookesia][phone][install_uninstall_app]")
 // {
 //     lv_display_t *disp = nullptr;
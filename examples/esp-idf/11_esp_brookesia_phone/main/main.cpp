@@ -125,14 +125,14 @@ If you need to use the three-cache anti-tear configuration, you need to fix idf
                         heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM), external_free, external_total);
                 ESP_UTILS_LOGI("\n%s", buffer);
 
-                {
-                    LvLockGuard gui_guard;
+                // The label is only for display, so run it on the LVGL thread instead of blocking on the lock
+                LvLock::post([=]() {
                     ESP_UTILS_CHECK_FALSE_EXIT(
                         phone->getDisplay().getRecentsScreen()->setMemoryLabel(
                             internal_free / 1024, internal_total / 1024, external_free / 1024, external_total / 1024
                         ), "Set memory label failed"
                     );
-                }
+                });
 
                 boost::this_thread::sleep_for(boost::chrono::seconds(5));
             } })